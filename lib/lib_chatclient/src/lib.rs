@@ -1,7 +1,8 @@
 //! Matrix chat client provider — Rust port of `lib_chatclient/`.
 //!
 //! Communicates with a Matrix homeserver via the Client-Server API.
-//! Uses `reqwest` blocking for HTTP (no async runtime required).
+//! Uses `reqwest` blocking for request/response calls; the /sync long-poll
+//! runs as a task on the crate's own tokio runtime (see `sync`).
 //!
 //! ## FFON tree layout
 //!
@@ -37,7 +38,9 @@
 mod auth;
 mod members;
 mod messages;
+mod room_index;
 mod rooms;
+mod store;
 mod sync;
 
 use sicompass_sdk::ffon::FfonElement;
@@ -183,8 +186,6 @@ pub struct ChatClientProvider {
     sync_cache: Arc<Mutex<sync::SyncCache>>,
     needs_refresh_flag: Arc<AtomicBool>,
     sync_controller: sync::SyncController,
-    /// Serialises settings-file writes between the main thread and the sync thread.
-    file_lock: Arc<Mutex<()>>,
     uia_session: String,
     config_path_override: Option<std::path::PathBuf>,
     sync_disabled: bool,
@@ -202,6 +203,8 @@ pub struct ChatClientProvider {
     /// Unified-timeline emission queue. Drained by the app via
     /// `take_timeline_entries` after each command.
     pending_timeline_entries: Vec<TimelineEntry>,
+    /// room_id → when its full member list was last asked for.
+    members_requested: Mutex<HashMap<String, std::time::Instant>>,
 }
 
 impl ChatClientProvider {
@@ -219,7 +222,6 @@ impl ChatClientProvider {
             sync_cache: cache,
             needs_refresh_flag: flag,
             sync_controller: ctrl,
-            file_lock: Arc::new(Mutex::new(())),
             uia_session: String::new(),
             config_path_override: None,
             sync_disabled: false,
@@ -231,6 +233,7 @@ impl ChatClientProvider {
             public_rooms_cache: Vec::new(),
             drafts: HashMap::new(),
             pending_timeline_entries: Vec::new(),
+            members_requested: Mutex::new(HashMap::new()),
         }
     }
 
@@ -258,44 +261,30 @@ impl ChatClientProvider {
             .or_else(|| sicompass_sdk::platform::main_config_path())
     }
 
-    fn cache(&self) -> std::sync::MutexGuard<'_, sync::SyncCache> {
-        self.sync_cache.lock().unwrap_or_else(|e| e.into_inner())
+    /// The room store the sync task resumes from: one per account under the
+    /// cache dir, or next to the settings file when a test overrides that.
+    ///
+    /// `None` without a user ID — the store is keyed on it, and resuming one
+    /// account's `next_batch` for another would silently skip its history.
+    fn sync_store_path(&self) -> Option<std::path::PathBuf> {
+        if let Some(p) = &self.config_path_override {
+            return Some(p.with_file_name("chat-store.db"));
+        }
+        if self.user_id.is_empty() {
+            return None;
+        }
+        store::default_path(&self.user_id)
     }
 
-    fn file_guard(&self) -> std::sync::MutexGuard<'_, ()> {
-        self.file_lock.lock().unwrap_or_else(|e| e.into_inner())
+    fn cache(&self) -> std::sync::MutexGuard<'_, sync::SyncCache> {
+        self.sync_cache.lock().unwrap_or_else(|e| e.into_inner())
     }
 
     fn save_setting(&self, key: &str, value: &str) {
-        use serde_json::{Map, Value};
         let Some(path) = self.config_path() else {
             return;
         };
-        let _guard = self.file_guard();
-        // See `sync::persist_next_batch`: abort on read/parse failure rather
-        // than starting from an empty map, which would wipe every other section
-        // of settings.json. Only a genuinely-missing file starts empty.
-        let mut root: Map<String, Value> = match std::fs::read_to_string(&path) {
-            Ok(s) => match serde_json::from_str::<Value>(&s) {
-                Ok(Value::Object(m)) => m,
-                _ => return,
-            },
-            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Map::new(),
-            Err(_) => return,
-        };
-        let section = root
-            .entry("chat client".to_owned())
-            .or_insert_with(|| Value::Object(Map::new()));
-        if let Value::Object(m) = section {
-            m.insert(key.to_owned(), Value::String(value.to_owned()));
-        }
-        if let Some(parent) = path.parent() {
-            sicompass_sdk::platform::make_dirs(parent);
-        }
-        if let Ok(json) = serde_json::to_string_pretty(&Value::Object(root)) {
-            // Atomic write so concurrent readers never see a truncated file.
-            let _ = sicompass_sdk::platform::atomic_write(&path, &json);
-        }
+        sicompass_config::at(&path).set("chat client", key, value);
     }
 
     fn save_access_token(&self, token: &str) {
@@ -343,9 +332,8 @@ impl ChatClientProvider {
         self.sync_controller.start(
             self.homeserver.clone(),
             self.access_token.clone(),
-            self.config_path(),
+            self.sync_store_path(),
             self.user_id.clone(),
-            Arc::clone(&self.file_lock),
         );
     }
 
@@ -387,51 +375,9 @@ impl ChatClientProvider {
             items.push(item);
         }
 
-        // Spaces.
-        let mut spaces: Vec<&sync::RoomState> = cache
-            .rooms
-            .values()
-            .filter(|r| r.kind == sync::RoomKind::Space)
-            .collect();
-        spaces.sort_by(|a, b| a.display_name.cmp(&b.display_name));
-        for space in spaces {
-            items.push(FfonElement::new_obj(format!(
-                "[space] {}",
-                space.display_name
-            )));
-        }
-
-        // DM rooms.
-        let mut dm_rooms: Vec<(&sync::RoomState, String)> = cache
-            .rooms
-            .values()
-            .filter(|r| r.is_dm && r.kind == sync::RoomKind::Room)
-            .filter_map(|r| {
-                cache
-                    .direct_room_to_user
-                    .get(&r.room_id)
-                    .map(|u| (r, format!("[dm] {u}")))
-            })
-            .collect();
-        dm_rooms.sort_by(|(_, a), (_, b)| a.cmp(b));
-        for (room, key) in dm_rooms {
-            items.push(room_list_item(key, room.unread_count, room.highlight_count));
-        }
-
-        // Regular rooms.
-        let mut rooms: Vec<&sync::RoomState> = cache
-            .rooms
-            .values()
-            .filter(|r| !r.is_dm && r.kind == sync::RoomKind::Room)
-            .collect();
-        rooms.sort_by(|a, b| a.display_name.cmp(&b.display_name));
-        for room in rooms {
-            items.push(room_list_item(
-                room.display_name.clone(),
-                room.unread_count,
-                room.highlight_count,
-            ));
-        }
+        // Spaces, DMs, then rooms — kept sorted and rendered by the sync
+        // task, which re-keys only the rooms each batch touched.
+        items.extend(cache.room_index.rows().cloned());
 
         items
     }
@@ -492,6 +438,19 @@ impl ChatClientProvider {
     }
 
     fn fetch_members(&self, room_key: &str) -> Vec<FfonElement> {
+        // /sync lazy-loads members; the full list is fetched in the background
+        // on first view, and what /sync has delivered is shown meanwhile.
+        let unloaded = {
+            let cache = self.cache();
+            cache
+                .display_to_id
+                .get(room_key)
+                .filter(|id| cache.rooms.get(*id).is_some_and(|r| !r.members_loaded))
+                .cloned()
+        };
+        if let Some(room_id) = unloaded {
+            self.start_load_members(&room_id);
+        }
         let cache = self.cache();
         let Some(room_id) = cache.display_to_id.get(room_key).cloned() else {
             return vec![FfonElement::new_str("room not found".to_owned())];
@@ -857,15 +816,10 @@ impl Provider for ChatClientProvider {
             self.maybe_start_sync();
             return;
         };
-        let Ok(content) = std::fs::read_to_string(&path) else {
-            self.maybe_start_sync();
-            return;
-        };
-        let Ok(root) = serde_json::from_str::<Value>(&content) else {
-            self.maybe_start_sync();
-            return;
-        };
-        let Some(section) = root.get("chat client").and_then(|v| v.as_object()) else {
+        let Some(Value::Object(section)) = sicompass_config::at(&path)
+            .read(|root| root.get("chat client").cloned())
+            .flatten()
+        else {
             self.maybe_start_sync();
             return;
         };
@@ -888,11 +842,10 @@ impl Provider for ChatClientProvider {
         // register_mode stays false (login form) unless the user has no token and
         // explicitly ran :register — we don't override it from settings.
 
-        // Do NOT restore chatSyncNextBatch — resuming from a stored token causes
-        // the sync thread to only fetch events newer than that token, leaving room
-        // timelines empty (no visible messages) when the app restarts in a quiet room.
-        // Every session starts with a fresh initial sync (?timeout=0, no since) which
-        // returns the current room list plus a bounded recent-message history.
+        // Do NOT restore chatSyncNextBatch from settings — a bare token makes the
+        // sync task fetch only events newer than it, leaving room timelines empty.
+        // The sync task resumes from the room store instead, which holds the
+        // token together with the rooms and timelines it is current as of.
 
         self.maybe_start_sync();
     }
@@ -1303,6 +1256,8 @@ impl Provider for ChatClientProvider {
                     let event_id_opt = room.timeline.last().map(|ev| ev.event_id.clone());
                     room.unread_count = 0;
                     room.highlight_count = 0;
+                    cache.reindex_room(&room_id);
+                    cache.dirty_rooms.insert(room_id.clone());
                     (room_id, event_id_opt)
                 };
                 if let Some(event_id) = event_id_opt {
@@ -1745,17 +1700,11 @@ impl ChatClientProvider {
 
     pub fn test_seed_room(&mut self, room_id: &str, display_name: &str) {
         let mut cache = self.sync_cache.lock().unwrap();
-        cache.rooms.insert(
-            room_id.to_owned(),
-            sync::RoomState {
-                room_id: room_id.to_owned(),
-                display_name: display_name.to_owned(),
-                ..Default::default()
-            },
-        );
-        cache
-            .display_to_id
-            .insert(display_name.to_owned(), room_id.to_owned());
+        cache.insert_room(sync::RoomState {
+            room_id: room_id.to_owned(),
+            display_name: display_name.to_owned(),
+            ..Default::default()
+        });
     }
 
     pub fn test_set_needs_refresh(&self) {
@@ -1779,6 +1728,7 @@ impl ChatClientProvider {
                 room.unread_count = unread;
                 room.highlight_count = highlight;
             }
+            cache.reindex_room(&room_id);
         }
         // Mark next_batch non-empty so fetch() doesn't show "Loading…".
         if cache.next_batch.is_empty() {
@@ -1794,7 +1744,7 @@ impl ChatClientProvider {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use wiremock::matchers::{method, path};
+    use wiremock::matchers::{method, path, path_regex};
     use wiremock::{Mock, MockServer, ResponseTemplate};
 
     fn start_mock_server() -> (tokio::runtime::Runtime, MockServer) {
@@ -1816,17 +1766,11 @@ mod tests {
 
     fn seed_room(p: &mut ChatClientProvider, room_id: &str, display_name: &str) {
         let mut cache = p.sync_cache.lock().unwrap();
-        cache.rooms.insert(
-            room_id.to_owned(),
-            sync::RoomState {
-                room_id: room_id.to_owned(),
-                display_name: display_name.to_owned(),
-                ..Default::default()
-            },
-        );
-        cache
-            .display_to_id
-            .insert(display_name.to_owned(), room_id.to_owned());
+        cache.insert_room(sync::RoomState {
+            room_id: room_id.to_owned(),
+            display_name: display_name.to_owned(),
+            ..Default::default()
+        });
     }
 
     fn seed_room_with_events(
@@ -1846,18 +1790,12 @@ mod tests {
             })
             .collect();
         let mut cache = p.sync_cache.lock().unwrap();
-        cache.rooms.insert(
-            room_id.to_owned(),
-            sync::RoomState {
-                room_id: room_id.to_owned(),
-                display_name: display_name.to_owned(),
-                timeline,
-                ..Default::default()
-            },
-        );
-        cache
-            .display_to_id
-            .insert(display_name.to_owned(), room_id.to_owned());
+        cache.insert_room(sync::RoomState {
+            room_id: room_id.to_owned(),
+            display_name: display_name.to_owned(),
+            timeline,
+            ..Default::default()
+        });
     }
 
     // ---- original tests (adapted) ------------------------------------------
@@ -2573,8 +2511,8 @@ mod tests {
 
     #[test]
     fn next_batch_not_restored_from_settings_on_init() {
-        // chatSyncNextBatch is intentionally ignored on startup so every session
-        // begins with a fresh initial sync and gets a visible message history.
+        // chatSyncNextBatch is intentionally ignored on startup: a bare token
+        // without the rooms it covers would leave every timeline empty.
         let dir = tempfile::tempdir().unwrap();
         let cfg = dir.path().join("settings.json");
         write_settings(
@@ -2884,6 +2822,7 @@ mod tests {
         {
             let mut cache = p.sync_cache.lock().unwrap();
             cache.rooms.get_mut("!r:s").unwrap().unread_count = 2;
+            cache.reindex_room("!r:s");
         }
         p.push_path("General");
         let mut err = String::new();
@@ -3069,16 +3008,13 @@ mod tests {
         let mut p = provider_for(&server);
         {
             let mut cache = p.sync_cache.lock().unwrap();
-            cache.invites.insert(
+            cache.insert_invite(
                 "!inv:server".to_owned(),
                 sync::InviteState {
                     display_name: "Party".to_owned(),
                     inviter: "@alice:server".to_owned(),
                 },
             );
-            cache
-                .invite_display_to_id
-                .insert("[invite] Party".to_owned(), "!inv:server".to_owned());
         }
         let mut err = String::new();
         let elem = p.handle_command("accept invite", "[invite] Party", 0, &mut err);
@@ -3094,27 +3030,18 @@ mod tests {
         p.access_token = "tok".to_owned();
         {
             let mut cache = p.sync_cache.lock().unwrap();
-            cache.rooms.insert(
-                "!r:s".to_owned(),
-                sync::RoomState {
-                    room_id: "!r:s".to_owned(),
-                    display_name: "Zzz".to_owned(),
-                    ..Default::default()
-                },
-            );
-            cache
-                .display_to_id
-                .insert("Zzz".to_owned(), "!r:s".to_owned());
-            cache.invites.insert(
+            cache.insert_room(sync::RoomState {
+                room_id: "!r:s".to_owned(),
+                display_name: "Zzz".to_owned(),
+                ..Default::default()
+            });
+            cache.insert_invite(
                 "!inv:s".to_owned(),
                 sync::InviteState {
                     display_name: "Aaa".to_owned(),
                     inviter: String::new(),
                 },
             );
-            cache
-                .invite_display_to_id
-                .insert("[invite] Aaa".to_owned(), "!inv:s".to_owned());
         }
         let items = p.fetch();
         let keys: Vec<&str> = items
@@ -3137,30 +3064,18 @@ mod tests {
         p.access_token = "tok".to_owned();
         {
             let mut cache = p.sync_cache.lock().unwrap();
-            cache.rooms.insert(
-                "!space:s".to_owned(),
-                sync::RoomState {
-                    room_id: "!space:s".to_owned(),
-                    display_name: "Work".to_owned(),
-                    kind: sync::RoomKind::Space,
-                    space_children: vec!["!general:s".to_owned()],
-                    ..Default::default()
-                },
-            );
-            cache.rooms.insert(
-                "!general:s".to_owned(),
-                sync::RoomState {
-                    room_id: "!general:s".to_owned(),
-                    display_name: "general".to_owned(),
-                    ..Default::default()
-                },
-            );
-            cache
-                .display_to_id
-                .insert("[space] Work".to_owned(), "!space:s".to_owned());
-            cache
-                .display_to_id
-                .insert("general".to_owned(), "!general:s".to_owned());
+            cache.insert_room(sync::RoomState {
+                room_id: "!space:s".to_owned(),
+                display_name: "Work".to_owned(),
+                kind: sync::RoomKind::Space,
+                space_children: vec!["!general:s".to_owned()],
+                ..Default::default()
+            });
+            cache.insert_room(sync::RoomState {
+                room_id: "!general:s".to_owned(),
+                display_name: "general".to_owned(),
+                ..Default::default()
+            });
         }
         p.push_path("[space] Work");
         let items = p.fetch();
@@ -3187,18 +3102,13 @@ mod tests {
                     membership: "join".to_owned(),
                 },
             );
-            cache.rooms.insert(
-                "!r:s".to_owned(),
-                sync::RoomState {
-                    room_id: "!r:s".to_owned(),
-                    display_name: "General".to_owned(),
-                    members,
-                    ..Default::default()
-                },
-            );
-            cache
-                .display_to_id
-                .insert("General".to_owned(), "!r:s".to_owned());
+            cache.insert_room(sync::RoomState {
+                room_id: "!r:s".to_owned(),
+                display_name: "General".to_owned(),
+                members,
+                members_loaded: true,
+                ..Default::default()
+            });
         }
         p.push_path("General");
         p.push_path("[members]");
@@ -3210,6 +3120,72 @@ mod tests {
         );
     }
 
+    /// Poll until the background member fetch has raised `needs_refresh`.
+    fn await_refresh(p: &ChatClientProvider) -> bool {
+        for _ in 0..500 {
+            if p.needs_refresh() {
+                return true;
+            }
+            std::thread::sleep(std::time::Duration::from_millis(10));
+        }
+        false
+    }
+
+    #[test]
+    fn members_load_in_the_background() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path_regex("/members$"))
+                .respond_with(ResponseTemplate::new(200).set_body_json(serde_json::json!({
+                    "chunk": [{
+                        "type": "m.room.member",
+                        "state_key": "@bob:s",
+                        "content": {"membership": "join", "displayname": "Bob"},
+                    }],
+                }))),
+        );
+        let mut p = provider_for(&server);
+        seed_room(&mut p, "!r:s", "General");
+        p.push_path("General");
+        p.push_path("[members]");
+
+        // Nothing waits on the request: what /sync sent is shown meanwhile.
+        assert_eq!(p.fetch(), vec![FfonElement::new_str("no member data yet")]);
+        assert!(await_refresh(&p), "the full list never arrived");
+        assert!(
+            p.fetch()
+                .iter()
+                .any(|e| e.as_obj().is_some_and(|o| o.key.contains("@bob:s")))
+        );
+    }
+
+    #[test]
+    fn a_failed_member_load_is_not_retried_on_every_fetch() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path_regex("/members$"))
+                .respond_with(ResponseTemplate::new(500)),
+        );
+        let mut p = provider_for(&server);
+        seed_room(&mut p, "!r:s", "General");
+        p.push_path("General");
+        p.push_path("[members]");
+
+        for _ in 0..5 {
+            p.fetch();
+            std::thread::sleep(std::time::Duration::from_millis(50));
+        }
+        let asked = rt.block_on(server.received_requests()).unwrap_or_default();
+        assert_eq!(asked.len(), 1);
+        assert!(!p.needs_refresh());
+    }
+
     // ---- room_list_item badge helper -----------------------------------------
 
     #[test]
@@ -3245,19 +3221,13 @@ mod tests {
         p.access_token = "tok".to_owned();
         {
             let mut cache = p.sync_cache.lock().unwrap();
-            cache.rooms.insert(
-                "!r:s".to_owned(),
-                sync::RoomState {
-                    room_id: "!r:s".to_owned(),
-                    display_name: "Noisy".to_owned(),
-                    unread_count: 7,
-                    highlight_count: 0,
-                    ..Default::default()
-                },
-            );
-            cache
-                .display_to_id
-                .insert("Noisy".to_owned(), "!r:s".to_owned());
+            cache.insert_room(sync::RoomState {
+                room_id: "!r:s".to_owned(),
+                display_name: "Noisy".to_owned(),
+                unread_count: 7,
+                highlight_count: 0,
+                ..Default::default()
+            });
             cache.next_batch = "tok".to_owned();
         }
         let items = p.fetch();
@@ -3436,16 +3406,13 @@ mod tests {
         let mut p = provider_for(&server);
         {
             let mut cache = p.sync_cache.lock().unwrap();
-            cache.invites.insert(
+            cache.insert_invite(
                 "!inv:x".to_owned(),
                 sync::InviteState {
                     display_name: "Party".to_owned(),
                     inviter: "@a:s".to_owned(),
                 },
             );
-            cache
-                .invite_display_to_id
-                .insert("[invite] Party".to_owned(), "!inv:x".to_owned());
         }
         let mut err = String::new();
         p.handle_command("accept invite", "[invite] Party", 0, &mut err);
@@ -1,6 +1,10 @@
 //! Matrix member management operations for ChatClientProvider.
 
+use super::sync;
 use super::{ChatClientProvider, encode_room_id};
+use std::sync::Arc;
+use std::sync::atomic::Ordering;
+use std::time::{Duration, Instant};
 
 impl ChatClientProvider {
     pub(crate) fn do_kick_member(
@@ -109,4 +113,70 @@ impl ChatClientProvider {
                 .to_owned())
         }
     }
+
+    /// Start fetching a room's full member list on the sync runtime, unless
+    /// it was asked for less than [`MEMBERS_RETRY`] ago.
+    ///
+    /// /sync lazy-loads members, so until the list lands a room only knows the
+    /// members that have appeared in its timeline. `needs_refresh` is raised
+    /// when it does. A failed fetch is not retried before the wait is up, so
+    /// an unreachable server does not cost a request per fetch of the view.
+    pub(crate) fn start_load_members(&self, room_id: &str) {
+        if self.homeserver.is_empty() {
+            return;
+        }
+        {
+            let mut requested = self
+                .members_requested
+                .lock()
+                .unwrap_or_else(|e| e.into_inner());
+            if requested
+                .get(room_id)
+                .is_some_and(|at| at.elapsed() < MEMBERS_RETRY)
+            {
+                return;
+            }
+            requested.insert(room_id.to_owned(), Instant::now());
+        }
+        let encoded = encode_room_id(room_id);
+        let url = self.api(&format!("/_matrix/client/v3/rooms/{encoded}/members"));
+        let auth = self.auth_header();
+        let room_id = room_id.to_owned();
+        let cache = Arc::clone(&self.sync_cache);
+        let notify = Arc::clone(&self.needs_refresh_flag);
+        sync::runtime().spawn(async move {
+            let Ok(body) = fetch_members(&url, &auth).await else {
+                return;
+            };
+            let mut cache = cache.lock().unwrap_or_else(|e| e.into_inner());
+            let Some(room) = cache.rooms.get_mut(&room_id) else {
+                return;
+            };
+            if sync::apply_members_response(&body, room).is_ok() {
+                cache.dirty_rooms.insert(room_id);
+                notify.store(true, Ordering::Relaxed);
+            }
+        });
+    }
+}
+
+/// How long a member-list fetch that has not landed holds off the next one.
+const MEMBERS_RETRY: Duration = Duration::from_secs(60);
+
+/// GET a /members body.
+async fn fetch_members(url: &str, auth: &str) -> Result<Vec<u8>, String> {
+    let resp = reqwest::Client::builder()
+        .user_agent("sicompass/1.0")
+        .timeout(Duration::from_secs(30))
+        .build()
+        .map_err(|e| e.to_string())?
+        .get(url)
+        .header("Authorization", auth)
+        .send()
+        .await
+        .map_err(|e| e.to_string())?;
+    if !resp.status().is_success() {
+        return Err(format!("HTTP {}", resp.status()));
+    }
+    Ok(resp.bytes().await.map_err(|e| e.to_string())?.to_vec())
 }
@@ -122,6 +122,7 @@ impl ChatClientProvider {
                 room.timeline.drain(..drain);
             }
             room.prev_batch = new_prev;
+            cache.dirty_rooms.insert(room_id);
             Ok(fetched)
         } else {
             Err("room not found".to_owned())
@@ -0,0 +1,188 @@
+//! Sorted room list for the chat root view.
+//!
+//! Keeps every joined room's list row rendered and in order, so a /sync batch
+//! that touches three rooms re-keys three rows instead of re-sorting and
+//! re-rendering all of them. Rows sort spaces first (by name), then DMs, then
+//! group rooms; within those, rooms with mentions, then unread rooms, then by
+//! most recent activity.
+
+use crate::sync::{RoomKind, RoomState};
+use sicompass_sdk::ffon::FfonElement;
+use std::cmp::Reverse;
+use std::collections::{BTreeMap, HashMap};
+
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord)]
+enum Section {
+    Space,
+    Dm,
+    Room,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq, PartialOrd, Ord)]
+struct SortKey {
+    section: Section,
+    highlight: Reverse<u32>,
+    unread: Reverse<u32>,
+    activity: Reverse<i64>,
+    display_key: String,
+    room_id: String,
+}
+
+#[derive(Debug, Default)]
+pub struct RoomIndex {
+    /// Rendered rows in list order.
+    rows: BTreeMap<SortKey, FfonElement>,
+    /// room_id → its current key, to find the row again.
+    keys: HashMap<String, SortKey>,
+}
+
+/// The name a room is listed and navigated under.
+pub fn display_key(room: &RoomState, dm_partner: Option<&str>) -> String {
+    match (&room.kind, dm_partner) {
+        (RoomKind::Space, _) => format!("[space] {}", room.display_name),
+        (RoomKind::Room, Some(partner)) => format!("[dm] {partner}"),
+        (RoomKind::Room, None) => room.display_name.clone(),
+    }
+}
+
+impl RoomIndex {
+    /// Insert or re-key `room`. `dm_partner` is set for DM rooms.
+    ///
+    /// Returns the display key the room was listed under before, if any, and
+    /// the one it is listed under now. A room whose key is unchanged keeps its
+    /// rendered row untouched.
+    pub fn update(
+        &mut self,
+        room: &RoomState,
+        dm_partner: Option<&str>,
+    ) -> (Option<String>, String) {
+        let display_key = display_key(room, dm_partner);
+        let key = match room.kind {
+            // Spaces carry no badge and sort by name only.
+            RoomKind::Space => SortKey {
+                section: Section::Space,
+                highlight: Reverse(0),
+                unread: Reverse(0),
+                activity: Reverse(0),
+                display_key: display_key.clone(),
+                room_id: room.room_id.clone(),
+            },
+            RoomKind::Room => SortKey {
+                section: if dm_partner.is_some() {
+                    Section::Dm
+                } else {
+                    Section::Room
+                },
+                highlight: Reverse(room.highlight_count),
+                unread: Reverse(room.unread_count),
+                activity: Reverse(room.timeline.last().map_or(0, |e| e.origin_server_ts)),
+                display_key: display_key.clone(),
+                room_id: room.room_id.clone(),
+            },
+        };
+
+        let old = self.keys.get(&room.room_id).cloned();
+        if old.as_ref() == Some(&key) {
+            return (Some(display_key.clone()), display_key);
+        }
+        if let Some(old) = &old {
+            self.rows.remove(old);
+        }
+        let item = match key.section {
+            Section::Space => FfonElement::new_obj(display_key.clone()),
+            Section::Dm | Section::Room => {
+                crate::room_list_item(display_key.clone(), room.unread_count, room.highlight_count)
+            }
+        };
+        self.rows.insert(key.clone(), item);
+        self.keys.insert(room.room_id.clone(), key);
+        (old.map(|k| k.display_key), display_key)
+    }
+
+    /// Drop a room's row. Returns the display key it was listed under.
+    pub fn remove(&mut self, room_id: &str) -> Option<String> {
+        let key = self.keys.remove(room_id)?;
+        self.rows.remove(&key);
+        Some(key.display_key)
+    }
+
+    pub fn clear(&mut self) {
+        self.rows.clear();
+        self.keys.clear();
+    }
+
+    /// Rendered rows in list order.
+    pub fn rows(&self) -> impl Iterator<Item = &FfonElement> {
+        self.rows.values()
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::sync::TimelineEvent;
+
+    fn room(id: &str, name: &str, unread: u32, last_ts: i64) -> RoomState {
+        RoomState {
+            room_id: id.to_owned(),
+            display_name: name.to_owned(),
+            unread_count: unread,
+            timeline: vec![TimelineEvent {
+                event_id: format!("${id}"),
+                sender: "@a:s".to_owned(),
+                body: "hi".to_owned(),
+                origin_server_ts: last_ts,
+            }],
+            ..Default::default()
+        }
+    }
+
+    fn labels(index: &RoomIndex) -> Vec<String> {
+        index
+            .rows()
+            .map(|e| e.as_obj().unwrap().key.clone())
+            .collect()
+    }
+
+    #[test]
+    fn rooms_sort_by_attention_then_activity() {
+        let mut index = RoomIndex::default();
+        index.update(&room("!a:s", "Old", 0, 1), None);
+        index.update(&room("!b:s", "Recent", 0, 9), None);
+        index.update(&room("!c:s", "Unread", 2, 5), None);
+        let mut space = room("!s:s", "Work", 0, 0);
+        space.kind = RoomKind::Space;
+        index.update(&space, None);
+        index.update(&room("!d:s", "Dm", 0, 3), Some("@bob:s"));
+        assert_eq!(
+            labels(&index),
+            [
+                "[space] Work",
+                "[dm] @bob:s",
+                "Unread [unread:2]",
+                "Recent",
+                "Old"
+            ]
+        );
+    }
+
+    #[test]
+    fn update_moves_only_the_changed_room() {
+        let mut index = RoomIndex::default();
+        index.update(&room("!a:s", "A", 0, 1), None);
+        index.update(&room("!b:s", "B", 0, 2), None);
+        assert_eq!(labels(&index), ["B", "A"]);
+
+        let (old, new) = index.update(&room("!a:s", "A2", 0, 3), None);
+        assert_eq!(old.as_deref(), Some("A"));
+        assert_eq!(new, "A2");
+        assert_eq!(labels(&index), ["A2", "B"]);
+
+        assert_eq!(index.remove("!b:s").as_deref(), Some("B"));
+        assert_eq!(labels(&index), ["A2"]);
+    }
+}
@@ -0,0 +1,453 @@
+//! SQLite-backed room store for `lib_chatclient`.
+//!
+//! Persists the joined rooms, their state, members and recent timeline, the
+//! pending invites, the m.direct map and the `next_batch` token that all of it
+//! is current as of. A restart loads the store into the `SyncCache` and resumes
+//! /sync from that token instead of downloading a full initial sync.
+//!
+//! Everything is written in one transaction per flush, so the stored
+//! `next_batch` never runs ahead of the rooms it covers.
+//!
+//! DB location: platform cache dir + `/sicompass/chat/<hex_user_id>.db`
+//! (Linux: `~/.cache`, macOS: `~/Library/Caches`, Windows: `%LOCALAPPDATA%`).
+
+use crate::sync::{InviteState, Member, RoomKind, RoomState, SyncCache, TimelineEvent};
+use rusqlite::{Connection, OptionalExtension, params};
+use sicompass_sdk::platform;
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
+
+/// Default store path for `user_id`, or `None` if there is no cache dir.
+pub fn default_path(user_id: &str) -> Option<PathBuf> {
+    let dir = platform::cache_home()?.join("sicompass").join("chat");
+    // Safe filename: hex-encode the user id bytes.
+    let hex: String = user_id.bytes().map(|b| format!("{b:02x}")).collect();
+    Some(dir.join(format!("{hex}.db")))
+}
+
+/// What one flush writes: the rooms that changed since the last flush (`None`
+/// for a room that was left) plus the small whole-account tables.
+#[derive(Debug, Default)]
+pub struct Snapshot {
+    pub next_batch: String,
+    pub rooms: Vec<(String, Option<RoomState>)>,
+    pub invites: HashMap<String, InviteState>,
+    pub direct_room_to_user: HashMap<String, String>,
+}
+
+impl Snapshot {
+    /// Take the dirty rooms out of `cache`. Cheap enough to run under the
+    /// cache lock: at most [`crate::sync::MAX_TIMELINE`]-ish events per room.
+    pub fn take(cache: &mut SyncCache) -> Self {
+        let rooms = cache
+            .dirty_rooms
+            .drain()
+            .map(|id| {
+                let room = cache.rooms.get(&id).cloned();
+                (id, room)
+            })
+            .collect();
+        Snapshot {
+            next_batch: cache.next_batch.clone(),
+            rooms,
+            invites: cache.invites.clone(),
+            direct_room_to_user: cache.direct_room_to_user.clone(),
+        }
+    }
+}
+
+pub struct RoomStore {
+    conn: Connection,
+}
+
+impl RoomStore {
+    /// Open (or create) the store at `path`.
+    ///
+    /// Returns `None` if the directory cannot be created or the DB cannot be
+    /// opened — the caller silently falls back to a full initial sync.
+    pub fn open(path: &Path) -> Option<Self> {
+        if let Some(parent) = path.parent() {
+            std::fs::create_dir_all(parent).ok()?;
+        }
+        let conn = Connection::open(path).ok()?;
+        let store = RoomStore { conn };
+        store.init_schema().ok()?;
+        Some(store)
+    }
+
+    fn init_schema(&self) -> rusqlite::Result<()> {
+        self.conn.execute_batch(
+            "CREATE TABLE IF NOT EXISTS meta (
+                key   TEXT PRIMARY KEY,
+                value TEXT NOT NULL
+             );
+             CREATE TABLE IF NOT EXISTS rooms (
+                room_id         TEXT PRIMARY KEY,
+                display_name    TEXT    NOT NULL,
+                is_space        INTEGER NOT NULL,
+                topic           TEXT,
+                is_encrypted    INTEGER NOT NULL,
+                unread_count    INTEGER NOT NULL,
+                highlight_count INTEGER NOT NULL,
+                prev_batch      TEXT,
+                members_loaded  INTEGER NOT NULL
+             );
+             CREATE TABLE IF NOT EXISTS space_children (
+                room_id  TEXT    NOT NULL,
+                pos      INTEGER NOT NULL,
+                child_id TEXT    NOT NULL,
+                PRIMARY KEY (room_id, pos)
+             );
+             CREATE TABLE IF NOT EXISTS members (
+                room_id      TEXT NOT NULL,
+                user_id      TEXT NOT NULL,
+                display_name TEXT,
+                membership   TEXT NOT NULL,
+                PRIMARY KEY (room_id, user_id)
+             );
+             CREATE TABLE IF NOT EXISTS events (
+                room_id          TEXT    NOT NULL,
+                pos              INTEGER NOT NULL,
+                event_id         TEXT    NOT NULL,
+                sender           TEXT    NOT NULL,
+                body             TEXT    NOT NULL,
+                origin_server_ts INTEGER NOT NULL,
+                PRIMARY KEY (room_id, pos)
+             );
+             CREATE TABLE IF NOT EXISTS invites (
+                room_id      TEXT PRIMARY KEY,
+                display_name TEXT NOT NULL,
+                inviter      TEXT NOT NULL
+             );
+             CREATE TABLE IF NOT EXISTS direct (
+                room_id TEXT PRIMARY KEY,
+                user_id TEXT NOT NULL
+             );",
+        )
+    }
+
+    // -----------------------------------------------------------------------
+    // Read
+    // -----------------------------------------------------------------------
+
+    /// Load the whole store into a fresh cache.
+    ///
+    /// `None` when nothing has been stored yet (no `next_batch`), in which case
+    /// the caller starts with a full initial sync.
+    pub fn load(&self) -> Option<SyncCache> {
+        let next_batch: String = self
+            .conn
+            .query_row(
+                "SELECT value FROM meta WHERE key = 'next_batch'",
+                [],
+                |row| row.get(0),
+            )
+            .optional()
+            .ok()
+            .flatten()?;
+        let mut cache = SyncCache {
+            next_batch,
+            ..Default::default()
+        };
+        self.load_rooms(&mut cache).ok()?;
+        self.load_account(&mut cache).ok()?;
+        for room in cache.rooms.values_mut() {
+            room.is_dm = cache.direct_room_ids.contains(&room.room_id);
+        }
+        cache.reindex_all();
+        Some(cache)
+    }
+
+    fn load_rooms(&self, cache: &mut SyncCache) -> rusqlite::Result<()> {
+        let mut stmt = self.conn.prepare(
+            "SELECT room_id, display_name, is_space, topic, is_encrypted,
+                    unread_count, highlight_count, prev_batch, members_loaded
+               FROM rooms",
+        )?;
+        let rows = stmt.query_map([], |row| {
+            Ok(RoomState {
+                room_id: row.get(0)?,
+                display_name: row.get(1)?,
+                kind: if row.get::<_, i64>(2)? != 0 {
+                    RoomKind::Space
+                } else {
+                    RoomKind::Room
+                },
+                topic: row.get(3)?,
+                is_encrypted: row.get::<_, i64>(4)? != 0,
+                unread_count: row.get::<_, i64>(5)? as u32,
+                highlight_count: row.get::<_, i64>(6)? as u32,
+                prev_batch: row.get(7)?,
+                members_loaded: row.get::<_, i64>(8)? != 0,
+                ..Default::default()
+            })
+        })?;
+        for room in rows {
+            let room = room?;
+            cache.rooms.insert(room.room_id.clone(), room);
+        }
+
+        let mut stmt = self
+            .conn
+            .prepare("SELECT room_id, child_id FROM space_children ORDER BY room_id, pos")?;
+        let rows = stmt.query_map([], |row| Ok((row.get::<_, String>(0)?, row.get(1)?)))?;
+        for row in rows {
+            let (room_id, child_id) = row?;
+            if let Some(room) = cache.rooms.get_mut(&room_id) {
+                room.space_children.push(child_id);
+            }
+        }
+
+        let mut stmt = self
+            .conn
+            .prepare("SELECT room_id, user_id, display_name, membership FROM members")?;
+        let rows = stmt.query_map([], |row| {
+            Ok((
+                row.get::<_, String>(0)?,
+                Member {
+                    user_id: row.get(1)?,
+                    display_name: row.get(2)?,
+                    membership: row.get(3)?,
+                },
+            ))
+        })?;
+        for row in rows {
+            let (room_id, member) = row?;
+            if let Some(room) = cache.rooms.get_mut(&room_id) {
+                room.members.insert(member.user_id.clone(), member);
+            }
+        }
+
+        let mut stmt = self.conn.prepare(
+            "SELECT room_id, event_id, sender, body, origin_server_ts
+               FROM events
+           ORDER BY room_id, pos",
+        )?;
+        let rows = stmt.query_map([], |row| {
+            Ok((
+                row.get::<_, String>(0)?,
+                TimelineEvent {
+                    event_id: row.get(1)?,
+                    sender: row.get(2)?,
+                    body: row.get(3)?,
+                    origin_server_ts: row.get(4)?,
+                },
+            ))
+        })?;
+        for row in rows {
+            let (room_id, event) = row?;
+            if let Some(room) = cache.rooms.get_mut(&room_id) {
+                room.timeline.push(event);
+            }
+        }
+        Ok(())
+    }
+
+    fn load_account(&self, cache: &mut SyncCache) -> rusqlite::Result<()> {
+        let mut stmt = self
+            .conn
+            .prepare("SELECT room_id, display_name, inviter FROM invites")?;
+        let rows = stmt.query_map([], |row| {
+            Ok((
+                row.get::<_, String>(0)?,
+                InviteState {
+                    display_name: row.get(1)?,
+                    inviter: row.get(2)?,
+                },
+            ))
+        })?;
+        for row in rows {
+            let (room_id, invite) = row?;
+            cache.invites.insert(room_id, invite);
+        }
+
+        let mut stmt = self.conn.prepare("SELECT room_id, user_id FROM direct")?;
+        let rows = stmt.query_map([], |row| {
+            Ok((row.get::<_, String>(0)?, row.get::<_, String>(1)?))
+        })?;
+        for row in rows {
+            let (room_id, user_id) = row?;
+            cache.direct_room_ids.insert(room_id.clone());
+            cache.direct_room_to_user.insert(room_id, user_id);
+        }
+        Ok(())
+    }
+
+    // -----------------------------------------------------------------------
+    // Write
+    // -----------------------------------------------------------------------
+
+    /// Write `snap` in a single transaction.
+    pub fn save(&mut self, snap: &Snapshot) -> rusqlite::Result<()> {
+        let tx = self.conn.transaction()?;
+        for (room_id, room) in &snap.rooms {
+            for table in ["rooms", "space_children", "members", "events"] {
+                tx.execute(
+                    &format!("DELETE FROM {table} WHERE room_id = ?1"),
+                    params![room_id],
+                )?;
+            }
+            let Some(room) = room else { continue };
+            tx.execute(
+                "INSERT INTO rooms (room_id, display_name, is_space, topic, is_encrypted,
+                                    unread_count, highlight_count, prev_batch, members_loaded)
+                 VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9)",
+                params![
+                    room_id,
+                    &room.display_name,
+                    (room.kind == RoomKind::Space) as i64,
+                    &room.topic,
+                    room.is_encrypted as i64,
+                    room.unread_count as i64,
+                    room.highlight_count as i64,
+                    &room.prev_batch,
+                    room.members_loaded as i64,
+                ],
+            )?;
+            let mut stmt = tx.prepare_cached(
+                "INSERT INTO space_children (room_id, pos, child_id) VALUES (?1, ?2, ?3)",
+            )?;
+            for (pos, child_id) in room.space_children.iter().enumerate() {
+                stmt.execute(params![room_id, pos as i64, child_id])?;
+            }
+            let mut stmt = tx.prepare_cached(
+                "INSERT INTO members (room_id, user_id, display_name, membership)
+                 VALUES (?1, ?2, ?3, ?4)",
+            )?;
+            for m in room.members.values() {
+                stmt.execute(params![room_id, &m.user_id, &m.display_name, &m.membership])?;
+            }
+            let mut stmt = tx.prepare_cached(
+                "INSERT INTO events (room_id, pos, event_id, sender, body, origin_server_ts)
+                 VALUES (?1, ?2, ?3, ?4, ?5, ?6)",
+            )?;
+            for (pos, ev) in room.timeline.iter().enumerate() {
+                stmt.execute(params![
+                    room_id,
+                    pos as i64,
+                    &ev.event_id,
+                    &ev.sender,
+                    &ev.body,
+                    ev.origin_server_ts,
+                ])?;
+            }
+        }
+
+        // Invites and m.direct are a handful of rows; rewrite them whole.
+        tx.execute("DELETE FROM invites", [])?;
+        for (room_id, inv) in &snap.invites {
+            tx.execute(
+                "INSERT INTO invites (room_id, display_name, inviter) VALUES (?1, ?2, ?3)",
+                params![room_id, &inv.display_name, &inv.inviter],
+            )?;
+        }
+        tx.execute("DELETE FROM direct", [])?;
+        for (room_id, user_id) in &snap.direct_room_to_user {
+            tx.execute(
+                "INSERT INTO direct (room_id, user_id) VALUES (?1, ?2)",
+                params![room_id, user_id],
+            )?;
+        }
+
+        if !snap.next_batch.is_empty() {
+            tx.execute(
+                "INSERT INTO meta (key, value) VALUES ('next_batch', ?1)
+                 ON CONFLICT(key) DO UPDATE SET value = excluded.value",
+                params![&snap.next_batch],
+            )?;
+        }
+        tx.commit()
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use tempfile::tempdir;
+
+    fn room(id: &str, name: &str, bodies: &[&str]) -> RoomState {
+        RoomState {
+            room_id: id.to_owned(),
+            display_name: name.to_owned(),
+            timeline: bodies
+                .iter()
+                .enumerate()
+                .map(|(i, b)| TimelineEvent {
+                    event_id: format!("${i}"),
+                    sender: "@a:s".to_owned(),
+                    body: (*b).to_owned(),
+                    origin_server_ts: i as i64,
+                })
+                .collect(),
+            prev_batch: Some("p1".to_owned()),
+            ..Default::default()
+        }
+    }
+
+    #[test]
+    fn empty_store_loads_nothing() {
+        let dir = tempdir().unwrap();
+        let store = RoomStore::open(&dir.path().join("chat.db")).unwrap();
+        assert!(store.load().is_none());
+    }
+
+    #[test]
+    fn saved_rooms_round_trip_in_order() {
+        let dir = tempdir().unwrap();
+        let path = dir.path().join("chat.db");
+        let mut store = RoomStore::open(&path).unwrap();
+        let mut cache = SyncCache::default();
+        cache.next_batch = "s9".to_owned();
+        cache
+            .rooms
+            .insert("!r:s".to_owned(), room("!r:s", "General", &["one", "two"]));
+        cache.dirty_rooms.insert("!r:s".to_owned());
+        cache
+            .direct_room_to_user
+            .insert("!r:s".to_owned(), "@b:s".to_owned());
+        store.save(&Snapshot::take(&mut cache)).unwrap();
+        assert!(cache.dirty_rooms.is_empty());
+        drop(store);
+
+        let loaded = RoomStore::open(&path).unwrap().load().unwrap();
+        assert_eq!(loaded.next_batch, "s9");
+        let r = &loaded.rooms["!r:s"];
+        let bodies: Vec<&str> = r.timeline.iter().map(|e| e.body.as_str()).collect();
+        assert_eq!(bodies, ["one", "two"]);
+        assert_eq!(r.prev_batch.as_deref(), Some("p1"));
+        assert!(r.is_dm);
+        assert_eq!(
+            loaded.display_to_id.get("[dm] @b:s").map(String::as_str),
+            Some("!r:s")
+        );
+    }
+
+    #[test]
+    fn only_dirty_rooms_are_rewritten_and_left_rooms_deleted() {
+        let dir = tempdir().unwrap();
+        let mut store = RoomStore::open(&dir.path().join("chat.db")).unwrap();
+        let mut cache = SyncCache::default();
+        cache.next_batch = "s1".to_owned();
+        for id in ["!a:s", "!b:s"] {
+            cache.rooms.insert(id.to_owned(), room(id, id, &["x"]));
+            cache.dirty_rooms.insert(id.to_owned());
+        }
+        store.save(&Snapshot::take(&mut cache)).unwrap();
+
+        // !a:s is left; !b:s changes in memory but is not marked dirty.
+        cache.rooms.remove("!a:s");
+        cache.dirty_rooms.insert("!a:s".to_owned());
+        cache.rooms.get_mut("!b:s").unwrap().display_name = "unsaved".to_owned();
+        cache.next_batch = "s2".to_owned();
+        store.save(&Snapshot::take(&mut cache)).unwrap();
+
+        let loaded = store.load().unwrap();
+        assert_eq!(loaded.next_batch, "s2");
+        assert!(!loaded.rooms.contains_key("!a:s"));
+        assert_eq!(loaded.rooms["!b:s"].display_name, "!b:s");
+    }
+}
@@ -1,20 +1,63 @@
-//! Matrix /sync background thread.
+//! Matrix /sync background task.
 //!
 //! Mirrors the structure of lib_emailclient/src/idle.rs — same AtomicBool
-//! wake mechanism, same non-blocking stop, same reconnect back-off.
-
+//! wake mechanism, same non-blocking stop, same reconnect back-off. The loop
+//! runs on this crate's shared tokio runtime rather than a dedicated thread,
+//! and each /sync body is deserialized into borrowed, typed structs before the
+//! cache is touched, so the cache mutex is only held while a room is merged.
+//!
+//! When a room store is configured (see `store.rs`) the loop starts from the
+//! stored rooms and `next_batch` instead of a full initial sync, and writes the
+//! rooms each batch touched back to it. Member lists are lazy-loaded: /sync
+//! only carries the members that appear in the timeline, and the full list is
+//! fetched when a room's members are first viewed.
+
+use crate::room_index::RoomIndex;
+use crate::store::{RoomStore, Snapshot};
+use serde::Deserialize;
+use serde::de::{self, Deserializer, IgnoredAny, MapAccess, SeqAccess, Visitor};
+use std::borrow::Cow;
 use std::collections::{HashMap, HashSet};
+use std::path::PathBuf;
 use std::sync::atomic::{AtomicBool, Ordering};
-use std::sync::{Arc, Mutex, MutexGuard};
-use std::time::Duration;
+use std::sync::{Arc, Mutex, MutexGuard, OnceLock};
+use std::time::{Duration, Instant};
 
 const RECONNECT_DELAY_SECS: u64 = 10;
 pub const MAX_TIMELINE: usize = 200;
 
+/// Minimum gap between two writes to the room store.
+///
+/// An active account advances `next_batch` on every /sync round trip; writing
+/// each batch through would rewrite the busiest rooms several times a minute.
+/// Pending changes are always flushed when the loop stops.
+const STORE_FLUSH_INTERVAL: Duration = Duration::from_secs(30);
+
+/// Sync filter: lazy-load room members, so a batch only carries the member
+/// events for senders in its timeline rather than every member of every room.
+const SYNC_FILTER: &str = r#"{"room":{"state":{"lazy_load_members":true}}}"#;
+
 fn lock<T>(m: &Mutex<T>) -> MutexGuard<'_, T> {
     m.lock().unwrap_or_else(|e| e.into_inner())
 }
 
+/// The runtime that carries the /sync long-poll.
+///
+/// One per process, shared by every chat provider instance, so an idle account
+/// costs a parked task instead of a parked OS thread. Mirrors
+/// `connection::runtime()` in lib_emailclient.
+pub fn runtime() -> &'static tokio::runtime::Runtime {
+    static RT: OnceLock<tokio::runtime::Runtime> = OnceLock::new();
+    RT.get_or_init(|| {
+        tokio::runtime::Builder::new_multi_thread()
+            .worker_threads(1)
+            .enable_all()
+            .thread_name("sicompass-chat")
+            .build()
+            .expect("failed to build the chat runtime")
+    })
+}
+
 // ---------------------------------------------------------------------------
 // Cache types
 // ---------------------------------------------------------------------------
@@ -57,6 +100,9 @@ pub struct RoomState {
     pub is_encrypted: bool,
     /// Token for fetching earlier messages via /messages?dir=b.
     pub prev_batch: Option<String>,
+    /// Whether `members` holds the full list from /members rather than only
+    /// the lazy-loaded members /sync sent.
+    pub members_loaded: bool,
 }
 
 #[derive(Debug, Clone)]
@@ -82,6 +128,358 @@ pub struct SyncCache {
     pub direct_room_ids: HashSet<String>,
     /// room_id → partner user_id for DM rooms.
     pub direct_room_to_user: HashMap<String, String>,
+    /// Rooms changed or left since the last room-store flush.
+    pub dirty_rooms: HashSet<String>,
+    /// Joined rooms as rendered, sorted list rows.
+    pub room_index: RoomIndex,
+}
+
+// `rooms`, `invites` and the display maps are kept in step through these
+// methods; mutate a room in place and then call `reindex_room`.
+impl SyncCache {
+    /// Insert or replace a joined room and list it.
+    pub fn insert_room(&mut self, room: RoomState) {
+        let room_id = room.room_id.clone();
+        self.rooms.insert(room_id.clone(), room);
+        self.reindex_room(&room_id);
+    }
+
+    /// Remove a joined room and its list row.
+    pub fn remove_room(&mut self, room_id: &str) -> Option<RoomState> {
+        let room = self.rooms.remove(room_id);
+        if let Some(old) = self.room_index.remove(room_id) {
+            remove_if_maps_to(&mut self.display_to_id, &old, room_id);
+        }
+        room
+    }
+
+    /// Re-key one room's list row and display-map entry after its name, kind,
+    /// DM status, counts or timeline changed.
+    pub fn reindex_room(&mut self, room_id: &str) {
+        let Some(room) = self.rooms.get(room_id) else {
+            return;
+        };
+        let partner = if room.is_dm {
+            self.direct_room_to_user.get(room_id).map(String::as_str)
+        } else {
+            None
+        };
+        let (old, new) = self.room_index.update(room, partner);
+        if let Some(old) = old.filter(|old| *old != new) {
+            remove_if_maps_to(&mut self.display_to_id, &old, room_id);
+        }
+        self.display_to_id.insert(new, room_id.to_owned());
+    }
+
+    pub fn insert_invite(&mut self, room_id: String, invite: InviteState) {
+        self.invite_display_to_id
+            .insert(format!("[invite] {}", invite.display_name), room_id.clone());
+        self.invites.insert(room_id, invite);
+    }
+
+    pub fn remove_invite(&mut self, room_id: &str) -> Option<InviteState> {
+        let invite = self.invites.remove(room_id)?;
+        let key = format!("[invite] {}", invite.display_name);
+        remove_if_maps_to(&mut self.invite_display_to_id, &key, room_id);
+        Some(invite)
+    }
+
+    /// Rebuild the list and both display maps from scratch — after loading
+    /// from the store, or when m.direct moves rooms between sections.
+    pub fn reindex_all(&mut self) {
+        self.room_index.clear();
+        self.display_to_id.clear();
+        self.invite_display_to_id.clear();
+        let room_ids: Vec<String> = self.rooms.keys().cloned().collect();
+        for room_id in &room_ids {
+            self.reindex_room(room_id);
+        }
+        for (room_id, inv) in &self.invites {
+            let key = format!("[invite] {}", inv.display_name);
+            self.invite_display_to_id.insert(key, room_id.clone());
+        }
+    }
+}
+
+/// Remove `key` from a display map unless another room has since taken it.
+fn remove_if_maps_to(map: &mut HashMap<String, String>, key: &str, room_id: &str) {
+    if map.get(key).is_some_and(|id| id == room_id) {
+        map.remove(key);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Typed /sync response
+// ---------------------------------------------------------------------------
+//
+// Only the fields the cache uses are declared; serde skips everything else
+// without building it. Strings borrow from the response body wherever the JSON
+// has no escapes, which covers nearly all event ids, senders and bodies.
+//
+// Event `content` is written by other users' clients, so it is parsed
+// leniently: a field of the wrong type reads as absent instead of failing the
+// whole batch, which `serde_json::Value` used to tolerate implicitly and which
+// would otherwise wedge the loop on the same bad event forever.
+
+#[derive(Debug, Default, Deserialize)]
+struct SyncResponse<'a> {
+    #[serde(borrow, default)]
+    next_batch: LenientStr<'a>,
+    #[serde(borrow, default)]
+    account_data: AccountData<'a>,
+    #[serde(borrow, default)]
+    rooms: Rooms<'a>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct AccountData<'a> {
+    #[serde(borrow, default)]
+    events: Vec<AccountDataEvent<'a>>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct AccountDataEvent<'a> {
+    #[serde(rename = "type", borrow, default)]
+    kind: LenientStr<'a>,
+    /// Kept generic: only `m.direct` is read, and its content is a map keyed
+    /// by user id rather than a fixed shape.
+    #[serde(default)]
+    content: serde_json::Value,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct Rooms<'a> {
+    #[serde(borrow, default)]
+    join: HashMap<String, JoinedRoom<'a>>,
+    #[serde(borrow, default)]
+    invite: HashMap<String, InvitedRoom<'a>>,
+    #[serde(default)]
+    leave: HashMap<String, IgnoredAny>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct JoinedRoom<'a> {
+    #[serde(borrow, default)]
+    state: EventList<'a>,
+    #[serde(borrow, default)]
+    timeline: Timeline<'a>,
+    #[serde(default)]
+    unread_notifications: Option<UnreadNotifications>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct InvitedRoom<'a> {
+    #[serde(borrow, default)]
+    invite_state: EventList<'a>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct EventList<'a> {
+    #[serde(borrow, default)]
+    events: Vec<Event<'a>>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct Timeline<'a> {
+    #[serde(borrow, default)]
+    events: Vec<Event<'a>>,
+    #[serde(borrow, default)]
+    prev_batch: LenientStr<'a>,
+    /// Set when the server dropped events between the previous batch and
+    /// this one.
+    #[serde(default)]
+    limited: bool,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct UnreadNotifications {
+    #[serde(default)]
+    notification_count: Option<u64>,
+    #[serde(default)]
+    highlight_count: Option<u64>,
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct Event<'a> {
+    #[serde(rename = "type", borrow, default)]
+    kind: LenientStr<'a>,
+    /// Present (possibly empty) on state events, absent on message events.
+    #[serde(borrow, default)]
+    state_key: LenientStr<'a>,
+    #[serde(borrow, default)]
+    event_id: LenientStr<'a>,
+    #[serde(borrow, default)]
+    sender: LenientStr<'a>,
+    #[serde(default)]
+    origin_server_ts: Option<i64>,
+    #[serde(borrow, default)]
+    content: Lenient<EventContent<'a>>,
+}
+
+/// The union of the `content` fields the cache reads across event types.
+#[derive(Debug, Default, Deserialize)]
+struct EventContent<'a> {
+    #[serde(borrow, default)]
+    body: LenientStr<'a>,
+    #[serde(borrow, default)]
+    name: LenientStr<'a>,
+    #[serde(borrow, default)]
+    topic: LenientStr<'a>,
+    #[serde(borrow, default)]
+    membership: LenientStr<'a>,
+    #[serde(borrow, default)]
+    displayname: LenientStr<'a>,
+    /// `m.room.create` room type, e.g. `m.space`.
+    #[serde(rename = "type", borrow, default)]
+    room_type: LenientStr<'a>,
+    /// `m.space.child`: whether `via` is a non-empty list.
+    #[serde(default)]
+    via: NonEmptyList,
+}
+
+/// A string that reads any other JSON type as absent.
+#[derive(Debug, Default)]
+struct LenientStr<'a>(Option<Cow<'a, str>>);
+
+impl LenientStr<'_> {
+    fn get(&self) -> Option<&str> {
+        self.0.as_deref()
+    }
+
+    fn as_str(&self) -> &str {
+        self.get().unwrap_or("")
+    }
+}
+
+impl<'de: 'a, 'a> Deserialize<'de> for LenientStr<'a> {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        struct V;
+        impl<'de> Visitor<'de> for V {
+            type Value = LenientStr<'de>;
+            fn expecting(&self, f: &mut std::fmt::Formatter) -> std::fmt::Result {
+                f.write_str("any JSON value")
+            }
+            fn visit_borrowed_str<E>(self, v: &'de str) -> Result<Self::Value, E> {
+                Ok(LenientStr(Some(Cow::Borrowed(v))))
+            }
+            fn visit_str<E>(self, v: &str) -> Result<Self::Value, E> {
+                Ok(LenientStr(Some(Cow::Owned(v.to_owned()))))
+            }
+            fn visit_string<E>(self, v: String) -> Result<Self::Value, E> {
+                Ok(LenientStr(Some(Cow::Owned(v))))
+            }
+            fn visit_bool<E>(self, _: bool) -> Result<Self::Value, E> {
+                Ok(LenientStr(None))
+            }
+            fn visit_i64<E>(self, _: i64) -> Result<Self::Value, E> {
+                Ok(LenientStr(None))
+            }
+            fn visit_u64<E>(self, _: u64) -> Result<Self::Value, E> {
+                Ok(LenientStr(None))
+            }
+            fn visit_f64<E>(self, _: f64) -> Result<Self::Value, E> {
+                Ok(LenientStr(None))
+            }
+            fn visit_unit<E>(self) -> Result<Self::Value, E> {
+                Ok(LenientStr(None))
+            }
+            fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> Result<Self::Value, A::Error> {
+                while seq.next_element::<IgnoredAny>()?.is_some() {}
+                Ok(LenientStr(None))
+            }
+            fn visit_map<A: MapAccess<'de>>(self, mut map: A) -> Result<Self::Value, A::Error> {
+                while map.next_entry::<IgnoredAny, IgnoredAny>()?.is_some() {}
+                Ok(LenientStr(None))
+            }
+        }
+        d.deserialize_any(V)
+    }
+}
+
+/// An object that reads any non-object JSON value as `T::default()`.
+#[derive(Debug, Default)]
+struct Lenient<T>(T);
+
+impl<'de, T: Deserialize<'de> + Default> Deserialize<'de> for Lenient<T> {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        struct V<T>(std::marker::PhantomData<T>);
+        impl<'de, T: Deserialize<'de> + Default> Visitor<'de> for V<T> {
+            type Value = Lenient<T>;
+            fn expecting(&self, f: &mut std::fmt::Formatter) -> std::fmt::Result {
+                f.write_str("any JSON value")
+            }
+            fn visit_map<A: MapAccess<'de>>(self, map: A) -> Result<Self::Value, A::Error> {
+                T::deserialize(de::value::MapAccessDeserializer::new(map)).map(Lenient)
+            }
+            fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> Result<Self::Value, A::Error> {
+                while seq.next_element::<IgnoredAny>()?.is_some() {}
+                Ok(Lenient(T::default()))
+            }
+            fn visit_str<E>(self, _: &str) -> Result<Self::Value, E> {
+                Ok(Lenient(T::default()))
+            }
+            fn visit_bool<E>(self, _: bool) -> Result<Self::Value, E> {
+                Ok(Lenient(T::default()))
+            }
+            fn visit_i64<E>(self, _: i64) -> Result<Self::Value, E> {
+                Ok(Lenient(T::default()))
+            }
+            fn visit_u64<E>(self, _: u64) -> Result<Self::Value, E> {
+                Ok(Lenient(T::default()))
+            }
+            fn visit_f64<E>(self, _: f64) -> Result<Self::Value, E> {
+                Ok(Lenient(T::default()))
+            }
+            fn visit_unit<E>(self) -> Result<Self::Value, E> {
+                Ok(Lenient(T::default()))
+            }
+        }
+        d.deserialize_any(V(std::marker::PhantomData))
+    }
+}
+
+/// Whether a JSON value is a non-empty array; anything else reads as `false`.
+#[derive(Debug, Default)]
+struct NonEmptyList(bool);
+
+impl<'de> Deserialize<'de> for NonEmptyList {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        struct V;
+        impl<'de> Visitor<'de> for V {
+            type Value = NonEmptyList;
+            fn expecting(&self, f: &mut std::fmt::Formatter) -> std::fmt::Result {
+                f.write_str("any JSON value")
+            }
+            fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> Result<Self::Value, A::Error> {
+                let non_empty = seq.next_element::<IgnoredAny>()?.is_some();
+                while seq.next_element::<IgnoredAny>()?.is_some() {}
+                Ok(NonEmptyList(non_empty))
+            }
+            fn visit_map<A: MapAccess<'de>>(self, mut map: A) -> Result<Self::Value, A::Error> {
+                while map.next_entry::<IgnoredAny, IgnoredAny>()?.is_some() {}
+                Ok(NonEmptyList(false))
+            }
+            fn visit_str<E>(self, _: &str) -> Result<Self::Value, E> {
+                Ok(NonEmptyList(false))
+            }
+            fn visit_bool<E>(self, _: bool) -> Result<Self::Value, E> {
+                Ok(NonEmptyList(false))
+            }
+            fn visit_i64<E>(self, _: i64) -> Result<Self::Value, E> {
+                Ok(NonEmptyList(false))
+            }
+            fn visit_u64<E>(self, _: u64) -> Result<Self::Value, E> {
+                Ok(NonEmptyList(false))
+            }
+            fn visit_f64<E>(self, _: f64) -> Result<Self::Value, E> {
+                Ok(NonEmptyList(false))
+            }
+            fn visit_unit<E>(self) -> Result<Self::Value, E> {
+                Ok(NonEmptyList(false))
+            }
+        }
+        d.deserialize_any(V)
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -92,274 +490,220 @@ pub struct SyncCache {
 ///
 /// Returns `true` if the cache changed (new room, new event, updated name,
 /// a new `next_batch` token, invite/leave/member change, or DM update).
+///
+/// The sync loop does not go through here: it deserializes the raw body with
+/// `parse_sync_bytes` and merges with `apply_sync_response` under short locks.
 pub fn parse_sync_response(json: serde_json::Value, cache: &mut SyncCache) -> bool {
+    // `&Value` is itself a deserializer, and one that lends out its strings.
+    let Ok(resp) = SyncResponse::deserialize(&json) else {
+        return false;
+    };
+    let shared = Mutex::new(std::mem::take(cache));
+    let changed = apply_sync_response(&resp, &shared);
+    *cache = shared.into_inner().unwrap_or_else(|e| e.into_inner());
+    changed
+}
+
+/// Deserialize a raw /sync body and merge it into `cache`.
+fn parse_sync_bytes(body: &[u8], cache: &Mutex<SyncCache>) -> Result<bool, String> {
+    let resp: SyncResponse<'_> = serde_json::from_slice(body).map_err(|e| e.to_string())?;
+    Ok(apply_sync_response(&resp, cache))
+}
+
+/// Merge a typed response into `cache`, taking the lock once per room.
+///
+/// The render thread locks the same cache for every frame, so holding it for
+/// the whole of a large initial sync stalled the UI. `next_batch` is advanced
+/// last, once everything it covers has been merged.
+fn apply_sync_response(resp: &SyncResponse<'_>, cache: &Mutex<SyncCache>) -> bool {
     let mut changed = false;
 
-    if let Some(nb) = json.get("next_batch").and_then(|v| v.as_str()) {
-        if cache.next_batch != nb {
-            cache.next_batch = nb.to_owned();
+    // m.direct first — rooms below need it to set is_dm.
+    if let Some(direct) = direct_rooms(&resp.account_data) {
+        let mut locked = lock(cache);
+        if apply_direct_rooms(direct, &mut locked) {
+            // DM status moves rooms between list sections; rare enough to
+            // re-index everything.
+            locked.reindex_all();
             changed = true;
         }
     }
 
-    // Parse m.direct from account_data first — rooms below need it to set is_dm.
-    parse_account_data(&json, cache, &mut changed);
+    // rooms.invite — pending invites.
+    for (room_id, room) in &resp.rooms.invite {
+        changed |= apply_invite(room_id, room, &mut lock(cache));
+    }
 
-    // Process rooms.
-    let rooms_val = json.get("rooms");
+    // rooms.join — active joined rooms.
+    for (room_id, room) in &resp.rooms.join {
+        let mut locked = lock(cache);
+        if apply_joined_room(room_id, room, &mut locked) {
+            locked.reindex_room(room_id);
+            locked.dirty_rooms.insert(room_id.clone());
+            changed = true;
+        }
+    }
 
-    // rooms.invite — pending invites.
-    if let Some(invite_map) = rooms_val
-        .and_then(|r| r.get("invite"))
-        .and_then(|i| i.as_object())
-    {
-        for (room_id, room_data) in invite_map {
-            if cache.rooms.contains_key(room_id) {
-                continue; // already joined; skip
-            }
-            let mut display_name = room_id.clone();
-            let mut inviter = String::new();
-            if let Some(events) = room_data
-                .get("invite_state")
-                .and_then(|s| s.get("events"))
-                .and_then(|e| e.as_array())
-            {
-                for ev in events {
-                    let ev_type = ev.get("type").and_then(|t| t.as_str()).unwrap_or("");
-                    let state_key = ev.get("state_key").and_then(|s| s.as_str()).unwrap_or("");
-                    match ev_type {
-                        "m.room.name" => {
-                            if let Some(name) = ev
-                                .get("content")
-                                .and_then(|c| c.get("name"))
-                                .and_then(|n| n.as_str())
-                            {
-                                if !name.is_empty() {
-                                    display_name = name.to_owned();
-                                }
-                            }
-                        }
-                        "m.room.member"
-                            if !cache.self_user_id.is_empty()
-                                && state_key == cache.self_user_id =>
-                        {
-                            inviter = ev
-                                .get("sender")
-                                .and_then(|s| s.as_str())
-                                .unwrap_or("")
-                                .to_owned();
-                        }
-                        _ => {}
-                    }
-                }
-            }
-            if !cache.invites.contains_key(room_id) {
-                cache.invites.insert(
-                    room_id.clone(),
-                    InviteState {
-                        display_name,
-                        inviter,
-                    },
-                );
-                changed = true;
-            }
+    let mut locked = lock(cache);
+
+    // rooms.leave — remove rooms the user left or was kicked from.
+    for room_id in resp.rooms.leave.keys() {
+        if locked.remove_room(room_id).is_some() {
+            locked.dirty_rooms.insert(room_id.clone());
+            changed = true;
+        }
+        if locked.remove_invite(room_id).is_some() {
+            changed = true;
         }
     }
 
-    // rooms.join — active joined rooms.
-    if let Some(join) = rooms_val
-        .and_then(|r| r.get("join"))
-        .and_then(|j| j.as_object())
-    {
-        for (room_id, room_data) in join {
-            // Clear any pending invite — the user accepted it.
-            if cache.invites.remove(room_id).is_some() {
-                changed = true;
-            }
+    if let Some(nb) = resp.next_batch.get() {
+        if locked.next_batch != nb {
+            locked.next_batch = nb.to_owned();
+            changed = true;
+        }
+    }
 
-            let is_dm = cache.direct_room_ids.contains(room_id.as_str());
+    changed
+}
 
-            let entry = cache.rooms.entry(room_id.clone()).or_insert_with(|| {
-                changed = true;
-                RoomState {
-                    room_id: room_id.clone(),
-                    display_name: room_id.clone(),
-                    is_dm,
-                    ..Default::default()
+/// Merge one pending invite. Rooms already joined are skipped.
+fn apply_invite(room_id: &str, room: &InvitedRoom<'_>, cache: &mut SyncCache) -> bool {
+    if cache.rooms.contains_key(room_id) || cache.invites.contains_key(room_id) {
+        return false;
+    }
+    let mut display_name = room_id.to_owned();
+    let mut inviter = String::new();
+    for ev in &room.invite_state.events {
+        match ev.kind.as_str() {
+            "m.room.name" => {
+                if let Some(name) = ev.content.0.name.get().filter(|n| !n.is_empty()) {
+                    display_name = name.to_owned();
                 }
-            });
-
-            // State events — room name, kind, space children, members.
-            if let Some(state_events) = room_data
-                .get("state")
-                .and_then(|s| s.get("events"))
-                .and_then(|e| e.as_array())
+            }
+            "m.room.member"
+                if !cache.self_user_id.is_empty()
+                    && ev.state_key.as_str() == cache.self_user_id =>
             {
-                for ev in state_events {
-                    let ev_type = ev.get("type").and_then(|t| t.as_str()).unwrap_or("");
-                    let state_key = ev.get("state_key").and_then(|s| s.as_str()).unwrap_or("");
-                    apply_state_event(ev, ev_type, state_key, entry, &mut changed);
-                }
+                inviter = ev.sender.as_str().to_owned();
             }
+            _ => {}
+        }
+    }
+    cache.insert_invite(
+        room_id.to_owned(),
+        InviteState {
+            display_name,
+            inviter,
+        },
+    );
+    true
+}
 
-            // Timeline events — room name updates, member changes, messages.
-            if let Some(timeline_events) = room_data
-                .get("timeline")
-                .and_then(|t| t.get("events"))
-                .and_then(|e| e.as_array())
-            {
-                for ev in timeline_events {
-                    let ev_type = ev.get("type").and_then(|t| t.as_str()).unwrap_or("");
-                    let state_key = ev.get("state_key").and_then(|s| s.as_str()).unwrap_or("");
-
-                    // State events delivered via timeline still carry state_key.
-                    if ev.get("state_key").is_some() {
-                        apply_state_event(ev, ev_type, state_key, entry, &mut changed);
-                        if ev_type == "m.room.message" {
-                            // m.room.message is never a state event — fall through to message parsing.
-                        } else {
-                            continue;
-                        }
-                    }
+/// Merge one joined room's state, timeline and notification counts.
+fn apply_joined_room(room_id: &str, room: &JoinedRoom<'_>, cache: &mut SyncCache) -> bool {
+    let mut changed = false;
 
-                    if ev_type == "m.room.encrypted" {
-                        let event_id = ev
-                            .get("event_id")
-                            .and_then(|v| v.as_str())
-                            .unwrap_or("")
-                            .to_owned();
-                        if event_id.is_empty()
-                            || entry.timeline.iter().any(|e| e.event_id == event_id)
-                        {
-                            continue;
-                        }
-                        let sender = ev
-                            .get("sender")
-                            .and_then(|v| v.as_str())
-                            .unwrap_or("?")
-                            .to_owned();
-                        let origin_server_ts = ev
-                            .get("origin_server_ts")
-                            .and_then(|v| v.as_i64())
-                            .unwrap_or(0);
-                        entry.timeline.push(TimelineEvent {
-                            event_id,
-                            sender,
-                            body: "[encrypted message]".to_owned(),
-                            origin_server_ts,
-                        });
-                        changed = true;
-                        continue;
-                    }
+    // Clear any pending invite — the user accepted it.
+    if cache.remove_invite(room_id).is_some() {
+        changed = true;
+    }
 
-                    if ev_type != "m.room.message" {
-                        continue;
-                    }
+    let is_dm = cache.direct_room_ids.contains(room_id);
 
-                    let event_id = ev
-                        .get("event_id")
-                        .and_then(|v| v.as_str())
-                        .unwrap_or("")
-                        .to_owned();
-                    if !event_id.is_empty() && entry.timeline.iter().any(|e| e.event_id == event_id)
-                    {
-                        continue; // duplicate
-                    }
-                    let sender = ev
-                        .get("sender")
-                        .and_then(|v| v.as_str())
-                        .unwrap_or("?")
-                        .to_owned();
-                    let body = ev
-                        .get("content")
-                        .and_then(|c| c.get("body"))
-                        .and_then(|v| v.as_str())
-                        .unwrap_or("(media)")
-                        .to_owned();
-                    let origin_server_ts = ev
-                        .get("origin_server_ts")
-                        .and_then(|v| v.as_i64())
-                        .unwrap_or(0);
-                    entry.timeline.push(TimelineEvent {
-                        event_id,
-                        sender,
-                        body,
-                        origin_server_ts,
-                    });
-                    changed = true;
-                }
+    let entry = cache.rooms.entry(room_id.to_owned()).or_insert_with(|| {
+        changed = true;
+        RoomState {
+            room_id: room_id.to_owned(),
+            display_name: room_id.to_owned(),
+            is_dm,
+            ..Default::default()
+        }
+    });
 
-                if entry.timeline.len() > MAX_TIMELINE {
-                    let drain = entry.timeline.len() - MAX_TIMELINE;
-                    entry.timeline.drain(..drain);
-                }
+    // State events — room name, kind, space children, members.
+    for ev in &room.state.events {
+        apply_state_event(ev, entry, &mut changed);
+    }
 
-                // Store the prev_batch token for history pagination.
-                if let Some(pb) = room_data
-                    .get("timeline")
-                    .and_then(|t| t.get("prev_batch"))
-                    .and_then(|v| v.as_str())
-                {
-                    if entry.prev_batch.as_deref() != Some(pb) {
-                        entry.prev_batch = Some(pb.to_owned());
-                    }
-                }
+    // A limited timeline leaves a gap after what we hold (typically after
+    // resuming from the store); drop the stale tail rather than splice across
+    // it. "load earlier messages" pages back from the new prev_batch.
+    if room.timeline.limited && !entry.timeline.is_empty() {
+        entry.timeline.clear();
+        changed = true;
+    }
+
+    // Timeline events — room name updates, member changes, messages.
+    for ev in &room.timeline.events {
+        let ev_type = ev.kind.as_str();
+
+        // State events delivered via timeline still carry state_key.
+        // m.room.message is never a state event — it falls through to
+        // message parsing.
+        if ev.state_key.get().is_some() {
+            apply_state_event(ev, entry, &mut changed);
+            if ev_type != "m.room.message" {
+                continue;
             }
+        }
 
-            // Update unread/mention counts.
-            if let Some(notifs) = room_data.get("unread_notifications") {
-                let unread = notifs
-                    .get("notification_count")
-                    .and_then(|v| v.as_u64())
-                    .unwrap_or(0) as u32;
-                let highlight = notifs
-                    .get("highlight_count")
-                    .and_then(|v| v.as_u64())
-                    .unwrap_or(0) as u32;
-                let entry = cache.rooms.get_mut(room_id).unwrap();
-                if entry.unread_count != unread || entry.highlight_count != highlight {
-                    entry.unread_count = unread;
-                    entry.highlight_count = highlight;
-                    changed = true;
+        let body = match ev_type {
+            "m.room.encrypted" => {
+                if ev.event_id.as_str().is_empty() {
+                    continue;
                 }
+                "[encrypted message]"
             }
+            "m.room.message" => ev.content.0.body.get().unwrap_or("(media)"),
+            _ => continue,
+        };
+        let event_id = ev.event_id.as_str();
+        if !event_id.is_empty() && entry.timeline.iter().any(|e| e.event_id == event_id) {
+            continue; // duplicate
         }
+        entry.timeline.push(TimelineEvent {
+            event_id: event_id.to_owned(),
+            sender: ev.sender.get().unwrap_or("?").to_owned(),
+            body: body.to_owned(),
+            origin_server_ts: ev.origin_server_ts.unwrap_or(0),
+        });
+        changed = true;
     }
 
-    // rooms.leave — remove rooms the user left or was kicked from.
-    if let Some(leave_map) = rooms_val
-        .and_then(|r| r.get("leave"))
-        .and_then(|l| l.as_object())
-    {
-        for room_id in leave_map.keys() {
-            if cache.rooms.remove(room_id).is_some() {
-                changed = true;
-            }
-            if cache.invites.remove(room_id).is_some() {
-                changed = true;
-            }
+    if entry.timeline.len() > MAX_TIMELINE {
+        let drain = entry.timeline.len() - MAX_TIMELINE;
+        entry.timeline.drain(..drain);
+    }
+
+    // Store the prev_batch token for history pagination.
+    if let Some(pb) = room.timeline.prev_batch.get() {
+        if entry.prev_batch.as_deref() != Some(pb) {
+            entry.prev_batch = Some(pb.to_owned());
+            changed = true;
+        }
+    }
+
+    // Update unread/mention counts.
+    if let Some(notifs) = &room.unread_notifications {
+        let unread = notifs.notification_count.unwrap_or(0) as u32;
+        let highlight = notifs.highlight_count.unwrap_or(0) as u32;
+        if entry.unread_count != unread || entry.highlight_count != highlight {
+            entry.unread_count = unread;
+            entry.highlight_count = highlight;
+            changed = true;
         }
     }
 
-    rebuild_display_map(cache);
     changed
 }
 
 /// Apply a single state event to a room's cached state.
-fn apply_state_event(
-    ev: &serde_json::Value,
-    ev_type: &str,
-    state_key: &str,
-    entry: &mut RoomState,
-    changed: &mut bool,
-) {
-    match ev_type {
+fn apply_state_event(ev: &Event<'_>, entry: &mut RoomState, changed: &mut bool) {
+    let content = &ev.content.0;
+    match ev.kind.as_str() {
         "m.room.name" => {
-            if let Some(name) = ev
-                .get("content")
-                .and_then(|c| c.get("name"))
-                .and_then(|n| n.as_str())
-            {
+            if let Some(name) = content.name.get() {
                 if !name.is_empty() && entry.display_name != name {
                     entry.display_name = name.to_owned();
                     *changed = true;
@@ -367,39 +711,23 @@ fn apply_state_event(
             }
         }
         "m.room.create" => {
-            if ev
-                .get("content")
-                .and_then(|c| c.get("type"))
-                .and_then(|t| t.as_str())
-                == Some("m.space")
-            {
-                if entry.kind != RoomKind::Space {
-                    entry.kind = RoomKind::Space;
-                    *changed = true;
-                }
+            if content.room_type.get() == Some("m.space") && entry.kind != RoomKind::Space {
+                entry.kind = RoomKind::Space;
+                *changed = true;
             }
         }
         "m.space.child" => {
-            let child_id = state_key;
-            let is_active = ev
-                .get("content")
-                .and_then(|c| c.get("via"))
-                .and_then(|v| v.as_array())
-                .map_or(false, |a| !a.is_empty());
-            if is_active
+            let child_id = ev.state_key.as_str();
+            if content.via.0
                 && !child_id.is_empty()
-                && !entry.space_children.contains(&child_id.to_owned())
+                && !entry.space_children.iter().any(|c| c == child_id)
             {
                 entry.space_children.push(child_id.to_owned());
                 *changed = true;
             }
         }
         "m.room.topic" => {
-            if let Some(topic) = ev
-                .get("content")
-                .and_then(|c| c.get("topic"))
-                .and_then(|t| t.as_str())
-            {
+            if let Some(topic) = content.topic.get() {
                 let new_topic = if topic.is_empty() {
                     None
                 } else {
@@ -418,28 +746,18 @@ fn apply_state_event(
             }
         }
         "m.room.member" => {
-            let user_id = state_key;
+            let user_id = ev.state_key.as_str();
             if user_id.is_empty() {
                 return;
             }
-            let membership = ev
-                .get("content")
-                .and_then(|c| c.get("membership"))
-                .and_then(|m| m.as_str())
-                .unwrap_or("")
-                .to_owned();
+            let membership = content.membership.as_str();
             if membership.is_empty() {
                 return;
             }
-            let display_name = ev
-                .get("content")
-                .and_then(|c| c.get("displayname"))
-                .and_then(|d| d.as_str())
-                .map(|s| s.to_owned());
             let member = Member {
                 user_id: user_id.to_owned(),
-                display_name,
-                membership,
+                display_name: content.displayname.get().map(|s| s.to_owned()),
+                membership: membership.to_owned(),
             };
             entry.members.insert(user_id.to_owned(), member);
             *changed = true;
@@ -448,72 +766,134 @@ fn apply_state_event(
     }
 }
 
-/// Parse top-level account_data events and update the DM room sets in `cache`.
-fn parse_account_data(json: &serde_json::Value, cache: &mut SyncCache, changed: &mut bool) {
-    let Some(acc_events) = json
-        .get("account_data")
-        .and_then(|a| a.get("events"))
-        .and_then(|e| e.as_array())
-    else {
-        return;
-    };
-
-    for ev in acc_events {
-        if ev.get("type").and_then(|t| t.as_str()) != Some("m.direct") {
-            continue;
-        }
-        let Some(content) = ev.get("content").and_then(|c| c.as_object()) else {
-            continue;
-        };
-        let mut new_ids: HashSet<String> = HashSet::new();
-        let mut new_to_user: HashMap<String, String> = HashMap::new();
-        for (user_id, room_list) in content {
-            if let Some(rooms) = room_list.as_array() {
-                for room_val in rooms {
-                    if let Some(room_id) = room_val.as_str() {
-                        new_ids.insert(room_id.to_owned());
-                        new_to_user.insert(room_id.to_owned(), user_id.clone());
-                    }
+/// The DM room sets from an `m.direct` account-data event, if the batch has one.
+fn direct_rooms(
+    account_data: &AccountData<'_>,
+) -> Option<(HashSet<String>, HashMap<String, String>)> {
+    // Only one m.direct event is expected per batch.
+    let ev = account_data
+        .events
+        .iter()
+        .find(|ev| ev.kind.get() == Some("m.direct"))?;
+    let content = ev.content.as_object()?;
+    let mut new_ids: HashSet<String> = HashSet::new();
+    let mut new_to_user: HashMap<String, String> = HashMap::new();
+    for (user_id, room_list) in content {
+        if let Some(rooms) = room_list.as_array() {
+            for room_val in rooms {
+                if let Some(room_id) = room_val.as_str() {
+                    new_ids.insert(room_id.to_owned());
+                    new_to_user.insert(room_id.to_owned(), user_id.clone());
                 }
             }
         }
-        if new_ids != cache.direct_room_ids {
-            cache.direct_room_ids = new_ids;
-            cache.direct_room_to_user = new_to_user;
-            // Update is_dm on already-cached rooms.
-            let direct_ids = &cache.direct_room_ids;
-            for room in cache.rooms.values_mut() {
-                room.is_dm = direct_ids.contains(&room.room_id);
-            }
-            *changed = true;
-        }
-        break; // only one m.direct event expected
     }
+    Some((new_ids, new_to_user))
 }
 
-fn rebuild_display_map(cache: &mut SyncCache) {
-    cache.display_to_id.clear();
-    cache.invite_display_to_id.clear();
-    for (room_id, state) in &cache.rooms {
-        let key = match state.kind {
-            RoomKind::Space => format!("[space] {}", state.display_name),
-            RoomKind::Room => {
-                if state.is_dm {
-                    if let Some(partner) = cache.direct_room_to_user.get(room_id) {
-                        format!("[dm] {}", partner)
-                    } else {
-                        state.display_name.clone()
-                    }
-                } else {
-                    state.display_name.clone()
-                }
+/// Replace the DM room sets and re-flag already-cached rooms.
+fn apply_direct_rooms(
+    (new_ids, new_to_user): (HashSet<String>, HashMap<String, String>),
+    cache: &mut SyncCache,
+) -> bool {
+    if new_ids == cache.direct_room_ids {
+        return false;
+    }
+    cache.direct_room_ids = new_ids;
+    cache.direct_room_to_user = new_to_user;
+    let direct_ids = &cache.direct_room_ids;
+    for room in cache.rooms.values_mut() {
+        room.is_dm = direct_ids.contains(&room.room_id);
+    }
+    true
+}
+
+#[derive(Debug, Default, Deserialize)]
+struct MembersResponse<'a> {
+    #[serde(borrow, default)]
+    chunk: Vec<Event<'a>>,
+}
+
+/// Replace a room's lazy-loaded member list with a /members response body.
+pub(crate) fn apply_members_response(body: &[u8], room: &mut RoomState) -> Result<(), String> {
+    let resp: MembersResponse<'_> = serde_json::from_slice(body).map_err(|e| e.to_string())?;
+    let mut changed = false;
+    room.members.clear();
+    for ev in &resp.chunk {
+        apply_state_event(ev, room, &mut changed);
+    }
+    room.members_loaded = true;
+    Ok(())
+}
+
+// ---------------------------------------------------------------------------
+// Room store persistence
+// ---------------------------------------------------------------------------
+
+/// Flushes the rooms touched since the last flush, and the `next_batch` they
+/// are current as of, to the room store at most once per
+/// [`STORE_FLUSH_INTERVAL`].
+struct StoreWriter {
+    store: Option<RoomStore>,
+    pending: bool,
+    last_write: Option<Instant>,
+}
+
+impl StoreWriter {
+    fn new(store: Option<RoomStore>) -> Self {
+        StoreWriter {
+            store,
+            pending: false,
+            last_write: None,
+        }
+    }
+
+    /// Note that the cache changed; writes through if the interval has elapsed.
+    fn record(&mut self, cache: &Mutex<SyncCache>, now: Instant) {
+        self.pending = true;
+        let due = self
+            .last_write
+            .map_or(true, |t| now.duration_since(t) >= STORE_FLUSH_INTERVAL);
+        if due {
+            self.flush_at(cache, now);
+        }
+    }
+
+    /// Write anything not yet in the store, including rooms dirtied outside
+    /// the sync loop (backfill, member loads).
+    fn flush(&mut self, cache: &Mutex<SyncCache>) {
+        self.pending = true;
+        self.flush_at(cache, Instant::now());
+    }
+
+    fn flush_at(&mut self, cache: &Mutex<SyncCache>, now: Instant) {
+        if !self.pending {
+            return;
+        }
+        self.pending = false;
+        self.last_write = Some(now);
+        let Some(store) = &mut self.store else {
+            // Nowhere to write; keep the dirty set from growing without bound.
+            lock(cache).dirty_rooms.clear();
+            return;
+        };
+        // Snapshot under the lock, write without it. A cache with no
+        // next_batch was never synced or has just been reset by the provider;
+        // writing it would wipe the stored invites and DM map.
+        let snap = {
+            let mut locked = lock(cache);
+            if locked.next_batch.is_empty() {
+                return;
             }
+            Snapshot::take(&mut locked)
         };
-        cache.display_to_id.insert(key, room_id.clone());
-    }
-    for (room_id, inv) in &cache.invites {
-        let key = format!("[invite] {}", inv.display_name);
-        cache.invite_display_to_id.insert(key, room_id.clone());
+        if store.save(&snap).is_err() {
+            // Retry these rooms on the next flush.
+            lock(cache)
+                .dirty_rooms
+                .extend(snap.rooms.into_iter().map(|(id, _)| id));
+            self.pending = true;
+        }
     }
 }
 
@@ -525,7 +905,8 @@ pub struct SyncController {
     cache: Arc<Mutex<SyncCache>>,
     notify: Arc<AtomicBool>,
     running: Arc<AtomicBool>,
-    thread: Option<std::thread::JoinHandle<()>>,
+    /// Wakes the running task out of its long-poll or back-off on `stop`.
+    stop: Arc<tokio::sync::Notify>,
 }
 
 impl SyncController {
@@ -534,58 +915,56 @@ impl SyncController {
             cache,
             notify,
             running: Arc::new(AtomicBool::new(false)),
-            thread: None,
+            stop: Arc::new(tokio::sync::Notify::new()),
         }
     }
 
-    /// Start (or restart) the /sync background thread.
+    /// Start (or restart) the /sync background task.
     ///
-    /// Stops any existing session first, then spawns a new thread.
-    /// `config_path` is used to persist the `next_batch` token.
-    /// `user_id` seeds `cache.self_user_id` for invite parsing.
-    /// `file_lock` serialises settings-file writes with the main thread.
+    /// Stops any existing session first, then spawns a new task on
+    /// [`runtime()`]. `store_path` is the room store to resume from and
+    /// write back to (`None` disables persistence). `user_id` seeds
+    /// `cache.self_user_id` for invite parsing.
     pub fn start(
         &mut self,
         homeserver: String,
         access_token: String,
-        config_path: Option<std::path::PathBuf>,
+        store_path: Option<PathBuf>,
         user_id: String,
-        file_lock: Arc<Mutex<()>>,
     ) {
         self.stop();
 
+        // Fresh flag and signal per session, so a stopped task that has not
+        // yet noticed can never be revived by the next `start`.
+        self.running = Arc::new(AtomicBool::new(true));
+        self.stop = Arc::new(tokio::sync::Notify::new());
+
         let cache = Arc::clone(&self.cache);
         let notify = Arc::clone(&self.notify);
         let running = Arc::clone(&self.running);
-        running.store(true, Ordering::Relaxed);
-
-        self.thread = Some(std::thread::spawn(move || {
-            sync_loop(
-                homeserver,
-                access_token,
-                config_path,
-                user_id,
-                file_lock,
-                cache,
-                notify,
-                running,
-            );
-        }));
-    }
-
-    /// Stop the background sync thread.
+        let stop = Arc::clone(&self.stop);
+
+        runtime().spawn(sync_loop(
+            homeserver,
+            access_token,
+            store_path,
+            user_id,
+            cache,
+            notify,
+            running,
+            stop,
+        ));
+    }
+
+    /// Stop the background sync task.
     ///
-    /// Sets the running flag to false and hands the join handle to a
-    /// background cleanup thread so the OS doesn't accumulate zombie threads
-    /// across rapid start/stop cycles, while still avoiding a block on the
-    /// main thread (the HTTP long-poll timeout is up to 60 s).
+    /// Clears the running flag and wakes the task, which abandons any
+    /// in-flight long-poll, flushes pending changes to the store and exits.
+    /// Never blocks the caller.
     pub fn stop(&mut self) {
         self.running.store(false, Ordering::Relaxed);
-        if let Some(handle) = self.thread.take() {
-            std::thread::spawn(move || {
-                let _ = handle.join();
-            });
-        }
+        // notify_one stores a permit if the task is between awaits.
+        self.stop.notify_one();
     }
 
     #[cfg(test)]
@@ -604,64 +983,80 @@ impl Drop for SyncController {
 // Sync loop
 // ---------------------------------------------------------------------------
 
-fn sync_loop(
+async fn sync_loop(
     homeserver: String,
     access_token: String,
-    config_path: Option<std::path::PathBuf>,
+    store_path: Option<PathBuf>,
     user_id: String,
-    file_lock: Arc<Mutex<()>>,
     cache: Arc<Mutex<SyncCache>>,
     notify: Arc<AtomicBool>,
     running: Arc<AtomicBool>,
+    stop: Arc<tokio::sync::Notify>,
 ) {
+    let store = store_path.as_deref().and_then(RoomStore::open);
+
+    // Resume from the stored rooms, unless the cache is already warm.
+    if let Some(store) = &store {
+        if lock(&cache).next_batch.is_empty() {
+            if let Some(mut warm) = store.load() {
+                let mut locked = lock(&cache);
+                warm.self_user_id = std::mem::take(&mut locked.self_user_id);
+                *locked = warm;
+                notify.store(true, Ordering::Relaxed);
+            }
+        }
+    }
+
+    let mut writer = StoreWriter::new(store);
+
     while running.load(Ordering::Relaxed) {
-        match run_sync_session(
+        let session = run_sync_session(
             &homeserver,
             &access_token,
-            &config_path,
             &user_id,
-            &file_lock,
             &cache,
             &notify,
             &running,
-        ) {
-            Ok(()) | Err(_) => {}
+            &mut writer,
+        );
+        tokio::select! {
+            _ = session => {}
+            _ = stop.notified() => break,
         }
 
         if !running.load(Ordering::Relaxed) {
             break;
         }
 
-        for _ in 0..RECONNECT_DELAY_SECS {
-            if !running.load(Ordering::Relaxed) {
-                return;
-            }
-            std::thread::sleep(Duration::from_secs(1));
+        tokio::select! {
+            _ = tokio::time::sleep(Duration::from_secs(RECONNECT_DELAY_SECS)) => {}
+            _ = stop.notified() => break,
         }
     }
+
+    writer.flush(&cache);
 }
 
 /// Build the HTTP client once, then loop over /sync calls until an error or
 /// the running flag is cleared.
-fn run_sync_session(
+async fn run_sync_session(
     homeserver: &str,
     access_token: &str,
-    config_path: &Option<std::path::PathBuf>,
     user_id: &str,
-    file_lock: &Arc<Mutex<()>>,
-    cache: &Arc<Mutex<SyncCache>>,
-    notify: &Arc<AtomicBool>,
-    running: &Arc<AtomicBool>,
+    cache: &Mutex<SyncCache>,
+    notify: &AtomicBool,
+    running: &AtomicBool,
+    writer: &mut StoreWriter,
 ) -> Result<(), String> {
     // Seed self_user_id into the cache if provided.
     if !user_id.is_empty() {
-        let mut locked = lock(&cache);
+        let mut locked = lock(cache);
         if locked.self_user_id.is_empty() {
             locked.self_user_id = user_id.to_owned();
         }
     }
 
-    let client = reqwest::blocking::Client::builder()
+    let client = reqwest::Client::builder()
         .user_agent("sicompass/1.0")
         .timeout(Duration::from_secs(60))
         .build()
@@ -674,85 +1069,34 @@ fn run_sync_session(
             return Ok(());
         }
 
-        let since = lock(&cache).next_batch.clone();
-        let url = if since.is_empty() {
-            format!("{base}/_matrix/client/v3/sync?timeout=0")
+        let since = lock(cache).next_batch.clone();
+        let mut query = vec![("filter", SYNC_FILTER)];
+        if since.is_empty() {
+            query.push(("timeout", "0"));
         } else {
-            format!("{base}/_matrix/client/v3/sync?since={since}&timeout=30000")
-        };
+            query.extend([("since", since.as_str()), ("timeout", "30000")]);
+        }
 
         let resp = client
-            .get(&url)
+            .get(format!("{base}/_matrix/client/v3/sync"))
+            .query(&query)
             .header("Authorization", format!("Bearer {access_token}"))
             .send()
+            .await
             .map_err(|e| e.to_string())?;
 
         if !resp.status().is_success() {
             return Err(format!("HTTP {}", resp.status()));
         }
 
-        let body: serde_json::Value = resp.json().map_err(|e| e.to_string())?;
-        let next_batch = body
-            .get("next_batch")
-            .and_then(|v| v.as_str())
-            .unwrap_or("")
-            .to_owned();
-
-        let changed = {
-            let mut locked = lock(&cache);
-            parse_sync_response(body, &mut locked)
-        };
-
-        if changed {
+        let body = resp.bytes().await.map_err(|e| e.to_string())?;
+        if parse_sync_bytes(&body, cache)? {
             notify.store(true, Ordering::Relaxed);
-            if !next_batch.is_empty() {
-                persist_next_batch(config_path, &next_batch, file_lock);
-            }
+            writer.record(cache, Instant::now());
         }
     }
 }
 
-/// Write `next_batch` into settings.json under `"chat client"."chatSyncNextBatch"`.
-///
-/// `file_lock` must be the same mutex used by `save_setting` on the main thread
-/// to serialise all read-modify-write cycles on the settings file.
-fn persist_next_batch(
-    config_path: &Option<std::path::PathBuf>,
-    token: &str,
-    file_lock: &Arc<Mutex<()>>,
-) {
-    use serde_json::{Map, Value};
-    let Some(path) = config_path else { return };
-    let _guard = lock(file_lock);
-    // Read-modify-write. CRITICAL: never start from an empty map on a read or
-    // parse failure — doing so would overwrite settings.json with just this one
-    // key, wiping every other section (enabled programs, login tokens, …). An
-    // unparseable file means another writer is mid-write, so abort instead.
-    // Only a genuinely-absent file (first run) legitimately starts empty.
-    let mut root: Map<String, Value> = match std::fs::read_to_string(path) {
-        Ok(s) => match serde_json::from_str::<Value>(&s) {
-            Ok(Value::Object(m)) => m,
-            _ => return,
-        },
-        Err(e) if e.kind() == std::io::ErrorKind::NotFound => Map::new(),
-        Err(_) => return,
-    };
-    let section = root
-        .entry("chat client".to_owned())
-        .or_insert_with(|| Value::Object(Map::new()));
-    if let Value::Object(m) = section {
-        m.insert(
-            "chatSyncNextBatch".to_owned(),
-            Value::String(token.to_owned()),
-        );
-    }
-    if let Ok(json) = serde_json::to_string_pretty(&Value::Object(root)) {
-        // Atomic write (temp + rename) so concurrent readers never observe a
-        // truncated file mid-write.
-        let _ = sicompass_sdk::platform::atomic_write(path, &json);
-    }
-}
-
 // ---------------------------------------------------------------------------
 // Tests
 // ---------------------------------------------------------------------------
@@ -970,7 +1314,6 @@ mod tests {
             "tok".to_owned(),
             None,
             String::new(),
-            Arc::new(Mutex::new(())),
         );
         std::thread::sleep(Duration::from_millis(100));
         ctrl.stop();
@@ -987,7 +1330,6 @@ mod tests {
             "tok".to_owned(),
             None,
             String::new(),
-            Arc::new(Mutex::new(())),
         );
         assert!(ctrl.is_running());
         ctrl.stop();
@@ -1244,4 +1586,145 @@ mod tests {
                 .contains_key("[invite] !nameless:server")
         );
     }
+
+    #[test]
+    fn content_of_the_wrong_type_does_not_drop_the_batch() {
+        let mut cache = SyncCache::default();
+        let json = serde_json::json!({
+            "next_batch": "s1",
+            "rooms": { "join": { "!r:s": {
+                "state": { "events": [
+                    { "type": "m.room.name", "state_key": "", "content": { "name": 42 } },
+                    { "type": "m.room.topic", "state_key": "", "content": "not an object" },
+                    { "type": "m.space.child", "state_key": "!c:s", "content": { "via": "x" } }
+                ] },
+                "timeline": { "events": [
+                    { "type": "m.room.message", "event_id": "$1", "sender": "@a:s",
+                      "content": { "body": ["odd"] } },
+                    { "type": "m.room.message", "event_id": "$2", "sender": "@a:s",
+                      "content": { "body": "fine" } }
+                ] }
+            } } }
+        });
+        assert!(parse_sync_response(json, &mut cache));
+        let room = &cache.rooms["!r:s"];
+        assert_eq!(room.display_name, "!r:s");
+        assert!(room.topic.is_none());
+        assert!(room.space_children.is_empty());
+        let bodies: Vec<&str> = room.timeline.iter().map(|e| e.body.as_str()).collect();
+        assert_eq!(bodies, ["(media)", "fine"]);
+        assert_eq!(cache.next_batch, "s1");
+    }
+
+    #[test]
+    fn parse_sync_bytes_decodes_escapes() {
+        let cache = Mutex::new(SyncCache::default());
+        let body = br#"{"next_batch":"s7","rooms":{"join":{"!r:s":{"timeline":{"events":[
+            {"type":"m.room.message","event_id":"$1","sender":"@a:s","content":{"body":"caf\u00e9"}}
+        ]}}}}}"#;
+        assert!(parse_sync_bytes(body, &cache).unwrap());
+        assert_eq!(lock(&cache).next_batch, "s7");
+        assert_eq!(lock(&cache).rooms["!r:s"].timeline[0].body, "café");
+    }
+
+    #[test]
+    fn store_writes_are_debounced_and_flushed() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("chat.db");
+        let cache = Mutex::new(SyncCache::default());
+        let mut writer = StoreWriter::new(RoomStore::open(&path));
+        let t0 = Instant::now();
+        let stored = || RoomStore::open(&path).unwrap().load().map(|c| c.next_batch);
+
+        let json = make_sync_response("s1", "!r:s", None, &[("$1", "@a:s", "one")]);
+        let body = serde_json::to_vec(&json).unwrap();
+        assert!(parse_sync_bytes(&body, &cache).unwrap());
+        writer.record(&cache, t0);
+        assert_eq!(stored().as_deref(), Some("s1"));
+
+        let json = make_sync_response("s2", "!r:s", None, &[("$2", "@a:s", "two")]);
+        let body = serde_json::to_vec(&json).unwrap();
+        assert!(parse_sync_bytes(&body, &cache).unwrap());
+        writer.record(&cache, t0 + Duration::from_secs(1));
+        assert_eq!(stored().as_deref(), Some("s1"));
+
+        writer.flush(&cache);
+        let warm = RoomStore::open(&path).unwrap().load().unwrap();
+        assert_eq!(warm.next_batch, "s2");
+        assert_eq!(warm.rooms["!r:s"].timeline.len(), 2);
+        assert!(lock(&cache).dirty_rooms.is_empty());
+    }
+
+    #[test]
+    fn limited_timeline_drops_events_before_the_gap() {
+        let mut cache = SyncCache::default();
+        let json = make_sync_response("s1", "!r:s", None, &[("$1", "@a:s", "old")]);
+        parse_sync_response(json, &mut cache);
+        let json = serde_json::json!({
+            "next_batch": "s2",
+            "rooms": { "join": { "!r:s": { "timeline": {
+                "limited": true,
+                "prev_batch": "p2",
+                "events": [{ "type": "m.room.message", "event_id": "$9",
+                             "sender": "@a:s", "content": { "body": "new" } }]
+            } } } }
+        });
+        assert!(parse_sync_response(json, &mut cache));
+        let room = &cache.rooms["!r:s"];
+        let bodies: Vec<&str> = room.timeline.iter().map(|e| e.body.as_str()).collect();
+        assert_eq!(bodies, ["new"]);
+        assert_eq!(room.prev_batch.as_deref(), Some("p2"));
+        assert!(cache.dirty_rooms.contains("!r:s"));
+    }
+
+    #[test]
+    fn members_response_replaces_lazy_loaded_members() {
+        let mut room = RoomState::default();
+        room.members.insert(
+            "@gone:s".to_owned(),
+            Member {
+                user_id: "@gone:s".to_owned(),
+                display_name: None,
+                membership: "join".to_owned(),
+            },
+        );
+        let body = br#"{"chunk":[
+            {"type":"m.room.member","state_key":"@a:s","content":{"membership":"join","displayname":"A"}},
+            {"type":"m.room.member","state_key":"@b:s","content":{"membership":"invite"}}
+        ]}"#;
+        apply_members_response(body, &mut room).unwrap();
+        assert!(room.members_loaded);
+        assert_eq!(room.members.len(), 2);
+        assert_eq!(room.members["@a:s"].display_name.as_deref(), Some("A"));
+    }
+
+    #[test]
+    fn batch_reindexes_only_touched_rooms() {
+        let mut cache = SyncCache::default();
+        let json = make_sync_response("s1", "!a:s", Some("Alpha"), &[("$1", "@a:s", "hi")]);
+        parse_sync_response(json, &mut cache);
+        let json = make_sync_response("s2", "!b:s", Some("Beta"), &[]);
+        parse_sync_response(json, &mut cache);
+
+        // Renaming !a:s moves its display key; !b:s keeps its entry.
+        let json = make_sync_response("s3", "!a:s", Some("Gamma"), &[]);
+        assert!(parse_sync_response(json, &mut cache));
+        assert!(!cache.display_to_id.contains_key("Alpha"));
+        assert_eq!(cache.display_to_id["Gamma"], "!a:s");
+        assert_eq!(cache.display_to_id["Beta"], "!b:s");
+        let rows: Vec<String> = cache
+            .room_index
+            .rows()
+            .map(|e| e.as_obj().unwrap().key.clone())
+            .collect();
+        assert_eq!(rows, ["Gamma", "Beta"]);
+
+        let json = serde_json::json!({
+            "next_batch": "s4",
+            "rooms": { "leave": { "!a:s": {} } }
+        });
+        assert!(parse_sync_response(json, &mut cache));
+        assert!(!cache.display_to_id.contains_key("Gamma"));
+        assert_eq!(cache.room_index.rows().count(), 1);
+    }
 }
@@ -7,3 +7,9 @@ claude-display-name = claude
 claude-command-session = Sitzung
 claude-command-browse = Ordner
 claude-command-skills = Fähigkeiten
+
+# Überschriften über den früheren Sitzungen, die über der Eingabe aufgelistet
+# werden.
+claude-past-here = frühere Sitzungen hier
+claude-past-matching = Sitzungen, die { $query } erwähnen
+claude-past-no-match = keine frühere Sitzung erwähnt { $query }
@@ -7,3 +7,9 @@ claude-display-name = claude
 claude-command-session = session
 claude-command-browse = folders
 claude-command-skills = skills
+
+# Headings over the earlier sessions listed above the prompt: the ones run in
+# this folder, or those `/resume <words>` found.
+claude-past-here = earlier sessions here
+claude-past-matching = sessions mentioning { $query }
+claude-past-no-match = no earlier session mentions { $query }
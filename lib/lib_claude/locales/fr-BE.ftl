@@ -6,3 +6,8 @@ claude-display-name = claude
 claude-command-session = session
 claude-command-browse = dossiers
 claude-command-skills = compétences
+
+# Titres au-dessus des sessions précédentes listées avant l'invite.
+claude-past-here = sessions précédentes ici
+claude-past-matching = sessions mentionnant { $query }
+claude-past-no-match = aucune session précédente ne mentionne { $query }
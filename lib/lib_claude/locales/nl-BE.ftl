@@ -6,3 +6,8 @@ claude-display-name = claude
 claude-command-session = sessie
 claude-command-browse = mappen
 claude-command-skills = vaardigheden
+
+# Koppen boven de eerdere sessies die boven de prompt opgesomd worden.
+claude-past-here = eerdere sessies hier
+claude-past-matching = sessies over { $query }
+claude-past-no-match = geen eerdere sessie vermeldt { $query }
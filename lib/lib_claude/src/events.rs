@@ -4,97 +4,150 @@
 //! These types deserialize those lines. The model is **Claude-specific** — it
 //! mirrors the documented event schema rather than being a generic JSON tree.
 //!
+//! Events borrow from the line they were parsed from, and only the fields the
+//! transcript shows are read out of it: strings without escapes are slices of
+//! the line, tool inputs and tool results stay raw JSON text until
+//! [`Conversation::apply`](crate::render::Conversation::apply) summarizes them,
+//! and everything else is skipped by the parser without being built. No
+//! `serde_json::Value` tree is made of a line, so a tool result carrying a
+//! whole file is scanned rather than copied.
+//!
+//! That is also why nothing here is an internally tagged serde enum: those
+//! buffer the whole object before they can look at its tag. A line, a content
+//! block and a streaming event each parse in one pass into a flat struct with
+//! the fields of every kind, and are told apart after.
+//!
 //! Robustness rule: a single malformed or unexpected line must never abort the
 //! session. [`parse_line`] swallows JSON errors and returns `None`; unknown
-//! `type` values deserialize to [`StreamEvent::Unknown`]; unknown content
-//! blocks to [`ContentBlock::Other`].
+//! `type` values parse to [`StreamEvent::Unknown`]; unknown content blocks to
+//! [`ContentBlock::Other`].
 
 use serde::Deserialize;
-use serde_json::Value;
+use serde::de::{self, Deserializer, IgnoredAny, MapAccess, SeqAccess, Visitor};
+use serde_json::value::RawValue;
+use std::borrow::Cow;
+use std::fmt;
 
 /// One line of the `stream-json` output stream.
-#[derive(Debug, Clone, Deserialize)]
-#[serde(tag = "type", rename_all = "lowercase")]
-pub enum StreamEvent {
-    System(SystemEvent),
-    Assistant(AssistantEvent),
-    User(UserEvent),
+#[derive(Debug, Clone)]
+pub enum StreamEvent<'a> {
+    System(SystemEvent<'a>),
+    Assistant(AssistantEvent<'a>),
+    User(UserEvent<'a>),
     Result(ResultEvent),
     /// `{"type":"stream_event","event":{...}}` — token-level streaming deltas,
     /// emitted only when `--include-partial-messages` is passed. The final
     /// consolidated `assistant` line still follows and supersedes them.
-    #[serde(rename = "stream_event")]
-    Partial(PartialEvent),
+    Partial(PartialEvent<'a>),
     /// Any `type` we do not model (forward compatibility).
-    #[serde(other)]
     Unknown,
 }
 
 /// The `stream_event` envelope around one Anthropic streaming event.
-#[derive(Debug, Clone, Deserialize)]
-pub struct PartialEvent {
-    pub event: PartialInner,
+#[derive(Debug, Clone)]
+pub struct PartialEvent<'a> {
+    pub event: PartialInner<'a>,
 }
 
 /// An inner streaming event (the Anthropic Messages API streaming schema).
-#[derive(Debug, Clone, Deserialize)]
-#[serde(tag = "type", rename_all = "snake_case")]
-pub enum PartialInner {
+#[derive(Debug, Clone)]
+pub enum PartialInner<'a> {
     ContentBlockStart {
-        #[serde(default)]
-        content_block: Value,
+        content_block: BlockStart<'a>,
     },
     ContentBlockDelta {
-        delta: PartialDelta,
+        delta: PartialDelta<'a>,
     },
     /// `message_start`, `content_block_stop`, `message_delta`, `message_stop`,
     /// and anything else — not needed for the live text preview.
-    #[serde(other)]
     Other,
 }
 
+/// The opening of a content block: what kind it is, and for a `tool_use` the
+/// tool's name. Its `input` is always empty at this point.
+#[derive(Debug, Clone, Default, Deserialize)]
+pub struct BlockStart<'a> {
+    #[serde(default, rename = "type", borrow)]
+    pub kind: Cow<'a, str>,
+    #[serde(default, borrow)]
+    pub name: Option<Cow<'a, str>>,
+}
+
 /// The `delta` of a `content_block_delta` event.
-#[derive(Debug, Clone, Deserialize)]
-#[serde(tag = "type", rename_all = "snake_case")]
-pub enum PartialDelta {
+#[derive(Debug, Clone)]
+pub enum PartialDelta<'a> {
     TextDelta {
-        #[serde(default)]
-        text: String,
+        text: Cow<'a, str>,
     },
     /// `input_json_delta` (partial tool input), `thinking_delta`, … — skipped
     /// in the live preview; the consolidated event carries the final value.
-    #[serde(other)]
     Other,
 }
 
+/// [`PartialInner`] as it is parsed, before the tag is looked at.
+#[derive(Deserialize)]
+struct FlatInner<'a> {
+    #[serde(default, rename = "type", borrow)]
+    kind: Cow<'a, str>,
+    #[serde(default, borrow)]
+    content_block: BlockStart<'a>,
+    #[serde(default, borrow)]
+    delta: Option<FlatDelta<'a>>,
+}
+
+#[derive(Deserialize)]
+struct FlatDelta<'a> {
+    #[serde(default, rename = "type", borrow)]
+    kind: Cow<'a, str>,
+    #[serde(default, borrow)]
+    text: Cow<'a, str>,
+}
+
+impl<'de: 'a, 'a> Deserialize<'de> for PartialInner<'a> {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        let flat = FlatInner::deserialize(d)?;
+        Ok(match &*flat.kind {
+            "content_block_start" => PartialInner::ContentBlockStart {
+                content_block: flat.content_block,
+            },
+            "content_block_delta" => {
+                let delta = flat
+                    .delta
+                    .ok_or_else(|| de::Error::missing_field("delta"))?;
+                PartialInner::ContentBlockDelta {
+                    delta: match &*delta.kind {
+                        "text_delta" => PartialDelta::TextDelta { text: delta.text },
+                        _ => PartialDelta::Other,
+                    },
+                }
+            }
+            _ => PartialInner::Other,
+        })
+    }
+}
+
 /// `{"type":"system","subtype":"init", ...}` — session bootstrap.
-#[derive(Debug, Clone, Deserialize)]
-pub struct SystemEvent {
-    #[serde(default)]
-    pub subtype: String,
-    #[serde(default)]
-    pub session_id: String,
-    #[serde(default)]
-    pub model: Option<String>,
-    #[serde(default)]
-    pub cwd: Option<String>,
-    #[serde(default, rename = "permissionMode")]
-    pub permission_mode: Option<String>,
-    #[serde(default)]
-    pub tools: Vec<String>,
+#[derive(Debug, Clone)]
+pub struct SystemEvent<'a> {
+    pub subtype: Cow<'a, str>,
+    pub session_id: Cow<'a, str>,
+    pub model: Option<Cow<'a, str>>,
+    pub cwd: Option<Cow<'a, str>>,
+    pub permission_mode: Option<Cow<'a, str>>,
+    pub tools: Vec<Cow<'a, str>>,
 }
 
 /// `{"type":"assistant","message":{...}}`. The `session_id` field is also
 /// present but unmodeled — it never differs from the `system/init` one.
-#[derive(Debug, Clone, Deserialize)]
-pub struct AssistantEvent {
-    pub message: ApiMessage,
+#[derive(Debug, Clone)]
+pub struct AssistantEvent<'a> {
+    pub message: ApiMessage<'a>,
 }
 
 /// `{"type":"user","message":{...}}` — tool results, mostly.
-#[derive(Debug, Clone, Deserialize)]
-pub struct UserEvent {
-    pub message: ApiMessage,
+#[derive(Debug, Clone)]
+pub struct UserEvent<'a> {
+    pub message: ApiMessage<'a>,
 }
 
 /// An Anthropic API message embedded in an assistant/user event.
@@ -102,99 +155,341 @@ pub struct UserEvent {
 /// Only `content` is modeled — the assistant/user distinction comes from the
 /// enclosing [`StreamEvent`] variant, so `role` is not needed.
 #[derive(Debug, Clone, Deserialize)]
-pub struct ApiMessage {
-    #[serde(default)]
-    pub content: ContentField,
+pub struct ApiMessage<'a> {
+    #[serde(default, borrow)]
+    pub content: ContentField<'a>,
 }
 
 /// `content` is sometimes a bare string, sometimes an array of blocks.
-#[derive(Debug, Clone, Deserialize)]
-#[serde(untagged)]
-pub enum ContentField {
-    Text(String),
-    Blocks(Vec<ContentBlock>),
+#[derive(Debug, Clone)]
+pub enum ContentField<'a> {
+    Text(Cow<'a, str>),
+    Blocks(Vec<ContentBlock<'a>>),
 }
 
-impl Default for ContentField {
+impl Default for ContentField<'_> {
     fn default() -> Self {
         ContentField::Blocks(Vec::new())
     }
 }
 
-impl ContentField {
+impl<'a> ContentField<'a> {
     /// Flatten to the list of blocks, promoting a bare string to one text block.
-    pub fn blocks(&self) -> Vec<ContentBlock> {
+    pub fn blocks(self) -> Vec<ContentBlock<'a>> {
         match self {
-            ContentField::Text(t) => vec![ContentBlock::Text { text: t.clone() }],
-            ContentField::Blocks(b) => b.clone(),
+            ContentField::Text(text) => vec![ContentBlock::Text { text }],
+            ContentField::Blocks(b) => b,
         }
     }
 }
 
+impl<'de: 'a, 'a> Deserialize<'de> for ContentField<'a> {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        struct FieldVisitor;
+
+        impl<'de> Visitor<'de> for FieldVisitor {
+            type Value = ContentField<'de>;
+
+            fn expecting(&self, f: &mut fmt::Formatter) -> fmt::Result {
+                f.write_str("a string or an array of content blocks")
+            }
+
+            fn visit_borrowed_str<E: de::Error>(self, v: &'de str) -> Result<Self::Value, E> {
+                Ok(ContentField::Text(Cow::Borrowed(v)))
+            }
+
+            fn visit_str<E: de::Error>(self, v: &str) -> Result<Self::Value, E> {
+                Ok(ContentField::Text(Cow::Owned(v.to_owned())))
+            }
+
+            fn visit_string<E: de::Error>(self, v: String) -> Result<Self::Value, E> {
+                Ok(ContentField::Text(Cow::Owned(v)))
+            }
+
+            fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> Result<Self::Value, A::Error> {
+                let mut blocks = Vec::new();
+                while let Some(block) = seq.next_element()? {
+                    blocks.push(block);
+                }
+                Ok(ContentField::Blocks(blocks))
+            }
+        }
+
+        d.deserialize_any(FieldVisitor)
+    }
+}
+
 /// A single content block inside an [`ApiMessage`].
-#[derive(Debug, Clone, Deserialize)]
-#[serde(tag = "type", rename_all = "snake_case")]
-pub enum ContentBlock {
+#[derive(Debug, Clone)]
+pub enum ContentBlock<'a> {
     Text {
-        #[serde(default)]
-        text: String,
+        text: Cow<'a, str>,
     },
     ToolUse {
-        #[serde(default)]
-        id: String,
-        #[serde(default)]
-        name: String,
-        #[serde(default)]
-        input: Value,
+        id: Cow<'a, str>,
+        name: Cow<'a, str>,
+        /// The tool's arguments, as the JSON text they arrived as.
+        input: &'a RawValue,
     },
     ToolResult {
-        #[serde(default)]
-        tool_use_id: String,
-        #[serde(default)]
-        content: Value,
-        #[serde(default)]
+        tool_use_id: Cow<'a, str>,
+        /// What the tool returned, as the JSON text it arrived as — a string,
+        /// an array of blocks, or occasionally something else. Read with
+        /// [`result_text`].
+        content: Option<&'a RawValue>,
         is_error: bool,
     },
     /// `thinking`, `image`, … — skipped in v1.
-    #[serde(other)]
     Other,
 }
 
+/// [`ContentBlock`] as it is parsed, before the tag is looked at.
+#[derive(Deserialize)]
+struct FlatBlock<'a> {
+    #[serde(default, rename = "type", borrow)]
+    kind: Cow<'a, str>,
+    #[serde(default, borrow)]
+    text: Cow<'a, str>,
+    #[serde(default, borrow)]
+    id: Cow<'a, str>,
+    #[serde(default, borrow)]
+    name: Cow<'a, str>,
+    #[serde(default, borrow)]
+    input: Option<&'a RawValue>,
+    #[serde(default, borrow)]
+    tool_use_id: Cow<'a, str>,
+    #[serde(default, borrow)]
+    content: Option<&'a RawValue>,
+    #[serde(default)]
+    is_error: bool,
+}
+
+impl<'de: 'a, 'a> Deserialize<'de> for ContentBlock<'a> {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        let flat = FlatBlock::deserialize(d)?;
+        Ok(match &*flat.kind {
+            "text" => ContentBlock::Text { text: flat.text },
+            "tool_use" => ContentBlock::ToolUse {
+                id: flat.id,
+                name: flat.name,
+                input: flat.input.unwrap_or(RawValue::NULL),
+            },
+            "tool_result" => ContentBlock::ToolResult {
+                tool_use_id: flat.tool_use_id,
+                content: flat.content,
+                is_error: flat.is_error,
+            },
+            _ => ContentBlock::Other,
+        })
+    }
+}
+
 /// `{"type":"result","subtype":"success", ...}` — end-of-turn summary.
 ///
 /// The event also carries `result` (the final assistant text, already streamed
 /// via `assistant` events), `session_id`, and `usage`; those are not modeled
 /// because serde ignores unmodeled fields and we render only the cost line.
-#[derive(Debug, Clone, Deserialize)]
+/// Owned, unlike the other events: the conversation keeps the last one.
+#[derive(Debug, Clone)]
 pub struct ResultEvent {
-    #[serde(default)]
     pub subtype: String,
-    #[serde(default)]
     pub num_turns: Option<u64>,
-    #[serde(default)]
     pub duration_ms: Option<u64>,
-    #[serde(default)]
     pub total_cost_usd: Option<f64>,
-    #[serde(default)]
     pub is_error: bool,
 }
 
+/// The text of a tool result's `content`, in the pieces it arrived in.
+///
+/// A bare string is one piece; an array of blocks gives the text of each text
+/// block (and each bare string), which read joined by newlines. Images and
+/// other blocks are skipped unread. `null` is no text at all, and anything
+/// else — or an array with no text in it — reads as its JSON.
+pub fn result_text(content: Option<&RawValue>) -> Vec<Cow<'_, str>> {
+    let Some(raw) = content else {
+        return Vec::new();
+    };
+    let json = raw.get();
+    match json.as_bytes().first() {
+        Some(b'"') => serde_json::from_str::<Cow<str>>(json)
+            .map(|text| vec![text])
+            .unwrap_or_default(),
+        Some(b'[') => match serde_json::from_str::<Vec<ResultPiece>>(json) {
+            Ok(pieces) => {
+                let texts: Vec<_> = pieces.into_iter().filter_map(|p| p.0).collect();
+                if texts.is_empty() {
+                    vec![Cow::Borrowed(json)]
+                } else {
+                    texts
+                }
+            }
+            Err(_) => vec![Cow::Borrowed(json)],
+        },
+        Some(b'n') => Vec::new(),
+        _ => vec![Cow::Borrowed(json)],
+    }
+}
+
+/// One element of a tool result's block array: its text, if it has any.
+struct ResultPiece<'a>(Option<Cow<'a, str>>);
+
+impl<'de: 'a, 'a> Deserialize<'de> for ResultPiece<'a> {
+    fn deserialize<D: Deserializer<'de>>(d: D) -> Result<Self, D::Error> {
+        struct PieceVisitor;
+
+        impl<'de> Visitor<'de> for PieceVisitor {
+            type Value = ResultPiece<'de>;
+
+            fn expecting(&self, f: &mut fmt::Formatter) -> fmt::Result {
+                f.write_str("a content block or a string")
+            }
+
+            fn visit_borrowed_str<E: de::Error>(self, v: &'de str) -> Result<Self::Value, E> {
+                Ok(ResultPiece(Some(Cow::Borrowed(v))))
+            }
+
+            fn visit_str<E: de::Error>(self, v: &str) -> Result<Self::Value, E> {
+                Ok(ResultPiece(Some(Cow::Owned(v.to_owned()))))
+            }
+
+            fn visit_string<E: de::Error>(self, v: String) -> Result<Self::Value, E> {
+                Ok(ResultPiece(Some(Cow::Owned(v))))
+            }
+
+            fn visit_map<A: MapAccess<'de>>(self, mut map: A) -> Result<Self::Value, A::Error> {
+                let mut text = None;
+                while let Some(key) = map.next_key::<Cow<str>>()? {
+                    if key == "text" {
+                        text = map.next_value::<Option<Cow<str>>>()?;
+                    } else {
+                        map.next_value::<IgnoredAny>()?;
+                    }
+                }
+                Ok(ResultPiece(text))
+            }
+
+            fn visit_unit<E: de::Error>(self) -> Result<Self::Value, E> {
+                Ok(ResultPiece(None))
+            }
+
+            fn visit_bool<E: de::Error>(self, _: bool) -> Result<Self::Value, E> {
+                Ok(ResultPiece(None))
+            }
+
+            fn visit_i64<E: de::Error>(self, _: i64) -> Result<Self::Value, E> {
+                Ok(ResultPiece(None))
+            }
+
+            fn visit_u64<E: de::Error>(self, _: u64) -> Result<Self::Value, E> {
+                Ok(ResultPiece(None))
+            }
+
+            fn visit_f64<E: de::Error>(self, _: f64) -> Result<Self::Value, E> {
+                Ok(ResultPiece(None))
+            }
+
+            fn visit_seq<A: SeqAccess<'de>>(self, mut seq: A) -> Result<Self::Value, A::Error> {
+                while seq.next_element::<IgnoredAny>()?.is_some() {}
+                Ok(ResultPiece(None))
+            }
+        }
+
+        d.deserialize_any(PieceVisitor)
+    }
+}
+
+/// The file a tool call works on, for the tools that name one: `file_path`
+/// (Read, Write, Edit) or `notebook_path` (NotebookEdit). A search scope such
+/// as Grep's `path` is not a file touched, and is not counted as one.
+pub fn tool_file(input: &RawValue) -> Option<String> {
+    #[derive(Deserialize)]
+    struct FileArgs<'a> {
+        #[serde(borrow, default)]
+        file_path: Option<Cow<'a, str>>,
+        #[serde(borrow, default)]
+        notebook_path: Option<Cow<'a, str>>,
+    }
+    let args: FileArgs = serde_json::from_str(input.get()).ok()?;
+    args.file_path
+        .or(args.notebook_path)
+        .filter(|p| !p.is_empty())
+        .map(Cow::into_owned)
+}
+
+/// A line as it is parsed, before the `type` is looked at: every top-level
+/// field any event we model has.
+#[derive(Deserialize)]
+struct FlatEvent<'a> {
+    #[serde(rename = "type", borrow)]
+    kind: Cow<'a, str>,
+    #[serde(default, borrow)]
+    subtype: Cow<'a, str>,
+    #[serde(default, borrow)]
+    session_id: Cow<'a, str>,
+    #[serde(default, borrow)]
+    model: Option<Cow<'a, str>>,
+    #[serde(default, borrow)]
+    cwd: Option<Cow<'a, str>>,
+    #[serde(default, rename = "permissionMode", borrow)]
+    permission_mode: Option<Cow<'a, str>>,
+    #[serde(default, borrow)]
+    tools: Vec<Cow<'a, str>>,
+    #[serde(default, borrow)]
+    message: Option<ApiMessage<'a>>,
+    #[serde(default, borrow)]
+    event: Option<PartialInner<'a>>,
+    #[serde(default)]
+    num_turns: Option<u64>,
+    #[serde(default)]
+    duration_ms: Option<u64>,
+    #[serde(default)]
+    total_cost_usd: Option<f64>,
+    #[serde(default)]
+    is_error: bool,
+}
+
 /// Parse one complete JSONL line into a [`StreamEvent`].
 ///
 /// Returns `None` for blank lines and for any line that is not valid JSON of a
 /// shape we recognize — a stray diagnostic line must not kill the session.
-pub fn parse_line(line: &str) -> Option<StreamEvent> {
+pub fn parse_line(line: &str) -> Option<StreamEvent<'_>> {
     let trimmed = line.trim();
     if trimmed.is_empty() {
         return None;
     }
-    serde_json::from_str::<StreamEvent>(trimmed).ok()
+    let flat: FlatEvent = serde_json::from_str(trimmed).ok()?;
+    let event = match &*flat.kind {
+        "system" => StreamEvent::System(SystemEvent {
+            subtype: flat.subtype,
+            session_id: flat.session_id,
+            model: flat.model,
+            cwd: flat.cwd,
+            permission_mode: flat.permission_mode,
+            tools: flat.tools,
+        }),
+        "assistant" => StreamEvent::Assistant(AssistantEvent {
+            message: flat.message?,
+        }),
+        "user" => StreamEvent::User(UserEvent {
+            message: flat.message?,
+        }),
+        "result" => StreamEvent::Result(ResultEvent {
+            subtype: flat.subtype.into_owned(),
+            num_turns: flat.num_turns,
+            duration_ms: flat.duration_ms,
+            total_cost_usd: flat.total_cost_usd,
+            is_error: flat.is_error,
+        }),
+        "stream_event" => StreamEvent::Partial(PartialEvent { event: flat.event? }),
+        _ => StreamEvent::Unknown,
+    };
+    Some(event)
 }
 
 /// Convenience: parse a batch of lines, dropping any that fail. Test-only —
 /// the provider parses lines one at a time as the reader thread delivers them.
 #[cfg(test)]
-pub fn parse_lines<'a, I: IntoIterator<Item = &'a str>>(lines: I) -> Vec<StreamEvent> {
+pub fn parse_lines<'a, I: IntoIterator<Item = &'a str>>(lines: I) -> Vec<StreamEvent<'a>> {
     lines.into_iter().filter_map(parse_line).collect()
 }
 
@@ -281,8 +576,8 @@ mod tests {
         match parse_line(line) {
             Some(StreamEvent::Partial(p)) => match p.event {
                 PartialInner::ContentBlockStart { content_block } => {
-                    assert_eq!(content_block["type"], "tool_use");
-                    assert_eq!(content_block["name"], "Bash");
+                    assert_eq!(content_block.kind, "tool_use");
+                    assert_eq!(content_block.name.as_deref(), Some("Bash"));
                 }
                 other => panic!("expected content_block_start, got {other:?}"),
             },
@@ -380,4 +675,137 @@ mod tests {
         let evs = parse_lines(raw);
         assert_eq!(evs.len(), 2);
     }
+
+    #[test]
+    fn unescaped_strings_borrow_from_the_line() {
+        let line = r#"{"type":"assistant","message":{"content":[{"type":"text","text":"plain"},{"type":"text","text":"two\nlines"},{"type":"tool_use","id":"tu_1","name":"Bash","input":{"command":"ls"}}]}}"#;
+        let Some(StreamEvent::Assistant(a)) = parse_line(line) else {
+            panic!("expected Assistant");
+        };
+        let blocks = a.message.content.blocks();
+        assert!(matches!(
+            &blocks[0],
+            ContentBlock::Text {
+                text: Cow::Borrowed("plain")
+            }
+        ));
+        // An escape has to be decoded into a string of its own.
+        assert!(
+            matches!(&blocks[1], ContentBlock::Text { text: Cow::Owned(t) } if t == "two\nlines")
+        );
+        match &blocks[2] {
+            ContentBlock::ToolUse { input, .. } => assert_eq!(input.get(), r#"{"command":"ls"}"#),
+            other => panic!("expected ToolUse, got {other:?}"),
+        }
+    }
+
+    #[test]
+    fn tool_result_content_stays_raw_until_read() {
+        let line = r#"{"type":"user","message":{"content":[{"type":"tool_result","tool_use_id":"tu_1","content":[{"type":"text","text":"a"},{"type":"image","source":{"type":"base64","data":"AAAA"}},"b"]}]}}"#;
+        let Some(StreamEvent::User(u)) = parse_line(line) else {
+            panic!("expected User");
+        };
+        let blocks = u.message.content.blocks();
+        let ContentBlock::ToolResult { content, .. } = &blocks[0] else {
+            panic!("expected ToolResult, got {:?}", blocks[0]);
+        };
+        assert!(content.unwrap().get().starts_with(r#"[{"type":"text""#));
+        assert_eq!(result_text(*content), ["a", "b"]);
+        assert!(result_text(None).is_empty());
+    }
+
+    #[test]
+    fn the_type_need_not_come_first() {
+        let line = r#"{"subtype":"success","num_turns":2,"type":"result"}"#;
+        assert!(matches!(parse_line(line), Some(StreamEvent::Result(r)) if r.num_turns == Some(2)));
+    }
+
+    /// Parse throughput over a stream-json log, against building the
+    /// `serde_json::Value` tree of each line the way a generic parse would,
+    /// and then with each event folded into a conversation.
+    ///
+    /// Ignored by default; run deliberately:
+    ///
+    /// ```text
+    /// cargo test -p sicompass-claude --release -- --ignored --nocapture parse_throughput
+    /// ```
+    ///
+    /// `SICOMPASS_BENCH_STREAM` points it at a recorded log instead of the
+    /// synthetic one, whose tool results are 64 KiB file dumps.
+    #[test]
+    #[ignore = "manual profiling aid; prints timings instead of asserting"]
+    fn parse_throughput() {
+        let lines: Vec<String> = match std::env::var("SICOMPASS_BENCH_STREAM") {
+            Ok(path) => std::fs::read_to_string(path)
+                .expect("read the recorded stream")
+                .lines()
+                .map(str::to_owned)
+                .collect(),
+            Err(_) => {
+                let dump: String = (0..1_000)
+                    .map(|i| format!("{i:>6}  let value_{i} = compute(&input[{i}..]);\n"))
+                    .collect();
+                let dump = serde_json::to_string(&dump).unwrap();
+                (0..500)
+                    .flat_map(|i| {
+                        [
+                            format!(
+                                r#"{{"type":"stream_event","event":{{"type":"content_block_delta","index":0,"delta":{{"type":"text_delta","text":"step {i} "}}}}}}"#
+                            ),
+                            format!(
+                                r#"{{"type":"assistant","message":{{"role":"assistant","content":[{{"type":"text","text":"Reading file {i}."}},{{"type":"tool_use","id":"tu_{i}","name":"Read","input":{{"file_path":"/w/{i}.rs"}}}}]}},"session_id":"s"}}"#
+                            ),
+                            format!(
+                                r#"{{"type":"user","message":{{"role":"user","content":[{{"type":"tool_result","tool_use_id":"tu_{i}","content":{dump},"is_error":false}}]}},"session_id":"s"}}"#
+                            ),
+                        ]
+                    })
+                    .collect()
+            }
+        };
+        let bytes: usize = lines.iter().map(String::len).sum();
+        let mib = bytes as f64 / (1024.0 * 1024.0);
+        println!("\n  {} lines, {mib:.1} MiB", lines.len());
+
+        let t = std::time::Instant::now();
+        for line in &lines {
+            std::hint::black_box(parse_line(line));
+        }
+        let secs = t.elapsed().as_secs_f64();
+        println!("  parse_line          {:>8.1} MiB/s", mib / secs);
+
+        let t = std::time::Instant::now();
+        for line in &lines {
+            std::hint::black_box(serde_json::from_str::<serde_json::Value>(line).ok());
+        }
+        let secs = t.elapsed().as_secs_f64();
+        println!("  Value tree          {:>8.1} MiB/s", mib / secs);
+
+        // Into a conversation, spilling the long results.
+        let spill = tempfile::tempdir().unwrap();
+        let mut convo = crate::render::Conversation {
+            spill: crate::render::Spill::in_dir(spill.path()),
+            ..Default::default()
+        };
+        let t = std::time::Instant::now();
+        for line in &lines {
+            if let Some(ev) = parse_line(line) {
+                convo.apply(ev);
+            }
+        }
+        let secs = t.elapsed().as_secs_f64();
+        let kept: usize = convo
+            .turns
+            .iter()
+            .map(|turn| match turn {
+                crate::render::Turn::ToolResult { summary, .. } => summary.len(),
+                _ => 0,
+            })
+            .sum();
+        println!(
+            "  parse + apply       {:>8.1} MiB/s   ({} KiB of output kept)\n",
+            mib / secs,
+            kept / 1024
+        );
+    }
 }
@@ -33,6 +33,13 @@
 //! * `tick()` drains buffered JSONL lines and folds them into conversation
 //!   state.
 //!
+//! Every session is also recorded, turn by turn, into [`store`]. A fresh
+//! session view lists the earlier sessions run in its folder above the prompt,
+//! and `/resume` — the CLI's own name for it — lists them again, or with words
+//! after it searches every session for them. Pressing a row shows that
+//! transcript straight from the store; the child that continues it is spawned
+//! with `--resume` only once the next prompt is sent.
+//!
 //! The child process lives in [`session`]; the event schema in [`events`]; the
 //! conversation state and FFON projection in [`render`].
 
@@ -40,6 +47,7 @@ mod events;
 mod render;
 mod session;
 mod skills;
+mod store;
 
 pub use skills::_set_test_no_ambient_skills;
 
@@ -52,7 +60,7 @@ use sicompass_sdk::{
     register_provider_factory,
 };
 
-use render::Conversation;
+use render::{Conversation, Transcript};
 use session::{Session, SessionConfig};
 
 /// Register this crate's translation bundles with the SDK localizer.
@@ -70,6 +78,22 @@ pub fn register_translations() {
 /// Cap on remembered prompts for `<input>`-slot recall.
 const HISTORY_CAP: usize = 1000;
 
+/// The prompt that lists past sessions instead of being sent. The CLI answers
+/// the same word with its own picker, which `--print` mode does not have.
+const RESUME_PROMPT: &str = "/resume";
+
+/// Past sessions offered above the prompt, each a `<button>` whose function
+/// name is the session id.
+struct PastSessions {
+    heading: String,
+    rows: Vec<PastRow>,
+}
+
+struct PastRow {
+    id: String,
+    label: String,
+}
+
 /// Command id: swap from the folder listing to the session, running `claude` in
 /// the folder the user browsed to. The app binds `:` to this.
 ///
@@ -141,6 +165,8 @@ pub struct ClaudeProvider {
     /// deliberately when we *want* a re-spawn (after an unexpected child exit).
     init_attempted: bool,
     convo: Conversation,
+    /// `convo` as rendered so far; reset with it.
+    transcript: Transcript,
     /// Past prompts, oldest first — recall history for the input slot.
     history: Vec<String>,
     /// Value rendered inside the live `<input>` slot on the next `fetch()`.
@@ -155,6 +181,14 @@ pub struct ClaudeProvider {
     skills: Vec<skills::Skill>,
     /// Last `session_id` seen — used for `--resume` on re-spawn.
     last_session_id: Option<String>,
+    /// What of `convo` is in the session store.
+    recorder: store::Recorder,
+    /// Earlier sessions listed above the prompt, until one is opened or a
+    /// prompt is sent.
+    past: Option<PastSessions>,
+    /// `convo` was opened from the store and no child has resumed it yet, so
+    /// the `--resume` that does is not a restart to report.
+    reopened: bool,
     error: Option<String>,
 }
 
@@ -182,10 +216,14 @@ impl ClaudeProvider {
             session: None,
             init_attempted: false,
             convo: Conversation::default(),
+            transcript: Transcript::default(),
             history: Vec::new(),
             pending_input: String::new(),
             skills: Vec::new(),
             last_session_id: None,
+            recorder: store::Recorder::default(),
+            past: None,
+            reopened: false,
             error: None,
         }
     }
@@ -211,13 +249,14 @@ impl ClaudeProvider {
         }
         self.init_attempted = true;
         let resume = self.last_session_id.clone();
-        let restarting = resume.is_some();
+        let restarting = resume.is_some() && !std::mem::take(&mut self.reopened);
         tracing::debug!(program = %self.program, restarting, "claude: ensure_session spawning");
         match Session::spawn(&self.session_config(resume)) {
             Ok(s) => {
                 tracing::debug!("claude: ensure_session spawn OK");
                 self.session = Some(s);
                 self.spawn_error = None;
+                self.recorder.new_process();
                 if restarting {
                     self.error = Some("claude session restarted".to_owned());
                 }
@@ -309,10 +348,15 @@ impl ClaudeProvider {
             return;
         }
 
-        if self.session.is_some() {
+        // A conversation with no child — one whose child died, or one opened
+        // from the store — belongs to its folder just as much as a live one.
+        if !same_folder {
             // Session::Drop kills the child.
             self.session = None;
             self.convo = Conversation::default();
+            self.transcript = Transcript::default();
+            self.recorder = store::Recorder::default();
+            self.reopened = false;
             self.pending_input.clear();
             // Must not survive: `ensure_session` would hand it to `--resume` and
             // reopen the *old* folder's transcript in the new folder.
@@ -337,6 +381,90 @@ impl ClaudeProvider {
         // `!same_folder` reset above is what lets `:` elsewhere try again,
         // instead of leaving the tab permanently session-less.
         self.ensure_session();
+        if self.convo.turns.is_empty() {
+            self.list_past_sessions();
+        }
+    }
+
+    /// Offer the sessions run earlier in this folder above the prompt.
+    fn list_past_sessions(&mut self) {
+        register_translations();
+        let rows: Vec<PastRow> = store::list(&self.session_path)
+            .into_iter()
+            .map(|s| PastRow {
+                label: format!(
+                    "{}  {} — {} prompts, {} tool calls, {} files, ${:.2}",
+                    s.when,
+                    render::escape_markup(&s.preview),
+                    s.prompts,
+                    s.tool_calls,
+                    s.files,
+                    s.cost_usd
+                ),
+                id: s.id,
+            })
+            .collect();
+        self.past = (!rows.is_empty()).then(|| PastSessions {
+            heading: localize::t("claude-past-here"),
+            rows,
+        });
+    }
+
+    /// Offer every stored session with a turn matching `query`. Unlike the
+    /// folder listing this says so when there is nothing: the user asked.
+    fn search_past_sessions(&mut self, query: &str) {
+        register_translations();
+        let mut args = localize::Args::new();
+        args.set("query", query.to_owned());
+        let hits = store::search(query);
+        let heading = if hits.is_empty() {
+            localize::t_args("claude-past-no-match", &args)
+        } else {
+            localize::t_args("claude-past-matching", &args)
+        };
+        let rows = hits
+            .into_iter()
+            .map(|h| PastRow {
+                // A match may be in another project, and opening it moves there.
+                label: format!(
+                    "{}  {} — {}",
+                    h.session.when,
+                    render::escape_markup(&h.session.cwd),
+                    render::escape_markup(&h.snippet)
+                ),
+                id: h.session.id,
+            })
+            .collect();
+        self.past = Some(PastSessions { heading, rows });
+    }
+
+    /// Show stored session `id` in place of the current conversation.
+    ///
+    /// No child is spawned: the transcript comes from the store, and the next
+    /// prompt spawns one with `--resume`. The running child, if any, goes — its
+    /// conversation is in the store already, and reopens the same way. A session
+    /// from another folder moves the provider there, since that is the only
+    /// folder `--resume` can find it from.
+    fn open_past_session(&mut self, id: &str) {
+        let Some(convo) = store::load(id) else {
+            self.error = Some(format!("session {id} is no longer stored"));
+            return;
+        };
+        // Session::Drop kills the child.
+        self.session = None;
+        self.init_attempted = false;
+        self.spawn_error = None;
+        if let Some(cwd) = convo.cwd.as_deref().filter(|c| !c.is_empty()) {
+            self.browse_path = PathBuf::from(cwd);
+            self.cwd = Some(self.browse_path.clone());
+            self.session_path = cwd.to_owned();
+        }
+        self.recorder = store::Recorder::loaded(&convo);
+        self.convo = convo;
+        self.transcript = Transcript::default();
+        self.last_session_id = Some(id.to_owned());
+        self.reopened = true;
+        self.past = None;
     }
 
     /// Swap back to the folder listing. The child keeps running: this is a view
@@ -350,16 +478,30 @@ impl ClaudeProvider {
         self.view = View::Browse;
     }
 
-    /// The session view: the conversation, then the live `<input>` slot, with a
-    /// spawn failure spliced in directly above that slot.
+    /// The session view: the conversation, then the live `<input>` slot, with
+    /// the past-session listing and a spawn failure spliced in directly above
+    /// that slot, the failure last.
     ///
-    /// Splicing here rather than inside [`render::build`] keeps the conversation
-    /// projection untouched. `build` always ends with the input slot, so
+    /// Splicing here rather than inside [`Transcript::render`] keeps the
+    /// conversation projection untouched. It always ends with the input slot, so
     /// inserting at `len - 1` puts the message where the last thing that
     /// happened is the last thing read out before the prompt.
     fn fetch_session(&mut self) -> Vec<FfonElement> {
         self.pump();
-        let mut out = render::build(&self.convo, &self.pending_input);
+        let mut out = self.transcript.render(&self.convo, &self.pending_input);
+        if let Some(past) = &self.past {
+            let mut obj = FfonElement::new_obj(&past.heading);
+            if let Some(o) = obj.as_obj_mut() {
+                for row in &past.rows {
+                    o.push(FfonElement::new_str(format!(
+                        "<button>{}</button>{}",
+                        row.id, row.label
+                    )));
+                }
+            }
+            let at = out.len().saturating_sub(1);
+            out.insert(at, obj);
+        }
         if let Some(msg) = &self.spawn_error {
             let at = out.len().saturating_sub(1);
             out.insert(at, FfonElement::new_str(msg.clone()));
@@ -381,6 +523,9 @@ impl ClaudeProvider {
         for line in drained {
             match events::parse_line(&line) {
                 Some(ev) => {
+                    if let events::StreamEvent::Result(r) = &ev {
+                        self.recorder.result(r.total_cost_usd);
+                    }
                     self.convo.apply(ev);
                     changed = true;
                 }
@@ -393,6 +538,9 @@ impl ClaudeProvider {
         if let Some(sid) = &self.convo.session_id {
             self.last_session_id = Some(sid.clone());
         }
+        if changed {
+            self.recorder.sync(&self.convo);
+        }
         // Unexpected child exit: surface stderr, drop the session, and allow a
         // `--resume` re-spawn on the next `ensure_session()`.
         if !session.is_alive() {
@@ -537,6 +685,16 @@ impl Provider for ClaudeProvider {
             tracing::debug!("claude: commit_edit rejected — empty prompt");
             return false;
         }
+        if let Some(rest) = prompt.strip_prefix(RESUME_PROMPT)
+            && (rest.is_empty() || rest.starts_with(char::is_whitespace))
+        {
+            match rest.trim() {
+                "" => self.list_past_sessions(),
+                query => self.search_past_sessions(query),
+            }
+            self.pending_input.clear();
+            return true;
+        }
         self.ensure_session();
         let Some(session) = self.session.as_mut() else {
             // `ensure_session` already set a descriptive error.
@@ -563,6 +721,7 @@ impl Provider for ClaudeProvider {
         self.convo.push_user(prompt);
         self.record_history(prompt);
         self.pending_input.clear();
+        self.past = None;
         true
     }
 
@@ -570,6 +729,19 @@ impl Provider for ClaudeProvider {
         self.pending_input = value.to_owned();
     }
 
+    /// A past-session row. Matched by membership, like the web browser's
+    /// history rows, so nothing else that happens to carry a button can open
+    /// a session.
+    fn on_button_press(&mut self, function_name: &str) {
+        let listed = self
+            .past
+            .as_ref()
+            .is_some_and(|p| p.rows.iter().any(|r| r.id == function_name));
+        if listed {
+            self.open_past_session(function_name);
+        }
+    }
+
     fn tick(&mut self) -> bool {
         // Pump unconditionally: the reader thread buffers into `Session::lines`
         // whether or not anyone is looking, and leaving that undrained means a
@@ -1336,6 +1508,42 @@ mod tests {
         );
     }
 
+    #[test]
+    #[cfg(unix)]
+    fn resume_is_answered_here_and_never_sent() {
+        let dir = tempfile::tempdir().unwrap();
+        let mut p = browsing_with_a_live_child(&dir.path().canonicalize().unwrap());
+
+        assert!(p.commit_edit("", "/resume  flaky lexer "));
+        assert!(p.convo.turns.is_empty(), "nothing went to claude");
+        assert!(p.history.is_empty());
+        let out = p.fetch();
+        let rows = names(&out);
+        let heading = &rows[rows.len() - 2];
+        assert!(
+            heading.starts_with("no earlier session mentions") && heading.contains("flaky lexer"),
+            "got: {heading}"
+        );
+        assert!(
+            slot_key(&out).contains("<input>"),
+            "the input slot stays last"
+        );
+
+        // Only the word itself: a prompt that merely starts with it is sent.
+        assert!(p.commit_edit("", "/resumes"));
+        assert_eq!(p.convo.turns.len(), 1);
+        assert!(p.past.is_none(), "sending a prompt clears the listing");
+    }
+
+    #[test]
+    fn a_button_that_is_not_a_listed_session_opens_nothing() {
+        let mut p = ClaudeProvider::new();
+        p.view = View::Session;
+        p.on_button_press("submit:form_0");
+        assert!(p.last_session_id.is_none());
+        assert!(!p.reopened);
+    }
+
     #[test]
     fn tick_reports_no_change_while_browsing() {
         // Returning `true` here would make the app re-read the *directory* from
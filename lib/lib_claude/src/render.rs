@@ -3,21 +3,31 @@
 //! [`Conversation`] is an append-only log of [`Turn`]s built by folding
 //! [`StreamEvent`]s through [`Conversation::apply`]. [`build`] renders that log
 //! (plus the live input value) into the flat `Vec<FfonElement>` the provider
-//! returns from `fetch()`.
+//! returns from `fetch()`; [`Transcript`] does the same while keeping each
+//! turn's rendering, so a long session costs per fetch what arrived since the
+//! last one rather than everything before it.
 
+use std::borrow::Cow;
 use std::collections::{HashMap, HashSet};
+use std::io::Write;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
 
-use serde_json::Value;
 use sicompass_sdk::FfonElement;
 
-use crate::events::{ContentBlock, PartialDelta, PartialInner, ResultEvent, StreamEvent};
+use crate::events::{
+    ContentBlock, PartialDelta, PartialInner, ResultEvent, StreamEvent, result_text, tool_file,
+};
 
 /// A tool invocation requested by the assistant.
 #[derive(Debug, Clone)]
 pub struct ToolUseRec {
     pub id: String,
     pub name: String,
-    pub input: Value,
+    /// The call's arguments as compact JSON, cut to what its label shows.
+    pub input: String,
+    /// The file it reads or writes, for the tools that name one.
+    pub file: Option<String>,
 }
 
 /// One entry in the conversation log.
@@ -33,10 +43,16 @@ pub enum Turn {
     /// The result of a tool the assistant ran. `tool_use_id` links it back to
     /// the [`ToolUseRec`] in an earlier [`Turn::Assistant`], which is how
     /// [`build`] nests the output under the call that produced it.
+    ///
+    /// `summary` is as much of the output as the transcript shows; the lines
+    /// past it are only counted, and the whole output is in the `spill` file.
     ToolResult {
         tool_use_id: String,
         tool_name: String,
         summary: String,
+        /// Lines of output past the ones in `summary`.
+        more_lines: usize,
+        spill: Option<PathBuf>,
         is_error: bool,
     },
 }
@@ -78,6 +94,8 @@ pub struct Conversation {
     pub busy: bool,
     /// Live token-level preview of the assistant message currently streaming.
     pub partial: PartialAssistant,
+    /// Where tool output too long to keep goes.
+    pub spill: Spill,
 }
 
 impl Conversation {
@@ -98,11 +116,11 @@ impl Conversation {
             StreamEvent::System(s) => {
                 if s.subtype == "init" {
                     if !s.session_id.is_empty() {
-                        self.session_id = Some(s.session_id);
+                        self.session_id = Some(s.session_id.into_owned());
                     }
-                    self.model = s.model;
-                    self.cwd = s.cwd;
-                    self.permission_mode = s.permission_mode;
+                    self.model = s.model.map(Cow::into_owned);
+                    self.cwd = s.cwd.map(Cow::into_owned);
+                    self.permission_mode = s.permission_mode.map(Cow::into_owned);
                     self.tools_count = s.tools.len();
                 }
             }
@@ -113,11 +131,16 @@ impl Conversation {
                     match block {
                         ContentBlock::Text { text } => {
                             if !text.is_empty() {
-                                texts.push(text);
+                                texts.push(text.into_owned());
                             }
                         }
                         ContentBlock::ToolUse { id, name, input } => {
-                            tools.push(ToolUseRec { id, name, input });
+                            tools.push(ToolUseRec {
+                                id: id.into_owned(),
+                                name: name.into_owned(),
+                                input: truncate_chars(input.get(), TOOL_INPUT_CHARS),
+                                file: tool_file(input),
+                            });
                         }
                         ContentBlock::ToolResult { .. } | ContentBlock::Other => {}
                     }
@@ -140,10 +163,19 @@ impl Conversation {
                     } = block
                     {
                         let tool_name = self.tool_name_for(&tool_use_id);
+                        let pieces = result_text(content);
+                        let (summary, more_lines, cut) = summarize(&pieces);
+                        let spill = if cut {
+                            self.spill.write(self.turns.len(), &pieces)
+                        } else {
+                            None
+                        };
                         self.turns.push(Turn::ToolResult {
-                            tool_use_id,
+                            tool_use_id: tool_use_id.into_owned(),
                             tool_name,
-                            summary: stringify_content(&content),
+                            summary,
+                            more_lines,
+                            spill,
                             is_error,
                         });
                     }
@@ -152,9 +184,9 @@ impl Conversation {
             StreamEvent::Partial(p) => match p.event {
                 PartialInner::ContentBlockStart { content_block } => {
                     self.partial.active = true;
-                    if content_block.get("type").and_then(|t| t.as_str()) == Some("tool_use") {
-                        if let Some(name) = content_block.get("name").and_then(|n| n.as_str()) {
-                            self.partial.tools.push(name.to_owned());
+                    if content_block.kind == "tool_use" {
+                        if let Some(name) = content_block.name {
+                            self.partial.tools.push(name.into_owned());
                         }
                     }
                 }
@@ -191,34 +223,132 @@ impl Conversation {
 
 /// Lines past this cap are collapsed to a single "… N more" line.
 const TOOL_RESULT_LINE_CAP: usize = 40;
+/// A line of tool output is kept to this many characters.
+const TOOL_RESULT_LINE_CHARS: usize = 1000;
 /// Compact-JSON tool input is truncated to this many characters.
 const TOOL_INPUT_CHARS: usize = 200;
 
-/// Stringify a tool-result `content` value: a bare string passes through, a
-/// block array joins its text blocks, anything else becomes compact JSON.
-pub fn stringify_content(v: &Value) -> String {
-    match v {
-        Value::String(s) => s.clone(),
-        Value::Array(items) => {
-            let mut parts = Vec::new();
-            for item in items {
-                if let Some(text) = item.get("text").and_then(Value::as_str) {
-                    parts.push(text.to_owned());
-                } else if let Some(s) = item.as_str() {
-                    parts.push(s.to_owned());
+/// Keep what the transcript shows of a tool's output.
+///
+/// `pieces` read joined by newlines, as [`result_text`] gives them. Returns
+/// the first [`TOOL_RESULT_LINE_CAP`] lines, each cut to
+/// [`TOOL_RESULT_LINE_CHARS`], the number of lines after those, and whether
+/// anything was left out — in which case the output is worth spilling. Output
+/// within both caps comes back exactly as it was.
+fn summarize(pieces: &[Cow<'_, str>]) -> (String, usize, bool) {
+    let mut summary = String::new();
+    let mut kept = 0;
+    let mut more = 0;
+    let mut cut = false;
+    let mut last_empty = false;
+    // `str::lines` over the joined text: split at every `\n`, drop a `\r`
+    // before it, and no line after a trailing `\n`.
+    let mut segments = pieces.iter().flat_map(|p| p.split('\n')).peekable();
+    while let Some(segment) = segments.next() {
+        if segment.is_empty() && segments.peek().is_none() {
+            break;
+        }
+        if kept == TOOL_RESULT_LINE_CAP {
+            more += 1;
+            continue;
+        }
+        let line = segment.strip_suffix('\r').unwrap_or(segment);
+        if kept > 0 {
+            summary.push('\n');
+        }
+        if line.len() > TOOL_RESULT_LINE_CHARS && line.chars().count() > TOOL_RESULT_LINE_CHARS {
+            summary.push_str(&truncate_chars(line, TOOL_RESULT_LINE_CHARS));
+            cut = true;
+        } else {
+            summary.push_str(line);
+        }
+        kept += 1;
+        last_empty = line.is_empty();
+    }
+    // Read back with `str::lines`, a final empty line needs its own `\n`.
+    if last_empty {
+        summary.push('\n');
+    }
+    (summary, more, cut || more > 0)
+}
+
+/// Conversations that have spilled, this process.
+static SPILLS: AtomicUsize = AtomicUsize::new(0);
+
+/// Where tool output too long for the transcript is written in full.
+///
+/// A directory per conversation, made under the cache dir on the first spill
+/// and removed with the conversation, holding one file per result named for
+/// its turn. What a session keeps in memory is then bounded by what the
+/// transcript shows, however much its tools print; the `full output:` line
+/// under a capped result names the file.
+#[derive(Debug, Default)]
+pub struct Spill {
+    dir: Option<PathBuf>,
+    /// Whether `dir` was made here, and so is removed on drop.
+    owned: bool,
+    /// The directory could not be made; output is capped without a copy.
+    failed: bool,
+}
+
+impl Spill {
+    /// Spill into `dir`, which the caller cleans up.
+    #[cfg(test)]
+    pub fn in_dir(dir: &Path) -> Self {
+        Spill {
+            dir: Some(dir.to_owned()),
+            ..Spill::default()
+        }
+    }
+
+    /// Write the output of turn `turn` out in full. Returns the file, or
+    /// `None` when there is nowhere to put it.
+    fn write(&mut self, turn: usize, pieces: &[Cow<'_, str>]) -> Option<PathBuf> {
+        if self.dir.is_none() && !self.failed {
+            let dir = spill_root().map(|root| {
+                let n = SPILLS.fetch_add(1, Ordering::Relaxed);
+                root.join(format!("{}-{n}", std::process::id()))
+            });
+            match dir {
+                Some(dir) if std::fs::create_dir_all(&dir).is_ok() => {
+                    self.dir = Some(dir);
+                    self.owned = true;
                 }
+                _ => self.failed = true,
             }
-            if parts.is_empty() {
-                v.to_string()
-            } else {
-                parts.join("\n")
+        }
+        let path = self.dir.as_ref()?.join(format!("{turn}.txt"));
+        let mut file = std::io::BufWriter::new(std::fs::File::create(&path).ok()?);
+        for (i, piece) in pieces.iter().enumerate() {
+            if i > 0 {
+                file.write_all(b"\n").ok()?;
             }
+            file.write_all(piece.as_bytes()).ok()?;
+        }
+        file.flush().ok()?;
+        Some(path)
+    }
+}
+
+impl Drop for Spill {
+    fn drop(&mut self) {
+        if self.owned
+            && let Some(dir) = &self.dir
+        {
+            let _ = std::fs::remove_dir_all(dir);
         }
-        Value::Null => String::new(),
-        other => other.to_string(),
     }
 }
 
+/// Parent of every conversation's spill directory. `None` in tests, which
+/// must not write to the real cache dir; they use [`Spill::in_dir`].
+fn spill_root() -> Option<PathBuf> {
+    if cfg!(test) {
+        return None;
+    }
+    sicompass_sdk::platform::cache_home().map(|c| c.join("sicompass").join("claude").join("spill"))
+}
+
 /// Truncate a string to `max` characters, appending `…` when cut.
 fn truncate_chars(s: &str, max: usize) -> String {
     if s.chars().count() <= max {
@@ -230,18 +360,23 @@ fn truncate_chars(s: &str, max: usize) -> String {
     }
 }
 
-/// Push each line of `text` as its own navigable `Str`, capped at
-/// `TOOL_RESULT_LINE_CAP` with a trailing "… N more" marker.
-fn push_capped_lines(obj: &mut sicompass_sdk::FfonObject, text: &str) {
-    let lines: Vec<&str> = text.lines().collect();
+/// Push each line of `body` as its own navigable `Str`, capped at
+/// `TOOL_RESULT_LINE_CAP` with a trailing "… N more" marker, and the spill
+/// file after it when there is one.
+fn push_capped_lines(obj: &mut sicompass_sdk::FfonObject, body: Body<'_>) {
+    let lines: Vec<&str> = body.text.lines().collect();
     let shown = lines.len().min(TOOL_RESULT_LINE_CAP);
     for line in &lines[..shown] {
         obj.push(FfonElement::new_str(escape_markup(line)));
     }
-    if lines.len() > shown {
+    let more = lines.len() - shown + body.more_lines;
+    if more > 0 {
+        obj.push(FfonElement::new_str(format!("… ({more} more lines)")));
+    }
+    if let Some(path) = body.spill {
         obj.push(FfonElement::new_str(format!(
-            "… ({} more lines)",
-            lines.len() - shown
+            "full output: {}",
+            escape_markup(&path.to_string_lossy())
         )));
     }
 }
@@ -258,7 +393,7 @@ fn push_capped_lines(obj: &mut sicompass_sdk::FfonObject, text: &str) {
 /// tool input, tool output, the prompt echo, the session's own metadata. The
 /// live input slot is deliberately *not* escaped: its `<input>` is real markup
 /// the app parses back out with `extract_input`.
-fn escape_markup(s: &str) -> String {
+pub(crate) fn escape_markup(s: &str) -> String {
     s.replace('<', "\\<").replace('>', "\\>")
 }
 
@@ -294,8 +429,7 @@ fn message_lines(texts: &[String]) -> Vec<String> {
 /// The label for one tool call: its name, its input as compact JSON, and an
 /// `[error]` marker when the result came back a failure. The marker rides the
 /// label so a failure is announced without stepping into the node.
-fn tool_label(tool: &ToolUseRec, result: Option<(&str, bool)>) -> String {
-    let compact = serde_json::to_string(&tool.input).unwrap_or_else(|_| "{}".to_owned());
+fn tool_label(tool: &ToolUseRec, result: Option<(Body<'_>, bool)>) -> String {
     let suffix = if matches!(result, Some((_, true))) {
         "  [error]"
     } else {
@@ -304,22 +438,65 @@ fn tool_label(tool: &ToolUseRec, result: Option<(&str, bool)>) -> String {
     format!(
         "{}: {}{suffix}",
         escape_markup(&tool.name),
-        escape_markup(&truncate_chars(&compact, TOOL_INPUT_CHARS))
+        escape_markup(&tool.input)
     )
 }
 
-/// Build `key` as an element whose children are `summary`'s lines.
+/// Text to hang under a label, a line per child.
+#[derive(Debug, Clone, Copy)]
+struct Body<'a> {
+    text: &'a str,
+    /// Lines left out after `text`.
+    more_lines: usize,
+    /// The file holding all of it.
+    spill: Option<&'a Path>,
+}
+
+impl<'a> Body<'a> {
+    fn text(text: &'a str) -> Self {
+        Body {
+            text,
+            more_lines: 0,
+            spill: None,
+        }
+    }
+}
+
+impl Turn {
+    /// A tool result's output, and whether the tool failed.
+    fn output(&self) -> Option<(Body<'_>, bool)> {
+        match self {
+            Turn::ToolResult {
+                summary,
+                more_lines,
+                spill,
+                is_error,
+                ..
+            } => Some((
+                Body {
+                    text: summary,
+                    more_lines: *more_lines,
+                    spill: spill.as_deref(),
+                },
+                *is_error,
+            )),
+            _ => None,
+        }
+    }
+}
+
+/// Build `key` as an element whose children are `body`'s lines.
 ///
 /// The renderer derives the `+`/`-` list prefix from the element *type*, not
 /// from the child count (`build_obj_label` in the app's `list.rs` always emits
 /// `+`), so a childless `Obj` would announce as expandable with nothing to
 /// expand into. Anything with no body must therefore be a `Str`.
-fn body_element(key: String, summary: Option<&str>) -> FfonElement {
-    match summary {
-        Some(text) if !text.is_empty() => {
+fn body_element(key: String, body: Option<Body<'_>>) -> FfonElement {
+    match body {
+        Some(body) if !body.text.is_empty() => {
             let mut el = FfonElement::new_obj(key);
             if let Some(o) = el.as_obj_mut() {
-                push_capped_lines(o, text);
+                push_capped_lines(o, body);
             }
             el
         }
@@ -331,6 +508,10 @@ fn body_element(key: String, summary: Option<&str>) -> FfonElement {
 /// Render the conversation into the flat FFON element list `fetch()` returns.
 ///
 /// `pending_input` is the value currently typed into the live input slot.
+///
+/// Renders every turn from scratch. The provider goes through [`Transcript`],
+/// which keeps the turns it has rendered; this is the reference it must agree
+/// with.
 pub fn build(convo: &Conversation, pending_input: &str) -> Vec<FfonElement> {
     let mut out: Vec<FfonElement> = Vec::new();
 
@@ -344,22 +525,31 @@ pub fn build(convo: &Conversation, pending_input: &str) -> Vec<FfonElement> {
             used_ids.extend(tools.iter().map(|t| t.id.as_str()));
         }
     }
-    let mut results: HashMap<&str, (&str, bool)> = HashMap::new();
+    let mut results: HashMap<&str, (Body<'_>, bool)> = HashMap::new();
     for turn in &convo.turns {
-        if let Turn::ToolResult {
-            tool_use_id,
-            summary,
-            is_error,
-            ..
-        } = turn
+        if let Turn::ToolResult { tool_use_id, .. } = turn
+            && used_ids.contains(tool_use_id.as_str())
+            && let Some(output) = turn.output()
         {
-            if used_ids.contains(tool_use_id.as_str()) {
-                results.insert(tool_use_id.as_str(), (summary.as_str(), *is_error));
-            }
+            results.insert(tool_use_id.as_str(), output);
         }
     }
 
-    // --- session header --------------------------------------------------
+    push_header(convo, &mut out);
+    for turn in &convo.turns {
+        render_turn(
+            turn,
+            |id| results.get(id).copied(),
+            |id| used_ids.contains(id),
+            &mut out,
+        );
+    }
+    push_tail(convo, pending_input, &mut out);
+    out
+}
+
+/// The session header, if the session has introduced itself yet.
+fn push_header(convo: &Conversation, out: &mut Vec<FfonElement>) {
     if convo.session_id.is_some() || convo.model.is_some() {
         let model = convo.model.as_deref().unwrap_or("claude");
         let mode = convo.permission_mode.as_deref().unwrap_or("default");
@@ -377,82 +567,99 @@ pub fn build(convo: &Conversation, pending_input: &str) -> Vec<FfonElement> {
             detail.push_str(&format!("session id: {}\n", escape_markup(sid)));
         }
         // `body_element` keeps it a `Str` when there is no detail to expand.
-        out.push(body_element(key, Some(detail.trim_end_matches('\n'))));
+        out.push(body_element(
+            key,
+            Some(Body::text(detail.trim_end_matches('\n'))),
+        ));
     }
+}
 
-    // --- turns -----------------------------------------------------------
-    for turn in &convo.turns {
-        match turn {
-            Turn::User { text } => {
-                let first = text.lines().next().unwrap_or("");
-                out.push(FfonElement::new_str(format!(
-                    "you: {}",
-                    escape_markup(first)
-                )));
-                for line in text.lines().skip(1) {
-                    out.push(FfonElement::new_str(escape_markup(line)));
-                }
+/// Render one turn onto `out`.
+///
+/// `result` finds the answer to a tool call by its id, and `has_call` says
+/// whether a call with that id is in the log — which is what decides that a
+/// result is already shown inside its call, and so renders nothing here.
+fn render_turn<'a>(
+    turn: &Turn,
+    result: impl Fn(&str) -> Option<(Body<'a>, bool)>,
+    has_call: impl Fn(&str) -> bool,
+    out: &mut Vec<FfonElement>,
+) {
+    match turn {
+        Turn::User { text } => {
+            let first = text.lines().next().unwrap_or("");
+            out.push(FfonElement::new_str(format!(
+                "you: {}",
+                escape_markup(first)
+            )));
+            for line in text.lines().skip(1) {
+                out.push(FfonElement::new_str(escape_markup(line)));
+            }
+        }
+        Turn::Assistant { texts, tools } => {
+            // The whole message rides the `claude:` label — the app's
+            // text renderer breaks a label on explicit `\n`, so the lines
+            // show as lines without costing a level to step into.
+            let lines = message_lines(texts);
+
+            // A turn that said nothing and ran a single tool folds the call
+            // straight into the `claude:` label — an empty container above
+            // one tool would cost a level and announce nothing.
+            if lines.is_empty() && tools.len() == 1 {
+                let tool = &tools[0];
+                let result = result(tool.id.as_str());
+                out.push(body_element(
+                    format!("claude: {}", tool_label(tool, result)),
+                    result.map(|(body, _)| body),
+                ));
+                return;
             }
-            Turn::Assistant { texts, tools } => {
-                // The whole message rides the `claude:` label — the app's
-                // text renderer breaks a label on explicit `\n`, so the lines
-                // show as lines without costing a level to step into.
-                let lines = message_lines(texts);
-
-                // A turn that said nothing and ran a single tool folds the call
-                // straight into the `claude:` label — an empty container above
-                // one tool would cost a level and announce nothing.
-                if lines.is_empty() && tools.len() == 1 {
-                    let tool = &tools[0];
-                    let result = results.get(tool.id.as_str()).copied();
-                    out.push(body_element(
-                        format!("claude: {}", tool_label(tool, result)),
-                        result.map(|(summary, _)| summary),
-                    ));
-                    continue;
-                }
 
-                let key = if lines.is_empty() {
-                    "claude:".to_owned()
-                } else {
-                    format!("claude: {}", lines.join("\n"))
-                };
-                if tools.is_empty() {
-                    // Nothing to expand into, so the row must read `-`.
-                    out.push(FfonElement::new_str(key));
-                    continue;
-                }
-                let mut obj = FfonElement::new_obj(key);
-                if let Some(o) = obj.as_obj_mut() {
-                    for tool in tools {
-                        let result = results.get(tool.id.as_str()).copied();
-                        o.push(body_element(
-                            tool_label(tool, result),
-                            result.map(|(summary, _)| summary),
-                        ));
-                    }
-                }
-                out.push(obj);
+            let key = if lines.is_empty() {
+                "claude:".to_owned()
+            } else {
+                format!("claude: {}", lines.join("\n"))
+            };
+            if tools.is_empty() {
+                // Nothing to expand into, so the row must read `-`.
+                out.push(FfonElement::new_str(key));
+                return;
             }
-            Turn::ToolResult {
-                tool_use_id,
-                tool_name,
-                summary,
-                is_error,
-            } => {
-                // Already rendered inside the tool node that asked for it.
-                if used_ids.contains(tool_use_id.as_str()) {
-                    continue;
+            let mut obj = FfonElement::new_obj(key);
+            if let Some(o) = obj.as_obj_mut() {
+                for tool in tools {
+                    let result = result(tool.id.as_str());
+                    o.push(body_element(
+                        tool_label(tool, result),
+                        result.map(|(body, _)| body),
+                    ));
                 }
-                let suffix = if *is_error { "  [error]" } else { "" };
-                out.push(body_element(
-                    format!("tool result: {tool_name}{suffix}"),
-                    Some(summary.as_str()),
-                ));
             }
+            out.push(obj);
+        }
+        Turn::ToolResult {
+            tool_use_id,
+            tool_name,
+            is_error,
+            ..
+        } => {
+            // Already rendered inside the tool node that asked for it.
+            if has_call(tool_use_id.as_str()) {
+                return;
+            }
+            let suffix = if *is_error { "  [error]" } else { "" };
+            out.push(body_element(
+                format!("tool result: {tool_name}{suffix}"),
+                turn.output().map(|(body, _)| body),
+            ));
         }
     }
+}
 
+/// Everything after the turns: the live preview, the result footer, the
+/// working line and the input slot. Rebuilt on every render — it is the part
+/// that changes while a turn streams in, and none of it grows with the log.
+fn push_tail(convo: &Conversation, pending_input: &str, out: &mut Vec<FfonElement>) {
     // --- live streaming preview -----------------------------------------
     // The in-progress assistant message, reconstructed from token deltas.
     // Cleared the moment the consolidated `assistant` turn lands above.
@@ -508,8 +715,105 @@ pub fn build(convo: &Conversation, pending_input: &str) -> Vec<FfonElement> {
     out.push(FfonElement::new_str(format!(
         "send to claude: <input>{pending_input}</input>"
     )));
+}
 
-    out
+/// [`build`], keeping what it rendered.
+///
+/// A session's log only ever grows, and a turn's rendering only changes when a
+/// result for one of its tool calls arrives. So each turn is rendered once, when
+/// it lands, and again only when an answer to one of its calls does; the header
+/// and everything after the turns are rebuilt each time, being small. The
+/// correlation `build` recomputes over the whole log — which call a result
+/// answers, which results are shown nested — is kept up to date one turn at a
+/// time instead.
+///
+/// The rendering work per call is therefore proportional to what arrived since
+/// the last one. The returned `Vec` is still a copy of every element, since
+/// `fetch()` hands back an owned list.
+///
+/// Reset with the conversation: a log that got shorter is taken to be a new
+/// one and rendered afresh.
+#[derive(Debug, Default)]
+pub struct Transcript {
+    /// Each turn's elements, by turn index. Empty for a result shown inside
+    /// its call.
+    turns: Vec<Vec<FfonElement>>,
+    /// tool_use_id → the assistant turns that made that call.
+    calls: HashMap<String, Vec<usize>>,
+    /// tool_use_id → the latest result turn for it.
+    results: HashMap<String, usize>,
+    /// Turns rendered, rather than reused, by the last call.
+    #[cfg(test)]
+    rendered: usize,
+}
+
+impl Transcript {
+    /// Render `convo`, re-rendering only the turns that are new or changed.
+    pub fn render(&mut self, convo: &Conversation, pending_input: &str) -> Vec<FfonElement> {
+        if convo.turns.len() < self.turns.len() {
+            *self = Transcript::default();
+        }
+        let mut dirty: Vec<usize> = Vec::new();
+        for (i, turn) in convo.turns.iter().enumerate().skip(self.turns.len()) {
+            self.turns.push(Vec::new());
+            dirty.push(i);
+            match turn {
+                Turn::Assistant { tools, .. } => {
+                    for tool in tools {
+                        self.calls.entry(tool.id.clone()).or_default().push(i);
+                        // A result that came in ahead of its call was shown on
+                        // its own; it moves inside the call now.
+                        if let Some(&r) = self.results.get(&tool.id) {
+                            dirty.push(r);
+                        }
+                    }
+                }
+                Turn::ToolResult { tool_use_id, .. } => {
+                    self.results.insert(tool_use_id.clone(), i);
+                    if let Some(callers) = self.calls.get(tool_use_id) {
+                        dirty.extend(callers);
+                    }
+                }
+                Turn::User { .. } => {}
+            }
+        }
+        dirty.sort_unstable();
+        dirty.dedup();
+        #[cfg(test)]
+        {
+            self.rendered = dirty.len();
+        }
+
+        for i in dirty {
+            let mut elements = Vec::new();
+            render_turn(
+                &convo.turns[i],
+                |id| {
+                    if !self.calls.contains_key(id) {
+                        return None;
+                    }
+                    convo.turns.get(*self.results.get(id)?)?.output()
+                },
+                |id| self.calls.contains_key(id),
+                &mut elements,
+            );
+            self.turns[i] = elements;
+        }
+
+        let mut out = Vec::with_capacity(self.turns.iter().map(Vec::len).sum::<usize>() + 4);
+        push_header(convo, &mut out);
+        for elements in &self.turns {
+            out.extend(elements.iter().cloned());
+        }
+        push_tail(convo, pending_input, &mut out);
+        out
+    }
+
+    /// Turns rendered, rather than reused, by the last call.
+    #[cfg(test)]
+    fn rendered(&self) -> usize {
+        self.rendered
+    }
 }
 
 #[cfg(test)]
@@ -565,6 +869,7 @@ mod tests {
                 tool_name,
                 summary,
                 is_error,
+                ..
             } => {
                 assert_eq!(tool_use_id, "tu_7");
                 assert_eq!(tool_name, "Grep");
@@ -892,6 +1197,8 @@ mod tests {
             tool_use_id: "tu_x".to_owned(),
             tool_name: "Bash".to_owned(),
             summary: big,
+            more_lines: 0,
+            spill: None,
             is_error: false,
         });
         let out = build(&c, "");
@@ -934,6 +1241,8 @@ mod tests {
             tool_use_id: "tu_gone".to_owned(),
             tool_name: "Bash".to_owned(),
             summary: big,
+            more_lines: 0,
+            spill: None,
             is_error: false,
         });
         let out = build(&c, "");
@@ -950,14 +1259,105 @@ mod tests {
         );
     }
 
+    fn result_summary(content: &str) -> String {
+        let line = format!(
+            r#"{{"type":"user","message":{{"content":[{{"type":"tool_result","tool_use_id":"t","content":{content}}}]}}}}"#
+        );
+        match &convo_from(&[&line]).turns[..] {
+            [Turn::ToolResult { summary, .. }] => summary.clone(),
+            other => panic!("expected one ToolResult, got {other:?}"),
+        }
+    }
+
+    #[test]
+    fn tool_result_content_reads_string_array_and_value() {
+        assert_eq!(result_summary(r#""hi""#), "hi");
+        assert_eq!(
+            result_summary(
+                r#"[{"type":"text","text":"a"},{"type":"image","source":{"data":"…"}},"b"]"#
+            ),
+            "a\nb"
+        );
+        assert_eq!(result_summary("null"), "");
+        assert_eq!(result_summary(r#"{"ok":true}"#), r#"{"ok":true}"#);
+        assert_eq!(
+            result_summary(r#"[{"type":"image"}]"#),
+            r#"[{"type":"image"}]"#
+        );
+    }
+
     #[test]
-    fn stringify_content_handles_string_array_and_value() {
-        assert_eq!(stringify_content(&Value::String("hi".into())), "hi");
-        let arr: Value =
-            serde_json::from_str(r#"[{"type":"text","text":"a"},{"type":"text","text":"b"}]"#)
-                .unwrap();
-        assert_eq!(stringify_content(&arr), "a\nb");
-        assert_eq!(stringify_content(&Value::Null), "");
+    fn summarize_reads_lines_as_str_lines_does() {
+        for text in ["", "a", "a\n", "\n", "a\n\nb\n\n", "a\r\nb", "\n\n"] {
+            let (summary, more, cut) = summarize(&[Cow::Borrowed(text)]);
+            assert_eq!(
+                summary.lines().collect::<Vec<_>>(),
+                text.lines().collect::<Vec<_>>(),
+                "{text:?}"
+            );
+            assert_eq!((more, cut), (0, false));
+        }
+        // Pieces read joined by newlines.
+        let (summary, _, _) = summarize(&[Cow::Borrowed("a\n"), Cow::Borrowed("b")]);
+        assert_eq!(summary.lines().collect::<Vec<_>>(), ["a", "", "b"]);
+    }
+
+    #[test]
+    fn long_tool_output_is_capped_in_memory_and_spilled_in_full() {
+        let dir = tempfile::tempdir().unwrap();
+        let mut c = Conversation {
+            spill: Spill::in_dir(dir.path()),
+            ..Conversation::default()
+        };
+        for ev in parse_lines([
+            r#"{"type":"assistant","message":{"content":[{"type":"tool_use","id":"tu_1","name":"Read","input":{}},{"type":"tool_use","id":"tu_2","name":"Read","input":{}}]}}"#,
+        ]) {
+            c.apply(ev);
+        }
+        let long: String = (0..5_000).map(|i| format!("row {i}\n")).collect();
+        let wide = "x".repeat(50_000);
+        for (id, text) in [("tu_1", &long), ("tu_2", &wide)] {
+            let line = format!(
+                r#"{{"type":"user","message":{{"content":[{{"type":"tool_result","tool_use_id":"{id}","content":{}}}]}}}}"#,
+                serde_json::to_string(text).unwrap()
+            );
+            for ev in parse_lines([line.as_str()]) {
+                c.apply(ev);
+            }
+        }
+
+        let Turn::ToolResult {
+            summary,
+            more_lines,
+            spill: Some(path),
+            ..
+        } = &c.turns[1]
+        else {
+            panic!("expected a spilled result, got {:?}", c.turns[1]);
+        };
+        assert_eq!(summary.lines().count(), TOOL_RESULT_LINE_CAP);
+        assert_eq!(*more_lines, 5_000 - TOOL_RESULT_LINE_CAP);
+        assert_eq!(std::fs::read_to_string(path).unwrap(), long);
+
+        let Turn::ToolResult {
+            summary,
+            spill: Some(path),
+            ..
+        } = &c.turns[2]
+        else {
+            panic!("expected a spilled result, got {:?}", c.turns[2]);
+        };
+        assert_eq!(summary.chars().count(), TOOL_RESULT_LINE_CHARS + 1);
+        assert_eq!(std::fs::read_to_string(path).unwrap(), wide);
+
+        let out = build(&c, "");
+        let tool = out[0].as_obj().unwrap().children[0].as_obj().unwrap();
+        let tail: Vec<_> = tool.children[TOOL_RESULT_LINE_CAP..]
+            .iter()
+            .map(|e| e.as_str().unwrap().to_owned())
+            .collect();
+        assert_eq!(tail[0], "… (4960 more lines)");
+        assert!(tail[1].starts_with("full output: "), "{tail:?}");
     }
 
     // ContentField is exercised indirectly above; keep an explicit smoke test.
@@ -1055,4 +1455,136 @@ mod tests {
         assert!(!c.partial.active);
         assert!(c.partial.text.is_empty());
     }
+
+    // --- incremental rendering --------------------------------------------
+
+    /// A long agent run as the CLI streams it: per step, a few token deltas,
+    /// the consolidated assistant turn calling one tool, then that tool's
+    /// result. Five events a step.
+    fn agent_run(steps: usize) -> Vec<String> {
+        let mut lines = Vec::new();
+        for i in 0..steps {
+            for word in ["reading ", "the ", "file"] {
+                lines.push(format!(
+                    r#"{{"type":"stream_event","event":{{"type":"content_block_delta","index":0,"delta":{{"type":"text_delta","text":"{word}"}}}}}}"#
+                ));
+            }
+            lines.push(format!(
+                r#"{{"type":"assistant","message":{{"role":"assistant","content":[{{"type":"text","text":"step {i}"}},{{"type":"tool_use","id":"tu_{i}","name":"Read","input":{{"file_path":"/w/{i}.rs"}}}}]}}}}"#
+            ));
+            lines.push(format!(
+                r#"{{"type":"user","message":{{"role":"user","content":[{{"type":"tool_result","tool_use_id":"tu_{i}","content":"line one\nline two","is_error":false}}]}}}}"#
+            ));
+        }
+        lines
+    }
+
+    #[test]
+    fn transcript_matches_build_after_every_event() {
+        let mut lines: Vec<String> = vec![
+            r#"{"type":"system","subtype":"init","session_id":"s1","model":"opus","tools":["Bash"]}"#.to_owned(),
+            // A result ahead of its call, and one whose call never comes.
+            r#"{"type":"user","message":{"role":"user","content":[{"type":"tool_result","tool_use_id":"tu_late","content":"early","is_error":false}]}}"#.to_owned(),
+            r#"{"type":"user","message":{"role":"user","content":[{"type":"tool_result","tool_use_id":"tu_gone","content":"orphan","is_error":true}]}}"#.to_owned(),
+            r#"{"type":"assistant","message":{"role":"assistant","content":[{"type":"tool_use","id":"tu_a","name":"Bash","input":{}},{"type":"tool_use","id":"tu_late","name":"Grep","input":{}}]}}"#.to_owned(),
+            r#"{"type":"user","message":{"role":"user","content":[{"type":"tool_result","tool_use_id":"tu_a","content":"first","is_error":false}]}}"#.to_owned(),
+            // A second answer to the same call replaces the first.
+            r#"{"type":"user","message":{"role":"user","content":[{"type":"tool_result","tool_use_id":"tu_a","content":"second","is_error":true}]}}"#.to_owned(),
+        ];
+        lines.extend(agent_run(3));
+        lines.push(
+            r#"{"type":"result","subtype":"success","num_turns":4,"duration_ms":900,"total_cost_usd":0.01}"#.to_owned(),
+        );
+
+        let mut convo = Conversation::default();
+        let mut transcript = Transcript::default();
+        for line in &lines {
+            for ev in parse_lines([line.as_str()]) {
+                convo.apply(ev);
+            }
+            assert_eq!(
+                format!("{:?}", transcript.render(&convo, "draft")),
+                format!("{:?}", build(&convo, "draft")),
+                "after {line}"
+            );
+        }
+
+        // A new session starts over.
+        let fresh = convo_from(&[
+            r#"{"type":"assistant","message":{"role":"assistant","content":[{"type":"text","text":"hi"}]}}"#,
+        ]);
+        assert_eq!(
+            format!("{:?}", transcript.render(&fresh, "")),
+            format!("{:?}", build(&fresh, ""))
+        );
+    }
+
+    #[test]
+    fn transcript_renders_only_what_each_event_touches() {
+        let mut convo = Conversation::default();
+        let mut transcript = Transcript::default();
+        for line in agent_run(2_000) {
+            for ev in parse_lines([line.as_str()]) {
+                convo.apply(ev);
+            }
+            transcript.render(&convo, "");
+            // A new turn, plus the call its result nests under.
+            assert!(
+                transcript.rendered() <= 2,
+                "{} turns rendered after {line}",
+                transcript.rendered()
+            );
+        }
+        assert_eq!(convo.turns.len(), 4_000);
+    }
+
+    /// Incremental against from-scratch rendering over a whole agent run, one
+    /// `fetch()` per streamed line.
+    ///
+    /// Ignored by default; run deliberately:
+    ///
+    /// ```text
+    /// cargo test -p sicompass-claude --release -- --ignored --nocapture incremental_transcript_cost
+    /// ```
+    ///
+    /// `SICOMPASS_BENCH_STREAM` points it at a recorded stream-json log, e.g.
+    /// `claude --print --output-format stream-json --verbose … > run.jsonl`,
+    /// instead of the synthetic 10k-event one.
+    #[test]
+    #[ignore = "manual profiling aid; prints timings instead of asserting"]
+    fn incremental_transcript_cost() {
+        let lines: Vec<String> = match std::env::var("SICOMPASS_BENCH_STREAM") {
+            Ok(path) => std::fs::read_to_string(path)
+                .expect("read the recorded stream")
+                .lines()
+                .map(str::to_owned)
+                .collect(),
+            Err(_) => agent_run(10_000 / 5),
+        };
+        let events: Vec<StreamEvent> = parse_lines(lines.iter().map(String::as_str));
+        println!("\n  {} events", events.len());
+
+        let mut convo = Conversation::default();
+        let mut transcript = Transcript::default();
+        let mut rendered = 0;
+        let t = std::time::Instant::now();
+        for ev in events.iter().cloned() {
+            convo.apply(ev);
+            std::hint::black_box(transcript.render(&convo, ""));
+            rendered += transcript.rendered();
+        }
+        println!(
+            "  incremental   {:>10.2?}   ({rendered} turn renders for {} turns)",
+            t.elapsed(),
+            convo.turns.len()
+        );
+
+        let mut convo = Conversation::default();
+        let t = std::time::Instant::now();
+        for ev in events.iter().cloned() {
+            convo.apply(ev);
+            std::hint::black_box(build(&convo, ""));
+        }
+        println!("  from scratch  {:>10.2?}\n", t.elapsed());
+    }
 }
@@ -0,0 +1,682 @@
+//! Past sessions, kept on disk so they can be listed, read and searched
+//! without a `claude` process.
+//!
+//! The CLI keeps its own session logs, but only `--resume` reads them, and
+//! resuming means spawning a child and having it replay the whole session
+//! before the first byte of it can be shown. This is the provider's own index
+//! instead: every turn of every session, written as it is folded into the
+//! [`Conversation`], with each tool call, the file it touched and what the
+//! session has cost so far. Opening a past session reads its rows back into a
+//! `Conversation` and renders that; the child is only spawned, with
+//! `--resume`, when the user sends the next prompt.
+//!
+//! What is not kept is the full output of a tool that went past the
+//! transcript's cap. That lives in the spill file of the provider that ran it
+//! and goes away with it; a past session shows the capped output and the
+//! count of lines cut.
+//!
+//! Turn text is indexed for full-text search (SQLite FTS5, as an
+//! external-content table over the turns, so the text is stored once).
+//!
+//! Process-global, like the web browser's archive: every claude tab records
+//! into the same file.
+//!
+//! DB location: platform state dir + `/sicompass/claude/sessions.db`.
+
+use rusqlite::{Connection, OptionalExtension, params};
+use std::path::{Path, PathBuf};
+use std::sync::{Mutex, OnceLock};
+
+use crate::render::{Conversation, ToolUseRec, Turn};
+
+/// Sessions listed above the prompt.
+pub(crate) const LIST_LIMIT: usize = 20;
+
+/// Matches shown for a search.
+pub(crate) const SEARCH_LIMIT: usize = 30;
+
+/// Characters of a session's first prompt kept as its preview.
+const PREVIEW_CHARS: usize = 80;
+
+/// Separates the texts of one assistant turn in its stored row. FTS5 reads it
+/// as whitespace, so the row still searches as prose.
+const TEXT_SEP: char = '\u{1e}';
+
+const KIND_USER: i64 = 0;
+const KIND_ASSISTANT: i64 = 1;
+const KIND_TOOL_RESULT: i64 = 2;
+
+/// A stored session, as listed.
+#[derive(Debug, Clone)]
+pub(crate) struct SessionSummary {
+    pub id: String,
+    pub cwd: String,
+    /// Last activity, as local `YYYY-MM-DD HH:MM`.
+    pub when: String,
+    pub preview: String,
+    pub prompts: usize,
+    pub tool_calls: usize,
+    pub files: usize,
+    pub cost_usd: f64,
+}
+
+/// A search match: the session, and the words around the match in one turn.
+#[derive(Debug, Clone)]
+pub(crate) struct Hit {
+    pub session: SessionSummary,
+    pub snippet: String,
+}
+
+fn now_secs() -> u64 {
+    std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0)
+}
+
+/// The first line of `text`, cut to [`PREVIEW_CHARS`].
+fn preview_of(text: &str) -> String {
+    let line = text.lines().next().unwrap_or("").trim();
+    match line.char_indices().nth(PREVIEW_CHARS) {
+        Some((at, _)) => format!("{}…", &line[..at]),
+        None => line.to_owned(),
+    }
+}
+
+/// `query` as an FTS5 expression: every word must appear, the last one as a
+/// prefix so a half-typed word still matches. Each word is quoted, so what the
+/// user types is never read as FTS5 syntax.
+fn fts_query(query: &str) -> Option<String> {
+    let words: Vec<String> = query
+        .split_whitespace()
+        .map(|w| format!("\"{}\"", w.replace('"', "\"\"")))
+        .collect();
+    if words.is_empty() {
+        return None;
+    }
+    Some(format!("{}*", words.join(" ")))
+}
+
+/// Columns of a [`SessionSummary`], for a query over `sessions s`.
+const SUMMARY_COLUMNS: &str = "s.id, s.cwd,
+     strftime('%Y-%m-%d %H:%M', s.updated_at, 'unixepoch', 'localtime'),
+     s.preview, s.prompts, s.cost_usd,
+     (SELECT COUNT(*) FROM calls c WHERE c.session_id = s.id),
+     (SELECT COUNT(DISTINCT file) FROM calls c WHERE c.session_id = s.id)";
+
+fn summary_from(row: &rusqlite::Row) -> rusqlite::Result<SessionSummary> {
+    Ok(SessionSummary {
+        id: row.get(0)?,
+        cwd: row.get(1)?,
+        when: row.get(2)?,
+        preview: row.get(3)?,
+        prompts: row.get::<_, i64>(4)? as usize,
+        cost_usd: row.get(5)?,
+        tool_calls: row.get::<_, i64>(6)? as usize,
+        files: row.get::<_, i64>(7)? as usize,
+    })
+}
+
+pub(crate) struct Store {
+    conn: Connection,
+}
+
+impl Store {
+    /// Open (or create) the store at `path`.
+    ///
+    /// Returns `None` if the directory cannot be created or the DB cannot be
+    /// opened — sessions are then simply not kept.
+    pub fn open(path: &Path) -> Option<Self> {
+        if let Some(parent) = path.parent() {
+            std::fs::create_dir_all(parent).ok()?;
+        }
+        let conn = Connection::open(path).ok()?;
+        let store = Store { conn };
+        store.init_schema().ok()?;
+        Some(store)
+    }
+
+    fn init_schema(&self) -> rusqlite::Result<()> {
+        self.conn.execute_batch(
+            "CREATE TABLE IF NOT EXISTS sessions (
+                id         TEXT    PRIMARY KEY,
+                cwd        TEXT    NOT NULL,
+                model      TEXT,
+                started_at INTEGER NOT NULL,
+                updated_at INTEGER NOT NULL,
+                prompts    INTEGER NOT NULL DEFAULT 0,
+                cost_usd   REAL    NOT NULL DEFAULT 0,
+                preview    TEXT    NOT NULL DEFAULT ''
+            );
+            CREATE INDEX IF NOT EXISTS sessions_cwd ON sessions(cwd, updated_at);
+            CREATE TABLE IF NOT EXISTS turns (
+                session_id  TEXT    NOT NULL,
+                seq         INTEGER NOT NULL,
+                kind        INTEGER NOT NULL,
+                text        TEXT    NOT NULL,
+                tool_use_id TEXT,
+                tool_name   TEXT,
+                more_lines  INTEGER NOT NULL DEFAULT 0,
+                is_error    INTEGER NOT NULL DEFAULT 0,
+                UNIQUE (session_id, seq)
+            );
+            CREATE TABLE IF NOT EXISTS calls (
+                session_id TEXT    NOT NULL,
+                seq        INTEGER NOT NULL,
+                idx        INTEGER NOT NULL,
+                id         TEXT    NOT NULL,
+                name       TEXT    NOT NULL,
+                input      TEXT    NOT NULL,
+                file       TEXT,
+                PRIMARY KEY (session_id, seq, idx)
+            );
+            CREATE VIRTUAL TABLE IF NOT EXISTS turns_fts USING fts5(text, content='turns');",
+        )
+    }
+
+    /// Write `convo`'s turns from `from` on, and add `cost` to what the
+    /// session has cost. A turn already stored under the same session and
+    /// position is left as it is.
+    pub fn record(&self, convo: &Conversation, from: usize, cost: f64, now: u64) {
+        let Some(id) = convo.session_id.as_deref() else {
+            return;
+        };
+        let Ok(tx) = self.conn.unchecked_transaction() else {
+            return;
+        };
+        let preview = convo
+            .turns
+            .iter()
+            .find_map(|t| match t {
+                Turn::User { text } => Some(preview_of(text)),
+                _ => None,
+            })
+            .unwrap_or_default();
+        let new_prompts = convo.turns[from.min(convo.turns.len())..]
+            .iter()
+            .filter(|t| matches!(t, Turn::User { .. }))
+            .count();
+        let _ = tx.execute(
+            "INSERT INTO sessions (id, cwd, model, started_at, updated_at, prompts, cost_usd, preview)
+             VALUES (?1, ?2, ?3, ?4, ?4, ?5, ?6, ?7)
+             ON CONFLICT(id) DO UPDATE SET
+                 model      = COALESCE(excluded.model, model),
+                 updated_at = excluded.updated_at,
+                 prompts    = prompts + excluded.prompts,
+                 cost_usd   = cost_usd + excluded.cost_usd,
+                 preview    = CASE preview WHEN '' THEN excluded.preview ELSE preview END",
+            params![
+                id,
+                convo.cwd.as_deref().unwrap_or(""),
+                convo.model,
+                now as i64,
+                new_prompts as i64,
+                cost,
+                preview,
+            ],
+        );
+        for (seq, turn) in convo.turns.iter().enumerate().skip(from) {
+            let (kind, text, tool_use_id, tool_name, more_lines, is_error) = match turn {
+                Turn::User { text } => (KIND_USER, text.clone(), None, None, 0, false),
+                Turn::Assistant { texts, .. } => (
+                    KIND_ASSISTANT,
+                    texts.join(&TEXT_SEP.to_string()),
+                    None,
+                    None,
+                    0,
+                    false,
+                ),
+                Turn::ToolResult {
+                    tool_use_id,
+                    tool_name,
+                    summary,
+                    more_lines,
+                    is_error,
+                    ..
+                } => (
+                    KIND_TOOL_RESULT,
+                    summary.clone(),
+                    Some(tool_use_id.as_str()),
+                    Some(tool_name.as_str()),
+                    *more_lines,
+                    *is_error,
+                ),
+            };
+            let inserted = tx
+                .execute(
+                    "INSERT OR IGNORE INTO turns
+                         (session_id, seq, kind, text, tool_use_id, tool_name, more_lines, is_error)
+                     VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8)",
+                    params![
+                        id,
+                        seq as i64,
+                        kind,
+                        text,
+                        tool_use_id,
+                        tool_name,
+                        more_lines as i64,
+                        is_error
+                    ],
+                )
+                .unwrap_or(0);
+            if inserted == 0 {
+                continue;
+            }
+            let _ = tx.execute(
+                "INSERT INTO turns_fts (rowid, text) VALUES (?1, ?2)",
+                params![tx.last_insert_rowid(), text],
+            );
+            if let Turn::Assistant { tools, .. } = turn {
+                for (idx, tool) in tools.iter().enumerate() {
+                    let _ = tx.execute(
+                        "INSERT OR IGNORE INTO calls (session_id, seq, idx, id, name, input, file)
+                         VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)",
+                        params![
+                            id, seq as i64, idx as i64, tool.id, tool.name, tool.input, tool.file
+                        ],
+                    );
+                }
+            }
+        }
+        let _ = tx.commit();
+    }
+
+    /// The sessions run in `cwd`, most recent first.
+    pub fn list(&self, cwd: &str, limit: usize) -> Vec<SessionSummary> {
+        let Ok(mut stmt) = self.conn.prepare(&format!(
+            "SELECT {SUMMARY_COLUMNS} FROM sessions s
+             WHERE s.cwd = ?1 ORDER BY s.updated_at DESC LIMIT ?2"
+        )) else {
+            return Vec::new();
+        };
+        stmt.query_map(params![cwd, limit as i64], summary_from)
+            .map(|rows| rows.filter_map(Result::ok).collect())
+            .unwrap_or_default()
+    }
+
+    /// Turns of every session matching `query`, best match first.
+    pub fn search(&self, query: &str, limit: usize) -> Vec<Hit> {
+        let Some(expr) = fts_query(query) else {
+            return Vec::new();
+        };
+        let Ok(mut stmt) = self.conn.prepare(&format!(
+            "SELECT {SUMMARY_COLUMNS}, snippet(turns_fts, 0, '', '', '…', 10)
+             FROM turns_fts
+             JOIN turns t ON t.rowid = turns_fts.rowid
+             JOIN sessions s ON s.id = t.session_id
+             WHERE turns_fts MATCH ?1
+             ORDER BY rank LIMIT ?2"
+        )) else {
+            return Vec::new();
+        };
+        stmt.query_map(params![expr, limit as i64], |row| {
+            Ok(Hit {
+                session: summary_from(row)?,
+                snippet: row
+                    .get::<_, String>(8)?
+                    .replace([TEXT_SEP, '\n'], " ")
+                    .trim()
+                    .to_owned(),
+            })
+        })
+        .map(|rows| rows.filter_map(Result::ok).collect())
+        .unwrap_or_default()
+    }
+
+    /// Session `id` read back into a conversation, ready to render.
+    pub fn load(&self, id: &str) -> Option<Conversation> {
+        let (cwd, model) = self
+            .conn
+            .query_row(
+                "SELECT cwd, model FROM sessions WHERE id = ?1",
+                params![id],
+                |row| Ok((row.get::<_, String>(0)?, row.get::<_, Option<String>>(1)?)),
+            )
+            .optional()
+            .ok()
+            .flatten()?;
+
+        let mut calls: Vec<(usize, ToolUseRec)> = {
+            let mut stmt = self
+                .conn
+                .prepare(
+                    "SELECT seq, id, name, input, file FROM calls
+                     WHERE session_id = ?1 ORDER BY seq DESC, idx DESC",
+                )
+                .ok()?;
+            let rows = stmt
+                .query_map(params![id], |row| {
+                    Ok((
+                        row.get::<_, i64>(0)? as usize,
+                        ToolUseRec {
+                            id: row.get(1)?,
+                            name: row.get(2)?,
+                            input: row.get(3)?,
+                            file: row.get(4)?,
+                        },
+                    ))
+                })
+                .ok()?;
+            rows.filter_map(Result::ok).collect()
+        };
+
+        let mut stmt = self
+            .conn
+            .prepare(
+                "SELECT seq, kind, text, tool_use_id, tool_name, more_lines, is_error
+                 FROM turns WHERE session_id = ?1 ORDER BY seq",
+            )
+            .ok()?;
+        let rows = stmt
+            .query_map(params![id], |row| {
+                Ok((
+                    row.get::<_, i64>(0)? as usize,
+                    row.get::<_, i64>(1)?,
+                    row.get::<_, String>(2)?,
+                    row.get::<_, Option<String>>(3)?,
+                    row.get::<_, Option<String>>(4)?,
+                    row.get::<_, i64>(5)? as usize,
+                    row.get::<_, bool>(6)?,
+                ))
+            })
+            .ok()?;
+
+        let mut turns = Vec::new();
+        for (seq, kind, text, tool_use_id, tool_name, more_lines, is_error) in
+            rows.filter_map(Result::ok)
+        {
+            turns.push(match kind {
+                KIND_USER => Turn::User { text },
+                KIND_ASSISTANT => {
+                    // `calls` is in reverse, so this turn's are at the end.
+                    let mut tools = Vec::new();
+                    while calls.last().is_some_and(|(s, _)| *s <= seq) {
+                        let (s, call) = calls.pop().expect("checked above");
+                        if s == seq {
+                            tools.push(call);
+                        }
+                    }
+                    Turn::Assistant {
+                        texts: text
+                            .split(TEXT_SEP)
+                            .filter(|t| !t.is_empty())
+                            .map(str::to_owned)
+                            .collect(),
+                        tools,
+                    }
+                }
+                _ => Turn::ToolResult {
+                    tool_use_id: tool_use_id.unwrap_or_default(),
+                    tool_name: tool_name.unwrap_or_default(),
+                    summary: text,
+                    more_lines,
+                    spill: None,
+                    is_error,
+                },
+            });
+        }
+
+        Some(Conversation {
+            session_id: Some(id.to_owned()),
+            model,
+            cwd: Some(cwd),
+            turns,
+            ..Conversation::default()
+        })
+    }
+}
+
+/// Where the store lives, or `None` under test or without a state dir.
+fn store_path() -> Option<PathBuf> {
+    if cfg!(test) {
+        return None;
+    }
+    sicompass_sdk::platform::state_home()
+        .map(|s| s.join("sicompass").join("claude").join("sessions.db"))
+}
+
+#[derive(Default)]
+struct Shared {
+    store: Option<Store>,
+    opened: bool,
+}
+
+fn shared() -> &'static Mutex<Shared> {
+    static SHARED: OnceLock<Mutex<Shared>> = OnceLock::new();
+    SHARED.get_or_init(|| Mutex::new(Shared::default()))
+}
+
+/// Run `f` against the store, opening it on first use.
+fn with_store<R>(f: impl FnOnce(&Store) -> R) -> Option<R> {
+    let mut shared = shared().lock().ok()?;
+    if !shared.opened {
+        shared.opened = true;
+        shared.store = store_path().and_then(|p| Store::open(&p));
+    }
+    shared.store.as_ref().map(f)
+}
+
+/// The sessions run in `cwd`, most recent first.
+pub(crate) fn list(cwd: &str) -> Vec<SessionSummary> {
+    with_store(|s| s.list(cwd, LIST_LIMIT)).unwrap_or_default()
+}
+
+/// Turns of every stored session matching `query`, best match first.
+pub(crate) fn search(query: &str) -> Vec<Hit> {
+    with_store(|s| s.search(query, SEARCH_LIMIT)).unwrap_or_default()
+}
+
+/// A stored session read back into a conversation.
+pub(crate) fn load(id: &str) -> Option<Conversation> {
+    with_store(|s| s.load(id)).flatten()
+}
+
+/// What of one conversation is in the store already, and what it has cost
+/// since it was last written.
+///
+/// The CLI reports cost as a running total for the process, so each `result`
+/// is counted as its increase over the one before it, and a respawned child
+/// starts from nothing again.
+#[derive(Debug, Default)]
+pub(crate) struct Recorder {
+    session_id: Option<String>,
+    recorded: usize,
+    process_total: f64,
+    unsaved_cost: f64,
+}
+
+impl Recorder {
+    /// A recorder for a conversation read out of the store: all of it is
+    /// there already.
+    pub(crate) fn loaded(convo: &Conversation) -> Self {
+        Recorder {
+            session_id: convo.session_id.clone(),
+            recorded: convo.turns.len(),
+            ..Recorder::default()
+        }
+    }
+
+    /// A new child is running; its cost total starts from zero.
+    pub(crate) fn new_process(&mut self) {
+        self.process_total = 0.0;
+    }
+
+    /// Count a `result` event's running cost total.
+    pub(crate) fn result(&mut self, total_cost_usd: Option<f64>) {
+        let Some(total) = total_cost_usd else {
+            return;
+        };
+        self.unsaved_cost += (total - self.process_total).max(0.0);
+        self.process_total = total;
+    }
+
+    /// Write what `convo` has gained since the last call to `store`.
+    ///
+    /// A session the CLI reports under a new id — a `--resume` that forked —
+    /// is written out in full under that id: the CLI's own log of it starts
+    /// with the whole history too.
+    pub(crate) fn sync_to(&mut self, store: &Store, convo: &Conversation) {
+        if convo.session_id.is_none() {
+            return;
+        }
+        if convo.session_id != self.session_id {
+            self.session_id = convo.session_id.clone();
+            self.recorded = 0;
+        }
+        if self.recorded == convo.turns.len() && self.unsaved_cost == 0.0 {
+            return;
+        }
+        store.record(convo, self.recorded, self.unsaved_cost, now_secs());
+        self.recorded = convo.turns.len();
+        self.unsaved_cost = 0.0;
+    }
+
+    /// [`Self::sync_to`] the process-wide store.
+    pub(crate) fn sync(&mut self, convo: &Conversation) {
+        with_store(|s| self.sync_to(s, convo));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::events::parse_line;
+
+    /// A recorded session: a prompt, a read, an edit, and the answer.
+    const EDIT_SESSION: &str = r#"{"type":"system","subtype":"init","session_id":"s-edit","model":"claude-sonnet-4-5","cwd":"/work/parser","permissionMode":"default","tools":["Read","Edit"]}
+{"type":"assistant","message":{"content":[{"type":"text","text":"Let me look at the tokenizer first."},{"type":"tool_use","id":"tu1","name":"Read","input":{"file_path":"/work/parser/src/lex.rs"}}]}}
+{"type":"user","message":{"content":[{"type":"tool_result","tool_use_id":"tu1","content":"fn lex() {}\nfn peek() {}"}]}}
+{"type":"assistant","message":{"content":[{"type":"tool_use","id":"tu2","name":"Edit","input":{"file_path":"/work/parser/src/lex.rs","old_string":"a","new_string":"b"}},{"type":"tool_use","id":"tu3","name":"Grep","input":{"pattern":"peek","path":"/work/parser"}}]}}
+{"type":"user","message":{"content":[{"type":"tool_result","tool_use_id":"tu2","content":"edited"},{"type":"tool_result","tool_use_id":"tu3","content":"no matches","is_error":true}]}}
+{"type":"assistant","message":{"content":[{"type":"text","text":"The lookahead was off by one."},{"type":"text","text":"Fixed in lex.rs."}]}}
+{"type":"result","subtype":"success","num_turns":3,"duration_ms":5000,"total_cost_usd":0.25,"is_error":false}"#;
+
+    /// Another folder, another session, sharing no words with the first.
+    const DOCS_SESSION: &str = r#"{"type":"system","subtype":"init","session_id":"s-docs","cwd":"/work/site","tools":[]}
+{"type":"assistant","message":{"content":[{"type":"text","text":"The README now has an install section."}]}}
+{"type":"result","subtype":"success","total_cost_usd":0.1,"is_error":false}"#;
+
+    /// Fold `log` into a conversation after `prompt`, recording as it goes.
+    fn replay(store: &Store, prompt: &str, log: &str) -> Conversation {
+        let mut convo = Conversation::default();
+        let mut recorder = Recorder::default();
+        convo.push_user(prompt);
+        for line in log.lines() {
+            let ev = parse_line(line).expect("fixture line parses");
+            if let crate::events::StreamEvent::Result(r) = &ev {
+                recorder.result(r.total_cost_usd);
+            }
+            convo.apply(ev);
+            recorder.sync_to(store, &convo);
+        }
+        convo
+    }
+
+    fn temp_store() -> (tempfile::TempDir, Store) {
+        let dir = tempfile::tempdir().unwrap();
+        let store = Store::open(&dir.path().join("sessions.db")).expect("opens");
+        (dir, store)
+    }
+
+    #[test]
+    fn a_session_reads_back_as_it_was_recorded() {
+        let (_dir, store) = temp_store();
+        let live = replay(&store, "fix the lexer's peek", EDIT_SESSION);
+
+        let loaded = store.load("s-edit").expect("stored");
+        assert_eq!(loaded.session_id.as_deref(), Some("s-edit"));
+        assert_eq!(loaded.cwd.as_deref(), Some("/work/parser"));
+        assert_eq!(loaded.model.as_deref(), Some("claude-sonnet-4-5"));
+        assert_eq!(format!("{:?}", loaded.turns), format!("{:?}", live.turns));
+        let Turn::Assistant { tools, .. } = &loaded.turns[3] else {
+            panic!("turn 3 is the edit: {:?}", loaded.turns[3]);
+        };
+        let files: Vec<_> = tools.iter().map(|t| t.file.as_deref()).collect();
+        assert_eq!(files, [Some("/work/parser/src/lex.rs"), None]);
+    }
+
+    #[test]
+    fn sessions_are_listed_per_folder_with_their_counts() {
+        let (_dir, store) = temp_store();
+        replay(&store, "fix the lexer's peek\nand add a test", EDIT_SESSION);
+        replay(&store, "document the install", DOCS_SESSION);
+
+        let listed = store.list("/work/parser", LIST_LIMIT);
+        assert_eq!(listed.len(), 1);
+        let s = &listed[0];
+        assert_eq!(s.id, "s-edit");
+        assert_eq!(s.preview, "fix the lexer's peek");
+        assert_eq!(s.prompts, 1);
+        assert_eq!(s.tool_calls, 3);
+        // Read and Edit name the same file; Grep names none.
+        assert_eq!(s.files, 1);
+        assert!((s.cost_usd - 0.25).abs() < 1e-9);
+        assert!(store.list("/work/nowhere", LIST_LIMIT).is_empty());
+    }
+
+    #[test]
+    fn search_finds_turns_across_sessions() {
+        let (_dir, store) = temp_store();
+        replay(&store, "fix the lexer's peek", EDIT_SESSION);
+        replay(&store, "document the install", DOCS_SESSION);
+
+        let hits = store.search("lookahead", SEARCH_LIMIT);
+        assert_eq!(hits.len(), 1);
+        assert_eq!(hits[0].session.id, "s-edit");
+        assert!(hits[0].snippet.contains("lookahead was off by one"));
+
+        // Every word must match; the last may be half-typed.
+        let ids: Vec<_> = store
+            .search("README inst", SEARCH_LIMIT)
+            .into_iter()
+            .map(|h| h.session.id)
+            .collect();
+        assert_eq!(ids, ["s-docs"]);
+        assert!(store.search("README lookahead", SEARCH_LIMIT).is_empty());
+
+        // Tool output is searched too, and FTS5 syntax is taken literally.
+        assert_eq!(store.search("edited", SEARCH_LIMIT).len(), 1);
+        assert!(store.search("\"", SEARCH_LIMIT).is_empty());
+        assert!(store.search("edited NOT", SEARCH_LIMIT).is_empty());
+        assert!(store.search("   ", SEARCH_LIMIT).is_empty());
+    }
+
+    #[test]
+    fn recording_again_adds_only_what_is_new() {
+        let (_dir, store) = temp_store();
+        let mut convo = replay(&store, "fix the lexer's peek", EDIT_SESSION);
+
+        // A follow-up in a resumed process: its cost total starts over.
+        let mut recorder = Recorder::loaded(&convo);
+        recorder.new_process();
+        convo.push_user("now run the tests");
+        for line in [
+            r#"{"type":"assistant","message":{"content":[{"type":"text","text":"All green."}]}}"#,
+            r#"{"type":"result","subtype":"success","total_cost_usd":0.05,"is_error":false}"#,
+        ] {
+            let ev = parse_line(line).unwrap();
+            if let crate::events::StreamEvent::Result(r) = &ev {
+                recorder.result(r.total_cost_usd);
+            }
+            convo.apply(ev);
+            recorder.sync_to(&store, &convo);
+        }
+
+        let s = &store.list("/work/parser", LIST_LIMIT)[0];
+        assert_eq!(s.prompts, 2);
+        assert!((s.cost_usd - 0.30).abs() < 1e-9);
+        assert_eq!(store.load("s-edit").unwrap().turns.len(), convo.turns.len());
+        assert_eq!(store.search("green", SEARCH_LIMIT).len(), 1);
+        assert_eq!(store.search("lookahead", SEARCH_LIMIT).len(), 1);
+    }
+
+    #[test]
+    fn a_missing_session_does_not_load() {
+        let (_dir, store) = temp_store();
+        assert!(store.load("never-recorded").is_none());
+    }
+}
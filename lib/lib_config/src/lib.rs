@@ -0,0 +1,461 @@
+//! sicompass-config — settings.json, parsed once per process.
+//!
+//! Every reader of the settings file used to read and parse all of it for the
+//! one key it wanted, and every writer did a read-modify-write of its own. Two
+//! writers interleaving that way lose one of the two edits. A [`ConfigStore`]
+//! holds the parsed file instead, so reads are a lookup, and all edits to it go
+//! through one lock, so none is lost.
+//!
+//! There is one store per file, shared process-wide: [`settings`] for the
+//! user's settings.json, [`at`] for any other path (tests, overrides).
+//!
+//! ## Writing
+//!
+//! By default an edit is written before the call returns, as it always was. The
+//! app calls [`coalesce_writes`] at startup: edits then land in memory at once
+//! and a writer thread saves them, all edits made within one window in one
+//! atomic replace. [`flush_all`] writes whatever is pending (on exit).
+//!
+//! ## Outside edits
+//!
+//! A store checks the file's size and modification time before serving a read,
+//! and reparses when either changed — an edit made in an editor, or by another
+//! process, is seen on the next read. Edits still waiting to be written win over
+//! an outside edit made in the same window.
+//!
+//! ## A file that does not parse
+//!
+//! Is left alone: reads see no settings, and edits are refused rather than
+//! written over it. A settings file that fails to parse is most often one
+//! caught mid-write, and rebuilding it from the one key being saved would
+//! drop every other section.
+//!
+//! ## Status
+//!
+//! [`status`] carries read-only sections the app measures and the settings
+//! panel shows; they are never written to the file.
+
+pub mod status;
+
+use serde::de::DeserializeOwned;
+use serde_json::{Map, Value};
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, OnceLock};
+use std::time::{Duration, SystemTime};
+
+/// Window in milliseconds for coalesced writes; 0 writes each edit through.
+static WRITE_WINDOW_MS: AtomicU64 = AtomicU64::new(0);
+
+fn stores() -> MutexGuard<'static, HashMap<PathBuf, Arc<ConfigStore>>> {
+    static STORES: OnceLock<Mutex<HashMap<PathBuf, Arc<ConfigStore>>>> = OnceLock::new();
+    STORES
+        .get_or_init(Default::default)
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+}
+
+/// The store for the user's settings.json, or `None` without a config dir.
+pub fn settings() -> Option<Arc<ConfigStore>> {
+    sicompass_sdk::platform::main_config_path().map(|p| at(&p))
+}
+
+/// The store for the settings file at `path`.
+pub fn at(path: &Path) -> Arc<ConfigStore> {
+    Arc::clone(
+        stores()
+            .entry(path.to_owned())
+            .or_insert_with(|| Arc::new(ConfigStore::new(path.to_owned(), None))),
+    )
+}
+
+/// From now on, save edits at most once per `window` instead of on every edit.
+/// `Duration::ZERO` goes back to writing each edit through.
+pub fn coalesce_writes(window: Duration) {
+    WRITE_WINDOW_MS.store(window.as_millis() as u64, Ordering::Relaxed);
+}
+
+/// Write every store's pending edits now.
+pub fn flush_all() {
+    let all: Vec<Arc<ConfigStore>> = stores().values().cloned().collect();
+    for store in all {
+        store.flush();
+    }
+}
+
+/// What the file looked like when it was last read or written.
+type Stamp = Option<(SystemTime, u64)>;
+
+fn stamp(path: &Path) -> Stamp {
+    let meta = std::fs::metadata(path).ok()?;
+    Some((meta.modified().ok()?, meta.len()))
+}
+
+struct State {
+    /// The parsed file; `None` when it is missing or does not parse.
+    root: Option<Map<String, Value>>,
+    /// The file exists but does not parse.
+    unreadable: bool,
+    seen: Stamp,
+    /// Whether the file has been read at all yet.
+    loaded: bool,
+    /// Bumped by every edit.
+    version: u64,
+    /// The version last on disk.
+    written: u64,
+    writer_started: bool,
+}
+
+pub struct ConfigStore {
+    path: PathBuf,
+    /// Fixed window for this store; `None` follows [`coalesce_writes`].
+    window: Option<Duration>,
+    state: Mutex<State>,
+    /// Signalled when there is something to write.
+    dirty: Condvar,
+    /// Held while a snapshot is taken and written, so snapshots reach the disk
+    /// in the order they were taken.
+    io: Mutex<()>,
+}
+
+impl ConfigStore {
+    fn new(path: PathBuf, window: Option<Duration>) -> Self {
+        ConfigStore {
+            path,
+            window,
+            state: Mutex::new(State {
+                root: None,
+                unreadable: false,
+                seen: None,
+                loaded: false,
+                version: 0,
+                written: 0,
+                writer_started: false,
+            }),
+            dirty: Condvar::new(),
+            io: Mutex::new(()),
+        }
+    }
+
+    pub fn path(&self) -> &Path {
+        &self.path
+    }
+
+    fn window(&self) -> Duration {
+        self.window
+            .unwrap_or_else(|| Duration::from_millis(WRITE_WINDOW_MS.load(Ordering::Relaxed)))
+    }
+
+    /// The state, current with the file unless edits are waiting to be written.
+    fn state(&self) -> MutexGuard<'_, State> {
+        let mut st = self.state.lock().unwrap_or_else(|e| e.into_inner());
+        if st.version == st.written {
+            let now = stamp(&self.path);
+            if !st.loaded || now != st.seen {
+                self.reload(&mut st, now);
+            }
+        }
+        st
+    }
+
+    fn reload(&self, st: &mut State, now: Stamp) {
+        st.loaded = true;
+        st.seen = now;
+        st.unreadable = false;
+        st.root = match std::fs::read_to_string(&self.path) {
+            Ok(text) => match serde_json::from_str::<Value>(&text) {
+                Ok(Value::Object(m)) => Some(m),
+                _ => {
+                    st.unreadable = true;
+                    None
+                }
+            },
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => None,
+            Err(_) => {
+                st.unreadable = true;
+                None
+            }
+        };
+    }
+
+    /// Run `f` on the settings, or `None` when there are none (no file, or a
+    /// file that does not parse).
+    pub fn read<T>(&self, f: impl FnOnce(&Map<String, Value>) -> T) -> Option<T> {
+        self.state().root.as_ref().map(f)
+    }
+
+    /// `section.key`.
+    pub fn get(&self, section: &str, key: &str) -> Option<Value> {
+        self.read(|root| root.get(section)?.get(key).cloned())?
+    }
+
+    /// A whole section, as `T`.
+    pub fn section<T: DeserializeOwned>(&self, name: &str) -> Option<T> {
+        let value = self.read(|root| root.get(name).cloned())??;
+        serde_json::from_value(value).ok()
+    }
+
+    /// Set `section.key`, creating the section if need be. Returns `false` if
+    /// the edit was refused (see the module docs).
+    pub fn set(&self, section: &str, key: &str, value: impl Into<Value>) -> bool {
+        let value = value.into();
+        self.update(|root| {
+            let Value::Object(sec) = root
+                .entry(section.to_owned())
+                .or_insert_with(|| Value::Object(Map::new()))
+            else {
+                return false;
+            };
+            if sec.get(key) == Some(&value) {
+                return false;
+            }
+            sec.insert(key.to_owned(), value);
+            true
+        })
+    }
+
+    /// Edit the settings in place. `f` returns whether it changed anything;
+    /// only then is the file written. Returns `false` if the edit was refused
+    /// (see the module docs).
+    pub fn update(&self, f: impl FnOnce(&mut Map<String, Value>) -> bool) -> bool {
+        let window = self.window();
+        // Write-through: keep `io` across the edit so this edit's snapshot is
+        // the next one on disk.
+        let io = window.is_zero().then(|| self.io());
+        let mut st = self.state();
+        if st.unreadable {
+            eprintln!(
+                "sicompass: {} is unreadable or corrupt — setting not saved, \
+                 file left intact for recovery",
+                self.path.display()
+            );
+            return false;
+        }
+        // A missing file is edited as an empty one, but only created if the
+        // edit changed something.
+        let existed = st.root.is_some();
+        let mut root = st.root.take().unwrap_or_default();
+        let changed = f(&mut root);
+        if existed || changed {
+            st.root = Some(root);
+        }
+        if !changed {
+            return true;
+        }
+        st.version += 1;
+        match io {
+            Some(_io) => self.write(st),
+            None => {
+                if !st.writer_started {
+                    st.writer_started = true;
+                    self.spawn_writer();
+                }
+                self.dirty.notify_one();
+            }
+        }
+        true
+    }
+
+    /// Write pending edits now.
+    pub fn flush(&self) {
+        let _io = self.io();
+        let st = self.state.lock().unwrap_or_else(|e| e.into_inner());
+        if st.version != st.written {
+            self.write(st);
+        }
+    }
+
+    fn io(&self) -> MutexGuard<'_, ()> {
+        self.io.lock().unwrap_or_else(|e| e.into_inner())
+    }
+
+    /// Write the state's root out. Takes the snapshot under the state lock
+    /// and does the I/O without it; the caller holds `io`.
+    fn write(&self, st: MutexGuard<'_, State>) {
+        let version = st.version;
+        let json = serde_json::to_string_pretty(st.root.as_ref().unwrap_or(&Map::new()));
+        drop(st);
+        if let Ok(json) = json {
+            if let Some(parent) = self.path.parent() {
+                sicompass_sdk::platform::make_dirs(parent);
+            }
+            let _ = sicompass_sdk::platform::atomic_write(&self.path, &json);
+        }
+        let mut st = self.state.lock().unwrap_or_else(|e| e.into_inner());
+        st.written = st.written.max(version);
+        st.seen = stamp(&self.path);
+    }
+
+    fn spawn_writer(&self) {
+        // Stores live as long as the process (`at` keeps them), so the
+        // writer's handle on this one never dangles.
+        let Some(store) = stores().get(&self.path).cloned() else {
+            return;
+        };
+        let _ = std::thread::Builder::new()
+            .name("sicompass-config-writer".to_owned())
+            .spawn(move || store.writer_loop());
+    }
+
+    fn writer_loop(&self) {
+        loop {
+            let mut st = self.state.lock().unwrap_or_else(|e| e.into_inner());
+            while st.version == st.written {
+                st = self.dirty.wait(st).unwrap_or_else(|e| e.into_inner());
+            }
+            drop(st);
+            // Let the edits that follow this one join it.
+            std::thread::sleep(self.window());
+            self.flush();
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// A registered store with its own write window, so tests here do not
+    /// change the process-wide one under each other.
+    fn store_with_window(path: &Path, window: Duration) -> Arc<ConfigStore> {
+        let store = Arc::new(ConfigStore::new(path.to_owned(), Some(window)));
+        stores().insert(path.to_owned(), Arc::clone(&store));
+        store
+    }
+
+    fn on_disk(path: &Path) -> Value {
+        serde_json::from_str(&std::fs::read_to_string(path).unwrap()).unwrap()
+    }
+
+    #[test]
+    fn reads_see_edits_and_outside_changes() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("settings.json");
+        let store = at(&path);
+        assert_eq!(store.read(|_| ()), None, "no file, no settings");
+
+        assert!(store.set("sicompass", "colorScheme", "light"));
+        assert_eq!(
+            on_disk(&path)["sicompass"]["colorScheme"],
+            "light",
+            "written through by default"
+        );
+        assert_eq!(store.get("sicompass", "colorScheme"), Some("light".into()));
+
+        std::fs::write(&path, r#"{"sicompass": {"colorScheme": "dark!"}}"#).unwrap();
+        assert_eq!(store.get("sicompass", "colorScheme"), Some("dark!".into()));
+    }
+
+    #[test]
+    fn sections_read_as_types() {
+        #[derive(serde::Deserialize, Debug, PartialEq)]
+        #[serde(rename_all = "camelCase")]
+        struct Remote {
+            remote_url: String,
+            #[serde(default)]
+            api_key: String,
+        }
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("settings.json");
+        std::fs::write(&path, r#"{"svc": {"remoteUrl": "https://x", "other": 1}}"#).unwrap();
+        let store = at(&path);
+        assert_eq!(
+            store.section::<Remote>("svc"),
+            Some(Remote {
+                remote_url: "https://x".to_owned(),
+                api_key: String::new()
+            })
+        );
+        assert_eq!(store.section::<Remote>("absent"), None);
+    }
+
+    #[test]
+    fn a_file_that_does_not_parse_is_never_written_over() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("settings.json");
+        let partial = r#"{"text editor": {"textEditorPath": "/home/nico/Dro"#;
+        std::fs::write(&path, partial).unwrap();
+        let store = at(&path);
+
+        assert_eq!(store.read(|_| ()), None);
+        assert!(!store.set("sicompass", "colorScheme", "light"));
+        store.flush();
+        assert_eq!(std::fs::read_to_string(&path).unwrap(), partial);
+
+        // Once repaired, edits go through again.
+        std::fs::write(&path, r#"{"other": {"kept": true}}"#).unwrap();
+        assert!(store.set("sicompass", "colorScheme", "light"));
+        assert_eq!(on_disk(&path)["other"]["kept"], true);
+    }
+
+    #[test]
+    fn coalesced_edits_are_written_once_the_window_closes() {
+        let dir = tempfile::tempdir().unwrap();
+        let path = dir.path().join("settings.json");
+        let store = store_with_window(&path, Duration::from_millis(200));
+
+        for i in 0..50 {
+            store.set("s", &format!("k{i}"), i);
+        }
+        assert!(!path.exists(), "nothing written inside the window");
+        assert_eq!(
+            store.get("s", "k49"),
+            Some(49.into()),
+            "but every edit is read back"
+        );
+
+        std::thread::sleep(Duration::from_millis(600));
+        assert_eq!(on_disk(&path)["s"].as_object().unwrap().len(), 50);
+        store.set("s", "late", true);
+        store.flush();
+        assert_eq!(on_disk(&path)["s"]["late"], true, "flush writes at once");
+    }
+
+    #[test]
+    fn concurrent_writers_lose_no_update() {
+        for window in [Duration::ZERO, Duration::from_millis(5)] {
+            let dir = tempfile::tempdir().unwrap();
+            let path = dir.path().join("settings.json");
+            std::fs::write(&path, r#"{"keep": {"me": true}}"#).unwrap();
+            let store = store_with_window(&path, window);
+
+            const WRITERS: usize = 8;
+            const EDITS: usize = 100;
+            let threads: Vec<_> = (0..WRITERS)
+                .map(|w| {
+                    let store = Arc::clone(&store);
+                    std::thread::spawn(move || {
+                        for i in 0..EDITS {
+                            // Disjoint keys in one shared section, plus a
+                            // counter every writer bumps.
+                            store.set("shared", &format!("w{w}-{i}"), i);
+                            store.update(|root| {
+                                let n = root.get("count").and_then(Value::as_u64).unwrap_or(0);
+                                root.insert("count".to_owned(), (n + 1).into());
+                                true
+                            });
+                        }
+                    })
+                })
+                .collect();
+            for t in threads {
+                t.join().unwrap();
+            }
+            store.flush();
+
+            let disk = on_disk(&path);
+            assert_eq!(disk["keep"]["me"], true, "window {window:?}");
+            assert_eq!(
+                disk["shared"].as_object().unwrap().len(),
+                WRITERS * EDITS,
+                "window {window:?}"
+            );
+            assert_eq!(disk["count"], WRITERS * EDITS, "window {window:?}");
+        }
+    }
+}
@@ -0,0 +1,63 @@
+//! Read-only status sections shown in the settings panel after the settings.
+//!
+//! Some of what the user wants to see next to their settings is not a setting:
+//! figures the app measures while it runs. The app registers a source per
+//! section here and the settings provider asks each one for its rows whenever
+//! it builds its tree, so the rows are as current as the last refresh. This
+//! lives in the crate both of them already share because neither can call the
+//! other.
+
+use sicompass_sdk::FfonElement;
+use std::sync::{Mutex, OnceLock};
+
+/// Builds a section's rows. Empty means the section is left out.
+pub type Source = fn() -> Vec<FfonElement>;
+
+fn sources() -> &'static Mutex<Vec<(String, Source)>> {
+    static SOURCES: OnceLock<Mutex<Vec<(String, Source)>>> = OnceLock::new();
+    SOURCES.get_or_init(|| Mutex::new(Vec::new()))
+}
+
+/// Show `source`'s rows under `section`, replacing any earlier source for it.
+pub fn register(section: &str, source: Source) {
+    let mut sources = sources().lock().unwrap_or_else(|e| e.into_inner());
+    sources.retain(|(s, _)| s != section);
+    sources.push((section.to_owned(), source));
+}
+
+/// Every section with something to show, in registration order.
+pub fn sections() -> Vec<(String, Vec<FfonElement>)> {
+    // Copied out so a source is never run under the lock.
+    let sources = sources().lock().unwrap_or_else(|e| e.into_inner()).clone();
+    sources
+        .into_iter()
+        .map(|(section, source)| (section, source()))
+        .filter(|(_, rows)| !rows.is_empty())
+        .collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn two_rows() -> Vec<FfonElement> {
+        vec![FfonElement::new_str("a"), FfonElement::new_str("b")]
+    }
+
+    fn no_rows() -> Vec<FfonElement> {
+        Vec::new()
+    }
+
+    #[test]
+    fn an_empty_section_is_left_out_and_a_later_source_replaces_an_earlier_one() {
+        register("status-test", two_rows);
+        assert!(
+            sections()
+                .iter()
+                .any(|(s, rows)| s == "status-test" && rows.len() == 2)
+        );
+
+        register("status-test", no_rows);
+        assert!(sections().iter().all(|(s, _)| s != "status-test"));
+    }
+}
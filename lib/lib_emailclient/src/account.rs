@@ -0,0 +1,285 @@
+//! Per-account IMAP state shared by every provider signed in to the account.
+//!
+//! The app keeps a whole provider set per tab, so each tab owns an
+//! `EmailClientProvider`. Its view state — path, folder listing, compose form —
+//! is cheap; the IMAP session, the envelope cache DB it reads through, and the
+//! IDLE session watching a folder are not. Those live here instead, one per
+//! `(imap_url, username)`, and each provider holds an `Arc` to its account.
+//! When the last provider lets go, the account and its sessions close.
+//!
+//! IDLE is kept per folder: two tabs in the same folder share one session,
+//! tabs in different folders each need their own, since IDLE watches only the
+//! selected mailbox.
+//!
+//! The account opens two command connections. Background tasks share one; the
+//! synchronous backend, which runs on the render thread, has the other. A
+//! folder fetch holding the background connection for seconds then never
+//! stalls a frame. Each is an IMAP login of its own and opens its own handle
+//! on the account's envelope cache DB — the same file, kept consistent by
+//! SQLite — so an account holds two logins and two cache handles however many
+//! tabs it has.
+
+use crate::idle::IdleController;
+use crate::net::RealImap;
+use crate::{EmailClientConfig, EmailMessage, FolderInfo, ImapBackend, MessageHeader};
+use std::collections::HashMap;
+use std::sync::atomic::AtomicBool;
+use std::sync::{Arc, Mutex, OnceLock, Weak};
+
+/// An IMAP connection of the account; owns the envelope cache as well.
+pub type Connection = Arc<tokio::sync::Mutex<RealImap>>;
+
+/// `(imap_url, username)`.
+type Key = (String, String);
+
+fn accounts() -> &'static Mutex<HashMap<Key, Weak<Account>>> {
+    static ACCOUNTS: OnceLock<Mutex<HashMap<Key, Weak<Account>>>> = OnceLock::new();
+    ACCOUNTS.get_or_init(|| Mutex::new(HashMap::new()))
+}
+
+#[derive(Default)]
+pub struct Account {
+    /// For spawned tasks. Opened on first use; dropped when credentials change.
+    connection: Mutex<Option<Connection>>,
+    /// For [`SharedImap`], on the render thread. Likewise opened on first use.
+    sync_connection: Mutex<Option<Connection>>,
+    /// One IDLE session per watched folder.
+    watches: Mutex<HashMap<String, IdleController>>,
+}
+
+impl Account {
+    /// The account `config` signs in to, shared with every other provider
+    /// signed in to it.
+    ///
+    /// Without a server or a user there is nothing to share, so an unconfigured
+    /// provider gets an account of its own.
+    pub fn for_config(config: &EmailClientConfig) -> Arc<Account> {
+        if config.imap_url.is_empty() || config.username.is_empty() {
+            return Arc::new(Account::default());
+        }
+        let key = (config.imap_url.clone(), config.username.clone());
+        let mut accounts = accounts().lock().expect("accounts mutex");
+        if let Some(account) = accounts.get(&key).and_then(Weak::upgrade) {
+            return account;
+        }
+        accounts.retain(|_, account| account.strong_count() > 0);
+        let account = Arc::new(Account::default());
+        accounts.insert(key, Arc::downgrade(&account));
+        account
+    }
+
+    /// The background connection, opened with `config` if none is open.
+    pub fn connection(&self, config: &EmailClientConfig) -> Connection {
+        open(&self.connection, config)
+    }
+
+    /// The render thread's connection, opened with `config` if none is open.
+    ///
+    /// Only the synchronous backend uses it, and the render thread runs one
+    /// operation at a time, so locking it never waits.
+    pub fn sync_connection(&self, config: &EmailClientConfig) -> Connection {
+        open(&self.sync_connection, config)
+    }
+
+    /// Drop both connections so the next operation reconnects.
+    ///
+    /// Operations already running keep the old one until they finish.
+    pub fn reconnect(&self) {
+        *self.connection.lock().expect("connection mutex") = None;
+        *self.sync_connection.lock().expect("connection mutex") = None;
+    }
+
+    pub fn is_connected(&self) -> bool {
+        self.connection.lock().expect("connection mutex").is_some()
+    }
+
+    /// Raise `notify` when `folder` changes, starting its IDLE session if no
+    /// other provider is already watching it.
+    pub fn watch(&self, config: &EmailClientConfig, folder: &str, notify: &Arc<AtomicBool>) {
+        let mut watches = self.watches.lock().expect("watches mutex");
+        if let Some(idle) = watches.get(folder) {
+            idle.subscribe(notify);
+            return;
+        }
+        let mut idle = IdleController::new(Arc::clone(notify));
+        idle.start(config.clone(), folder.to_owned());
+        watches.insert(folder.to_owned(), idle);
+    }
+
+    /// Stop raising `notify` for `folder`; the last one out stops the session.
+    pub fn unwatch(&self, folder: &str, notify: &Arc<AtomicBool>) {
+        let mut watches = self.watches.lock().expect("watches mutex");
+        if let Some(idle) = watches.get(folder)
+            && !idle.unsubscribe(notify)
+        {
+            watches.remove(folder);
+        }
+    }
+
+    /// Publish a refreshed OAuth access token to every IDLE session.
+    pub fn update_token(&self, access_token: &str) {
+        for idle in self.watches.lock().expect("watches mutex").values() {
+            idle.update_token(access_token);
+        }
+    }
+
+    #[cfg(test)]
+    pub fn watch_count(&self) -> usize {
+        self.watches.lock().expect("watches mutex").len()
+    }
+
+    /// Connections opened and not dropped: one per login and per cache handle.
+    #[cfg(test)]
+    pub fn open_connections(&self) -> usize {
+        usize::from(self.connection.lock().expect("connection mutex").is_some())
+            + usize::from(
+                self.sync_connection
+                    .lock()
+                    .expect("connection mutex")
+                    .is_some(),
+            )
+    }
+
+    #[cfg(test)]
+    pub fn shares_connections(&self, config: &EmailClientConfig) -> bool {
+        Arc::ptr_eq(&self.connection(config), &self.sync_connection(config))
+    }
+}
+
+fn open(slot: &Mutex<Option<Connection>>, config: &EmailClientConfig) -> Connection {
+    let mut connection = slot.lock().expect("connection mutex");
+    Arc::clone(
+        connection.get_or_insert_with(|| {
+            Arc::new(tokio::sync::Mutex::new(RealImap::from_config(config)))
+        }),
+    )
+}
+
+// ---------------------------------------------------------------------------
+// SharedImap
+// ---------------------------------------------------------------------------
+
+/// The synchronous backend of a provider, run over its account's
+/// [`Account::sync_connection`].
+///
+/// Resolves the connection per call rather than holding one, so a reconnect
+/// made by another tab is picked up here too.
+pub struct SharedImap {
+    account: Arc<Account>,
+    config: EmailClientConfig,
+}
+
+impl SharedImap {
+    pub fn new(account: Arc<Account>, config: &EmailClientConfig) -> Self {
+        SharedImap {
+            account,
+            config: config.clone(),
+        }
+    }
+
+    fn connection(&self) -> Connection {
+        self.account.sync_connection(&self.config)
+    }
+}
+
+#[async_trait::async_trait]
+impl ImapBackend for SharedImap {
+    async fn list_folders(&mut self) -> Result<Vec<FolderInfo>, String> {
+        self.connection().lock().await.list_folders().await
+    }
+
+    async fn list_messages(
+        &mut self,
+        folder: &str,
+        limit: usize,
+    ) -> Result<Vec<MessageHeader>, String> {
+        self.connection()
+            .lock()
+            .await
+            .list_messages(folder, limit)
+            .await
+    }
+
+    async fn fetch_message(
+        &mut self,
+        folder: &str,
+        uid: u32,
+    ) -> Result<Option<EmailMessage>, String> {
+        self.connection()
+            .lock()
+            .await
+            .fetch_message(folder, uid)
+            .await
+    }
+
+    async fn fetch_part(
+        &mut self,
+        folder: &str,
+        uid: u32,
+        section: &str,
+    ) -> Result<Option<Vec<u8>>, String> {
+        self.connection()
+            .lock()
+            .await
+            .fetch_part(folder, uid, section)
+            .await
+    }
+
+    async fn fetch_message_by_message_id(
+        &mut self,
+        folder: &str,
+        message_id: &str,
+    ) -> Result<Option<EmailMessage>, String> {
+        self.connection()
+            .lock()
+            .await
+            .fetch_message_by_message_id(folder, message_id)
+            .await
+    }
+
+    async fn set_flags(
+        &mut self,
+        folder: &str,
+        uid: u32,
+        add: &[&str],
+        remove: &[&str],
+    ) -> Result<(), String> {
+        self.connection()
+            .lock()
+            .await
+            .set_flags(folder, uid, add, remove)
+            .await
+    }
+
+    async fn copy_message(&mut self, folder: &str, uid: u32, dest: &str) -> Result<(), String> {
+        self.connection()
+            .lock()
+            .await
+            .copy_message(folder, uid, dest)
+            .await
+    }
+
+    async fn move_message(&mut self, folder: &str, uid: u32, dest: &str) -> Result<(), String> {
+        self.connection()
+            .lock()
+            .await
+            .move_message(folder, uid, dest)
+            .await
+    }
+
+    async fn expunge_uid(&mut self, folder: &str, uid: u32) -> Result<(), String> {
+        self.connection()
+            .lock()
+            .await
+            .expunge_uid(folder, uid)
+            .await
+    }
+
+    async fn append(&mut self, folder: &str, message: &[u8]) -> Result<(), String> {
+        self.connection().lock().await.append(folder, message).await
+    }
+
+    async fn fetch_threads(&mut self, folder: &str) -> Result<Option<Vec<Vec<u32>>>, String> {
+        self.connection().lock().await.fetch_threads(folder).await
+    }
+}
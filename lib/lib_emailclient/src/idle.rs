@@ -1,8 +1,10 @@
 //! IMAP IDLE background task.
 //!
 //! Runs an IMAP IDLE connection for a single folder on the shared email
-//! runtime. When the server reports EXISTS or EXPUNGE, the shared `notify` flag
-//! is set so the provider refreshes on the next render cycle.
+//! runtime. When the server reports EXISTS or EXPUNGE, every subscribed
+//! `notify` flag is set so each provider watching the folder refreshes on its
+//! next render cycle. One session serves every tab open on the same folder of
+//! the same account; see `account.rs`.
 //!
 //! This replaced an OS thread driven by an `AtomicBool` plus a `SyncSender`
 //! shutdown channel. That design could only notice a stop request when its 30 s
@@ -29,9 +31,12 @@ const IDLE_KEEPALIVE: Duration = Duration::from_secs(29 * 60);
 // IdleController
 // ---------------------------------------------------------------------------
 
+/// Refresh flags of the providers watching one IDLE session.
+type Subscribers = Arc<Mutex<Vec<Arc<AtomicBool>>>>;
+
 pub struct IdleController {
-    /// Shared flag written by the IDLE task when new mail arrives.
-    notify: Arc<AtomicBool>,
+    /// Flags written by the IDLE task when new mail arrives, one per provider.
+    notify: Subscribers,
     /// Cancels the running task; `None` when nothing is running.
     cancel: Option<CancellationToken>,
     /// The OAuth access token the IDLE session should authenticate with.
@@ -46,7 +51,7 @@ pub struct IdleController {
 impl IdleController {
     pub fn new(notify: Arc<AtomicBool>) -> Self {
         IdleController {
-            notify,
+            notify: Arc::new(Mutex::new(vec![notify])),
             cancel: None,
             token: Arc::new(Mutex::new(String::new())),
         }
@@ -80,6 +85,21 @@ impl IdleController {
         *self.token.lock().expect("token mutex") = access_token.to_owned();
     }
 
+    /// Have the running session also raise `notify` on new mail.
+    pub fn subscribe(&self, notify: &Arc<AtomicBool>) {
+        let mut flags = self.notify.lock().expect("notify mutex");
+        if !flags.iter().any(|f| Arc::ptr_eq(f, notify)) {
+            flags.push(Arc::clone(notify));
+        }
+    }
+
+    /// Stop raising `notify`. Returns whether anyone is still subscribed.
+    pub fn unsubscribe(&self, notify: &Arc<AtomicBool>) -> bool {
+        let mut flags = self.notify.lock().expect("notify mutex");
+        flags.retain(|f| !Arc::ptr_eq(f, notify));
+        !flags.is_empty()
+    }
+
     /// Stop the background IDLE task.
     ///
     /// Returns immediately: cancelling the token interrupts the IDLE wait at
@@ -105,7 +125,7 @@ impl Drop for IdleController {
 async fn idle_loop(
     config: EmailClientConfig,
     folder: String,
-    notify: Arc<AtomicBool>,
+    notify: Subscribers,
     cancel: CancellationToken,
     token: Arc<Mutex<String>>,
 ) {
@@ -130,7 +150,7 @@ async fn idle_loop(
 async fn run_idle_session(
     config: &EmailClientConfig,
     folder: &str,
-    notify: &Arc<AtomicBool>,
+    notify: &Subscribers,
     cancel: &CancellationToken,
     token: &Arc<Mutex<String>>,
 ) -> Result<(), String> {
@@ -173,7 +193,9 @@ async fn run_idle_session(
             Some(IdleResponse::Timeout) => {}
             Some(IdleResponse::NewData(data)) => {
                 if is_mailbox_change(data.parsed()) {
-                    notify.store(true, Ordering::Relaxed);
+                    for flag in notify.lock().expect("notify mutex").iter() {
+                        flag.store(true, Ordering::Relaxed);
+                    }
                 }
             }
         }
@@ -227,6 +249,18 @@ mod tests {
         assert!(!notify.load(Ordering::Relaxed));
     }
 
+    #[test]
+    fn test_subscribers_are_counted_once_each() {
+        let first = Arc::new(AtomicBool::new(false));
+        let second = Arc::new(AtomicBool::new(false));
+        let ctrl = IdleController::new(Arc::clone(&first));
+        ctrl.subscribe(&second);
+        ctrl.subscribe(&second);
+        assert_eq!(ctrl.notify.lock().expect("notify mutex").len(), 2);
+        assert!(ctrl.unsubscribe(&first));
+        assert!(!ctrl.unsubscribe(&second));
+    }
+
     #[test]
     fn test_update_token_is_visible_to_the_session() {
         let notify = Arc::new(AtomicBool::new(false));
@@ -3,7 +3,8 @@
 //! Implements the [`Provider`] trait for IMAP/SMTP email access.
 //! IMAP and SMTP operations are injected via the [`ImapBackend`] and
 //! [`SmtpBackend`] traits, making the provider fully unit-testable.
-//! Real network backends live in `net`, OAuth2 in `oauth2`, IDLE in `idle`.
+//! Real network backends live in `net`, OAuth2 in `oauth2`, IDLE in `idle`;
+//! the connection and IDLE sessions tabs share per account live in `account`.
 //!
 //! ## FFON tree layout
 //!
@@ -24,6 +25,7 @@
 //!   Date: …        (str)
 //!   Subject: …     (str)
 //!   body text      (str)
+//!   Attachments    (obj)  — one button per attachment, fetched on press
 //!   History        (obj)  — only if References header present
 //!   reply          (obj)
 //!   reply all      (obj)
@@ -43,9 +45,11 @@
 //!   History        (obj)  — only for reply/reply-all (lazy)
 //! ```
 
+pub mod account;
 pub mod cache;
 pub mod connection;
 pub mod idle;
+mod mime;
 pub mod net;
 pub mod oauth2;
 
@@ -78,7 +82,7 @@ use sicompass_sdk::platform;
 use sicompass_sdk::provider::Provider;
 use sicompass_sdk::timeline::{ImapOpKind, TimelineEntry};
 
-use idle::IdleController;
+use account::{Account, SharedImap};
 
 // ---------------------------------------------------------------------------
 // Mail body type
@@ -200,11 +204,19 @@ pub struct MessageHeader {
 }
 
 /// A file attached to a received message.
+///
+/// Only the metadata is kept: the bytes are fetched with
+/// `ImapBackend::fetch_part` when the user opens the attachment.
 #[derive(Debug, Clone)]
 pub struct EmailAttachment {
     pub filename: String,
     pub content_type: String,
-    pub data: Vec<u8>,
+    /// IMAP section number of the part, e.g. `"2"` or `"1.3"`.
+    pub section: String,
+    /// Lowercased Content-Transfer-Encoding of the part.
+    pub encoding: String,
+    /// Decoded size in bytes.
+    pub size: usize,
 }
 
 /// A fully fetched email message.
@@ -278,6 +290,14 @@ pub trait ImapBackend: Send {
         folder: &str,
         uid: u32,
     ) -> Result<Option<EmailMessage>, String>;
+    /// Fetch one MIME part of a message (`BODY.PEEK[section]`), still
+    /// transfer-encoded. `Ok(None)` when the server has no such part.
+    async fn fetch_part(
+        &mut self,
+        folder: &str,
+        uid: u32,
+        section: &str,
+    ) -> Result<Option<Vec<u8>>, String>;
     /// Fetch a message by its Message-ID header via IMAP SEARCH.
     async fn fetch_message_by_message_id(
         &mut self,
@@ -329,51 +349,29 @@ pub trait SmtpBackend: Send {
 // ---------------------------------------------------------------------------
 
 // ---------------------------------------------------------------------------
-// Settings file helpers (atomic write)
+// Settings file helper
 // ---------------------------------------------------------------------------
 
-/// Load the settings root for an in-place key write. Returns `Some(object)` for
-/// a parseable file, `Some(empty)` only when the file is genuinely absent (first
-/// write), and `None` when it exists but can't be read or parsed — in that case
-/// another writer is likely mid-write, so the caller MUST abort rather than
-/// rebuild from an empty object, which would wipe every other section.
-fn load_settings_json(path: &std::path::Path) -> Option<serde_json::Value> {
-    match std::fs::read_to_string(path) {
-        Ok(s) => match serde_json::from_str::<serde_json::Value>(&s) {
-            Ok(v @ serde_json::Value::Object(_)) => Some(v),
-            _ => None,
-        },
-        Err(e) if e.kind() == std::io::ErrorKind::NotFound => {
-            Some(serde_json::Value::Object(Default::default()))
+/// Write `fields` into the "email client" section of the settings at `path`,
+/// in one edit. The shared store refuses the edit when the file exists but
+/// does not parse, so a half-written file never loses its other sections.
+fn save_email_fields(path: &std::path::Path, fields: Vec<(&str, serde_json::Value)>) {
+    sicompass_config::at(path).update(|root| {
+        let serde_json::Value::Object(section) = root
+            .entry("email client".to_owned())
+            .or_insert_with(|| serde_json::Value::Object(Default::default()))
+        else {
+            return false;
+        };
+        let mut changed = false;
+        for (key, value) in fields {
+            if section.get(key) != Some(&value) {
+                section.insert(key.to_owned(), value);
+                changed = true;
+            }
         }
-        Err(_) => None,
-    }
-}
-
-fn ensure_email_section(
-    root: &mut serde_json::Value,
-) -> &mut serde_json::Map<String, serde_json::Value> {
-    let obj = root.as_object_mut().expect("settings root is object");
-    if !obj.contains_key("email client") {
-        obj.insert(
-            "email client".to_owned(),
-            serde_json::Value::Object(Default::default()),
-        );
-    }
-    obj.get_mut("email client")
-        .expect("just inserted")
-        .as_object_mut()
-        .expect("email client is object")
-}
-
-/// Write `value` as pretty JSON to `path` atomically. Routes through the SDK's
-/// `atomic_write`, whose temp file is PID-keyed, so concurrent writers (e.g.
-/// one email provider instance per tab) don't collide on a shared `.tmp` path.
-fn atomic_write_json(path: &std::path::Path, value: &serde_json::Value) {
-    let Ok(json) = serde_json::to_string_pretty(value) else {
-        return;
-    };
-    let _ = platform::atomic_write(path, &json);
+        changed
+    });
 }
 
 // ---------------------------------------------------------------------------
@@ -390,6 +388,31 @@ fn folder_display_name(imap_name: &str) -> &str {
     }
 }
 
+/// Where opened attachments are decoded to: the platform cache dir +
+/// `/sicompass/email/attachments`, next to the envelope cache.
+fn attachment_dir() -> Option<std::path::PathBuf> {
+    Some(
+        platform::cache_home()?
+            .join("sicompass")
+            .join("email")
+            .join("attachments"),
+    )
+}
+
+/// File name for a decoded attachment. UID and section keep two attachments
+/// with the same name apart; the sender-chosen name is reduced to its last
+/// path component so it cannot point outside the attachment directory.
+fn attachment_file_name(uid: u32, att: &EmailAttachment) -> String {
+    let base = att
+        .filename
+        .rsplit(['/', '\\'])
+        .next()
+        .unwrap_or("")
+        .trim_start_matches('.');
+    let base = if base.is_empty() { "attachment" } else { base };
+    format!("{uid}-{}-{base}", att.section)
+}
+
 /// Compute the FFON label for a message header.
 ///
 /// Produces a prefix of bracketed state tags followed by the subject/from body:
@@ -478,8 +501,11 @@ pub struct EmailClientProvider {
     // Cross-thread needs-refresh flag (set by IDLE, cleared by fetch).
     needs_refresh_flag: Arc<AtomicBool>,
 
-    // IDLE background thread controller.
-    idle: IdleController,
+    // Connection and IDLE sessions, shared with every other tab signed in to
+    // the same account; see `account.rs`.
+    account: Arc<Account>,
+    // Folder this provider is subscribed to on the account's IDLE.
+    watching: Option<String>,
 
     // Injected backends (None until init() or with_imap/with_smtp).
     imap: Option<Box<dyn ImapBackend>>,
@@ -505,12 +531,13 @@ pub struct EmailClientProvider {
     // the same inflight + result-slot + `needs_refresh_flag` handshake the
     // folder fetch already proved out.
     //
-    // One connection behind an async mutex, reused across operations. IMAP is
+    // One connection behind an async mutex, reused across operations — the
+    // account's background one, so every tab on the account shares it. IMAP is
     // strictly one command at a time per connection anyway, and reconnecting
     // per operation would cost a TCP + TLS + login round-trip on every message
-    // open — worse than the blocking this replaces. The render thread never
-    // touches it; only spawned tasks do.
-    bg_imap: Option<Arc<tokio::sync::Mutex<crate::net::RealImap>>>,
+    // open — worse than the blocking this replaces. Only spawned tasks lock
+    // it. What still runs inline through `self.imap` goes over the account's
+    // sync connection, so it never waits behind a task here.
 
     // Message body fetch (opening a message).
     message_fetch_inflight: Arc<AtomicBool>,
@@ -663,9 +690,10 @@ impl BgOp {
 
 impl EmailClientProvider {
     pub fn new() -> Self {
-        let needs_refresh_flag = Arc::new(AtomicBool::new(false));
+        let config = EmailClientConfig::default();
         EmailClientProvider {
-            config: EmailClientConfig::default(),
+            account: Account::for_config(&config),
+            config,
             current_path: "/".to_owned(),
             folder_mappings: Vec::new(),
             folder_cache: None,
@@ -683,15 +711,14 @@ impl EmailClientProvider {
             history_refs: String::new(),
             history_uid: None,
             thread_cache: std::collections::HashMap::new(),
-            needs_refresh_flag: Arc::clone(&needs_refresh_flag),
-            idle: IdleController::new(needs_refresh_flag),
+            needs_refresh_flag: Arc::new(AtomicBool::new(false)),
+            watching: None,
             imap: None,
             smtp: None,
             folder_fetch_inflight: Arc::new(AtomicBool::new(false)),
             folder_fetch_result: Arc::new(Mutex::new(None)),
             async_folder_fetch_enabled: true,
             inbox_prefetch_result: Arc::new(Mutex::new(None)),
-            bg_imap: None,
             message_fetch_inflight: Arc::new(AtomicBool::new(false)),
             message_fetch_result: Arc::new(Mutex::new(None)),
             message_fetch_key: None,
@@ -721,23 +748,50 @@ impl EmailClientProvider {
 
     // ---- Non-blocking IMAP plumbing -----------------------------------------
 
-    /// The shared background connection, opened on first use.
-    fn bg_imap(&mut self) -> Arc<tokio::sync::Mutex<crate::net::RealImap>> {
-        if self.bg_imap.is_none() {
-            self.bg_imap = Some(Arc::new(tokio::sync::Mutex::new(
-                crate::net::RealImap::from_config(&self.config),
-            )));
-        }
-        Arc::clone(self.bg_imap.as_ref().expect("opened above"))
+    /// The account's background connection, opened on first use.
+    fn bg_imap(&mut self) -> account::Connection {
+        self.account.connection(&self.config)
     }
 
     /// Drop the background connection so the next operation reconnects.
     ///
     /// Called wherever `self.imap` is invalidated — after a token refresh or a
     /// config change — since the open connection authenticated with the old
-    /// credentials.
+    /// credentials. A change of server or user moves the provider to that
+    /// account instead, leaving the old one to the tabs still on it.
     fn reset_bg_imap(&mut self) {
-        self.bg_imap = None;
+        if self.join_account() {
+            self.account.reconnect();
+        }
+    }
+
+    /// Move to the account `self.config` names. Returns whether it is the
+    /// account the provider was already on.
+    fn join_account(&mut self) -> bool {
+        let account = Account::for_config(&self.config);
+        if Arc::ptr_eq(&account, &self.account) {
+            return true;
+        }
+        self.unwatch_folder();
+        self.account = account;
+        false
+    }
+
+    /// Refresh on changes to `folder`, and stop refreshing on any other.
+    fn watch_folder(&mut self, folder: String) {
+        if self.watching.as_deref() == Some(folder.as_str()) {
+            return;
+        }
+        self.unwatch_folder();
+        self.account
+            .watch(&self.config, &folder, &self.needs_refresh_flag);
+        self.watching = Some(folder);
+    }
+
+    fn unwatch_folder(&mut self) {
+        if let Some(folder) = self.watching.take() {
+            self.account.unwatch(&folder, &self.needs_refresh_flag);
+        }
     }
 
     /// Whether IMAP work should run in the background.
@@ -926,6 +980,78 @@ impl EmailClientProvider {
         });
     }
 
+    /// Fetch, decode and open an attachment of the message being viewed.
+    ///
+    /// The part is pulled from the server only now, so a message with a large
+    /// attachment costs nothing extra until the user asks for the file.
+    fn open_attachment(&mut self, section: &str) {
+        let Some(dir) = attachment_dir() else {
+            self.error_message = Some("open attachment failed: no cache directory".to_owned());
+            return;
+        };
+        if !self.bg_enabled() {
+            match self.save_attachment(section, &dir) {
+                Ok(path) => platform::open_with_default(&path.to_string_lossy()),
+                Err(e) => self.error_message = Some(format!("open attachment failed: {e}")),
+            }
+            return;
+        }
+
+        let Some((folder, uid, att)) = self.attachment_for(section) else {
+            return;
+        };
+        let dest = dir.join(attachment_file_name(uid, &att));
+        let imap = self.bg_imap();
+        let errors = Arc::clone(&self.bg_errors);
+        let bg_done = Arc::clone(&self.bg_completed);
+
+        crate::connection::runtime().spawn(async move {
+            let fetched = {
+                let mut guard = imap.lock().await;
+                guard.fetch_part(&folder, uid, &att.section).await
+            };
+            let saved = match fetched {
+                Ok(Some(raw)) => mime::write_attachment(&raw, &att.encoding, &dest),
+                Ok(None) => Err("part not found on server".to_owned()),
+                Err(e) => Err(e),
+            };
+            match saved {
+                Ok(_) => platform::open_with_default(&dest.to_string_lossy()),
+                Err(e) => {
+                    errors
+                        .lock()
+                        .unwrap()
+                        .push(format!("open attachment failed: {e}"));
+                    bg_done.store(true, Ordering::Release);
+                }
+            }
+        });
+    }
+
+    /// The viewed message's attachment at `section`, with its folder and UID.
+    fn attachment_for(&self, section: &str) -> Option<(String, u32, EmailAttachment)> {
+        let msg = self.message_detail.as_ref()?;
+        let att = msg.attachments.iter().find(|a| a.section == section)?;
+        Some((self.message_detail_folder.clone(), msg.uid, att.clone()))
+    }
+
+    /// Fetch an attachment on the blocking path and decode it into `dir`.
+    fn save_attachment(
+        &mut self,
+        section: &str,
+        dir: &std::path::Path,
+    ) -> Result<std::path::PathBuf, String> {
+        let (folder, uid, att) = self
+            .attachment_for(section)
+            .ok_or_else(|| format!("no attachment {section}"))?;
+        let imap = self.imap.as_mut().ok_or("not connected")?;
+        let raw = block_on(imap.fetch_part(&folder, uid, &att.section))?
+            .ok_or("part not found on server")?;
+        let dest = dir.join(attachment_file_name(uid, &att));
+        mime::write_attachment(&raw, &att.encoding, &dest)?;
+        Ok(dest)
+    }
+
     fn push_imap_op(&mut self, op: ImapOpKind) {
         self.pending_timeline_entries.push(TimelineEntry::ImapOp {
             provider_idx: 0, // patched by app
@@ -1220,23 +1346,14 @@ impl EmailClientProvider {
         let Some(path) = self.config_path() else {
             return;
         };
-        let Some(mut root) = load_settings_json(&path) else {
-            return;
-        };
-        let section = ensure_email_section(&mut root);
-        section.insert(
-            "emailImapUrl".to_owned(),
-            self.config.imap_url.clone().into(),
+        save_email_fields(
+            &path,
+            vec![
+                ("emailImapUrl", self.config.imap_url.clone().into()),
+                ("emailSmtpUrl", self.config.smtp_url.clone().into()),
+                ("emailUsername", self.config.username.clone().into()),
+            ],
         );
-        section.insert(
-            "emailSmtpUrl".to_owned(),
-            self.config.smtp_url.clone().into(),
-        );
-        section.insert(
-            "emailUsername".to_owned(),
-            self.config.username.clone().into(),
-        );
-        atomic_write_json(&path, &root);
     }
 
     /// Persist OAuth tokens to settings.json.
@@ -1244,23 +1361,20 @@ impl EmailClientProvider {
         let Some(path) = self.config_path() else {
             return;
         };
-        let Some(mut root) = load_settings_json(&path) else {
-            return;
-        };
-        let section = ensure_email_section(&mut root);
-        section.insert(
-            "emailOAuthAccessToken".to_owned(),
-            self.config.oauth_access_token.clone().into(),
+        save_email_fields(
+            &path,
+            vec![
+                (
+                    "emailOAuthAccessToken",
+                    self.config.oauth_access_token.clone().into(),
+                ),
+                (
+                    "emailOAuthRefreshToken",
+                    self.config.oauth_refresh_token.clone().into(),
+                ),
+                ("emailTokenExpiry", self.config.token_expiry.into()),
+            ],
         );
-        section.insert(
-            "emailOAuthRefreshToken".to_owned(),
-            self.config.oauth_refresh_token.clone().into(),
-        );
-        section.insert(
-            "emailTokenExpiry".to_owned(),
-            self.config.token_expiry.into(),
-        );
-        atomic_write_json(&path, &root);
     }
 
     // ---- IMAP backend access with lazy real-backend construction -------------
@@ -1455,7 +1569,7 @@ impl EmailClientProvider {
 
     fn build_root(&mut self) -> Vec<FfonElement> {
         // Stop IDLE when leaving a folder (returning to root).
-        self.idle.stop();
+        self.unwatch_folder();
 
         // When not logged in, show a single login button.
         if !self.is_logged_in() {
@@ -1644,7 +1758,7 @@ impl EmailClientProvider {
         }
 
         // Start IDLE for new mail notifications.
-        self.idle.start(self.config.clone(), real_folder);
+        self.watch_folder(real_folder);
 
         items
     }
@@ -2333,7 +2447,7 @@ impl EmailClientProvider {
                     // the old one at start-up, so without this it would keep
                     // reconnecting on a dead credential until the folder was
                     // re-entered, and new mail would stop being noticed.
-                    self.idle.update_token(&self.config.oauth_access_token);
+                    self.account.update_token(&self.config.oauth_access_token);
                     // Drop backends and cached folder list so the next fetch
                     // issues a fresh IMAP connection with the new token.
                     self.imap = None;
@@ -2395,6 +2509,7 @@ impl EmailClientProvider {
     /// Rebuild the IMAP/SMTP backends from current config.
     /// Called after config changes (init, on_setting_change).
     fn rebuild_backends(&mut self) {
+        self.join_account();
         if self.config.imap_url.is_empty() || self.config.username.is_empty() {
             return;
         }
@@ -2404,7 +2519,10 @@ impl EmailClientProvider {
         }
         // Only build if no backend is already injected (e.g. in tests).
         if self.imap.is_none() {
-            self.imap = Some(Box::new(net::RealImap::from_config(&self.config)));
+            self.imap = Some(Box::new(SharedImap::new(
+                Arc::clone(&self.account),
+                &self.config,
+            )));
         }
         if self.smtp.is_none() {
             self.smtp = Some(Box::new(net::RealSmtp::from_config(&self.config)));
@@ -2587,10 +2705,8 @@ fn build_message_view(msg: &EmailMessage) -> Vec<FfonElement> {
                 .iter()
                 .map(|a| {
                     FfonElement::new_str(format!(
-                        "{} ({}, {} bytes)",
-                        a.filename,
-                        a.content_type,
-                        a.data.len()
+                        "<button>attachment:{}</button>{} ({}, {} bytes)",
+                        a.section, a.filename, a.content_type, a.size
                     ))
                 })
                 .collect();
@@ -2960,6 +3076,13 @@ impl Default for EmailClientProvider {
     }
 }
 
+impl Drop for EmailClientProvider {
+    /// Leave the account's IDLE session; other tabs may still be on it.
+    fn drop(&mut self) {
+        self.unwatch_folder();
+    }
+}
+
 #[async_trait::async_trait]
 impl Provider for EmailClientProvider {
     fn name(&self) -> &str {
@@ -2984,6 +3107,13 @@ impl Provider for EmailClientProvider {
         self.envelope_cache = None;
     }
 
+    /// A compose form with something typed in is saved to Drafts only when it
+    /// is left (`pop_path`). Until then this provider holds the only copy, so
+    /// its tab is neither dehydrated nor closed without asking.
+    fn is_busy(&self) -> bool {
+        self.at_compose() && Self::is_draft_non_empty(&self.compose.draft)
+    }
+
     fn init(&mut self) {
         self.current_path = "/".to_owned();
         self.folder_cache = None;
@@ -2994,13 +3124,10 @@ impl Provider for EmailClientProvider {
         let Some(path) = self.config_path() else {
             return;
         };
-        let Ok(content) = std::fs::read_to_string(&path) else {
-            return;
-        };
-        let Ok(root) = serde_json::from_str::<serde_json::Value>(&content) else {
-            return;
-        };
-        let Some(section) = root.get("email client").and_then(|v| v.as_object()) else {
+        let Some(serde_json::Value::Object(section)) = sicompass_config::at(&path)
+            .read(|root| root.get("email client").cloned())
+            .flatten()
+        else {
             return;
         };
 
@@ -3028,7 +3155,7 @@ impl Provider for EmailClientProvider {
     }
 
     fn cleanup(&mut self) {
-        self.idle.stop();
+        self.unwatch_folder();
         self.folder_cache = None;
         self.envelope_cache = None;
     }
@@ -3290,6 +3417,9 @@ impl Provider for EmailClientProvider {
                 renormalize_body_variant(&mut self.compose.draft.body);
                 self.sync_body_path_label();
             }
+            name if name.starts_with("attachment:") => {
+                self.open_attachment(&name["attachment:".len()..]);
+            }
             "load-more" => {
                 // Increase the display limit for the current folder by 50.
                 let segs = self.path_segments();
@@ -3612,7 +3742,7 @@ impl Provider for EmailClientProvider {
                 None
             }
             "logout" => {
-                self.idle.stop();
+                self.unwatch_folder();
                 self.config.oauth_access_token.clear();
                 self.config.oauth_refresh_token.clear();
                 self.config.token_expiry = 0;
@@ -3925,6 +4055,9 @@ mod tests {
         appended: Vec<(String, Vec<u8>)>,         // (folder, raw_bytes)
         /// Pre-configured thread result for fetch_threads(); None = not supported.
         thread_result: Option<Vec<Vec<u32>>>,
+        /// Raw MIME parts served by fetch_part(), keyed by section.
+        parts: Vec<(String, Vec<u8>)>,
+        fetched_parts: Vec<(String, u32, String)>, // (folder, uid, section)
     }
 
     impl MockImap {
@@ -3945,8 +4078,14 @@ mod tests {
                 expunged: vec![],
                 appended: vec![],
                 thread_result: None,
+                parts: vec![],
+                fetched_parts: vec![],
             }
         }
+        fn with_part(mut self, section: &str, raw: &[u8]) -> Self {
+            self.parts.push((section.to_owned(), raw.to_vec()));
+            self
+        }
         fn with_threads(mut self, threads: Vec<Vec<u32>>) -> Self {
             self.thread_result = Some(threads);
             self
@@ -4022,6 +4161,23 @@ mod tests {
             }
             Ok(self.detail.clone())
         }
+        async fn fetch_part(
+            &mut self,
+            folder: &str,
+            uid: u32,
+            section: &str,
+        ) -> Result<Option<Vec<u8>>, String> {
+            if let Some(ref e) = self.error {
+                return Err(e.clone());
+            }
+            self.fetched_parts
+                .push((folder.to_owned(), uid, section.to_owned()));
+            Ok(self
+                .parts
+                .iter()
+                .find(|(s, _)| s == section)
+                .map(|(_, raw)| raw.clone()))
+        }
         async fn fetch_message_by_message_id(
             &mut self,
             folder: &str,
@@ -4559,12 +4715,87 @@ mod tests {
         let mut p = EmailClientProvider::new();
         p.config.imap_url = "imaps://imap.example.com".to_owned();
         p.config.username = "user@example.com".to_owned();
+        p.join_account();
         let _ = p.bg_imap();
-        assert!(p.bg_imap.is_some());
+        assert!(p.account.is_connected());
 
         // The open connection authenticated with the previous credentials.
         p.reset_bg_imap();
-        assert!(p.bg_imap.is_none());
+        assert!(!p.account.is_connected());
+    }
+
+    /// Inline calls through the sync backend run on the render thread; they
+    /// must not queue behind a background fetch holding the task connection.
+    #[test]
+    fn test_sync_backend_does_not_share_the_background_connection() {
+        let mut p = on_account("sync@example.com");
+        p.config.password = "secret".to_owned();
+        p.rebuild_backends();
+        assert!(p.imap.is_some());
+        assert!(!p.account.shares_connections(&p.config));
+    }
+
+    fn on_account(username: &str) -> EmailClientProvider {
+        let mut p = EmailClientProvider::new();
+        p.config.imap_url = "imaps://imap.example.com".to_owned();
+        p.config.username = username.to_owned();
+        p.join_account();
+        p
+    }
+
+    #[test]
+    fn test_tabs_on_one_account_share_one_connection_and_cache() {
+        let mut tabs: Vec<_> = (0..3).map(|_| on_account("tabs@example.com")).collect();
+        let first = tabs[0].bg_imap();
+        let first_sync = tabs[0].account.sync_connection(&tabs[0].config);
+        for tab in &mut tabs[1..] {
+            assert!(Arc::ptr_eq(&first, &tab.bg_imap()));
+            assert!(Arc::ptr_eq(
+                &first_sync,
+                &tab.account.sync_connection(&tab.config)
+            ));
+        }
+        // Each connection opens its own envelope cache handle, so three tabs
+        // hold two logins and two handles: the background one and the render
+        // thread's.
+        assert_eq!(tabs[0].account.open_connections(), 2);
+        assert_eq!(Arc::strong_count(&tabs[0].account), 3);
+
+        // Another user on the same server is another account.
+        let mut other = on_account("other-tabs@example.com");
+        assert!(!Arc::ptr_eq(&first, &other.bg_imap()));
+
+        // The account closes with its last tab.
+        let account = Arc::downgrade(&tabs[0].account);
+        drop(tabs);
+        drop((first, first_sync));
+        assert!(account.upgrade().is_none());
+    }
+
+    #[test]
+    fn test_tabs_in_one_folder_share_one_idle_session() {
+        let mut a = on_account("idle-tabs@example.com");
+        let mut b = on_account("idle-tabs@example.com");
+        a.watch_folder("INBOX".to_owned());
+        b.watch_folder("INBOX".to_owned());
+        assert_eq!(a.account.watch_count(), 1);
+
+        // A tab in another folder needs a session of its own.
+        b.watch_folder("Sent".to_owned());
+        assert_eq!(a.account.watch_count(), 2);
+
+        // The last tab out of a folder stops its session.
+        a.unwatch_folder();
+        assert_eq!(b.account.watch_count(), 1);
+        drop(b);
+        assert_eq!(a.account.watch_count(), 0);
+    }
+
+    #[test]
+    fn test_unconfigured_providers_share_nothing() {
+        let a = EmailClientProvider::new();
+        let b = EmailClientProvider::new();
+        assert!(!Arc::ptr_eq(&a.account, &b.account));
     }
 
     #[test]
@@ -7385,7 +7616,9 @@ mod tests {
         let attachment = EmailAttachment {
             filename: "report.pdf".to_owned(),
             content_type: "application/pdf".to_owned(),
-            data: vec![1, 2, 3, 4],
+            section: "2".to_owned(),
+            encoding: "base64".to_owned(),
+            size: 4,
         };
         let mut msg = make_message(1);
         msg.attachments = vec![attachment];
@@ -7407,6 +7640,61 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_message_view_attachment_is_a_button_naming_its_section() {
+        let mut msg = make_message(1);
+        msg.attachments = vec![EmailAttachment {
+            filename: "report.pdf".to_owned(),
+            content_type: "application/pdf".to_owned(),
+            section: "1.2".to_owned(),
+            encoding: "base64".to_owned(),
+            size: 4,
+        }];
+        let items = build_message_view(&msg);
+        let attach_obj = items
+            .iter()
+            .find_map(|e| e.as_obj().filter(|o| o.key == "Attachments"))
+            .expect("Attachments obj");
+        assert_eq!(
+            attach_obj.children[0]
+                .as_str()
+                .map(|s| s.to_string())
+                .as_deref(),
+            Some("<button>attachment:1.2</button>report.pdf (application/pdf, 4 bytes)")
+        );
+    }
+
+    #[test]
+    fn test_save_attachment_fetches_only_the_opened_part() {
+        let mut msg = make_message(7);
+        msg.attachments = vec![EmailAttachment {
+            filename: "../notes.txt".to_owned(),
+            content_type: "text/plain".to_owned(),
+            section: "2".to_owned(),
+            encoding: "base64".to_owned(),
+            size: 12,
+        }];
+        let mut p = EmailClientProvider::new().with_imap(Box::new(
+            MockImap::new().with_part("2", b"aGVsbG8sIHdvcmxk\r\n"),
+        ));
+        p.message_detail = Some(msg);
+        p.message_detail_folder = "INBOX".to_owned();
+
+        let dir = tempfile::tempdir().unwrap();
+        let path = p.save_attachment("2", dir.path()).expect("save_attachment");
+
+        assert_eq!(path, dir.path().join("7-2-notes.txt"));
+        assert_eq!(std::fs::read(&path).unwrap(), b"hello, world");
+    }
+
+    #[test]
+    fn test_save_attachment_unknown_section_is_an_error() {
+        let mut p = EmailClientProvider::new().with_imap(Box::new(MockImap::new()));
+        p.message_detail = Some(make_message(7));
+        let dir = tempfile::tempdir().unwrap();
+        assert!(p.save_attachment("3", dir.path()).is_err());
+    }
+
     #[test]
     fn test_message_view_no_attachments_section_when_empty() {
         let msg = make_message(1);
@@ -7440,9 +7728,12 @@ mod tests {
             .with_imap(Box::new(imap));
         p.fetch(); // populate special_folders
         p.push_path("compose");
+        assert!(!p.is_busy(), "an empty form holds nothing to lose");
         p.compose.draft.to = "to@example.com".to_owned();
         p.compose.draft.subject = "Draft subject".to_owned();
+        assert!(p.is_busy(), "the draft is not saved anywhere yet");
         p.pop_path();
+        assert!(!p.is_busy());
         let mock = p.imap.as_ref().unwrap().as_ref() as *const dyn ImapBackend as *const MockImap;
         let appended = unsafe { &(*mock).appended };
         assert!(
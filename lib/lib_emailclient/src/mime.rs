@@ -0,0 +1,431 @@
+//! Byte-level MIME walker for fetched messages.
+//!
+//! `parse_rfc2822` used to convert the whole `BODY[]` literal to a `String`,
+//! split it into owned chunks per part and decode every attachment up front,
+//! so a message with a 40 MB attachment was held four or five times over
+//! before the first frame rendered. The walker here borrows slices of the raw
+//! literal instead: each leaf part is a `&[u8]` into the fetch buffer, only
+//! body candidates are decoded, and attachments are recorded by IMAP section
+//! number so `ImapBackend::fetch_part` can pull them on demand.
+//!
+//! Decoding is line-at-a-time into any `Write`, so an attachment the user opens
+//! streams from the fetched part into its file without a second full-size copy.
+
+use std::io::{self, Write};
+
+/// A header block split into `(lowercase-name, unfolded-value)` pairs.
+///
+/// Header blocks are a few hundred bytes, so they are the one thing worth
+/// materialising; bodies stay borrowed.
+#[derive(Debug, Default)]
+pub(crate) struct Headers(Vec<(String, String)>);
+
+impl Headers {
+    /// Parse a raw header block with folded-line support (RFC 2822 §2.2.3).
+    pub(crate) fn parse(block: &[u8]) -> Self {
+        let text = String::from_utf8_lossy(block);
+        let mut out: Vec<(String, String)> = Vec::new();
+        for line in text.lines() {
+            if line.starts_with(' ') || line.starts_with('\t') {
+                if let Some((_, value)) = out.last_mut() {
+                    value.push(' ');
+                    value.push_str(line.trim());
+                }
+                continue;
+            }
+            if let Some((name, value)) = line.split_once(':') {
+                out.push((name.trim().to_ascii_lowercase(), value.trim().to_owned()));
+            }
+        }
+        Headers(out)
+    }
+
+    /// The first value for `name` (lowercase), or `""` when absent.
+    pub(crate) fn get(&self, name: &str) -> &str {
+        self.0
+            .iter()
+            .find(|(n, _)| n == name)
+            .map_or("", |(_, v)| v.as_str())
+    }
+}
+
+/// One leaf part of a message, borrowing its body from the raw literal.
+#[derive(Debug)]
+pub(crate) struct Part<'a> {
+    /// IMAP section number (RFC 3501 §6.4.5), e.g. `"1"` or `"2.1"`.
+    pub section: String,
+    /// Full `Content-Type` value, parameters included.
+    pub content_type: String,
+    /// Lowercased `Content-Transfer-Encoding`.
+    pub encoding: String,
+    /// Lowercased `Content-Disposition`.
+    pub disposition: String,
+    pub filename: String,
+    /// Still transfer-encoded.
+    pub body: &'a [u8],
+}
+
+impl Part<'_> {
+    /// The bare lowercased MIME type, without parameters.
+    pub(crate) fn mime(&self) -> String {
+        mime_type(&self.content_type)
+    }
+
+    /// Whether this part is a file rather than a candidate for the body.
+    ///
+    /// `application/json` stays a body candidate: it is how FFON bodies that
+    /// were not sent by sicompass arrive.
+    pub(crate) fn is_attachment(&self) -> bool {
+        if self.disposition.trim_start().starts_with("attachment") {
+            return true;
+        }
+        let mime = self.mime();
+        !mime.is_empty()
+            && !mime.starts_with("text/")
+            && !mime.starts_with("multipart/")
+            && mime != "application/json"
+    }
+
+    /// Size of the part once decoded, without decoding it.
+    pub(crate) fn decoded_size(&self) -> usize {
+        match self.encoding.as_str() {
+            "base64" => {
+                let mut chars = 0usize;
+                let mut padding = 0usize;
+                for &b in self.body {
+                    if b == b'=' {
+                        padding += 1;
+                    } else if !b.is_ascii_whitespace() {
+                        chars += 1;
+                    }
+                }
+                ((chars + padding) / 4 * 3).saturating_sub(padding)
+            }
+            _ => self.body.len(),
+        }
+    }
+}
+
+/// The bare lowercased MIME type of a `Content-Type` value.
+pub(crate) fn mime_type(content_type: &str) -> String {
+    content_type
+        .split(';')
+        .next()
+        .unwrap_or("")
+        .trim()
+        .to_ascii_lowercase()
+}
+
+/// Extract a parameter (e.g. `boundary`, `filename`) from a header value.
+pub(crate) fn header_param(value: &str, name: &str) -> Option<String> {
+    for param in value.split(';').skip(1) {
+        let p = param.trim();
+        let Some((key, val)) = p.split_once('=') else {
+            continue;
+        };
+        let key = key.trim().to_ascii_lowercase();
+        // `filename*=` is the RFC 2231 form; it is taken verbatim like the
+        // plain one rather than charset-decoded.
+        if key == name || key.strip_suffix('*') == Some(name) {
+            return Some(val.trim().trim_matches('"').to_owned());
+        }
+    }
+    None
+}
+
+/// Split a message or part at the first blank line into headers and body.
+pub(crate) fn split_headers(raw: &[u8]) -> (&[u8], &[u8]) {
+    if let Some(pos) = find(raw, b"\r\n\r\n") {
+        (&raw[..pos], &raw[pos + 4..])
+    } else if let Some(pos) = find(raw, b"\n\n") {
+        (&raw[..pos], &raw[pos + 2..])
+    } else {
+        (raw, &[])
+    }
+}
+
+/// Collect the leaf parts of a message body in document order.
+///
+/// `headers` are the message's own headers. A non-multipart message is a
+/// single leaf numbered `"1"`, as IMAP numbers it.
+pub(crate) fn leaf_parts<'a>(headers: &Headers, body: &'a [u8]) -> Vec<Part<'a>> {
+    let mut out = Vec::new();
+    walk(headers, body, "", &mut out);
+    out
+}
+
+/// Whether `headers` describe a multipart entity that can actually be split.
+pub(crate) fn is_multipart(headers: &Headers) -> bool {
+    let content_type = headers.get("content-type");
+    mime_type(content_type).starts_with("multipart/")
+        && header_param(content_type, "boundary").is_some()
+}
+
+fn walk<'a>(headers: &Headers, body: &'a [u8], section: &str, out: &mut Vec<Part<'a>>) {
+    let content_type = headers.get("content-type");
+    if is_multipart(headers) {
+        if let Some(boundary) = header_param(content_type, "boundary") {
+            for (i, chunk) in split_multipart(body, &boundary).into_iter().enumerate() {
+                let child = if section.is_empty() {
+                    format!("{}", i + 1)
+                } else {
+                    format!("{section}.{}", i + 1)
+                };
+                let (part_headers, part_body) = split_headers(chunk);
+                walk(&Headers::parse(part_headers), part_body, &child, out);
+            }
+            return;
+        }
+    }
+
+    let disposition = headers.get("content-disposition");
+    let filename = header_param(disposition, "filename")
+        .or_else(|| header_param(content_type, "name"))
+        .unwrap_or_default();
+    out.push(Part {
+        section: if section.is_empty() {
+            "1".to_owned()
+        } else {
+            section.to_owned()
+        },
+        content_type: content_type.to_owned(),
+        encoding: headers
+            .get("content-transfer-encoding")
+            .trim()
+            .to_ascii_lowercase(),
+        disposition: disposition.to_ascii_lowercase(),
+        filename,
+        body,
+    });
+}
+
+/// Split a multipart body on its `--boundary` delimiter lines.
+///
+/// The preamble and epilogue are dropped, and the line break before each
+/// delimiter belongs to the delimiter (RFC 2046 §5.1.1), so it is trimmed.
+fn split_multipart<'a>(body: &'a [u8], boundary: &str) -> Vec<&'a [u8]> {
+    let delimiter = format!("--{boundary}");
+    let delimiter = delimiter.as_bytes();
+    let mut parts = Vec::new();
+    let mut start: Option<usize> = None;
+    let mut pos = 0;
+    while pos < body.len() {
+        let line_end = body[pos..]
+            .iter()
+            .position(|&b| b == b'\n')
+            .map_or(body.len(), |i| pos + i + 1);
+        let line = &body[pos..line_end];
+        if line.starts_with(delimiter) {
+            if let Some(s) = start {
+                parts.push(trim_trailing_eol(&body[s..pos]));
+            }
+            if line[delimiter.len()..].starts_with(b"--") {
+                return parts;
+            }
+            start = Some(line_end);
+        }
+        pos = line_end;
+    }
+    // No closing delimiter: keep what arrived rather than drop the last part.
+    if let Some(s) = start {
+        if s < body.len() {
+            parts.push(trim_trailing_eol(&body[s..]));
+        }
+    }
+    parts
+}
+
+fn trim_trailing_eol(b: &[u8]) -> &[u8] {
+    let b = b.strip_suffix(b"\n").unwrap_or(b);
+    b.strip_suffix(b"\r").unwrap_or(b)
+}
+
+fn find(haystack: &[u8], needle: &[u8]) -> Option<usize> {
+    haystack.windows(needle.len()).position(|w| w == needle)
+}
+
+/// Bytes of base64 text decoded per step; a multiple of 4.
+const BASE64_CHUNK: usize = 16 * 1024;
+
+/// Decode a transfer-encoded part into `out`, returning the bytes written.
+///
+/// Works a line (quoted-printable) or a bounded chunk (base64) at a time, so
+/// the decoded copy never has to exist in memory as a whole.
+pub(crate) fn decode_into<W: Write>(body: &[u8], encoding: &str, out: &mut W) -> io::Result<u64> {
+    let mut written = 0u64;
+    match encoding.trim() {
+        "base64" => {
+            use base64::Engine as _;
+            let engine = &base64::engine::general_purpose::STANDARD;
+            let mut pending: Vec<u8> = Vec::with_capacity(BASE64_CHUNK + 4);
+            for &b in body {
+                if b.is_ascii_whitespace() {
+                    continue;
+                }
+                pending.push(b);
+                if pending.len() == BASE64_CHUNK {
+                    let bytes = engine
+                        .decode(&pending)
+                        .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))?;
+                    out.write_all(&bytes)?;
+                    written += bytes.len() as u64;
+                    pending.clear();
+                }
+            }
+            if !pending.is_empty() {
+                let bytes = engine
+                    .decode(&pending)
+                    .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))?;
+                out.write_all(&bytes)?;
+                written += bytes.len() as u64;
+            }
+        }
+        "quoted-printable" => {
+            // Soft line breaks (`=\r\n`) end a line, so decoding line by line
+            // with the line ending included joins them exactly as a
+            // whole-body decode would.
+            for line in body.split_inclusive(|&b| b == b'\n') {
+                let bytes = quoted_printable::decode(line, quoted_printable::ParseMode::Robust)
+                    .map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e.to_string()))?;
+                out.write_all(&bytes)?;
+                written += bytes.len() as u64;
+            }
+        }
+        _ => {
+            out.write_all(body)?;
+            written = body.len() as u64;
+        }
+    }
+    Ok(written)
+}
+
+/// Decode a text part to a `String`, falling back to the raw text when the
+/// encoding is broken rather than showing nothing.
+pub(crate) fn decode_text(body: &[u8], encoding: &str) -> String {
+    let mut buf = Vec::with_capacity(body.len());
+    match decode_into(body, encoding, &mut buf) {
+        Ok(_) => String::from_utf8_lossy(&buf).into_owned(),
+        Err(_) => String::from_utf8_lossy(body).into_owned(),
+    }
+}
+
+/// Decode a fetched attachment part straight into `dest`.
+pub(crate) fn write_attachment(
+    body: &[u8],
+    encoding: &str,
+    dest: &std::path::Path,
+) -> Result<u64, String> {
+    if let Some(parent) = dest.parent() {
+        std::fs::create_dir_all(parent).map_err(|e| e.to_string())?;
+    }
+    let file = std::fs::File::create(dest).map_err(|e| e.to_string())?;
+    let mut w = io::BufWriter::new(file);
+    let n = decode_into(body, encoding, &mut w).map_err(|e| e.to_string())?;
+    w.flush().map_err(|e| e.to_string())?;
+    Ok(n)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn mixed() -> &'static [u8] {
+        b"Content-Type: multipart/mixed; boundary=\"outer\"\r\n\
+          \r\n\
+          preamble\r\n\
+          --outer\r\n\
+          Content-Type: multipart/alternative; boundary=inner\r\n\
+          \r\n\
+          --inner\r\n\
+          Content-Type: text/plain\r\n\
+          \r\n\
+          plain\r\n\
+          --inner\r\n\
+          Content-Type: text/html\r\n\
+          \r\n\
+          <p>rich</p>\r\n\
+          --inner--\r\n\
+          --outer\r\n\
+          Content-Type: application/pdf; name=\"r.pdf\"\r\n\
+          Content-Transfer-Encoding: base64\r\n\
+          \r\n\
+          aGVsbG8sIHdvcmxk\r\n\
+          --outer--\r\n\
+          epilogue\r\n"
+    }
+
+    #[test]
+    fn leaf_parts_number_sections_like_imap() {
+        let (h, b) = split_headers(mixed());
+        let parts = leaf_parts(&Headers::parse(h), b);
+        let sections: Vec<&str> = parts.iter().map(|p| p.section.as_str()).collect();
+        assert_eq!(sections, ["1.1", "1.2", "2"]);
+        assert_eq!(parts[0].body, b"plain");
+        assert_eq!(parts[1].body, b"<p>rich</p>");
+    }
+
+    #[test]
+    fn single_part_message_is_section_one() {
+        let (h, b) = split_headers(b"Subject: x\r\n\r\nbody\r\n");
+        let parts = leaf_parts(&Headers::parse(h), b);
+        assert_eq!(parts.len(), 1);
+        assert_eq!(parts[0].section, "1");
+    }
+
+    #[test]
+    fn leaf_parts_borrow_the_raw_buffer() {
+        let raw = mixed();
+        let (h, b) = split_headers(raw);
+        let parts = leaf_parts(&Headers::parse(h), b);
+        let range = raw.as_ptr_range();
+        for p in &parts {
+            assert!(
+                range.contains(&p.body.as_ptr()),
+                "part {} was copied",
+                p.section
+            );
+        }
+    }
+
+    #[test]
+    fn attachment_size_is_known_without_decoding() {
+        let (h, b) = split_headers(mixed());
+        let parts = leaf_parts(&Headers::parse(h), b);
+        let pdf = &parts[2];
+        assert!(pdf.is_attachment());
+        assert_eq!(pdf.filename, "r.pdf");
+        assert_eq!(pdf.decoded_size(), b"hello, world".len());
+    }
+
+    #[test]
+    fn base64_decodes_across_chunk_boundaries() {
+        use base64::Engine as _;
+        let data: Vec<u8> = (0..BASE64_CHUNK * 3).map(|i| (i % 251) as u8).collect();
+        let encoded = base64::engine::general_purpose::STANDARD.encode(&data);
+        // Wrap at 76 columns as MIME does, so whitespace is interleaved.
+        let wrapped: Vec<u8> = encoded
+            .as_bytes()
+            .chunks(76)
+            .flat_map(|l| l.iter().copied().chain(*b"\r\n"))
+            .collect();
+        let mut out = Vec::new();
+        let n = decode_into(&wrapped, "base64", &mut out).unwrap();
+        assert_eq!(n as usize, data.len());
+        assert_eq!(out, data);
+    }
+
+    #[test]
+    fn quoted_printable_joins_soft_line_breaks() {
+        let text = decode_text(b"caf=C3=A9 au=\r\n lait\r\nnext", "quoted-printable");
+        assert_eq!(text, "café au lait\r\nnext");
+    }
+
+    #[test]
+    fn write_attachment_streams_decoded_bytes_to_disk() {
+        let dir = tempfile::tempdir().unwrap();
+        let dest = dir.path().join("sub").join("notes.txt");
+        let n = write_attachment(b"aGVsbG8s\r\nIHdvcmxk\r\n", "base64", &dest).unwrap();
+        assert_eq!(n, 12);
+        assert_eq!(std::fs::read(&dest).unwrap(), b"hello, world");
+    }
+}
@@ -10,11 +10,12 @@
 
 use crate::cache::EnvelopeCache;
 use crate::connection::{ImapSession, RawImap, connect_imap};
+use crate::mime;
 use crate::{
     EmailAttachment, EmailClientConfig, EmailMessage, FolderInfo, ImapBackend, MailBody,
     MessageHeader, SmtpBackend,
 };
-use async_imap::imap_proto::types::Address;
+use async_imap::imap_proto::types::{Address, SectionPath};
 use async_imap::types::Fetch;
 use async_trait::async_trait;
 use futures::TryStreamExt;
@@ -286,16 +287,46 @@ impl RealImap {
             .map_err(|e| e.to_string())?;
         let fetched: Vec<Fetch> = stream.try_collect().await.map_err(|e| e.to_string())?;
 
-        let raw = fetched
+        // Parsed straight out of the fetch buffer: copying the literal first
+        // would double the footprint of a message with a large attachment.
+        Ok(fetched
             .iter()
             .find(|m| m.uid == Some(uid))
             .and_then(|m| m.body())
-            .map(|b| b.to_vec());
+            .map(|bytes| parse_rfc2822(uid, bytes)))
+    }
 
-        match raw {
-            None => Ok(None),
-            Some(bytes) => Ok(Some(parse_rfc2822(uid, &bytes))),
-        }
+    async fn fetch_part_inner(
+        &mut self,
+        folder: &str,
+        uid: u32,
+        section: &str,
+    ) -> Result<Option<Vec<u8>>, String> {
+        let path = section
+            .split('.')
+            .map(str::parse::<u32>)
+            .collect::<Result<Vec<u32>, _>>()
+            .map_err(|_| format!("invalid MIME section {section:?}"))?;
+
+        self.ensure_session().await?;
+        let session = self.session_mut();
+
+        session.select(folder).await.map_err(|e| e.to_string())?;
+        let uid_str = uid.to_string();
+        // PEEK: opening an attachment must not flip \Seen on its own.
+        let query = format!("BODY.PEEK[{section}]");
+        let stream = session
+            .uid_fetch(&uid_str, &query)
+            .await
+            .map_err(|e| e.to_string())?;
+        let fetched: Vec<Fetch> = stream.try_collect().await.map_err(|e| e.to_string())?;
+
+        let path = SectionPath::Part(path, None);
+        Ok(fetched
+            .iter()
+            .find(|m| m.uid == Some(uid))
+            .and_then(|m| m.section(&path))
+            .map(|b| b.to_vec()))
     }
 
     async fn fetch_by_message_id_inner(
@@ -501,6 +532,15 @@ impl ImapBackend for RealImap {
         timed!(self, self.fetch_message_inner(folder, uid))
     }
 
+    async fn fetch_part(
+        &mut self,
+        folder: &str,
+        uid: u32,
+        section: &str,
+    ) -> Result<Option<Vec<u8>>, String> {
+        timed!(self, self.fetch_part_inner(folder, uid, section))
+    }
+
     async fn fetch_message_by_message_id(
         &mut self,
         folder: &str,
@@ -715,208 +755,78 @@ impl SmtpBackend for RealSmtp {
 // ---------------------------------------------------------------------------
 
 /// Parse a raw RFC 2822 email (BODY[] response) into an `EmailMessage`.
+///
+/// Only the body candidates are decoded. Attachments are recorded by section
+/// number and decoded size; their bytes are fetched again by
+/// `ImapBackend::fetch_part` if the user opens one.
 fn parse_rfc2822(uid: u32, raw: &[u8]) -> EmailMessage {
-    let text = String::from_utf8_lossy(raw);
+    let (header_block, raw_body) = mime::split_headers(raw);
+    let headers = mime::Headers::parse(header_block);
+    let parts = mime::leaf_parts(&headers, raw_body);
 
-    // Split headers from body at the first blank line.
-    let (header_block, raw_body) = if let Some(pos) = text.find("\r\n\r\n") {
-        (&text[..pos], &text[pos + 4..])
-    } else if let Some(pos) = text.find("\n\n") {
-        (&text[..pos], &text[pos + 2..])
-    } else {
-        (text.as_ref(), "")
-    };
-
-    let mut from = String::new();
-    let mut to = String::new();
-    let mut subject = String::new();
-    let mut date = String::new();
-    let mut message_id = String::new();
-    let mut in_reply_to = String::new();
-    let mut references = String::new();
-    let mut content_type = String::new();
-    let mut content_transfer_encoding = String::new();
-
-    // Header parsing with folded-line support (RFC 2822 §2.2.3).
-    let mut lines = header_block.lines().peekable();
-    while let Some(line) = lines.next() {
-        // Unfold continuation lines (lines starting with whitespace).
-        let mut value = line.to_owned();
-        while lines
-            .peek()
-            .map_or(false, |l| l.starts_with(' ') || l.starts_with('\t'))
-        {
-            if let Some(cont) = lines.next() {
-                value.push(' ');
-                value.push_str(cont.trim());
-            }
-        }
-        let lc = value.to_ascii_lowercase();
-        if lc.starts_with("from: ") {
-            from = value[6..].to_owned();
-        } else if lc.starts_with("to: ") {
-            to = value[4..].to_owned();
-        } else if lc.starts_with("subject: ") {
-            subject = value[9..].to_owned();
-        } else if lc.starts_with("date: ") {
-            date = value[6..].to_owned();
-        } else if lc.starts_with("message-id: ") {
-            message_id = value[12..].to_owned();
-        } else if lc.starts_with("in-reply-to: ") {
-            in_reply_to = value[13..].to_owned();
-        } else if lc.starts_with("references: ") {
-            references = value[12..].to_owned();
-        } else if lc.starts_with("content-type: ") {
-            content_type = value[14..].to_owned();
-        } else if lc.starts_with("content-transfer-encoding: ") {
-            content_transfer_encoding = value[27..].trim().to_ascii_lowercase();
-        }
-    }
-
-    let body = parse_body_part(raw_body, &content_type, &content_transfer_encoding);
-    let attachments = parse_attachments(raw_body, &content_type);
-
-    EmailMessage {
-        uid,
-        from,
-        to,
-        subject,
-        date,
-        body,
-        message_id,
-        in_reply_to,
-        references,
-        attachments,
-    }
-}
-
-/// Walk a MIME body looking for attachment parts (Content-Disposition: attachment
-/// or non-text, non-multipart parts in multipart/mixed).
-fn parse_attachments(raw_body: &str, content_type: &str) -> Vec<EmailAttachment> {
-    let ct_lc = content_type.to_ascii_lowercase();
-    let mime = ct_lc.split(';').next().unwrap_or("").trim();
-    if !mime.starts_with("multipart/") {
-        return vec![];
-    }
-    let boundary = match extract_boundary(content_type) {
-        Some(b) => b,
-        None => return vec![],
-    };
-    let delimiter = format!("--{boundary}");
+    // A single-part message is its own body, whatever its type.
+    let single = !mime::is_multipart(&headers);
     let mut attachments = Vec::new();
-
-    for chunk in raw_body.split(&delimiter) {
-        let chunk = chunk.trim_start_matches('-').trim();
-        if chunk.is_empty() {
+    let mut text: Option<MailBody> = None;
+    let mut ffon: Option<MailBody> = None;
+    for part in &parts {
+        if !single && part.is_attachment() {
+            attachments.push(EmailAttachment {
+                filename: if part.filename.is_empty() {
+                    "attachment".to_owned()
+                } else {
+                    part.filename.clone()
+                },
+                content_type: part.mime(),
+                section: part.section.clone(),
+                encoding: part.encoding.clone(),
+                size: part.decoded_size(),
+            });
             continue;
         }
-
-        let (part_headers, part_body) = if let Some(pos) = chunk.find("\r\n\r\n") {
-            (&chunk[..pos], &chunk[pos + 4..])
-        } else if let Some(pos) = chunk.find("\n\n") {
-            (&chunk[..pos], &chunk[pos + 2..])
-        } else {
+        // Preference order: FFON > text. Once FFON is found the remaining
+        // body candidates are not decoded at all.
+        if ffon.is_some() {
             continue;
-        };
-
-        let mut part_ct = String::new();
-        let mut part_cte = String::new();
-        let mut disposition = String::new();
-        let mut filename = String::new();
-
-        for line in part_headers.lines() {
-            let lc = line.to_ascii_lowercase();
-            if lc.starts_with("content-type: ") {
-                part_ct = line[14..].to_owned();
-            } else if lc.starts_with("content-transfer-encoding: ") {
-                part_cte = line[27..].trim().to_ascii_lowercase();
-            } else if lc.starts_with("content-disposition: ") {
-                disposition = lc[21..].to_owned();
-                // Extract filename= from the same header line.
-                for param in line[21..].split(';') {
-                    let p = param.trim();
-                    let pl = p.to_ascii_lowercase();
-                    if pl.starts_with("filename=") || pl.starts_with("filename*=") {
-                        filename = p
-                            .splitn(2, '=')
-                            .nth(1)
-                            .unwrap_or("")
-                            .trim_matches('"')
-                            .to_owned();
-                    }
-                }
-            }
         }
-
-        let is_attachment = disposition.trim_start().starts_with("attachment");
-        let part_mime = part_ct
-            .split(';')
-            .next()
-            .unwrap_or("")
-            .trim()
-            .to_ascii_lowercase();
-        let is_non_text = !part_mime.is_empty()
-            && !part_mime.starts_with("text/")
-            && !part_mime.starts_with("multipart/");
-
-        if is_attachment || is_non_text {
-            // Decode bytes.
-            let data: Vec<u8> = match part_cte.as_str() {
-                "base64" => {
-                    use base64::Engine as _;
-                    let compact: String =
-                        part_body.chars().filter(|c| !c.is_whitespace()).collect();
-                    base64::engine::general_purpose::STANDARD
-                        .decode(compact.as_bytes())
-                        .unwrap_or_default()
+        match parse_body_part(part) {
+            b @ MailBody::Ffon(_) => ffon = Some(b),
+            b @ MailBody::Text(_) => {
+                if text.is_none() {
+                    text = Some(b);
                 }
-                _ => part_body.as_bytes().to_vec(),
-            };
-            if filename.is_empty() {
-                filename = "attachment".to_owned();
             }
-            attachments.push(EmailAttachment {
-                filename,
-                content_type: part_mime,
-                data,
-            });
         }
     }
-    attachments
-}
-
-/// Parse a MIME body part given its content-type and transfer-encoding headers.
-fn parse_body_part(raw: &str, content_type: &str, cte: &str) -> MailBody {
-    let ct_lc = content_type.to_ascii_lowercase();
-    let mime = ct_lc.split(';').next().unwrap_or("").trim();
 
-    // Handle multipart/* by extracting the best sub-part.
-    if mime.starts_with("multipart/") {
-        if let Some(boundary) = extract_boundary(content_type) {
-            return parse_multipart(raw, &boundary);
-        }
-        return MailBody::Text(raw.to_owned());
+    EmailMessage {
+        uid,
+        from: headers.get("from").to_owned(),
+        to: headers.get("to").to_owned(),
+        subject: headers.get("subject").to_owned(),
+        date: headers.get("date").to_owned(),
+        body: ffon
+            .or(text)
+            .unwrap_or_else(|| MailBody::Text(String::new())),
+        message_id: headers.get("message-id").to_owned(),
+        in_reply_to: headers.get("in-reply-to").to_owned(),
+        references: headers.get("references").to_owned(),
+        attachments,
     }
+}
 
-    let decoded = decode_transfer_encoding(raw, cte);
+/// Decode one body-candidate part into a `MailBody` according to its type.
+fn parse_body_part(part: &mime::Part<'_>) -> MailBody {
+    let decoded = mime::decode_text(part.body, &part.encoding);
 
-    match mime {
+    match part.mime().as_str() {
         "text/html" => {
             let elems = sicompass_sdk::ffon::html_to_ffon(&decoded, "");
             MailBody::Text(crate::flatten_ffon_to_text(&elems))
         }
-        "application/json" => {
-            if let Ok(v) = serde_json::from_str::<serde_json::Value>(&decoded) {
-                if sicompass_sdk::ffon::is_ffon(&v) {
-                    if let Ok(elems) = serde_json::from_value(v) {
-                        return MailBody::Ffon(elems);
-                    }
-                }
-            }
-            MailBody::Text(decoded)
-        }
-        // text/plain or unknown/empty — treat as plain text, but promote to
-        // Ffon if the content is valid FFON JSON (sicompass-sent bodies).
+        // application/json, text/plain or unknown/empty — treat as plain text,
+        // but promote to Ffon if the content is valid FFON JSON
+        // (sicompass-sent bodies).
         _ => {
             if let Ok(v) = serde_json::from_str::<serde_json::Value>(&decoded) {
                 if sicompass_sdk::ffon::is_ffon(&v) {
@@ -930,84 +840,6 @@ fn parse_body_part(raw: &str, content_type: &str, cte: &str) -> MailBody {
     }
 }
 
-/// Decode a transfer-encoded body string.
-fn decode_transfer_encoding(raw: &str, cte: &str) -> String {
-    match cte.trim() {
-        "quoted-printable" => {
-            quoted_printable::decode(raw.as_bytes(), quoted_printable::ParseMode::Robust)
-                .map(|b| String::from_utf8_lossy(&b).into_owned())
-                .unwrap_or_else(|_| raw.to_owned())
-        }
-        "base64" => {
-            use base64::Engine as _;
-            let compact: String = raw.chars().filter(|c| !c.is_whitespace()).collect();
-            base64::engine::general_purpose::STANDARD
-                .decode(compact.as_bytes())
-                .map(|b| String::from_utf8_lossy(&b).into_owned())
-                .unwrap_or_else(|_| raw.to_owned())
-        }
-        _ => raw.to_owned(),
-    }
-}
-
-/// Extract the `boundary=` parameter from a Content-Type value.
-fn extract_boundary(content_type: &str) -> Option<String> {
-    for part in content_type.split(';').skip(1) {
-        let p = part.trim();
-        let lc = p.to_ascii_lowercase();
-        if lc.starts_with("boundary=") {
-            let val = &p[9..].trim_matches('"');
-            return Some(val.to_string());
-        }
-    }
-    None
-}
-
-/// Split a multipart body and return the best available part.
-/// Preference order: FFON (application/json) > HTML > plain text.
-fn parse_multipart(raw: &str, boundary: &str) -> MailBody {
-    let delimiter = format!("--{boundary}");
-    let mut parts: Vec<MailBody> = Vec::new();
-
-    for chunk in raw.split(&delimiter) {
-        let chunk = chunk.trim_start_matches('-').trim();
-        if chunk.is_empty() {
-            continue;
-        }
-
-        // Split chunk into its own headers and body.
-        let (part_headers, part_body) = if let Some(pos) = chunk.find("\r\n\r\n") {
-            (&chunk[..pos], &chunk[pos + 4..])
-        } else if let Some(pos) = chunk.find("\n\n") {
-            (&chunk[..pos], &chunk[pos + 2..])
-        } else {
-            continue;
-        };
-
-        let mut part_ct = String::new();
-        let mut part_cte = String::new();
-        for line in part_headers.lines() {
-            let lc = line.to_ascii_lowercase();
-            if lc.starts_with("content-type: ") {
-                part_ct = line[14..].to_owned();
-            } else if lc.starts_with("content-transfer-encoding: ") {
-                part_cte = line[27..].trim().to_ascii_lowercase();
-            }
-        }
-        parts.push(parse_body_part(part_body, &part_ct, &part_cte));
-    }
-
-    // Pick in preference order: Ffon > Text.
-    let ffon = parts.iter().find(|p| matches!(p, MailBody::Ffon(_)));
-    if let Some(f) = ffon {
-        return f.clone();
-    }
-    parts
-        .into_iter()
-        .find(|p| matches!(p, MailBody::Text(_)))
-        .unwrap_or_else(|| MailBody::Text(String::new()))
-}
-
 /// Format an IMAP address struct as "Name <mailbox@host>" or "mailbox@host".
 /// Convert a single IMAP FETCH result into a `MessageHeader`, or `None` if
 /// the fetch result is missing UID or ENVELOPE data.
@@ -386,6 +386,8 @@ fn dispatch(
     } else if upper.starts_with("UID FETCH") || upper.starts_with("FETCH") {
         if upper.contains("BODY[]") {
             fetch_body(w, tag, rest);
+        } else if upper.contains("BODY.PEEK[2]") {
+            fetch_section(w, tag, rest);
         } else {
             send(
                 w,
@@ -455,6 +457,27 @@ fn fetch_body(w: &mut TcpStream, tag: &str, rest: &str) {
     send(w, &format!("{tag} OK FETCH completed\r\n"));
 }
 
+/// `UID FETCH <uid> BODY.PEEK[2]` — the attachment part of UID 2, still
+/// base64-encoded, answered as `BODY[2]` the way real servers do.
+fn fetch_section(w: &mut TcpStream, tag: &str, rest: &str) {
+    let uid: u32 = rest
+        .split_whitespace()
+        .nth(2)
+        .and_then(|s| s.parse().ok())
+        .unwrap_or(0);
+
+    if uid == 2 {
+        let part = "aGVsbG8sIHdvcmxk";
+        send(
+            w,
+            &format!("* 2 FETCH (UID 2 BODY[2] {{{}}}\r\n", part.len()),
+        );
+        send(w, part);
+        send(w, ")\r\n");
+    }
+    send(w, &format!("{tag} OK FETCH completed\r\n"));
+}
+
 /// `APPEND <folder> {<len>}` — continuation, then the literal, then OK.
 fn append(
     w: &mut TcpStream,
@@ -687,9 +710,12 @@ async fn fetch_message_parses_literal_body_and_attachment() {
 
     let att = msg.attachments.first().expect("one attachment");
     assert_eq!(att.filename, "notes.txt");
+    assert_eq!(att.section, "2");
+    assert_eq!(att.encoding, "base64");
     assert_eq!(
-        att.data, b"hello, world",
-        "base64 attachment must be decoded"
+        att.size,
+        b"hello, world".len(),
+        "size must be the decoded size, known without decoding"
     );
 
     let fetch = server.expect_command("BODY[]");
@@ -699,6 +725,29 @@ async fn fetch_message_parses_literal_body_and_attachment() {
     );
 }
 
+#[tokio::test]
+async fn fetch_part_peeks_a_single_section() {
+    let server = FakeImap::start(Options::default());
+    let mut imap = RealImap::from_config(&server.config(&unique_user("part")));
+
+    let raw = imap
+        .fetch_part("INBOX", 2, "2")
+        .await
+        .expect("fetch_part")
+        .expect("section 2 exists");
+
+    assert_eq!(
+        raw, b"aGVsbG8sIHdvcmxk",
+        "the part comes back still encoded"
+    );
+    let fetch = server.expect_command("BODY.PEEK[2]");
+    assert!(
+        fetch.contains("UID FETCH 2"),
+        "must fetch by UID, not sequence: {fetch}"
+    );
+    server.assert_no_command("BODY[]");
+}
+
 #[tokio::test]
 async fn fetch_message_returns_none_for_unknown_uid() {
     let server = FakeImap::start(Options::default());
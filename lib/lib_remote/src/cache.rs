@@ -0,0 +1,253 @@
+//! Remote responses kept on disk, so a level read once opens at once in the
+//! next session too, and revisiting it only asks the server whether it changed.
+//!
+//! What is kept is the page as parsed — elements and the cursor of the page
+//! after it, in the binary FFON of [`crate::wire`] — with the validators (ETag / Last-Modified)
+//! and the freshness lifetime the response carried. `Cache-Control: max-age`
+//! sets that lifetime, `no-cache` makes it zero, and `no-store` keeps the
+//! response off the disk altogether; a response that says nothing is fresh for
+//! [`DEFAULT_FRESH_SECS`].
+//!
+//! Keyed by URL and by a fingerprint of the API key it was fetched with: two
+//! keys can see two different trees behind the same URL.
+//!
+//! Only the fetch worker touches this, so it needs no lock of its own.
+//!
+//! DB location: platform cache dir + `/sicompass/remote/responses.db`.
+
+use rusqlite::{Connection, OptionalExtension, params};
+use std::hash::{DefaultHasher, Hash, Hasher};
+use std::path::{Path, PathBuf};
+
+use crate::fetcher::Page;
+use crate::wire;
+
+/// Lifetime of a response that sets none.
+pub(crate) const DEFAULT_FRESH_SECS: u64 = 60;
+
+/// Responses kept on disk; the least recently stored go first.
+const DISK_RESPONSES: i64 = 2000;
+
+/// URL plus API-key fingerprint.
+pub(crate) type Key = (String, i64);
+
+pub(crate) fn key(url: &str, api_key: &str) -> Key {
+    let mut hasher = DefaultHasher::new();
+    api_key.hash(&mut hasher);
+    (url.to_owned(), hasher.finish() as i64)
+}
+
+/// A response's cache validators, as its server sent them.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub(crate) struct Validators {
+    pub etag: Option<String>,
+    pub last_modified: Option<String>,
+}
+
+impl Validators {
+    pub fn is_empty(&self) -> bool {
+        self.etag.is_none() && self.last_modified.is_none()
+    }
+}
+
+/// How long a response may be used without asking, and whether it may be
+/// written to disk at all, from its `Cache-Control` header.
+pub(crate) fn freshness(cache_control: Option<&str>) -> (u64, bool) {
+    let mut fresh_secs = DEFAULT_FRESH_SECS;
+    let mut storable = true;
+    for directive in cache_control.unwrap_or("").split(',') {
+        let directive = directive.trim().to_ascii_lowercase();
+        if directive == "no-store" {
+            storable = false;
+            fresh_secs = 0;
+        } else if directive == "no-cache" {
+            fresh_secs = 0;
+        } else if let Some(secs) = directive.strip_prefix("max-age=")
+            && let Ok(secs) = secs.trim_matches('"').parse()
+            && storable
+        {
+            fresh_secs = secs;
+        }
+    }
+    (fresh_secs, storable)
+}
+
+#[derive(Debug, Clone)]
+pub(crate) struct Entry {
+    pub page: Page,
+    pub validators: Validators,
+    /// Unix seconds the response was stored or last revalidated.
+    pub stored_at: u64,
+    pub fresh_secs: u64,
+}
+
+impl Entry {
+    pub fn fresh_until(&self) -> u64 {
+        self.stored_at.saturating_add(self.fresh_secs)
+    }
+}
+
+pub(crate) struct ResponseStore {
+    conn: Connection,
+}
+
+impl ResponseStore {
+    /// Open (or create) the store at `path`.
+    ///
+    /// Returns `None` if the directory cannot be created or the DB cannot be
+    /// opened — responses are then revalidated from memory only.
+    pub fn open(path: &Path) -> Option<Self> {
+        if let Some(parent) = path.parent() {
+            std::fs::create_dir_all(parent).ok()?;
+        }
+        let conn = Connection::open(path).ok()?;
+        let store = ResponseStore { conn };
+        store.init_schema().ok()?;
+        Some(store)
+    }
+
+    fn init_schema(&self) -> rusqlite::Result<()> {
+        self.conn.execute_batch(
+            "CREATE TABLE IF NOT EXISTS responses (
+                url           TEXT    NOT NULL,
+                auth          INTEGER NOT NULL,
+                etag          TEXT,
+                last_modified TEXT,
+                stored_at     INTEGER NOT NULL,
+                fresh_secs    INTEGER NOT NULL,
+                tree          BLOB    NOT NULL,
+                PRIMARY KEY (url, auth)
+            );
+            CREATE INDEX IF NOT EXISTS responses_stored_at ON responses(stored_at);",
+        )
+    }
+
+    /// The entry for `key`; one that no longer decodes is as good as none.
+    pub fn load(&self, key: &Key) -> Option<Entry> {
+        let (validators, stored_at, fresh_secs, tree) = self
+            .conn
+            .query_row(
+                "SELECT etag, last_modified, stored_at, fresh_secs, tree FROM responses
+                 WHERE url = ?1 AND auth = ?2",
+                params![key.0, key.1],
+                |row| {
+                    Ok((
+                        Validators {
+                            etag: row.get(0)?,
+                            last_modified: row.get(1)?,
+                        },
+                        row.get::<_, i64>(2)? as u64,
+                        row.get::<_, i64>(3)? as u64,
+                        row.get::<_, Vec<u8>>(4)?,
+                    ))
+                },
+            )
+            .optional()
+            .ok()
+            .flatten()?;
+        Some(Entry {
+            page: wire::decode(&tree[..]).ok()?,
+            validators,
+            stored_at,
+            fresh_secs,
+        })
+    }
+
+    /// Write `entry`, then drop whatever falls past [`DISK_RESPONSES`].
+    pub fn save(&self, key: &Key, entry: &Entry) {
+        let _ = self.conn.execute(
+            "INSERT OR REPLACE INTO responses
+                 (url, auth, etag, last_modified, stored_at, fresh_secs, tree)
+             VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)",
+            params![
+                key.0,
+                key.1,
+                entry.validators.etag,
+                entry.validators.last_modified,
+                entry.stored_at as i64,
+                entry.fresh_secs as i64,
+                wire::encode(&entry.page),
+            ],
+        );
+        let _ = self.conn.execute(
+            "DELETE FROM responses WHERE rowid NOT IN
+                 (SELECT rowid FROM responses ORDER BY stored_at DESC LIMIT ?1)",
+            params![DISK_RESPONSES],
+        );
+    }
+
+    /// The server confirmed the stored copy at `now`; it is good for another
+    /// `fresh_secs`.
+    pub fn touch(&self, key: &Key, now: u64, fresh_secs: u64) {
+        let _ = self.conn.execute(
+            "UPDATE responses SET stored_at = ?3, fresh_secs = ?4 WHERE url = ?1 AND auth = ?2",
+            params![key.0, key.1, now as i64, fresh_secs as i64],
+        );
+    }
+}
+
+/// Where the store lives, or `None` under test or without a cache dir.
+pub(crate) fn store_path() -> Option<PathBuf> {
+    if cfg!(test) {
+        return None;
+    }
+    sicompass_sdk::platform::cache_home()
+        .map(|c| c.join("sicompass").join("remote").join("responses.db"))
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use sicompass_sdk::ffon::FfonElement;
+
+    #[test]
+    fn cache_control_sets_the_lifetime_and_the_storability() {
+        assert_eq!(freshness(None), (DEFAULT_FRESH_SECS, true));
+        assert_eq!(freshness(Some("public, max-age=300")), (300, true));
+        assert_eq!(freshness(Some("Max-Age=\"30\"")), (30, true));
+        assert_eq!(freshness(Some("no-cache")), (0, true));
+        assert_eq!(freshness(Some("max-age=300, no-store")), (0, false));
+        assert_eq!(freshness(Some("no-store, max-age=300")), (0, false));
+        assert_eq!(freshness(Some("max-age=soon")), (DEFAULT_FRESH_SECS, true));
+    }
+
+    #[test]
+    fn a_saved_response_loads_back_per_url_and_key() {
+        let dir = tempfile::tempdir().unwrap();
+        let store = ResponseStore::open(&dir.path().join("responses.db")).unwrap();
+        let entry = Entry {
+            page: Page {
+                elements: vec![FfonElement::new_str("a"), FfonElement::new_obj("b")],
+                next: Some("c2".to_owned()),
+                lazy: vec![1],
+                legacy: false,
+            },
+            validators: Validators {
+                etag: Some("\"v1\"".to_owned()),
+                last_modified: None,
+            },
+            stored_at: 1_000,
+            fresh_secs: 60,
+        };
+        let k = key("https://example.com/root", "secret");
+        store.save(&k, &entry);
+
+        let back = store.load(&k).expect("stored");
+        assert_eq!(back.page, entry.page);
+        assert_eq!(back.validators, entry.validators);
+        assert_eq!(back.fresh_until(), 1_060);
+        // Another key does not see it.
+        assert!(
+            store
+                .load(&key("https://example.com/root", "other"))
+                .is_none()
+        );
+
+        store.touch(&k, 2_000, 10);
+        assert_eq!(store.load(&k).unwrap().fresh_until(), 2_010);
+    }
+}
@@ -0,0 +1,592 @@
+//! The remote provider's HTTP, off the UI thread.
+//!
+//! One worker thread per provider. It builds the one `reqwest` client it will
+//! ever use, so connections (and their TLS sessions) are kept alive from one
+//! level to the next, and it owns the response cache. The provider hands it a
+//! [`Job`] per page it wants and reads [`Reply`]s back from `tick()`; nothing
+//! on the UI thread waits on the network, on the disk, or on a JSON parse.
+//!
+//! A page the disk has is sent back at once, whether or not it is still fresh.
+//! A stale one is then revalidated with a conditional GET, and the reply that
+//! follows says either that the copy stands or what replaced it — the
+//! provider shows the stale copy meanwhile.
+//!
+//! ## Wire format
+//!
+//! A level is `GET {remoteUrl}/root` for the top and
+//! `GET {remoteUrl}/{segment}/{segment}…` below it, each segment
+//! percent-encoded. A server that speaks binary FFON answers in it ([`wire`]);
+//! otherwise the body is either the level's elements as a JSON array, or one
+//! page of them:
+//!
+//! ```json
+//! { "items": [ ... ], "next": "opaque-cursor" }
+//! ```
+//!
+//! in which case the page after it is the same URL with `?cursor=` and the
+//! cursor. No `next` (or `null`) ends the level.
+//!
+//! An object with an empty array (or `null`) as its value is a sub-level the
+//! server has not sent: it is shown as an empty object, and fetched from its
+//! own path when entered. An object with children is taken as sent.
+//!
+//! A server that can tell an empty sub-level from an unsent one says so with
+//! the indices of the unsent ones:
+//!
+//! ```json
+//! { "items": [ {"Products": []}, {"Archive": []} ], "lazy": [0] }
+//! ```
+//!
+//! With `lazy` present only the objects it lists are fetched when entered;
+//! every other object, an empty one included, is taken as sent. Binary FFON
+//! marks them the same way ([`wire`]).
+
+use sicompass_sdk::ffon::{FfonElement, parse_json_value};
+use std::collections::HashMap;
+use std::path::PathBuf;
+use std::sync::mpsc::{self, Receiver, Sender};
+
+use crate::cache::{self, Entry, Key, ResponseStore, Validators};
+use crate::wire;
+
+/// Binary FFON first, JSON for servers that only have that.
+const ACCEPTED: &str = "application/x-ffon, application/json;q=0.9";
+
+/// How long one request may take.
+const TIMEOUT_SECS: u64 = 15;
+
+/// One page of a level, as the server sent it.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub(crate) struct Page {
+    pub elements: Vec<FfonElement>,
+    /// Cursor of the page after this one.
+    pub next: Option<String>,
+    /// Indices, ascending, of the objects in `elements` whose children the
+    /// server has not sent.
+    pub lazy: Vec<usize>,
+    /// The server tells an unsent sub-level only by its being empty (JSON
+    /// without `lazy`, binary FFON version 1), so an empty object at any
+    /// depth is fetched when entered.
+    pub legacy: bool,
+}
+
+/// A page wanted.
+pub(crate) struct Job {
+    pub url: String,
+    pub api_key: String,
+    /// The provider holds this page already and only wants to know whether
+    /// it changed, so a stored copy is not sent back.
+    pub held: bool,
+}
+
+#[derive(Debug)]
+pub(crate) enum Outcome {
+    /// The stored copy. `revalidating` says a second reply follows.
+    Stored {
+        page: Page,
+        fresh_until: u64,
+        revalidating: bool,
+    },
+    /// A new page from the server.
+    Fetched {
+        page: Page,
+        fresh_until: u64,
+    },
+    /// The server says the copy already sent or held is current.
+    Unchanged {
+        fresh_until: u64,
+    },
+    Failed(String),
+}
+
+#[derive(Debug)]
+pub(crate) struct Reply {
+    pub url: String,
+    pub outcome: Outcome,
+}
+
+/// The worker, as the provider sees it. Dropping it lets the thread finish
+/// the request it is on and exit.
+pub(crate) struct Fetcher {
+    jobs: Sender<Job>,
+    replies: Receiver<Reply>,
+}
+
+impl Fetcher {
+    /// Start the worker. `store` is opened on the worker, not here; `None`
+    /// keeps responses in memory only.
+    pub fn spawn(store: Option<PathBuf>) -> Self {
+        let (jobs, job_rx) = mpsc::channel::<Job>();
+        let (reply_tx, replies) = mpsc::channel();
+        let _ = std::thread::Builder::new()
+            .name("sicompass-remote-fetch".to_owned())
+            .spawn(move || {
+                let mut worker = Worker::new(store.and_then(|p| ResponseStore::open(&p)));
+                for job in job_rx {
+                    let url = job.url.clone();
+                    let sent = worker.serve(job, |outcome| {
+                        reply_tx
+                            .send(Reply {
+                                url: url.clone(),
+                                outcome,
+                            })
+                            .is_ok()
+                    });
+                    if !sent {
+                        return;
+                    }
+                }
+            });
+        Fetcher { jobs, replies }
+    }
+
+    pub fn request(&self, job: Job) {
+        let _ = self.jobs.send(job);
+    }
+
+    /// Replies that have arrived, without waiting for more.
+    pub fn replies(&self) -> Vec<Reply> {
+        self.replies.try_iter().collect()
+    }
+}
+
+pub(crate) fn now_secs() -> u64 {
+    std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0)
+}
+
+/// What the server answered.
+enum Answer {
+    NotModified { fresh_secs: u64 },
+    Page(Entry, bool),
+}
+
+struct Worker {
+    client: Option<reqwest::blocking::Client>,
+    store: Option<ResponseStore>,
+    /// Validators of responses not written to disk, so a held page can still
+    /// be revalidated without one.
+    known: HashMap<Key, Validators>,
+}
+
+impl Worker {
+    fn new(store: Option<ResponseStore>) -> Self {
+        let client = reqwest::blocking::Client::builder()
+            .timeout(std::time::Duration::from_secs(TIMEOUT_SECS))
+            .build()
+            .ok();
+        Worker {
+            client,
+            store,
+            known: HashMap::new(),
+        }
+    }
+
+    /// Answer `job`, passing each outcome to `send`. Returns `false` once
+    /// `send` does, i.e. once the provider is gone.
+    fn serve(&mut self, job: Job, mut send: impl FnMut(Outcome) -> bool) -> bool {
+        let key = cache::key(&job.url, &job.api_key);
+        let now = now_secs();
+        let stored = self.store.as_ref().and_then(|s| s.load(&key));
+
+        if let Some(entry) = &stored
+            && !job.held
+        {
+            let fresh = now < entry.fresh_until();
+            if !send(Outcome::Stored {
+                page: entry.page.clone(),
+                fresh_until: entry.fresh_until(),
+                revalidating: !fresh,
+            }) {
+                return false;
+            }
+            if fresh {
+                return true;
+            }
+        }
+
+        // Conditional only when there is a copy for a 304 to vouch for.
+        let validators = if job.held || stored.is_some() {
+            stored
+                .as_ref()
+                .map(|e| e.validators.clone())
+                .or_else(|| self.known.get(&key).cloned())
+                .unwrap_or_default()
+        } else {
+            Validators::default()
+        };
+
+        let outcome = match self.get(&job, &validators, now) {
+            Ok(Answer::NotModified { fresh_secs }) => {
+                if let Some(store) = &self.store {
+                    store.touch(&key, now, fresh_secs);
+                }
+                Outcome::Unchanged {
+                    fresh_until: now.saturating_add(fresh_secs),
+                }
+            }
+            Ok(Answer::Page(entry, storable)) => {
+                let fresh_until = entry.fresh_until();
+                if storable && let Some(store) = &self.store {
+                    store.save(&key, &entry);
+                }
+                self.known.insert(key, entry.validators);
+                Outcome::Fetched {
+                    page: entry.page,
+                    fresh_until,
+                }
+            }
+            Err(msg) => Outcome::Failed(msg),
+        };
+        send(outcome)
+    }
+
+    /// GET `job.url`, conditional on `validators` when there are any.
+    fn get(&self, job: &Job, validators: &Validators, now: u64) -> Result<Answer, String> {
+        use reqwest::header::{
+            ACCEPT, AUTHORIZATION, CACHE_CONTROL, CONTENT_TYPE, ETAG, IF_MODIFIED_SINCE,
+            IF_NONE_MATCH, LAST_MODIFIED,
+        };
+        let Some(client) = &self.client else {
+            return Err("Error building HTTP client".to_owned());
+        };
+        let mut req = client.get(&job.url).header(ACCEPT, ACCEPTED);
+        if !job.api_key.is_empty() {
+            req = req.header(AUTHORIZATION, format!("Bearer {}", job.api_key));
+        }
+        if let Some(etag) = &validators.etag {
+            req = req.header(IF_NONE_MATCH, etag);
+        }
+        if let Some(last_modified) = &validators.last_modified {
+            req = req.header(IF_MODIFIED_SINCE, last_modified);
+        }
+        let response = req
+            .send()
+            .map_err(|e| format!("Error connecting to {}: {e}", job.url))?;
+
+        let header = |name| {
+            response
+                .headers()
+                .get(name)
+                .and_then(|v| v.to_str().ok())
+                .map(str::to_owned)
+        };
+        let (fresh_secs, storable) = cache::freshness(header(CACHE_CONTROL).as_deref());
+        let status = response.status();
+        if status == reqwest::StatusCode::NOT_MODIFIED && !validators.is_empty() {
+            return Ok(Answer::NotModified { fresh_secs });
+        }
+        if !status.is_success() {
+            return Err(format!(
+                "Failed to fetch from {}: {} {}",
+                job.url,
+                status.as_u16(),
+                status.canonical_reason().unwrap_or("")
+            ));
+        }
+        let validators = Validators {
+            etag: header(ETAG),
+            last_modified: header(LAST_MODIFIED),
+        };
+        let binary = header(CONTENT_TYPE).is_some_and(|t| t.starts_with(wire::CONTENT_TYPE));
+        let page = if binary {
+            // Decoded as it arrives, no body buffered first.
+            wire::decode(response)
+        } else {
+            let body = response
+                .bytes()
+                .map_err(|e| format!("Error reading response from {}: {e}", job.url))?;
+            parse_page(&body)
+        };
+        let page = page.map_err(|e| format!("{e} from {}", job.url))?;
+        Ok(Answer::Page(
+            Entry {
+                page,
+                validators,
+                stored_at: now,
+                fresh_secs,
+            },
+            storable,
+        ))
+    }
+}
+
+/// A response body as a [`Page`]: a bare array, or `{"items", "next",
+/// "lazy"}`.
+pub(crate) fn parse_page(body: &[u8]) -> Result<Page, String> {
+    let value: serde_json::Value =
+        serde_json::from_slice(body).map_err(|e| format!("Invalid JSON ({e})"))?;
+    let (items, next, marked) = match value {
+        serde_json::Value::Array(items) => (items, None, None),
+        serde_json::Value::Object(mut map) => {
+            let Some(serde_json::Value::Array(items)) = map.remove("items") else {
+                return Err("Invalid response".to_owned());
+            };
+            let next = match map.remove("next") {
+                Some(serde_json::Value::String(cursor)) if !cursor.is_empty() => Some(cursor),
+                _ => None,
+            };
+            let marked = match map.remove("lazy") {
+                Some(serde_json::Value::Array(indices)) => Some(
+                    indices
+                        .iter()
+                        .map(|i| i.as_u64().map(|i| i as usize))
+                        .collect::<Option<Vec<_>>>()
+                        .ok_or("Invalid response")?,
+                ),
+                _ => None,
+            };
+            (items, next, marked)
+        }
+        _ => return Err("Invalid response".to_owned()),
+    };
+    let mut lazy = Vec::new();
+    let elements = items
+        .iter()
+        .enumerate()
+        .map(|(i, item)| {
+            let unsent = match &marked {
+                Some(marked) => marked
+                    .contains(&i)
+                    .then(|| unsent_key(item, true))
+                    .flatten(),
+                None => unsent_key(item, false),
+            };
+            match unsent {
+                Some(key) => {
+                    lazy.push(i);
+                    FfonElement::new_obj(key)
+                }
+                None => parse_json_value(item),
+            }
+        })
+        .collect();
+    Ok(Page {
+        elements,
+        next,
+        lazy,
+        legacy: marked.is_none(),
+    })
+}
+
+/// The key of `v` if it is a sub-level the server has not sent, which the
+/// app descends into by asking the provider for its path: one the server
+/// `marked` as such, or else one whose value is an empty array or `null`.
+/// An object the server already gave a `<link>` is always taken as sent.
+fn unsent_key(v: &serde_json::Value, marked: bool) -> Option<&str> {
+    if let serde_json::Value::Object(map) = v
+        && map.len() == 1
+        && let Some((key, children)) = map.iter().next()
+        && !key.contains("<link>")
+        && (marked
+            || match children {
+                serde_json::Value::Array(a) => a.is_empty(),
+                serde_json::Value::Null => true,
+                _ => false,
+            })
+    {
+        return Some(key);
+    }
+    None
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use wiremock::matchers::{header, method, path};
+    use wiremock::{Mock, MockServer, ResponseTemplate};
+
+    #[test]
+    fn a_page_is_a_bare_array_or_items_with_a_cursor() {
+        let page = parse_page(br#"["a", {"Sub": []}, {"Inline": ["x"]}]"#).unwrap();
+        assert_eq!(page.next, None);
+        assert_eq!(page.elements[0], FfonElement::new_str("a"));
+        assert_eq!(page.elements[1], FfonElement::new_obj("Sub"));
+        assert_eq!(
+            page.elements[2].as_obj().map(|o| o.children.len()),
+            Some(1),
+            "children the server sent are kept"
+        );
+        assert_eq!(page.lazy, vec![1]);
+
+        let page = parse_page(br#"{"items": ["a"], "next": "c2"}"#).unwrap();
+        assert_eq!(page.elements, vec![FfonElement::new_str("a")]);
+        assert_eq!(page.next.as_deref(), Some("c2"));
+        let last = parse_page(br#"{"items": [], "next": null}"#).unwrap();
+        assert_eq!(last.next, None);
+
+        assert!(parse_page(br#"{"rows": []}"#).is_err());
+        assert!(parse_page(b"42").is_err());
+        assert!(parse_page(b"not json").is_err());
+    }
+
+    #[test]
+    fn a_server_may_list_its_unsent_levels() {
+        let page = parse_page(
+            br#"{"items": [{"Sub": []}, {"Empty": []}, {"Null": null}, {"Inline": ["x"]}, {"Marked": ["x"]}],
+                 "lazy": [0, 4]}"#,
+        )
+        .unwrap();
+        assert_eq!(page.lazy, vec![0, 4], "only the listed ones are fetched");
+        assert_eq!(page.elements[1], FfonElement::new_obj("Empty"));
+        assert_eq!(page.elements[4], FfonElement::new_obj("Marked"));
+        assert_eq!(page.elements[3].as_obj().map(|o| o.children.len()), Some(1));
+
+        assert!(parse_page(br#"{"items": [], "lazy": ["0"]}"#).is_err());
+    }
+
+    /// Serve `job` on a worker of its own and collect what it sends.
+    fn serve(worker: &mut Worker, url: &str, held: bool) -> Vec<Outcome> {
+        let mut out = Vec::new();
+        worker.serve(
+            Job {
+                url: url.to_owned(),
+                api_key: String::new(),
+                held,
+            },
+            |o| {
+                out.push(o);
+                true
+            },
+        );
+        out
+    }
+
+    #[test]
+    fn a_stored_response_is_sent_at_once_and_then_revalidated() {
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        let server = rt.block_on(MockServer::start());
+        rt.block_on(
+            Mock::given(method("GET"))
+                .and(path("/root"))
+                .and(header("If-None-Match", "\"v1\""))
+                .respond_with(ResponseTemplate::new(304))
+                .with_priority(1)
+                .mount(&server),
+        );
+        rt.block_on(
+            Mock::given(method("GET"))
+                .and(path("/root"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .insert_header("ETag", "\"v1\"")
+                        .insert_header("Cache-Control", "max-age=0")
+                        .set_body_json(serde_json::json!(["item"])),
+                )
+                .with_priority(2)
+                .mount(&server),
+        );
+        let url = format!("{}/root", server.uri());
+        let dir = tempfile::tempdir().unwrap();
+        let db = dir.path().join("responses.db");
+
+        // First session: nothing stored, one plain GET.
+        let mut worker = Worker::new(ResponseStore::open(&db));
+        let out = serve(&mut worker, &url, false);
+        assert!(
+            matches!(&out[..], [Outcome::Fetched { page, .. }] if page.elements.len() == 1),
+            "got: {out:?}"
+        );
+
+        // Next session: the stored copy comes back first, stale, and the
+        // conditional GET that follows confirms it.
+        let mut worker = Worker::new(ResponseStore::open(&db));
+        let out = serve(&mut worker, &url, false);
+        assert!(
+            matches!(
+                &out[..],
+                [
+                    Outcome::Stored {
+                        revalidating: true,
+                        ..
+                    },
+                    Outcome::Unchanged { .. }
+                ]
+            ),
+            "got: {out:?}"
+        );
+
+        // A page the provider holds is only revalidated.
+        let out = serve(&mut worker, &url, true);
+        assert!(
+            matches!(&out[..], [Outcome::Unchanged { .. }]),
+            "got: {out:?}"
+        );
+    }
+
+    #[test]
+    fn binary_ffon_is_asked_for_and_decoded() {
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        let server = rt.block_on(MockServer::start());
+        let sent = Page {
+            elements: vec![FfonElement::new_str("a"), FfonElement::new_obj("Sub")],
+            next: Some("c2".to_owned()),
+            lazy: vec![1],
+            legacy: false,
+        };
+        rt.block_on(
+            Mock::given(method("GET"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .set_body_raw(wire::encode(&sent), "application/x-ffon; v=2"),
+                )
+                .mount(&server),
+        );
+        let out = serve(
+            &mut Worker::new(None),
+            &format!("{}/root", server.uri()),
+            false,
+        );
+        assert!(
+            matches!(&out[..], [Outcome::Fetched { page, .. }] if *page == sent),
+            "got: {out:?}"
+        );
+        let requests = rt.block_on(server.received_requests()).unwrap();
+        assert_eq!(
+            requests[0]
+                .headers
+                .get("accept")
+                .and_then(|v| v.to_str().ok()),
+            Some(ACCEPTED)
+        );
+    }
+
+    #[test]
+    fn a_held_page_revalidates_without_a_disk() {
+        let rt = tokio::runtime::Runtime::new().unwrap();
+        let server = rt.block_on(MockServer::start());
+        rt.block_on(
+            Mock::given(method("GET"))
+                .and(header("If-None-Match", "\"v1\""))
+                .respond_with(ResponseTemplate::new(304))
+                .with_priority(1)
+                .mount(&server),
+        );
+        rt.block_on(
+            Mock::given(method("GET"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .insert_header("ETag", "\"v1\"")
+                        .set_body_json(serde_json::json!(["item"])),
+                )
+                .with_priority(2)
+                .mount(&server),
+        );
+        let url = format!("{}/root", server.uri());
+        let mut worker = Worker::new(None);
+        assert!(matches!(
+            &serve(&mut worker, &url, false)[..],
+            [Outcome::Fetched { .. }]
+        ));
+        assert!(matches!(
+            &serve(&mut worker, &url, true)[..],
+            [Outcome::Unchanged { .. }]
+        ));
+    }
+}
@@ -1,10 +1,17 @@
 //! Remote FFON provider — Rust port of `lib/lib_remote/remote.ts`.
 //!
 //! Fetches a JSON FFON tree from a remote HTTP server and exposes it as a
-//! sicompass provider. Each top-level object in the server response is wrapped
-//! with a `<link>` tag so the main app's existing link-navigation handles
-//! sub-navigation (no per-path fetching is needed here, matching the TS script
-//! behaviour).
+//! sicompass provider, one level at a time: the top level is `{remoteUrl}/root`
+//! and every level below it is fetched from its own path when it is entered
+//! (see [`fetcher`] for the wire format and pagination). Children the server
+//! sends inline are served from the level that carried them, without a request.
+//!
+//! Requests run on a worker thread, so `fetch()` never blocks: a level not yet
+//! here shows "Loading…" and `tick()` reports when it arrives. Levels are kept
+//! in memory for the session and on disk across sessions ([`cache`]); a copy
+//! past its freshness lifetime is shown as it is while a conditional GET asks
+//! the server whether it changed. Servers that can are asked for binary FFON
+//! rather than JSON ([`wire`]).
 //!
 //! ## Settings keys consumed via `on_setting_change`
 //!
@@ -22,21 +29,83 @@
 //! }
 //! ```
 
-use sicompass_sdk::ffon::{FfonElement, parse_json_value};
+mod cache;
+mod fetcher;
+mod wire;
+
+use sicompass_sdk::ffon::FfonElement;
 use sicompass_sdk::provider::Provider;
+use sicompass_sdk::tags;
+use std::collections::HashMap;
+
+use fetcher::{Fetcher, Job, Outcome, Page};
+
+/// How long a level whose fetch failed waits before it is asked for again,
+/// and how soon a page just received may be revalidated.
+const RETRY_SECS: u64 = 5;
+
+/// The button that fetches a level's next page.
+const LOAD_MORE: &str = "load-more";
 
 // ---------------------------------------------------------------------------
 // RemoteProvider
 // ---------------------------------------------------------------------------
 
+/// A page held, and until when it may be shown without asking the server.
+struct Loaded {
+    page: Page,
+    fresh_until: u64,
+}
+
+/// One path's pages, in order.
+#[derive(Default)]
+struct Level {
+    pages: Vec<Loaded>,
+    /// Why the first page could not be fetched, and when to try again.
+    failed: Option<(String, u64)>,
+}
+
+impl Level {
+    /// Put page `idx` in place. Returns whether what the level shows changed.
+    fn place(&mut self, idx: usize, page: Page, fresh_until: u64) -> bool {
+        self.failed = None;
+        if let Some(held) = self.pages.get_mut(idx) {
+            held.fresh_until = fresh_until;
+            if held.page == page {
+                return false;
+            }
+            // A new cursor invalidates the pages fetched with the old one.
+            let next_changed = held.page.next != page.next;
+            held.page = page;
+            if next_changed {
+                self.pages.truncate(idx + 1);
+            }
+            true
+        } else if idx == self.pages.len() {
+            self.pages.push(Loaded { page, fresh_until });
+            true
+        } else {
+            false
+        }
+    }
+}
+
 pub struct RemoteProvider {
     /// Provider name — also used as the settings section name.
     name: String,
     remote_url: String,
     api_key: String,
     current_path: String,
-    /// Cached root fetch (cleared when remoteUrl changes).
-    cached_root: Option<Vec<FfonElement>>,
+    /// Levels fetched this session, by path (cleared when a setting changes).
+    levels: HashMap<String, Level>,
+    /// Requests on the worker: URL → (path, page index).
+    inflight: HashMap<String, (String, usize)>,
+    /// Started by the first request.
+    fetcher: Option<Fetcher>,
+    error: Option<String>,
+    /// The last reply was a failure. The outage has been reported; it is not
+    /// again until a reply gets through.
+    offline: bool,
 }
 
 impl RemoteProvider {
@@ -50,112 +119,164 @@ impl RemoteProvider {
             remote_url,
             api_key,
             current_path: "/".to_owned(),
-            cached_root: None,
+            levels: HashMap::new(),
+            inflight: HashMap::new(),
+            fetcher: None,
+            error: None,
+            offline: false,
         }
     }
 
-    /// Perform a blocking GET request and return the parsed FFON elements.
-    fn fetch_from_server(&self) -> Vec<FfonElement> {
-        if self.remote_url.is_empty() {
-            return vec![FfonElement::new_str(format!(
-                "No remote URL configured for \"{}\"",
-                self.name
-            ))];
+    /// URL of the first page of `path`'s level.
+    fn level_url(&self, path: &str) -> String {
+        let base = self.remote_url.trim_end_matches('/');
+        if path == "/" {
+            return format!("{base}/root");
         }
+        let mut url = base.to_owned();
+        for segment in path.split('/').filter(|s| !s.is_empty()) {
+            url.push('/');
+            url.push_str(&url_encode(segment));
+        }
+        url
+    }
 
-        let root_url = format!("{}/root", self.remote_url.trim_end_matches('/'));
-
-        let client = match reqwest::blocking::Client::builder()
-            .timeout(std::time::Duration::from_secs(15))
-            .build()
-        {
-            Ok(c) => c,
-            Err(e) => {
-                return vec![FfonElement::new_str(format!(
-                    "Error building HTTP client: {e}"
-                ))];
-            }
-        };
-
-        let mut req = client.get(&root_url).header("Accept", "application/json");
-        if !self.api_key.is_empty() {
-            req = req.header("Authorization", format!("Bearer {}", self.api_key));
+    /// URL of page `idx` of `path`, if the page before it has a cursor.
+    fn page_url(&self, path: &str, idx: usize) -> Option<String> {
+        let level_url = self.level_url(path);
+        if idx == 0 {
+            return Some(level_url);
         }
+        let cursor = self
+            .levels
+            .get(path)?
+            .pages
+            .get(idx - 1)?
+            .page
+            .next
+            .as_ref()?;
+        Some(format!("{level_url}?cursor={}", url_encode(cursor)))
+    }
 
-        let response = match req.send() {
-            Ok(r) => r,
-            Err(e) => {
-                return vec![FfonElement::new_str(format!(
-                    "Error connecting to {}: {}",
-                    self.remote_url, e
-                ))];
-            }
+    /// Ask the worker for page `idx` of `path`, unless it is already asked for.
+    fn request(&mut self, path: &str, idx: usize, held: bool) {
+        let Some(url) = self.page_url(path, idx) else {
+            return;
         };
-
-        if !response.status().is_success() {
-            return vec![FfonElement::new_str(format!(
-                "Failed to fetch from {}: {} {}",
-                self.remote_url,
-                response.status().as_u16(),
-                response.status().canonical_reason().unwrap_or("")
-            ))];
+        if self.inflight.contains_key(&url) {
+            return;
         }
+        let fetcher = self
+            .fetcher
+            .get_or_insert_with(|| Fetcher::spawn(cache::store_path()));
+        fetcher.request(Job {
+            url: url.clone(),
+            api_key: self.api_key.clone(),
+            held,
+        });
+        self.inflight.insert(url, (path.to_owned(), idx));
+    }
 
-        let body = match response.text() {
-            Ok(t) => t,
-            Err(e) => {
-                return vec![FfonElement::new_str(format!(
-                    "Error reading response from {}: {e}",
-                    self.remote_url
-                ))];
-            }
-        };
+    fn pending(&self, path: &str, idx: usize) -> bool {
+        self.inflight.values().any(|(p, i)| p == path && *i == idx)
+    }
 
-        let arr = match serde_json::from_str::<serde_json::Value>(&body) {
-            Ok(serde_json::Value::Array(a)) => a,
-            Ok(_) => {
-                return vec![FfonElement::new_str(format!(
-                    "Invalid response from {}",
-                    self.remote_url
-                ))];
+    /// The children of `path` if the nearest level above it that is here
+    /// already carries them, so entering them needs no request.
+    fn inline_children(&self, path: &str) -> Option<Vec<FfonElement>> {
+        fn named<'a>(
+            elements: impl IntoIterator<Item = &'a FfonElement>,
+            segment: &str,
+        ) -> Option<&'a Vec<FfonElement>> {
+            elements
+                .into_iter()
+                .filter_map(FfonElement::as_obj)
+                .find(|o| tags::strip_display(&o.key) == segment)
+                .map(|o| &o.children)
+        }
+        let segments: Vec<&str> = path.split('/').filter(|s| !s.is_empty()).collect();
+        for depth in (0..segments.len()).rev() {
+            let ancestor = format!("/{}", segments[..depth].join("/"));
+            let Some(level) = self.levels.get(&ancestor) else {
+                continue;
+            };
+            // The object at the ancestor's level: one the server left to
+            // fetch is asked for, one it sent — empty or not — is served.
+            let (page, index) = level.pages.iter().find_map(|l| {
+                l.page
+                    .elements
+                    .iter()
+                    .position(|e| {
+                        e.as_obj()
+                            .is_some_and(|o| tags::strip_display(&o.key) == segments[depth])
+                    })
+                    .map(|i| (&l.page, i))
+            })?;
+            if page.lazy.binary_search(&index).is_ok() {
+                return None;
             }
-            Err(e) => {
-                return vec![FfonElement::new_str(format!(
-                    "Invalid JSON from {}: {e}",
-                    self.remote_url
-                ))];
+            let mut children = &page.elements[index].as_obj()?.children;
+            for segment in &segments[depth + 1..] {
+                children = named(children, segment)?;
             }
-        };
-
-        // Wrap each top-level object with a <link> tag for lazy sub-navigation,
-        // matching wrapWithLinks() in remote.ts.
-        let base = self.remote_url.trim_end_matches('/');
-        arr.iter().map(|v| wrap_with_link(v, base)).collect()
+            // A server that tells unsent levels only by their being empty
+            // has sent nothing for an empty one at any depth.
+            if page.legacy && children.is_empty() {
+                return None;
+            }
+            return Some(children.clone());
+        }
+        None
     }
-}
 
-/// Wrap a top-level JSON value with a `<link>` tag on its object key,
-/// mirroring `wrapWithLinks` in remote.ts.
-///
-/// - Strings are passed through as-is.
-/// - Objects whose key already contains `<link>` are passed through.
-/// - Other objects get `<link>{base_url}/{url-encoded key}</link>{key}` as
-///   their key, and an empty children list (sub-nav is handled by the link
-///   resolver in the main binary, not fetched here).
-fn wrap_with_link(v: &serde_json::Value, base_url: &str) -> FfonElement {
-    if let serde_json::Value::Object(map) = v {
-        if let Some((key, _)) = map.iter().next() {
-            if key.contains("<link>") {
-                // Already wrapped — delegate to the standard parser.
-                return parse_json_value(v);
+    /// Revalidate the pages of `path` past their lifetime, and retry a first
+    /// page that failed once its wait is up.
+    fn revalidate(&mut self, path: &str) {
+        let now = fetcher::now_secs();
+        let Some(level) = self.levels.get(path) else {
+            return;
+        };
+        if let Some((_, retry_at)) = level.failed {
+            if now >= retry_at {
+                self.request(path, 0, false);
             }
-            let encoded_key = url_encode(key);
-            let link_key = format!("<link>{base_url}/{encoded_key}</link>{key}");
-            // Return an empty object — children are fetched lazily via the link.
-            return FfonElement::new_obj(link_key);
+            return;
+        }
+        let stale: Vec<usize> = (0..level.pages.len())
+            .filter(|&i| now >= level.pages[i].fresh_until)
+            .collect();
+        for idx in stale {
+            self.request(path, idx, true);
+        }
+    }
+
+    /// What `path` shows: its pages, then what is under way or what comes next.
+    fn render(&self, path: &str) -> Vec<FfonElement> {
+        let Some(level) = self.levels.get(path) else {
+            return Vec::new();
+        };
+        let mut items: Vec<FfonElement> = level
+            .pages
+            .iter()
+            .flat_map(|l| l.page.elements.iter().cloned())
+            .collect();
+        let more = level.pages.last().and_then(|l| l.page.next.as_ref());
+        if self.pending(path, level.pages.len()) {
+            let text = if level.pages.is_empty() {
+                "Loading…"
+            } else {
+                "Loading more…"
+            };
+            items.push(FfonElement::new_str(text));
+        } else if more.is_some() {
+            items.push(FfonElement::new_str(format!(
+                "<button>{LOAD_MORE}</button>Load more…"
+            )));
+        } else if let Some((msg, _)) = &level.failed {
+            items.push(FfonElement::new_str(msg.clone()));
         }
+        items
     }
-    parse_json_value(v)
 }
 
 /// Minimal percent-encoding for path segments (RFC 3986 unreserved chars are
@@ -206,16 +327,23 @@ impl Provider for RemoteProvider {
     }
 
     fn fetch(&mut self) -> Vec<FfonElement> {
-        if self.current_path != "/" {
-            // Sub-navigation is handled by the <link> resolver; we serve nothing here.
-            return Vec::new();
+        if self.remote_url.is_empty() {
+            return vec![FfonElement::new_str(format!(
+                "No remote URL configured for \"{}\"",
+                self.name
+            ))];
         }
-        if let Some(cached) = &self.cached_root {
-            return cached.clone();
+        let path = self.current_path.clone();
+        if self.levels.contains_key(&path) {
+            self.revalidate(&path);
+        } else {
+            if let Some(children) = self.inline_children(&path) {
+                return children;
+            }
+            self.levels.insert(path.clone(), Level::default());
+            self.request(&path, 0, false);
         }
-        let result = self.fetch_from_server();
-        self.cached_root = Some(result.clone());
-        result
+        self.render(&path)
     }
 
     fn push_path(&mut self, segment: &str) {
@@ -244,18 +372,89 @@ impl Provider for RemoteProvider {
         &self.current_path
     }
 
-    fn on_setting_change(&mut self, key: &str, value: &str) {
-        match key {
-            "remoteUrl" => {
-                if self.remote_url != value {
-                    self.remote_url = value.to_owned();
-                    self.cached_root = None; // invalidate cache
+    fn on_button_press(&mut self, function_name: &str) {
+        if function_name == LOAD_MORE {
+            let path = self.current_path.clone();
+            let next = self.levels.get(&path).map_or(0, |l| l.pages.len());
+            self.request(&path, next, false);
+        }
+    }
+
+    fn tick(&mut self) -> bool {
+        let Some(fetcher) = &self.fetcher else {
+            return false;
+        };
+        let now = fetcher::now_secs();
+        let mut changed = false;
+        for reply in fetcher.replies() {
+            // A request from before a settings change: its level is gone.
+            let Some((path, idx)) = self.inflight.get(&reply.url).cloned() else {
+                continue;
+            };
+            if !matches!(
+                reply.outcome,
+                Outcome::Stored {
+                    revalidating: true,
+                    ..
                 }
+            ) {
+                self.inflight.remove(&reply.url);
             }
-            "apiKey" => {
-                self.api_key = value.to_owned();
-            }
-            _ => {}
+            let level = self.levels.entry(path.clone()).or_default();
+            // Shown as "Loading…" until now, whatever the reply says.
+            let placeholder = idx >= level.pages.len();
+            // A page may not be revalidated again straight away, however
+            // short the lifetime its server gave it.
+            let floor = now + RETRY_SECS;
+            let shown = match reply.outcome {
+                Outcome::Stored {
+                    page, fresh_until, ..
+                } => level.place(idx, page, fresh_until),
+                Outcome::Fetched { page, fresh_until } => {
+                    self.offline = false;
+                    level.place(idx, page, fresh_until.max(floor))
+                }
+                Outcome::Unchanged { fresh_until } => {
+                    self.offline = false;
+                    if let Some(held) = level.pages.get_mut(idx) {
+                        held.fresh_until = fresh_until.max(floor);
+                    }
+                    false
+                }
+                Outcome::Failed(msg) => {
+                    if let Some(held) = level.pages.get_mut(idx) {
+                        held.fresh_until = floor;
+                    } else if idx == 0 {
+                        level.failed = Some((msg.clone(), floor));
+                    }
+                    if !std::mem::replace(&mut self.offline, true) {
+                        self.error = Some(msg);
+                    }
+                    true
+                }
+            };
+            changed |= path == self.current_path && (shown || placeholder);
+        }
+        changed
+    }
+
+    fn take_error(&mut self) -> Option<String> {
+        self.error.take()
+    }
+
+    fn on_setting_change(&mut self, key: &str, value: &str) {
+        let changed = match key {
+            "remoteUrl" => std::mem::replace(&mut self.remote_url, value.to_owned()) != value,
+            "apiKey" => std::mem::replace(&mut self.api_key, value.to_owned()) != value,
+            _ => false,
+        };
+        if changed {
+            // Another server or another account: nothing held still applies.
+            // Replies still on their way are dropped with the worker.
+            self.levels.clear();
+            self.inflight.clear();
+            self.fetcher = None;
+            self.offline = false;
         }
     }
 }
@@ -273,7 +472,7 @@ impl Provider for RemoteProvider {
 #[cfg(test)]
 mod tests {
     use super::*;
-    use wiremock::matchers::{header, method, path};
+    use wiremock::matchers::{header, method, path, query_param};
     use wiremock::{Mock, MockServer, ResponseTemplate};
 
     fn start_mock_server() -> (tokio::runtime::Runtime, MockServer) {
@@ -286,8 +485,26 @@ mod tests {
         rt.block_on(mock.mount(server));
     }
 
+    /// `fetch()`, then tick until the worker has answered everything asked.
+    fn fetch_settled(p: &mut RemoteProvider) -> Vec<FfonElement> {
+        p.fetch();
+        for _ in 0..500 {
+            p.tick();
+            if p.inflight.is_empty() {
+                break;
+            }
+            std::thread::sleep(std::time::Duration::from_millis(10));
+        }
+        assert!(p.inflight.is_empty(), "the worker never answered");
+        p.fetch()
+    }
+
+    fn requests(rt: &tokio::runtime::Runtime, server: &MockServer) -> Vec<wiremock::Request> {
+        rt.block_on(server.received_requests()).unwrap_or_default()
+    }
+
     #[test]
-    fn fetch_success_wraps_objects_with_link_tags() {
+    fn fetch_success_serves_unsent_levels_as_empty_objects() {
         let (rt, server) = start_mock_server();
         mount(
             &rt,
@@ -300,28 +517,14 @@ mod tests {
             ),
         );
 
-        let base_url = server.uri();
-        let mut p = RemoteProvider::new("mysvc", base_url.clone(), String::new());
-        let items = p.fetch();
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        // Nothing waits on the network: the level shows as loading.
+        assert_eq!(p.fetch(), vec![FfonElement::new_str("Loading…")]);
 
-        // Expect 2 elements
+        let items = fetch_settled(&mut p);
         assert_eq!(items.len(), 2, "should have 2 items, got: {items:?}");
-
-        // First item: "Products" should be wrapped with a <link> tag
-        let first_key = match &items[0] {
-            FfonElement::Obj(o) => o.key.clone(),
-            other => panic!("expected Obj, got {other:?}"),
-        };
-        assert!(
-            first_key.contains("<link>") && first_key.contains("Products"),
-            "expected <link> tag wrapping 'Products', got: {first_key}"
-        );
-        assert!(
-            first_key.contains(&base_url),
-            "link key should contain server URL, got: {first_key}"
-        );
-
-        // Second item: plain string passes through
+        // An object sent without children is entered through the provider.
+        assert_eq!(items[0], FfonElement::new_obj("Products"));
         assert_eq!(items[1], FfonElement::Str("plain string item".to_owned()));
     }
 
@@ -340,7 +543,7 @@ mod tests {
         );
 
         let mut p = RemoteProvider::new("mysvc", server.uri(), "secret123".to_owned());
-        let items = p.fetch();
+        let items = fetch_settled(&mut p);
         assert_eq!(items, vec![FfonElement::Str("item".to_owned())]);
     }
 
@@ -356,7 +559,7 @@ mod tests {
         );
 
         let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
-        let items = p.fetch();
+        let items = fetch_settled(&mut p);
 
         assert_eq!(items.len(), 1);
         let msg = match &items[0] {
@@ -367,6 +570,7 @@ mod tests {
             msg.contains("401") || msg.contains("Failed"),
             "expected 401/Failed in error message, got: {msg}"
         );
+        assert_eq!(p.take_error(), Some(msg));
     }
 
     #[test]
@@ -381,6 +585,218 @@ mod tests {
         );
     }
 
+    #[test]
+    fn entering_an_object_fetches_its_own_path() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET")).and(path("/root")).respond_with(
+                ResponseTemplate::new(200)
+                    .set_body_json(serde_json::json!([{ "Products & Co": [] }])),
+            ),
+        );
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path("/Products%20%26%20Co"))
+                .respond_with(
+                    ResponseTemplate::new(200).set_body_json(serde_json::json!(["Widget"])),
+                ),
+        );
+
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        let root = fetch_settled(&mut p);
+        p.push_path("Products & Co");
+        assert_eq!(fetch_settled(&mut p), vec![FfonElement::new_str("Widget")]);
+
+        // Going back is served from memory.
+        p.pop_path();
+        assert_eq!(p.fetch(), root);
+        assert!(p.inflight.is_empty());
+        assert_eq!(requests(&rt, &server).len(), 2);
+    }
+
+    #[test]
+    fn inline_children_are_served_without_a_request() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET")).and(path("/root")).respond_with(
+                ResponseTemplate::new(200)
+                    .set_body_json(serde_json::json!([{ "Docs": [{ "Guides": ["intro"] }] }])),
+            ),
+        );
+
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        fetch_settled(&mut p);
+        p.push_path("Docs");
+        p.push_path("Guides");
+        assert_eq!(p.fetch(), vec![FfonElement::new_str("intro")]);
+        assert!(p.inflight.is_empty());
+        assert_eq!(requests(&rt, &server).len(), 1);
+    }
+
+    #[test]
+    fn an_object_a_server_marks_as_sent_is_entered_without_a_request() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET")).and(path("/root")).respond_with(
+                ResponseTemplate::new(200).set_body_json(serde_json::json!({
+                    "items": [{ "Empty": [] }],
+                    "lazy": [],
+                })),
+            ),
+        );
+
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        fetch_settled(&mut p);
+        p.push_path("Empty");
+        assert_eq!(p.fetch(), Vec::<FfonElement>::new());
+        assert!(p.inflight.is_empty());
+        assert_eq!(requests(&rt, &server).len(), 1);
+    }
+
+    #[test]
+    fn an_outage_is_reported_once() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET")).respond_with(ResponseTemplate::new(503)),
+        );
+
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        fetch_settled(&mut p);
+        assert!(p.take_error().is_some());
+
+        // Retried while the server is still down: nothing new to say.
+        let settle = |p: &mut RemoteProvider| {
+            p.request("/", 0, false);
+            for _ in 0..500 {
+                p.tick();
+                if p.inflight.is_empty() {
+                    break;
+                }
+                std::thread::sleep(std::time::Duration::from_millis(10));
+            }
+            assert!(p.inflight.is_empty(), "the worker never answered");
+        };
+        settle(&mut p);
+        assert_eq!(p.take_error(), None);
+
+        // Back, then down again: a new outage.
+        rt.block_on(server.reset());
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .respond_with(ResponseTemplate::new(200).set_body_json(serde_json::json!(["a"]))),
+        );
+        settle(&mut p);
+        assert_eq!(p.take_error(), None);
+        rt.block_on(server.reset());
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET")).respond_with(ResponseTemplate::new(503)),
+        );
+        settle(&mut p);
+        assert!(p.take_error().is_some());
+    }
+
+    #[test]
+    fn further_pages_load_when_asked_for() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path("/root"))
+                .and(query_param("cursor", "page 2"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .set_body_json(serde_json::json!({ "items": ["b"], "next": null })),
+                )
+                .with_priority(1),
+        );
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path("/root"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .set_body_json(serde_json::json!({ "items": ["a"], "next": "page 2" })),
+                )
+                .with_priority(2),
+        );
+
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        let first = fetch_settled(&mut p);
+        assert_eq!(first[0], FfonElement::new_str("a"));
+        let more = first[1].as_str().unwrap_or("");
+        assert!(tags::has_button(more), "got: {first:?}");
+
+        p.on_button_press(LOAD_MORE);
+        assert_eq!(
+            p.fetch(),
+            vec![
+                FfonElement::new_str("a"),
+                FfonElement::new_str("Loading more…")
+            ]
+        );
+        assert_eq!(
+            fetch_settled(&mut p),
+            vec![FfonElement::new_str("a"), FfonElement::new_str("b")]
+        );
+    }
+
+    #[test]
+    fn a_stale_level_shows_at_once_while_it_is_revalidated() {
+        let (rt, server) = start_mock_server();
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path("/root"))
+                .and(header("If-None-Match", "\"v1\""))
+                .respond_with(ResponseTemplate::new(304))
+                .with_priority(1),
+        );
+        mount(
+            &rt,
+            &server,
+            Mock::given(method("GET"))
+                .and(path("/root"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .insert_header("ETag", "\"v1\"")
+                        .insert_header("Cache-Control", "max-age=0")
+                        .set_body_json(serde_json::json!(["item"])),
+                )
+                .with_priority(2),
+        );
+
+        let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
+        let items = fetch_settled(&mut p);
+        p.levels.get_mut("/").unwrap().pages[0].fresh_until = 0;
+
+        assert_eq!(p.fetch(), items, "the stale copy shows while it is checked");
+        assert!(!p.inflight.is_empty());
+        assert_eq!(fetch_settled(&mut p), items);
+        let sent = requests(&rt, &server);
+        assert_eq!(sent.len(), 2);
+        assert!(sent[1].headers.get("if-none-match").is_some());
+        // Confirmed: good for a while, so entering again asks nothing.
+        p.fetch();
+        assert!(p.inflight.is_empty());
+    }
+
     #[test]
     fn on_setting_change_remote_url_invalidates_cache() {
         let (rt, server) = start_mock_server();
@@ -393,12 +809,12 @@ mod tests {
         );
 
         let mut p = RemoteProvider::new("mysvc", server.uri(), String::new());
-        let _ = p.fetch(); // populate cache
-        assert!(p.cached_root.is_some());
+        let _ = fetch_settled(&mut p); // populate cache
+        assert!(!p.levels.is_empty());
 
         p.on_setting_change("remoteUrl", "https://other.example.com");
         assert!(
-            p.cached_root.is_none(),
+            p.levels.is_empty(),
             "cache should be cleared after remoteUrl change"
         );
         assert_eq!(p.remote_url, "https://other.example.com");
@@ -407,8 +823,10 @@ mod tests {
     #[test]
     fn on_setting_change_api_key_stores_value() {
         let mut p = RemoteProvider::new("mysvc", String::new(), String::new());
+        p.levels.insert("/".to_owned(), Level::default());
         p.on_setting_change("apiKey", "newkey");
         assert_eq!(p.api_key, "newkey");
+        assert!(p.levels.is_empty(), "another key may see another tree");
     }
 
     #[test]
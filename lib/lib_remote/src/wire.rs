@@ -0,0 +1,558 @@
+//! Binary FFON, as the remote provider takes it over the wire and keeps it on
+//! disk.
+//!
+//! A server that can send it is asked for it first (`Accept:
+//! application/x-ffon, application/json;q=0.9`) and says so with
+//! `Content-Type: application/x-ffon`. It saves the two passes JSON costs —
+//! text into a `serde_json::Value`, then the value into elements — and
+//! decodes straight off the response body as it arrives: every string is
+//! read into the one allocation the tree keeps.
+//!
+//! ```text
+//! page  := "FFON" 0x02  list  [cursor]
+//! list  := item* END
+//! item  := STR text | OBJ text list | LAZY text
+//! text  := varint(len) utf8         (literal)
+//!        | varint(len) utf8         (literal, kept: appended to the table)
+//!        | varint(index)            (a kept string again)
+//! cursor:= varint(len) utf8         (the next page's; absent on the last)
+//! ```
+//!
+//! An item's tag byte says both what it is and how its text comes, see
+//! [`tag`]. The encoder keeps only strings that occur more than once — keys
+//! repeated across rows, the same label in every record — so a table entry is
+//! never paid for by a string that does not repeat, and the decoder's table is
+//! exactly the strings it will be asked for again. Lengths and indexes are
+//! unsigned LEB128.
+//!
+//! `LAZY` is an object whose children the server has not sent, fetched from
+//! its own path when entered; it may only stand in the top list. An `OBJ` with
+//! an empty list is an object with no children. Version 1 had no `LAZY` and
+//! meant it by an empty `OBJ`, which is how a version 1 body is still read,
+//! and how a page from a server that does not tell the two apart is still
+//! written ([`Page::legacy`]).
+
+use sicompass_sdk::ffon::FfonElement;
+use std::collections::HashMap;
+use std::io::{BufRead, BufReader, Read};
+
+use crate::fetcher::Page;
+
+/// Media type of a binary FFON body.
+pub(crate) const CONTENT_TYPE: &str = "application/x-ffon";
+
+const MAGIC: &[u8; 5] = b"FFON\x02";
+
+/// Version 1, without `LAZY`.
+const MAGIC_V1: &[u8; 5] = b"FFON\x01";
+
+/// Nesting deeper than this is refused rather than decoded.
+const MAX_DEPTH: usize = 4096;
+
+/// A string longer than this is refused rather than allocated.
+const MAX_TEXT: u64 = 64 << 20;
+
+/// Item tags: `1 + 3 * kind + mode`, with kind 0 for a string, 1 for an
+/// object and 2 for a lazy one, and mode 0 literal, 1 literal kept, 2
+/// reference.
+mod tag {
+    pub const END: u8 = 0;
+    pub const STR: u8 = 1;
+    pub const OBJ: u8 = 4;
+    pub const LAZY: u8 = 7;
+    pub const KEPT: u8 = 1;
+    pub const REF: u8 = 2;
+}
+
+/// Encode `page`, elements and cursor.
+pub(crate) fn encode(page: &Page) -> Vec<u8> {
+    // First pass: which strings repeat.
+    let mut seen: HashMap<&str, u32> = HashMap::new();
+    walk(page, &mut |item, text| {
+        if item.is_some() {
+            *seen.entry(text).or_default() += 1;
+        }
+    });
+
+    let mut out = Vec::with_capacity(16 + seen.keys().map(|s| s.len() + 2).sum::<usize>());
+    out.extend_from_slice(if page.legacy { MAGIC_V1 } else { MAGIC });
+    let mut kept: HashMap<&str, u64> = HashMap::new();
+    walk(page, &mut |item, text| {
+        let Some(kind) = item else {
+            out.push(tag::END);
+            return;
+        };
+        if let Some(&index) = kept.get(text) {
+            out.push(kind + tag::REF);
+            put_varint(&mut out, index);
+        } else if seen[text] > 1 {
+            out.push(kind + tag::KEPT);
+            put_text(&mut out, text);
+            kept.insert(text, kept.len() as u64);
+        } else {
+            out.push(kind);
+            put_text(&mut out, text);
+        }
+    });
+    if let Some(cursor) = &page.next {
+        put_text(&mut out, cursor);
+    }
+    out
+}
+
+/// Visit `page`'s elements depth-first, in order: `(Some(tag), text)` for
+/// each item, then `(None, "")` where each list ends — the top one last.
+fn walk<'a>(page: &'a Page, visit: &mut impl FnMut(Option<u8>, &'a str)) {
+    // An explicit stack: a tree as deep as a decoder accepts must not
+    // overflow the encoder's.
+    let mut stack = vec![page.elements.iter().enumerate()];
+    loop {
+        let top = stack.len() == 1;
+        let Some(items) = stack.last_mut() else {
+            break;
+        };
+        let Some((i, e)) = items.next() else {
+            stack.pop();
+            visit(None, "");
+            continue;
+        };
+        if let Some(obj) = e.as_obj() {
+            if top && !page.legacy && page.lazy.binary_search(&i).is_ok() {
+                visit(Some(tag::LAZY), &obj.key);
+            } else {
+                visit(Some(tag::OBJ), &obj.key);
+                stack.push(obj.children.iter().enumerate());
+            }
+        } else if let Some(s) = e.as_str() {
+            visit(Some(tag::STR), s);
+        }
+    }
+}
+
+fn put_varint(out: &mut Vec<u8>, mut n: u64) {
+    while n >= 0x80 {
+        out.push(n as u8 | 0x80);
+        n >>= 7;
+    }
+    out.push(n as u8);
+}
+
+fn put_text(out: &mut Vec<u8>, text: &str) {
+    put_varint(out, text.len() as u64);
+    out.extend_from_slice(text.as_bytes());
+}
+
+/// Decode a page from `reader` as it reads — a response body, a file, a
+/// slice.
+pub(crate) fn decode(reader: impl Read) -> Result<Page, String> {
+    let mut decoder = Decoder {
+        r: BufReader::new(reader),
+        table: Vec::new(),
+    };
+    let mut magic = [0; MAGIC.len()];
+    decoder
+        .r
+        .read_exact(&mut magic)
+        .map_err(|_| "Invalid FFON (truncated)".to_owned())?;
+    let v1 = &magic == MAGIC_V1;
+    if &magic != MAGIC && !v1 {
+        return Err("Invalid FFON (not binary FFON)".to_owned());
+    }
+
+    // The list being read, and the objects it is nested in with the lists
+    // they were found in.
+    let mut list: Vec<FfonElement> = Vec::new();
+    let mut open: Vec<(String, Vec<FfonElement>)> = Vec::new();
+    let mut lazy = Vec::new();
+    loop {
+        let t = decoder.byte()?.ok_or("Invalid FFON (truncated)")?;
+        if t == tag::END {
+            let Some((key, parent)) = open.pop() else {
+                break;
+            };
+            let children = std::mem::replace(&mut list, parent);
+            let mut obj = FfonElement::new_obj(key);
+            if let Some(o) = obj.as_obj_mut() {
+                o.children = children;
+            }
+            list.push(obj);
+            continue;
+        }
+        let (kind, mode) = match t {
+            1..=3 => (tag::STR, t - tag::STR),
+            4..=6 => (tag::OBJ, t - tag::OBJ),
+            7..=9 if !v1 => (tag::LAZY, t - tag::LAZY),
+            _ => return Err(format!("Invalid FFON (tag {t})")),
+        };
+        let text = match mode {
+            0 => decoder.text()?,
+            tag::KEPT => {
+                let text = decoder.text()?;
+                decoder.table.push(text.clone());
+                text
+            }
+            _ => {
+                let index = decoder.varint()?;
+                decoder
+                    .table
+                    .get(index as usize)
+                    .cloned()
+                    .ok_or_else(|| format!("Invalid FFON (string {index})"))?
+            }
+        };
+        if kind == tag::STR {
+            list.push(FfonElement::new_str(text));
+        } else if kind == tag::LAZY {
+            if !open.is_empty() {
+                return Err("Invalid FFON (lazy object below the top)".to_owned());
+            }
+            lazy.push(list.len());
+            list.push(FfonElement::new_obj(text));
+        } else if open.len() < MAX_DEPTH {
+            open.push((text, std::mem::take(&mut list)));
+        } else {
+            return Err("Invalid FFON (nested too deep)".to_owned());
+        }
+    }
+
+    let next = match decoder.byte()? {
+        None => None,
+        Some(first) => Some(decoder.text_from(first)?),
+    };
+    if v1 {
+        lazy = (0..list.len())
+            .filter(|&i| list[i].as_obj().is_some_and(|o| o.children.is_empty()))
+            .collect();
+    }
+    Ok(Page {
+        elements: list,
+        next,
+        lazy,
+        legacy: v1,
+    })
+}
+
+struct Decoder<R> {
+    r: BufReader<R>,
+    /// The kept strings, by index.
+    table: Vec<String>,
+}
+
+impl<R: Read> Decoder<R> {
+    /// The next byte, `None` at a clean end.
+    fn byte(&mut self) -> Result<Option<u8>, String> {
+        let b = self.fill()?.first().copied();
+        if b.is_some() {
+            self.r.consume(1);
+        }
+        Ok(b)
+    }
+
+    /// What is buffered, reading more if nothing is; empty at the end.
+    fn fill(&mut self) -> Result<&[u8], String> {
+        loop {
+            match self.r.fill_buf() {
+                Ok(_) => break,
+                Err(e) if e.kind() == std::io::ErrorKind::Interrupted => continue,
+                Err(e) => return Err(format!("Error reading FFON: {e}")),
+            }
+        }
+        Ok(self.r.buffer())
+    }
+
+    fn varint(&mut self) -> Result<u64, String> {
+        let first = self.byte()?.ok_or("Invalid FFON (truncated)")?;
+        self.varint_from(first)
+    }
+
+    fn varint_from(&mut self, first: u8) -> Result<u64, String> {
+        let mut n = u64::from(first & 0x7f);
+        let mut b = first;
+        let mut shift = 7;
+        while b & 0x80 != 0 {
+            if shift > 63 {
+                return Err("Invalid FFON (length)".to_owned());
+            }
+            b = self.byte()?.ok_or("Invalid FFON (truncated)")?;
+            n |= u64::from(b & 0x7f) << shift;
+            shift += 7;
+        }
+        Ok(n)
+    }
+
+    fn text(&mut self) -> Result<String, String> {
+        let first = self.byte()?.ok_or("Invalid FFON (truncated)")?;
+        self.text_from(first)
+    }
+
+    fn text_from(&mut self, first: u8) -> Result<String, String> {
+        let len = self.varint_from(first)?;
+        if len > MAX_TEXT {
+            return Err(format!("Invalid FFON (string of {len} bytes)"));
+        }
+        let len = len as usize;
+        let buffered = self.fill()?;
+        let bytes = if buffered.len() >= len {
+            let bytes = buffered[..len].to_vec();
+            self.r.consume(len);
+            bytes
+        } else {
+            // Longer than the buffer: `take` rather than a buffer of `len` up
+            // front, so a length the body does not back up costs nothing.
+            let mut bytes = Vec::new();
+            (&mut self.r)
+                .take(len as u64)
+                .read_to_end(&mut bytes)
+                .map_err(|e| format!("Error reading FFON: {e}"))?;
+            if bytes.len() != len {
+                return Err("Invalid FFON (truncated)".to_owned());
+            }
+            bytes
+        };
+        String::from_utf8(bytes).map_err(|_| "Invalid FFON (not UTF-8)".to_owned())
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// xorshift64*: the same trees on every run, no dependency.
+    struct Rng(u64);
+
+    impl Rng {
+        fn next(&mut self) -> u64 {
+            self.0 ^= self.0 >> 12;
+            self.0 ^= self.0 << 25;
+            self.0 ^= self.0 >> 27;
+            self.0.wrapping_mul(0x2545_f491_4f6c_dd1d)
+        }
+
+        fn below(&mut self, n: u64) -> u64 {
+            self.next() % n
+        }
+    }
+
+    /// A tree of about `nodes` elements, at most `depth` deep, whose strings
+    /// repeat about as often as a real listing's do.
+    fn tree(rng: &mut Rng, nodes: usize, depth: usize) -> Vec<FfonElement> {
+        const WORDS: &[&str] = &[
+            "",
+            "id",
+            "name",
+            "<button>open</button>Open",
+            "ü ✓ 𝄞",
+            "a\0b",
+        ];
+        let text = |rng: &mut Rng| match rng.below(3) {
+            0 => WORDS[rng.below(WORDS.len() as u64) as usize].to_owned(),
+            1 => format!("row {}", rng.below(50)),
+            _ => format!("unique {}", rng.next()),
+        };
+        let mut out = Vec::new();
+        let mut left = nodes;
+        while left > 0 {
+            left -= 1;
+            if depth > 0 && rng.below(4) == 0 {
+                let share = rng.below(left as u64 + 1) as usize;
+                left -= share;
+                let mut obj = FfonElement::new_obj(text(rng));
+                obj.as_obj_mut().unwrap().children = tree(rng, share, depth - 1);
+                out.push(obj);
+            } else {
+                out.push(FfonElement::new_str(text(rng)));
+            }
+        }
+        out
+    }
+
+    #[test]
+    fn random_pages_survive_the_round_trip() {
+        let mut rng = Rng(0x5eed);
+        for round in 0..300 {
+            let (nodes, depth) = (rng.below(200) as usize, rng.below(8) as usize);
+            let elements = tree(&mut rng, nodes, depth);
+            let lazy = (0..elements.len())
+                .filter(|&i| elements[i].as_obj().is_some_and(|o| o.children.is_empty()))
+                .filter(|_| rng.below(2) == 0)
+                .collect();
+            let page = Page {
+                elements,
+                next: (round % 3 == 0).then(|| format!("cursor {round}")),
+                lazy,
+                legacy: false,
+            };
+            let bytes = encode(&page);
+            assert_eq!(decode(&bytes[..]), Ok(page), "round {round}");
+        }
+    }
+
+    #[test]
+    fn edge_shapes_survive_the_round_trip() {
+        let mut deep = FfonElement::new_obj("leaf");
+        for level in 0..MAX_DEPTH - 1 {
+            let mut parent = FfonElement::new_obj(format!("level {level}"));
+            parent.as_obj_mut().unwrap().children = vec![deep];
+            deep = parent;
+        }
+        for page in [
+            Page::default(),
+            Page {
+                elements: Vec::new(),
+                next: Some(String::new()),
+                lazy: Vec::new(),
+                legacy: false,
+            },
+            Page {
+                elements: vec![FfonElement::new_str("x".repeat(70_000))],
+                next: None,
+                lazy: Vec::new(),
+                legacy: false,
+            },
+            Page {
+                elements: vec![deep],
+                next: Some("end".to_owned()),
+                lazy: Vec::new(),
+                legacy: false,
+            },
+        ] {
+            assert_eq!(decode(&encode(&page)[..]), Ok(page));
+        }
+    }
+
+    #[test]
+    fn unsent_levels_are_told_from_empty_ones() {
+        let page = Page {
+            elements: vec![
+                FfonElement::new_obj("unsent"),
+                FfonElement::new_obj("empty"),
+            ],
+            next: None,
+            lazy: vec![0],
+            legacy: false,
+        };
+        let bytes = encode(&page);
+        assert_eq!(bytes[MAGIC.len()], tag::LAZY);
+        assert_eq!(decode(&bytes[..]), Ok(page));
+
+        // Version 1 said "unsent" with an empty object at the top.
+        let v1 = b"FFON\x01\x04\x01a\x00\x04\x01b\x01\x01c\x00\x00";
+        let page = decode(&v1[..]).unwrap();
+        assert_eq!(page.lazy, vec![0]);
+        assert_eq!(page.elements[1].as_obj().map(|o| o.children.len()), Some(1));
+        assert!(page.legacy);
+        assert_eq!(encode(&page), v1, "and is written back as version 1");
+        assert!(decode(&b"FFON\x01\x07\x01a\x00"[..]).is_err());
+
+        // Only the top list holds unsent levels.
+        assert!(decode(&b"FFON\x02\x04\x01a\x07\x01b\x00\x00"[..]).is_err());
+    }
+
+    #[test]
+    fn repeated_strings_are_sent_once() {
+        let row = |i| {
+            let mut obj = FfonElement::new_obj("customer");
+            obj.as_obj_mut().unwrap().children = vec![
+                FfonElement::new_str("status: active"),
+                FfonElement::new_str(format!("#{i}")),
+            ];
+            obj
+        };
+        let page = Page {
+            elements: (0..1000).map(row).collect(),
+            next: None,
+            lazy: Vec::new(),
+            legacy: false,
+        };
+        let bytes = encode(&page);
+        let count = |needle: &[u8]| bytes.windows(needle.len()).filter(|w| w == &needle).count();
+        assert_eq!(count(b"customer"), 1);
+        assert_eq!(count(b"status: active"), 1);
+        assert_eq!(decode(&bytes[..]), Ok(page));
+    }
+
+    #[test]
+    fn damaged_input_is_an_error_not_a_panic() {
+        let mut rng = Rng(7);
+        let page = Page {
+            elements: tree(&mut rng, 60, 4),
+            next: Some("more".to_owned()),
+            lazy: Vec::new(),
+            legacy: false,
+        };
+        let bytes = encode(&page);
+        // Every cut either fails or, once past the list, loses only the cursor.
+        for cut in 0..bytes.len() {
+            if let Ok(short) = decode(&bytes[..cut]) {
+                assert_eq!(short.elements, page.elements, "cut at {cut}");
+            }
+        }
+        for _ in 0..2000 {
+            let mut bad = bytes.clone();
+            let at = rng.below(bad.len() as u64) as usize;
+            bad[at] = rng.next() as u8;
+            let _ = decode(&bad[..]);
+        }
+        assert!(decode(&b"FFON\x02\x01\xff\xff\xff\xff\x7f"[..]).is_err());
+        assert!(decode(&b"FFON\x02\x03\x09\x00"[..]).is_err());
+        assert!(decode(&b"{\"items\": []}"[..]).is_err());
+
+        let mut too_deep = MAGIC.to_vec();
+        for _ in 0..=MAX_DEPTH {
+            too_deep.extend_from_slice(&[tag::OBJ, 0]);
+        }
+        assert!(decode(&too_deep[..]).is_err());
+    }
+
+    /// JSON against binary FFON for the same 1M-node page: size, encode, and
+    /// the decode the provider does per response.
+    ///
+    /// Ignored by default; run deliberately:
+    ///
+    /// ```text
+    /// cargo test -p sicompass-remote --release -- --ignored --nocapture wire_against_json
+    /// ```
+    #[test]
+    #[ignore = "manual profiling aid; prints timings instead of asserting"]
+    fn wire_against_json() {
+        let page = Page {
+            elements: tree(&mut Rng(1), 1_000_000, 6),
+            next: None,
+            lazy: Vec::new(),
+            legacy: false,
+        };
+        let t = std::time::Instant::now();
+        let json = sicompass_sdk::ffon::to_json_string(&page.elements).unwrap();
+        let json_encode = t.elapsed();
+        let t = std::time::Instant::now();
+        let binary = encode(&page);
+        let binary_encode = t.elapsed();
+
+        let t = std::time::Instant::now();
+        let from_json = crate::fetcher::parse_page(json.as_bytes()).unwrap();
+        let json_decode = t.elapsed();
+        let t = std::time::Instant::now();
+        let from_binary = decode(&binary[..]).unwrap();
+        let binary_decode = t.elapsed();
+        assert_eq!(from_binary, page);
+        std::hint::black_box(from_json);
+
+        println!("\n  1M nodes        size        encode      decode");
+        println!(
+            "  JSON     {:>10} B  {:>10.2?}  {:>10.2?}",
+            json.len(),
+            json_encode,
+            json_decode
+        );
+        println!(
+            "  binary   {:>10} B  {:>10.2?}  {:>10.2?}\n",
+            binary.len(),
+            binary_encode,
+            binary_decode
+        );
+    }
+}
@@ -24,6 +24,7 @@ settings-section-chat-client = Chat-Client
 settings-section-terminal = Terminal
 settings-section-text-editor = Texteditor
 settings-section-tutorial = Anleitung
+settings-section-plugin-usage = Plugin-Nutzung
 
 # Titel der Sponsor- / Cloud- / Support-Links (clientseitig erstellt; die
 # Inhalte der Stufen liefert der Server, auf Englisch).
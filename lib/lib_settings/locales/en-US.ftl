@@ -27,6 +27,7 @@ settings-section-chat-client = chat client
 settings-section-terminal = terminal
 settings-section-text-editor = text editor
 settings-section-tutorial = tutorial
+settings-section-plugin-usage = plugin usage
 
 # Sponsor / cloud / support tier link titles (built client-side; the tier
 # trees themselves are served, in English, by the server).
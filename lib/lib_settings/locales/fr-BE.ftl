@@ -24,6 +24,7 @@ settings-section-chat-client = client de chat
 settings-section-terminal = terminal
 settings-section-text-editor = éditeur de texte
 settings-section-tutorial = tutoriel
+settings-section-plugin-usage = utilisation des plugins
 
 # Titres des liens des niveaux sponsor / cloud / support (construits côté
 # client ; le contenu des niveaux est fourni, en anglais, par le serveur).
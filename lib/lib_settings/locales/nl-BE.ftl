@@ -24,6 +24,7 @@ settings-section-chat-client = chatclient
 settings-section-terminal = terminal
 settings-section-text-editor = tekstverwerker
 settings-section-tutorial = handleiding
+settings-section-plugin-usage = plugingebruik
 
 # Titels van de sponsor- / cloud- / ondersteuningskoppelingen (lokaal gebouwd;
 # de inhoud van de niveaus wordt door de server geleverd, in het Engels).
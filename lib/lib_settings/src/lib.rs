@@ -357,10 +357,7 @@ impl SettingsProvider {
     // ---- Load / save -------------------------------------------------------
 
     fn load_config(&mut self, path: &Path) {
-        let Ok(data) = std::fs::read_to_string(path) else {
-            return;
-        };
-        let Ok(Value::Object(root)) = serde_json::from_str::<Value>(&data) else {
+        let Some(root) = sicompass_config::at(path).read(Map::clone) else {
             return;
         };
 
@@ -431,9 +428,6 @@ impl SettingsProvider {
         let Some(section_name) = self.priority_section.clone() else {
             return;
         };
-        if let Some(parent) = path.parent() {
-            platform::make_dirs(parent);
-        }
         let mut section_map = Map::new();
         for e in &self.checkbox_entries {
             if e.section == section_name && e.checked {
@@ -443,89 +437,28 @@ impl SettingsProvider {
         if section_map.is_empty() {
             return;
         }
-        let mut root = Map::new();
-        root.insert(section_name, Value::Object(section_map));
-        if let Ok(json) = serde_json::to_string_pretty(&Value::Object(root)) {
-            let _ = platform::atomic_write(path, &json);
-        }
-    }
-
-    /// Load the settings root object for an in-place key write.
-    ///
-    /// Returns `Some(map)` when the file is absent (a fresh empty root — the
-    /// legitimate first-write case) or parses cleanly as a JSON object.
-    /// Returns `None` when the file exists but cannot be read or does not
-    /// parse as an object. In that state another process is likely mid-write
-    /// (a partial file parses as garbage), so the caller must abort rather
-    /// than rebuild the file from an empty map — doing so would drop every
-    /// section it is not currently touching.
-    fn load_root_for_write(path: &Path) -> Option<Map<String, Value>> {
-        match std::fs::read_to_string(path) {
-            Ok(s) => match serde_json::from_str::<Value>(&s) {
-                Ok(Value::Object(m)) => Some(m),
-                _ => None,
-            },
-            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Some(Map::new()),
-            Err(_) => None,
-        }
+        sicompass_config::at(path).update(|root| {
+            // Only a file nobody has written yet is seeded.
+            if !root.is_empty() {
+                return false;
+            }
+            root.insert(section_name, Value::Object(section_map));
+            true
+        });
     }
 
-    // Write a single string key into section, preserving everything else in the file.
+    // Write a single string key into section, preserving everything else in the
+    // file. The shared store refuses the write if the file does not parse.
     fn write_key_string(&self, section: &str, key: &str, value: &str) {
-        let Some(path) = self.config_path() else {
-            return;
-        };
-        if let Some(parent) = path.parent() {
-            platform::make_dirs(parent);
-        }
-        // Abort rather than clobber: if the file exists but won't parse,
-        // another process is likely mid-write — rebuilding from an empty map
-        // here would drop every other section.
-        let Some(mut root) = Self::load_root_for_write(&path) else {
-            eprintln!(
-                "sicompass: {} is unreadable or corrupt — setting not saved, \
-                 file left intact for recovery",
-                path.display()
-            );
-            return;
-        };
-        let sec = root
-            .entry(section.to_owned())
-            .or_insert_with(|| Value::Object(Map::new()));
-        if let Value::Object(m) = sec {
-            m.insert(key.to_owned(), Value::String(value.to_owned()));
-        }
-        if let Ok(json) = serde_json::to_string_pretty(&Value::Object(root)) {
-            let _ = platform::atomic_write(&path, &json);
+        if let Some(path) = self.config_path() {
+            sicompass_config::at(&path).set(section, key, value);
         }
     }
 
     // Write a single boolean key into section, preserving everything else in the file.
     fn write_key_bool(&self, section: &str, key: &str, value: bool) {
-        let Some(path) = self.config_path() else {
-            return;
-        };
-        if let Some(parent) = path.parent() {
-            platform::make_dirs(parent);
-        }
-        // See `write_key_string` — abort on an unparseable file to avoid
-        // clobbering a settings file another process is mid-write on.
-        let Some(mut root) = Self::load_root_for_write(&path) else {
-            eprintln!(
-                "sicompass: {} is unreadable or corrupt — setting not saved, \
-                 file left intact for recovery",
-                path.display()
-            );
-            return;
-        };
-        let sec = root
-            .entry(section.to_owned())
-            .or_insert_with(|| Value::Object(Map::new()));
-        if let Value::Object(m) = sec {
-            m.insert(key.to_owned(), Value::Bool(value));
-        }
-        if let Ok(json) = serde_json::to_string_pretty(&Value::Object(root)) {
-            let _ = platform::atomic_write(&path, &json);
+        if let Some(path) = self.config_path() {
+            sicompass_config::at(&path).set(section, key, value);
         }
     }
 
@@ -948,6 +881,16 @@ impl Provider for SettingsProvider {
             result.push(self.populate_section(&section));
         }
 
+        // Read-only status the app measures (plugin usage), last: it is not a
+        // setting, and it only appears once there is something to show.
+        for (section, rows) in sicompass_config::status::sections() {
+            let mut obj = FfonElement::new_obj(Self::localize_section_name(&section));
+            for row in rows {
+                obj.as_obj_mut().unwrap().push(row);
+            }
+            result.push(obj);
+        }
+
         result
     }
 
@@ -326,19 +326,12 @@ impl Provider for TextEditorProvider {
     fn init(&mut self) {
         // Read saved textEditorPath from config so the first fetch() shows the
         // correct directory rather than the home-dir default.
-        if let Some(path) = sicompass_sdk::platform::main_config_path() {
-            if let Ok(data) = std::fs::read_to_string(&path) {
-                if let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) {
-                    if let Some(val) = root
-                        .get("text editor")
-                        .and_then(|s| s.get("textEditorPath"))
-                        .and_then(|v| v.as_str())
-                        .filter(|s| !s.is_empty())
-                    {
-                        self.text_editor_path = val.to_string();
-                    }
-                }
-            }
+        if let Some(val) = sicompass_config::settings()
+            .and_then(|s| s.get("text editor", "textEditorPath"))
+            .and_then(|v| v.as_str().map(str::to_owned))
+            .filter(|s| !s.is_empty())
+        {
+            self.text_editor_path = val;
         }
         self.current_fs_path = PathBuf::from(&self.text_editor_path);
         self.ffon_sub_path.clear();
@@ -10,7 +10,7 @@
 //! - **App** on Windows: download the signed MSI, then on user consent
 //!   spawn `msiexec /i ... /passive` and exit so the installer can replace
 //!   files (preserves WiX upgrade-guid + Programs & Features tracking).
-//! - **Plugin**: test-load the new entry, atomically swap
+//! - **Plugin**: test-load and precompile the new entry, atomically swap
 //!   `<plugins_dir>/<name>/`, then send a `HotReload` event back to the main
 //!   thread so the running provider can be swapped without restart.
 
@@ -63,6 +63,13 @@ pub struct PluginUpdate {
     pub applied: bool,
 }
 
+/// Compiles a staged plugin entry ahead of its first use.
+///
+/// Supplied by the app, which owns the WASM engine: an artifact is only any good
+/// to the engine configuration that built it. Called after the entry is verified
+/// and test-loaded, before the swap.
+pub type Precompile = fn(&Path) -> Result<(), String>;
+
 /// Events the updater sends to the main thread. Only `HotReload` is
 /// consumed today; `AppUpdateReady` is reserved for a future toast.
 #[derive(Debug, Clone)]
@@ -127,6 +134,7 @@ pub struct UpdateChecker {
     pub github_owner: String,
     pub github_repo: String,
     pub event_tx: Option<mpsc::Sender<UpdateEvent>>,
+    pub precompile: Option<Precompile>,
 }
 
 impl UpdateChecker {
@@ -144,6 +152,7 @@ impl UpdateChecker {
             github_owner: github_owner.into(),
             github_repo: github_repo.into(),
             event_tx: None,
+            precompile: None,
         }
     }
 
@@ -152,6 +161,11 @@ impl UpdateChecker {
         self
     }
 
+    pub fn with_precompiler(mut self, precompile: Precompile) -> Self {
+        self.precompile = Some(precompile);
+        self
+    }
+
     /// Run the full check. Designed to be called from a background thread;
     /// never panics, swallows all I/O errors into `UpdateStatus.errors`.
     pub fn check_and_stage(&self) -> UpdateStatus {
@@ -188,6 +202,7 @@ impl UpdateChecker {
             &self.plugins_dir,
             &self.current_app_version,
             self.event_tx.as_ref(),
+            self.precompile,
             &mut status.errors,
         );
         status.plugin_updates = plugin_updates;
@@ -1,6 +1,6 @@
 //! Per-plugin update flow: read installed manifest, GET updateUrl, compare
-//! semver, download to staging, verify, test-load, atomic swap, emit
-//! HotReload event.
+//! semver, download to staging, verify, test-load, precompile, atomic swap,
+//! emit HotReload event.
 //!
 //! The flow is designed so the installed plugin stays untouched until the
 //! new entry has been (a) downloaded, (b) SHA-256 verified, and
@@ -11,8 +11,8 @@
 //! intact.
 
 use crate::{
-    PluginUpdate, PluginUpdateManifest, UpdateEvent, github::download_to, parse_version,
-    signature::verify_entry, staging_path,
+    PluginUpdate, PluginUpdateManifest, Precompile, UpdateEvent, github::download_to,
+    parse_version, signature::verify_entry, staging_path,
 };
 use serde::Deserialize;
 use std::path::Path;
@@ -56,6 +56,7 @@ pub fn check_all_plugin_updates(
     plugins_dir: &Path,
     current_app_version: &semver::Version,
     event_tx: Option<&mpsc::Sender<UpdateEvent>>,
+    precompile: Option<Precompile>,
     errors: &mut Vec<String>,
 ) -> Vec<PluginUpdate> {
     let Ok(entries) = std::fs::read_dir(plugins_dir) else {
@@ -78,7 +79,7 @@ pub fn check_all_plugin_updates(
             continue;
         }
 
-        match check_one(&plugin_dir, current_app_version, event_tx) {
+        match check_one(&plugin_dir, current_app_version, event_tx, precompile) {
             Ok(Some(update)) => results.push(update),
             Ok(None) => {}
             Err(e) => {
@@ -94,6 +95,7 @@ fn check_one(
     plugin_dir: &Path,
     current_app_version: &semver::Version,
     event_tx: Option<&mpsc::Sender<UpdateEvent>>,
+    precompile: Option<Precompile>,
 ) -> Result<Option<PluginUpdate>, String> {
     let manifest_path = plugin_dir.join("plugin.json");
     let data =
@@ -229,6 +231,16 @@ fn check_one(
         return Err(format!("test-load failed: {e}"));
     }
 
+    // Compile now, on this background thread, so the first launch after the swap
+    // maps a finished artifact instead of spending a second in Cranelift. Not
+    // fatal: the entry is already known good, and the app compiles it on first
+    // use if this did not.
+    if let Some(precompile) = precompile
+        && let Err(e) = precompile(&staged_entry)
+    {
+        tracing::warn!("plugin {}: precompile failed: {e}", installed.name);
+    }
+
     // Atomic swap: move <name>/ → <name>.old/, <name>.staging/ → <name>/,
     // delete <name>.old/. On any failure mid-rename we try to revert.
     let live = plugins_root.join(&installed.name);
@@ -295,7 +307,8 @@ fn fetch_manifest(
 /// Uses `wasmparser` rather than `wasmtime`: this only needs to know the bytes are a
 /// valid component, and validation is far cheaper than compiling one. The updater
 /// runs on a background thread and has no business spending a second in Cranelift
-/// to answer a yes/no question. The app compiles it later, once, and caches it.
+/// to answer a yes/no question. Compiling is the app's [`Precompile`] hook's job,
+/// since only the app knows the engine configuration it has to match.
 fn test_load(entry: &Path) -> Result<(), String> {
     let bytes = std::fs::read(entry).map_err(|e| format!("read staged entry: {e}"))?;
     if bytes.is_empty() {
@@ -393,6 +406,7 @@ mod tests {
             plugins.path(),
             &semver::Version::new(0, 1, 0),
             None,
+            None,
             &mut errors,
         );
         assert!(results.is_empty());
@@ -430,6 +444,7 @@ mod tests {
                 plugins.path(),
                 &semver::Version::new(0, 1, 0),
                 None,
+                None,
                 &mut errors,
             );
             (r, errors)
@@ -504,6 +519,14 @@ mod tests {
             .mount(&server)
             .await;
 
+        // The precompiler sees the staged entry, and its failure does not hold the
+        // update back: the app compiles on first use instead.
+        static PRECOMPILED: std::sync::Mutex<Vec<PathBuf>> = std::sync::Mutex::new(Vec::new());
+        fn failing_precompile(entry: &Path) -> Result<(), String> {
+            PRECOMPILED.lock().unwrap().push(entry.to_path_buf());
+            Err("no engine in this test".to_owned())
+        }
+
         let (tx, rx) = mpsc::channel();
         let (results, errors) = tokio::task::block_in_place(|| {
             let mut errors = Vec::new();
@@ -511,11 +534,16 @@ mod tests {
                 plugins.path(),
                 &semver::Version::new(0, 1, 0),
                 Some(&tx),
+                Some(failing_precompile),
                 &mut errors,
             );
             (r, errors)
         });
         assert!(errors.is_empty(), "expected no errors, got: {:?}", errors);
+        assert_eq!(
+            *PRECOMPILED.lock().unwrap(),
+            [staging_path(plugins.path(), "foo").join("p.wasm")]
+        );
         assert_eq!(results.len(), 1);
         assert_eq!(results[0].plugin_name, "foo");
         assert_eq!(results[0].new_version, semver::Version::new(1, 0, 1));
@@ -599,6 +627,7 @@ mod tests {
                 plugins.path(),
                 &semver::Version::new(0, 1, 0),
                 None,
+                None,
                 &mut errors,
             );
             (r, errors)
@@ -643,6 +672,7 @@ mod tests {
                 plugins.path(),
                 &semver::Version::new(0, 1, 0),
                 None,
+                None,
                 &mut errors,
             );
             (r, errors)
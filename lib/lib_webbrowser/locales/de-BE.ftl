@@ -21,3 +21,9 @@ webbrowser-bookmark-marker = [Lesezeichen]
 webbrowser-bookmark-added = { $url } als Lesezeichen gespeichert
 webbrowser-bookmark-removed = Lesezeichen für { $url } entfernt
 webbrowser-bookmark-nothing = Keine Seite zum Speichern als Lesezeichen
+
+# A history row or bookmark opened from the offline archive. These lead the
+# saved copy, so the reader knows it is not the live page.
+webbrowser-archived-copy = Gespeicherte Kopie. Aktualisieren, um die Live-Seite zu laden.
+webbrowser-archived-forms = Die Formulare funktionieren nach dem Aktualisieren wieder.
+webbrowser-archived-images = Mit der Seite gespeicherte Bilder
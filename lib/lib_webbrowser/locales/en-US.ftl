@@ -21,3 +21,9 @@ webbrowser-bookmark-marker = [bookmark]
 webbrowser-bookmark-added = Bookmarked { $url }
 webbrowser-bookmark-removed = Bookmark removed from { $url }
 webbrowser-bookmark-nothing = No page to bookmark
+
+# A history row or bookmark opened from the offline archive. These lead the
+# saved copy, so the reader knows it is not the live page.
+webbrowser-archived-copy = Saved copy. Refresh to load the live page.
+webbrowser-archived-forms = Its forms work again after a refresh.
+webbrowser-archived-images = Images saved with the page
@@ -21,3 +21,9 @@ webbrowser-bookmark-marker = [favori]
 webbrowser-bookmark-added = { $url } ajouté aux favoris
 webbrowser-bookmark-removed = Favori supprimé pour { $url }
 webbrowser-bookmark-nothing = Aucune page à ajouter aux favoris
+
+# A history row or bookmark opened from the offline archive. These lead the
+# saved copy, so the reader knows it is not the live page.
+webbrowser-archived-copy = Copie enregistrée. Actualisez pour charger la page en ligne.
+webbrowser-archived-forms = Ses formulaires fonctionnent à nouveau après une actualisation.
+webbrowser-archived-images = Images enregistrées avec la page
@@ -21,3 +21,9 @@ webbrowser-bookmark-marker = [bladwijzer]
 webbrowser-bookmark-added = { $url } opgeslagen als bladwijzer
 webbrowser-bookmark-removed = Bladwijzer verwijderd van { $url }
 webbrowser-bookmark-nothing = Geen pagina om als bladwijzer op te slaan
+
+# A history row or bookmark opened from the offline archive. These lead the
+# saved copy, so the reader knows it is not the live page.
+webbrowser-archived-copy = Bewaarde kopie. Vernieuw om de live pagina te laden.
+webbrowser-archived-forms = De formulieren werken weer na het vernieuwen.
+webbrowser-archived-images = Afbeeldingen bewaard met de pagina
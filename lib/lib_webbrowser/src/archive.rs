@@ -0,0 +1,697 @@
+//! Offline copies of the pages the user has visited, so a history row or a
+//! bookmark opens at once, and opens at all without a network.
+//!
+//! Not the page cache. That one answers "can this render be reused instead of
+//! going through Chrome", is keyed on freshness and is wiped with the cookies.
+//! This one answers "what did that page say when I last read it": a snapshot is
+//! kept however old it is, until the archive runs out of room, and it is shown
+//! labelled as a saved copy rather than passed off as the live page. Pages
+//! are kept as the user saw them, signed in or not, so `clear cookies` empties
+//! the archive along with the cache; only the bookmark pins stay.
+//!
+//! A snapshot is the finished FFON tree, deflated, plus the page's outbound
+//! links and the images it carried inline as `data:` URIs. Images are stored
+//! once per content hash and shared between every snapshot that has them —
+//! site logos and icon sprites repeat on every page of a site. Opening a
+//! snapshot writes its images out as files beside the DB, once each, so the
+//! saved copy can list them as `<image>` lines.
+//!
+//! The form map is not kept. Its selectors point into the document of a live
+//! tab, and a saved copy has none; whether the page had forms is recorded, so
+//! the copy can say that a refresh makes them usable again.
+//!
+//! The archive is capped by size (`webArchiveSizeMb`). Past it, snapshots go
+//! least recently opened first, bookmarked pages after every other; images no
+//! snapshot refers to any more go with them, files and all.
+//!
+//! Process-global for the same reason the page cache is.
+//!
+//! DB location: platform state dir + `/sicompass/webbrowser/archive.db`, and
+//! the image files in `archive-images/` next to it.
+
+use rusqlite::{Connection, OptionalExtension, params};
+use sha2::{Digest, Sha256};
+use sicompass_sdk::ffon::{self, FfonElement};
+use std::collections::HashSet;
+use std::io::{Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Mutex, OnceLock};
+
+/// Default cap, in MiB. The manifest's default for `webArchiveSizeMb`.
+const DEFAULT_SIZE_MB: u64 = 200;
+
+const MB: u64 = 1024 * 1024;
+
+/// Cap on the archive's size in bytes. 0 turns archiving off.
+static CAP_BYTES: AtomicU64 = AtomicU64::new(DEFAULT_SIZE_MB * MB);
+
+/// URL plus whether hidden content was pruned, as in the page cache.
+type Key = (String, bool);
+
+/// A saved page, as it comes back out.
+pub(crate) struct Snapshot {
+    pub elements: Vec<FfonElement>,
+    /// Read for prefetch, which Windows has none of.
+    #[cfg_attr(target_os = "windows", allow(dead_code))]
+    pub links: Vec<String>,
+    pub has_forms: bool,
+    /// Paths of its inline images, in document order.
+    pub images: Vec<String>,
+}
+
+fn now_secs() -> u64 {
+    std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0)
+}
+
+fn deflate(data: &[u8]) -> Vec<u8> {
+    let mut encoder =
+        flate2::write::DeflateEncoder::new(Vec::new(), flate2::Compression::default());
+    // Writing into a Vec cannot fail.
+    let _ = encoder.write_all(data);
+    encoder.finish().unwrap_or_default()
+}
+
+fn inflate(data: &[u8]) -> Option<Vec<u8>> {
+    let mut out = Vec::new();
+    flate2::read::DeflateDecoder::new(data)
+        .read_to_end(&mut out)
+        .ok()?;
+    Some(out)
+}
+
+/// Every image `html` carries inline as a base64 `data:` URI, as its MIME type
+/// and decoded bytes, in document order. That covers `src`, `srcset` and
+/// inline-style `url(...)` alike, since each is just the URI in the text.
+/// A URI that is not base64 (`data:image/svg+xml;utf8,...`) or does not decode
+/// is skipped.
+fn inline_images(html: &str) -> Vec<(String, Vec<u8>)> {
+    use base64::Engine as _;
+    const MARK: &str = "data:image/";
+    let mut images = Vec::new();
+    let mut rest = html;
+    while let Some(at) = rest.find(MARK) {
+        rest = &rest[at + MARK.len()..];
+        let Some((subtype, tail)) = rest.split_once(";base64,") else {
+            break;
+        };
+        if subtype.is_empty() || subtype.len() > 32 || subtype.contains(['"', '\'', ' ', '>', ','])
+        {
+            continue;
+        }
+        let end = tail
+            .find(|c: char| !(c.is_ascii_alphanumeric() || matches!(c, '+' | '/' | '=')))
+            .unwrap_or(tail.len());
+        if let Ok(data) = base64::engine::general_purpose::STANDARD.decode(&tail[..end])
+            && !data.is_empty()
+        {
+            images.push((format!("image/{subtype}"), data));
+        }
+        rest = &tail[end..];
+    }
+    images
+}
+
+/// The file an image is written to: its hash in hex, with an extension from
+/// its MIME type so the image loader knows the format.
+fn image_file_name(hash: &[u8], mime: &str) -> String {
+    let hex: String = hash.iter().map(|b| format!("{b:02x}")).collect();
+    let subtype = mime.trim_start_matches("image/");
+    let ext = subtype.split('+').next().unwrap_or(subtype);
+    format!("{hex}.{ext}")
+}
+
+pub(crate) struct Archive {
+    conn: Connection,
+    /// Where opened snapshots' images are written out.
+    image_dir: PathBuf,
+}
+
+impl Archive {
+    /// Open (or create) the archive at `path`.
+    ///
+    /// Returns `None` if the directory cannot be created or the DB cannot be
+    /// opened — pages are then simply not kept.
+    pub fn open(path: &Path) -> Option<Self> {
+        if let Some(parent) = path.parent() {
+            std::fs::create_dir_all(parent).ok()?;
+        }
+        let conn = Connection::open(path).ok()?;
+        let archive = Archive {
+            conn,
+            image_dir: path.with_file_name("archive-images"),
+        };
+        archive.init_schema().ok()?;
+        Some(archive)
+    }
+
+    fn init_schema(&self) -> rusqlite::Result<()> {
+        self.conn.execute_batch(
+            "CREATE TABLE IF NOT EXISTS snapshots (
+                url        TEXT    NOT NULL,
+                pruned     INTEGER NOT NULL,
+                saved_at   INTEGER NOT NULL,
+                opened_at  INTEGER NOT NULL,
+                has_forms  INTEGER NOT NULL,
+                tree       BLOB    NOT NULL,
+                links      TEXT    NOT NULL,
+                PRIMARY KEY (url, pruned)
+            );
+            CREATE TABLE IF NOT EXISTS images (
+                hash BLOB PRIMARY KEY,
+                mime TEXT NOT NULL,
+                data BLOB NOT NULL
+            );
+            CREATE TABLE IF NOT EXISTS snapshot_images (
+                url    TEXT    NOT NULL,
+                pruned INTEGER NOT NULL,
+                hash   BLOB    NOT NULL,
+                PRIMARY KEY (url, pruned, hash)
+            );
+            CREATE INDEX IF NOT EXISTS snapshot_images_hash ON snapshot_images(hash);
+            CREATE TABLE IF NOT EXISTS pins (url TEXT PRIMARY KEY);",
+        )
+    }
+
+    /// Write a snapshot of `key`, replacing any earlier one, with the inline
+    /// images of the `html` it was rendered from.
+    fn save(
+        &self,
+        key: &Key,
+        elements: &[FfonElement],
+        links: &[String],
+        has_forms: bool,
+        html: &str,
+        now: u64,
+    ) {
+        let Ok(tx) = self.conn.unchecked_transaction() else {
+            return;
+        };
+        let _ = tx.execute(
+            "INSERT OR REPLACE INTO snapshots
+                 (url, pruned, saved_at, opened_at, has_forms, tree, links)
+             VALUES (?1, ?2, ?3, ?3, ?4, ?5, ?6)",
+            params![
+                key.0,
+                key.1,
+                now as i64,
+                has_forms,
+                deflate(&ffon::serialize_binary(elements)),
+                links.join("\n"),
+            ],
+        );
+        let _ = tx.execute(
+            "DELETE FROM snapshot_images WHERE url = ?1 AND pruned = ?2",
+            params![key.0, key.1],
+        );
+        for (mime, data) in inline_images(html) {
+            let hash = Sha256::digest(&data).to_vec();
+            let _ = tx.execute(
+                "INSERT OR IGNORE INTO images (hash, mime, data) VALUES (?1, ?2, ?3)",
+                params![hash, mime, deflate(&data)],
+            );
+            let _ = tx.execute(
+                "INSERT OR IGNORE INTO snapshot_images (url, pruned, hash) VALUES (?1, ?2, ?3)",
+                params![key.0, key.1, hash],
+            );
+        }
+        // Images only the replaced snapshot had are left for `evict` to sweep.
+        let _ = tx.commit();
+    }
+
+    /// The snapshot of `key`, marking it opened at `now`.
+    fn load(&self, key: &Key, now: u64) -> Option<Snapshot> {
+        let (tree, links, has_forms) = self
+            .conn
+            .query_row(
+                "SELECT tree, links, has_forms FROM snapshots WHERE url = ?1 AND pruned = ?2",
+                params![key.0, key.1],
+                |row| {
+                    Ok((
+                        row.get::<_, Vec<u8>>(0)?,
+                        row.get::<_, String>(1)?,
+                        row.get::<_, bool>(2)?,
+                    ))
+                },
+            )
+            .optional()
+            .ok()
+            .flatten()?;
+        let elements = ffon::deserialize_binary(&inflate(&tree)?);
+        let _ = self.conn.execute(
+            "UPDATE snapshots SET opened_at = ?3 WHERE url = ?1 AND pruned = ?2",
+            params![key.0, key.1, now as i64],
+        );
+        Some(Snapshot {
+            elements,
+            links: links.lines().map(str::to_owned).collect(),
+            has_forms,
+            images: self.image_files(key),
+        })
+    }
+
+    /// The images stored with `key`'s snapshot, as hash, MIME type and bytes,
+    /// in document order.
+    fn images(&self, key: &Key) -> Vec<(Vec<u8>, String, Vec<u8>)> {
+        let Ok(mut stmt) = self.conn.prepare(
+            "SELECT i.hash, i.mime, i.data FROM images i
+             JOIN snapshot_images s ON s.hash = i.hash
+             WHERE s.url = ?1 AND s.pruned = ?2
+             ORDER BY s.rowid",
+        ) else {
+            return Vec::new();
+        };
+        stmt.query_map(params![key.0, key.1], |row| {
+            Ok((
+                row.get::<_, Vec<u8>>(0)?,
+                row.get::<_, String>(1)?,
+                row.get::<_, Vec<u8>>(2)?,
+            ))
+        })
+        .map(|rows| {
+            rows.filter_map(Result::ok)
+                .filter_map(|(hash, mime, data)| Some((hash, mime, inflate(&data)?)))
+                .collect()
+        })
+        .unwrap_or_default()
+    }
+
+    /// `key`'s images as files in the image dir, written the first time any
+    /// snapshot that has them is opened. One that cannot be written is left out.
+    fn image_files(&self, key: &Key) -> Vec<String> {
+        let images = self.images(key);
+        if images.is_empty() || std::fs::create_dir_all(&self.image_dir).is_err() {
+            return Vec::new();
+        }
+        images
+            .into_iter()
+            .filter_map(|(hash, mime, data)| {
+                let path = self.image_dir.join(image_file_name(&hash, &mime));
+                if !path.exists() {
+                    std::fs::write(&path, data).ok()?;
+                }
+                Some(path.to_string_lossy().into_owned())
+            })
+            .collect()
+    }
+
+    /// Bytes stored: snapshots and images, as compressed.
+    fn total_bytes(&self) -> u64 {
+        self.conn
+            .query_row(
+                "SELECT (SELECT COALESCE(SUM(length(tree) + length(links)), 0) FROM snapshots)
+                      + (SELECT COALESCE(SUM(length(data)), 0) FROM images)",
+                [],
+                |row| row.get::<_, i64>(0),
+            )
+            .map(|n| n as u64)
+            .unwrap_or(0)
+    }
+
+    /// Drop snapshots until the archive fits in `cap` bytes: least recently
+    /// opened first, pinned ones only once nothing else is left. `keep` — the
+    /// snapshot just saved — always stays, even when it alone is over the cap:
+    /// the page being read is the one copy certain to be wanted.
+    ///
+    /// Images left behind by replaced snapshots are swept first, and only
+    /// here: under the cap they cost nothing worth a scan on every save.
+    fn evict(&self, cap: u64, keep: &Key) {
+        if self.total_bytes() <= cap {
+            return;
+        }
+        self.remove_images(
+            "SELECT hash, mime, length(data) FROM images
+             WHERE hash NOT IN (SELECT hash FROM snapshot_images)",
+            [],
+        );
+        let mut total = self.total_bytes();
+        while total > cap {
+            let victim = self
+                .conn
+                .query_row(
+                    "SELECT url, pruned FROM snapshots
+                     WHERE NOT (url = ?1 AND pruned = ?2)
+                     ORDER BY url IN (SELECT url FROM pins), opened_at
+                     LIMIT 1",
+                    params![keep.0, keep.1],
+                    |row| Ok((row.get::<_, String>(0)?, row.get::<_, bool>(1)?)),
+                )
+                .optional()
+                .ok()
+                .flatten();
+            let Some(victim) = victim else {
+                return;
+            };
+            total = total.saturating_sub(self.remove(&victim));
+        }
+    }
+
+    /// Drop `key`'s snapshot and the images no other snapshot has, returning
+    /// the bytes freed.
+    fn remove(&self, key: &Key) -> u64 {
+        let snapshot_bytes = self
+            .conn
+            .query_row(
+                "SELECT length(tree) + length(links) FROM snapshots
+                 WHERE url = ?1 AND pruned = ?2",
+                params![key.0, key.1],
+                |row| row.get::<_, i64>(0),
+            )
+            .map(|n| n as u64)
+            .unwrap_or(0);
+        let image_bytes = self.remove_images(
+            "SELECT s.hash, i.mime, length(i.data) FROM snapshot_images s
+             JOIN images i ON i.hash = s.hash
+             WHERE s.url = ?1 AND s.pruned = ?2
+               AND NOT EXISTS (SELECT 1 FROM snapshot_images o
+                               WHERE o.hash = s.hash AND NOT (o.url = ?1 AND o.pruned = ?2))",
+            params![key.0, key.1],
+        );
+        let _ = self.conn.execute(
+            "DELETE FROM snapshots WHERE url = ?1 AND pruned = ?2",
+            params![key.0, key.1],
+        );
+        let _ = self.conn.execute(
+            "DELETE FROM snapshot_images WHERE url = ?1 AND pruned = ?2",
+            params![key.0, key.1],
+        );
+        snapshot_bytes + image_bytes
+    }
+
+    /// Drop every snapshot and every image, rows and files.  The pins stay:
+    /// they mirror the bookmarks, which are not being forgotten.
+    fn clear(&self) {
+        self.remove_images("SELECT hash, mime, length(data) FROM images", []);
+        let Ok(tx) = self.conn.unchecked_transaction() else {
+            return;
+        };
+        let _ = tx.execute("DELETE FROM snapshots", []);
+        let _ = tx.execute("DELETE FROM snapshot_images", []);
+        let _ = tx.commit();
+    }
+
+    /// Delete the images `select` names by hash, MIME type and stored size,
+    /// rows and files, returning the bytes freed.
+    fn remove_images(&self, select: &str, params: impl rusqlite::Params) -> u64 {
+        let doomed: Vec<(Vec<u8>, String, i64)> = self
+            .conn
+            .prepare(select)
+            .and_then(|mut stmt| {
+                stmt.query_map(params, |row| Ok((row.get(0)?, row.get(1)?, row.get(2)?)))?
+                    .collect()
+            })
+            .unwrap_or_default();
+        let mut freed = 0;
+        for (hash, mime, bytes) in doomed {
+            if let Ok(1) = self
+                .conn
+                .execute("DELETE FROM images WHERE hash = ?1", params![hash])
+            {
+                freed += bytes as u64;
+            }
+            let _ = std::fs::remove_file(self.image_dir.join(image_file_name(&hash, &mime)));
+        }
+        freed
+    }
+
+    /// Make `urls` the pinned set.
+    fn set_pins(&self, urls: &HashSet<String>) {
+        let Ok(tx) = self.conn.unchecked_transaction() else {
+            return;
+        };
+        let _ = tx.execute("DELETE FROM pins", []);
+        for url in urls {
+            let _ = tx.execute("INSERT OR IGNORE INTO pins (url) VALUES (?1)", params![url]);
+        }
+        let _ = tx.commit();
+    }
+}
+
+/// Where the archive lives, or `None` under test or without a state dir.
+fn store_path() -> Option<PathBuf> {
+    if crate::test_no_history() {
+        return None;
+    }
+    sicompass_sdk::platform::state_home()
+        .map(|s| s.join("sicompass").join("webbrowser").join("archive.db"))
+}
+
+#[derive(Default)]
+struct Shared {
+    archive: Option<Archive>,
+    opened: bool,
+}
+
+fn shared() -> &'static Mutex<Shared> {
+    static SHARED: OnceLock<Mutex<Shared>> = OnceLock::new();
+    SHARED.get_or_init(|| Mutex::new(Shared::default()))
+}
+
+/// Run `f` against the archive, opening it on first use.
+fn with_archive<R>(f: impl FnOnce(&Archive) -> R) -> Option<R> {
+    let mut shared = shared().lock().ok()?;
+    if !shared.opened {
+        shared.opened = true;
+        shared.archive = store_path().and_then(|p| Archive::open(&p));
+    }
+    shared.archive.as_ref().map(f)
+}
+
+/// Set the cap, in MiB. 0 stops new pages being saved; what is saved already
+/// stays readable.
+pub(crate) fn set_size_mb(mb: u64) {
+    CAP_BYTES.store(mb.saturating_mul(MB), Ordering::Release);
+}
+
+/// Save a rendered page, then evict down to the cap.
+pub(crate) fn store(
+    url: &str,
+    pruned: bool,
+    elements: &[FfonElement],
+    links: &[String],
+    html: &str,
+    has_forms: bool,
+) {
+    let cap = CAP_BYTES.load(Ordering::Acquire);
+    if cap == 0 {
+        return;
+    }
+    let key = (url.to_owned(), pruned);
+    with_archive(|a| {
+        a.save(&key, elements, links, has_forms, html, now_secs());
+        a.evict(cap, &key);
+    });
+}
+
+/// The saved copy of `url`, if there is one.
+pub(crate) fn open(url: &str, pruned: bool) -> Option<Snapshot> {
+    with_archive(|a| a.load(&(url.to_owned(), pruned), now_secs())).flatten()
+}
+
+/// Forget every saved page.
+pub(crate) fn clear() {
+    with_archive(Archive::clear);
+}
+
+/// Pin exactly the bookmarked pages.
+pub(crate) fn sync_pins(bookmarks: &HashSet<String>) {
+    with_archive(|a| a.set_pins(bookmarks));
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use sicompass_sdk::ffon::html_to_ffon_with_forms;
+
+    /// A 1×1 transparent PNG.
+    const PIXEL: &str = "iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAQAAAC1HAwCAAAAC0lEQVR42mNkYAAAAAYAAjCB0C8AAAAASUVORK5CYII=";
+
+    fn fixture(body: &str) -> String {
+        format!(
+            "<!DOCTYPE html><html><body><h1>Fixture</h1>\
+             <img src=\"data:image/png;base64,{PIXEL}\" alt=\"logo\">\
+             <p>{body}</p><a href=\"https://a.invalid/next\">Next</a>\
+             <div style=\"background:url(data:image/png;base64,{PIXEL})\"></div>\
+             </body></html>"
+        )
+    }
+
+    fn key(url: &str) -> Key {
+        (url.to_owned(), true)
+    }
+
+    fn save_fixture(archive: &Archive, url: &str, body: &str, now: u64) -> Vec<FfonElement> {
+        let html = fixture(body);
+        let (elements, forms) = html_to_ffon_with_forms(&html, url);
+        let links = vec!["https://a.invalid/next".to_owned()];
+        archive.save(&key(url), &elements, &links, !forms.is_empty(), &html, now);
+        elements
+    }
+
+    fn image_count(archive: &Archive) -> i64 {
+        archive
+            .conn
+            .query_row("SELECT COUNT(*) FROM images", [], |row| row.get(0))
+            .unwrap()
+    }
+
+    #[test]
+    fn a_snapshot_round_trips_with_its_links_and_images() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive = Archive::open(&dir.path().join("archive.db")).unwrap();
+        let elements = save_fixture(&archive, "https://a.invalid/", "Offline text", 10);
+
+        let snapshot = archive.load(&key("https://a.invalid/"), 20).unwrap();
+        assert_eq!(format!("{:?}", snapshot.elements), format!("{elements:?}"));
+        assert_eq!(snapshot.links, ["https://a.invalid/next"]);
+        assert!(!snapshot.has_forms);
+        // The same image twice on the page is stored once.
+        let images = archive.images(&key("https://a.invalid/"));
+        assert_eq!(images.len(), 1);
+        assert_eq!(images[0].1, "image/png");
+        assert!(images[0].2.starts_with(b"\x89PNG"));
+        // And it is there to show, as a file.
+        assert_eq!(snapshot.images.len(), 1);
+        assert!(snapshot.images[0].ends_with(".png"));
+        assert!(
+            std::fs::read(&snapshot.images[0])
+                .unwrap()
+                .starts_with(b"\x89PNG")
+        );
+        // The other rendering of the same URL is a separate snapshot.
+        assert!(
+            archive
+                .load(&("https://a.invalid/".to_owned(), false), 20)
+                .is_none()
+        );
+    }
+
+    #[test]
+    fn images_are_shared_between_snapshots_and_go_with_the_last() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive = Archive::open(&dir.path().join("archive.db")).unwrap();
+        save_fixture(&archive, "https://a.invalid/1", "One", 1);
+        save_fixture(&archive, "https://a.invalid/2", "Two", 2);
+        assert_eq!(image_count(&archive), 1);
+
+        let file = archive
+            .load(&key("https://a.invalid/1"), 3)
+            .unwrap()
+            .images
+            .remove(0);
+
+        archive.remove(&key("https://a.invalid/1"));
+        assert_eq!(image_count(&archive), 1, "still used by the second page");
+        assert!(Path::new(&file).exists());
+        archive.remove(&key("https://a.invalid/2"));
+        assert_eq!(image_count(&archive), 0);
+        assert!(!Path::new(&file).exists());
+    }
+
+    #[test]
+    fn clearing_drops_every_snapshot_and_image_file() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive = Archive::open(&dir.path().join("archive.db")).unwrap();
+        save_fixture(&archive, "https://a.invalid/1", "One", 1);
+        save_fixture(&archive, "https://a.invalid/2", "Two", 2);
+        archive.set_pins(&HashSet::from(["https://a.invalid/1".to_owned()]));
+        let file = archive
+            .load(&key("https://a.invalid/1"), 3)
+            .unwrap()
+            .images
+            .remove(0);
+
+        archive.clear();
+        assert!(archive.load(&key("https://a.invalid/1"), 4).is_none());
+        assert!(archive.load(&key("https://a.invalid/2"), 4).is_none());
+        assert_eq!(image_count(&archive), 0);
+        assert!(!Path::new(&file).exists());
+        assert_eq!(archive.total_bytes(), 0);
+    }
+
+    #[test]
+    fn eviction_goes_by_last_opened_and_spares_bookmarks() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive = Archive::open(&dir.path().join("archive.db")).unwrap();
+        // Incompressible text, so each snapshot is about the same size.
+        let noise = |seed: u64| -> String {
+            let mut x = seed.wrapping_mul(6364136223846793005).wrapping_add(1);
+            (0..4000)
+                .map(|_| {
+                    x = x
+                        .wrapping_mul(6364136223846793005)
+                        .wrapping_add(1442695040888963407);
+                    char::from(b'a' + (x >> 59) as u8 % 26)
+                })
+                .collect()
+        };
+        for i in 0..4u64 {
+            save_fixture(&archive, &format!("https://a.invalid/{i}"), &noise(i), i);
+        }
+        // Opening 1 makes 2 the least recently opened; pinning 0 spares it.
+        archive.load(&key("https://a.invalid/1"), 10).unwrap();
+        archive.set_pins(&HashSet::from(["https://a.invalid/0".to_owned()]));
+
+        // Room for three and a half pages: one has to go.
+        let per_page = archive.total_bytes() / 4;
+        archive.evict(per_page * 3 + per_page / 2, &key("https://a.invalid/3"));
+
+        let kept: Vec<bool> = (0..4)
+            .map(|i| {
+                archive
+                    .load(&key(&format!("https://a.invalid/{i}")), 20)
+                    .is_some()
+            })
+            .collect();
+        assert_eq!(kept, [true, true, false, true]);
+    }
+
+    #[test]
+    fn the_page_just_saved_survives_a_cap_it_exceeds_alone() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive = Archive::open(&dir.path().join("archive.db")).unwrap();
+        save_fixture(&archive, "https://a.invalid/old", "Old", 1);
+        save_fixture(&archive, "https://a.invalid/new", "New", 2);
+        archive.evict(1, &key("https://a.invalid/new"));
+        assert!(archive.load(&key("https://a.invalid/old"), 3).is_none());
+        assert!(archive.load(&key("https://a.invalid/new"), 3).is_some());
+        assert_eq!(image_count(&archive), 1, "the kept page's image stays");
+    }
+
+    #[test]
+    fn images_a_resave_dropped_are_swept_when_eviction_runs() {
+        let dir = tempfile::tempdir().unwrap();
+        let archive = Archive::open(&dir.path().join("archive.db")).unwrap();
+        save_fixture(&archive, "https://a.invalid/", "Before", 1);
+        let (elements, _) = html_to_ffon_with_forms("<p>After</p>", "https://a.invalid/");
+        archive.save(&key("https://a.invalid/"), &elements, &[], false, "", 2);
+        assert_eq!(image_count(&archive), 1, "left until eviction");
+
+        // Under the cap, eviction has nothing to do.
+        archive.evict(u64::MAX, &key("https://a.invalid/"));
+        assert_eq!(image_count(&archive), 1);
+        archive.evict(1, &key("https://a.invalid/"));
+        assert_eq!(image_count(&archive), 0);
+        assert!(archive.load(&key("https://a.invalid/"), 3).is_some());
+    }
+
+    #[test]
+    fn inline_images_are_lifted_out_of_the_html() {
+        let html = format!(
+            "<img src='data:image/png;base64,{PIXEL}'>\
+             <img src=\"data:image/svg+xml;utf8,<svg></svg>\">\
+             <img src='data:image/gif;base64,!!!'>\
+             <img src='https://a.invalid/x.png'>"
+        );
+        let images = inline_images(&html);
+        assert_eq!(images.len(), 1, "only the base64 image decodes");
+        assert_eq!(images[0].0, "image/png");
+    }
+}
@@ -0,0 +1,308 @@
+//! One warm Chrome, shared by every provider instance and every link the app
+//! follows.
+//!
+//! Before this, each browser tab's provider launched a Chrome of its own on its
+//! first navigation, and `fetch_url_to_ffon` launched and closed one for every
+//! link followed — a cold start each time, and the single longest operation in
+//! the app.  Now there is one process, launched on the first navigation in the
+//! process, and callers lease tabs from it.
+//!
+//! One process rather than several because the persistent profile dir admits
+//! exactly one (`SingletonLock`): a second Chrome on the same profile hands its
+//! command line to the first and exits.  What is pooled is therefore tabs.
+//! [`set_warm_tabs`] blank tabs, with the stealth script and viewport already
+//! applied, are kept open so a lease never waits on `Target.createTarget`.
+//! Each is its own window: a tab behind another in the same window is
+//! `visibilityState = hidden` in headed Chrome, which throttles the timers
+//! the settle waits depend on.
+//!
+//! Health and recycling:
+//!
+//! * an idle tab is pinged before it is handed out, and closed if it does not
+//!   answer; a browser that cannot open a tab is dropped and relaunched once;
+//! * after [`RECYCLE_AFTER`] navigations, or once a page has been seen using
+//!   more than [`HEAP_LIMIT`] of JS heap, the process is due for a restart.  It
+//!   happens at the next lease taken while no other lease is out, since closing
+//!   Chrome under a reader's tab would throw away the forms they are filling in.
+//!   The live session gives its tab back before each navigation when a restart
+//!   is due, which is what lets that moment arrive.
+//!
+//! Not on Windows: there the off-screen window would sit in the screen reader's
+//! UI Automation tree, so every load and submit launches and closes its own.
+
+use crate::{
+    BrowserSession, STEALTH_SCRIPT, chromium_runtime, launch_browser, set_desktop_viewport,
+};
+use chromiumoxide::Page;
+use chromiumoxide::cdp::browser_protocol::page::AddScriptToEvaluateOnNewDocumentParams;
+use std::sync::OnceLock;
+use std::sync::atomic::{AtomicBool, AtomicU32, AtomicUsize, Ordering};
+use tokio::time::{Duration, timeout};
+
+/// Navigations after which the process is restarted.
+pub(crate) const RECYCLE_AFTER: u32 = 200;
+
+/// JS heap one page may use before the process is restarted.
+pub(crate) const HEAP_LIMIT: f64 = 512.0 * 1024.0 * 1024.0;
+
+/// Blank tabs kept ready.  `webWarmTabs`.
+static WARM_TABS: AtomicUsize = AtomicUsize::new(1);
+
+/// Leases not yet given back.
+static LEASES: AtomicUsize = AtomicUsize::new(0);
+
+/// Navigations in the current process.
+static NAVIGATIONS: AtomicU32 = AtomicU32::new(0);
+
+/// A page in the current process went over [`HEAP_LIMIT`].
+static OVER_HEAP: AtomicBool = AtomicBool::new(false);
+
+/// Chrome processes started, ever.  Read by the reuse test.
+static LAUNCHES: AtomicU32 = AtomicU32::new(0);
+
+#[derive(Default)]
+struct Pool {
+    browser: Option<BrowserSession>,
+    /// Bumped on every launch, so a tab from a process that has since been
+    /// closed is recognised when it is handed back.
+    generation: u64,
+    idle: Vec<Page>,
+}
+
+fn pool() -> &'static tokio::sync::Mutex<Pool> {
+    static POOL: OnceLock<tokio::sync::Mutex<Pool>> = OnceLock::new();
+    POOL.get_or_init(|| tokio::sync::Mutex::new(Pool::default()))
+}
+
+/// A tab on loan from the pool.  Give it back with [`release`]; dropping it
+/// instead closes the tab, which is right for one whose page failed.
+pub(crate) struct PooledTab {
+    page: Option<Page>,
+    generation: u64,
+}
+
+impl PooledTab {
+    pub(crate) fn page(&self) -> &Page {
+        self.page.as_ref().expect("present until released")
+    }
+}
+
+impl Drop for PooledTab {
+    fn drop(&mut self) {
+        if let Some(page) = self.page.take() {
+            LEASES.fetch_sub(1, Ordering::AcqRel);
+            chromium_runtime().spawn(async move {
+                let _ = timeout(Duration::from_secs(3), page.close()).await;
+            });
+        }
+    }
+}
+
+/// Set the number of warm tabs.  Takes effect as tabs are leased and returned.
+pub(crate) fn set_warm_tabs(n: usize) {
+    WARM_TABS.store(n, Ordering::Release);
+}
+
+/// Chrome processes started so far.
+#[cfg(test)]
+pub(crate) fn launches() -> u32 {
+    LAUNCHES.load(Ordering::Acquire)
+}
+
+/// Whether the process should be restarted at the next chance.
+pub(crate) fn due_for_recycle() -> bool {
+    NAVIGATIONS.load(Ordering::Acquire) >= RECYCLE_AFTER || OVER_HEAP.load(Ordering::Acquire)
+}
+
+impl Pool {
+    async fn launch(&mut self) -> Result<(), String> {
+        self.browser = Some(launch_browser().await?);
+        self.generation += 1;
+        NAVIGATIONS.store(0, Ordering::Release);
+        OVER_HEAP.store(false, Ordering::Release);
+        LAUNCHES.fetch_add(1, Ordering::AcqRel);
+        Ok(())
+    }
+
+    /// Close the process.  Idle tabs go with it; leased ones are recognised by
+    /// their generation when they come back.
+    async fn shut_down(&mut self) {
+        self.idle.clear();
+        if let Some(session) = self.browser.take() {
+            use chromiumoxide::cdp::browser_protocol::browser::CloseParams;
+            let _ = timeout(
+                Duration::from_millis(500),
+                session.browser.execute(CloseParams::default()),
+            )
+            .await;
+        }
+    }
+
+    fn lease(&self, page: Page) -> PooledTab {
+        LEASES.fetch_add(1, Ordering::AcqRel);
+        PooledTab {
+            page: Some(page),
+            generation: self.generation,
+        }
+    }
+
+    /// A new blank tab, launching the process first if there is none.  A
+    /// process that will not open a tab is assumed dead and relaunched once.
+    async fn open_tab(&mut self) -> Result<Page, String> {
+        if self.browser.is_none() {
+            self.launch().await?;
+        }
+        let session = self.browser.as_ref().expect("launched above");
+        match new_tab(session).await {
+            Ok(page) => Ok(page),
+            Err(_) => {
+                self.shut_down().await;
+                self.launch().await?;
+                new_tab(self.browser.as_ref().expect("launched above")).await
+            }
+        }
+    }
+
+    /// Top the idle list back up to the configured count.  Best effort.
+    async fn refill(&mut self) {
+        while self.idle.len() < WARM_TABS.load(Ordering::Acquire) {
+            let Some(session) = &self.browser else {
+                return;
+            };
+            match new_tab(session).await {
+                Ok(page) => self.idle.push(page),
+                Err(_) => return,
+            }
+        }
+    }
+}
+
+/// Open a blank tab in a window of its own, ready for a navigation.
+async fn new_tab(session: &BrowserSession) -> Result<Page, String> {
+    use chromiumoxide::cdp::browser_protocol::target::CreateTargetParams;
+    let t = Duration::from_secs;
+    let mut params = CreateTargetParams::new("about:blank");
+    params.new_window = Some(true);
+    let page = timeout(t(15), session.browser.new_page(params))
+        .await
+        .map_err(|_| "Chrome took >15 s to open a tab".to_owned())?
+        .map_err(|e| format!("failed to open tab: {e}"))?;
+    timeout(
+        t(10),
+        page.execute(AddScriptToEvaluateOnNewDocumentParams::new(STEALTH_SCRIPT)),
+    )
+    .await
+    .map_err(|_| "stealth script injection timed out".to_owned())?
+    .map_err(|e| format!("stealth script injection failed: {e}"))?;
+    set_desktop_viewport(&page).await;
+    Ok(page)
+}
+
+/// Whether an idle tab still answers.
+async fn is_healthy(page: &Page) -> bool {
+    matches!(
+        timeout(Duration::from_secs(2), page.evaluate("1")).await,
+        Ok(Ok(_))
+    )
+}
+
+/// Lease a tab, launching Chrome if this is the first one.
+pub(crate) async fn checkout() -> Result<PooledTab, String> {
+    let mut pool = pool().lock().await;
+    if due_for_recycle() && LEASES.load(Ordering::Acquire) == 0 {
+        pool.shut_down().await;
+    }
+    let page = loop {
+        let Some(page) = pool.idle.pop() else {
+            break pool.open_tab().await?;
+        };
+        if is_healthy(&page).await {
+            break page;
+        }
+        // Dropping the handle would leave its target open in Chrome. Closed
+        // behind the lease, since a tab that did not answer may not now.
+        chromium_runtime().spawn(async move {
+            let _ = timeout(Duration::from_secs(3), page.close()).await;
+        });
+    };
+    let tab = pool.lease(page);
+    drop(pool);
+    // The lease is handed out first; the tab that replaces it is opened
+    // behind the caller's navigation rather than in front of it.
+    chromium_runtime().spawn(async {
+        pool().lock().await.refill().await;
+    });
+    Ok(tab)
+}
+
+/// Give a tab back.  It is blanked and kept warm if the pool wants it and its
+/// process is still the current one, and closed otherwise.
+pub(crate) async fn release(mut tab: PooledTab) {
+    let Some(page) = tab.page.take() else {
+        return;
+    };
+    LEASES.fetch_sub(1, Ordering::AcqRel);
+    let mut pool = pool().lock().await;
+    let wanted = tab.generation == pool.generation
+        && pool.browser.is_some()
+        && pool.idle.len() < WARM_TABS.load(Ordering::Acquire)
+        && !due_for_recycle();
+    if wanted
+        && matches!(
+            timeout(Duration::from_secs(5), page.goto("about:blank")).await,
+            Ok(Ok(_))
+        )
+    {
+        pool.idle.push(page);
+        return;
+    }
+    drop(pool);
+    let _ = timeout(Duration::from_secs(3), page.close()).await;
+}
+
+/// Close Chrome if nothing is leased.  The provider's cleanup calls this, so
+/// the process goes away with the last browser tab rather than with the app.
+pub(crate) async fn shut_down_if_unused() {
+    let mut pool = pool().lock().await;
+    if LEASES.load(Ordering::Acquire) == 0 {
+        pool.shut_down().await;
+    }
+}
+
+/// Count a finished navigation in `page` and note whether its heap is over
+/// the limit.
+pub(crate) async fn after_navigation(page: &Page) {
+    NAVIGATIONS.fetch_add(1, Ordering::AcqRel);
+    let heap = timeout(
+        Duration::from_secs(2),
+        page.evaluate("(performance.memory && performance.memory.usedJSHeapSize) || 0"),
+    )
+    .await
+    .ok()
+    .and_then(|r| r.ok())
+    .and_then(|v| v.into_value::<f64>().ok())
+    .unwrap_or(0.0);
+    if heap > HEAP_LIMIT {
+        OVER_HEAP.store(true, Ordering::Release);
+    }
+}
+
+/// Clear every cookie through the running Chrome.  `None` when none is
+/// running, in which case the caller clears the on-disk store instead.
+pub(crate) async fn clear_cookies() -> Option<bool> {
+    use chromiumoxide::cdp::browser_protocol::network::ClearBrowserCookiesParams;
+    if pool().lock().await.browser.is_none() {
+        return None;
+    }
+    let tab = checkout().await.ok()?;
+    let cleared = matches!(
+        timeout(
+            Duration::from_secs(5),
+            tab.page().execute(ClearBrowserCookiesParams::default()),
+        )
+        .await,
+        Ok(Ok(_))
+    );
+    release(tab).await;
+    Some(cleared)
+}
@@ -33,6 +33,7 @@
 //! ```
 
 use chromiumoxide::browser::{Browser, BrowserConfig};
+#[cfg(target_os = "windows")]
 use chromiumoxide::cdp::browser_protocol::page::AddScriptToEvaluateOnNewDocumentParams;
 use futures::StreamExt as _;
 use sicompass_sdk::ffon::{FfonElement, FormMap, FormNodeKind};
@@ -59,6 +60,14 @@ use std::sync::atomic::AtomicBool;
 use std::sync::atomic::Ordering;
 use std::sync::{Arc, Mutex};
 
+mod archive;
+#[cfg(not(target_os = "windows"))]
+mod chrome_pool;
+mod page_cache;
+mod streaming;
+
+use streaming::BandConverter;
+
 // ---------------------------------------------------------------------------
 // Test stub: skip Chrome launches entirely.
 //
@@ -98,6 +107,8 @@ fn test_no_launch() -> bool {
 // someone's real browser history with `a.invalid` and friends. That happened.
 // The per-instance override still wins over this (`resolve_url_history_path`
 // checks it first), so the tempdir-backed history tests are unaffected.
+//
+// The page cache's on-disk tier is behind the same switch, for the same reason.
 // ---------------------------------------------------------------------------
 
 static TEST_NO_HISTORY: AtomicBool = AtomicBool::new(cfg!(test));
@@ -156,6 +167,12 @@ struct CachedPage {
 /// Hand-off slot: a background load or submit task fills it, `tick` drains it.
 type ReadySlot = Arc<Mutex<Option<(Vec<FfonElement>, FormMap)>>>;
 
+/// The first paint of a page still loading, with the URL it is for.  No form
+/// map: form numbers can still shift as the page loads, so its forms become
+/// operable when the settled page replaces it.
+#[cfg(not(target_os = "windows"))]
+type EarlySlot = Arc<Mutex<Option<(String, Vec<FfonElement>)>>>;
+
 // ---------------------------------------------------------------------------
 // Live page session — kept alive for form interaction
 //
@@ -167,10 +184,20 @@ type ReadySlot = Arc<Mutex<Option<(Vec<FfonElement>, FormMap)>>>;
 
 #[cfg(not(target_os = "windows"))]
 struct LivePageSession {
-    session: BrowserSession,
+    // The lease on the shared Chrome's tab; `page` is that same tab, cloned
+    // out so callers need not go through the lease.
+    tab: chrome_pool::PooledTab,
     page: chromiumoxide::Page,
 }
 
+#[cfg(not(target_os = "windows"))]
+impl LivePageSession {
+    /// Hand the tab back to the pool, warm, for the next navigation anywhere.
+    async fn release(self) {
+        chrome_pool::release(self.tab).await;
+    }
+}
+
 // ---------------------------------------------------------------------------
 // WebbrowserProvider
 // ---------------------------------------------------------------------------
@@ -199,6 +226,16 @@ pub struct WebbrowserProvider {
     pending_url: Arc<Mutex<Option<String>>>,
     // Background thread delivers refreshed content here after form submission.
     ready_content: ReadySlot,
+    // A load's DOMContentLoaded snapshot, shown while the rest settles.
+    // `showing_early` is what lets `fetch` show it instead of "Loading…".
+    #[cfg(not(target_os = "windows"))]
+    early_content: EarlySlot,
+    #[cfg(not(target_os = "windows"))]
+    showing_early: bool,
+    // The bands of the last page rendered, so its settled snapshot and a
+    // refresh reconvert only what changed. Shared with the load task.
+    #[cfg(not(target_os = "windows"))]
+    bands: Arc<Mutex<BandConverter>>,
     // Typed form values, replayed into a fresh Chrome at submit time.  Source
     // of truth for what the user has filled in between page-load and submit.
     // Cleared on URL navigation and after a successful submit-response render.
@@ -245,6 +282,11 @@ pub struct WebbrowserProvider {
     url_history_loaded: bool,
     // Per-instance path override for the in-crate tests.
     url_history_path: Option<std::path::PathBuf>,
+    // `webPrefetchLinks`: after a page lands, render its first few links in
+    // pooled tabs so following one is served from the page cache. Off by
+    // default — it fetches pages the user has not asked for.
+    #[cfg(not(target_os = "windows"))]
+    prefetch_links: bool,
 }
 
 impl WebbrowserProvider {
@@ -262,6 +304,12 @@ impl WebbrowserProvider {
             cached_page: None,
             form_map: FormMap::new(),
             ready_content: Arc::new(Mutex::new(None)),
+            #[cfg(not(target_os = "windows"))]
+            early_content: Arc::new(Mutex::new(None)),
+            #[cfg(not(target_os = "windows"))]
+            showing_early: false,
+            #[cfg(not(target_os = "windows"))]
+            bands: Arc::new(Mutex::new(BandConverter::default())),
             form_field_values: HashMap::new(),
             pending_error: Arc::new(Mutex::new(None)),
             #[cfg(target_os = "windows")]
@@ -273,6 +321,8 @@ impl WebbrowserProvider {
             url_history_size: 50_000,
             url_history_loaded: false,
             url_history_path: None,
+            #[cfg(not(target_os = "windows"))]
+            prefetch_links: false,
         }
     }
 
@@ -324,6 +374,26 @@ impl WebbrowserProvider {
             return;
         }
 
+        // Back/forward and history rows: a page rendered moments ago comes
+        // straight from memory, without a round trip through the runtime. Not
+        // while a load is running: it would publish over this page when it
+        // lands. A URL queued behind it still goes through the cache, on the
+        // task.
+        #[cfg(not(target_os = "windows"))]
+        let idle = !self.load_inflight.load(Ordering::Acquire);
+        #[cfg(target_os = "windows")]
+        let idle = true;
+        if idle && let Some(elements) = page_cache::peek(url, prune_hidden(), false) {
+            self.cached_page = Some(CachedPage {
+                url: url.to_owned(),
+                elements,
+            });
+            self.form_map = FormMap::new();
+            self.current_url = url.to_owned();
+            self.content_landed();
+            return;
+        }
+
         // Non-Windows: hand the whole load to the runtime. Launching Chrome and
         // navigating can take seconds, and doing it here froze the frame for
         // the duration — SDL events went unpolled, AT-SPI went unserviced, and
@@ -333,6 +403,8 @@ impl WebbrowserProvider {
         #[cfg(not(target_os = "windows"))]
         {
             self.current_url = url.to_owned();
+            // Back to "Loading…" until this URL has something to show.
+            self.showing_early = false;
 
             if self.load_inflight.swap(true, Ordering::AcqRel) {
                 // A load is already running. Hand it the new destination rather
@@ -346,9 +418,12 @@ impl WebbrowserProvider {
 
             let live = Arc::clone(&self.live);
             let ready = Arc::clone(&self.ready_content);
+            let early = Arc::clone(&self.early_content);
+            let bands = Arc::clone(&self.bands);
             let errors = Arc::clone(&self.pending_error);
             let inflight = Arc::clone(&self.load_inflight);
             let pending = Arc::clone(&self.pending_url);
+            let prefetch = self.prefetch_links;
             let mut target = url.to_owned();
 
             chromium_runtime().spawn(async move {
@@ -357,7 +432,10 @@ impl WebbrowserProvider {
                 // chain, so `fetch` keeps showing "Loading…" and no second task
                 // is ever spawned alongside this one.
                 loop {
-                    navigate_once(&live, &ready, &errors, &pending, &target).await;
+                    navigate_once(
+                        &live, &bands, &ready, &early, &errors, &pending, &target, prefetch,
+                    )
+                    .await;
                     match next_target(&inflight, &pending) {
                         Some(next) => target = next,
                         None => return,
@@ -368,6 +446,21 @@ impl WebbrowserProvider {
             return;
         }
 
+        // Windows: the disk tier, revalidated if stale, before a cold launch.
+        #[cfg(target_os = "windows")]
+        if let Some(elements) =
+            chromium_runtime().block_on(page_cache::lookup(url, prune_hidden(), false))
+        {
+            self.cached_page = Some(CachedPage {
+                url: url.to_owned(),
+                elements,
+            });
+            self.form_map = FormMap::new();
+            self.current_url = url.to_owned();
+            self.content_landed();
+            return;
+        }
+
         #[cfg(target_os = "windows")]
         let result = chromium_runtime().block_on(fetch_html_once(url));
 
@@ -376,6 +469,7 @@ impl WebbrowserProvider {
             match result {
                 Ok(load) => {
                     let (elements, form_map) = page_to_ffon_with_forms(&load, url);
+                    keep_page(url, &load, &elements, &form_map);
                     self.cached_page = Some(CachedPage {
                         url: url.to_owned(),
                         elements,
@@ -383,9 +477,17 @@ impl WebbrowserProvider {
                     self.form_map = form_map;
                 }
                 Err(e) => {
+                    let msg = format!("Error loading {url}: {e}");
+                    let elements = match archive::open(url, prune_hidden()) {
+                        Some(snapshot) => {
+                            set_error(&self.pending_error, msg);
+                            archived_page(snapshot)
+                        }
+                        None => vec![FfonElement::new_str(msg)],
+                    };
                     self.cached_page = Some(CachedPage {
                         url: url.to_owned(),
-                        elements: vec![FfonElement::new_str(format!("Error loading {url}: {e}"))],
+                        elements,
                     });
                     self.form_map = FormMap::new();
                 }
@@ -395,6 +497,51 @@ impl WebbrowserProvider {
         }
     }
 
+    /// Show the archive's copy of `url`, if it has one. Returns whether it did.
+    ///
+    /// Not while a load is running, which would publish over it when it lands
+    /// — the same rule as the memory-cache path in `load_url`, which is also
+    /// preferred when it has the page: a fresh render beats a saved copy.
+    ///
+    /// With prefetch on, the links the copy recorded are warmed in the
+    /// background, so following one from it is as quick as from a live page.
+    fn open_archived(&mut self, url: &str) -> bool {
+        #[cfg(not(target_os = "windows"))]
+        if self.load_inflight.load(Ordering::Acquire) {
+            return false;
+        }
+        // Under the launch stub a history row gets the stub's placeholder page,
+        // whatever an earlier run left in the archive.
+        if test_no_launch() || page_cache::peek(url, prune_hidden(), false).is_some() {
+            return false;
+        }
+        let Some(snapshot) = archive::open(url, prune_hidden()) else {
+            return false;
+        };
+        #[cfg(not(target_os = "windows"))]
+        if self.prefetch_links {
+            queue_prefetch(uncached_links(snapshot.links.clone()));
+        }
+        self.show_archived(url, snapshot);
+        true
+    }
+
+    fn show_archived(&mut self, url: &str, snapshot: archive::Snapshot) {
+        self.form_field_values.clear();
+        self.pending_enter_content = true;
+        #[cfg(not(target_os = "windows"))]
+        {
+            self.showing_early = false;
+        }
+        self.cached_page = Some(CachedPage {
+            url: url.to_owned(),
+            elements: archived_page(snapshot),
+        });
+        self.form_map = FormMap::new();
+        self.current_url = url.to_owned();
+        self.content_landed();
+    }
+
     /// A page the user navigated to is now readable: turn the armed
     /// "enter the content" intent into a request for the app to act on.
     fn content_landed(&mut self) {
@@ -511,6 +658,7 @@ impl WebbrowserProvider {
         self.url_history = lines;
         self.bookmarks = bookmarks;
         self.trim_url_history();
+        archive::sync_pins(&self.bookmarks);
     }
 
     /// Drop the oldest entries past the cap. The list is newest-first, so that
@@ -689,6 +837,9 @@ impl WebbrowserProvider {
             None => !self.bookmarks.contains(url),
         };
         self.merge_and_save(url, false, Some(on));
+        // The whole set rather than this one flag: the merge just picked up
+        // whatever other tabs changed too.
+        archive::sync_pins(&self.bookmarks);
         on
     }
 
@@ -830,7 +981,7 @@ impl Provider for WebbrowserProvider {
         // the previous page is worth dropping the user into. The descent is
         // asked for through `take_navigation_request` once the page lands.
         #[cfg(not(target_os = "windows"))]
-        if self.load_inflight.load(Ordering::Acquire) {
+        if self.load_inflight.load(Ordering::Acquire) && !self.showing_early {
             result.push(FfonElement::new_str(url_bar));
             result.push(FfonElement::new_str("Loading…".to_owned()));
             // History stays put while loading. Dropping it here would shrink
@@ -928,10 +1079,15 @@ impl Provider for WebbrowserProvider {
         // Matched by membership rather than by shape, so a button the *page*
         // happens to carry can never be mistaken for a history row and
         // navigate the tab out from under the user.
+        //
+        // A page saved to the archive opens from there at once, labelled as a
+        // saved copy; the refresh command fetches the live page over it.
         if self.url_history.iter().any(|u| u == function_name) {
             let url = function_name.to_owned();
             self.record_url_history(&url);
-            self.load_url(&url);
+            if !self.open_archived(&url) {
+                self.load_url(&url);
+            }
             return;
         }
 
@@ -1024,6 +1180,14 @@ impl Provider for WebbrowserProvider {
     fn tick(&mut self) -> bool {
         let content = self.ready_content.lock().ok().and_then(|mut g| g.take());
         if let Some((elements, form_map)) = content {
+            // Whatever first paint is still waiting was overtaken by this.
+            #[cfg(not(target_os = "windows"))]
+            {
+                if let Ok(mut g) = self.early_content.lock() {
+                    *g = None;
+                }
+                self.showing_early = false;
+            }
             self.cached_page = Some(CachedPage {
                 url: self.current_url.clone(),
                 elements,
@@ -1036,6 +1200,18 @@ impl Provider for WebbrowserProvider {
             self.content_landed();
             return true;
         }
+        // The page still loading has a first paint. The URL check drops one
+        // that lands after the user has already moved on.
+        #[cfg(not(target_os = "windows"))]
+        if let Some((url, elements)) = self.early_content.lock().ok().and_then(|mut g| g.take())
+            && url == self.current_url
+        {
+            self.cached_page = Some(CachedPage { url, elements });
+            self.form_map = FormMap::new();
+            self.showing_early = true;
+            self.content_landed();
+            return true;
+        }
         false
     }
 
@@ -1048,6 +1224,12 @@ impl Provider for WebbrowserProvider {
         self.pending_error.lock().ok().and_then(|mut g| g.take())
     }
 
+    /// Typed form fields live only here until submit, so a tab holding some
+    /// is neither dehydrated nor closed without asking.
+    fn is_busy(&self) -> bool {
+        !self.form_field_values.is_empty()
+    }
+
     fn init(&mut self) {
         self.load_url_history();
     }
@@ -1061,24 +1243,33 @@ impl Provider for WebbrowserProvider {
                 self.trim_url_history();
             }
         }
+        #[cfg(not(target_os = "windows"))]
+        if key == "webPrefetchLinks" {
+            self.prefetch_links = matches!(value, "true" | "1" | "on");
+        }
+        #[cfg(not(target_os = "windows"))]
+        if key == "webWarmTabs"
+            && let Ok(n) = value.parse::<usize>()
+        {
+            chrome_pool::set_warm_tabs(n);
+        }
+        if key == "webArchiveSizeMb"
+            && let Ok(n) = value.parse::<u64>()
+        {
+            archive::set_size_mb(n);
+        }
     }
 
     fn cleanup(&mut self) {
-        // Non-Windows: close the persistent Chrome session cleanly.
+        // Non-Windows: give the tab up, and close the shared Chrome cleanly if
+        // this was the last provider using it.  Dropped rather than released:
+        // blanking a tab for reuse is wasted on the way out.
         // Windows: no persistent session — any in-flight submit thread owns
         // its own session and will close it on its own.
         #[cfg(not(target_os = "windows"))]
         {
-            if let Some(live) = chromium_runtime().block_on(self.live.lock()).take() {
-                use chromiumoxide::cdp::browser_protocol::browser::CloseParams;
-                let _ = chromium_runtime().block_on(async {
-                    tokio::time::timeout(
-                        tokio::time::Duration::from_millis(500),
-                        live.session.browser.execute(CloseParams::default()),
-                    )
-                    .await
-                });
-            }
+            drop(chromium_runtime().block_on(self.live.lock()).take());
+            chromium_runtime().block_on(chrome_pool::shut_down_if_unused());
         }
     }
 
@@ -1115,8 +1306,12 @@ impl Provider for WebbrowserProvider {
             if !url.is_empty() {
                 // load_url clears form_field_values, so refresh wipes any
                 // typed-but-not-yet-submitted form values.  Intentional —
-                // refresh means "start over from the server's current state".
+                // refresh means "start over from the server's current state",
+                // which is also why the page cache is bypassed.  It is also
+                // how a saved copy from the archive is replaced by the live
+                // page, which then overwrites the copy.
                 self.cached_page = None;
+                page_cache::forget(&url);
                 self.load_url(&url);
             }
         } else if cmd == "clear cookies" {
@@ -1188,37 +1383,32 @@ impl WebbrowserProvider {
         sanitize_history_url(&self.current_url)
     }
 
-    /// Clear all cookies from the persistent profile. On non-Windows there is a
-    /// live browser holding the cookie store open, so clear it over CDP (which
-    /// also empties the backing store). On Windows each fetch uses a throwaway
+    /// Clear all cookies from the persistent profile. On non-Windows the shared
+    /// browser, when running, holds the cookie store open, so clear it over CDP
+    /// (which also empties the backing store). On Windows each fetch uses a throwaway
     /// browser, so there is nothing live to clear — remove the cookie files from
     /// the persistent profile dir instead.
     ///
-    /// Also sweeps the language preference 0.1.17 used to keep, since this is
+    /// Also sweeps the language preference 0.1.17 used to keep, the page cache
+    /// and the offline archive, which holds signed-in pages too, since this is
     /// the command for "forget what has been remembered about me".
     #[cfg_attr(target_os = "windows", allow(unused_variables))]
     fn clear_cookies(&mut self, error: &mut String) {
         remove_stale_language_pref();
+        page_cache::clear();
+        archive::clear();
         #[cfg(not(target_os = "windows"))]
         {
-            let guard = chromium_runtime().block_on(self.live.lock());
-            if let Some(live) = guard.as_ref() {
-                use chromiumoxide::cdp::browser_protocol::network::ClearBrowserCookiesParams;
-                let page = live.page.clone();
-                let res = chromium_runtime().block_on(async {
-                    tokio::time::timeout(
-                        tokio::time::Duration::from_secs(5),
-                        page.execute(ClearBrowserCookiesParams::default()),
-                    )
-                    .await
-                });
-                if !matches!(res, Ok(Ok(_))) {
+            // The shared Chrome holds the cookie store open: clear it there,
+            // whichever provider it was launched for.
+            match chromium_runtime().block_on(chrome_pool::clear_cookies()) {
+                Some(true) => {}
+                Some(false) => {
                     *error = "Could not clear cookies (browser not responding)".to_owned();
                 }
-                return;
+                // No Chrome running: nothing in memory, clear the on-disk store.
+                None => remove_cookie_files(&chrome_profile_dir()),
             }
-            // No live session: nothing in memory, clear the on-disk store.
-            remove_cookie_files(&chrome_profile_dir());
         }
         #[cfg(target_os = "windows")]
         {
@@ -1496,11 +1686,24 @@ pub(crate) fn set_error(slot: &Arc<Mutex<Option<String>>>, msg: String) {
 /// provider errors on that same tick signal.  Filling both slots means a
 /// browser that will not launch (no Chrome installed, launch timed out) shows
 /// up as a readable page saying so.
+///
+/// When the archive has a copy of `url`, that copy is the content instead: the
+/// error still goes to the status line, and offline is when a saved copy is
+/// worth the most.
 #[cfg(not(target_os = "windows"))]
-fn publish_load_failure(ready: &ReadySlot, errors: &Arc<Mutex<Option<String>>>, msg: String) {
+fn publish_load_failure(
+    ready: &ReadySlot,
+    errors: &Arc<Mutex<Option<String>>>,
+    url: &str,
+    msg: String,
+) {
     set_error(errors, msg.clone());
+    let elements = match archive::open(url, prune_hidden()) {
+        Some(snapshot) => archived_page(snapshot),
+        None => vec![FfonElement::new_str(msg)],
+    };
     if let Ok(mut g) = ready.lock() {
-        *g = Some((vec![FfonElement::new_str(msg)], FormMap::new()));
+        *g = Some((elements, FormMap::new()));
     }
 }
 
@@ -1564,22 +1767,56 @@ fn next_target(inflight: &AtomicBool, pending: &Arc<Mutex<Option<String>>>) -> O
 /// flash on screen under the newer URL's bar before being replaced a moment
 /// later.  The chain always ends with a publish, because the loop only stops
 /// once the queue is empty.
+///
+/// The page cache is asked first, so a cached page never launches Chrome.
+/// With `prefetch`, a page rendered for real queues its first few links to be
+/// rendered in pooled tabs.
+///
+/// A page rendered for real is shown twice: its DOMContentLoaded snapshot goes
+/// to `early` as soon as there is one, and the settled page to `ready`.  Both
+/// go through `bands`, so the second converts only the bands that arrived or
+/// changed in between.
 #[cfg(not(target_os = "windows"))]
+#[allow(clippy::too_many_arguments)]
 async fn navigate_once(
     live: &Arc<tokio::sync::Mutex<Option<LivePageSession>>>,
+    bands: &Mutex<BandConverter>,
     ready: &ReadySlot,
+    early: &EarlySlot,
     errors: &Arc<Mutex<Option<String>>>,
     pending: &Arc<Mutex<Option<String>>>,
     url: &str,
+    prefetch: bool,
 ) {
+    if let Some(elements) = page_cache::lookup(url, prune_hidden(), false).await {
+        if !has_pending(pending)
+            && let Ok(mut g) = ready.lock()
+        {
+            *g = Some((elements, FormMap::new()));
+        }
+        return;
+    }
+
     let mut guard = live.lock().await;
+    if chrome_pool::due_for_recycle()
+        && let Some(old) = guard.take()
+    {
+        // The page in it is about to be replaced anyway, and no lease out is
+        // what lets the pool restart Chrome.
+        old.release().await;
+    }
     if guard.is_none() {
         match init_live_session().await {
             Ok(session) => *guard = Some(session),
             Err(e) => {
                 drop(guard);
                 if !has_pending(pending) {
-                    publish_load_failure(ready, errors, format!("Error launching browser: {e}"));
+                    publish_load_failure(
+                        ready,
+                        errors,
+                        url,
+                        format!("Error launching browser: {e}"),
+                    );
                 }
                 return;
             }
@@ -1590,7 +1827,26 @@ async fn navigate_once(
     // clear is not blocked behind a slow page.
     drop(guard);
 
-    let outcome = navigate_and_get_html(&page, url).await;
+    let first_paint = |html: String| {
+        // A consent wall or a bot check is about to be replaced by the gate
+        // flow; showing it first would only drop the reader into it.
+        if has_pending(pending)
+            || html_has_consent_wall(&html)
+            || html_has_inline_consent_banner(&html)
+            || looks_challenged(&html)
+        {
+            return;
+        }
+        let Ok(mut bands) = bands.lock() else {
+            return;
+        };
+        let (elements, _) = render_page(&mut bands, &PageLoad::plain(html), url);
+        drop(bands);
+        if let Ok(mut g) = early.lock() {
+            *g = Some((url.to_owned(), elements));
+        }
+    };
+    let outcome = navigate_with_first_paint(&page, url, Some(&first_paint)).await;
     if outcome.is_err() {
         // Drop the session so the next attempt starts fresh.
         *live.lock().await = None;
@@ -1600,48 +1856,60 @@ async fn navigate_once(
     }
     match outcome {
         Ok(load) => {
-            let (elements, form_map) = page_to_ffon_with_forms(&load, url);
+            let (elements, form_map) = match bands.lock() {
+                Ok(mut bands) => render_page(&mut bands, &load, url),
+                Err(_) => page_to_ffon_with_forms(&load, url),
+            };
+            keep_page(url, &load, &elements, &form_map);
+            if prefetch {
+                queue_prefetch(prefetch_candidates(&elements, url));
+            }
             if let Ok(mut g) = ready.lock() {
                 *g = Some((elements, form_map));
             }
         }
-        Err(e) => publish_load_failure(ready, errors, format!("Error loading {url}: {e}")),
+        Err(e) => publish_load_failure(ready, errors, url, format!("Error loading {url}: {e}")),
     }
 }
 
-/// Initialise a long-lived Chrome session: launch the browser, open a blank
-/// tab, and inject the stealth script so it applies to every page load.
+/// Initialise a long-lived page session: lease a warm tab from the shared
+/// Chrome, launching it first if this is the first navigation in the process.
+/// The tab comes with the stealth script and viewport already applied.
 ///
 /// Non-Windows only.  Windows uses `fetch_html_once` for each page load so the
 /// off-screen Chrome window is never present while the user reads the page.
 #[cfg(not(target_os = "windows"))]
 async fn init_live_session() -> Result<LivePageSession, String> {
-    let t = tokio::time::Duration::from_secs;
-    let session = launch_browser().await?;
-    let page = tokio::time::timeout(t(15), session.browser.new_page("about:blank"))
-        .await
-        .map_err(|_| "Chrome took >15 s to open a tab".to_owned())?
-        .map_err(|e| format!("failed to open tab: {e}"))?;
-    tokio::time::timeout(
-        t(10),
-        page.execute(AddScriptToEvaluateOnNewDocumentParams::new(STEALTH_SCRIPT)),
-    )
-    .await
-    .map_err(|_| "stealth script injection timed out".to_owned())?
-    .map_err(|e| format!("stealth script injection failed: {e}"))?;
-    set_desktop_viewport(&page).await;
-    Ok(LivePageSession { session, page })
+    let tab = chrome_pool::checkout().await?;
+    let page = tab.page().clone();
+    Ok(LivePageSession { tab, page })
 }
 
 /// Navigate an existing page to `url` and return the settled HTML.
 /// Mirrors the logic of the old `fetch_page` but reuses the caller's tab.
 async fn navigate_and_get_html(page: &chromiumoxide::Page, url: &str) -> Result<PageLoad, String> {
+    navigate_with_first_paint(page, url, None).await
+}
+
+/// [`navigate_and_get_html`], handing `first_paint` a snapshot of the document
+/// as soon as it reaches DOMContentLoaded — seconds before the load event, the
+/// URL settling and the consent gates let the settled HTML through.
+async fn navigate_with_first_paint(
+    page: &chromiumoxide::Page,
+    url: &str,
+    first_paint: Option<&(dyn Fn(String) + Send + Sync)>,
+) -> Result<PageLoad, String> {
     let t = tokio::time::Duration::from_secs;
 
-    tokio::time::timeout(t(30), page.goto(url))
-        .await
-        .map_err(|_| format!("navigation to {url} timed out after 30 s"))?
-        .map_err(|e| format!("navigation to {url} failed: {e}"))?;
+    // Asked before the navigation: the cookies it sends, not the ones it sets.
+    let credentialed = sends_credentials(page, url).await;
+    let navigation = tokio::time::timeout(t(30), page.goto(url));
+    match first_paint {
+        Some(publish) => with_first_paint(page, navigation, publish).await,
+        None => navigation.await,
+    }
+    .map_err(|_| format!("navigation to {url} timed out after 30 s"))?
+    .map_err(|e| format!("navigation to {url} failed: {e}"))?;
 
     let current_url = await_stable_url(page, t(5)).await;
 
@@ -1650,10 +1918,168 @@ async fn navigate_and_get_html(page: &chromiumoxide::Page, url: &str) -> Result<
     // also sniff the fetched content for the consent-save endpoint.
     let html = settled_html(page).await?;
 
-    let (load, _) = settle_gates(page, &current_url, html).await;
+    let (mut load, _) = settle_gates(page, &current_url, html).await;
+    load.credentialed = credentialed;
+    #[cfg(not(target_os = "windows"))]
+    chrome_pool::after_navigation(page).await;
     Ok(load)
 }
 
+/// Drive `navigation`, and if the document reaches DOMContentLoaded before it
+/// completes, serialise what is there and give it to `publish`.
+///
+/// The listener is attached before the navigation is first polled, so the
+/// event cannot slip past.  A snapshot still being taken when the navigation
+/// completes is dropped: the settled HTML is moments away by then.
+async fn with_first_paint<F: std::future::Future>(
+    page: &chromiumoxide::Page,
+    navigation: F,
+    publish: &(dyn Fn(String) + Send + Sync),
+) -> F::Output {
+    use chromiumoxide::cdp::browser_protocol::page::EventDomContentEventFired;
+    let Ok(mut dom_ready) = page.event_listener::<EventDomContentEventFired>().await else {
+        return navigation.await;
+    };
+    let snapshot = async {
+        dom_ready.next().await?;
+        settled_html(page).await.ok()
+    };
+    tokio::pin!(navigation);
+    tokio::select! {
+        done = &mut navigation => done,
+        Some(html) = snapshot => {
+            publish(html);
+            navigation.await
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Link prefetch
+//
+// After a page lands, its first few links are rendered in a tab leased from
+// the shared Chrome and put in the page cache.  Following one — which the app
+// does through `fetch_url_to_ffon`, a full render in the same Chrome — is then
+// served from the cache instead.  One worker at a time, and a newer page's
+// links replace whatever the previous page left queued: the same newest-wins
+// rule as the navigation queue.
+// ---------------------------------------------------------------------------
+
+/// Links prefetched per page.
+#[cfg(not(target_os = "windows"))]
+const PREFETCH_LINKS: usize = 3;
+
+#[cfg(not(target_os = "windows"))]
+static PREFETCH_QUEUE: Mutex<Vec<String>> = Mutex::new(Vec::new());
+
+#[cfg(not(target_os = "windows"))]
+static PREFETCH_RUNNING: AtomicBool = AtomicBool::new(false);
+
+/// The first [`PREFETCH_LINKS`] web links on a page, in reading order, that
+/// are neither the page itself nor cached already.
+#[cfg(not(target_os = "windows"))]
+fn prefetch_candidates(elements: &[FfonElement], page_url: &str) -> Vec<String> {
+    uncached_links(page_links(elements, page_url))
+}
+
+/// The first [`PREFETCH_LINKS`] of `links` not in the page cache yet.
+#[cfg(not(target_os = "windows"))]
+fn uncached_links(links: Vec<String>) -> Vec<String> {
+    let pruned = prune_hidden();
+    links
+        .into_iter()
+        .filter(|u| !page_cache::contains(u, pruned))
+        .take(PREFETCH_LINKS)
+        .collect()
+}
+
+/// Every web link on a page, in reading order, without its fragment, once
+/// each and never the page itself.
+fn page_links(elements: &[FfonElement], page_url: &str) -> Vec<String> {
+    fn walk(elements: &[FfonElement], out: &mut Vec<String>) {
+        for elem in elements {
+            match elem {
+                FfonElement::Str(s) => out.extend(sicompass_sdk::tags::extract_link(s)),
+                FfonElement::Obj(o) => {
+                    out.extend(sicompass_sdk::tags::extract_link(&o.key));
+                    walk(&o.children, out);
+                }
+            }
+        }
+    }
+    let without_fragment = |u: &str| u.split('#').next().unwrap_or(u).to_owned();
+    let page = without_fragment(page_url);
+
+    let mut links = Vec::new();
+    walk(elements, &mut links);
+    let mut seen = HashSet::new();
+    links
+        .into_iter()
+        .filter(|u| u.starts_with("http://") || u.starts_with("https://"))
+        .map(|u| without_fragment(&u))
+        .filter(|u| *u != page && seen.insert(u.clone()))
+        .collect()
+}
+
+/// Replace the prefetch queue with `links`, starting the worker if it is not
+/// running.
+#[cfg(not(target_os = "windows"))]
+fn queue_prefetch(links: Vec<String>) {
+    let empty = links.is_empty();
+    if let Ok(mut q) = PREFETCH_QUEUE.lock() {
+        *q = links;
+    }
+    if empty || PREFETCH_RUNNING.swap(true, Ordering::AcqRel) {
+        return;
+    }
+    chromium_runtime().spawn(async move {
+        while let Some(url) = next_prefetch() {
+            prefetch_one(&url).await;
+        }
+    });
+}
+
+/// The worker's next URL, or `None` to stop.  The double take is the one
+/// `next_target` explains.
+#[cfg(not(target_os = "windows"))]
+fn next_prefetch() -> Option<String> {
+    let take = || {
+        PREFETCH_QUEUE
+            .lock()
+            .ok()
+            .and_then(|mut q| (!q.is_empty()).then(|| q.remove(0)))
+    };
+    if let Some(next) = take() {
+        return Some(next);
+    }
+    PREFETCH_RUNNING.store(false, Ordering::Release);
+    let next = take()?;
+    (!PREFETCH_RUNNING.swap(true, Ordering::AcqRel)).then_some(next)
+}
+
+/// Render `url` in a pooled tab and cache it.  Failures are dropped: the link
+/// will simply load the slow way if the user follows it.
+#[cfg(not(target_os = "windows"))]
+async fn prefetch_one(url: &str) {
+    // Cached since it was queued, e.g. the user followed it already.
+    if page_cache::contains(url, prune_hidden()) {
+        return;
+    }
+    let Ok(tab) = chrome_pool::checkout().await else {
+        return;
+    };
+    let budget = tokio::time::Duration::from_secs(45);
+    match tokio::time::timeout(budget, navigate_and_get_html(tab.page(), url)).await {
+        Ok(Ok(load)) => {
+            let (elements, form_map) = page_to_ffon_with_forms(&load, url);
+            remember_page(url, &load, &elements, &form_map);
+            chrome_pool::release(tab).await;
+        }
+        // Dropping the lease closes a tab that may be stuck mid-load.
+        _ => drop(tab),
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Windows close-after-load: per-call launch+fetch+close helpers
 //
@@ -1697,11 +2123,7 @@ async fn fetch_html_once(url: &str) -> Result<PageLoad, String> {
 /// Send `Browser.close` so Chrome exits cleanly (WebSocket close handshake
 /// completes) before the `BrowserSession` is dropped.  Mirrors the pattern in
 /// `fetch_html_inner`.
-///
-/// Also used by the browser tests on every platform: nothing kills the child on
-/// drop, so a test that opens a session and walks away leaves a Chrome (and its
-/// Xvfb) running until the machine is rebooted.
-#[cfg(any(target_os = "windows", test))]
+#[cfg(target_os = "windows")]
 async fn close_browser(session: &BrowserSession) {
     use chromiumoxide::cdp::browser_protocol::browser::CloseParams;
     let _ = tokio::time::timeout(
@@ -2864,6 +3286,9 @@ fn challenge_notice(html: &str, elements: &[FfonElement]) -> Option<String> {
 struct PageLoad {
     html: String,
     notices: Vec<String>,
+    /// The request carried cookies or credentials, so the page may be the
+    /// signed-in user's own rather than what anyone would get.
+    credentialed: bool,
 }
 
 impl PageLoad {
@@ -2871,6 +3296,7 @@ impl PageLoad {
         PageLoad {
             html,
             notices: Vec::new(),
+            credentialed: false,
         }
     }
 }
@@ -3041,7 +3467,17 @@ fn declared_languages(html: &str, url: &str) -> Vec<(String, String)> {
 /// the load flow recorded, then whatever the content itself gives away, and the
 /// page's own language versions as a trailing section.
 fn page_to_ffon_with_forms(load: &PageLoad, url: &str) -> (Vec<FfonElement>, FormMap) {
-    let (mut elements, form_map) = html_to_ffon_with_forms(&load.html, url);
+    render_page(&mut BandConverter::default(), load, url)
+}
+
+/// [`page_to_ffon_with_forms`] through `bands`, which reuses whatever it
+/// converted for an earlier snapshot of the same page.
+fn render_page(
+    bands: &mut BandConverter,
+    load: &PageLoad,
+    url: &str,
+) -> (Vec<FfonElement>, FormMap) {
+    let (mut elements, form_map) = bands.convert(&load.html, url);
     let notices: Vec<String> = load
         .notices
         .iter()
@@ -3072,16 +3508,168 @@ fn page_to_ffon_with_forms(load: &PageLoad, url: &str) -> (Vec<FfonElement>, For
     (elements, form_map)
 }
 
+/// Put a rendered page in the page cache, unless what it shows depends on who
+/// asked or when: a page requested with cookies or credentials, a notice from
+/// the load flow (a consent wall that would not answer, a gate), or a bot
+/// check.  Those are worth a fresh try every time.
+fn remember_page(url: &str, load: &PageLoad, elements: &[FfonElement], form_map: &FormMap) {
+    if !cacheable(load) {
+        return;
+    }
+    let pruned = prune_hidden();
+    page_cache::store(url, pruned, elements, !form_map.is_empty());
+    chromium_runtime().spawn(page_cache::capture_validators(url.to_owned(), pruned));
+}
+
+/// [`remember_page`], and save the page to the offline archive as well.  For
+/// pages the user navigated to; a prefetched or followed link only warms the
+/// cache.  A gate or a bot check is no better a saved copy than a cached one.
+fn keep_page(url: &str, load: &PageLoad, elements: &[FfonElement], form_map: &FormMap) {
+    remember_page(url, load, elements, form_map);
+    if !worth_keeping(load) {
+        return;
+    }
+    archive::store(
+        url,
+        prune_hidden(),
+        elements,
+        &page_links(elements, url),
+        &load.html,
+        !form_map.is_empty(),
+    );
+}
+
+fn worth_keeping(load: &PageLoad) -> bool {
+    load.notices.is_empty() && !looks_challenged(&load.html)
+}
+
+/// [`worth_keeping`], and the same for whoever asks.  The archive is the user's
+/// own and keeps a signed-in page; the page cache also serves prefetch and
+/// followed links, so it does not.
+fn cacheable(load: &PageLoad) -> bool {
+    !load.credentialed && worth_keeping(load)
+}
+
+/// Cookies sites set for whoever visits — consent choices, analytics, bot
+/// management — by exact name and by prefix.  A request carrying only these
+/// gets the page anyone would.
+const ANONYMOUS_COOKIES: &[&str] = &[
+    "_ga",
+    "_gid",
+    "_gat",
+    "_fbp",
+    "_fbc",
+    "_clck",
+    "_clsk",
+    "__gads",
+    "__gpi",
+    "__utma",
+    "__utmb",
+    "__utmc",
+    "__utmz",
+    "__cf_bm",
+    "_cfuvid",
+    "cf_clearance",
+    "CONSENT",
+    "SOCS",
+    "euconsent-v2",
+    "OptanonConsent",
+    "OptanonAlertBoxClosed",
+    "CookieConsent",
+    "cookieconsent_status",
+    "ajs_anonymous_id",
+];
+const ANONYMOUS_COOKIE_PREFIXES: &[&str] = &["_ga_", "_gat_", "_gcl_", "_hj", "_pk_", "_uet"];
+
+/// Whether a cookie named `name` may say who is asking, and so change what
+/// the page shows.
+fn identifies_user(name: &str) -> bool {
+    !ANONYMOUS_COOKIES.contains(&name)
+        && !ANONYMOUS_COOKIE_PREFIXES
+            .iter()
+            .any(|p| name.starts_with(p))
+}
+
+/// Whether a request for `url` from `page` would carry credentials: a cookie
+/// Chrome holds for it that may identify the user, or a user in the URL.
+/// Assumed so when Chrome does not answer.
+///
+/// Consent and analytics cookies do not count: nearly every site sets them on
+/// the first visit, and counting them would keep its pages — the links
+/// prefetch renders among them — out of the cache altogether.
+async fn sends_credentials(page: &chromiumoxide::Page, url: &str) -> bool {
+    use chromiumoxide::cdp::browser_protocol::network::GetCookiesParams;
+    if reqwest::Url::parse(url).is_ok_and(|u| !u.username().is_empty()) {
+        return true;
+    }
+    let params = GetCookiesParams::builder()
+        .urls(vec![url.to_owned()])
+        .build();
+    match tokio::time::timeout(tokio::time::Duration::from_secs(5), page.execute(params)).await {
+        Ok(Ok(cookies)) => cookies
+            .result
+            .cookies
+            .iter()
+            .any(|c| identifies_user(&c.name)),
+        _ => true,
+    }
+}
+
+/// A saved copy as page content, led by the lines that say it is one.
+fn archived_page(snapshot: archive::Snapshot) -> Vec<FfonElement> {
+    register_translations();
+    let mut elements = vec![FfonElement::new_str(localize::t(
+        "webbrowser-archived-copy",
+    ))];
+    if snapshot.has_forms {
+        elements.push(FfonElement::new_str(localize::t(
+            "webbrowser-archived-forms",
+        )));
+    }
+    elements.extend(snapshot.elements);
+    if !snapshot.images.is_empty() {
+        let mut images = FfonElement::new_obj(localize::t("webbrowser-archived-images"));
+        if let Some(obj) = images.as_obj_mut() {
+            for path in snapshot.images {
+                obj.push(FfonElement::new_str(format!("<image>{path}</image>")));
+            }
+        }
+        elements.push(images);
+    }
+    elements
+}
+
+/// Any bot-check or CAPTCHA marker at all.  Broader than `challenge_notice`,
+/// which spares a real page carrying a CAPTCHA box: labelling that page would
+/// be wrong, but caching it is merely a missed opportunity.
+fn looks_challenged(html: &str) -> bool {
+    let haystack = html.to_lowercase();
+    BOT_WALL_MARKERS.iter().any(|(m, _)| haystack.contains(m))
+        || CAPTCHA_MARKERS.iter().any(|m| haystack.contains(m))
+}
+
 /// Fetch a URL via Chromium, parse the HTML, and return as FFON elements.
 /// Used by the main app's `fetch_url_to_elements` bridge.
+///
+/// Served from the page cache when it can be: this is how the app follows a
+/// link, and each miss cold-launches a Chrome of its own.
 pub fn fetch_url_to_ffon(url: &str) -> Vec<FfonElement> {
     if test_no_launch() {
         return vec![FfonElement::new_str(format!(
             "<test-no-launch>{url}</test-no-launch>"
         ))];
     }
+    if let Some(elements) =
+        chromium_runtime().block_on(page_cache::lookup(url, prune_hidden(), true))
+    {
+        return elements;
+    }
     match fetch_html_chromium(url) {
-        Ok(load) => page_to_ffon_with_forms(&load, url).0,
+        Ok(load) => {
+            let (elements, form_map) = page_to_ffon_with_forms(&load, url);
+            remember_page(url, &load, &elements, &form_map);
+            elements
+        }
         Err(e) => vec![FfonElement::new_str(format!("Error loading {url}: {e}"))],
     }
 }
@@ -3094,6 +3682,20 @@ fn fetch_html_chromium(url: &str) -> Result<PageLoad, String> {
     })
 }
 
+/// Non-Windows: lease a warm tab from the shared Chrome rather than starting
+/// one, and hand it back for the next fetch.  A tab whose load failed is
+/// dropped instead, which closes it.
+#[cfg(not(target_os = "windows"))]
+async fn fetch_html_inner(url: &str) -> Result<PageLoad, String> {
+    let tab = chrome_pool::checkout().await?;
+    let result = navigate_and_get_html(tab.page(), url).await;
+    if result.is_ok() {
+        chrome_pool::release(tab).await;
+    }
+    result
+}
+
+#[cfg(target_os = "windows")]
 async fn fetch_html_inner(url: &str) -> Result<PageLoad, String> {
     // Launch a fresh Chrome process for this fetch.
     let session = launch_browser().await?;
@@ -3118,6 +3720,7 @@ async fn fetch_html_inner(url: &str) -> Result<PageLoad, String> {
 
 /// Open a tab, navigate to `url`, and return the rendered HTML.
 /// Called by `fetch_html_inner` which handles Chrome lifecycle around it.
+#[cfg(target_os = "windows")]
 async fn fetch_page(session: &BrowserSession, url: &str) -> Result<PageLoad, String> {
     let t = tokio::time::Duration::from_secs;
 
@@ -3135,6 +3738,7 @@ async fn fetch_page(session: &BrowserSession, url: &str) -> Result<PageLoad, Str
     .map_err(|e| format!("stealth script injection failed: {e}"))?;
     set_desktop_viewport(&page).await;
 
+    let credentialed = sends_credentials(&page, url).await;
     tokio::time::timeout(t(30), page.goto(url))
         .await
         .map_err(|_| format!("navigation to {url} timed out after 30 s"))?
@@ -3151,7 +3755,8 @@ async fn fetch_page(session: &BrowserSession, url: &str) -> Result<PageLoad, Str
     let html = settled_html(&page).await?;
 
     // Surface any consent choice the page is showing, then hand the page over.
-    let (load, surfaced) = settle_gates(&page, &current_url, html).await;
+    let (mut load, surfaced) = settle_gates(&page, &current_url, html).await;
+    load.credentialed = credentialed;
     if !surfaced && (is_consent_wall_str(&current_url) || html_has_consent_wall(&load.html)) {
         // Capture a snippet to diagnose why no choice could be lifted out.
         let snippet: String = load.html.chars().take(2000).collect();
@@ -3485,6 +4090,20 @@ const PRUNE_JS_BODY: &str = r##"
         // of noise to push through the parser otherwise.
         for (const node of clone.querySelectorAll('[' + GEO + ']')) node.removeAttribute(GEO);
         for (const node of clone.querySelectorAll('[' + PIN + ']')) node.removeAttribute(PIN);
+        // Where the page may be converted band by band (streaming.rs): after
+        // each top-level landmark, with the number of forms before the cut so
+        // the next band's forms keep their document-wide numbers.  Last, after
+        // everything that moves top-level nodes around.
+        const bandBody = clone.querySelector('body');
+        if (bandBody) {
+            let forms = 0;
+            for (const node of Array.from(bandBody.children)) {
+                forms += (node.tagName === 'FORM' ? 1 : 0) + node.querySelectorAll('form').length;
+                if (node.nextSibling && node.matches('nav, main, aside, footer')) {
+                    node.after(document.createComment('sic-band:' + forms));
+                }
+            }
+        }
         html = '<!DOCTYPE html>' + clone.outerHTML;
     } finally {
         for (const node of marked) node.removeAttribute(MARK);
@@ -4793,6 +5412,7 @@ async fn settle_gates(
                 PageLoad {
                     html: gate_page_html(&report.labels, &ids),
                     notices: vec![localize::t(CONSENT_NOTICE_KEY)],
+                    credentialed: false,
                 },
                 true,
             );
@@ -4814,6 +5434,7 @@ async fn settle_gates(
             PageLoad {
                 html,
                 notices: vec![localize::t("webbrowser-consent-unrecognised")],
+                credentialed: false,
             },
             false,
         );
@@ -5921,6 +6542,39 @@ mod tests {
         assert_eq!(notice_for(&html), None);
     }
 
+    #[test]
+    fn a_page_requested_with_credentials_is_archived_but_not_cached() {
+        let mut load = PageLoad::plain("<html><body><p>Your orders</p></body></html>".to_owned());
+        assert!(cacheable(&load));
+        load.credentialed = true;
+        assert!(!cacheable(&load), "it may be someone's own page");
+        assert!(worth_keeping(&load), "the archive is theirs to keep it in");
+    }
+
+    #[test]
+    fn consent_and_analytics_cookies_do_not_make_a_page_private() {
+        for name in [
+            "_ga",
+            "_ga_X1Y2Z3",
+            "_gid",
+            "_hjSessionUser_42",
+            "CONSENT",
+            "__cf_bm",
+        ] {
+            assert!(!identifies_user(name), "{name}");
+        }
+        for name in [
+            "sid",
+            "session",
+            "PHPSESSID",
+            "auth_token",
+            "_gauth",
+            "__Host-id",
+        ] {
+            assert!(identifies_user(name), "{name}");
+        }
+    }
+
     #[test]
     fn interstitial_page_keeps_its_own_content() {
         // The point of the notice: it is added *in front of* the page, never
@@ -5952,6 +6606,7 @@ mod tests {
         let load = PageLoad {
             html: html.to_owned(),
             notices: vec!["Cookie-consent wall".to_owned()],
+            credentialed: false,
         };
         let (elements, _) = page_to_ffon_with_forms(&load, "https://example.com");
         assert!(
@@ -6088,6 +6743,46 @@ mod tests {
         assert!(!p.tick());
     }
 
+    #[cfg(not(target_os = "windows"))]
+    #[test]
+    fn first_paint_shows_until_the_settled_page_replaces_it() {
+        use sicompass_sdk::provider::Provider;
+        let mut p = WebbrowserProvider::new();
+        p.current_url = "https://a.invalid/".to_owned();
+        p.load_inflight.store(true, Ordering::Release);
+        let page_text = |p: &mut WebbrowserProvider| format!("{:?}", p.fetch());
+
+        // One for a URL the user has since left is dropped.
+        *p.early_content.lock().unwrap() = Some((
+            "https://old.invalid/".to_owned(),
+            vec![FfonElement::new_str("stale")],
+        ));
+        assert!(!p.tick());
+        assert!(page_text(&mut p).contains("Loading…"));
+
+        *p.early_content.lock().unwrap() = Some((
+            "https://a.invalid/".to_owned(),
+            vec![FfonElement::new_str("first paint")],
+        ));
+        assert!(p.tick());
+        let shown = page_text(&mut p);
+        assert!(shown.contains("first paint") && !shown.contains("Loading…"));
+
+        // The settled page wins, even over a first paint that has not been
+        // drained yet.
+        *p.early_content.lock().unwrap() = Some((
+            "https://a.invalid/".to_owned(),
+            vec![FfonElement::new_str("late first paint")],
+        ));
+        *p.ready_content.lock().unwrap() =
+            Some((vec![FfonElement::new_str("settled")], FormMap::new()));
+        p.load_inflight.store(false, Ordering::Release);
+        assert!(p.tick());
+        assert!(!p.tick());
+        let shown = page_text(&mut p);
+        assert!(shown.contains("settled") && !shown.contains("late first paint"));
+    }
+
     #[test]
     fn page_landing_asks_app_to_enter_content() {
         let mut p = WebbrowserProvider::new();
@@ -6150,6 +6845,7 @@ mod tests {
         publish_load_failure(
             &p.ready_content,
             &p.pending_error,
+            "https://example.com",
             "Error launching browser: Chrome/Chromium not found.".to_owned(),
         );
         p.load_inflight.store(false, Ordering::Release);
@@ -6233,6 +6929,47 @@ mod tests {
         );
     }
 
+    #[cfg(not(target_os = "windows"))]
+    #[test]
+    fn prefetch_takes_the_first_other_pages_in_reading_order() {
+        let mut nav = FfonElement::new_obj("nav".to_owned());
+        let o = nav.as_obj_mut().unwrap();
+        o.push(FfonElement::new_str(
+            "Home <link>https://a.invalid/</link>".to_owned(),
+        ));
+        o.push(FfonElement::new_str(
+            "Top <link>https://a.invalid/#top</link>".to_owned(),
+        ));
+        let elements = vec![
+            nav,
+            FfonElement::new_str("Mail <link>mailto:x@a.invalid</link>".to_owned()),
+            FfonElement::new_str("One <link>https://a.invalid/one</link>".to_owned()),
+            FfonElement::new_str("Again <link>https://a.invalid/one#part</link>".to_owned()),
+            FfonElement::new_str("Two <link>https://b.invalid/two</link>".to_owned()),
+            FfonElement::new_str("Three <link>http://c.invalid/</link>".to_owned()),
+            FfonElement::new_str("Four <link>https://d.invalid/</link>".to_owned()),
+        ];
+        assert_eq!(
+            prefetch_candidates(&elements, "https://a.invalid/#intro"),
+            [
+                "https://a.invalid/one",
+                "https://b.invalid/two",
+                "http://c.invalid/"
+            ]
+        );
+    }
+
+    #[cfg(not(target_os = "windows"))]
+    #[test]
+    fn prefetch_is_off_until_the_setting_turns_it_on() {
+        let mut p = WebbrowserProvider::new();
+        assert!(!p.prefetch_links);
+        p.on_setting_change("webPrefetchLinks", "true");
+        assert!(p.prefetch_links);
+        p.on_setting_change("webPrefetchLinks", "false");
+        assert!(!p.prefetch_links);
+    }
+
     #[cfg(not(target_os = "windows"))]
     #[test]
     fn next_target_serves_the_queue_then_releases_the_flag() {
@@ -7102,6 +7839,70 @@ mod tests {
         assert!(p.bookmarks.is_empty(), "and it has to be removable");
     }
 
+    // ---- Offline archive ----
+
+    #[test]
+    fn a_saved_copy_opens_labelled_and_without_a_form_map() {
+        let html = "<html><body><h1>Saved</h1><p>Read offline</p>\
+                    <form><input name='q'><button>Go</button></form></body></html>";
+        let (elements, forms) = html_to_ffon_with_forms(html, "https://a.invalid/");
+        assert!(!forms.is_empty());
+        let mut p = WebbrowserProvider::new();
+        p.form_field_values
+            .insert("form_1/q".to_owned(), "typed".to_owned());
+
+        p.show_archived(
+            "https://a.invalid/",
+            archive::Snapshot {
+                elements,
+                links: Vec::new(),
+                has_forms: true,
+                images: vec!["/saved/logo.png".to_owned()],
+            },
+        );
+
+        assert_eq!(p.current_url, "https://a.invalid/");
+        assert!(p.form_map.is_empty(), "its selectors point at no document");
+        assert!(p.form_field_values.is_empty());
+        assert_eq!(
+            p.take_navigation_request(),
+            Some(sicompass_sdk::NavigationRequest::EnterChildren),
+            "a history row drops the reader into the page, saved or not"
+        );
+        let items = p.fetch();
+        let page = items[0].as_obj().expect("URL bar wraps the saved copy");
+        assert_eq!(
+            page.children[0].as_str(),
+            Some(localize::t("webbrowser-archived-copy").as_str())
+        );
+        assert_eq!(
+            page.children[1].as_str(),
+            Some(localize::t("webbrowser-archived-forms").as_str())
+        );
+        assert!(format!("{:?}", page.children).contains("Read offline"));
+        let images = page.children.last().and_then(|e| e.as_obj()).unwrap();
+        assert_eq!(images.key, localize::t("webbrowser-archived-images"));
+        assert_eq!(
+            images.children[0].as_str(),
+            Some("<image>/saved/logo.png</image>")
+        );
+    }
+
+    #[test]
+    fn page_links_are_the_outbound_web_links_once_each() {
+        let elements = vec![
+            FfonElement::new_str("Self <link>https://a.invalid/#top</link>".to_owned()),
+            FfonElement::new_str("One <link>https://a.invalid/one</link>".to_owned()),
+            FfonElement::new_str("Mail <link>mailto:x@a.invalid</link>".to_owned()),
+            FfonElement::new_str("Again <link>https://a.invalid/one#part</link>".to_owned()),
+            FfonElement::new_str("Two <link>https://b.invalid/two</link>".to_owned()),
+        ];
+        assert_eq!(
+            page_links(&elements, "https://a.invalid/"),
+            ["https://a.invalid/one", "https://b.invalid/two"]
+        );
+    }
+
     /// No in-crate test may reach the real history file under `state_home()`.
     ///
     /// The tempdir-backed tests set `url_history_path`, but nothing forces them
@@ -7352,6 +8153,7 @@ mod tests {
             p.form_field_values.get("form_1/email").map(|s| s.as_str()),
             Some("user@example.com"),
         );
+        assert!(p.is_busy(), "the typed value has not been submitted");
     }
 
     // ---- take_error draining ----
@@ -7935,6 +8737,109 @@ mod tests {
 
     // ---- browser-backed tests (need Chrome; run with --ignored) ----
 
+    /// Give a test's session back and close the shared Chrome.  Nothing kills
+    /// the child on drop, so a test that opens a session and walks away leaves
+    /// a Chrome (and its Xvfb) running until the machine is rebooted.
+    #[cfg(not(target_os = "windows"))]
+    async fn close_live(live: LivePageSession) {
+        live.release().await;
+        chrome_pool::shut_down_if_unused().await;
+    }
+
+    /// Two fetches of a `file://` fixture share one Chrome: the second leases
+    /// a tab from the process the first launched instead of starting its own.
+    #[cfg(not(target_os = "windows"))]
+    #[test]
+    #[ignore]
+    fn pool_reuses_one_chrome_across_fetches() {
+        let path = std::env::temp_dir().join("sic-pool-reuse.html");
+        std::fs::write(&path, "<html><body><p>pooled</p></body></html>").expect("write fixture");
+        let url = format!("file://{}", path.display());
+
+        let before = chrome_pool::launches();
+        let first = fetch_html_chromium(&url).expect("first fetch");
+        let launched = chrome_pool::launches();
+        let second = fetch_html_chromium(&url).expect("second fetch");
+        chromium_runtime().block_on(chrome_pool::shut_down_if_unused());
+        let _ = std::fs::remove_file(&path);
+
+        assert!(
+            launched - before <= 1,
+            "one launch at most for the first fetch"
+        );
+        assert_eq!(
+            chrome_pool::launches(),
+            launched,
+            "the second fetch must reuse the running Chrome"
+        );
+        assert!(first.html.contains("pooled"));
+        assert!(second.html.contains("pooled"));
+    }
+
+    /// Serve `body` over HTTP on `host`, setting `cookie` with every response,
+    /// for as long as the test process runs.  Returns the site's origin.
+    #[cfg(not(target_os = "windows"))]
+    fn serve_with_cookie(host: &str, body: &'static str, cookie: &'static str) -> String {
+        use std::io::{Read, Write};
+        let listener = std::net::TcpListener::bind("127.0.0.1:0").expect("bind");
+        let port = listener.local_addr().expect("local addr").port();
+        std::thread::spawn(move || {
+            for stream in listener.incoming() {
+                let Ok(mut stream) = stream else {
+                    continue;
+                };
+                let _ = stream.read(&mut [0; 8192]);
+                let _ = write!(
+                    stream,
+                    "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\
+                     Set-Cookie: {cookie}; Path=/\r\nContent-Length: {}\r\n\
+                     Connection: close\r\n\r\n{body}",
+                    body.len()
+                );
+            }
+        });
+        format!("http://{host}:{port}")
+    }
+
+    /// A site that sets analytics cookies on the first visit still has the
+    /// links prefetched from it cached; one that signs the visitor in does
+    /// not.  The two are on different hosts, as cookies ignore the port.
+    #[cfg(not(target_os = "windows"))]
+    #[test]
+    #[ignore]
+    fn a_prefetched_page_is_cached_unless_the_site_knows_who_asks() {
+        use chromiumoxide::cdp::browser_protocol::network::ClearBrowserCookiesParams;
+        const BODY: &str = "<html><body><p>catalogue</p></body></html>";
+        let analytics = serve_with_cookie("127.0.0.1", BODY, "_ga=GA1.1.42");
+        let signed_in = serve_with_cookie("localhost", BODY, "sid=s3cr3t");
+
+        chromium_runtime().block_on(async {
+            let live = init_live_session().await.expect("launch chrome");
+            let _ = live
+                .page
+                .execute(ClearBrowserCookiesParams::default())
+                .await;
+            for site in [&analytics, &signed_in] {
+                navigate_and_get_html(&live.page, &format!("{site}/"))
+                    .await
+                    .expect("first visit");
+            }
+            live.release().await;
+            prefetch_one(&format!("{analytics}/next")).await;
+            prefetch_one(&format!("{signed_in}/next")).await;
+            chrome_pool::shut_down_if_unused().await;
+        });
+
+        assert!(page_cache::contains(
+            &format!("{analytics}/next"),
+            prune_hidden()
+        ));
+        assert!(!page_cache::contains(
+            &format!("{signed_in}/next"),
+            prune_hidden()
+        ));
+    }
+
     /// Load an HTML fixture from a temp file through the real load path.
     #[cfg(not(target_os = "windows"))]
     fn load_fixture(name: &str, html: &str) -> PageLoad {
@@ -7944,7 +8849,7 @@ mod tests {
         let out = chromium_runtime().block_on(async {
             let live = init_live_session().await.expect("launch chrome");
             let out = navigate_and_get_html(&live.page, &url).await;
-            close_browser(&live.session).await;
+            close_live(live).await;
             out
         });
         let _ = std::fs::remove_file(&path);
@@ -7969,7 +8874,7 @@ mod tests {
                 .await
                 .ok()
                 .and_then(|v| v.into_value::<String>().ok());
-            close_browser(&live.session).await;
+            close_live(live).await;
             out
         });
         let _ = std::fs::remove_file(&path);
@@ -8718,7 +9623,7 @@ mod tests {
         let loaded = chromium_runtime().block_on(async {
             let live = init_live_session().await.expect("launch chrome");
             let out = navigate_and_get_html(&live.page, "https://www.google.com/").await;
-            close_browser(&live.session).await;
+            close_live(live).await;
             out
         });
         let loaded = loaded.expect("navigate_and_get_html should not fail");
@@ -8994,6 +9899,24 @@ pub fn register() {
                 "urlHistorySize",
                 "50000",
             ),
+            // No effect on Windows, where there is no live browser to open a
+            // second tab in.
+            sicompass_sdk::SettingDecl::checkbox(
+                "web browser",
+                "prefetch linked pages",
+                "webPrefetchLinks",
+                false,
+            ),
+            // Blank tabs the shared Chrome keeps open. Not on Windows either.
+            sicompass_sdk::SettingDecl::text("web browser", "warm tabs", "webWarmTabs", "1"),
+            // MiB of saved pages kept for offline reading, as
+            // `archive::DEFAULT_SIZE_MB`; 0 saves none.
+            sicompass_sdk::SettingDecl::text(
+                "web browser",
+                "offline archive size (MB)",
+                "webArchiveSizeMb",
+                "200",
+            ),
         ]),
     );
     sicompass_sdk::register_url_fetcher(fetch_url_to_ffon);
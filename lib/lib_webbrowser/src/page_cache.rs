@@ -0,0 +1,670 @@
+//! Cache of rendered pages, so revisiting one does not go back through Chrome.
+//!
+//! What is cached is the finished FFON tree: the HTML after the prune and
+//! banding scripts ran and after the walker turned it into elements, i.e.
+//! everything the slow path produces. Two tiers:
+//!
+//! * a small in-memory LRU, which answers back/forward and history rows within
+//!   a session without any I/O;
+//! * an SQLite table under the cache dir, which outlives the session.
+//!
+//! An entry younger than [`FRESH_SECS`] is served as is. An older one is
+//! revalidated against the server with the ETag / Last-Modified the document
+//! had when it was stored, by a conditional HEAD, and served only if the server
+//! says it has not changed. Without validators a stale entry is a miss.
+//!
+//! Keyed by URL *and* by the hidden-content toggle: the two renderings of a
+//! page are different trees.
+//!
+//! Process-global for the same reason `PRUNE_HIDDEN` is: `fetch_url_to_ffon`,
+//! which the app uses to follow a link, reaches the renderer with no provider
+//! instance in scope — and a followed link is exactly what prefetch warms.
+//!
+//! What may be cached at all is the caller's call (see `remember_page`): only a
+//! page that reads the same whoever asks, so nothing requested with cookies or
+//! credentials. A page with forms is cached but flagged: its form map points
+//! into the tab that rendered it, so the provider's own navigation, which has
+//! to fill and submit those forms, loads it for real. Following a link from the
+//! app only reads the page and takes it either way.
+//!
+//! DB location: platform cache dir + `/sicompass/webbrowser/pages.db`.
+
+use rusqlite::{Connection, OptionalExtension, params};
+use sicompass_sdk::ffon::{self, FfonElement};
+use std::collections::{HashMap, VecDeque};
+use std::path::{Path, PathBuf};
+use std::sync::{Mutex, OnceLock};
+
+/// Pages kept in memory. A back/forward stack rarely goes deeper.
+const MEMORY_PAGES: usize = 16;
+
+/// Pages kept on disk; the oldest go first.
+const DISK_PAGES: i64 = 500;
+
+/// How long an entry is served without asking the server.
+const FRESH_SECS: u64 = 300;
+
+/// Revalidation is a single HEAD; a server that cannot answer it quickly is
+/// treated as "changed" and the page is loaded for real.
+const REVALIDATE_TIMEOUT_SECS: u64 = 5;
+
+/// URL plus whether hidden content was pruned.
+type Key = (String, bool);
+
+/// The document's cache validators, as its server sent them.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub(crate) struct Validators {
+    pub etag: Option<String>,
+    pub last_modified: Option<String>,
+}
+
+impl Validators {
+    fn is_empty(&self) -> bool {
+        self.etag.is_none() && self.last_modified.is_none()
+    }
+}
+
+#[derive(Clone)]
+struct Entry {
+    elements: Vec<FfonElement>,
+    has_forms: bool,
+    validators: Validators,
+    /// Unix seconds the page was rendered or last revalidated.
+    stored_at: u64,
+}
+
+impl Entry {
+    fn is_fresh(&self, now: u64) -> bool {
+        now.saturating_sub(self.stored_at) < FRESH_SECS
+    }
+
+    /// Whether a caller that does (`with_forms`) or does not take a page with
+    /// forms can use this entry.
+    fn usable(&self, with_forms: bool) -> bool {
+        with_forms || !self.has_forms
+    }
+}
+
+fn now_secs() -> u64 {
+    std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map(|d| d.as_secs())
+        .unwrap_or(0)
+}
+
+// ---------------------------------------------------------------------------
+// In-memory tier
+// ---------------------------------------------------------------------------
+
+#[derive(Default)]
+struct MemoryLru {
+    entries: HashMap<Key, Entry>,
+    /// Least recently used at the front.
+    order: VecDeque<Key>,
+}
+
+impl MemoryLru {
+    fn touch(&mut self, key: &Key) {
+        if let Some(pos) = self.order.iter().position(|k| k == key) {
+            let k = self.order.remove(pos).expect("position is in range");
+            self.order.push_back(k);
+        }
+    }
+
+    fn get(&mut self, key: &Key) -> Option<&mut Entry> {
+        if !self.entries.contains_key(key) {
+            return None;
+        }
+        self.touch(key);
+        self.entries.get_mut(key)
+    }
+
+    fn insert(&mut self, key: Key, entry: Entry) {
+        if self.entries.insert(key.clone(), entry).is_some() {
+            self.touch(&key);
+            return;
+        }
+        self.order.push_back(key);
+        while self.order.len() > MEMORY_PAGES {
+            if let Some(oldest) = self.order.pop_front() {
+                self.entries.remove(&oldest);
+            }
+        }
+    }
+
+    fn remove(&mut self, key: &Key) {
+        if self.entries.remove(key).is_some() {
+            self.order.retain(|k| k != key);
+        }
+    }
+
+    fn clear(&mut self) {
+        self.entries.clear();
+        self.order.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// On-disk tier
+// ---------------------------------------------------------------------------
+
+pub(crate) struct PageStore {
+    conn: Connection,
+}
+
+impl PageStore {
+    /// Open (or create) the store at `path`.
+    ///
+    /// Returns `None` if the directory cannot be created or the DB cannot be
+    /// opened — the cache then lives in memory only.
+    pub fn open(path: &Path) -> Option<Self> {
+        if let Some(parent) = path.parent() {
+            std::fs::create_dir_all(parent).ok()?;
+        }
+        let conn = Connection::open(path).ok()?;
+        let store = PageStore { conn };
+        store.init_schema().ok()?;
+        Some(store)
+    }
+
+    fn init_schema(&self) -> rusqlite::Result<()> {
+        self.conn.execute_batch(
+            "CREATE TABLE IF NOT EXISTS pages (
+                url           TEXT    NOT NULL,
+                pruned        INTEGER NOT NULL,
+                etag          TEXT,
+                last_modified TEXT,
+                stored_at     INTEGER NOT NULL,
+                has_forms     INTEGER NOT NULL,
+                tree          BLOB    NOT NULL,
+                PRIMARY KEY (url, pruned)
+            );
+            CREATE INDEX IF NOT EXISTS pages_stored_at ON pages(stored_at);",
+        )
+    }
+
+    fn load(&self, key: &Key) -> Option<Entry> {
+        self.conn
+            .query_row(
+                "SELECT etag, last_modified, stored_at, has_forms, tree FROM pages
+                 WHERE url = ?1 AND pruned = ?2",
+                params![key.0, key.1],
+                |row| {
+                    let tree: Vec<u8> = row.get(4)?;
+                    Ok(Entry {
+                        elements: ffon::deserialize_binary(&tree),
+                        has_forms: row.get(3)?,
+                        validators: Validators {
+                            etag: row.get(0)?,
+                            last_modified: row.get(1)?,
+                        },
+                        stored_at: row.get::<_, i64>(2)? as u64,
+                    })
+                },
+            )
+            .optional()
+            .ok()
+            .flatten()
+    }
+
+    /// Write `entry`, then drop whatever falls past [`DISK_PAGES`].
+    fn save(&self, key: &Key, entry: &Entry) {
+        let _ = self.conn.execute(
+            "INSERT OR REPLACE INTO pages
+                 (url, pruned, etag, last_modified, stored_at, has_forms, tree)
+             VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)",
+            params![
+                key.0,
+                key.1,
+                entry.validators.etag,
+                entry.validators.last_modified,
+                entry.stored_at as i64,
+                entry.has_forms,
+                ffon::serialize_binary(&entry.elements),
+            ],
+        );
+        let _ = self.conn.execute(
+            "DELETE FROM pages WHERE rowid NOT IN
+                 (SELECT rowid FROM pages ORDER BY stored_at DESC LIMIT ?1)",
+            params![DISK_PAGES],
+        );
+    }
+
+    fn set_validators(&self, key: &Key, validators: &Validators) {
+        let _ = self.conn.execute(
+            "UPDATE pages SET etag = ?3, last_modified = ?4 WHERE url = ?1 AND pruned = ?2",
+            params![key.0, key.1, validators.etag, validators.last_modified],
+        );
+    }
+
+    fn touch(&self, key: &Key, now: u64) {
+        let _ = self.conn.execute(
+            "UPDATE pages SET stored_at = ?3 WHERE url = ?1 AND pruned = ?2",
+            params![key.0, key.1, now as i64],
+        );
+    }
+
+    fn remove(&self, url: &str) {
+        let _ = self
+            .conn
+            .execute("DELETE FROM pages WHERE url = ?1", params![url]);
+    }
+
+    fn clear(&self) {
+        let _ = self.conn.execute("DELETE FROM pages", []);
+    }
+}
+
+/// Where the on-disk tier lives, or `None` under test or without a cache dir.
+fn store_path() -> Option<PathBuf> {
+    if crate::test_no_history() {
+        return None;
+    }
+    sicompass_sdk::platform::cache_home()
+        .map(|c| c.join("sicompass").join("webbrowser").join("pages.db"))
+}
+
+// ---------------------------------------------------------------------------
+// Both tiers together
+// ---------------------------------------------------------------------------
+
+/// Both tiers, each behind its own lock. The memory lock is never held across
+/// disk I/O, so [`peek`] waits at most for another in-memory lookup. Where both
+/// are needed the disk lock is taken first.
+#[derive(Default)]
+struct PageCache {
+    memory: Mutex<MemoryLru>,
+    disk: Mutex<Disk>,
+}
+
+#[derive(Default)]
+struct Disk {
+    store: Option<PageStore>,
+    opened: bool,
+}
+
+impl Disk {
+    /// The on-disk tier, opened on first use.
+    fn store(&mut self) -> Option<&PageStore> {
+        if !self.opened {
+            self.opened = true;
+            self.store = store_path().and_then(|p| PageStore::open(&p));
+        }
+        self.store.as_ref()
+    }
+}
+
+impl PageCache {
+    /// Memory first, then disk. A disk hit is promoted into memory.
+    fn get(&self, key: &Key) -> Option<Entry> {
+        if let Some(entry) = self.memory.lock().ok()?.get(key) {
+            return Some(entry.clone());
+        }
+        let entry = self.disk.lock().ok()?.store()?.load(key)?;
+        self.memory.lock().ok()?.insert(key.clone(), entry.clone());
+        Some(entry)
+    }
+
+    fn put(&self, key: Key, entry: Entry) {
+        let Ok(mut disk) = self.disk.lock() else {
+            return;
+        };
+        if let Some(store) = disk.store() {
+            store.save(&key, &entry);
+        }
+        if let Ok(mut memory) = self.memory.lock() {
+            memory.insert(key, entry);
+        }
+    }
+
+    fn touch(&self, key: &Key, now: u64) {
+        if let Ok(mut memory) = self.memory.lock()
+            && let Some(entry) = memory.get(key)
+        {
+            entry.stored_at = now;
+        }
+        if let Ok(mut disk) = self.disk.lock()
+            && let Some(store) = disk.store()
+        {
+            store.touch(key, now);
+        }
+    }
+
+    fn set_validators(&self, key: &Key, validators: Validators) {
+        if let Ok(mut disk) = self.disk.lock()
+            && let Some(store) = disk.store()
+        {
+            store.set_validators(key, &validators);
+        }
+        if let Ok(mut memory) = self.memory.lock()
+            && let Some(entry) = memory.get(key)
+        {
+            entry.validators = validators;
+        }
+    }
+
+    /// Drop `key` from memory only, after the server said it changed.
+    fn evict(&self, key: &Key) {
+        if let Ok(mut memory) = self.memory.lock() {
+            memory.remove(key);
+        }
+    }
+
+    fn remove(&self, url: &str) {
+        let Ok(mut disk) = self.disk.lock() else {
+            return;
+        };
+        if let Some(store) = disk.store() {
+            store.remove(url);
+        }
+        if let Ok(mut memory) = self.memory.lock() {
+            for pruned in [true, false] {
+                memory.remove(&(url.to_owned(), pruned));
+            }
+        }
+    }
+
+    fn clear(&self) {
+        let Ok(mut disk) = self.disk.lock() else {
+            return;
+        };
+        if let Some(store) = disk.store() {
+            store.clear();
+        }
+        if let Ok(mut memory) = self.memory.lock() {
+            memory.clear();
+        }
+    }
+}
+
+fn cache() -> &'static PageCache {
+    static CACHE: OnceLock<PageCache> = OnceLock::new();
+    CACHE.get_or_init(PageCache::default)
+}
+
+/// A page from memory, if it is there and fresh. Never touches the disk, so
+/// the render thread can ask before deciding whether a load is needed at all.
+pub(crate) fn peek(url: &str, pruned: bool, with_forms: bool) -> Option<Vec<FfonElement>> {
+    let key = (url.to_owned(), pruned);
+    let mut memory = cache().memory.lock().ok()?;
+    let entry = memory.get(&key)?;
+    (entry.usable(with_forms) && entry.is_fresh(now_secs())).then(|| entry.elements.clone())
+}
+
+/// A page from either tier, revalidating a stale one with the server first.
+pub(crate) async fn lookup(url: &str, pruned: bool, with_forms: bool) -> Option<Vec<FfonElement>> {
+    let key = (url.to_owned(), pruned);
+    let now = now_secs();
+    let entry = cache().get(&key)?;
+    if !entry.usable(with_forms) {
+        return None;
+    }
+    if entry.is_fresh(now) {
+        return Some(entry.elements);
+    }
+    if entry.validators.is_empty() {
+        return None;
+    }
+    let unchanged = match head(url, Some(&entry.validators)).await {
+        Some((status, current)) => still_valid(&entry.validators, status, &current),
+        None => false,
+    };
+    if unchanged {
+        cache().touch(&key, now);
+        Some(entry.elements)
+    } else {
+        cache().evict(&key);
+        None
+    }
+}
+
+/// Whether either tier holds `url` at all, fresh or not. Prefetch asks this
+/// to skip links it would only be re-rendering.
+pub(crate) fn contains(url: &str, pruned: bool) -> bool {
+    let key = (url.to_owned(), pruned);
+    cache().get(&key).is_some()
+}
+
+/// Cache a freshly rendered page. Its validators are not known yet — Chrome
+/// does not hand the response headers back — so [`capture_validators`] fills
+/// them in afterwards.
+pub(crate) fn store(url: &str, pruned: bool, elements: &[FfonElement], has_forms: bool) {
+    let entry = Entry {
+        elements: elements.to_vec(),
+        has_forms,
+        validators: Validators::default(),
+        stored_at: now_secs(),
+    };
+    cache().put((url.to_owned(), pruned), entry);
+}
+
+/// Ask the server for the validators of a page just stored. Until this lands
+/// (or when the server sends none) the entry is good for [`FRESH_SECS`] only.
+pub(crate) async fn capture_validators(url: String, pruned: bool) {
+    let Some((200, validators)) = head(&url, None).await else {
+        return;
+    };
+    if validators.is_empty() {
+        return;
+    }
+    cache().set_validators(&(url, pruned), validators);
+}
+
+/// Drop every rendering of `url`. The refresh command goes through this, so
+/// "reload" always means from the server.
+pub(crate) fn forget(url: &str) {
+    cache().remove(url);
+}
+
+/// Drop everything. A page can be personalised by the cookies that rendered
+/// it, so clearing cookies clears this too.
+pub(crate) fn clear() {
+    cache().clear();
+}
+
+// ---------------------------------------------------------------------------
+// Revalidation
+// ---------------------------------------------------------------------------
+
+fn http() -> &'static reqwest::Client {
+    static CLIENT: OnceLock<reqwest::Client> = OnceLock::new();
+    CLIENT.get_or_init(|| {
+        reqwest::Client::builder()
+            .timeout(std::time::Duration::from_secs(REVALIDATE_TIMEOUT_SECS))
+            .build()
+            .unwrap_or_else(|_| reqwest::Client::new())
+    })
+}
+
+fn header(resp: &reqwest::Response, name: reqwest::header::HeaderName) -> Option<String> {
+    resp.headers()
+        .get(name)
+        .and_then(|v| v.to_str().ok())
+        .map(str::to_owned)
+}
+
+/// HEAD `url`, conditional on `known` when given. Returns the status and the
+/// validators the server sent back; `None` on any transport failure.
+async fn head(url: &str, known: Option<&Validators>) -> Option<(u16, Validators)> {
+    use reqwest::header::{ETAG, IF_MODIFIED_SINCE, IF_NONE_MATCH, LAST_MODIFIED};
+    let mut req = http().head(url);
+    if let Some(known) = known {
+        if let Some(etag) = &known.etag {
+            req = req.header(IF_NONE_MATCH, etag);
+        }
+        if let Some(last_modified) = &known.last_modified {
+            req = req.header(IF_MODIFIED_SINCE, last_modified);
+        }
+    }
+    let resp = req.send().await.ok()?;
+    let validators = Validators {
+        etag: header(&resp, ETAG),
+        last_modified: header(&resp, LAST_MODIFIED),
+    };
+    Some((resp.status().as_u16(), validators))
+}
+
+/// Whether a revalidation response says the stored page is still current.
+///
+/// 304 is the plain yes. A 200 counts too when it carries the very validators
+/// the page was stored with: plenty of servers ignore conditional headers on
+/// HEAD and answer in full. The ETag is compared when there is one, since a
+/// Last-Modified date only has one-second resolution.
+fn still_valid(stored: &Validators, status: u16, current: &Validators) -> bool {
+    match status {
+        304 => true,
+        200 => match &stored.etag {
+            Some(etag) => current.etag.as_ref() == Some(etag),
+            None => stored.last_modified.is_some() && stored.last_modified == current.last_modified,
+        },
+        _ => false,
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn entry(text: &str, stored_at: u64) -> Entry {
+        Entry {
+            elements: vec![FfonElement::new_str(text.to_owned())],
+            has_forms: false,
+            validators: Validators::default(),
+            stored_at,
+        }
+    }
+
+    fn key(url: &str) -> Key {
+        (url.to_owned(), true)
+    }
+
+    fn text(entry: &Entry) -> Vec<u8> {
+        ffon::serialize_binary(&entry.elements)
+    }
+
+    #[test]
+    fn store_round_trips_a_page_and_its_validators() {
+        let dir = tempfile::tempdir().unwrap();
+        let store = PageStore::open(&dir.path().join("pages.db")).unwrap();
+        let mut page = entry("hello", 42);
+        page.has_forms = true;
+        store.save(&key("https://a.invalid/"), &page);
+
+        let validators = Validators {
+            etag: Some("\"v1\"".to_owned()),
+            last_modified: None,
+        };
+        store.set_validators(&key("https://a.invalid/"), &validators);
+
+        let loaded = store.load(&key("https://a.invalid/")).unwrap();
+        assert_eq!(text(&loaded), text(&page));
+        assert_eq!(loaded.stored_at, 42);
+        assert!(loaded.has_forms);
+        assert_eq!(loaded.validators, validators);
+        // The other rendering of the same URL is a separate entry.
+        assert!(
+            store
+                .load(&("https://a.invalid/".to_owned(), false))
+                .is_none()
+        );
+
+        store.remove("https://a.invalid/");
+        assert!(store.load(&key("https://a.invalid/")).is_none());
+    }
+
+    #[test]
+    fn store_keeps_only_the_newest_pages() {
+        let dir = tempfile::tempdir().unwrap();
+        let store = PageStore::open(&dir.path().join("pages.db")).unwrap();
+        for i in 0..=DISK_PAGES {
+            store.save(
+                &key(&format!("https://a.invalid/{i}")),
+                &entry("p", i as u64),
+            );
+        }
+        assert!(store.load(&key("https://a.invalid/0")).is_none());
+        assert!(store.load(&key("https://a.invalid/1")).is_some());
+        assert!(
+            store
+                .load(&key(&format!("https://a.invalid/{DISK_PAGES}")))
+                .is_some()
+        );
+    }
+
+    #[test]
+    fn memory_evicts_the_least_recently_used() {
+        let mut lru = MemoryLru::default();
+        for i in 0..MEMORY_PAGES {
+            lru.insert(key(&i.to_string()), entry("p", 0));
+        }
+        // Reading "0" makes "1" the oldest.
+        assert!(lru.get(&key("0")).is_some());
+        lru.insert(key("new"), entry("p", 0));
+        assert!(lru.get(&key("0")).is_some());
+        assert!(lru.get(&key("1")).is_none());
+        assert_eq!(lru.entries.len(), MEMORY_PAGES);
+        assert_eq!(lru.order.len(), MEMORY_PAGES);
+    }
+
+    #[test]
+    fn freshness_window() {
+        let page = entry("p", 1_000);
+        assert!(page.is_fresh(1_000 + FRESH_SECS - 1));
+        assert!(!page.is_fresh(1_000 + FRESH_SECS));
+    }
+
+    #[test]
+    fn a_page_with_forms_is_only_for_callers_that_take_one() {
+        let mut page = entry("p", 0);
+        assert!(page.usable(false));
+        page.has_forms = true;
+        assert!(page.usable(true));
+        assert!(!page.usable(false));
+    }
+
+    #[test]
+    fn a_stored_page_is_served_from_memory_until_forgotten() {
+        // Process-global: a URL no other test uses. The disk tier is off
+        // under test, so this never leaves memory.
+        let url = "https://page-cache-memory.invalid/";
+        store(url, true, &[FfonElement::new_str("hi".to_owned())], true);
+        assert!(peek(url, true, true).is_some());
+        assert!(peek(url, true, false).is_none(), "has forms");
+        assert!(peek(url, false, true).is_none(), "other rendering");
+        assert!(contains(url, true));
+        forget(url);
+        assert!(peek(url, true, true).is_none());
+    }
+
+    #[test]
+    fn revalidation_verdicts() {
+        let tagged = Validators {
+            etag: Some("\"v1\"".to_owned()),
+            last_modified: Some("Mon, 05 Oct 2026 10:00:00 GMT".to_owned()),
+        };
+        let dated = Validators {
+            etag: None,
+            last_modified: tagged.last_modified.clone(),
+        };
+        assert!(still_valid(&tagged, 304, &Validators::default()));
+        assert!(still_valid(&tagged, 200, &tagged));
+        // A new ETag wins over an unchanged date.
+        let retagged = Validators {
+            etag: Some("\"v2\"".to_owned()),
+            ..tagged.clone()
+        };
+        assert!(!still_valid(&tagged, 200, &retagged));
+        assert!(still_valid(&dated, 200, &dated));
+        assert!(!still_valid(&dated, 200, &Validators::default()));
+        assert!(!still_valid(
+            &Validators::default(),
+            200,
+            &Validators::default()
+        ));
+        assert!(!still_valid(&tagged, 404, &tagged));
+    }
+}
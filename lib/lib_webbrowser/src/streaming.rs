@@ -0,0 +1,267 @@
+//! Band-wise HTML→FFON, so a page can be shown before it has finished loading
+//! and a later snapshot of it only converts what changed.
+//!
+//! The prune pass writes a `<!--sic-band:N-->` comment after every top-level
+//! landmark of the copy it serialises, where `N` is the number of `<form>`s
+//! before that point.  Those are the only safe cuts: FFON nests everything
+//! after a heading underneath it regardless of DOM ancestry, and a landmark is
+//! the one thing that ends that, so a band converted on its own comes out just
+//! as it would have in place.  Forms are numbered across the whole document,
+//! so each band is converted behind `N` empty `<form>` shells — counted, but
+//! emitting no node, the same trick the prune plays when it drops a form.
+//!
+//! A band's FFON is kept against a hash of its HTML and its form offset, and
+//! reused while both are unchanged.  The first snapshot of a page, taken at
+//! DOMContentLoaded, converts everything it has; the settled one converts only
+//! the bands that arrived or changed since, and so does a refresh of the same
+//! URL.  HTML without markers — pruning off, the `page.content()` fallback, a
+//! gate page — is a single band, i.e. the plain one-pass conversion.
+
+use sicompass_sdk::ffon::{FfonElement, FormMap, html_to_ffon_with_forms};
+use std::collections::HashMap;
+use std::hash::{DefaultHasher, Hash, Hasher};
+
+/// Opens a band marker; the form count and `-->` follow.
+pub(crate) const BAND_MARK: &str = "<!--sic-band:";
+
+/// A converted band.
+struct Band {
+    key: u64,
+    elements: Vec<FfonElement>,
+}
+
+/// The bands of the last page converted, kept for the next snapshot of it.
+#[derive(Default)]
+pub(crate) struct BandConverter {
+    url: String,
+    bands: Vec<Band>,
+    /// Bands converted (rather than reused) by the last call.
+    #[cfg(test)]
+    converted: usize,
+}
+
+impl BandConverter {
+    /// Convert `html`, reusing every band that is unchanged since the last
+    /// call for the same `url`.
+    ///
+    /// A band with a form in it is converted every time: its form map moves
+    /// into the page's rather than being kept.  They are rare and small — a
+    /// search box, a newsletter signup — so that costs little.
+    pub(crate) fn convert(&mut self, html: &str, url: &str) -> (Vec<FfonElement>, FormMap) {
+        if self.url != url {
+            self.url = url.to_owned();
+            self.bands.clear();
+        }
+        let mut kept: HashMap<u64, Band> = self.bands.drain(..).map(|b| (b.key, b)).collect();
+        #[cfg(test)]
+        {
+            self.converted = 0;
+        }
+
+        let mut elements = Vec::new();
+        let mut form_map = FormMap::new();
+        for (forms_before, segment) in split_bands(html) {
+            let key = band_key(segment, forms_before);
+            if let Some(band) = kept.remove(&key) {
+                elements.extend(band.elements.iter().cloned());
+                self.bands.push(band);
+                continue;
+            }
+            #[cfg(test)]
+            {
+                self.converted += 1;
+            }
+            let (band_elements, band_forms) = if forms_before == 0 {
+                html_to_ffon_with_forms(segment, url)
+            } else {
+                let shells = "<form></form>".repeat(forms_before);
+                html_to_ffon_with_forms(&format!("{shells}{segment}"), url)
+            };
+            if band_forms.is_empty() {
+                elements.extend(band_elements.iter().cloned());
+                self.bands.push(Band {
+                    key,
+                    elements: band_elements,
+                });
+            } else {
+                elements.extend(band_elements);
+                form_map.extend(band_forms);
+            }
+        }
+        (elements, form_map)
+    }
+
+    /// Bands converted, rather than reused, by the last call.
+    #[cfg(test)]
+    pub(crate) fn converted(&self) -> usize {
+        self.converted
+    }
+}
+
+/// `html` cut at its band markers, each piece with the number of forms before
+/// it.  A marker that does not parse is left in the text, where the converter
+/// ignores it as the comment it is.
+fn split_bands(html: &str) -> Vec<(usize, &str)> {
+    let mut bands = Vec::new();
+    let mut rest = html;
+    let mut forms_before = 0;
+    while let Some(at) = rest.find(BAND_MARK) {
+        let after = &rest[at + BAND_MARK.len()..];
+        let Some((count, tail)) = after
+            .split_once("-->")
+            .and_then(|(n, tail)| Some((n.parse::<usize>().ok()?, tail)))
+        else {
+            break;
+        };
+        bands.push((forms_before, &rest[..at]));
+        forms_before = count;
+        rest = tail;
+    }
+    bands.push((forms_before, rest));
+    bands.retain(|(_, segment)| !segment.trim().is_empty());
+    bands
+}
+
+fn band_key(segment: &str, forms_before: usize) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    segment.hash(&mut hasher);
+    forms_before.hash(&mut hasher);
+    hasher.finish()
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// A banded page the way the prune pass serialises one: a heading ahead of
+    /// the first landmark, forms in two different bands, a trailing run.
+    fn banded_page(article: &str) -> String {
+        format!(
+            "<!DOCTYPE html><html><head><title>T</title></head><body>\
+             <h1>Site</h1><nav><a href='/a'>Alpha</a>\
+             <form><input name='q'><button>Search</button></form></nav>\
+             <!--sic-band:1-->\
+             <main><h2>Article</h2><p>{article}</p></main><!--sic-band:1-->\
+             <aside><h3>Related</h3><p>Other reading</p></aside><!--sic-band:1-->\
+             <footer><form><input name='mail'><button>Subscribe</button></form>\
+             <a href='/p'>Privacy</a></footer><!--sic-band:2-->\
+             <p>Trailing text</p></body></html>"
+        )
+    }
+
+    #[test]
+    fn banded_conversion_matches_the_one_pass_conversion() {
+        let html = banded_page("Body text");
+        let (whole, whole_forms) = html_to_ffon_with_forms(&html, "https://example.com");
+        let (banded, banded_forms) = BandConverter::default().convert(&html, "https://example.com");
+        assert_eq!(format!("{banded:?}"), format!("{whole:?}"));
+
+        let mut whole_keys: Vec<_> = whole_forms.keys().cloned().collect();
+        let mut banded_keys: Vec<_> = banded_forms.keys().cloned().collect();
+        whole_keys.sort();
+        banded_keys.sort();
+        assert_eq!(banded_keys, whole_keys);
+        assert!(
+            banded_keys.iter().any(|k| k.starts_with("form_2/")),
+            "the footer's form keeps its document-wide number; got: {banded_keys:?}"
+        );
+    }
+
+    #[test]
+    fn a_second_snapshot_converts_only_what_changed() {
+        let mut converter = BandConverter::default();
+        converter.convert(&banded_page("First draft"), "https://example.com");
+        assert_eq!(converter.converted(), 5);
+
+        // The article changed; the aside and the trailing run did not. The two
+        // bands holding forms are converted every time.
+        let (elements, _) = converter.convert(&banded_page("Final text"), "https://example.com");
+        assert_eq!(converter.converted(), 3);
+        assert!(format!("{elements:?}").contains("Final text"));
+
+        // Another page starts over.
+        converter.convert(&banded_page("Final text"), "https://example.org");
+        assert_eq!(converter.converted(), 5);
+    }
+
+    #[test]
+    fn html_without_markers_is_one_band() {
+        let html = "<html><body><h1>A</h1><p>B</p></body></html>";
+        assert_eq!(split_bands(html), vec![(0, html)]);
+        // A mangled marker is left for the converter to ignore.
+        let mangled = "<p>A</p><!--sic-band:x--><p>B</p>";
+        assert_eq!(split_bands(mangled), vec![(0, mangled)]);
+    }
+
+    /// Band-wise against one-pass conversion on a large page.
+    ///
+    /// Ignored by default; run deliberately:
+    ///
+    /// ```text
+    /// cargo test -p sicompass-webbrowser --release -- --ignored --nocapture banded_conversion_cost
+    /// ```
+    ///
+    /// `SICOMPASS_BENCH_HTML` points it at a saved page instead of the
+    /// synthetic one, e.g. a 5 MB Wikipedia article.  Save it from `settled_html`
+    /// for it to carry band markers; a page saved any other way is one band.
+    #[test]
+    #[ignore = "manual profiling aid; prints timings instead of asserting"]
+    fn banded_conversion_cost() {
+        let html = match std::env::var("SICOMPASS_BENCH_HTML") {
+            Ok(path) => std::fs::read_to_string(path).expect("read the saved page"),
+            Err(_) => {
+                let mut html = String::from("<!DOCTYPE html><html><body>");
+                for band in 0..200 {
+                    html.push_str(&format!("<main><h2>Section {band}</h2>"));
+                    for p in 0..100 {
+                        html.push_str(&format!(
+                            "<p>Paragraph {p} of section {band}, with \
+                             <a href='/wiki/{band}_{p}'>a link</a> in it.</p>"
+                        ));
+                    }
+                    html.push_str("</main><!--sic-band:0-->");
+                }
+                html.push_str("</body></html>");
+                html
+            }
+        };
+        let url = "https://en.wikipedia.org/wiki/Bench";
+        let bands = split_bands(&html).len();
+        println!("\n  {} KiB of HTML in {bands} band(s)", html.len() / 1024);
+
+        let t = std::time::Instant::now();
+        std::hint::black_box(html_to_ffon_with_forms(&html, url));
+        println!("  one pass               {:>10.2?}", t.elapsed());
+
+        // What DOMContentLoaded typically has: the first half of the bands.
+        let half = html
+            .match_indices(BAND_MARK)
+            .map(|(at, _)| at)
+            .nth(bands / 2)
+            .unwrap_or(html.len());
+        let mut converter = BandConverter::default();
+        let t = std::time::Instant::now();
+        std::hint::black_box(converter.convert(&html[..half], url));
+        println!("  first paint (½ bands)  {:>10.2?}", t.elapsed());
+
+        let t = std::time::Instant::now();
+        std::hint::black_box(converter.convert(&html, url));
+        println!(
+            "  settled, rest appended {:>10.2?}   ({} band(s) converted)",
+            t.elapsed(),
+            converter.converted()
+        );
+
+        let t = std::time::Instant::now();
+        std::hint::black_box(converter.convert(&html, url));
+        println!(
+            "  refresh, unchanged     {:>10.2?}   ({} band(s) converted)\n",
+            t.elapsed(),
+            converter.converted()
+        );
+    }
+}
@@ -14,12 +14,16 @@
 //! Exposes two public operations:
 //!
 //! * [`AccessKitAdapter::new`] — create the adapter from the SDL3 window.
-//! * [`AccessKitAdapter::update_if_active`] — rebuild the accessibility tree
-//!   from the current [`AppRenderer`] state, but only when an assistive
-//!   technology is actually listening (zero overhead otherwise).
+//! * [`AccessKitAdapter::update_if_active`] — bring the accessibility tree up
+//!   to date with the current [`AppRenderer`] state, but only when an assistive
+//!   technology is actually listening (zero overhead otherwise).  Only nodes
+//!   that changed since the last push are sent, and nothing at all on a frame
+//!   where nothing did.
 
 use crate::app_state::AppRenderer;
 use accesskit::{Live, Node, NodeId, Role, Tree, TreeId, TreeUpdate};
+use std::cell::RefCell;
+use std::collections::HashMap;
 
 // ---------------------------------------------------------------------------
 // Node-ID convention
@@ -49,6 +53,10 @@ pub struct AccessKitAdapter {
     registered: std::sync::Arc<std::sync::atomic::AtomicBool>,
     #[cfg(target_os = "windows")]
     adapter: accesskit_windows::SubclassingAdapter,
+    /// What the platform adapter's tree currently says; the baseline the next
+    /// update is diffed against.  See [`tree_update`].
+    #[cfg(any(target_os = "linux", target_os = "windows"))]
+    published: Published,
     #[cfg(target_os = "macos")]
     adapter: accesskit_macos::SubclassingAdapter,
     /// Tracks what has already been spoken, so the single macOS live region
@@ -177,7 +185,10 @@ impl AccessKitAdapter {
         #[cfg(target_os = "linux")]
         {
             let registered = std::sync::Arc::new(std::sync::atomic::AtomicBool::new(false));
-            let initial_tree = build_tree(renderer);
+            // The adapter starts from this tree whenever the AT connects, so it
+            // is also the baseline for the first diff.
+            let published = Published::of(renderer);
+            let initial_tree = full_tree(&published);
             let adapter = accesskit_unix::Adapter::new(
                 ActivationHandlerImpl {
                     initial_tree: Some(initial_tree),
@@ -189,6 +200,7 @@ impl AccessKitAdapter {
             return Some(AccessKitAdapter {
                 adapter,
                 registered,
+                published,
             });
         }
 
@@ -210,7 +222,8 @@ impl AccessKitAdapter {
             if hwnd_ptr.is_null() {
                 return None;
             }
-            let initial_tree = build_tree(renderer);
+            let published = Published::of(renderer);
+            let initial_tree = full_tree(&published);
             let adapter = accesskit_windows::SubclassingAdapter::new(
                 HWND(hwnd_ptr),
                 ActivationHandlerImpl {
@@ -218,7 +231,7 @@ impl AccessKitAdapter {
                 },
                 NoopActionHandler,
             );
-            return Some(AccessKitAdapter { adapter });
+            return Some(AccessKitAdapter { adapter, published });
         }
 
         // ---- macOS (NSAccessibility) ----------------------------------------
@@ -267,16 +280,39 @@ impl AccessKitAdapter {
         None
     }
 
-    /// Rebuild the accessibility tree from `renderer` and push it to the
+    /// Push whatever changed in `renderer` since the last update to the
     /// platform adapter — but only when an AT is actively listening.
+    ///
+    /// Called every frame, so an unchanged frame returns before touching the
+    /// adapter at all.  The baseline only advances when the adapter takes the
+    /// update: while it is inactive it still holds the initial tree.
     #[allow(unused_variables)]
     pub fn update_if_active(&mut self, renderer: &AppRenderer) {
-        #[cfg(target_os = "linux")]
-        self.adapter.update_if_active(|| build_tree(renderer));
+        #[cfg(any(target_os = "linux", target_os = "windows"))]
+        {
+            let next = Published::of(renderer);
+            if next == self.published {
+                return;
+            }
+            let published = &self.published;
+            let mut taken = false;
+            let update = || {
+                taken = true;
+                tree_update(Some(published), &next)
+                    .expect("a changed snapshot always yields an update")
+            };
 
-        #[cfg(target_os = "windows")]
-        if let Some(events) = self.adapter.update_if_active(|| build_tree(renderer)) {
-            events.raise();
+            #[cfg(target_os = "linux")]
+            self.adapter.update_if_active(update);
+
+            #[cfg(target_os = "windows")]
+            if let Some(events) = self.adapter.update_if_active(update) {
+                events.raise();
+            }
+
+            if taken {
+                self.published = next;
+            }
         }
 
         // macOS: choose the live-region text *before* borrowing `self.adapter`
@@ -428,6 +464,20 @@ fn speech_content(label: &str) -> &str {
     s
 }
 
+/// Distinct contents whose detected language is remembered.  Enough for the
+/// items a user moves between in a session; past it the memo starts over.
+const LANGUAGE_MEMO_ENTRIES: usize = 4096;
+
+thread_local! {
+    /// [`detect_language`] results by content.  The selected item's language
+    /// is asked for on the render thread every frame, and whatlang scores every
+    /// candidate language over the whole text each time, which on a long label
+    /// costs more than the rest of the update together.  A label's language
+    /// never changes, so each distinct content is classified once.
+    static LANGUAGE_MEMO: RefCell<HashMap<String, Option<String>>> =
+        RefCell::new(HashMap::new());
+}
+
 /// Best-effort BCP-47 language tag for `content`, or `None` when detection is
 /// not trustworthy (too short, low confidence, or a language we don't map).
 /// The caller falls back to the active UI locale in that case.
@@ -440,7 +490,25 @@ fn speech_content(label: &str) -> &str {
 /// The floor is deliberately well below `Info::is_reliable()`'s 0.9 (which
 /// rejects most ordinary one-line sentences); the length guard already filters
 /// out the genuinely ambiguous fragments.
+///
+/// Memoized per content in [`LANGUAGE_MEMO`].
 fn detect_language(content: &str) -> Option<String> {
+    if let Some(tag) = LANGUAGE_MEMO.with(|m| m.borrow().get(content).cloned()) {
+        return tag;
+    }
+    let tag = classify_language(content);
+    LANGUAGE_MEMO.with(|m| {
+        let mut memo = m.borrow_mut();
+        if memo.len() >= LANGUAGE_MEMO_ENTRIES {
+            memo.clear();
+        }
+        memo.insert(content.to_owned(), tag.clone());
+    });
+    tag
+}
+
+/// [`detect_language`] without the memo.
+fn classify_language(content: &str) -> Option<String> {
     const MIN_CONFIDENCE: f64 = 0.5;
     let text = content.trim_end_matches('\u{200B}').trim();
     if text.chars().count() < 12 || text.split_whitespace().count() < 3 {
@@ -515,61 +583,122 @@ fn current_element(renderer: &AppRenderer) -> (String, String) {
 ///
 /// Focus is `ELEMENT_ID` when `total_list` is non-empty, `ROOT_ID` otherwise.
 ///
+/// Because the list is never enumerated, the tree's size does not depend on
+/// the list's, and its node IDs are fixed rather than derived from FFON ids:
+/// the element node *is* the selection, whichever item that is.
+///
 /// macOS builds its own tree ([`build_tree_macos`]) because NSAccessibility
 /// honours neither the label-mutation nor the label-only live region above;
 /// this stays compiled under `cfg(test)` there so the tests keep pinning the
 /// AT-SPI / UIA shape.
 #[cfg(any(not(target_os = "macos"), test))]
 fn build_tree(renderer: &AppRenderer) -> TreeUpdate {
-    let mut nodes: Vec<(NodeId, accesskit::Node)> = Vec::with_capacity(3);
+    full_tree(&Published::of(renderer))
+}
 
-    // Active UI locale (e.g. "nl-BE"); used as the language fallback for any
-    // node whose content can't be reliably auto-detected, and directly for the
-    // app-generated announcement / root nodes.
-    let ui_locale = sicompass_sdk::localize::current_locale();
+/// Everything the shared tree says, as plain values, so two frames can be
+/// compared without building any nodes.
+#[cfg(any(not(target_os = "macos"), test))]
+#[derive(Clone, PartialEq, Debug)]
+struct Published {
+    /// Active UI locale (e.g. "nl-BE"); used as the language fallback for any
+    /// node whose content can't be reliably auto-detected, and directly for the
+    /// app-generated announcement / root nodes.
+    ui_locale: String,
+    element_label: String,
+    element_lang: String,
+    announcement: String,
+    focus: NodeId,
+}
 
-    // ---- Single focused element node (mirrors C's ELEMENT_ID) --------------
-    let (element_label, element_content) = current_element(renderer);
-    let mut elem = Node::new(Role::ListItem);
-    elem.set_label(Box::<str>::from(element_label.as_str()));
-    // Speak each item in its own language: auto-detect from the content, fall
-    // back to the UI locale when detection isn't reliable. The screen reader
-    // only honours this when its automatic language switching is enabled and a
-    // voice for the language is installed.
-    let elem_lang = detect_language(&element_content).unwrap_or_else(|| ui_locale.clone());
-    elem.set_language(elem_lang);
-    nodes.push((ELEMENT_ID, elem));
+#[cfg(any(not(target_os = "macos"), test))]
+impl Published {
+    fn of(renderer: &AppRenderer) -> Self {
+        let ui_locale = sicompass_sdk::localize::current_locale();
+        let (element_label, element_content) = current_element(renderer);
+        // Speak each item in its own language: auto-detect from the content,
+        // fall back to the UI locale when detection isn't reliable. The screen
+        // reader only honours this when its automatic language switching is
+        // enabled and a voice for the language is installed.
+        let element_lang = detect_language(&element_content).unwrap_or_else(|| ui_locale.clone());
+        let focus = if renderer.total_list.is_empty() {
+            ROOT_ID
+        } else {
+            ELEMENT_ID
+        };
+        Published {
+            element_label,
+            element_lang,
+            announcement: renderer.pending_announcement.clone().unwrap_or_default(),
+            ui_locale,
+            focus,
+        }
+    }
 
-    // ---- Announcement live-region node (always present) --------------------
-    // Announcements (mode changes, errors, tab switches) are app-generated in
-    // the active locale and usually too short to detect, so tag them with the
-    // UI locale directly.
-    let ann_text = renderer.pending_announcement.as_deref().unwrap_or("");
-    let mut ann = Node::new(Role::ListItem);
-    ann.set_label(Box::<str>::from(ann_text));
-    ann.set_language(ui_locale.clone());
-    ann.set_live(Live::Polite);
-    nodes.push((ANNOUNCEMENT_ID, ann));
+    fn root_node(&self) -> Node {
+        let mut root = Node::new(Role::Window);
+        root.set_label(Box::<str>::from("sicompass"));
+        root.set_language(self.ui_locale.clone());
+        root.set_children(vec![ELEMENT_ID, ANNOUNCEMENT_ID]);
+        root
+    }
 
-    // ---- Root window node --------------------------------------------------
-    let mut root_builder = Node::new(Role::Window);
-    root_builder.set_label(Box::<str>::from("sicompass"));
-    root_builder.set_language(ui_locale.clone());
-    root_builder.set_children(vec![ELEMENT_ID, ANNOUNCEMENT_ID]);
-    nodes.insert(0, (ROOT_ID, root_builder));
-
-    let focus = if renderer.total_list.is_empty() {
-        ROOT_ID
-    } else {
-        ELEMENT_ID
-    };
+    /// The single focused element node (mirrors C's ELEMENT_ID).
+    fn element_node(&self) -> Node {
+        let mut elem = Node::new(Role::ListItem);
+        elem.set_label(Box::<str>::from(self.element_label.as_str()));
+        elem.set_language(self.element_lang.clone());
+        elem
+    }
 
-    TreeUpdate {
+    /// The announcement live-region node.  Announcements (mode changes,
+    /// errors, tab switches) are app-generated in the active locale and usually
+    /// too short to detect, so they are tagged with the UI locale directly.
+    fn announcement_node(&self) -> Node {
+        let mut ann = Node::new(Role::ListItem);
+        ann.set_label(Box::<str>::from(self.announcement.as_str()));
+        ann.set_language(self.ui_locale.clone());
+        ann.set_live(Live::Polite);
+        ann
+    }
+}
+
+/// The whole tree for `published`: what an AT gets when it first connects.
+#[cfg(any(not(target_os = "macos"), test))]
+fn full_tree(published: &Published) -> TreeUpdate {
+    tree_update(None, published).expect("a full tree is never empty")
+}
+
+/// The update taking the adapter's tree from `prev` to `next`, or `None` when
+/// they say the same thing.
+///
+/// With no `prev` every node is sent along with the tree itself.  Otherwise
+/// only the nodes whose own properties changed are: AccessKit keeps every node
+/// an update leaves out, so moving the cursor sends the element node alone.
+#[cfg(any(not(target_os = "macos"), test))]
+fn tree_update(prev: Option<&Published>, next: &Published) -> Option<TreeUpdate> {
+    let mut nodes: Vec<(NodeId, Node)> = Vec::with_capacity(3);
+    let locale_changed = prev.is_none_or(|p| p.ui_locale != next.ui_locale);
+    if locale_changed {
+        nodes.push((ROOT_ID, next.root_node()));
+    }
+    if prev.is_none_or(|p| {
+        p.element_label != next.element_label || p.element_lang != next.element_lang
+    }) {
+        nodes.push((ELEMENT_ID, next.element_node()));
+    }
+    if locale_changed || prev.is_none_or(|p| p.announcement != next.announcement) {
+        nodes.push((ANNOUNCEMENT_ID, next.announcement_node()));
+    }
+    if prev.is_some_and(|p| p.focus == next.focus) && nodes.is_empty() {
+        return None;
+    }
+    Some(TreeUpdate {
         nodes,
-        tree: Some(Tree::new(ROOT_ID)),
+        tree: prev.is_none().then(|| Tree::new(ROOT_ID)),
         tree_id: TreeId::ROOT,
-        focus,
-    }
+        focus: next.focus,
+    })
 }
 
 // ---------------------------------------------------------------------------
@@ -996,6 +1125,84 @@ mod tests {
         assert_eq!(node.live(), Some(accesskit::Live::Polite));
     }
 
+    // --- tree_update ---
+
+    fn numbered_list(len: usize) -> AppRenderer {
+        let labels: Vec<String> = (0..len).map(|i| format!("- item {i}")).collect();
+        let labels: Vec<&str> = labels.iter().map(String::as_str).collect();
+        make_renderer_with_list(&labels)
+    }
+
+    fn ids(update: &TreeUpdate) -> Vec<NodeId> {
+        update.nodes.iter().map(|(id, _)| *id).collect()
+    }
+
+    #[test]
+    fn tree_update_cursor_move_on_a_long_list_sends_only_the_element() {
+        let mut r = numbered_list(10_000);
+        r.list_index = 5_000;
+        let before = Published::of(&r);
+        r.list_index = 5_001;
+        let after = Published::of(&r);
+
+        let update = tree_update(Some(&before), &after).unwrap();
+        assert_eq!(ids(&update), vec![ELEMENT_ID]);
+        assert!(update.tree.is_none(), "the tree itself is only sent once");
+        assert_eq!(update.focus, ELEMENT_ID);
+        assert_eq!(
+            update.nodes[0].1.label().as_deref(),
+            Some("minus item 5001")
+        );
+    }
+
+    #[test]
+    fn tree_update_unchanged_frame_sends_nothing() {
+        let mut r = numbered_list(10_000);
+        r.list_index = 42;
+        let published = Published::of(&r);
+        assert!(tree_update(Some(&published), &Published::of(&r)).is_none());
+    }
+
+    #[test]
+    fn tree_update_announcement_sends_only_the_live_region() {
+        let mut r = numbered_list(10_000);
+        let before = Published::of(&r);
+        r.pending_announcement = Some("search mode".to_owned());
+
+        let update = tree_update(Some(&before), &Published::of(&r)).unwrap();
+        assert_eq!(ids(&update), vec![ANNOUNCEMENT_ID]);
+    }
+
+    #[test]
+    fn tree_update_emptied_list_moves_focus_without_resending_the_root() {
+        let r = numbered_list(3);
+        let before = Published::of(&r);
+        let update = tree_update(Some(&before), &Published::of(&AppRenderer::new())).unwrap();
+        assert_eq!(ids(&update), vec![ELEMENT_ID]);
+        assert_eq!(update.focus, ROOT_ID);
+    }
+
+    #[test]
+    fn tree_update_without_a_baseline_is_the_full_tree() {
+        let r = numbered_list(10_000);
+        let update = tree_update(None, &Published::of(&r)).unwrap();
+        assert_eq!(ids(&update), vec![ROOT_ID, ELEMENT_ID, ANNOUNCEMENT_ID]);
+        assert!(update.tree.is_some());
+    }
+
+    #[test]
+    fn detect_language_is_memoized_per_content() {
+        assert_eq!(detect_language(NL_PASSAGE).as_deref(), Some("nl"));
+        let memo = LANGUAGE_MEMO.with(|m| m.borrow().get(NL_PASSAGE).cloned());
+        assert_eq!(memo, Some(Some("nl".to_owned())));
+        // A short label is remembered too, as "no reliable answer".
+        assert_eq!(detect_language("newfile.txt"), None);
+        assert_eq!(
+            LANGUAGE_MEMO.with(|m| m.borrow().get("newfile.txt").cloned()),
+            Some(None)
+        );
+    }
+
     // --- AppRenderer::speak_mode_change ---
 
     #[test]
@@ -4,6 +4,8 @@
 //! Equivalent to `SiCompassApplication` + `AppRenderer` in the C code.
 
 use crate::render;
+use crate::timeline_journal::Journal;
+use crate::timeline_store::TimelineEntries;
 use crate::view;
 use sicompass_sdk::ffon::{FfonElement, IdArray};
 use sicompass_sdk::provider::Provider;
@@ -20,6 +22,14 @@ pub const WINDOW_TITLE: &str = "sicompass";
 pub const WINDOW_WIDTH: u32 = 800;
 pub const WINDOW_HEIGHT: u32 = 600;
 
+/// Input-free time after which a parked tab may be built ahead of a switch.
+pub const TAB_HYDRATE_IDLE: std::time::Duration = std::time::Duration::from_secs(2);
+/// A parked tab left alone this long goes back to being a stub.
+pub const TAB_DEHYDRATE_AFTER: std::time::Duration = std::time::Duration::from_secs(15 * 60);
+/// Parked tabs kept built at most; the least recently used beyond this are
+/// dehydrated first.
+pub const MAX_HYDRATED_PARKED_TABS: usize = 4;
+
 // ---------------------------------------------------------------------------
 // Error type
 // ---------------------------------------------------------------------------
@@ -470,6 +480,11 @@ pub struct RenderListItem {
 
 /// Per-tab undo/redo timeline.
 ///
+/// Bounded by bytes rather than by a number of entries: large payloads live in
+/// the store shared by every tab, and `state::record_entry` drops the oldest
+/// entries of any tab once all of them together pass
+/// [`crate::timeline_store::TIMELINE_BUDGET_BYTES`].
+///
 /// Coalescing rules live in `state::record_entry`:
 /// - `TimelineEntry::TextChunk` entries on the same `id` within
 ///   `TEXT_CHUNK_IDLE_MS` collapse into the tail entry.
@@ -477,7 +492,7 @@ pub struct RenderListItem {
 ///   preceding `Navigate` so a burst of arrow keys is one undo step.
 #[derive(Debug, Default, Clone)]
 pub struct Timeline {
-    pub entries: Vec<TimelineEntry>,
+    pub entries: TimelineEntries,
     /// 0 = at HEAD. Walking back increments; walking forward decrements.
     pub position: usize,
     pub last_text_edit_at: Option<Instant>,
@@ -489,15 +504,91 @@ pub struct Timeline {
     /// arrow key would silently extend the pre-undo Navigate entry instead
     /// of recording a new branch.
     pub coalesce_break: bool,
+    /// Where changes to this timeline are persisted, if anywhere. See
+    /// `crate::timeline_journal`. Change `entries` and `position` only through
+    /// the methods below, which keep the journal in step.
+    pub journal: Option<Journal>,
 }
 
 impl Timeline {
     pub fn new() -> Self {
         Self::default()
     }
+
+    /// Record `entry` at HEAD. `provider` is the name of the provider it acts
+    /// on (see [`AppRenderer::journal_provider`]).
+    pub fn push(&mut self, entry: TimelineEntry, provider: Option<&str>) {
+        if let Some(journal) = &self.journal {
+            journal.push(&entry, provider);
+        }
+        self.entries.push(entry);
+        self.position = 0;
+    }
+
+    /// Keep the oldest `len` entries and return to HEAD.
+    pub fn truncate(&mut self, len: usize) {
+        let len = len.min(self.entries.len());
+        self.entries.truncate(len);
+        self.position = 0;
+        if let Some(journal) = &self.journal {
+            journal.truncate(len);
+        }
+    }
+
+    /// Drop the newest entry and return to HEAD.
+    pub fn pop(&mut self) {
+        self.truncate(self.entries.len().saturating_sub(1));
+    }
+
+    /// Forget every entry, and any run of edits in progress.
+    pub fn clear(&mut self) {
+        self.truncate(0);
+        self.last_text_id = None;
+        self.last_text_edit_at = None;
+        self.coalesce_break = false;
+    }
+
+    /// Rewrite the entry at `index` in place. `provider` names the provider
+    /// the rewritten entry acts on.
+    pub fn update(
+        &mut self,
+        index: usize,
+        provider: Option<&str>,
+        f: impl FnOnce(&mut TimelineEntry),
+    ) {
+        let Some(entry) = self.entries.get_mut(index) else {
+            return;
+        };
+        let was_journaled = crate::timeline_journal::journaled(entry);
+        f(entry);
+        let is_journaled = crate::timeline_journal::journaled(entry);
+        // An opaque placeholder stays the same however its entry changes, so a
+        // burst of coalesced arrow keys costs the journal nothing.
+        if let Some(journal) = &self.journal
+            && (was_journaled || is_journaled)
+            && let Some(entry) = self.entries.load(index)
+        {
+            journal.replace(index, &entry, provider);
+        }
+    }
+
+    pub fn set_position(&mut self, position: usize) {
+        self.position = position;
+        if let Some(journal) = &self.journal {
+            journal.set_position(position);
+        }
+    }
+
+    /// Forget the oldest entry. Undoing past it is no longer possible.
+    pub fn evict_oldest(&mut self) {
+        self.entries.pop_front();
+        self.position = self.position.min(self.entries.len());
+        if let Some(journal) = &self.journal {
+            journal.pop_front();
+        }
+    }
 }
 
-pub const TIMELINE_CAPACITY: usize = 1024;
 pub const TEXT_CHUNK_IDLE_MS: u64 = 500;
 
 // ---------------------------------------------------------------------------
@@ -597,6 +688,14 @@ pub struct AppRenderer {
     /// handed to the task, and put back when it finishes. A
     /// [`PlaceholderProvider`] stands in meanwhile so indices stay stable.
     pub pending_provider_ops: Vec<PendingProviderOp>,
+    /// Content providers still starting (see [`crate::startup`]). Their slots
+    /// hold a [`PlaceholderProvider`] until they are swapped in.
+    pub startup: Option<crate::startup::Startup>,
+    /// How long each provider took to start, in the order they finished.
+    pub startup_timings: Vec<crate::startup::InitTiming>,
+    /// Settings broadcast while `startup` was running, latest value per key,
+    /// for the providers that were still placeholders at the time.
+    pub startup_settings: Vec<(String, String)>,
 
     // ---- Navigation state --------------------------------------------------
     /// Current navigation path (depth=1 means at root, depth≥2 inside a provider).
@@ -827,6 +926,9 @@ pub struct AppRenderer {
     /// is always equal to `tabs.len()`. `tab_timelines[active_tab]` is the
     /// timeline that ctrl-Z / ctrl-Shift-Z operate on.
     pub tab_timelines: Vec<Timeline>,
+    /// Where tab timelines are journaled across restarts. `None` keeps them in
+    /// memory only, as in tests; set at startup before the tabs are restored.
+    pub journal_dir: Option<std::path::PathBuf>,
     /// Most-recently-used tab order (VS Code style switcher). Holds every tab
     /// index exactly once, most-recent first; `tab_mru[0]` is always the active
     /// tab. Maintained at the three `tabs` mutation sites (new/close/switch);
@@ -836,6 +938,9 @@ pub struct AppRenderer {
     /// Ctrl+Tab / Ctrl+Shift+Tab (releasing Ctrl commits the highlighted tab).
     /// False for the sticky `t`-key palette (Enter commits, Escape cancels).
     pub tab_switcher_held: bool,
+    /// Last key, text or mouse-button input; parked tabs are only hydrated and
+    /// dehydrated once the user has paused (see [`AppRenderer::tend_tabs`]).
+    pub last_input_at: Instant,
 
     /// Set by `walk_back` / `walk_forward` while applying an undo/redo so
     /// `record_entry` can ignore side-effect emissions (e.g. a Create undo
@@ -873,6 +978,11 @@ pub struct AppRenderer {
 ///
 /// `current_id` + `provider_path` are also what gets persisted to disk so the
 /// layout can be reconstructed across restarts (`persist_tabs`).
+///
+/// An inactive tab may also be a **stub**: navigation only, no providers built.
+/// Restored tabs start that way, and a tab parked long enough goes back to it.
+/// It is built on first activation, or ahead of time while the user is idle.
+/// Its timeline lives in `AppRenderer.tab_timelines` and is not touched.
 pub struct TabSnapshot {
     pub current_id: IdArray,
     /// `current_path()` of the provider at `current_id[0]` at snapshot time.
@@ -883,6 +993,26 @@ pub struct TabSnapshot {
     pub providers: Vec<Box<dyn Provider>>,
     /// FFON roots parallel to `providers`. Empty for the active tab.
     pub ffon: Vec<FfonElement>,
+    /// How to rebuild the tab, while it is a stub.
+    pub stub: Option<TabStub>,
+    /// Navigation still to walk once the provider it starts in has started:
+    /// the tab's providers are built but that one is a start-up placeholder.
+    /// `current_id` and `provider_path` say where to go, as for a stub.
+    pub pending_nav: Option<TabStub>,
+    /// When the tab was last left.
+    pub parked_at: Instant,
+}
+
+/// What a stub tab needs besides `current_id` and `provider_path` to rebuild
+/// itself.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct TabStub {
+    /// `name()` of the provider at `current_id[0]`. Programs enabled or
+    /// disabled while the tab is a stub shift the index, never the name.
+    pub provider_name: String,
+    /// Restore with [`AppRenderer::rebuild_on_path`] rather than by descending
+    /// the saved path (see `handlers::restorable_nav`).
+    pub on_path: bool,
 }
 
 impl TabSnapshot {
@@ -895,8 +1025,23 @@ impl TabSnapshot {
             provider_path,
             providers: Vec::new(),
             ffon: Vec::new(),
+            stub: None,
+            pending_nav: None,
+            parked_at: Instant::now(),
         }
     }
+
+    /// An inactive tab with nothing built yet.
+    pub fn stub(current_id: IdArray, provider_path: String, stub: TabStub) -> Self {
+        TabSnapshot {
+            stub: Some(stub),
+            ..TabSnapshot::nav_only(current_id, provider_path)
+        }
+    }
+
+    pub fn is_stub(&self) -> bool {
+        self.stub.is_some()
+    }
 }
 
 /// `current_path()` of the active provider (`current_id[0]`) in `r`, or empty.
@@ -918,6 +1063,9 @@ impl AppRenderer {
             ffon: Vec::new(),
             providers: Vec::new(),
             pending_provider_ops: Vec::new(),
+            startup: None,
+            startup_timings: Vec::new(),
+            startup_settings: Vec::new(),
             current_id,
             previous_id: IdArray::new(),
             current_insert_id: IdArray::new(),
@@ -991,8 +1139,10 @@ impl AppRenderer {
             tabs: vec![TabSnapshot::nav_only(current_id_clone, String::new())],
             active_tab: 0,
             tab_timelines: vec![Timeline::new()],
+            journal_dir: None,
             tab_mru: vec![0],
             tab_switcher_held: false,
+            last_input_at: Instant::now(),
             in_history_action: false,
             update_state: None,
             update_event_rx: None,
@@ -1011,6 +1161,29 @@ impl AppRenderer {
         &mut self.tab_timelines[self.active_tab]
     }
 
+    /// `name()` of the live provider `entry` acts on, which its journal
+    /// record is keyed by.
+    pub fn journal_provider(&self, entry: &TimelineEntry) -> Option<String> {
+        let idx = crate::timeline_journal::provider_index(entry)?;
+        self.providers.get(idx).map(|p| p.name().to_owned())
+    }
+
+    /// Names of every live provider, settings included, in order: what
+    /// journaled timelines are restored onto.
+    pub fn provider_names(&self) -> Vec<String> {
+        self.providers.iter().map(|p| p.name().to_owned()).collect()
+    }
+
+    /// Names of the live content providers (everything but the trailing shared
+    /// settings provider), in order — what every tab's set is built from.
+    pub fn content_names(&self) -> Vec<String> {
+        let content_n = self.providers.len().saturating_sub(1);
+        self.providers[..content_n]
+            .iter()
+            .map(|p| p.name().to_owned())
+            .collect()
+    }
+
     /// Detach the active tab's *content* providers/ffon (everything except the
     /// trailing shared settings provider) out of the live working set, leaving
     /// only settings in `self.providers`/`self.ffon`. Returns the detached
@@ -1089,9 +1262,10 @@ impl AppRenderer {
             return;
         }
         let active = self.active_tab;
+        let names = self.content_names();
         // Save outgoing navigation, then park its content providers.
-        self.tabs[active].current_id = self.current_id.clone();
-        self.tabs[active].provider_path = active_provider_path(self);
+        self.save_active_nav();
+        self.tabs[active].parked_at = Instant::now();
         let (cp, cf) = self.detach_content();
         self.tabs[active].providers = cp;
         self.tabs[active].ffon = cf;
@@ -1100,13 +1274,268 @@ impl AppRenderer {
         // than being consumed by an Escape over here.
         self.session_view_return_id = None;
         self.active_tab = target;
+        if self.tabs[target].is_stub() {
+            self.hydrate_into_live(target, &names);
+            return;
+        }
         let cp = std::mem::take(&mut self.tabs[target].providers);
         let cf = std::mem::take(&mut self.tabs[target].ffon);
         self.attach_content(cp, cf);
-        self.current_id = self.tabs[target].current_id.clone();
+        if self.tabs[target].pending_nav.is_some() {
+            // Its provider is still starting: wait on that provider's row
+            // until it is swapped in and the walk is replayed.
+            let mut id = IdArray::new();
+            id.push(self.tab_current_id(target).get(0).unwrap_or(0));
+            self.current_id = id;
+        } else {
+            self.current_id = self.tabs[target].current_id.clone();
+        }
         self.list_index = self.current_id.last().unwrap_or(0);
     }
 
+    /// Save the active tab's navigation onto its record, before it is left.
+    /// A pending navigation the cursor has not moved away from is kept
+    /// instead, so the tab still opens where it was saved.
+    pub fn save_active_nav(&mut self) {
+        if self.active_nav_pending() {
+            return;
+        }
+        let active = self.active_tab;
+        self.tabs[active].pending_nav = None;
+        self.tabs[active].current_id = self.current_id.clone();
+        self.tabs[active].provider_path = active_provider_path(self);
+    }
+
+    /// Whether the active tab's pending navigation still applies: the cursor
+    /// has not left the provider it waits for, nor descended into it.
+    fn active_nav_pending(&self) -> bool {
+        let Some(nav) = &self.tabs[self.active_tab].pending_nav else {
+            return false;
+        };
+        let slot = self
+            .providers
+            .iter()
+            .position(|p| p.name() == nav.provider_name);
+        slot.is_some() && self.current_id.get(0) == slot && self.current_id.depth() <= 2
+    }
+
+    /// `current_id` of tab `idx` with its provider index resolved against the
+    /// live set. Only differs from the stored one for a stub or a pending
+    /// navigation, whose stored index may predate a program being enabled or
+    /// disabled.
+    pub fn tab_current_id(&self, idx: usize) -> IdArray {
+        let tab = &self.tabs[idx];
+        match tab.stub.as_ref().or(tab.pending_nav.as_ref()) {
+            Some(nav) => self.resolve_nav_root(&tab.current_id, &nav.provider_name),
+            None => tab.current_id.clone(),
+        }
+    }
+
+    /// `id` with its provider index pointing at `provider_name` in the live
+    /// set, or the first provider if it is not loaded.
+    fn resolve_nav_root(&self, id: &IdArray, provider_name: &str) -> IdArray {
+        let mut id = id.clone();
+        match self
+            .providers
+            .iter()
+            .position(|p| p.name() == provider_name)
+        {
+            Some(pi) => id.set(0, pi),
+            None => {
+                id = IdArray::new();
+                id.push(0);
+            }
+        }
+        id
+    }
+
+    /// Walk the working set to tab `idx`'s saved navigation, rebuilding as
+    /// `nav` says to, and record where it landed on the tab.
+    fn walk_to_saved_nav(&mut self, idx: usize, nav: Option<TabStub>) {
+        let mut id = self.tabs[idx].current_id.clone();
+        if let Some(nav) = &nav {
+            id = self.resolve_nav_root(&id, &nav.provider_name);
+        }
+        let path = self.tabs[idx].provider_path.clone();
+        match nav {
+            Some(nav) if nav.on_path => self.rebuild_on_path(&path, id),
+            _ => self.rebuild_and_clamp(&path, id),
+        }
+        self.list_index = self.current_id.last().unwrap_or(0);
+        self.tabs[idx].current_id = self.current_id.clone();
+        self.tabs[idx].provider_path = active_provider_path(self);
+    }
+
+    /// Build stub tab `idx` into the working set and walk it to its saved
+    /// navigation. The working set must hold only the settings provider (a
+    /// prior `detach_content`); `names` is the content set to build.
+    pub fn hydrate_into_live(&mut self, idx: usize, names: &[String]) {
+        let (cp, cf) = crate::programs::build_content_set_from_names(self, names);
+        self.attach_content(cp, cf);
+        let nav = self.tabs[idx].stub.take();
+        self.walk_to_saved_nav(idx, nav);
+    }
+
+    /// Start building inactive stub tab `idx` ahead of a switch to it.
+    ///
+    /// Nothing here waits on a provider: they start in the background like
+    /// the ones at launch, and `programs::place_started_providers` swaps them
+    /// in. The tab is walked to its saved navigation once the provider it was
+    /// on is in ([`Self::replay_pending_nav`]).
+    pub fn hydrate_tab(&mut self, idx: usize) {
+        if idx == self.active_tab || !self.tabs.get(idx).is_some_and(TabSnapshot::is_stub) {
+            return;
+        }
+        let names = self.content_names();
+        let (cp, cf) = crate::programs::stage_content_set_from_names(self, &names);
+        let tab = &mut self.tabs[idx];
+        tab.providers = cp;
+        tab.ffon = cf;
+        tab.pending_nav = tab.stub.take();
+        // A tab on the shared settings provider has nothing to wait for.
+        let waits = tab
+            .pending_nav
+            .as_ref()
+            .is_some_and(|nav| names.contains(&nav.provider_name));
+        if !waits {
+            self.walk_parked(idx);
+        }
+    }
+
+    /// Walk parked tab `idx` to its pending navigation, leaving the active
+    /// tab's working set and cursor as they were.
+    fn walk_parked(&mut self, idx: usize) {
+        let nav = self.tabs[idx].pending_nav.take();
+        let (current_id, list_index) = (self.current_id.clone(), self.list_index);
+        let (live_p, live_f) = self.detach_content();
+        let cp = std::mem::take(&mut self.tabs[idx].providers);
+        let cf = std::mem::take(&mut self.tabs[idx].ffon);
+        self.attach_content(cp, cf);
+        self.walk_to_saved_nav(idx, nav);
+        let (cp, cf) = self.detach_content();
+        self.tabs[idx].providers = cp;
+        self.tabs[idx].ffon = cf;
+        self.attach_content(live_p, live_f);
+        self.current_id = current_id;
+        self.list_index = list_index;
+    }
+
+    /// Provider `name` was just swapped into tab `idx`'s set. Walk the tab to
+    /// its pending navigation if that waited for `name`. Returns whether the
+    /// active view moved.
+    ///
+    /// On the active tab only while [`Self::active_nav_pending`]: a user who
+    /// has gone elsewhere meanwhile is not pulled back.
+    pub fn replay_pending_nav(&mut self, idx: usize, name: &str) -> bool {
+        let waits = self
+            .tabs
+            .get(idx)
+            .and_then(|t| t.pending_nav.as_ref())
+            .is_some_and(|nav| nav.provider_name == name);
+        if !waits {
+            return false;
+        }
+        if idx != self.active_tab {
+            self.walk_parked(idx);
+            return false;
+        }
+        let pending = self.active_nav_pending();
+        let nav = self.tabs[idx].pending_nav.take();
+        if !pending {
+            return false;
+        }
+        self.walk_to_saved_nav(idx, nav);
+        true
+    }
+
+    /// Drop inactive tab `idx`'s providers, keeping its navigation as a stub.
+    ///
+    /// Refused for a tab with a child process or a busy provider: a shell or a
+    /// running command cannot be rebuilt, only restarted, and a provider
+    /// holding unsaved input (a compose draft, typed form fields) reports
+    /// itself busy for as long as it does.
+    pub fn dehydrate_tab(&mut self, idx: usize) -> bool {
+        if idx == self.active_tab {
+            return false;
+        }
+        let Some(tab) = self.tabs.get(idx) else {
+            return false;
+        };
+        if tab.is_stub()
+            || tab
+                .providers
+                .iter()
+                .any(|p| p.process_id().is_some() || p.is_busy())
+        {
+            return false;
+        }
+        // Still starting: it goes back to the stub it was built from.
+        if tab.pending_nav.is_some() {
+            let tab = &mut self.tabs[idx];
+            tab.providers.clear();
+            tab.ffon.clear();
+            tab.stub = tab.pending_nav.take();
+            return true;
+        }
+        let nav =
+            crate::handlers::restorable_nav(&tab.providers, &tab.current_id, &tab.provider_path);
+        // A tab on the shared settings provider points past its parked set.
+        let provider_name = nav
+            .current_id
+            .get(0)
+            .and_then(|pi| tab.providers.get(pi).or_else(|| self.providers.last()))
+            .map(|p| p.name().to_owned())
+            .unwrap_or_default();
+        let tab = &mut self.tabs[idx];
+        tab.providers.clear();
+        tab.ffon.clear();
+        tab.stub = Some(TabStub {
+            provider_name,
+            on_path: nav.on_path,
+        });
+        true
+    }
+
+    /// Hydrate and dehydrate parked tabs while the user is idle, one tab per
+    /// call. Returns whether anything changed.
+    ///
+    /// Dehydrates first: a tab parked longer than [`TAB_DEHYDRATE_AFTER`], or
+    /// the least recently used once more than [`MAX_HYDRATED_PARKED_TABS`] are
+    /// built. Otherwise builds the tab Ctrl+Tab would switch to, unless it has
+    /// been left long enough to be dehydrated again.
+    pub fn tend_tabs(&mut self) -> bool {
+        if self.last_input_at.elapsed() < TAB_HYDRATE_IDLE {
+            return false;
+        }
+        let parked: Vec<usize> = self
+            .tab_mru
+            .iter()
+            .copied()
+            .filter(|&i| i != self.active_tab && i < self.tabs.len())
+            .collect();
+        let hydrated: Vec<usize> = parked
+            .iter()
+            .copied()
+            .filter(|&i| !self.tabs[i].is_stub())
+            .collect();
+        for (rank, &i) in hydrated.iter().enumerate().rev() {
+            let stale = self.tabs[i].parked_at.elapsed() >= TAB_DEHYDRATE_AFTER;
+            if (stale || rank >= MAX_HYDRATED_PARKED_TABS) && self.dehydrate_tab(i) {
+                return true;
+            }
+        }
+        match parked.first() {
+            Some(&next)
+                if self.tabs[next].is_stub()
+                    && self.tabs[next].parked_at.elapsed() < TAB_DEHYDRATE_AFTER =>
+            {
+                self.hydrate_tab(next);
+                true
+            }
+            _ => false,
+        }
+    }
+
     /// Rebuild the active tab's saved provider FFON tree (for the cold-start
     /// restore path, where providers were freshly instantiated and need their
     /// saved navigation re-grafted) and clamp `current_id` to what actually
@@ -1807,8 +2236,12 @@ impl AppState {
         crate::programs::apply_pending_settings(&mut state.renderer, &queue, true);
         state.settings_queue = Some(queue);
 
-        // Restore persisted tab layout (no-op if none stored).
+        // Restore persisted tab layout (no-op if none stored), and each tab's
+        // undo timeline from its journal.
         // Must run AFTER providers are loaded so provider-index validation works.
+        // A second instance leaves the journals to the first.
+        state.renderer.journal_dir = crate::timeline_journal::default_dir()
+            .filter(|dir| crate::timeline_journal::claim_dir(dir));
         crate::programs::load_tabs_state(&mut state.renderer);
 
         // On first run, land the cursor on the onboarding line so a new (screen
@@ -1826,6 +2259,10 @@ impl AppState {
     /// Run the main event loop until the window is closed.
     pub fn run(&mut self) {
         view::main_loop(self);
+        sicompass_config::flush_all();
+        if let Some(path) = crate::wasm_host::accounting::write_dump() {
+            tracing::info!(target: "wasm_plugin", "plugin usage written to {}", path.display());
+        }
     }
 }
 
@@ -2319,20 +2756,28 @@ pub struct PendingProviderOp {
     pub rx: std::sync::mpsc::Receiver<(Box<dyn Provider>, String)>,
 }
 
-/// Stands in for a provider while its undo/redo is running.
+/// Stands in for a provider while its undo/redo is running, while it is
+/// still starting, or for good when it failed to start.
 ///
 /// Only `name` and `fetch` are required by the trait; every other method keeps
 /// its default, which is exactly the inert behaviour wanted here.
 pub struct PlaceholderProvider {
     name: String,
     display: String,
+    line: String,
 }
 
 impl PlaceholderProvider {
     pub fn new(name: &str, display: &str) -> Self {
+        Self::showing(name, display, "Working…")
+    }
+
+    /// A stand-in whose only line is `line`.
+    pub fn showing(name: &str, display: &str, line: &str) -> Self {
         PlaceholderProvider {
             name: name.to_owned(),
             display: display.to_owned(),
+            line: line.to_owned(),
         }
     }
 }
@@ -2348,6 +2793,6 @@ impl Provider for PlaceholderProvider {
     }
 
     fn fetch(&mut self) -> Vec<FfonElement> {
-        vec![FfonElement::new_str("Working…".to_owned())]
+        vec![FfonElement::new_str(self.line.clone())]
     }
 }
@@ -394,6 +394,9 @@ pub fn run_provider_ticks(
     // Put back any provider whose async undo/redo finished since last frame,
     // before ticking, so it is ticked as itself rather than as the placeholder.
     let mut active_tick_update = crate::state::drain_pending_provider_ops(r);
+    // Same for providers that were still starting when the first frame was
+    // drawn.
+    active_tick_update |= crate::programs::place_started_providers(r, std::time::Duration::ZERO);
     let mut dashboard_requests: Vec<(usize, sicompass_sdk::DashboardRequest)> = Vec::new();
     for (i, p) in r.providers.iter_mut().enumerate() {
         if p.tick() && Some(i) == active_root {
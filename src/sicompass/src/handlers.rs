@@ -174,7 +174,7 @@ fn pop_last_placeholder_structural(r: &mut AppRenderer) {
             ..
         })
     ) {
-        tl.entries.pop();
+        tl.pop();
     }
 }
 
@@ -186,9 +186,7 @@ fn pop_last_placeholder_structural(r: &mut AppRenderer) {
 fn collapse_typed_name_chunks(r: &mut AppRenderer, session_start: Option<usize>) {
     let Some(start) = session_start else { return };
     let tl = r.active_timeline_mut();
-    let cut = start.min(tl.entries.len());
-    tl.entries.truncate(cut);
-    tl.position = 0;
+    tl.truncate(start);
     tl.last_text_id = None;
     tl.last_text_edit_at = None;
     tl.coalesce_break = true;
@@ -2070,11 +2068,7 @@ pub fn handle_enter_general(r: &mut AppRenderer) {
                             p.set_current_path("/");
                         }
                         for tl in r.tab_timelines.iter_mut() {
-                            tl.entries.clear();
-                            tl.position = 0;
-                            tl.last_text_id = None;
-                            tl.last_text_edit_at = None;
-                            tl.coalesce_break = false;
+                            tl.clear();
                         }
                         r.current_save_path = full_path.clone();
                         r.error_message = format!("Loaded from {full_path}");
@@ -4489,11 +4483,7 @@ pub fn handle_load_provider_config(r: &mut AppRenderer, path: &str) {
             }
             // Clear undo history across all tabs
             for tl in r.tab_timelines.iter_mut() {
-                tl.entries.clear();
-                tl.position = 0;
-                tl.last_text_id = None;
-                tl.last_text_edit_at = None;
-                tl.coalesce_break = false;
+                tl.clear();
             }
 
             r.current_save_path = path.to_owned();
@@ -4785,10 +4775,20 @@ pub(crate) fn rewrite_last_text_chunk_after(
     final_state: &sicompass_sdk::ffon::FfonElement,
 ) {
     use sicompass_sdk::timeline::TimelineEntry;
+    let Some(tail) = r.active_timeline().entries.len().checked_sub(1) else {
+        return;
+    };
+    let provider = r
+        .active_timeline()
+        .entries
+        .load(tail)
+        .and_then(|e| r.journal_provider(&e));
     let tl = r.active_timeline_mut();
-    if let Some(TimelineEntry::TextChunk { after, .. }) = tl.entries.last_mut() {
-        *after = final_state.clone();
-    }
+    tl.update(tail, provider.as_deref(), |e| {
+        if let TimelineEntry::TextChunk { after, .. } = e {
+            *after = final_state.clone();
+        }
+    });
 }
 
 /// Retarget the per-keystroke TextChunks of the just-finished insert session
@@ -4806,15 +4806,24 @@ fn retarget_insert_session_chunks(
     committed: &sicompass_sdk::ffon::FfonElement,
 ) {
     use sicompass_sdk::timeline::TimelineEntry;
+    let provider = committed_id
+        .get(0)
+        .and_then(|i| r.providers.get(i))
+        .map(|p| p.name().to_owned());
     let tl = r.active_timeline_mut();
     let end = tl.entries.len();
     for i in session_start..end {
-        if let Some(TimelineEntry::TextChunk { id, after, .. }) = tl.entries.get_mut(i) {
-            *id = committed_id.clone();
-            if i + 1 == end {
-                *after = committed.clone();
+        if !matches!(tl.entries.get(i), Some(TimelineEntry::TextChunk { .. })) {
+            continue;
+        }
+        tl.update(i, provider.as_deref(), |e| {
+            if let TimelineEntry::TextChunk { id, after, .. } = e {
+                *id = committed_id.clone();
+                if i + 1 == end {
+                    *after = committed.clone();
+                }
             }
-        }
+        });
     }
 }
 
@@ -4850,9 +4859,7 @@ pub(crate) fn cancel_insert_session(r: &mut AppRenderer) {
     }
     // Truncate timeline back to pre-session length and clear merge state.
     let tl = r.active_timeline_mut();
-    let target_len = session.timeline_position_at_start.min(tl.entries.len());
-    tl.entries.truncate(target_len);
-    tl.position = 0;
+    tl.truncate(session.timeline_position_at_start);
     tl.last_text_id = None;
     tl.last_text_edit_at = None;
     tl.coalesce_break = true;
@@ -7013,13 +7020,20 @@ pub(crate) fn persist_tabs(r: &mut AppRenderer) {
         .enumerate()
         .map(|(i, t)| {
             // The active tab's providers are the live set; the rest are parked in
-            // their own slot.
+            // their own slot, or not built at all for a stub.
             let providers: &[Box<dyn sicompass_sdk::provider::Provider>] = if i == r.active_tab {
                 &r.providers
             } else {
                 &t.providers
             };
-            let nav = restorable_nav(providers, &t.current_id, &t.provider_path);
+            let nav = match t.stub.as_ref().or(t.pending_nav.as_ref()) {
+                Some(stub) => RestorableNav {
+                    current_id: r.tab_current_id(i),
+                    path: t.provider_path.clone(),
+                    on_path: stub.on_path,
+                },
+                None => restorable_nav(providers, &t.current_id, &t.provider_path),
+            };
             let ids: Vec<serde_json::Value> = nav
                 .current_id
                 .as_slice()
@@ -7034,6 +7048,12 @@ pub(crate) fn persist_tabs(r: &mut AppRenderer) {
                 // `false` default the reader applies.
                 obj.insert("onPath".to_string(), serde_json::Value::Bool(true));
             }
+            if let Some(journal) = r.tab_timelines.get(i).and_then(|tl| tl.journal.as_ref()) {
+                obj.insert(
+                    "journal".to_string(),
+                    serde_json::Value::String(journal.key().to_owned()),
+                );
+            }
             serde_json::Value::Object(obj)
         })
         .collect();
@@ -7083,8 +7103,7 @@ pub fn handle_tab_new(r: &mut AppRenderer) {
         .collect();
 
     // Save the outgoing tab's navigation, then park its live content providers.
-    r.tabs[active].current_id = r.current_id.clone();
-    r.tabs[active].provider_path = crate::app_state::active_provider_path(r);
+    r.save_active_nav();
     let (cp, cf) = r.detach_content();
     r.tabs[active].providers = cp;
     r.tabs[active].ffon = cf;
@@ -7109,9 +7128,9 @@ pub fn handle_tab_new(r: &mut AppRenderer) {
         crate::app_state::TabSnapshot::nav_only(new_id, new_path),
     );
     // Keep `tab_timelines` parallel to `tabs`. New tabs start with an empty
-    // timeline — a fresh tab carries no history.
-    r.tab_timelines
-        .insert(insert_at, crate::app_state::Timeline::new());
+    // timeline — a fresh tab carries no history — and a journal of their own.
+    let timeline = crate::timeline_journal::open_timeline(r.journal_dir.as_deref(), None, &[]);
+    r.tab_timelines.insert(insert_at, timeline);
     // Keep `tab_mru` parallel and consistent: existing indices at or past the
     // insertion point shift up by one, then the new tab becomes most-recent.
     for idx in r.tab_mru.iter_mut() {
@@ -7181,12 +7200,15 @@ fn close_active_tab(r: &mut AppRenderer) {
     // Drop the active tab's live content providers — this fires each provider's
     // Drop impl, killing the terminal's child shell process. The trailing
     // shared settings provider stays in `r.providers`.
+    let names = r.content_names();
     let (content_providers, _content_ffon) = r.detach_content();
     drop(content_providers);
 
     let closed = r.active_tab;
     r.tabs.remove(closed);
-    r.tab_timelines.remove(closed);
+    if let Some(journal) = r.tab_timelines.remove(closed).journal {
+        journal.discard();
+    }
     if r.active_tab > 0 {
         r.active_tab -= 1;
     }
@@ -7201,13 +7223,18 @@ fn close_active_tab(r: &mut AppRenderer) {
     }
     r.touch_mru(r.active_tab);
 
-    // Swap the new active tab's parked content into the live working set.
+    // Swap the new active tab's parked content into the live working set, or
+    // build it if it is still a stub.
     let idx = r.active_tab;
-    let np = std::mem::take(&mut r.tabs[idx].providers);
-    let nf = std::mem::take(&mut r.tabs[idx].ffon);
-    r.attach_content(np, nf);
-    r.current_id = r.tabs[idx].current_id.clone();
-    r.list_index = r.current_id.last().unwrap_or(0);
+    if r.tabs[idx].is_stub() {
+        r.hydrate_into_live(idx, &names);
+    } else {
+        let np = std::mem::take(&mut r.tabs[idx].providers);
+        let nf = std::mem::take(&mut r.tabs[idx].ffon);
+        r.attach_content(np, nf);
+        r.current_id = r.tabs[idx].current_id.clone();
+        r.list_index = r.current_id.last().unwrap_or(0);
+    }
     after_tab_change(r);
 }
 
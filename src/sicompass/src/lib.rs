@@ -26,8 +26,11 @@ pub mod rectangle;
 pub mod shaders;
 pub mod shortcuts;
 pub mod start_menu;
+pub mod startup;
 pub mod state;
 pub mod text;
+pub mod timeline_journal;
+pub mod timeline_store;
 pub mod unicode_search;
 /// Host for sandboxed WASM plugins — the replacement for `dlopen`ed native plugins
 /// and `bun`-spawned script plugins, neither of which can ship on Apple's stores.
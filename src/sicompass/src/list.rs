@@ -599,11 +599,6 @@ fn check_parent_has_radio(renderer: &AppRenderer) -> bool {
 fn build_timeline_list(renderer: &mut AppRenderer) {
     renderer.list_index = 0;
 
-    let (entries, position) = {
-        let tl = renderer.active_timeline();
-        (tl.entries.clone(), tl.position)
-    };
-
     let providers: Vec<TimelineProviderInfo> = renderer
         .providers
         .iter()
@@ -613,6 +608,11 @@ fn build_timeline_list(renderer: &mut AppRenderer) {
         })
         .collect();
 
+    // Labelled in place: cloning the entries would also copy every snapshot
+    // still held inline, only to read its op and id.
+    let tl = renderer.active_timeline();
+    let (entries, position) = (&tl.entries, tl.position);
+
     if entries.is_empty() {
         let mut id = IdArray::new();
         id.push(0);
@@ -749,6 +749,18 @@ fn tab_pid_and_path(r: &AppRenderer, ti: usize) -> (Option<u32>, String) {
         let Some(tab) = r.tabs.get(ti) else {
             return (None, String::new());
         };
+        if tab.is_stub() {
+            // Nothing built to walk: name the provider, then the saved path.
+            let id = r.tab_current_id(ti);
+            let root = id.get(0).and_then(|i| r.providers.get(i));
+            let segs = root.map(|p| p.display_name()).into_iter().chain(
+                tab.provider_path
+                    .split('/')
+                    .filter(|s| !s.is_empty())
+                    .map(str::to_owned),
+            );
+            return (None, segs.collect::<Vec<_>>().join(" > "));
+        }
         let pid = tab.providers.iter().find_map(|p| p.process_id());
         // The shared settings provider is never parked into `tab.ffon`; a tab
         // sitting on it has a `current_id[0]` past the parked content, so resolve
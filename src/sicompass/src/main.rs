@@ -29,6 +29,11 @@ fn main() {
     // Must happen before load_programs() so create_provider_by_name() resolves them.
     sicompass_builtins::register_all();
 
+    // Settings edits made while the app runs (tab state, window state, toggles)
+    // are batched into one settings.json write per window rather than one per
+    // edit; `AppState::run` flushes what is left on exit.
+    sicompass_config::coalesce_writes(std::time::Duration::from_millis(250));
+
     // No working-directory fixup here, and no resource-root probe: shaders, fonts
     // and every provider asset are compiled into the binary, so there is no runtime
     // resource tree to find. `register_all()` above is what publishes the assets,
@@ -80,7 +85,8 @@ fn main() {
                     GITHUB_OWNER,
                     GITHUB_REPO,
                 )
-                .with_event_sender(tx);
+                .with_event_sender(tx)
+                .with_precompiler(sicompass::wasm_host::precompile);
                 let result = checker.check_and_stage();
                 *state_for_thread.lock().unwrap() = result;
             });
@@ -106,18 +112,8 @@ fn main() {
 /// when the file or key is absent so updates work out of the box; users
 /// can disable via the settings UI checkbox.
 fn read_auto_update_check_setting() -> bool {
-    let Some(path) = sicompass_sdk::platform::main_config_path() else {
-        return true;
-    };
-    let Ok(data) = std::fs::read_to_string(&path) else {
-        return true;
-    };
-    let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) else {
-        return true;
-    };
-    root.get("sicompass")
-        .and_then(|v| v.as_object())
-        .and_then(|sc| sc.get("autoUpdateCheck"))
+    sicompass_config::settings()
+        .and_then(|s| s.get("sicompass", "autoUpdateCheck"))
         .and_then(|v| v.as_bool())
         .unwrap_or(true)
 }
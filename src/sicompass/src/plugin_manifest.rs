@@ -117,6 +117,12 @@ pub struct PluginManifest {
     /// intends to connect.
     #[serde(default)]
     pub allowed_hosts: Vec<String>,
+    /// Providers (by name) this plugin must start after. Providers start side
+    /// by side at launch; this orders the ones that read something another
+    /// sets up. Unknown names are ignored, and a cycle is broken by ignoring
+    /// the list of every plugin caught in it.
+    #[serde(default)]
+    pub init_after: Vec<String>,
 }
 
 fn default_hot_reload() -> bool {
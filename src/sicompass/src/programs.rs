@@ -13,13 +13,15 @@
 //! `Arc<Mutex<Vec<...>>>` queue that the main loop drains each frame via
 //! [`apply_pending_settings`].
 
-use crate::app_state::AppRenderer;
+use crate::app_state::{AppRenderer, PlaceholderProvider};
 use crate::plugin_manifest::{DiscoveredPlugin, PluginManifest, PluginType, discover_user_plugins};
+use crate::startup::{self, Job, STARTING, Started};
 use sicompass_sdk::ffon::{FfonElement, IdArray};
 use sicompass_sdk::provider::Provider;
 use sicompass_updater::UpdateEvent;
 use std::path::{Path, PathBuf};
 use std::sync::{Arc, Mutex, OnceLock};
+use std::time::{Duration, Instant};
 
 // ---------------------------------------------------------------------------
 // Types
@@ -93,6 +95,171 @@ fn init_provider_root(
     (provider, root)
 }
 
+/// Give `job`'s provider a slot in the root list now and start it later, as part of
+/// the start-up batch in `jobs`. The slot holds a placeholder showing
+/// [`STARTING`] until [`place_started_providers`] swaps the provider in.
+fn stage_provider(renderer: &mut AppRenderer, jobs: &mut Vec<Job>, display: &str, job: Job) {
+    renderer
+        .providers
+        .push(Box::new(PlaceholderProvider::showing(
+            &job.name, display, STARTING,
+        )));
+    let mut root = FfonElement::new_obj(display);
+    root.as_obj_mut()
+        .unwrap()
+        .push(FfonElement::new_str(STARTING.to_owned()));
+    renderer.ffon.push(root);
+    jobs.push(job);
+}
+
+/// Whether a provider root is still the start-up placeholder's.
+fn is_starting(root: &FfonElement) -> bool {
+    root.as_obj()
+        .is_some_and(|o| matches!(o.children.as_slice(), [FfonElement::Str(s)] if s == STARTING))
+}
+
+/// Swap providers that finished starting into their slots, waiting up to
+/// `wait` for more. Returns `true` when the active root's provider was among
+/// them, so the view should refresh.
+///
+/// A slot is found by provider name and its placeholder root — in the live
+/// set first, then in the parked tabs, since a tab restore may have moved the
+/// bootstrap set. A provider whose slot is gone (disabled meanwhile) is
+/// dropped.
+pub fn place_started_providers(renderer: &mut AppRenderer, wait: Duration) -> bool {
+    let Some(batch) = renderer.startup.as_mut() else {
+        return false;
+    };
+    let done = if wait.is_zero() {
+        batch.try_take()
+    } else {
+        batch.wait_until(Instant::now() + wait)
+    };
+    let finished = batch.pending() == 0;
+    if finished {
+        tracing::info!("providers started in {:?}", batch.elapsed());
+    }
+    let mut active = false;
+    for started in done {
+        active |= place_started(renderer, started);
+    }
+    if finished {
+        renderer.startup = None;
+        renderer.startup_settings.clear();
+    }
+    active
+}
+
+fn place_started(renderer: &mut AppRenderer, started: Started) -> bool {
+    let Started {
+        name,
+        provider,
+        children,
+        error,
+        timing,
+        ..
+    } = started;
+    tracing::info!(
+        "provider '{name}' started in {:?} (after {:?} waiting)",
+        timing.took,
+        timing.waited
+    );
+    renderer.startup_timings.push(timing);
+    if let Some(err) = &error {
+        eprintln!("provider '{name}' error on start: {err}");
+    }
+
+    let live = renderer
+        .providers
+        .iter()
+        .zip(&renderer.ffon)
+        .position(|(p, root)| p.name() == name && is_starting(root));
+    let parked = match live {
+        Some(_) => None,
+        None => {
+            let Some(t) = renderer.tabs.iter().position(|t| {
+                t.providers
+                    .iter()
+                    .zip(&t.ffon)
+                    .any(|(p, root)| p.name() == name && is_starting(root))
+            }) else {
+                return false;
+            };
+            Some(t)
+        }
+    };
+    let (providers, ffon) = match parked {
+        None => (&mut renderer.providers, &mut renderer.ffon),
+        Some(t) => (&mut renderer.tabs[t].providers, &mut renderer.tabs[t].ffon),
+    };
+    let Some(idx) = providers
+        .iter()
+        .zip(ffon.iter())
+        .position(|(p, root)| p.name() == name && is_starting(root))
+    else {
+        return false;
+    };
+
+    // A provider that failed to start keeps an inert slot for the session,
+    // saying so, rather than shifting every index after it.
+    let display = providers[idx].display_name();
+    let (provider, children): (Box<dyn Provider>, _) = match provider {
+        // Settings broadcast while it was starting went to the placeholder;
+        // hand them over, and fetch again if there were any.
+        Some(mut p) if !renderer.startup_settings.is_empty() => {
+            for (key, value) in &renderer.startup_settings {
+                p.on_setting_change(key, value);
+            }
+            let children = p.fetch();
+            (p, children)
+        }
+        Some(p) => (p, children),
+        None => {
+            let line = error.clone().unwrap_or_default();
+            (
+                Box::new(PlaceholderProvider::showing(&name, &display, &line)),
+                vec![FfonElement::new_str(line)],
+            )
+        }
+    };
+    let mut root = FfonElement::new_obj(&provider.display_name());
+    for child in children {
+        root.as_obj_mut().unwrap().push(child);
+    }
+    let version = provider.version().map(str::to_owned);
+    providers[idx] = provider;
+    ffon[idx] = root;
+
+    if let Some(err) = error {
+        renderer.error_message = err;
+    }
+    // Plugins without a manifest `version` show the one the provider reports,
+    // known only now that it exists. Only the live set carries the settings
+    // provider; a parked tab's instance leaves it to the live one.
+    if let Some(v) = version
+        && parked.is_none()
+    {
+        let unversioned = user_plugin_cache()
+            .lock()
+            .unwrap()
+            .iter()
+            .find(|p| p.manifest.name == name)
+            .filter(|p| p.manifest.version.is_none())
+            .map(|p| p.manifest.display_name.clone());
+        if let Some(section) = unversioned
+            && let Some(settings) = renderer.providers.last_mut()
+        {
+            settings.set_section_version(&section, &v);
+            rebuild_settings_ffon(renderer);
+        }
+    }
+    // The tab the slot belongs to may have been waiting on this provider to
+    // walk to where it was saved.
+    let tab = parked.unwrap_or(renderer.active_tab);
+    let walked = renderer.replay_pending_nav(tab, &name);
+    walked || live.is_some() && renderer.current_id.get(0) == live
+}
+
 /// Re-instantiate a fresh provider instance by name, mirroring `enable_provider`'s
 /// resolution order: built-ins first, then the user-plugin cache, then a remote
 /// FFON service. Returns `None` only when the name matches none of these — the
@@ -271,6 +438,10 @@ pub fn load_programs(renderer: &mut AppRenderer) -> SettingsQueue {
     // ---- Register settings as the last provider ----------------------------
     register_provider(renderer, settings);
 
+    // Give the content providers a moment before the first frame; any still
+    // starting after that are swapped in by the frame loop.
+    place_started_providers(renderer, startup::FIRST_FRAME_WAIT);
+
     queue
 }
 
@@ -322,6 +493,10 @@ pub fn focus_onboarding(renderer: &mut AppRenderer) {
 /// builtins first, then enabled opt-in builtins, then user plugins, then remote
 /// services, all sorted alphabetically.
 ///
+/// Providers get their slots here but start afterwards, side by side, as one
+/// batch on `renderer.startup` (see [`crate::startup`]); the slots show
+/// [`STARTING`] until [`place_started_providers`] swaps them in.
+///
 /// When `settings` is `Some`, also configures the settings provider (injects
 /// per-provider setting entries, registers sections, adds plugin/remote
 /// checkboxes) — done once, at initial app load (`load_programs`). New tabs
@@ -330,11 +505,14 @@ pub fn focus_onboarding(renderer: &mut AppRenderer) {
 /// would duplicate sections/checkboxes). The registered provider set is
 /// identical either way, so provider indices stay stable across tabs.
 pub fn load_content_providers(renderer: &mut AppRenderer, mut settings: Option<&mut dyn Provider>) {
+    let mut jobs: Vec<Job> = Vec::new();
+
     // Always-enabled providers first (e.g. file browser).
     for m in sicompass_sdk::builtin_manifests() {
         if m.always_enabled {
             if let Some(p) = instantiate_builtin(&m.name) {
-                register_provider(renderer, p);
+                let display = p.display_name();
+                stage_provider(renderer, &mut jobs, &display, Job::ready(p));
             }
             if let Some(s) = settings.as_deref_mut() {
                 if !m.settings.is_empty() {
@@ -356,7 +534,8 @@ pub fn load_content_providers(renderer: &mut AppRenderer, mut settings: Option<&
                     inject_builtin_manifest_settings(s, m);
                 }
             }
-            register_provider(renderer, p);
+            let display = p.display_name();
+            stage_provider(renderer, &mut jobs, &display, Job::ready(p));
         } else {
             eprintln!("sicompass: unknown program '{name}' — skipping");
         }
@@ -375,11 +554,13 @@ pub fn load_content_providers(renderer: &mut AppRenderer, mut settings: Option<&
     }
 
     // User-installed plugins, then remote services.
-    load_user_plugins(renderer, settings.as_deref_mut());
-    load_remote_programs(renderer, settings.as_deref_mut());
+    load_user_plugins(renderer, &mut jobs, settings.as_deref_mut());
+    load_remote_programs(renderer, &mut jobs, settings.as_deref_mut());
 
     // Sort content providers alphabetically (settings is appended afterwards).
     sort_providers_alphabetically(renderer);
+
+    renderer.startup = Some(startup::start(jobs));
 }
 
 /// Build a fresh, independent set of content providers + their ffon roots for a
@@ -399,26 +580,101 @@ pub fn build_content_set_from_names(
     renderer: &mut AppRenderer,
     names: &[String],
 ) -> (Vec<Box<dyn Provider>>, Vec<FfonElement>) {
+    // Build on this thread, start side by side.
+    let jobs: Vec<Job> = names
+        .iter()
+        .map(|name| Job::ready(reinstantiate_or_stand_in(name)))
+        .collect();
+    let mut slots: Vec<Option<Started>> = names.iter().map(|_| None).collect();
+    for started in startup::start(jobs).wait_all() {
+        let i = started.index;
+        slots[i] = Some(started);
+    }
+
     let mut fresh_p: Vec<Box<dyn Provider>> = Vec::with_capacity(names.len());
     let mut fresh_f: Vec<FfonElement> = Vec::with_capacity(names.len());
-    for name in names {
-        let provider = reinstantiate_provider(name).unwrap_or_else(|| {
-            eprintln!(
-                "sicompass: cannot re-instantiate provider '{name}' for new tab — using placeholder"
-            );
-            Box::new(sicompass_sdk::provider::GenericProvider::new(
-                name.clone(),
-                name.clone(),
-                |_| Vec::new(),
-            ))
-        });
-        let (provider, root) = init_provider_root(provider, &mut renderer.error_message);
+    for (name, started) in names.iter().zip(slots) {
+        let (provider, children) = match started {
+            Some(Started {
+                provider: Some(p),
+                children,
+                error,
+                ..
+            }) => {
+                if let Some(err) = error {
+                    eprintln!("provider '{name}' fetch error on register: {err}");
+                    renderer.error_message = err;
+                }
+                (p, children)
+            }
+            // Panicked while starting: keep the index, inertly.
+            other => {
+                let line = other
+                    .and_then(|s| s.error)
+                    .unwrap_or_else(|| format!("{name} could not be loaded"));
+                let stand_in: Box<dyn Provider> =
+                    Box::new(PlaceholderProvider::showing(name, name, &line));
+                (stand_in, vec![FfonElement::new_str(line)])
+            }
+        };
+        let mut root = FfonElement::new_obj(&provider.display_name());
+        for child in children {
+            root.as_obj_mut().unwrap().push(child);
+        }
         fresh_p.push(provider);
         fresh_f.push(root);
     }
     (fresh_p, fresh_f)
 }
 
+/// Like [`build_content_set_from_names`], without waiting: every slot holds a
+/// placeholder showing [`STARTING`], and the providers start alongside
+/// `renderer.startup`. [`place_started_providers`] swaps each one in when it
+/// is done, wherever its slot has been parked by then.
+pub fn stage_content_set_from_names(
+    renderer: &mut AppRenderer,
+    names: &[String],
+) -> (Vec<Box<dyn Provider>>, Vec<FfonElement>) {
+    let mut jobs = Vec::with_capacity(names.len());
+    let mut staged_p: Vec<Box<dyn Provider>> = Vec::with_capacity(names.len());
+    let mut staged_f: Vec<FfonElement> = Vec::with_capacity(names.len());
+    for name in names {
+        let provider = reinstantiate_or_stand_in(name);
+        let display = provider.display_name();
+        staged_p.push(Box::new(PlaceholderProvider::showing(
+            name, &display, STARTING,
+        )));
+        let mut root = FfonElement::new_obj(&display);
+        root.as_obj_mut()
+            .unwrap()
+            .push(FfonElement::new_str(STARTING.to_owned()));
+        staged_f.push(root);
+        jobs.push(Job::ready(provider));
+    }
+    let batch = startup::start(jobs);
+    match renderer.startup.as_mut() {
+        Some(running) => running.merge(batch),
+        None => renderer.startup = Some(batch),
+    }
+    (staged_p, staged_f)
+}
+
+/// A fresh instance of provider `name`, or an inert
+/// [`GenericProvider`](sicompass_sdk::provider::GenericProvider) of that name
+/// when it cannot be re-instantiated.
+fn reinstantiate_or_stand_in(name: &str) -> Box<dyn Provider> {
+    reinstantiate_provider(name).unwrap_or_else(|| {
+        eprintln!(
+            "sicompass: cannot re-instantiate provider '{name}' for new tab — using placeholder"
+        );
+        Box::new(sicompass_sdk::provider::GenericProvider::new(
+            name.to_owned(),
+            name.to_owned(),
+            |_| Vec::new(),
+        ))
+    })
+}
+
 /// Inject setting entries from a `BuiltinManifest` into the settings provider.
 /// Called from both the startup load loop and `enable_provider` so hot-enable
 /// registers identical settings to startup-enable.
@@ -564,9 +820,19 @@ fn inject_plugin_settings(settings: &mut dyn Provider, manifest: &PluginManifest
 /// provider instances, so settings is left untouched. The set of registered
 /// providers is identical regardless of `settings`, keeping provider indices
 /// stable across tabs.
-fn load_user_plugins(renderer: &mut AppRenderer, mut settings: Option<&mut dyn Provider>) {
+fn load_user_plugins(
+    renderer: &mut AppRenderer,
+    jobs: &mut Vec<Job>,
+    mut settings: Option<&mut dyn Provider>,
+) {
     let discovered = discover_user_plugins();
 
+    // What each WASM plugin costs, shown in the settings panel once one has run.
+    sicompass_config::status::register(
+        crate::wasm_host::accounting::STATUS_SECTION,
+        crate::wasm_host::accounting::status_rows,
+    );
+
     // Populate the global cache so hot-enable can find manifests later.
     *user_plugin_cache().lock().unwrap() = discovered.clone();
 
@@ -596,42 +862,52 @@ fn load_user_plugins(renderer: &mut AppRenderer, mut settings: Option<&mut dyn P
             s.add_settings_section(&m.display_name);
         }
 
-        // Construct and register the provider.
-        match instantiate_user_plugin(plugin) {
-            Some(p) => {
-                register_provider(renderer, p);
-                if let Some(s) = settings.as_deref_mut() {
-                    // Announce the load once, on the initial pass — every later tab
-                    // instantiates its own copy, and three identical lines at startup
-                    // is noise. Naming the capabilities makes it obvious at a glance
-                    // when a manifest grants more than its author meant to.
-                    if m.plugin_type == PluginType::Wasm {
-                        let caps = if m.allowed_hosts.is_empty() {
-                            "no network".to_owned()
-                        } else {
-                            format!("network: {}", m.allowed_hosts.join(", "))
-                        };
-                        eprintln!("sicompass: loaded wasm plugin '{}' ({caps})", m.name);
-                    }
-
-                    // Third-party plugin version: prefer plugin.json's `version`
-                    // field; fall back to the provider's own `Provider::version()`.
-                    let v: Option<String> = m.version.clone().or_else(|| {
-                        renderer
-                            .providers
-                            .last()
-                            .and_then(|p| p.version().map(|s| s.to_owned()))
-                    });
-                    if let Some(v) = v {
-                        s.set_section_version(&m.display_name, &v);
-                    }
+        // Give it a slot now; a WASM plugin's compilation happens on the
+        // start-up thread with its `init()`.
+        let job = match m.plugin_type {
+            PluginType::Wasm => {
+                let plugin = plugin.clone();
+                Job::build(&m.name, move || instantiate_user_plugin(&plugin))
+            }
+            PluginType::Factory => match instantiate_user_plugin(plugin) {
+                Some(p) => Job::ready(p),
+                None => {
+                    eprintln!(
+                        "sicompass: failed to load plugin '{}' from {}",
+                        m.name,
+                        plugin.entry_path.display()
+                    );
+                    continue;
                 }
+            },
+        };
+        stage_provider(
+            renderer,
+            jobs,
+            &m.display_name,
+            job.after(m.init_after.clone()),
+        );
+
+        if let Some(s) = settings.as_deref_mut() {
+            // Announce the load once, on the initial pass — every later tab
+            // instantiates its own copy, and three identical lines at startup
+            // is noise. Naming the capabilities makes it obvious at a glance
+            // when a manifest grants more than its author meant to.
+            if m.plugin_type == PluginType::Wasm {
+                let caps = if m.allowed_hosts.is_empty() {
+                    "no network".to_owned()
+                } else {
+                    format!("network: {}", m.allowed_hosts.join(", "))
+                };
+                eprintln!("sicompass: loading wasm plugin '{}' ({caps})", m.name);
+            }
+
+            // Third-party plugin version: plugin.json's `version` field here;
+            // without one, the provider's own `Provider::version()` once it
+            // has started (see `place_started`).
+            if let Some(v) = &m.version {
+                s.set_section_version(&m.display_name, v);
             }
-            None => eprintln!(
-                "sicompass: failed to load plugin '{}' from {}",
-                m.name,
-                plugin.entry_path.display()
-            ),
         }
     }
 }
@@ -640,18 +916,12 @@ fn load_user_plugins(renderer: &mut AppRenderer, mut settings: Option<&mut dyn P
 /// Returns `false` if the file doesn't exist, the section is absent, or the key
 /// is missing (user plugins are opt-in, default disabled — matches C behavior).
 fn is_plugin_enabled_in_config(name: &str) -> bool {
-    let Some(path) = sicompass_sdk::platform::main_config_path() else {
-        return false;
-    };
-    let Ok(data) = std::fs::read_to_string(&path) else {
-        return false;
-    };
-    let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) else {
+    let Some(store) = sicompass_config::settings() else {
         return false;
     };
     let config_key = format!("enable_{}", name);
-    root.get("Available programs:")
-        .and_then(|s| s.get(&config_key))
+    store
+        .get("Available programs:", &config_key)
         .and_then(|v| v.as_bool())
         .unwrap_or(false)
 }
@@ -665,13 +935,8 @@ fn is_plugin_enabled_in_config(name: &str) -> bool {
 /// provider — no English flash on launch.
 fn read_language_from_config(path: &Path) -> Option<String> {
     const ALLOWED: &[&str] = &["en-US", "nl-BE", "fr-BE", "de-BE"];
-    let data = std::fs::read_to_string(path).ok()?;
-    let root: serde_json::Value = serde_json::from_str(&data).ok()?;
-    let lang = root
-        .get("sicompass")
-        .and_then(|v| v.as_object())
-        .and_then(|sc| sc.get("language"))
-        .and_then(|v| v.as_str())?;
+    let lang = sicompass_config::at(path).get("sicompass", "language")?;
+    let lang = lang.as_str()?;
     if ALLOWED.contains(&lang) {
         Some(lang.to_owned())
     } else {
@@ -684,50 +949,39 @@ fn read_language_from_config(path: &Path) -> Option<String> {
 /// Mirrors `programs.c:422-448`. Runs once at startup; if the key is absent
 /// the function is a no-op.
 fn migrate_programs_to_load(path: &Path) {
-    let Ok(data) = std::fs::read_to_string(path) else {
-        return;
-    };
-    let Ok(mut root) = serde_json::from_str::<serde_json::Value>(&data) else {
-        return;
-    };
-
-    let programs_to_load: Vec<String> = {
-        let Some(sc) = root.get("sicompass").and_then(|v| v.as_object()) else {
-            return;
-        };
-        let Some(ptl) = sc.get("programsToLoad").and_then(|v| v.as_array()) else {
-            return;
+    sicompass_config::at(path).update(|root| {
+        let programs_to_load: Vec<String> = {
+            let Some(sc) = root.get("sicompass").and_then(|v| v.as_object()) else {
+                return false;
+            };
+            let Some(ptl) = sc.get("programsToLoad").and_then(|v| v.as_array()) else {
+                return false;
+            };
+            ptl.iter()
+                .filter_map(|v| v.as_str().map(|s| s.to_owned()))
+                .filter(|s| !s.is_empty())
+                .collect()
         };
-        ptl.iter()
-            .filter_map(|v| v.as_str().map(|s| s.to_owned()))
-            .filter(|s| !s.is_empty())
-            .collect()
-    };
 
-    // Insert enable_<name> = true into "Available programs:"
-    {
-        let available = root
-            .as_object_mut()
-            .unwrap()
-            .entry("Available programs:")
-            .or_insert_with(|| serde_json::Value::Object(serde_json::Map::new()));
-        let map = available.as_object_mut().unwrap();
-        for name in &programs_to_load {
-            let key = format!("enable_{name}");
-            map.entry(key).or_insert(serde_json::Value::Bool(true));
+        // Insert enable_<name> = true into "Available programs:"
+        {
+            let available = root
+                .entry("Available programs:")
+                .or_insert_with(|| serde_json::Value::Object(serde_json::Map::new()));
+            if let Some(map) = available.as_object_mut() {
+                for name in &programs_to_load {
+                    let key = format!("enable_{name}");
+                    map.entry(key).or_insert(serde_json::Value::Bool(true));
+                }
+            }
         }
-    }
-
-    // Remove programsToLoad
-    if let Some(sc) = root.get_mut("sicompass").and_then(|v| v.as_object_mut()) {
-        sc.remove("programsToLoad");
-    }
 
-    // Write back atomically so a concurrent sicompass instance never reads a
-    // truncated settings.json (which it would then rebuild from an empty map).
-    if let Ok(json) = serde_json::to_string_pretty(&root) {
-        let _ = sicompass_sdk::platform::atomic_write(path, &json);
-    }
+        // Remove programsToLoad
+        if let Some(sc) = root.get_mut("sicompass").and_then(|v| v.as_object_mut()) {
+            sc.remove("programsToLoad");
+        }
+        true
+    });
 }
 
 /// Migrate the renamed "editor" plugin to "text editor".
@@ -737,82 +991,55 @@ fn migrate_programs_to_load(path: &Path) {
 /// `Available programs:.enable_editor` toggle to `enable_text editor`. Runs
 /// once at startup; if no old keys are present the function is a no-op.
 fn migrate_editor_to_text_editor(path: &Path) {
-    let Ok(data) = std::fs::read_to_string(path) else {
-        return;
-    };
-    let Ok(mut root) = serde_json::from_str::<serde_json::Value>(&data) else {
-        return;
-    };
-    let Some(obj) = root.as_object_mut() else {
-        return;
-    };
-
-    let mut changed = false;
-
-    // Move the "editor" section → "text editor", renaming "editorPath" inside.
-    if let Some(mut section) = obj.remove("editor") {
-        if let Some(sec) = section.as_object_mut() {
-            if let Some(v) = sec.remove("editorPath") {
-                sec.entry("textEditorPath").or_insert(v);
+    sicompass_config::at(path).update(|obj| {
+        let mut changed = false;
+
+        // Move the "editor" section → "text editor", renaming "editorPath" inside.
+        if let Some(mut section) = obj.remove("editor") {
+            if let Some(sec) = section.as_object_mut() {
+                if let Some(v) = sec.remove("editorPath") {
+                    sec.entry("textEditorPath").or_insert(v);
+                }
             }
-        }
-        // Merge into an existing "text editor" section rather than clobbering.
-        match obj.get_mut("text editor").and_then(|v| v.as_object_mut()) {
-            Some(existing) => {
-                if let Some(sec) = section.as_object() {
-                    for (k, v) in sec {
-                        existing.entry(k.clone()).or_insert(v.clone());
+            // Merge into an existing "text editor" section rather than clobbering.
+            match obj.get_mut("text editor").and_then(|v| v.as_object_mut()) {
+                Some(existing) => {
+                    if let Some(sec) = section.as_object() {
+                        for (k, v) in sec {
+                            existing.entry(k.clone()).or_insert(v.clone());
+                        }
                     }
                 }
+                None => {
+                    obj.insert("text editor".to_owned(), section);
+                }
             }
-            None => {
-                obj.insert("text editor".to_owned(), section);
-            }
-        }
-        changed = true;
-    }
-
-    // Rename the "Available programs:" enable toggle.
-    if let Some(available) = obj
-        .get_mut("Available programs:")
-        .and_then(|v| v.as_object_mut())
-    {
-        if let Some(v) = available.remove("enable_editor") {
-            available
-                .entry("enable_text editor".to_owned())
-                .or_insert(v);
             changed = true;
         }
-    }
 
-    if !changed {
-        return;
-    }
+        // Rename the "Available programs:" enable toggle.
+        if let Some(available) = obj
+            .get_mut("Available programs:")
+            .and_then(|v| v.as_object_mut())
+        {
+            if let Some(v) = available.remove("enable_editor") {
+                available
+                    .entry("enable_text editor".to_owned())
+                    .or_insert(v);
+                changed = true;
+            }
+        }
 
-    // Write back atomically (see migrate_programs_to_load).
-    if let Ok(json) = serde_json::to_string_pretty(&root) {
-        let _ = sicompass_sdk::platform::atomic_write(path, &json);
-    }
+        changed
+    });
 }
 
 /// Read `sicompass.maximized` from settings.json.
 /// Returns `false` if absent, unparseable, or file missing.
 pub fn read_maximized() -> bool {
-    let Some(path) = sicompass_sdk::platform::main_config_path() else {
-        return false;
-    };
-    let Ok(data) = std::fs::read_to_string(&path) else {
-        return false;
-    };
-    let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) else {
-        return false;
-    };
-    let val = root
-        .get("sicompass")
-        .and_then(|v| v.as_object())
-        .and_then(|s| s.get("maximized"));
+    let val = sicompass_config::settings().and_then(|s| s.get("sicompass", "maximized"));
     match val {
-        Some(serde_json::Value::Bool(b)) => *b,
+        Some(serde_json::Value::Bool(b)) => b,
         Some(serde_json::Value::String(s)) => s == "true",
         _ => false,
     }
@@ -822,41 +1049,11 @@ pub fn read_maximized() -> bool {
 ///
 /// The maximize/restore checkbox was removed from the settings UI, so this is
 /// the sole writer of the window-state value (read back by [`read_maximized`]
-/// at startup). Mirrors the settings provider's safe merge-write: load the
-/// existing root, set the one key, atomic-write the whole file back. Aborts —
-/// leaving the file intact — if it exists but can't be read or parsed, so a
-/// transient failure never wipes the user's config.
+/// at startup). The store only writes when the value actually changes, and
+/// refuses — leaving the file intact — if it exists but can't be parsed.
 pub fn write_maximized(value: bool) {
-    // Only touch the file when the value actually changes — never rewrite
-    // (and so never reformat / "refresh") settings.json for a no-op toggle.
-    if read_maximized() == value {
-        return;
-    }
-    let Some(path) = sicompass_sdk::platform::main_config_path() else {
-        return;
-    };
-    if let Some(parent) = path.parent() {
-        sicompass_sdk::platform::make_dirs(parent);
-    }
-    // Only a genuinely missing file may start from scratch; an existing but
-    // unreadable/corrupt file is left untouched rather than clobbered.
-    let mut root = match std::fs::read_to_string(&path) {
-        Ok(data) => match serde_json::from_str::<serde_json::Value>(&data) {
-            Ok(serde_json::Value::Object(m)) => m,
-            _ => return,
-        },
-        Err(e) if e.kind() == std::io::ErrorKind::NotFound => serde_json::Map::new(),
-        Err(_) => return,
-    };
-
-    let sec = root
-        .entry("sicompass".to_owned())
-        .or_insert_with(|| serde_json::Value::Object(serde_json::Map::new()));
-    if let serde_json::Value::Object(m) = sec {
-        m.insert("maximized".to_owned(), serde_json::Value::Bool(value));
-    }
-    if let Ok(json) = serde_json::to_string_pretty(&serde_json::Value::Object(root)) {
-        let _ = sicompass_sdk::platform::atomic_write(&path, &json);
+    if let Some(store) = sicompass_config::settings() {
+        store.set("sicompass", "maximized", value);
     }
 }
 
@@ -868,20 +1065,35 @@ pub fn write_maximized(value: bool) {
 /// Tabs whose first index points to a provider that is no longer registered
 /// (e.g. the program was disabled) are dropped; if everything is filtered out,
 /// the existing default is preserved.
+///
+/// With `r.journal_dir` set, every tab's undo timeline is restored from the
+/// journal its `"journal"` key names; a tab without one starts a journal,
+/// and the new keys are saved right away.
 pub fn load_tabs_state(r: &mut crate::app_state::AppRenderer) {
-    let Some(path) = sicompass_sdk::platform::main_config_path() else {
-        return;
-    };
-    let Ok(data) = std::fs::read_to_string(&path) else {
-        return;
-    };
-    let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) else {
-        return;
-    };
-    let Some(sec) = root.get("sicompass").and_then(|v| v.as_object()) else {
+    if let Some(serde_json::Value::Object(sec)) = sicompass_config::settings()
+        .and_then(|s| s.read(|root| root.get("sicompass").cloned()))
+        .flatten()
+    {
+        apply_tabs_section(r, &sec);
+    }
+
+    let Some(dir) = r.journal_dir.clone() else {
         return;
     };
-    apply_tabs_section(r, sec);
+    let mut started = false;
+    for tl in r.tab_timelines.iter_mut().filter(|tl| tl.journal.is_none()) {
+        *tl = crate::timeline_journal::open_timeline(Some(&dir), None, &[]);
+        started |= tl.journal.is_some();
+    }
+    let keys: Vec<&str> = r
+        .tab_timelines
+        .iter()
+        .filter_map(|tl| tl.journal.as_ref().map(|j| j.key()))
+        .collect();
+    crate::timeline_journal::remove_orphans(&dir, &keys);
+    if started {
+        crate::handlers::persist_tabs(r);
+    }
 }
 
 /// Apply the parsed `sicompass` settings section to `r`. Split out from
@@ -901,7 +1113,7 @@ pub fn apply_tabs_section(
 
     // Parse the persisted nav entries (id + active provider path) per tab,
     // dropping any whose provider index no longer exists.
-    let parsed: Vec<(IdArray, String, bool)> = sec
+    let parsed: Vec<(IdArray, String, bool, Option<String>)> = sec
         .get("tabs")
         .and_then(|v| v.as_str())
         .and_then(|s| serde_json::from_str::<serde_json::Value>(s).ok())
@@ -918,13 +1130,18 @@ pub fn apply_tabs_section(
                     // Absent in configs written by older builds — the `false` default is
                     // the ordinary "descend into the saved path" restore.
                     let on_path = obj.get("onPath").and_then(|v| v.as_bool()).unwrap_or(false);
+                    // The tab's undo journal; absent before journals were kept.
+                    let journal = obj
+                        .get("journal")
+                        .and_then(|v| v.as_str())
+                        .map(str::to_owned);
                     let mut id = IdArray::new();
                     for n in ids {
                         id.push(n.as_u64()? as usize);
                     }
                     match id.get(0) {
                         Some(pi) if pi < provider_count && id.depth() > 0 => {
-                            Some((id, path, on_path))
+                            Some((id, path, on_path, journal))
                         }
                         _ => None,
                     }
@@ -934,67 +1151,86 @@ pub fn apply_tabs_section(
         .unwrap_or_default();
 
     if !parsed.is_empty() {
-        // Capture the bootstrap content provider names BEFORE detaching, so
-        // each freshly built tab mirrors them exactly (count + order).
-        let content_n = r.providers.len().saturating_sub(1);
-        let content_names: Vec<String> = r.providers[..content_n]
-            .iter()
-            .map(|p| p.name().to_owned())
-            .collect();
-
-        // Each restored tab gets its own independent content-provider set.
-        // The first tab reuses the already-live bootstrap set; the rest are
-        // built fresh. For each we attach the set, rebuild its saved provider
-        // path, then park it back out into the tab record.
+        // Resolve the active tab first: only it is built now, on the live
+        // bootstrap set. The rest come back as stubs and are built on first
+        // activation (or while the user is idle — see `AppRenderer::tend_tabs`),
+        // so a long tab list costs nothing before the first frame.
+        let mut active = 0;
+        if let Some(active_str) = sec.get("activeTab").and_then(|v| v.as_str()) {
+            if let Ok(n) = active_str.parse::<usize>() {
+                if n < parsed.len() {
+                    active = n;
+                }
+            }
+        }
         let mut tabs: Vec<TabSnapshot> = Vec::with_capacity(parsed.len());
-        for (i, (id, path, on_path)) in parsed.into_iter().enumerate() {
-            let (cp, cf) = if i == 0 {
-                r.detach_content()
-            } else {
-                build_content_set_from_names(r, &content_names)
-            };
-            r.attach_content(cp, cf);
+        let mut journals: Vec<Option<String>> = Vec::with_capacity(parsed.len());
+        for (i, (id, path, on_path, journal)) in parsed.into_iter().enumerate() {
+            journals.push(journal);
+            if i != active {
+                // Every tab shares the bootstrap ordering, so the name at
+                // `id[0]` is the provider the tab was on.
+                let provider_name = id
+                    .get(0)
+                    .and_then(|pi| r.providers.get(pi))
+                    .map(|p| p.name().to_owned())
+                    .unwrap_or_default();
+                tabs.push(TabSnapshot::stub(
+                    id,
+                    path,
+                    crate::app_state::TabStub {
+                        provider_name,
+                        on_path,
+                    },
+                ));
+                continue;
+            }
+            // Its provider is still starting: wait on that provider's row, and
+            // walk to the saved navigation once it is swapped in (see
+            // `place_started`).
+            if let Some(pi) = id.get(0)
+                && r.ffon.get(pi).is_some_and(is_starting)
+            {
+                let provider_name = r.providers[pi].name().to_owned();
+                let mut root = IdArray::new();
+                root.push(pi);
+                r.current_id = root;
+                let mut tab = TabSnapshot::nav_only(id, path);
+                tab.pending_nav = Some(crate::app_state::TabStub {
+                    provider_name,
+                    on_path,
+                });
+                tabs.push(tab);
+                continue;
+            }
             if on_path {
                 r.rebuild_on_path(&path, id);
             } else {
                 r.rebuild_and_clamp(&path, id);
             }
-            let current_id = r.current_id.clone();
             // `rebuild_on_path` leaves the provider at `path` on success, and at
             // the deepest level it could reach when a directory has gone missing,
             // so read the live value back rather than re-storing what was saved.
             let provider_path = crate::app_state::active_provider_path(r);
-            let (cp, cf) = r.detach_content();
-            tabs.push(TabSnapshot {
-                current_id,
-                provider_path,
-                providers: cp,
-                ffon: cf,
-            });
+            tabs.push(TabSnapshot::nav_only(r.current_id.clone(), provider_path));
         }
         r.tabs = tabs;
         // Keep `tab_timelines` parallel to `tabs` (invariant relied on by
         // `active_timeline_mut()`).
         r.tab_timelines
             .resize_with(r.tabs.len(), crate::app_state::Timeline::new);
-
-        // Resolve the active tab and make its parked content the live set.
-        let mut active = 0;
-        if let Some(active_str) = sec.get("activeTab").and_then(|v| v.as_str()) {
-            if let Ok(n) = active_str.parse::<usize>() {
-                if n < r.tabs.len() {
-                    active = n;
-                }
+        if let Some(dir) = r.journal_dir.clone() {
+            let names = r.provider_names();
+            let names: Vec<&str> = names.iter().map(String::as_str).collect();
+            for (tl, key) in r.tab_timelines.iter_mut().zip(&journals) {
+                *tl = crate::timeline_journal::open_timeline(Some(&dir), key.as_deref(), &names);
             }
         }
+
         r.active_tab = active;
         // Seed the MRU order to a default front-first sequence (no real visit
         // history exists across restarts; the active tab leads).
         r.reset_mru_default(active);
-        let cp = std::mem::take(&mut r.tabs[active].providers);
-        let cf = std::mem::take(&mut r.tabs[active].ffon);
-        r.attach_content(cp, cf);
-        r.current_id = r.tabs[active].current_id.clone();
         r.list_index = r.current_id.last().unwrap_or(0);
         return;
     }
@@ -1017,19 +1253,8 @@ pub const DEFAULT_FONT_SCALE: f32 = 1.75;
 /// Read `sicompass.fontScale` from settings.json.
 /// Returns [`DEFAULT_FONT_SCALE`] if absent or unparseable. Clamped to [1.0, 2.5].
 pub fn read_font_scale() -> f32 {
-    let Some(path) = sicompass_sdk::platform::main_config_path() else {
-        return DEFAULT_FONT_SCALE;
-    };
-    let Ok(data) = std::fs::read_to_string(&path) else {
-        return DEFAULT_FONT_SCALE;
-    };
-    let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) else {
-        return DEFAULT_FONT_SCALE;
-    };
-    let raw = root
-        .get("sicompass")
-        .and_then(|v| v.as_object())
-        .and_then(|s| s.get("fontScale"))
+    let raw = sicompass_config::settings()
+        .and_then(|s| s.get("sicompass", "fontScale"))
         .and_then(|v| {
             v.as_str()
                 .map(|s| s.to_owned())
@@ -1043,10 +1268,8 @@ pub fn read_font_scale() -> f32 {
 /// Read `remoteUrl` and `apiKey` from settings.json for the given section.
 /// Returns `None` if the file or section is absent, or if `remoteUrl` is empty.
 fn read_remote_config(section: &str) -> Option<(String, String)> {
-    let path = sicompass_sdk::platform::main_config_path()?;
-    let data = std::fs::read_to_string(&path).ok()?;
-    let root = serde_json::from_str::<serde_json::Value>(&data).ok()?;
-    let sec = root.get(section)?.as_object()?;
+    let root = sicompass_config::settings()?.read(|root| root.get(section).cloned())??;
+    let sec = root.as_object()?;
     let remote_url = sec.get("remoteUrl")?.as_str()?.to_owned();
     if remote_url.is_empty() {
         return None;
@@ -1064,22 +1287,17 @@ fn read_remote_config(section: &str) -> Option<(String, String)> {
 /// providers.  Mirrors the "unknown program → remote service" branch of C's
 /// `loadProgram` (src/sicompass/programs.c:247-273) but applied at startup so
 /// remote services are reachable without requiring a hot-enable action.
-fn load_remote_programs(renderer: &mut AppRenderer, mut settings: Option<&mut dyn Provider>) {
-    let path = match sicompass_sdk::platform::main_config_path() {
-        Some(p) => p,
-        None => return,
-    };
-    let data = match std::fs::read_to_string(&path) {
-        Ok(d) => d,
-        Err(_) => return,
-    };
-    let root = match serde_json::from_str::<serde_json::Value>(&data) {
-        Ok(v) => v,
-        Err(_) => return,
-    };
-    let available = match root.get("Available programs:").and_then(|v| v.as_object()) {
-        Some(m) => m,
-        None => return,
+fn load_remote_programs(
+    renderer: &mut AppRenderer,
+    jobs: &mut Vec<Job>,
+    mut settings: Option<&mut dyn Provider>,
+) {
+    let available = match sicompass_config::settings()
+        .and_then(|s| s.read(|root| root.get("Available programs:").cloned()))
+        .flatten()
+    {
+        Some(serde_json::Value::Object(m)) => m,
+        _ => return,
     };
 
     let builtin_manifests = sicompass_sdk::builtin_manifests();
@@ -1120,7 +1338,8 @@ fn load_remote_programs(renderer: &mut AppRenderer, mut settings: Option<&mut dy
 
         let provider: Box<dyn Provider> =
             sicompass_builtins::create_remote(name, remote_url, api_key);
-        register_provider(renderer, provider);
+        let display = provider.display_name();
+        stage_provider(renderer, jobs, &display, Job::ready(provider));
 
         // Register the two settings text entries for this remote service.
         if let Some(s) = settings.as_deref_mut() {
@@ -1573,6 +1792,20 @@ pub fn disable_provider(renderer: &mut AppRenderer, name: &str) {
     }
 }
 
+/// Drop the warm instances kept for a just-disabled WASM plugin. Every tab has
+/// let go of its provider by now; without this the pool would keep a linked
+/// component and a spare store alive until the app exits.
+fn release_plugin_pool(name: &str) {
+    let guard = user_plugin_cache().lock().unwrap();
+    if let Some(plugin) = guard.iter().find(|p| {
+        name_matches_provider(name, &p.manifest.name)
+            || name_matches_provider(name, &p.manifest.display_name)
+    }) && plugin.manifest.plugin_type == PluginType::Wasm
+    {
+        crate::wasm_host::pool::release(&plugin.manifest.name);
+    }
+}
+
 /// Propagate a just-enabled provider to every INACTIVE tab's parked content set
 /// so the enabled-program list stays identical across tabs. The active tab is
 /// skipped (already handled by [`enable_provider`], whose changes live in
@@ -1581,7 +1814,8 @@ pub fn disable_provider(renderer: &mut AppRenderer, name: &str) {
 fn propagate_enable_to_parked_tabs(renderer: &mut AppRenderer, name: &str) {
     let active = renderer.active_tab;
     for i in 0..renderer.tabs.len() {
-        if i == active {
+        // A stub has nothing built; it finds its provider by name when it is.
+        if i == active || renderer.tabs[i].is_stub() {
             continue;
         }
         // Skip tabs that somehow already have it (idempotent).
@@ -1623,7 +1857,7 @@ fn propagate_enable_to_parked_tabs(renderer: &mut AppRenderer, name: &str) {
 fn propagate_disable_to_parked_tabs(renderer: &mut AppRenderer, name: &str) {
     let active = renderer.active_tab;
     for i in 0..renderer.tabs.len() {
-        if i == active {
+        if i == active || renderer.tabs[i].is_stub() {
             continue;
         }
         let tab = &mut renderer.tabs[i];
@@ -1690,6 +1924,7 @@ fn apply_setting(renderer: &mut AppRenderer, key: &str, value: &str, skip_enable
         } else {
             disable_provider(renderer, name);
             propagate_disable_to_parked_tabs(renderer, name);
+            release_plugin_pool(name);
         }
         return;
     }
@@ -1766,6 +2001,14 @@ fn apply_setting(renderer: &mut AppRenderer, key: &str, value: &str, skip_enable
             provider.on_setting_change(key, value);
         }
     }
+    // Providers still starting are placeholders here; `place_started` replays
+    // what they missed.
+    if renderer.startup.is_some() {
+        renderer.startup_settings.retain(|(k, _)| k != key);
+        renderer
+            .startup_settings
+            .push((key.to_owned(), value.to_owned()));
+    }
 }
 
 // ---------------------------------------------------------------------------
@@ -1786,27 +2029,23 @@ fn enabled_programs() -> Vec<String> {
     let manifests = sicompass_sdk::builtin_manifests();
     let non_always: Vec<_> = manifests.iter().filter(|m| !m.always_enabled).collect();
 
-    if let Some(path) = sicompass_sdk::platform::main_config_path() {
-        if let Ok(data) = std::fs::read_to_string(&path) {
-            if let Ok(root) = serde_json::from_str::<serde_json::Value>(&data) {
-                if let Some(section) = root.get("Available programs:") {
-                    let mut result = Vec::new();
-                    for m in &non_always {
-                        let config_key = format!("enable_{}", m.display_name);
-                        let enabled = section
-                            .get(&config_key)
-                            .and_then(|v| v.as_bool())
-                            .unwrap_or(m.enable_default);
-                        if enabled {
-                            result.push(m.display_name.clone());
-                        }
-                    }
-                    if !result.is_empty() {
-                        return result;
-                    }
-                }
+    if let Some(Some(section)) = sicompass_config::settings()
+        .and_then(|s| s.read(|root| root.get("Available programs:").cloned()))
+    {
+        let mut result = Vec::new();
+        for m in &non_always {
+            let config_key = format!("enable_{}", m.display_name);
+            let enabled = section
+                .get(&config_key)
+                .and_then(|v| v.as_bool())
+                .unwrap_or(m.enable_default);
+            if enabled {
+                result.push(m.display_name.clone());
             }
         }
+        if !result.is_empty() {
+            return result;
+        }
     }
 
     non_always
@@ -2328,6 +2567,7 @@ mod tests {
             pubkey: None,
             hot_reload: true,
             allowed_hosts: vec![],
+            init_after: vec![],
         }
     }
 
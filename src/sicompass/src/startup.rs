@@ -0,0 +1,487 @@
+//! Provider start-up — building, `init()` and first `fetch()` of a set of
+//! providers, run side by side on the provider runtime.
+//!
+//! Started one after another on the main thread, the app's first frame waited
+//! for the sum of every provider's start: the email cache open, the chat
+//! client's sync setup, WASM component compilation, the terminal's shell spawn.
+//! Here each provider starts on its own blocking thread, so the wait is the
+//! slowest start rather than the sum of all of them.
+//!
+//! ## Order
+//!
+//! Results arrive in whatever order the providers finish; they carry their
+//! job index, and the caller owns placement — the root list order is decided
+//! before anything starts (see `programs::load_content_providers`), so it does
+//! not depend on which provider happens to be quick today.
+//!
+//! A job may name providers it has to start after ([`Job::after`], from a
+//! plugin manifest's `initAfter`). It then waits for those to finish, whether
+//! they succeeded or not. Names outside the batch are ignored, and so is the
+//! whole `after` list of a job caught in a cycle — one bad manifest cannot
+//! stall start-up.
+//!
+//! ## Timings
+//!
+//! Every result carries an [`InitTiming`]: how long the job waited for its
+//! dependencies and how long it took itself. The app keeps them on
+//! `AppRenderer::startup_timings` and logs them, so start-up can be measured
+//! from a headless harness without a window.
+
+use sicompass_sdk::ffon::FfonElement;
+use sicompass_sdk::provider::Provider;
+use std::panic::{AssertUnwindSafe, catch_unwind};
+use std::sync::mpsc::{self, Receiver, RecvTimeoutError};
+use std::sync::{Arc, Condvar, Mutex};
+use std::time::{Duration, Instant};
+
+/// Single child of a provider's root while it is still starting.
+pub const STARTING: &str = "Starting…";
+
+/// How long the app waits for providers before its first frame. Whatever is
+/// still starting then shows [`STARTING`] and is swapped in when it is done.
+pub const FIRST_FRAME_WAIT: Duration = Duration::from_millis(750);
+
+type Make = Box<dyn FnOnce() -> Option<Box<dyn Provider>> + Send>;
+
+/// One provider to start.
+pub struct Job {
+    /// Provider name, as `Provider::name` will report it.
+    pub name: String,
+    /// Providers (by name) that must finish starting first.
+    pub after: Vec<String>,
+    make: Make,
+}
+
+impl Job {
+    /// Start a provider that is already built.
+    pub fn ready(provider: Box<dyn Provider>) -> Self {
+        Job {
+            name: provider.name().to_owned(),
+            after: Vec::new(),
+            make: Box::new(move || Some(provider)),
+        }
+    }
+
+    /// Build the provider on the start-up thread too — for providers whose
+    /// construction is itself the slow part (WASM compilation). `make`
+    /// returning `None` means it could not be built.
+    pub fn build(
+        name: &str,
+        make: impl FnOnce() -> Option<Box<dyn Provider>> + Send + 'static,
+    ) -> Self {
+        Job {
+            name: name.to_owned(),
+            after: Vec::new(),
+            make: Box::new(make),
+        }
+    }
+
+    pub fn after(mut self, names: Vec<String>) -> Self {
+        self.after = names;
+        self
+    }
+}
+
+/// How one provider's start went, in time.
+#[derive(Debug, Clone, PartialEq)]
+pub struct InitTiming {
+    pub name: String,
+    /// From the start of the batch until the job could begin.
+    pub waited: Duration,
+    /// Building, `init()` and the first `fetch()`.
+    pub took: Duration,
+}
+
+/// A finished job.
+pub struct Started {
+    /// Position of the job in the batch given to [`start`].
+    pub index: usize,
+    pub name: String,
+    /// `None` when the provider could not be built or panicked while starting.
+    pub provider: Option<Box<dyn Provider>>,
+    /// Its first `fetch()`.
+    pub children: Vec<FfonElement>,
+    pub error: Option<String>,
+    pub timing: InitTiming,
+}
+
+/// A batch of providers starting.
+pub struct Startup {
+    rx: Receiver<Started>,
+    pending: usize,
+    began: Instant,
+    /// Batches started later and handed in with [`Startup::merge`], collected
+    /// after this one's jobs.
+    merged: Vec<Startup>,
+}
+
+impl Startup {
+    /// Jobs not yet handed back.
+    pub fn pending(&self) -> usize {
+        self.pending + self.merged.iter().map(Startup::pending).sum::<usize>()
+    }
+
+    /// Hand `other`'s jobs back along with this batch's, so whoever polls
+    /// this batch places them too.
+    pub fn merge(&mut self, other: Startup) {
+        self.merged.push(other);
+    }
+
+    /// Time since the batch was started.
+    pub fn elapsed(&self) -> Duration {
+        self.began.elapsed()
+    }
+
+    /// Collect finished jobs until all are in or `deadline` passes.
+    pub fn wait_until(&mut self, deadline: Instant) -> Vec<Started> {
+        let mut done = Vec::new();
+        while self.pending > 0 {
+            let left = deadline.saturating_duration_since(Instant::now());
+            match self.rx.recv_timeout(left) {
+                Ok(started) => {
+                    self.pending -= 1;
+                    done.push(started);
+                }
+                Err(RecvTimeoutError::Timeout) => break,
+                // Every job has sent or died without sending; nothing more
+                // will come.
+                Err(RecvTimeoutError::Disconnected) => {
+                    self.pending = 0;
+                    break;
+                }
+            }
+        }
+        for batch in &mut self.merged {
+            done.extend(batch.wait_until(deadline));
+        }
+        done
+    }
+
+    /// Collect every job, however long it takes.
+    pub fn wait_all(&mut self) -> Vec<Started> {
+        let mut done = Vec::new();
+        while self.pending > 0 {
+            match self.rx.recv() {
+                Ok(started) => {
+                    self.pending -= 1;
+                    done.push(started);
+                }
+                Err(_) => self.pending = 0,
+            }
+        }
+        for batch in &mut self.merged {
+            done.extend(batch.wait_all());
+        }
+        done
+    }
+
+    /// Collect whatever has finished, without waiting.
+    pub fn try_take(&mut self) -> Vec<Started> {
+        let mut done = Vec::new();
+        while self.pending > 0 {
+            match self.rx.try_recv() {
+                Ok(started) => {
+                    self.pending -= 1;
+                    done.push(started);
+                }
+                Err(mpsc::TryRecvError::Empty) => break,
+                Err(mpsc::TryRecvError::Disconnected) => self.pending = 0,
+            }
+        }
+        for batch in &mut self.merged {
+            done.extend(batch.try_take());
+        }
+        done
+    }
+}
+
+/// Jobs that have finished, whether they succeeded or not.
+struct Gate {
+    done: Mutex<Vec<bool>>,
+    changed: Condvar,
+}
+
+impl Gate {
+    fn wait_for(&self, deps: &[usize]) {
+        let mut done = self.done.lock().unwrap_or_else(|e| e.into_inner());
+        while !deps.iter().all(|&d| done[d]) {
+            done = self.changed.wait(done).unwrap_or_else(|e| e.into_inner());
+        }
+    }
+}
+
+/// Marks its job finished when dropped, so dependents are released on every
+/// path out of the job, unwinding included.
+struct Finished(Arc<Gate>, usize);
+
+impl Drop for Finished {
+    fn drop(&mut self) {
+        let mut done = self.0.done.lock().unwrap_or_else(|e| e.into_inner());
+        done[self.1] = true;
+        self.0.changed.notify_all();
+    }
+}
+
+/// Start every job in `jobs` on the provider runtime.
+pub fn start(jobs: Vec<Job>) -> Startup {
+    let deps = resolve_order(&jobs);
+    let gate = Arc::new(Gate {
+        done: Mutex::new(vec![false; jobs.len()]),
+        changed: Condvar::new(),
+    });
+    let (tx, rx) = mpsc::channel();
+    let began = Instant::now();
+    let pending = jobs.len();
+    for ((index, job), deps) in jobs.into_iter().enumerate().zip(deps) {
+        let tx = tx.clone();
+        let gate = Arc::clone(&gate);
+        crate::state::provider_runtime().spawn_blocking(move || {
+            let _finished = Finished(Arc::clone(&gate), index);
+            gate.wait_for(&deps);
+            let waited = began.elapsed();
+            let t = Instant::now();
+            let Job { name, make, .. } = job;
+            let (provider, children, error) = run(&name, make);
+            // A send failure means nobody is waiting any more (the app is
+            // closing); the provider is then dropped here.
+            let _ = tx.send(Started {
+                index,
+                timing: InitTiming {
+                    name: name.clone(),
+                    waited,
+                    took: t.elapsed(),
+                },
+                name,
+                provider,
+                children,
+                error,
+            });
+        });
+    }
+    Startup {
+        rx,
+        pending,
+        began,
+        merged: Vec::new(),
+    }
+}
+
+fn run(name: &str, make: Make) -> (Option<Box<dyn Provider>>, Vec<FfonElement>, Option<String>) {
+    let outcome = catch_unwind(AssertUnwindSafe(|| {
+        let mut provider = make()?;
+        provider.init();
+        let children = provider.fetch();
+        let error = provider.take_error();
+        Some((provider, children, error))
+    }));
+    match outcome {
+        Ok(Some((provider, children, error))) => (Some(provider), children, error),
+        Ok(None) => (
+            None,
+            Vec::new(),
+            Some(format!("{name} could not be loaded")),
+        ),
+        Err(_) => (
+            None,
+            Vec::new(),
+            Some(format!("{name} failed while starting")),
+        ),
+    }
+}
+
+/// Each job's dependencies, as job indices. `after` names outside the batch
+/// are dropped; so is the `after` list of every job that cannot be ordered
+/// (a cycle, or something waiting on one).
+fn resolve_order(jobs: &[Job]) -> Vec<Vec<usize>> {
+    let mut deps: Vec<Vec<usize>> = jobs
+        .iter()
+        .enumerate()
+        .map(|(i, job)| {
+            let mut d: Vec<usize> = job
+                .after
+                .iter()
+                .filter_map(|want| jobs.iter().position(|j| j.name.eq_ignore_ascii_case(want)))
+                .filter(|&d| d != i)
+                .collect();
+            d.sort_unstable();
+            d.dedup();
+            d
+        })
+        .collect();
+
+    // Kahn's algorithm: whatever is never freed is stuck behind a cycle.
+    let mut unmet: Vec<usize> = deps.iter().map(Vec::len).collect();
+    let mut ready: Vec<usize> = (0..jobs.len()).filter(|&i| unmet[i] == 0).collect();
+    let mut ordered = vec![false; jobs.len()];
+    while let Some(i) = ready.pop() {
+        ordered[i] = true;
+        for (j, d) in deps.iter().enumerate() {
+            if d.contains(&i) {
+                unmet[j] -= 1;
+                if unmet[j] == 0 {
+                    ready.push(j);
+                }
+            }
+        }
+    }
+    for (i, d) in deps.iter_mut().enumerate() {
+        if !ordered[i] {
+            eprintln!(
+                "sicompass: start-up order of '{}' ignored — its initAfter list forms a cycle",
+                jobs[i].name
+            );
+            d.clear();
+        }
+    }
+    deps
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use sicompass_sdk::provider::GenericProvider;
+
+    /// A job whose build sleeps `ms` and records when it ran.
+    fn slow(
+        name: &'static str,
+        ms: u64,
+        log: Arc<Mutex<Vec<(&'static str, Instant, Instant)>>>,
+    ) -> Job {
+        Job::build(name, move || {
+            let from = Instant::now();
+            std::thread::sleep(Duration::from_millis(ms));
+            log.lock().unwrap().push((name, from, Instant::now()));
+            Some(Box::new(GenericProvider::new(
+                name.to_owned(),
+                name.to_owned(),
+                |_| vec![FfonElement::new_str("ok".to_owned())],
+            )) as Box<dyn Provider>)
+        })
+    }
+
+    #[test]
+    fn providers_start_side_by_side() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let jobs = (0..4)
+            .map(|i| slow(["a", "b", "c", "d"][i], 200, Arc::clone(&log)))
+            .collect();
+        let t = Instant::now();
+        let mut startup = start(jobs);
+        let done = startup.wait_all();
+        assert_eq!(done.len(), 4);
+        assert!(
+            t.elapsed() < Duration::from_millis(600),
+            "four 200 ms starts took {:?}",
+            t.elapsed()
+        );
+        for s in &done {
+            assert!(s.provider.is_some());
+            assert_eq!(s.children, vec![FfonElement::new_str("ok".to_owned())]);
+            assert!(s.timing.took >= Duration::from_millis(200));
+        }
+    }
+
+    #[test]
+    fn a_job_waits_for_what_it_starts_after() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let jobs = vec![
+            slow("late", 10, Arc::clone(&log)).after(vec!["Early".to_owned()]),
+            slow("early", 150, Arc::clone(&log)),
+            slow("free", 10, Arc::clone(&log)).after(vec!["not in this batch".to_owned()]),
+        ];
+        let done = start(jobs).wait_all();
+        assert_eq!(done.len(), 3);
+        let log = log.lock().unwrap();
+        let at = |n: &str| *log.iter().find(|(name, ..)| *name == n).unwrap();
+        assert!(
+            at("late").1 >= at("early").2,
+            "late began before early finished"
+        );
+        // An unknown dependency does not hold a job back.
+        assert!(at("free").1 < at("early").2);
+        let late = done.iter().find(|s| s.name == "late").unwrap();
+        assert!(late.timing.waited >= Duration::from_millis(150));
+        assert_eq!(late.index, 0);
+    }
+
+    #[test]
+    fn a_cycle_is_broken_rather_than_waited_on() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let jobs = vec![
+            slow("x", 10, Arc::clone(&log)).after(vec!["y".to_owned()]),
+            slow("y", 10, Arc::clone(&log)).after(vec!["x".to_owned()]),
+            slow("z", 10, Arc::clone(&log)).after(vec!["x".to_owned()]),
+        ];
+        let mut startup = start(jobs);
+        let done = startup.wait_until(Instant::now() + Duration::from_secs(5));
+        assert_eq!(done.len(), 3);
+        assert_eq!(startup.pending(), 0);
+    }
+
+    #[test]
+    fn a_provider_that_cannot_be_built_or_panics_still_reports_and_releases_dependents() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let jobs = vec![
+            Job::build("missing", || None),
+            Job::build("broken", || panic!("boom")),
+            slow("after both", 10, Arc::clone(&log))
+                .after(vec!["missing".to_owned(), "broken".to_owned()]),
+        ];
+        let mut done = start(jobs).wait_all();
+        done.sort_by_key(|s| s.index);
+        assert!(done[0].provider.is_none());
+        assert!(
+            done[0]
+                .error
+                .as_deref()
+                .unwrap()
+                .contains("could not be loaded")
+        );
+        assert!(done[1].provider.is_none());
+        assert!(
+            done[1]
+                .error
+                .as_deref()
+                .unwrap()
+                .contains("failed while starting")
+        );
+        assert!(done[2].provider.is_some());
+    }
+
+    #[test]
+    fn a_deadline_leaves_slow_jobs_for_later() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let jobs = vec![
+            slow("quick", 1, Arc::clone(&log)),
+            slow("slow", 300, Arc::clone(&log)),
+        ];
+        let mut startup = start(jobs);
+        let first = startup.wait_until(Instant::now() + Duration::from_millis(150));
+        assert_eq!(first.len(), 1);
+        assert_eq!(first[0].name, "quick");
+        assert_eq!(startup.pending(), 1);
+        assert!(startup.try_take().is_empty());
+        let rest = startup.wait_all();
+        assert_eq!(rest[0].name, "slow");
+    }
+
+    #[test]
+    fn a_merged_batch_is_collected_with_the_first() {
+        let log = Arc::new(Mutex::new(Vec::new()));
+        let mut startup = start(vec![slow("first", 200, Arc::clone(&log))]);
+        startup.merge(start(vec![slow("later", 1, Arc::clone(&log))]));
+        assert_eq!(startup.pending(), 2);
+        std::thread::sleep(Duration::from_millis(50));
+        // The first batch still running does not hold the later one back.
+        let quick = startup.try_take();
+        assert_eq!(quick.len(), 1);
+        assert_eq!(quick[0].name, "later");
+        let rest = startup.wait_until(Instant::now() + Duration::from_secs(5));
+        assert_eq!(rest[0].name, "first");
+        assert_eq!(startup.pending(), 0);
+    }
+}
@@ -2,10 +2,9 @@
 //! task; `record_entry` / `walk_back` / `walk_forward` drive the per-tab
 //! `Timeline` for undo/redo.
 
-use crate::app_state::{
-    AppRenderer, Coordinate, History, TEXT_CHUNK_IDLE_MS, TIMELINE_CAPACITY, Task,
-};
+use crate::app_state::{AppRenderer, Coordinate, History, TEXT_CHUNK_IDLE_MS, Task, Timeline};
 use crate::list;
+use crate::timeline_store;
 use sicompass_sdk::ffon::{FfonElement, FfonObject, IdArray, next_layer_exists};
 use sicompass_sdk::timeline::{StructuralOp, StructuralPayload, TimelineEntry};
 use std::time::Instant;
@@ -423,6 +422,7 @@ pub fn record_entry(r: &mut AppRenderer, entry: TimelineEntry) {
         // entry remains the next redo target.
         return;
     }
+    let provider = r.journal_provider(&entry);
     let tl = r.active_timeline_mut();
 
     // Truncate the redo branch on a new action. The truncation itself implies
@@ -430,8 +430,7 @@ pub fn record_entry(r: &mut AppRenderer, entry: TimelineEntry) {
     let mut just_branched = false;
     if tl.position > 0 {
         let new_count = tl.entries.len().saturating_sub(tl.position);
-        tl.entries.truncate(new_count);
-        tl.position = 0;
+        tl.truncate(new_count);
         just_branched = true;
     }
     // A walk_back / walk_forward without truncation (position landed on an
@@ -470,21 +469,24 @@ pub fn record_entry(r: &mut AppRenderer, entry: TimelineEntry) {
                     && tail_tp.as_ref() == to_path.as_ref()
             );
             if can_coalesce {
-                if let Some(TimelineEntry::Navigate {
-                    to_id: tail_to_id,
-                    to_path: tail_to_path,
-                    kind: tail_kind,
-                    ..
-                }) = tl.entries.last_mut()
-                {
-                    *tail_to_id = to_id.clone();
-                    *tail_to_path = to_path.clone();
-                    *tail_kind = *kind;
-                    // Any navigation breaks an in-flight text-chunk run.
-                    tl.last_text_id = None;
-                    tl.last_text_edit_at = None;
-                    return;
-                }
+                let tail = tl.entries.len() - 1;
+                tl.update(tail, provider.as_deref(), |e| {
+                    if let TimelineEntry::Navigate {
+                        to_id: tail_to_id,
+                        to_path: tail_to_path,
+                        kind: tail_kind,
+                        ..
+                    } = e
+                    {
+                        *tail_to_id = to_id.clone();
+                        *tail_to_path = to_path.clone();
+                        *tail_kind = *kind;
+                    }
+                });
+                // Any navigation breaks an in-flight text-chunk run.
+                tl.last_text_id = None;
+                tl.last_text_edit_at = None;
+                return;
             }
         }
     }
@@ -498,15 +500,18 @@ pub fn record_entry(r: &mut AppRenderer, entry: TimelineEntry) {
                     .last_text_edit_at
                     .map(|t| (now - t).as_millis() as u64 <= TEXT_CHUNK_IDLE_MS)
                     .unwrap_or(false);
-            if coalesce {
-                if let Some(TimelineEntry::TextChunk {
-                    after: tail_after, ..
-                }) = tl.entries.last_mut()
-                {
-                    *tail_after = after.clone();
-                    tl.last_text_edit_at = Some(now);
-                    return;
-                }
+            if coalesce && matches!(tl.entries.last(), Some(TimelineEntry::TextChunk { .. })) {
+                let tail = tl.entries.len() - 1;
+                tl.update(tail, provider.as_deref(), |e| {
+                    if let TimelineEntry::TextChunk {
+                        after: tail_after, ..
+                    } = e
+                    {
+                        *tail_after = after.clone();
+                    }
+                });
+                tl.last_text_edit_at = Some(now);
+                return;
             }
         }
     }
@@ -523,11 +528,6 @@ pub fn record_entry(r: &mut AppRenderer, entry: TimelineEntry) {
         }
     }
 
-    // Cap the timeline by dropping the oldest entry.
-    if tl.entries.len() >= TIMELINE_CAPACITY {
-        tl.entries.remove(0);
-    }
-
     // Assign a chunk_seq for TextChunk entries.
     let entry = match entry {
         TimelineEntry::TextChunk {
@@ -545,8 +545,30 @@ pub fn record_entry(r: &mut AppRenderer, entry: TimelineEntry) {
         other => other,
     };
 
-    tl.entries.push(entry);
-    tl.position = 0;
+    tl.push(entry, provider.as_deref());
+
+    enforce_timeline_budget(&mut r.tab_timelines);
+}
+
+/// Drop the oldest entries, from whichever tab recorded them first, until
+/// all timelines together fit [`timeline_store::TIMELINE_BUDGET_BYTES`]. The
+/// entry just recorded is always kept.
+fn enforce_timeline_budget(timelines: &mut [Timeline]) {
+    while timeline_store::over_budget() {
+        // Past one entry in all, the oldest is never the one just recorded.
+        if timelines.iter().map(|tl| tl.entries.len()).sum::<usize>() <= 1 {
+            return;
+        }
+        let Some((_, oldest)) = timelines
+            .iter()
+            .enumerate()
+            .filter_map(|(i, tl)| Some((tl.entries.oldest_seq()?, i)))
+            .min()
+        else {
+            return;
+        };
+        timelines[oldest].evict_oldest();
+    }
 }
 
 /// Apply one undo step to the active tab's timeline.
@@ -564,10 +586,14 @@ pub fn walk_back(r: &mut AppRenderer) {
 
     let entry = {
         let tl = r.active_timeline_mut();
-        tl.position += 1;
+        let idx = tl.entries.len() - tl.position - 1;
+        let Some(entry) = tl.entries.load(idx) else {
+            r.error_message = "Undo history is no longer readable".to_owned();
+            return;
+        };
+        tl.set_position(tl.position + 1);
         tl.coalesce_break = true;
-        let idx = tl.entries.len() - tl.position;
-        tl.entries[idx].clone()
+        entry
     };
 
     r.in_history_action = true;
@@ -605,9 +631,13 @@ pub fn walk_forward(r: &mut AppRenderer) {
     let entry = {
         let tl = r.active_timeline_mut();
         let idx = tl.entries.len() - tl.position;
-        tl.position -= 1;
+        let Some(entry) = tl.entries.load(idx) else {
+            r.error_message = "Redo history is no longer readable".to_owned();
+            return;
+        };
+        tl.set_position(tl.position - 1);
         tl.coalesce_break = true;
-        tl.entries[idx].clone()
+        entry
     };
 
     r.in_history_action = true;
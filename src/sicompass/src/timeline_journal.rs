@@ -0,0 +1,1285 @@
+//! Keeps each tab's undo timeline on disk across restarts.
+//!
+//! [`Timeline`] lives in memory. Without this module, a crash or an ordinary
+//! quit took every undoable delete, rename and text edit with it. Each tab now
+//! has an append-only journal under `state_home()/sicompass/timeline/`, named
+//! by a key that is saved with the tab in settings.json:
+//!
+//! - **Records as they happen.** `state::record_entry` and the undo walk
+//!   append one record per change to the timeline: an entry pushed, an
+//!   entry rewritten in place, the newest entries dropped, the oldest entry
+//!   evicted, the position moved. Every change goes through the `Timeline`
+//!   methods that make it, so the journal cannot miss one. Each record is
+//!   written straight to the file. A crash of the process loses nothing the
+//!   OS already has. A power loss can lose the records since the last
+//!   compaction, which syncs.
+//! - **Torn-write tolerant.** Every record is `[len u32][crc32 u32][payload]`.
+//!   Replay stops at the first record that is short, fails its checksum or
+//!   does not decode. Everything before it is the timeline as it was
+//!   committed. The tail is cut off when the journal is reopened.
+//! - **Compacted in the background.** Once a journal holds twice as many
+//!   records as its last compaction left, a worker thread folds it into one
+//!   `push` per live entry. The folded file is written to a sibling file,
+//!   synced, and renamed over the journal, so a crash leaves the old file or
+//!   the new one and never half of either. Records appended meanwhile are
+//!   carried over.
+//!
+//! Only entries that are meaningful in a new process are journaled:
+//! `TextChunk`, `Structural` and `FsOp`. A trashed file or directory is
+//! journaled as `RenameOnly` of its original path. Undo then restores it from
+//! the OS trash; the in-memory content snapshot is not written out. Navigation
+//! and provider ops (IMAP, chat, settings toggles) are recorded as opaque
+//! placeholders, so record positions still line up, and are dropped on
+//! restore.
+//!
+//! Entries address their provider by index, and the indices shift when a
+//! program is enabled or disabled between runs. Each entry is journaled with
+//! its provider's name and moved to that provider's new index on restore; an
+//! entry whose provider is gone is dropped. Only one instance journals in a
+//! directory at a time ([`claim_dir`]); another one keeps its timelines in
+//! memory and leaves the journals alone.
+
+use crate::app_state::Timeline;
+use sicompass_sdk::ffon::{self, FfonElement, IdArray};
+use sicompass_sdk::timeline::{
+    FsOpKind, FsSideEffect, StructuralOp, StructuralPayload, TimelineEntry,
+};
+use std::collections::VecDeque;
+use std::fs::{File, OpenOptions};
+use std::io::{self, Read, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex, MutexGuard};
+
+/// First bytes of every journal. A file without them is not replayed.
+const MAGIC: &[u8; 8] = b"sctlj02\n";
+
+const JOURNAL_SUFFIX: &str = ".journal";
+const REPLACEMENT_SUFFIX: &str = ".journal.tmp";
+
+/// A record longer than this is taken for a corrupt length field.
+const MAX_RECORD_BYTES: usize = 1 << 30;
+
+/// Records a journal may hold before it is first compacted.
+const COMPACT_MIN_RECORDS: usize = 4096;
+
+/// Where the journals live.
+pub fn default_dir() -> Option<PathBuf> {
+    sicompass_sdk::platform::state_home().map(|s| s.join("sicompass").join("timeline"))
+}
+
+// ---------------------------------------------------------------------------
+// Records
+// ---------------------------------------------------------------------------
+
+/// One change to a timeline. Entries are carried in their encoded form.
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Op<'a> {
+    Push(&'a [u8]),
+    /// The entry at this index was rewritten in place.
+    Replace(usize, &'a [u8]),
+    /// Keep the oldest `n` entries and return to HEAD.
+    Truncate(usize),
+    PopFront,
+    Position(usize),
+}
+
+const OP_PUSH: u8 = 1;
+const OP_REPLACE: u8 = 2;
+const OP_TRUNCATE: u8 = 3;
+const OP_POP_FRONT: u8 = 4;
+const OP_POSITION: u8 = 5;
+
+impl<'a> Op<'a> {
+    fn encode(&self) -> Vec<u8> {
+        let mut out = Vec::new();
+        match *self {
+            Op::Push(entry) => {
+                out.push(OP_PUSH);
+                out.extend_from_slice(entry);
+            }
+            Op::Replace(index, entry) => {
+                out.push(OP_REPLACE);
+                put_u64(&mut out, index as u64);
+                out.extend_from_slice(entry);
+            }
+            Op::Truncate(n) => {
+                out.push(OP_TRUNCATE);
+                put_u64(&mut out, n as u64);
+            }
+            Op::PopFront => out.push(OP_POP_FRONT),
+            Op::Position(p) => {
+                out.push(OP_POSITION);
+                put_u64(&mut out, p as u64);
+            }
+        }
+        out
+    }
+
+    fn decode(payload: &'a [u8]) -> Option<Self> {
+        let (&tag, rest) = payload.split_first()?;
+        let count = || -> Option<usize> {
+            let mut r = Reader(rest);
+            let n = r.u64()?;
+            r.0.is_empty().then_some(usize::try_from(n).ok()?)
+        };
+        Some(match tag {
+            OP_PUSH => Op::Push(rest),
+            OP_REPLACE => {
+                let mut r = Reader(rest);
+                Op::Replace(r.usize()?, r.0)
+            }
+            OP_TRUNCATE => Op::Truncate(count()?),
+            OP_POP_FRONT if rest.is_empty() => Op::PopFront,
+            OP_POSITION => Op::Position(count()?),
+            _ => return None,
+        })
+    }
+}
+
+/// `payload` framed with its length and checksum.
+fn frame(payload: &[u8]) -> Vec<u8> {
+    let mut crc = flate2::Crc::new();
+    crc.update(payload);
+    let mut out = Vec::with_capacity(8 + payload.len());
+    out.extend_from_slice(&(payload.len() as u32).to_le_bytes());
+    out.extend_from_slice(&crc.sum().to_le_bytes());
+    out.extend_from_slice(payload);
+    out
+}
+
+/// The payload of the record at `at`, and where the next one starts. `None`
+/// past the end and for a torn or corrupt record.
+fn read_record(data: &[u8], at: usize) -> Option<(&[u8], usize)> {
+    let header = data.get(at..at.checked_add(8)?)?;
+    let len = u32::from_le_bytes(header[..4].try_into().ok()?) as usize;
+    let sum = u32::from_le_bytes(header[4..].try_into().ok()?);
+    if len > MAX_RECORD_BYTES {
+        return None;
+    }
+    let end = at + 8 + len;
+    let payload = data.get(at + 8..end)?;
+    let mut crc = flate2::Crc::new();
+    crc.update(payload);
+    (crc.sum() == sum).then_some((payload, end))
+}
+
+/// A journal replayed: the timeline it describes, entries still encoded.
+#[derive(Debug, Default)]
+struct Folded {
+    entries: VecDeque<Vec<u8>>,
+    position: usize,
+    records: usize,
+    /// Where the last good record ends.
+    end: usize,
+}
+
+impl Folded {
+    fn apply(&mut self, op: Op) {
+        match op {
+            Op::Push(entry) => {
+                self.entries.push_back(entry.to_vec());
+                self.position = 0;
+            }
+            Op::Replace(index, entry) => {
+                if let Some(slot) = self.entries.get_mut(index) {
+                    *slot = entry.to_vec();
+                }
+            }
+            Op::Truncate(n) => {
+                self.entries.truncate(n);
+                self.position = 0;
+            }
+            Op::PopFront => {
+                self.entries.pop_front();
+                self.position = self.position.min(self.entries.len());
+            }
+            Op::Position(p) => self.position = p.min(self.entries.len()),
+        }
+    }
+}
+
+/// Replay `data` up to the first record that is not whole and valid.
+fn fold(data: &[u8]) -> Folded {
+    let mut folded = Folded::default();
+    if !data.starts_with(MAGIC) {
+        return folded;
+    }
+    let mut at = MAGIC.len();
+    folded.end = at;
+    while let Some((payload, next)) = read_record(data, at) {
+        let Some(op) = Op::decode(payload) else {
+            break;
+        };
+        folded.apply(op);
+        folded.records += 1;
+        at = next;
+        folded.end = at;
+    }
+    folded
+}
+
+/// A journal holding just `entries` at `position`, and its record count.
+fn snapshot<'a>(entries: impl IntoIterator<Item = &'a [u8]>, position: usize) -> (Vec<u8>, usize) {
+    let mut out = MAGIC.to_vec();
+    let mut records = 0;
+    for entry in entries {
+        out.extend_from_slice(&frame(&Op::Push(entry).encode()));
+        records += 1;
+    }
+    if position > 0 {
+        out.extend_from_slice(&frame(&Op::Position(position).encode()));
+        records += 1;
+    }
+    (out, records)
+}
+
+/// Replace the file at `path` with `data` in one step, and open it for
+/// appending.
+fn write_replacement(path: &Path, data: &[u8]) -> io::Result<File> {
+    let mut name = path.file_name().unwrap_or_default().to_owned();
+    name.push(".tmp");
+    let tmp = path.with_file_name(name);
+    {
+        let mut file = File::create(&tmp)?;
+        file.write_all(data)?;
+        file.sync_all()?;
+    }
+    std::fs::rename(&tmp, path)?;
+    OpenOptions::new().append(true).open(path)
+}
+
+// ---------------------------------------------------------------------------
+// Entries
+// ---------------------------------------------------------------------------
+
+/// Leading byte of an encoded entry.
+const ENTRY_OPAQUE: u8 = 0;
+const ENTRY_TEXT: u8 = 1;
+const ENTRY_STRUCTURAL: u8 = 2;
+const ENTRY_FS: u8 = 3;
+
+fn put_u64(out: &mut Vec<u8>, n: u64) {
+    out.extend_from_slice(&n.to_le_bytes());
+}
+
+fn put_bytes(out: &mut Vec<u8>, bytes: &[u8]) {
+    put_u64(out, bytes.len() as u64);
+    out.extend_from_slice(bytes);
+}
+
+fn put_id(out: &mut Vec<u8>, id: &IdArray) {
+    put_u64(out, id.depth() as u64);
+    for &n in id.as_slice() {
+        put_u64(out, n as u64);
+    }
+}
+
+fn put_elem(out: &mut Vec<u8>, elem: &FfonElement) {
+    put_bytes(out, &ffon::serialize_binary(std::slice::from_ref(elem)));
+}
+
+fn put_opt_elem(out: &mut Vec<u8>, elem: Option<&FfonElement>) {
+    match elem {
+        Some(elem) => {
+            out.push(1);
+            put_elem(out, elem);
+        }
+        None => out.push(0),
+    }
+}
+
+fn put_path(out: &mut Vec<u8>, path: &Path) {
+    put_bytes(out, path.to_string_lossy().as_bytes());
+}
+
+struct Reader<'a>(&'a [u8]);
+
+impl<'a> Reader<'a> {
+    fn take(&mut self, n: usize) -> Option<&'a [u8]> {
+        if n > self.0.len() {
+            return None;
+        }
+        let (head, rest) = self.0.split_at(n);
+        self.0 = rest;
+        Some(head)
+    }
+
+    fn u8(&mut self) -> Option<u8> {
+        Some(self.take(1)?[0])
+    }
+
+    fn u64(&mut self) -> Option<u64> {
+        Some(u64::from_le_bytes(self.take(8)?.try_into().ok()?))
+    }
+
+    fn usize(&mut self) -> Option<usize> {
+        usize::try_from(self.u64()?).ok()
+    }
+
+    fn bytes(&mut self) -> Option<&'a [u8]> {
+        let len = self.usize()?;
+        self.take(len)
+    }
+
+    fn id(&mut self) -> Option<IdArray> {
+        let depth = self.usize()?;
+        let mut id = IdArray::new();
+        for _ in 0..depth {
+            id.push(self.usize()?);
+        }
+        Some(id)
+    }
+
+    fn elem(&mut self) -> Option<FfonElement> {
+        let mut elems = ffon::deserialize_binary(self.bytes()?).into_iter();
+        let elem = elems.next()?;
+        elems.next().is_none().then_some(elem)
+    }
+
+    fn opt_elem(&mut self) -> Option<Option<FfonElement>> {
+        match self.u8()? {
+            0 => Some(None),
+            1 => Some(Some(self.elem()?)),
+            _ => None,
+        }
+    }
+
+    fn path(&mut self) -> Option<PathBuf> {
+        Some(PathBuf::from(std::str::from_utf8(self.bytes()?).ok()?))
+    }
+}
+
+fn structural_op_code(op: &StructuralOp) -> Option<u8> {
+    Some(match op {
+        StructuralOp::Append => 0,
+        StructuralOp::Insert => 1,
+        StructuralOp::Delete => 2,
+        StructuralOp::Cut => 3,
+        StructuralOp::Paste => 4,
+        StructuralOp::Replace => 5,
+        #[allow(unreachable_patterns)]
+        _ => return None,
+    })
+}
+
+fn structural_op(code: u8) -> Option<StructuralOp> {
+    Some(match code {
+        0 => StructuralOp::Append,
+        1 => StructuralOp::Insert,
+        2 => StructuralOp::Delete,
+        3 => StructuralOp::Cut,
+        4 => StructuralOp::Paste,
+        5 => StructuralOp::Replace,
+        _ => return None,
+    })
+}
+
+fn fs_op_code(op: FsOpKind) -> u8 {
+    match op {
+        FsOpKind::Create => 0,
+        FsOpKind::Rename => 1,
+        FsOpKind::Delete => 2,
+        FsOpKind::Move => 3,
+        FsOpKind::Paste => 4,
+    }
+}
+
+fn fs_op(code: u8) -> Option<FsOpKind> {
+    Some(match code {
+        0 => FsOpKind::Create,
+        1 => FsOpKind::Rename,
+        2 => FsOpKind::Delete,
+        3 => FsOpKind::Move,
+        4 => FsOpKind::Paste,
+        _ => return None,
+    })
+}
+
+/// Whether `entry` is journaled in full rather than as an opaque placeholder.
+pub fn journaled(entry: &TimelineEntry) -> bool {
+    matches!(
+        entry,
+        TimelineEntry::TextChunk { .. }
+            | TimelineEntry::Structural { .. }
+            | TimelineEntry::FsOp { .. }
+    )
+}
+
+/// The index of the provider `entry` acts on, among the root-level providers.
+///
+/// Indices follow the canonical provider order, which changes when a program
+/// is enabled or disabled between runs. So entries are journaled with the
+/// provider's name, and restored only onto a provider of that name.
+pub fn provider_index(entry: &TimelineEntry) -> Option<usize> {
+    match entry {
+        TimelineEntry::TextChunk { id, .. } | TimelineEntry::Structural { id, .. } => id.get(0),
+        TimelineEntry::FsOp { provider_idx, .. } => Some(*provider_idx),
+        _ => None,
+    }
+}
+
+/// `entry` as journaled, owned by the provider named `provider`. See the
+/// module docs for what is kept of each kind.
+fn encode_entry(entry: &TimelineEntry, provider: Option<&str>) -> Vec<u8> {
+    let mut out = Vec::new();
+    if write_entry(&mut out, entry, provider).is_none() {
+        out.clear();
+        out.push(ENTRY_OPAQUE);
+    }
+    out
+}
+
+fn write_entry(out: &mut Vec<u8>, entry: &TimelineEntry, provider: Option<&str>) -> Option<()> {
+    let tag = match entry {
+        TimelineEntry::TextChunk { .. } => ENTRY_TEXT,
+        TimelineEntry::Structural { .. } => ENTRY_STRUCTURAL,
+        TimelineEntry::FsOp { .. } => ENTRY_FS,
+        _ => return None,
+    };
+    out.push(tag);
+    match provider {
+        Some(name) => {
+            out.push(1);
+            put_bytes(out, name.as_bytes());
+        }
+        None => out.push(0),
+    }
+    match entry {
+        TimelineEntry::TextChunk {
+            id,
+            before,
+            after,
+            chunk_seq,
+        } => {
+            put_id(out, id);
+            put_elem(out, before);
+            put_elem(out, after);
+            put_u64(out, u64::from(*chunk_seq));
+        }
+        TimelineEntry::Structural { id, op, payload } => {
+            put_id(out, id);
+            out.push(structural_op_code(op)?);
+            match payload {
+                StructuralPayload::Inserted(e) => {
+                    out.push(0);
+                    put_elem(out, e);
+                }
+                StructuralPayload::Removed(e) => {
+                    out.push(1);
+                    put_elem(out, e);
+                }
+                StructuralPayload::Pasted { before, after } => {
+                    out.push(2);
+                    put_elem(out, before);
+                    put_elem(out, after);
+                }
+                StructuralPayload::Replaced { before, after } => {
+                    out.push(3);
+                    put_elem(out, before);
+                    put_elem(out, after);
+                }
+                #[allow(unreachable_patterns)]
+                _ => return None,
+            }
+        }
+        TimelineEntry::FsOp {
+            provider_idx,
+            id,
+            op,
+            before,
+            after,
+            side_effect,
+        } => {
+            put_u64(out, *provider_idx as u64);
+            put_id(out, id);
+            out.push(fs_op_code(*op));
+            put_opt_elem(out, before.as_ref());
+            put_opt_elem(out, after.as_ref());
+            match side_effect {
+                FsSideEffect::None => out.push(0),
+                FsSideEffect::RenameOnly { from, to } => {
+                    out.push(1);
+                    put_path(out, from);
+                    put_path(out, to);
+                }
+                FsSideEffect::TrashedFile { original_path, .. }
+                | FsSideEffect::TrashedDir { original_path, .. } => {
+                    out.push(1);
+                    put_path(out, original_path);
+                    put_path(out, original_path);
+                }
+            }
+        }
+        _ => return None,
+    }
+    Some(())
+}
+
+/// The entry `data` encodes, and the name of its provider. `None` for an
+/// opaque placeholder.
+fn decode_entry(data: &[u8]) -> Option<(TimelineEntry, Option<String>)> {
+    let mut r = Reader(data);
+    let tag = r.u8()?;
+    let provider = match r.u8()? {
+        0 => None,
+        1 => Some(std::str::from_utf8(r.bytes()?).ok()?.to_owned()),
+        _ => return None,
+    };
+    let entry = match tag {
+        ENTRY_TEXT => TimelineEntry::TextChunk {
+            id: r.id()?,
+            before: r.elem()?,
+            after: r.elem()?,
+            chunk_seq: u32::try_from(r.u64()?).ok()?,
+        },
+        ENTRY_STRUCTURAL => {
+            let id = r.id()?;
+            let op = structural_op(r.u8()?)?;
+            let payload = match r.u8()? {
+                0 => StructuralPayload::Inserted(r.elem()?),
+                1 => StructuralPayload::Removed(r.elem()?),
+                2 => StructuralPayload::Pasted {
+                    before: r.elem()?,
+                    after: r.elem()?,
+                },
+                3 => StructuralPayload::Replaced {
+                    before: r.elem()?,
+                    after: r.elem()?,
+                },
+                _ => return None,
+            };
+            TimelineEntry::Structural { id, op, payload }
+        }
+        ENTRY_FS => TimelineEntry::FsOp {
+            provider_idx: r.usize()?,
+            id: r.id()?,
+            op: fs_op(r.u8()?)?,
+            before: r.opt_elem()?,
+            after: r.opt_elem()?,
+            side_effect: match r.u8()? {
+                0 => FsSideEffect::None,
+                1 => FsSideEffect::RenameOnly {
+                    from: r.path()?,
+                    to: r.path()?,
+                },
+                _ => return None,
+            },
+        },
+        _ => return None,
+    };
+    r.0.is_empty().then_some((entry, provider))
+}
+
+/// `id` with its root index replaced by `root`.
+fn with_root(id: &IdArray, root: usize) -> IdArray {
+    let mut out = IdArray::new();
+    out.push(root);
+    for &n in id.as_slice().iter().skip(1) {
+        out.push(n);
+    }
+    out
+}
+
+/// Point `entry` at where its provider now sits among `providers`. `None`
+/// when no provider of that name is loaded any more.
+fn remap(
+    mut entry: TimelineEntry,
+    provider: Option<&str>,
+    providers: &[&str],
+) -> Option<TimelineEntry> {
+    let Some(name) = provider else {
+        return Some(entry);
+    };
+    let old = provider_index(&entry)?;
+    let new = providers.iter().position(|p| *p == name)?;
+    if old != new {
+        match &mut entry {
+            TimelineEntry::TextChunk { id, .. } | TimelineEntry::Structural { id, .. } => {
+                *id = with_root(id, new);
+            }
+            TimelineEntry::FsOp {
+                provider_idx, id, ..
+            } => {
+                *provider_idx = new;
+                if id.get(0) == Some(old) {
+                    *id = with_root(id, new);
+                }
+            }
+            _ => {}
+        }
+    }
+    Some(entry)
+}
+
+// ---------------------------------------------------------------------------
+// Journal
+// ---------------------------------------------------------------------------
+
+#[derive(Debug)]
+struct Writer {
+    /// `None` once the journal is discarded or could not be repaired.
+    file: Option<File>,
+    len: u64,
+    records: usize,
+    /// Record count at which the next compaction starts.
+    compact_at: usize,
+}
+
+#[derive(Debug)]
+struct Shared {
+    path: PathBuf,
+    writer: Mutex<Writer>,
+    compacting: AtomicBool,
+}
+
+impl Shared {
+    fn writer(&self) -> MutexGuard<'_, Writer> {
+        self.writer.lock().unwrap_or_else(|e| e.into_inner())
+    }
+}
+
+/// The timeline as a journal held it when it was opened.
+#[derive(Debug, Default)]
+pub struct Restored {
+    pub entries: Vec<TimelineEntry>,
+    pub position: usize,
+}
+
+/// One tab's journal. Writes never fail the caller: an I/O error is logged,
+/// and the timeline goes on in memory.
+#[derive(Debug, Clone)]
+pub struct Journal {
+    key: String,
+    shared: Arc<Shared>,
+}
+
+impl Journal {
+    /// Open the journal `key` in `dir`, creating it if there is none, and
+    /// replay it onto `providers`, the names of the root-level providers in
+    /// order. The journal is rewritten to hold just what was restored, so a
+    /// torn tail and the entries that cannot be restored are gone from it.
+    pub fn open(dir: &Path, key: &str, providers: &[&str]) -> io::Result<(Journal, Restored)> {
+        std::fs::create_dir_all(dir)?;
+        let path = dir.join(format!("{key}{JOURNAL_SUFFIX}"));
+        let data = match std::fs::read(&path) {
+            Ok(data) => data,
+            Err(e) if e.kind() == io::ErrorKind::NotFound => Vec::new(),
+            Err(e) => return Err(e),
+        };
+        let folded = fold(&data);
+
+        let redo_from = folded.entries.len() - folded.position;
+        let mut kept = Vec::new();
+        let mut restored = Restored::default();
+        for (i, raw) in folded.entries.into_iter().enumerate() {
+            let Some((entry, provider)) = decode_entry(&raw) else {
+                continue;
+            };
+            let Some(entry) = remap(entry, provider.as_deref(), providers) else {
+                continue;
+            };
+            if i >= redo_from {
+                restored.position += 1;
+            }
+            kept.push(encode_entry(&entry, provider.as_deref()));
+            restored.entries.push(entry);
+        }
+
+        let (bytes, records) = snapshot(kept.iter().map(Vec::as_slice), restored.position);
+        let file = write_replacement(&path, &bytes)?;
+        let journal = Journal {
+            key: key.to_owned(),
+            shared: Arc::new(Shared {
+                path,
+                writer: Mutex::new(Writer {
+                    file: Some(file),
+                    len: bytes.len() as u64,
+                    records,
+                    compact_at: (2 * records).max(COMPACT_MIN_RECORDS),
+                }),
+                compacting: AtomicBool::new(false),
+            }),
+        };
+        Ok((journal, restored))
+    }
+
+    /// The name this journal is saved under with its tab.
+    pub fn key(&self) -> &str {
+        &self.key
+    }
+
+    /// `provider` names the provider at [`provider_index`] of `entry`.
+    pub fn push(&self, entry: &TimelineEntry, provider: Option<&str>) {
+        self.append(Op::Push(&encode_entry(entry, provider)));
+    }
+
+    /// The entry at `index` was rewritten in place, into `entry`.
+    pub fn replace(&self, index: usize, entry: &TimelineEntry, provider: Option<&str>) {
+        self.append(Op::Replace(index, &encode_entry(entry, provider)));
+    }
+
+    /// Entries past the oldest `len` were dropped, and the timeline is at
+    /// HEAD.
+    pub fn truncate(&self, len: usize) {
+        self.append(Op::Truncate(len));
+    }
+
+    pub fn pop_front(&self) {
+        self.append(Op::PopFront);
+    }
+
+    pub fn set_position(&self, position: usize) {
+        self.append(Op::Position(position));
+    }
+
+    /// Stop journaling and delete the file: the tab is closed.
+    pub fn discard(&self) {
+        let mut writer = self.shared.writer();
+        writer.file = None;
+        if let Err(e) = std::fs::remove_file(&self.shared.path)
+            && e.kind() != io::ErrorKind::NotFound
+        {
+            tracing::warn!("undo journal {}: {e}", self.shared.path.display());
+        }
+    }
+
+    fn append(&self, op: Op) {
+        let record = frame(&op.encode());
+        let compact = {
+            let mut guard = self.shared.writer();
+            let writer = &mut *guard;
+            let Some(file) = writer.file.as_mut() else {
+                return;
+            };
+            if let Err(e) = file.write_all(&record) {
+                tracing::warn!("undo journal {}: {e}", self.shared.path.display());
+                // Cut off what part of the record got written, so the records
+                // after it are still reached on replay.
+                if file.set_len(writer.len).is_err() {
+                    writer.file = None;
+                }
+                return;
+            }
+            writer.len += record.len() as u64;
+            writer.records += 1;
+            if writer.records >= writer.compact_at {
+                // Not again before it has doubled, whether this one succeeds
+                // or not.
+                writer.compact_at = 2 * writer.records;
+                true
+            } else {
+                false
+            }
+        };
+        if compact {
+            self.compact_in_background();
+        }
+    }
+
+    fn compact_in_background(&self) {
+        if self.shared.compacting.swap(true, Ordering::AcqRel) {
+            return;
+        }
+        let shared = Arc::clone(&self.shared);
+        let spawned = std::thread::Builder::new()
+            .name("timeline-journal".into())
+            .spawn(move || {
+                if let Err(e) = compact(&shared) {
+                    tracing::warn!("undo journal {}: {e}", shared.path.display());
+                }
+                shared.compacting.store(false, Ordering::Release);
+            });
+        if spawned.is_err() {
+            self.shared.compacting.store(false, Ordering::Release);
+        }
+    }
+}
+
+/// Fold the journal into one record per live entry. Only the rewrite itself
+/// holds the writer lock; the replay runs while records are still appended.
+fn compact(shared: &Shared) -> io::Result<()> {
+    let (upto, records_then) = {
+        let writer = shared.writer();
+        if writer.file.is_none() {
+            return Ok(());
+        }
+        (writer.len, writer.records)
+    };
+    let mut data = Vec::new();
+    File::open(&shared.path)?
+        .take(upto)
+        .read_to_end(&mut data)?;
+    let folded = fold(&data);
+    if folded.end as u64 != upto || folded.records != records_then {
+        return Err(io::Error::new(
+            io::ErrorKind::InvalidData,
+            "journal changed under compaction",
+        ));
+    }
+    let (mut bytes, records) = snapshot(folded.entries.iter().map(Vec::as_slice), folded.position);
+
+    let mut guard = shared.writer();
+    let writer = &mut *guard;
+    if writer.file.is_none() {
+        return Ok(());
+    }
+    // Carry over what was appended while the replay ran.
+    let mut file = File::open(&shared.path)?;
+    file.seek(SeekFrom::Start(upto))?;
+    file.take(writer.len - upto).read_to_end(&mut bytes)?;
+    let tail_records = writer.records - records_then;
+
+    writer.file = Some(write_replacement(&shared.path, &bytes)?);
+    writer.len = bytes.len() as u64;
+    writer.records = records + tail_records;
+    writer.compact_at = (2 * writer.records).max(COMPACT_MIN_RECORDS);
+    Ok(())
+}
+
+// ---------------------------------------------------------------------------
+// Tabs
+// ---------------------------------------------------------------------------
+
+/// Whether `key`, read back from settings.json, can name a journal file.
+fn valid_key(key: &str) -> bool {
+    (1..=32).contains(&key.len()) && key.bytes().all(|b| b.is_ascii_hexdigit())
+}
+
+/// A key no journal in `dir` has yet.
+fn new_key(dir: &Path) -> String {
+    use std::hash::BuildHasher;
+    let nanos = std::time::SystemTime::now()
+        .duration_since(std::time::UNIX_EPOCH)
+        .map_or(0, |d| d.as_nanos());
+    let mut salt = 0u32;
+    loop {
+        let key = format!(
+            "{:016x}",
+            std::collections::hash_map::RandomState::new().hash_one((nanos, salt))
+        );
+        if !dir.join(format!("{key}{JOURNAL_SUFFIX}")).exists() {
+            return key;
+        }
+        salt += 1;
+    }
+}
+
+/// A tab's timeline, restored from its journal `key` in `dir` onto
+/// `providers`, or starting a new journal when there is no key. With no `dir`
+/// (tests, or no state directory) the timeline is kept in memory only.
+pub fn open_timeline(dir: Option<&Path>, key: Option<&str>, providers: &[&str]) -> Timeline {
+    let mut timeline = Timeline::new();
+    let Some(dir) = dir else {
+        return timeline;
+    };
+    let key = match key.filter(|k| valid_key(k)) {
+        Some(key) => key.to_owned(),
+        None => new_key(dir),
+    };
+    match Journal::open(dir, &key, providers) {
+        Ok((journal, restored)) => {
+            timeline.next_chunk_seq = restored
+                .entries
+                .iter()
+                .filter_map(|e| match e {
+                    TimelineEntry::TextChunk { chunk_seq, .. } => Some(chunk_seq.wrapping_add(1)),
+                    _ => None,
+                })
+                .max()
+                .unwrap_or(0);
+            for entry in restored.entries {
+                timeline.entries.push(entry);
+            }
+            timeline.position = restored.position;
+            timeline.journal = Some(journal);
+        }
+        Err(e) => tracing::warn!("undo journal {key}: {e}"),
+    }
+    timeline
+}
+
+/// Delete the journals in `dir` that none of `keep` names: tabs closed while
+/// the settings could not be saved, and replacements a crash left behind.
+pub fn remove_orphans(dir: &Path, keep: &[&str]) {
+    let Ok(read) = std::fs::read_dir(dir) else {
+        return;
+    };
+    for dirent in read.flatten() {
+        let name = dirent.file_name();
+        let Some(name) = name.to_str() else {
+            continue;
+        };
+        let orphan = match name.strip_suffix(JOURNAL_SUFFIX) {
+            Some(key) => !keep.contains(&key),
+            None => name.ends_with(REPLACEMENT_SUFFIX),
+        };
+        if orphan {
+            let _ = std::fs::remove_file(dirent.path());
+        }
+    }
+}
+
+/// The lock on `dir`, if no other process holds it. Dropping the file
+/// releases it.
+fn try_claim(dir: &Path) -> Option<File> {
+    std::fs::create_dir_all(dir).ok()?;
+    let file = OpenOptions::new()
+        .create(true)
+        .truncate(false)
+        .write(true)
+        .open(dir.join("lock"))
+        .ok()?;
+    file.try_lock().ok()?;
+    Some(file)
+}
+
+/// Claim `dir` for this process, for as long as it runs. `false` when
+/// another instance already journals there: its journals, and the ones its
+/// tabs are about to start, must be neither written nor swept by this one.
+pub fn claim_dir(dir: &Path) -> bool {
+    static CLAIMED: std::sync::OnceLock<Option<(PathBuf, File)>> = std::sync::OnceLock::new();
+    match CLAIMED.get_or_init(|| try_claim(dir).map(|f| (dir.to_path_buf(), f))) {
+        Some((claimed, _)) => claimed == dir,
+        None => false,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn id(path: &[usize]) -> IdArray {
+        let mut id = IdArray::new();
+        for &n in path {
+            id.push(n);
+        }
+        id
+    }
+
+    fn text(n: usize, after: &str) -> TimelineEntry {
+        TimelineEntry::TextChunk {
+            id: id(&[0, n]),
+            before: FfonElement::new_str("before"),
+            after: FfonElement::new_str(after),
+            chunk_seq: n as u32,
+        }
+    }
+
+    fn rename(from: &str, to: &str) -> TimelineEntry {
+        TimelineEntry::FsOp {
+            provider_idx: 1,
+            id: id(&[1, 2]),
+            op: FsOpKind::Rename,
+            before: Some(FfonElement::new_str(from)),
+            after: Some(FfonElement::new_str(to)),
+            side_effect: FsSideEffect::RenameOnly {
+                from: PathBuf::from(format!("/tmp/{from}")),
+                to: PathBuf::from(format!("/tmp/{to}")),
+            },
+        }
+    }
+
+    fn removed(key: &str) -> TimelineEntry {
+        let mut elem = FfonElement::new_obj(key);
+        elem.as_obj_mut()
+            .unwrap()
+            .push(FfonElement::new_str("child"));
+        TimelineEntry::Structural {
+            id: id(&[0, 3, 1]),
+            op: StructuralOp::Delete,
+            payload: StructuralPayload::Removed(elem),
+        }
+    }
+
+    fn navigate() -> TimelineEntry {
+        TimelineEntry::Navigate {
+            provider_idx: 0,
+            from_id: id(&[0, 0]),
+            to_id: id(&[0, 1]),
+            from_path: None,
+            to_path: None,
+            kind: sicompass_sdk::timeline::NavKind::ArrowDown,
+        }
+    }
+
+    fn debug(entries: &[TimelineEntry]) -> Vec<String> {
+        entries.iter().map(|e| format!("{e:?}")).collect()
+    }
+
+    fn journal_path(dir: &Path, key: &str) -> PathBuf {
+        dir.join(format!("{key}{JOURNAL_SUFFIX}"))
+    }
+
+    #[test]
+    fn every_journaled_kind_round_trips() {
+        for entry in [text(0, "after"), rename("a", "b"), removed("gone:")] {
+            for provider in [None, Some("file browser")] {
+                let (decoded, name) =
+                    decode_entry(&encode_entry(&entry, provider)).expect("decodes");
+                assert_eq!(format!("{decoded:?}"), format!("{entry:?}"));
+                assert_eq!(name.as_deref(), provider);
+            }
+        }
+        assert_eq!(
+            encode_entry(&navigate(), Some("web browser")),
+            [ENTRY_OPAQUE]
+        );
+        assert!(decode_entry(&[ENTRY_OPAQUE]).is_none());
+    }
+
+    #[test]
+    fn a_reopened_journal_restores_entries_and_position() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        assert!(restored.entries.is_empty());
+        journal.push(&text(0, "zero"), None);
+        journal.push(&rename("a", "b"), None);
+        journal.push(&removed("x:"), None);
+        journal.replace(2, &removed("y:"), None);
+        journal.replace(0, &text(0, "one"), None);
+        journal.set_position(1);
+        drop(journal);
+
+        let (_, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        assert_eq!(
+            debug(&restored.entries),
+            debug(&[text(0, "one"), rename("a", "b"), removed("y:")])
+        );
+        assert_eq!(restored.position, 1);
+    }
+
+    #[test]
+    fn entries_follow_their_provider_to_its_new_index() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, _) =
+            Journal::open(tmp.path(), "ab", &["file browser", "web browser"]).unwrap();
+        journal.push(&text(0, "files"), Some("file browser"));
+        journal.push(&rename("a", "b"), Some("web browser"));
+        journal.push(&removed("x:"), Some("file browser"));
+        journal.set_position(1);
+        drop(journal);
+
+        // A program enabled since sits in front of the file browser, and the
+        // web browser is gone.
+        let providers = ["tutorial", "file browser"];
+        let (_, restored) = Journal::open(tmp.path(), "ab", &providers).unwrap();
+        let expected = |e: TimelineEntry| remap(e, Some("file browser"), &providers).unwrap();
+        assert_eq!(
+            debug(&restored.entries),
+            debug(&[expected(text(0, "files")), expected(removed("x:"))])
+        );
+        assert!(matches!(
+            &restored.entries[0],
+            TimelineEntry::TextChunk { id, .. } if id.as_slice() == [1, 0]
+        ));
+        assert_eq!(restored.position, 1);
+
+        // The rewritten journal keeps the names, and the new indices.
+        let (_, again) = Journal::open(tmp.path(), "ab", &providers).unwrap();
+        assert_eq!(debug(&again.entries), debug(&restored.entries));
+    }
+
+    #[test]
+    fn a_renamed_fs_op_moves_its_provider_index_and_id() {
+        let moved = remap(rename("a", "b"), Some("files"), &["files"]).unwrap();
+        assert!(matches!(
+            &moved,
+            TimelineEntry::FsOp { provider_idx: 0, id, .. } if id.as_slice() == [0, 2]
+        ));
+        assert!(remap(rename("a", "b"), Some("files"), &["web"]).is_none());
+        assert!(remap(rename("a", "b"), None, &[]).is_some());
+    }
+
+    #[test]
+    fn truncation_and_eviction_replay_in_order() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, _) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        for n in 0..5 {
+            journal.push(&text(n, "t"), None);
+        }
+        journal.set_position(2);
+        // A new action on a walked-back timeline drops the redo branch.
+        journal.truncate(3);
+        journal.push(&text(9, "t"), None);
+        journal.pop_front();
+        drop(journal);
+
+        let (_, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        assert_eq!(
+            debug(&restored.entries),
+            debug(&[text(1, "t"), text(2, "t"), text(9, "t")])
+        );
+        assert_eq!(restored.position, 0);
+    }
+
+    #[test]
+    fn opaque_entries_are_dropped_and_the_position_follows() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, _) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        journal.push(&text(0, "t"), None);
+        journal.push(&navigate(), None);
+        journal.push(&text(1, "t"), None);
+        journal.push(&navigate(), None);
+        // Walked back over both navigations and the second edit.
+        journal.set_position(3);
+        drop(journal);
+
+        let (journal, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        assert_eq!(
+            debug(&restored.entries),
+            debug(&[text(0, "t"), text(1, "t")])
+        );
+        assert_eq!(restored.position, 1);
+
+        // The rewritten journal counts what was restored, so relative records
+        // still land on the right entries.
+        journal.truncate(1);
+        drop(journal);
+        let (_, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        assert_eq!(debug(&restored.entries), debug(&[text(0, "t")]));
+    }
+
+    /// A writer killed partway through an append leaves some prefix of the
+    /// record on disk. Whatever that prefix is, replay must come back with
+    /// the timeline as it was before the append, and the journal must go on
+    /// taking appends afterwards.
+    #[test]
+    fn a_writer_killed_mid_append_replays_to_the_last_whole_record() {
+        let committed = [text(0, "one"), rename("a", "b")];
+        let torn = frame(&Op::Push(&encode_entry(&removed("torn:"), None)).encode());
+
+        for cut in 0..torn.len() {
+            let tmp = tempfile::tempdir().unwrap();
+            let (journal, _) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+            for entry in &committed {
+                journal.push(entry, None);
+            }
+            drop(journal);
+            let path = journal_path(tmp.path(), "ab");
+            let intact = std::fs::metadata(&path).unwrap().len();
+            OpenOptions::new()
+                .append(true)
+                .open(&path)
+                .unwrap()
+                .write_all(&torn[..cut])
+                .unwrap();
+
+            let (journal, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+            assert_eq!(debug(&restored.entries), debug(&committed), "cut at {cut}");
+            assert_eq!(std::fs::metadata(&path).unwrap().len(), intact);
+
+            journal.push(&text(7, "after the crash"), None);
+            drop(journal);
+            let (_, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+            assert_eq!(restored.entries.len(), 3, "cut at {cut}");
+        }
+    }
+
+    #[test]
+    fn a_corrupt_record_ends_the_replay() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, _) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        journal.push(&text(0, "kept"), None);
+        journal.push(&text(1, "flipped"), None);
+        journal.push(&text(2, "after"), None);
+        drop(journal);
+
+        let path = journal_path(tmp.path(), "ab");
+        let mut data = std::fs::read(&path).unwrap();
+        let second = read_record(&data, MAGIC.len()).unwrap().1;
+        data[second + 12] ^= 0x40;
+        std::fs::write(&path, &data).unwrap();
+
+        let (_, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        assert_eq!(debug(&restored.entries), debug(&[text(0, "kept")]));
+    }
+
+    #[test]
+    fn compaction_keeps_the_timeline_and_later_appends() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, _) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        for n in 0..50 {
+            journal.push(&text(n, "t"), None);
+            journal.replace(n, &text(n, "coalesced"), None);
+        }
+        journal.truncate(10);
+        journal.set_position(4);
+        let before = std::fs::metadata(journal_path(tmp.path(), "ab"))
+            .unwrap()
+            .len();
+
+        compact(&journal.shared).unwrap();
+        let after = std::fs::metadata(journal_path(tmp.path(), "ab"))
+            .unwrap()
+            .len();
+        assert!(after < before / 5, "{after} of {before} bytes left");
+        assert_eq!(journal.shared.writer().records, 11);
+
+        journal.set_position(2);
+        drop(journal);
+        let (_, restored) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        let expected: Vec<_> = (0..10).map(|n| text(n, "coalesced")).collect();
+        assert_eq!(debug(&restored.entries), debug(&expected));
+        assert_eq!(restored.position, 2);
+    }
+
+    #[test]
+    fn a_discarded_journal_is_deleted_and_takes_no_more_records() {
+        let tmp = tempfile::tempdir().unwrap();
+        let (journal, _) = Journal::open(tmp.path(), "ab", &[]).unwrap();
+        journal.discard();
+        journal.push(&text(0, "t"), None);
+        assert!(!journal_path(tmp.path(), "ab").exists());
+    }
+
+    #[test]
+    fn orphans_are_removed_and_named_journals_kept() {
+        let tmp = tempfile::tempdir().unwrap();
+        for name in ["aa.journal", "bb.journal", "cc.journal.tmp", "notes.txt"] {
+            std::fs::write(tmp.path().join(name), b"").unwrap();
+        }
+        remove_orphans(tmp.path(), &["aa"]);
+        let mut left: Vec<String> = std::fs::read_dir(tmp.path())
+            .unwrap()
+            .map(|d| d.unwrap().file_name().into_string().unwrap())
+            .collect();
+        left.sort();
+        assert_eq!(left, ["aa.journal", "notes.txt"]);
+    }
+
+    #[test]
+    fn a_claimed_dir_cannot_be_claimed_again() {
+        let tmp = tempfile::tempdir().unwrap();
+        let held = try_claim(tmp.path()).expect("unclaimed");
+        assert!(try_claim(tmp.path()).is_none());
+        drop(held);
+        assert!(try_claim(tmp.path()).is_some());
+    }
+
+    #[test]
+    fn open_timeline_restores_into_a_timeline() {
+        let tmp = tempfile::tempdir().unwrap();
+        let first = open_timeline(Some(tmp.path()), None, &[]);
+        let journal = first.journal.clone().expect("journaled");
+        journal.push(&text(4, "t"), None);
+        journal.push(&rename("a", "b"), None);
+        journal.set_position(1);
+
+        let restored = open_timeline(Some(tmp.path()), Some(journal.key()), &[]);
+        assert_eq!(restored.entries.len(), 2);
+        assert_eq!(restored.position, 1);
+        assert_eq!(restored.next_chunk_seq, 5);
+
+        assert!(
+            open_timeline(None, Some(journal.key()), &[])
+                .journal
+                .is_none()
+        );
+        assert!(
+            open_timeline(Some(tmp.path()), Some("../escape"), &[])
+                .journal
+                .is_some_and(|j| j.key() != "../escape")
+        );
+    }
+}
@@ -0,0 +1,848 @@
+//! Where the undo timeline keeps its snapshots.
+//!
+//! A `Structural` entry carries whole FFON elements, before and after, and a
+//! trashed file carries its contents (up to `TRASH_SNAPSHOT_LIMIT_BYTES`). Kept
+//! inline, ten edits to one large subtree held ten full copies of it, and the
+//! only bound was an entry count, however big the entries were.
+//!
+//! So [`TimelineEntries`] takes those payloads out of an entry when it is
+//! recorded and keeps them here instead:
+//!
+//! - **Content-addressed chunks.** A payload is cut into content-defined chunks
+//!   (a gear hash picks the boundaries, so an edit in the middle of a subtree
+//!   leaves the chunks around it intact) and each chunk is stored once per
+//!   SHA-256, however many entries, in however many tabs, refer to it.
+//! - **One byte budget across tabs.** [`over_budget`] counts every unique chunk
+//!   plus what entries still hold inline, and `state::record_entry` drops the
+//!   oldest entries of any tab until it fits. Undo depth is bounded by bytes,
+//!   not by a number of entries.
+//! - **Cold chunks on disk.** Past [`HOT_BUDGET_BYTES`], the least recently
+//!   used chunks are deflated into an unnamed spill file in the cache dir and
+//!   read back only when an undo reaches them. The OS removes the file when the
+//!   process exits.
+//!
+//! Entries are what the rest of the app sees; which payloads are stored, and
+//! how they are put back, is private to this module.
+
+use sha2::{Digest, Sha256};
+use sicompass_sdk::ffon::{self, FfonElement};
+use sicompass_sdk::timeline::{FsSideEffect, StructuralPayload, TimelineEntry};
+use std::collections::{HashMap, VecDeque};
+use std::fs::File;
+use std::io::{Read, Seek, SeekFrom, Write};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, MutexGuard, OnceLock};
+
+/// Everything the timelines of all tabs may hold, stored chunks (in memory or
+/// spilled) and inline entries together, before the oldest entries go.
+pub const TIMELINE_BUDGET_BYTES: usize = 256 * 1024 * 1024;
+
+/// Stored chunks kept in memory. Past this the least recently used spill.
+pub const HOT_BUDGET_BYTES: usize = 32 * 1024 * 1024;
+
+/// Payloads smaller than this stay in their entry: below a few chunks, the
+/// hashing and bookkeeping cost more than the copy they would save.
+const STORE_MIN_BYTES: usize = 4 * 1024;
+
+/// Content-defined chunk bounds. The average is about 8 KiB.
+const MIN_CHUNK: usize = 2 * 1024;
+const MAX_CHUNK: usize = 64 * 1024;
+/// A boundary falls where the top 13 bits of the rolling hash are zero.
+const BOUNDARY_SHIFT: u32 = 64 - 13;
+
+/// Spill-file garbage tolerated before it is rewritten without it.
+const COMPACT_MIN_DEAD: u64 = 16 * 1024 * 1024;
+
+type Hash = [u8; 32];
+
+// ---------------------------------------------------------------------------
+// Chunking
+// ---------------------------------------------------------------------------
+
+/// Per-byte values for the gear hash; any fixed random table will do.
+const GEAR: [u64; 256] = gear_table();
+
+const fn gear_table() -> [u64; 256] {
+    let mut table = [0u64; 256];
+    let mut state: u64 = 0x9E37_79B9_7F4A_7C15;
+    let mut i = 0;
+    while i < 256 {
+        // splitmix64
+        state = state.wrapping_add(0x9E37_79B9_7F4A_7C15);
+        let mut z = state;
+        z = (z ^ (z >> 30)).wrapping_mul(0xBF58_476D_1CE4_E5B9);
+        z = (z ^ (z >> 27)).wrapping_mul(0x94D0_49BB_1331_11EB);
+        table[i] = z ^ (z >> 31);
+        i += 1;
+    }
+    table
+}
+
+/// Cut `data` where its content says to, so the same bytes produce the same
+/// chunks wherever they sit in a payload.
+fn chunks(data: &[u8]) -> Vec<&[u8]> {
+    let mut out = Vec::new();
+    let mut start = 0;
+    let mut hash: u64 = 0;
+    for (i, &byte) in data.iter().enumerate() {
+        hash = (hash << 1).wrapping_add(GEAR[byte as usize]);
+        let len = i + 1 - start;
+        if (len >= MIN_CHUNK && hash >> BOUNDARY_SHIFT == 0) || len >= MAX_CHUNK {
+            out.push(&data[start..=i]);
+            start = i + 1;
+            hash = 0;
+        }
+    }
+    if start < data.len() {
+        out.push(&data[start..]);
+    }
+    out
+}
+
+fn digest(chunk: &[u8]) -> Hash {
+    Sha256::digest(chunk).into()
+}
+
+fn deflate(data: &[u8]) -> Vec<u8> {
+    let mut encoder = flate2::write::DeflateEncoder::new(Vec::new(), flate2::Compression::fast());
+    // Writing into a Vec cannot fail.
+    let _ = encoder.write_all(data);
+    encoder.finish().unwrap_or_default()
+}
+
+fn inflate(data: &[u8]) -> Option<Vec<u8>> {
+    let mut out = Vec::new();
+    flate2::read::DeflateDecoder::new(data)
+        .read_to_end(&mut out)
+        .ok()?;
+    Some(out)
+}
+
+// ---------------------------------------------------------------------------
+// The chunk store
+// ---------------------------------------------------------------------------
+
+enum Place {
+    Hot(Arc<[u8]>),
+    /// Deflated at `offset` in the spill file, `stored` bytes long.
+    Cold {
+        offset: u64,
+        stored: u64,
+    },
+}
+
+struct Chunk {
+    refs: usize,
+    len: usize,
+    place: Place,
+    /// Store tick of the last put or read, for picking what to spill.
+    used: u64,
+}
+
+/// The spill file. Unnamed, so nothing is left behind however the process ends.
+struct Spill {
+    file: File,
+    len: u64,
+    /// Bytes belonging to chunks no longer referenced.
+    dead: u64,
+}
+
+struct Store {
+    chunks: HashMap<Hash, Chunk>,
+    hot_bytes: usize,
+    cold_bytes: usize,
+    /// What entries hold themselves; see [`TimelineEntries`].
+    inline_bytes: usize,
+    hot_budget: usize,
+    spill: Option<Spill>,
+    tick: u64,
+}
+
+impl Store {
+    fn new(hot_budget: usize) -> Self {
+        Store {
+            chunks: HashMap::new(),
+            hot_bytes: 0,
+            cold_bytes: 0,
+            inline_bytes: 0,
+            hot_budget,
+            spill: None,
+            tick: 0,
+        }
+    }
+
+    fn total_bytes(&self) -> usize {
+        self.hot_bytes + self.cold_bytes + self.inline_bytes
+    }
+
+    /// Store `data` and return its chunk list, one reference taken per chunk.
+    fn put(&mut self, data: &[u8]) -> Vec<Hash> {
+        self.tick += 1;
+        let mut hashes = Vec::new();
+        for chunk in chunks(data) {
+            let hash = digest(chunk);
+            match self.chunks.get_mut(&hash) {
+                Some(existing) => {
+                    existing.refs += 1;
+                    existing.used = self.tick;
+                }
+                None => {
+                    self.hot_bytes += chunk.len();
+                    self.chunks.insert(
+                        hash,
+                        Chunk {
+                            refs: 1,
+                            len: chunk.len(),
+                            place: Place::Hot(Arc::from(chunk)),
+                            used: self.tick,
+                        },
+                    );
+                }
+            }
+            hashes.push(hash);
+        }
+        if self.hot_bytes > self.hot_budget {
+            self.spill_cold();
+        }
+        hashes
+    }
+
+    /// Take another reference to each of `hashes`.
+    fn retain(&mut self, hashes: &[Hash]) {
+        for hash in hashes {
+            if let Some(chunk) = self.chunks.get_mut(hash) {
+                chunk.refs += 1;
+            }
+        }
+    }
+
+    /// Give back one reference to each of `hashes`; a chunk nobody refers to
+    /// any more goes, from memory or from the spill file.
+    fn release(&mut self, hashes: &[Hash]) {
+        for hash in hashes {
+            let Some(chunk) = self.chunks.get_mut(hash) else {
+                continue;
+            };
+            chunk.refs -= 1;
+            if chunk.refs > 0 {
+                continue;
+            }
+            let Some(chunk) = self.chunks.remove(hash) else {
+                continue;
+            };
+            match chunk.place {
+                Place::Hot(_) => self.hot_bytes -= chunk.len,
+                Place::Cold { stored, .. } => {
+                    self.cold_bytes -= chunk.len;
+                    if let Some(spill) = &mut self.spill {
+                        spill.dead += stored;
+                    }
+                }
+            }
+        }
+        self.tidy_spill();
+    }
+
+    /// The bytes `hashes` spell, or `None` if a spilled chunk cannot be read
+    /// back.
+    fn read(&mut self, hashes: &[Hash], len: usize) -> Option<Vec<u8>> {
+        self.tick += 1;
+        let mut out = Vec::with_capacity(len);
+        for hash in hashes {
+            let chunk = self.chunks.get_mut(hash)?;
+            chunk.used = self.tick;
+            match &chunk.place {
+                Place::Hot(data) => out.extend_from_slice(data),
+                Place::Cold { offset, stored } => {
+                    let spill = self.spill.as_mut()?;
+                    let mut deflated = vec![0; *stored as usize];
+                    spill.file.seek(SeekFrom::Start(*offset)).ok()?;
+                    spill.file.read_exact(&mut deflated).ok()?;
+                    out.extend_from_slice(&inflate(&deflated)?);
+                }
+            }
+        }
+        Some(out)
+    }
+
+    /// Move the least recently used chunks to the spill file until a quarter
+    /// of the hot budget is free, so this does not run again on the next put.
+    /// A chunk that cannot be written stays in memory.
+    fn spill_cold(&mut self) {
+        let target = self.hot_budget / 4 * 3;
+        let mut hot: Vec<(u64, Hash)> = self
+            .chunks
+            .iter()
+            .filter(|(_, c)| matches!(c.place, Place::Hot(_)))
+            .map(|(h, c)| (c.used, *h))
+            .collect();
+        hot.sort_unstable();
+
+        if self.spill.is_none() {
+            self.spill = open_spill();
+        }
+        let Some(spill) = self.spill.as_mut() else {
+            return;
+        };
+        for (_, hash) in hot {
+            if self.hot_bytes <= target {
+                break;
+            }
+            let Some(chunk) = self.chunks.get_mut(&hash) else {
+                continue;
+            };
+            let Place::Hot(data) = &chunk.place else {
+                continue;
+            };
+            let deflated = deflate(data);
+            if spill.file.seek(SeekFrom::Start(spill.len)).is_err()
+                || spill.file.write_all(&deflated).is_err()
+            {
+                return;
+            }
+            chunk.place = Place::Cold {
+                offset: spill.len,
+                stored: deflated.len() as u64,
+            };
+            spill.len += deflated.len() as u64;
+            self.hot_bytes -= chunk.len;
+            self.cold_bytes += chunk.len;
+        }
+    }
+
+    /// Drop the spill file once nothing lives in it, and rewrite it without
+    /// its garbage once that outweighs what is still live.
+    fn tidy_spill(&mut self) {
+        if self.cold_bytes == 0 {
+            self.spill = None;
+            return;
+        }
+        let Some(Spill { len, dead, .. }) = self.spill else {
+            return;
+        };
+        if dead < COMPACT_MIN_DEAD || dead < len - dead {
+            return;
+        }
+        let Some(mut fresh) = open_spill() else {
+            return;
+        };
+        let mut moved: Vec<(Hash, u64)> = Vec::new();
+        for (hash, chunk) in &self.chunks {
+            let Place::Cold { offset, stored } = chunk.place else {
+                continue;
+            };
+            let old = self.spill.as_mut().expect("checked above");
+            let mut deflated = vec![0; stored as usize];
+            if old.file.seek(SeekFrom::Start(offset)).is_err()
+                || old.file.read_exact(&mut deflated).is_err()
+                || fresh.file.write_all(&deflated).is_err()
+            {
+                // Leave the old file in place; it is still consistent.
+                return;
+            }
+            moved.push((*hash, fresh.len));
+            fresh.len += stored;
+        }
+        for (hash, offset) in moved {
+            if let Some(Chunk {
+                place: Place::Cold { offset: at, .. },
+                ..
+            }) = self.chunks.get_mut(&hash)
+            {
+                *at = offset;
+            }
+        }
+        self.spill = Some(fresh);
+    }
+}
+
+fn open_spill() -> Option<Spill> {
+    let file = match sicompass_sdk::platform::cache_home() {
+        Some(base) => {
+            let dir = base.join("sicompass").join("timeline");
+            std::fs::create_dir_all(&dir).ok()?;
+            tempfile::tempfile_in(dir).ok()?
+        }
+        None => tempfile::tempfile().ok()?,
+    };
+    Some(Spill {
+        file,
+        len: 0,
+        dead: 0,
+    })
+}
+
+fn store() -> MutexGuard<'static, Store> {
+    static STORE: OnceLock<Mutex<Store>> = OnceLock::new();
+    STORE
+        .get_or_init(|| Mutex::new(Store::new(HOT_BUDGET_BYTES)))
+        .lock()
+        .unwrap_or_else(|e| e.into_inner())
+}
+
+/// Whether the timelines together hold more than [`TIMELINE_BUDGET_BYTES`].
+pub fn over_budget() -> bool {
+    store().total_bytes() > TIMELINE_BUDGET_BYTES
+}
+
+/// A stored payload: a counted reference to its chunks.
+struct Blob {
+    hashes: Box<[Hash]>,
+    len: usize,
+}
+
+impl Blob {
+    fn new(data: &[u8]) -> Self {
+        Blob {
+            hashes: store().put(data).into_boxed_slice(),
+            len: data.len(),
+        }
+    }
+
+    fn read(&self) -> Option<Vec<u8>> {
+        store().read(&self.hashes, self.len)
+    }
+}
+
+impl Clone for Blob {
+    fn clone(&self) -> Self {
+        store().retain(&self.hashes);
+        Blob {
+            hashes: self.hashes.clone(),
+            len: self.len,
+        }
+    }
+}
+
+impl Drop for Blob {
+    fn drop(&mut self) {
+        store().release(&self.hashes);
+    }
+}
+
+impl std::fmt::Debug for Blob {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        write!(
+            f,
+            "Blob({} bytes in {} chunks)",
+            self.len,
+            self.hashes.len()
+        )
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Entries
+// ---------------------------------------------------------------------------
+
+/// Global recording order, so the budget can find the oldest entry of any tab.
+static NEXT_SEQ: AtomicU64 = AtomicU64::new(0);
+
+/// Rough heap size of an FFON element.
+fn ffon_bytes(elem: &FfonElement) -> usize {
+    std::mem::size_of::<FfonElement>()
+        + match elem {
+            FfonElement::Str(s) => s.len(),
+            FfonElement::Obj(obj) => {
+                obj.key.len() + obj.children.iter().map(ffon_bytes).sum::<usize>()
+            }
+        }
+}
+
+/// What an entry costs where it is, once its stored payload is out of it.
+/// Measured when recorded; coalescing that later grows a `TextChunk` in place
+/// is not followed.
+fn inline_bytes(entry: &TimelineEntry) -> usize {
+    let payload = match entry {
+        TimelineEntry::TextChunk { before, after, .. } => ffon_bytes(before) + ffon_bytes(after),
+        TimelineEntry::Navigate {
+            from_path, to_path, ..
+        } => from_path.as_ref().map_or(0, String::len) + to_path.as_ref().map_or(0, String::len),
+        TimelineEntry::Structural { payload, .. } => match payload {
+            StructuralPayload::Inserted(e) | StructuralPayload::Removed(e) => ffon_bytes(e),
+            StructuralPayload::Pasted { before, after }
+            | StructuralPayload::Replaced { before, after } => {
+                ffon_bytes(before) + ffon_bytes(after)
+            }
+            #[allow(unreachable_patterns)]
+            _ => 0,
+        },
+        TimelineEntry::FsOp {
+            before,
+            after,
+            side_effect,
+            ..
+        } => {
+            before.as_ref().map_or(0, ffon_bytes)
+                + after.as_ref().map_or(0, ffon_bytes)
+                + match side_effect {
+                    FsSideEffect::TrashedFile {
+                        content_snapshot, ..
+                    } => content_snapshot.len(),
+                    _ => 0,
+                }
+        }
+        TimelineEntry::ProviderOp { payload, .. } => ffon_bytes(payload),
+        _ => 0,
+    };
+    std::mem::size_of::<TimelineEntry>() + payload
+}
+
+/// An empty stand-in for an element whose bytes are stored.
+fn hollow_element() -> FfonElement {
+    FfonElement::Str(String::new())
+}
+
+/// Take the payload worth storing out of `entry`, if it has one.
+///
+/// Structural elements are stored in the FFON binary codec, the one or two of
+/// them as one list; a trashed file's contents as they are. A trashed
+/// directory keeps its snapshot inline.
+fn take_payload(entry: &mut TimelineEntry) -> Option<Blob> {
+    match entry {
+        TimelineEntry::Structural { payload, .. } => {
+            let elems: Vec<&mut FfonElement> = match payload {
+                StructuralPayload::Inserted(e) | StructuralPayload::Removed(e) => vec![e],
+                StructuralPayload::Pasted { before, after }
+                | StructuralPayload::Replaced { before, after } => vec![before, after],
+                #[allow(unreachable_patterns)]
+                _ => return None,
+            };
+            if elems.iter().map(|e| ffon_bytes(e)).sum::<usize>() < STORE_MIN_BYTES {
+                return None;
+            }
+            let owned: Vec<FfonElement> = elems
+                .into_iter()
+                .map(|e| std::mem::replace(e, hollow_element()))
+                .collect();
+            Some(Blob::new(&ffon::serialize_binary(&owned)))
+        }
+        TimelineEntry::FsOp {
+            side_effect:
+                FsSideEffect::TrashedFile {
+                    content_snapshot, ..
+                },
+            ..
+        } if content_snapshot.len() >= STORE_MIN_BYTES => {
+            let blob = Blob::new(content_snapshot);
+            *content_snapshot = Vec::new();
+            Some(blob)
+        }
+        _ => None,
+    }
+}
+
+/// Put `data`, as taken by [`take_payload`], back into a copy of the entry.
+fn restore_payload(entry: &mut TimelineEntry, data: Vec<u8>) -> Option<()> {
+    match entry {
+        TimelineEntry::Structural { payload, .. } => {
+            let mut elems = ffon::deserialize_binary(&data).into_iter();
+            match payload {
+                StructuralPayload::Inserted(e) | StructuralPayload::Removed(e) => {
+                    *e = elems.next()?;
+                }
+                StructuralPayload::Pasted { before, after }
+                | StructuralPayload::Replaced { before, after } => {
+                    *before = elems.next()?;
+                    *after = elems.next()?;
+                }
+                #[allow(unreachable_patterns)]
+                _ => return None,
+            }
+        }
+        TimelineEntry::FsOp {
+            side_effect:
+                FsSideEffect::TrashedFile {
+                    content_snapshot, ..
+                },
+            ..
+        } => *content_snapshot = data,
+        _ => return None,
+    }
+    Some(())
+}
+
+/// One recorded entry, its stored payload taken out.
+#[derive(Debug)]
+struct Slot {
+    entry: TimelineEntry,
+    payload: Option<Blob>,
+    seq: u64,
+    /// Counted into the store's inline bytes while this slot lives.
+    inline: usize,
+}
+
+impl Slot {
+    fn new(mut entry: TimelineEntry) -> Self {
+        let payload = take_payload(&mut entry);
+        let inline = inline_bytes(&entry);
+        store().inline_bytes += inline;
+        Slot {
+            entry,
+            payload,
+            seq: NEXT_SEQ.fetch_add(1, Ordering::Relaxed),
+            inline,
+        }
+    }
+
+    /// The entry as recorded, payload and all.
+    fn load(&self) -> Option<TimelineEntry> {
+        let mut entry = self.entry.clone();
+        if let Some(blob) = &self.payload {
+            restore_payload(&mut entry, blob.read()?)?;
+        }
+        Some(entry)
+    }
+}
+
+impl Clone for Slot {
+    fn clone(&self) -> Self {
+        store().inline_bytes += self.inline;
+        Slot {
+            entry: self.entry.clone(),
+            payload: self.payload.clone(),
+            seq: self.seq,
+            inline: self.inline,
+        }
+    }
+}
+
+impl Drop for Slot {
+    fn drop(&mut self) {
+        let mut store = store();
+        store.inline_bytes = store.inline_bytes.saturating_sub(self.inline);
+    }
+}
+
+/// A tab's timeline entries, oldest first: a ring buffer whose large payloads
+/// live in the shared store.
+///
+/// Indexing, iteration, [`get_mut`](Self::get_mut) and
+/// [`last_mut`](Self::last_mut) see entries with their stored payloads taken
+/// out, which is all the timeline view and coalescing look at; only
+/// `TextChunk` and `Navigate` entries, which are never stored, are edited in
+/// place. [`load`](Self::load) returns an entry whole, for undo and redo.
+#[derive(Debug, Default, Clone)]
+pub struct TimelineEntries {
+    slots: VecDeque<Slot>,
+}
+
+impl TimelineEntries {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    pub fn len(&self) -> usize {
+        self.slots.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.slots.is_empty()
+    }
+
+    pub fn push(&mut self, entry: TimelineEntry) {
+        self.slots.push_back(Slot::new(entry));
+    }
+
+    /// Remove the newest entry, returning it whole when it can still be read.
+    pub fn pop(&mut self) -> Option<TimelineEntry> {
+        self.slots.pop_back().and_then(|slot| slot.load())
+    }
+
+    /// Drop the oldest entry.
+    pub fn pop_front(&mut self) {
+        self.slots.pop_front();
+    }
+
+    pub fn truncate(&mut self, len: usize) {
+        self.slots.truncate(len);
+    }
+
+    pub fn clear(&mut self) {
+        self.slots.clear();
+    }
+
+    pub fn get(&self, index: usize) -> Option<&TimelineEntry> {
+        self.slots.get(index).map(|s| &s.entry)
+    }
+
+    pub fn get_mut(&mut self, index: usize) -> Option<&mut TimelineEntry> {
+        self.slots.get_mut(index).map(|s| &mut s.entry)
+    }
+
+    pub fn first(&self) -> Option<&TimelineEntry> {
+        self.slots.front().map(|s| &s.entry)
+    }
+
+    pub fn last(&self) -> Option<&TimelineEntry> {
+        self.slots.back().map(|s| &s.entry)
+    }
+
+    pub fn last_mut(&mut self) -> Option<&mut TimelineEntry> {
+        self.slots.back_mut().map(|s| &mut s.entry)
+    }
+
+    pub fn iter(&self) -> impl DoubleEndedIterator<Item = &TimelineEntry> + ExactSizeIterator {
+        self.slots.iter().map(|s| &s.entry)
+    }
+
+    /// The entries in `range`, as [`iter`](Self::iter) sees them.
+    pub fn range(
+        &self,
+        range: impl std::ops::RangeBounds<usize>,
+    ) -> impl DoubleEndedIterator<Item = &TimelineEntry> + ExactSizeIterator {
+        self.slots.range(range).map(|s| &s.entry)
+    }
+
+    /// Entry `index` whole, for applying it. `None` past the end, or when its
+    /// payload was spilled and can no longer be read.
+    pub fn load(&self, index: usize) -> Option<TimelineEntry> {
+        self.slots.get(index)?.load()
+    }
+
+    /// Recording order of the oldest entry, comparable across tabs.
+    pub fn oldest_seq(&self) -> Option<u64> {
+        self.slots.front().map(|s| s.seq)
+    }
+}
+
+impl std::ops::Index<usize> for TimelineEntries {
+    type Output = TimelineEntry;
+
+    fn index(&self, index: usize) -> &TimelineEntry {
+        &self.slots[index].entry
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use sicompass_sdk::ffon::IdArray;
+    use sicompass_sdk::timeline::StructuralOp;
+
+    /// A large subtree with some variety, so the chunker finds boundaries.
+    fn big_tree(tag: &str) -> FfonElement {
+        let mut root = FfonElement::new_obj(tag);
+        if let FfonElement::Obj(obj) = &mut root {
+            for i in 0..2_000 {
+                obj.children.push(FfonElement::new_str(&format!(
+                    "{tag} line {i}: {}",
+                    i * 7919 % 104_729
+                )));
+            }
+        }
+        root
+    }
+
+    fn removed(elem: FfonElement) -> TimelineEntry {
+        TimelineEntry::Structural {
+            id: IdArray::new(),
+            op: StructuralOp::Delete,
+            payload: StructuralPayload::Removed(elem),
+        }
+    }
+
+    #[test]
+    fn chunks_cover_the_input_within_bounds() {
+        let data: Vec<u8> = (0..300_000u32).map(|i| (i * 31 % 251) as u8).collect();
+        let parts = chunks(&data);
+        assert_eq!(parts.concat(), data);
+        for part in &parts[..parts.len() - 1] {
+            assert!(part.len() >= MIN_CHUNK && part.len() <= MAX_CHUNK);
+        }
+    }
+
+    #[test]
+    fn an_insertion_leaves_later_chunks_unchanged() {
+        let data: Vec<u8> = (0..200_000u32)
+            .map(|i| (i.wrapping_mul(2_654_435_761) >> 13) as u8)
+            .collect();
+        let mut edited = data[..50_000].to_vec();
+        edited.extend_from_slice(b"a few inserted bytes");
+        edited.extend_from_slice(&data[50_000..]);
+
+        let before: Vec<Hash> = chunks(&data).into_iter().map(digest).collect();
+        let after: Vec<Hash> = chunks(&edited).into_iter().map(digest).collect();
+        let shared = after.iter().filter(|h| before.contains(h)).count();
+        assert!(
+            shared + 3 >= before.len(),
+            "{shared} of {} chunks survived",
+            before.len()
+        );
+    }
+
+    #[test]
+    fn a_structural_payload_round_trips_through_the_store() {
+        let entry = removed(big_tree("big"));
+        let mut entries = TimelineEntries::new();
+        entries.push(entry.clone());
+
+        let slot = &entries.slots[0];
+        assert!(slot.payload.is_some(), "a large payload is stored");
+        assert!(matches!(
+            &entries[0],
+            TimelineEntry::Structural {
+                payload: StructuralPayload::Removed(FfonElement::Str(s)),
+                ..
+            } if s.is_empty()
+        ));
+        assert_eq!(
+            format!("{:?}", entries.load(0).unwrap()),
+            format!("{entry:?}")
+        );
+    }
+
+    #[test]
+    fn a_small_payload_stays_inline() {
+        let mut entries = TimelineEntries::new();
+        entries.push(removed(FfonElement::new_str("small")));
+        assert!(entries.slots[0].payload.is_none());
+    }
+
+    #[test]
+    fn repeated_snapshots_share_their_chunks() {
+        let mut entries = TimelineEntries::new();
+        entries.push(removed(big_tree("shared")));
+        entries.push(removed(big_tree("shared")));
+
+        let first = entries.slots[0].payload.as_ref().unwrap();
+        let second = entries.slots[1].payload.as_ref().unwrap();
+        assert_eq!(first.hashes, second.hashes);
+        let store = store();
+        for hash in first.hashes.iter() {
+            assert!(store.chunks[hash].refs >= 2);
+        }
+    }
+
+    #[test]
+    fn dropping_entries_releases_their_chunks() {
+        let mut entries = TimelineEntries::new();
+        entries.push(removed(big_tree("released-only-here")));
+        let hashes = entries.slots[0].payload.as_ref().unwrap().hashes.clone();
+        entries.clear();
+        let store = store();
+        assert!(hashes.iter().all(|h| !store.chunks.contains_key(h)));
+    }
+
+    #[test]
+    fn cold_chunks_spill_and_read_back() {
+        let mut store = Store::new(64 * 1024);
+        let data: Vec<u8> = (0..400_000u32)
+            .map(|i| (i.wrapping_mul(2_654_435_761) >> 11) as u8)
+            .collect();
+        let hashes = store.put(&data);
+
+        assert!(
+            store.hot_bytes <= 64 * 1024,
+            "over budget: {}",
+            store.hot_bytes
+        );
+        assert!(store.cold_bytes > 0);
+        assert_eq!(store.hot_bytes + store.cold_bytes, data.len());
+        assert_eq!(store.read(&hashes, data.len()).unwrap(), data);
+
+        store.release(&hashes);
+        assert_eq!(store.total_bytes(), 0);
+        assert!(store.spill.is_none(), "an empty spill file is dropped");
+    }
+}
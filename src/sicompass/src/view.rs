@@ -112,6 +112,14 @@ pub fn main_loop(app: &mut AppState) {
 
         // ---- Collect all pending SDL events (avoids split borrow) -----------
         let events: Vec<Event> = app.event_pump.poll_iter().collect();
+        if events.iter().any(|e| {
+            matches!(
+                e,
+                Event::KeyDown { .. } | Event::TextInput { .. } | Event::MouseButtonDown { .. }
+            )
+        }) {
+            app.renderer.last_input_at = std::time::Instant::now();
+        }
 
         for event in events {
             match event {
@@ -340,6 +348,12 @@ pub fn main_loop(app: &mut AppState) {
         // out of one tab into another tab's dashboard. The gate itself lives in
         // `events` so the loop and the tests exercise the same code.
         crate::events::apply_dashboard_requests(&mut app.renderer, dashboard_requests);
+        // Build the next tab ahead of a switch, or drop a long-parked one, while
+        // the user is idle. Not while the switcher is open: its rows are built
+        // from the tabs' parked trees.
+        if app.renderer.coordinate != Coordinate::TabSwitcher {
+            app.renderer.tend_tabs();
+        }
         // Sync SDL text-input state with the coordinate after the dispatch.
         // Without this, the dashboard's text-input-enabled state lingers
         // through auto-leave; the next `i` keypress would fire BOTH the
@@ -0,0 +1,443 @@
+//! What each plugin costs: per export, per host import, and in memory.
+//!
+//! [`super::limits`] stops a guest that goes too far, but says nothing about one
+//! that stays inside its caps and is merely expensive — the plugin that takes
+//! 30ms of every frame is invisible until it traps. This module keeps the
+//! figures that find it, per plugin (by manifest name, not the guest's
+//! self-reported one):
+//!
+//! - **per export** — calls, traps, fuel burned, wall time (total and worst),
+//!   and the FFON bytes sent and received;
+//! - **per host import** — how often the guest called back, and the bytes it got;
+//! - **linear memory** — the largest any of its instances grew to;
+//! - **network** — requests sent, bytes each way, and requests the HTTP cache
+//!   answered instead.
+//!
+//! Recording costs a clock read, a fuel read and one uncontended lock per call,
+//! so it is always on. The totals are shown as a table in the settings panel
+//! (see [`status_rows`]) and written as JSON on exit (see [`write_dump`]).
+//!
+//! ## Where the figures come from
+//!
+//! Fuel is the difference between [`FUEL_PER_CALL`] and what is left, so it
+//! counts guest instructions and not time spent in host functions; wall time
+//! counts both. Memory growth and import calls happen inside the store, so they
+//! are counted there by the [`Meter`] in [`HostState`] and collected after each
+//! export returns.
+
+use std::collections::BTreeMap;
+use std::path::PathBuf;
+use std::sync::{Mutex, OnceLock};
+use std::time::{Duration, Instant};
+
+use serde_json::{Value, json};
+use sicompass_sdk::FfonElement;
+use wasmtime::{ResourceLimiter, Store, StoreLimits};
+
+use super::HostState;
+use super::limits::{self, FUEL_PER_CALL};
+
+/// The settings-panel section the table is shown under.
+pub const STATUS_SECTION: &str = "Plugin usage";
+
+/// One export's totals.
+#[derive(Debug, Default, Clone, PartialEq)]
+pub struct ExportUsage {
+    pub calls: u64,
+    pub traps: u64,
+    pub fuel: u64,
+    pub wall: Duration,
+    pub max_wall: Duration,
+    /// FFON bytes the host passed in.
+    pub bytes_sent: u64,
+    /// FFON bytes the guest passed back.
+    pub bytes_received: u64,
+}
+
+/// One host import's totals.
+#[derive(Debug, Default, Clone, PartialEq)]
+pub struct ImportUsage {
+    pub calls: u64,
+    /// Bytes the import handed the guest: an asset, a response body.
+    pub bytes: u64,
+}
+
+/// One plugin's network traffic, counted on the wire.
+#[derive(Debug, Default, Clone, PartialEq)]
+pub struct NetworkUsage {
+    pub requests: u64,
+    pub bytes_sent: u64,
+    pub bytes_received: u64,
+    /// Requests answered from the HTTP cache, which sent nothing.
+    pub cache_hits: u64,
+}
+
+/// One plugin's totals.
+#[derive(Debug, Default, Clone, PartialEq)]
+pub struct PluginUsage {
+    pub exports: BTreeMap<String, ExportUsage>,
+    pub imports: BTreeMap<&'static str, ImportUsage>,
+    pub memory_high_water: usize,
+    pub network: NetworkUsage,
+}
+
+impl PluginUsage {
+    /// The export this plugin spent the most wall time in.
+    fn busiest(&self) -> Option<(&str, &ExportUsage)> {
+        self.exports
+            .iter()
+            .max_by_key(|(_, e)| e.wall)
+            .map(|(name, e)| (name.as_str(), e))
+    }
+}
+
+fn usage() -> &'static Mutex<BTreeMap<String, PluginUsage>> {
+    static USAGE: OnceLock<Mutex<BTreeMap<String, PluginUsage>>> = OnceLock::new();
+    USAGE.get_or_init(|| Mutex::new(BTreeMap::new()))
+}
+
+fn with_plugin<T>(plugin: &str, f: impl FnOnce(&mut PluginUsage) -> T) -> T {
+    let mut usage = usage().lock().unwrap_or_else(|e| e.into_inner());
+    if !usage.contains_key(plugin) {
+        usage.insert(plugin.to_owned(), PluginUsage::default());
+    }
+    f(usage.get_mut(plugin).expect("inserted above"))
+}
+
+// ---------------------------------------------------------------------------
+// Meter
+// ---------------------------------------------------------------------------
+
+/// The in-store half: enforces the memory caps and counts what happens between
+/// two collections.
+///
+/// Wraps [`StoreLimits`] rather than replacing it, so the caps are exactly the
+/// ones [`limits::store_limits`] documents; this only watches what they allow.
+pub struct Meter {
+    limits: StoreLimits,
+    memory_high_water: usize,
+    imports: BTreeMap<&'static str, ImportUsage>,
+}
+
+impl Default for Meter {
+    fn default() -> Self {
+        Meter {
+            limits: limits::store_limits(),
+            memory_high_water: 0,
+            imports: BTreeMap::new(),
+        }
+    }
+}
+
+impl Meter {
+    /// Count one call of host import `name` that handed the guest `bytes`.
+    pub fn import(&mut self, name: &'static str, bytes: usize) {
+        let entry = self.imports.entry(name).or_default();
+        entry.calls += 1;
+        entry.bytes += bytes as u64;
+    }
+}
+
+impl ResourceLimiter for Meter {
+    fn memory_growing(
+        &mut self,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> wasmtime::Result<bool> {
+        let allowed = self.limits.memory_growing(current, desired, maximum)?;
+        if allowed {
+            self.memory_high_water = self.memory_high_water.max(desired);
+        }
+        Ok(allowed)
+    }
+
+    fn memory_grow_failed(&mut self, error: wasmtime::Error) -> wasmtime::Result<()> {
+        self.limits.memory_grow_failed(error)
+    }
+
+    fn table_growing(
+        &mut self,
+        current: usize,
+        desired: usize,
+        maximum: Option<usize>,
+    ) -> wasmtime::Result<bool> {
+        self.limits.table_growing(current, desired, maximum)
+    }
+
+    fn table_grow_failed(&mut self, error: wasmtime::Error) -> wasmtime::Result<()> {
+        self.limits.table_grow_failed(error)
+    }
+
+    fn instances(&self) -> usize {
+        self.limits.instances()
+    }
+
+    fn tables(&self) -> usize {
+        self.limits.tables()
+    }
+
+    fn memories(&self) -> usize {
+        self.limits.memories()
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Recording
+// ---------------------------------------------------------------------------
+
+/// Record one call of `export` that began at `started`, and collect what the
+/// store's [`Meter`] counted during it.
+///
+/// Call after the export returns and before anything re-arms the store's fuel.
+pub fn record_call(store: &mut Store<HostState>, export: &str, started: Instant, trapped: bool) {
+    let wall = started.elapsed();
+    let fuel = FUEL_PER_CALL.saturating_sub(store.get_fuel().unwrap_or(0));
+    let state = store.data_mut();
+    let imports = std::mem::take(&mut state.meter.imports);
+    let memory = state.meter.memory_high_water;
+
+    with_plugin(&state.plugin_name, |plugin| {
+        let e = plugin.exports.entry(export.to_owned()).or_default();
+        e.calls += 1;
+        e.traps += u64::from(trapped);
+        e.fuel += fuel;
+        e.wall += wall;
+        e.max_wall = e.max_wall.max(wall);
+        for (name, counted) in imports {
+            let i = plugin.imports.entry(name).or_default();
+            i.calls += counted.calls;
+            i.bytes += counted.bytes;
+        }
+        plugin.memory_high_water = plugin.memory_high_water.max(memory);
+    });
+}
+
+/// Record FFON bytes that crossed the boundary during the last call of `export`.
+pub fn record_bytes(plugin: &str, export: &str, sent: usize, received: usize) {
+    if sent == 0 && received == 0 {
+        return;
+    }
+    with_plugin(plugin, |plugin| {
+        let e = plugin.exports.entry(export.to_owned()).or_default();
+        e.bytes_sent += sent as u64;
+        e.bytes_received += received as u64;
+    });
+}
+
+/// Record one request a plugin made: its body and the response body, or a
+/// cache hit that sent nothing.
+///
+/// Called from whichever thread ran the request, which is why this takes the
+/// plugin by name rather than through its store.
+pub fn record_network(plugin: &str, sent: usize, received: usize, cache_hit: bool) {
+    with_plugin(plugin, |plugin| {
+        let n = &mut plugin.network;
+        if cache_hit {
+            n.cache_hits += 1;
+        } else {
+            n.requests += 1;
+            n.bytes_sent += sent as u64;
+            n.bytes_received += received as u64;
+        }
+    });
+}
+
+/// Every plugin's totals so far.
+pub fn snapshot() -> BTreeMap<String, PluginUsage> {
+    usage().lock().unwrap_or_else(|e| e.into_inner()).clone()
+}
+
+// ---------------------------------------------------------------------------
+// Reporting
+// ---------------------------------------------------------------------------
+
+/// The totals as JSON, for tools rather than people.
+///
+/// Durations are in microseconds and every count is a plain integer, so two
+/// dumps can be diffed or summed without parsing units.
+pub fn to_json(usage: &BTreeMap<String, PluginUsage>) -> Value {
+    let plugins: serde_json::Map<String, Value> = usage
+        .iter()
+        .map(|(name, p)| {
+            let exports: serde_json::Map<String, Value> = p
+                .exports
+                .iter()
+                .map(|(export, e)| {
+                    let usage = json!({
+                        "calls": e.calls,
+                        "traps": e.traps,
+                        "fuel": e.fuel,
+                        "wallMicros": e.wall.as_micros() as u64,
+                        "maxWallMicros": e.max_wall.as_micros() as u64,
+                        "bytesSent": e.bytes_sent,
+                        "bytesReceived": e.bytes_received,
+                    });
+                    (export.clone(), usage)
+                })
+                .collect();
+            let imports: serde_json::Map<String, Value> = p
+                .imports
+                .iter()
+                .map(|(import, i)| {
+                    let usage = json!({ "calls": i.calls, "bytes": i.bytes });
+                    ((*import).to_owned(), usage)
+                })
+                .collect();
+            let plugin = json!({
+                "memoryHighWaterBytes": p.memory_high_water,
+                "exports": exports,
+                "imports": imports,
+                "network": {
+                    "requests": p.network.requests,
+                    "bytesSent": p.network.bytes_sent,
+                    "bytesReceived": p.network.bytes_received,
+                    "cacheHits": p.network.cache_hits,
+                },
+            });
+            (name.clone(), plugin)
+        })
+        .collect();
+    json!({ "plugins": plugins })
+}
+
+/// Where [`write_dump`] writes: `wasm-usage.json` next to the log.
+pub fn dump_path() -> Option<PathBuf> {
+    sicompass_sdk::platform::log_dir().map(|dir| dir.join("wasm-usage.json"))
+}
+
+/// Write the totals to [`dump_path`]. Nothing is written when no plugin ran.
+pub fn write_dump() -> Option<PathBuf> {
+    let usage = snapshot();
+    if usage.is_empty() {
+        return None;
+    }
+    let path = dump_path()?;
+    let json = serde_json::to_string_pretty(&to_json(&usage)).ok()?;
+    if let Some(dir) = path.parent() {
+        sicompass_sdk::platform::make_dirs(dir);
+    }
+    sicompass_sdk::platform::atomic_write(&path, &json).then_some(path)
+}
+
+/// The settings-panel table: one entry per plugin, its summary in the key and
+/// one line per export, busiest first.
+///
+/// Registered with `sicompass_config::status` at startup; empty until a plugin
+/// has run, so the section only appears once there is something in it.
+pub fn status_rows() -> Vec<FfonElement> {
+    snapshot()
+        .iter()
+        .map(|(name, p)| {
+            let mut heading = format!("{name}: memory {}", kib(p.memory_high_water));
+            if let Some((export, e)) = p.busiest() {
+                heading.push_str(&format!(", busiest {export} {}", millis(e.wall)));
+            }
+            let mut plugin = FfonElement::new_obj(heading);
+            let rows = plugin.as_obj_mut().expect("new_obj is an obj");
+
+            let mut exports: Vec<_> = p.exports.iter().collect();
+            exports.sort_by(|a, b| b.1.wall.cmp(&a.1.wall));
+            for (export, e) in exports {
+                let mut line = format!(
+                    "{export}: {} calls, {} total, {} worst, {} fuel",
+                    e.calls,
+                    millis(e.wall),
+                    millis(e.max_wall),
+                    e.fuel
+                );
+                if e.bytes_sent + e.bytes_received > 0 {
+                    line.push_str(&format!(
+                        ", {} in, {} out",
+                        kib(e.bytes_sent as usize),
+                        kib(e.bytes_received as usize)
+                    ));
+                }
+                if e.traps > 0 {
+                    line.push_str(&format!(", {} traps", e.traps));
+                }
+                rows.push(FfonElement::Str(line));
+            }
+            for (import, i) in &p.imports {
+                rows.push(FfonElement::Str(format!(
+                    "host {import}: {} calls, {}",
+                    i.calls,
+                    kib(i.bytes as usize)
+                )));
+            }
+            let n = &p.network;
+            if n.requests + n.cache_hits > 0 {
+                rows.push(FfonElement::Str(format!(
+                    "network: {} requests, {} sent, {} received, {} from cache",
+                    n.requests,
+                    kib(n.bytes_sent as usize),
+                    kib(n.bytes_received as usize),
+                    n.cache_hits
+                )));
+            }
+            plugin
+        })
+        .collect()
+}
+
+fn millis(d: Duration) -> String {
+    format!("{:.1}ms", d.as_secs_f64() * 1000.0)
+}
+
+fn kib(bytes: usize) -> String {
+    format!("{:.1} KiB", bytes as f64 / 1024.0)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn the_meter_tracks_the_largest_growth_it_allowed() {
+        let mut meter = Meter::default();
+        assert!(meter.memory_growing(0, 1 << 20, None).unwrap());
+        assert!(meter.memory_growing(1 << 20, 4 << 20, None).unwrap());
+        assert_eq!(meter.memory_high_water, 4 << 20);
+
+        // Refused growth is not usage: the cap is what stopped it.
+        let over = limits::MAX_MEMORY_BYTES + 1;
+        assert!(!meter.memory_growing(4 << 20, over, None).unwrap());
+        assert_eq!(meter.memory_high_water, 4 << 20);
+    }
+
+    #[test]
+    fn bytes_accumulate_per_export() {
+        let plugin = "accounting-test-bytes";
+        record_bytes(plugin, "fetch", 0, 100);
+        record_bytes(plugin, "fetch", 10, 50);
+        record_bytes(plugin, "poll", 0, 0);
+
+        let usage = snapshot().remove(plugin).unwrap();
+        let fetch = &usage.exports["fetch"];
+        assert_eq!((fetch.bytes_sent, fetch.bytes_received), (10, 150));
+        // Nothing crossed, so nothing was recorded.
+        assert!(!usage.exports.contains_key("poll"));
+    }
+
+    #[test]
+    fn the_dump_uses_plain_units() {
+        let mut p = PluginUsage::default();
+        p.exports.insert(
+            "fetch".to_owned(),
+            ExportUsage {
+                calls: 2,
+                wall: Duration::from_millis(3),
+                ..Default::default()
+            },
+        );
+        p.imports.insert("log", ImportUsage { calls: 5, bytes: 0 });
+        p.memory_high_water = 65536;
+        let usage = BTreeMap::from([("hello".to_owned(), p)]);
+
+        let json = to_json(&usage);
+        let hello = &json["plugins"]["hello"];
+        assert_eq!(hello["memoryHighWaterBytes"], 65536);
+        assert_eq!(hello["exports"]["fetch"]["wallMicros"], 3000);
+        assert_eq!(hello["imports"]["log"]["calls"], 5);
+    }
+}
@@ -0,0 +1,172 @@
+//! The host half of the `incremental` interface: applying a guest's changes to
+//! the host's copy of its tree, and describing the host's edits to body children
+//! as changes.
+//!
+//! Both directions use the same `ffon-patch`, a splice at a path; the WIT file
+//! documents the contract. Anything that does not fit — a path that does not
+//! resolve, a splice past the end of its list — is an `Err`, and the caller falls
+//! back to a full transfer rather than guessing what the sender meant.
+
+use sicompass_sdk::{FfonElement, ffon};
+
+use super::wit_incremental::FfonPatch;
+
+/// Apply `patches` to `tree` in order.
+///
+/// On `Err` the tree may be partly patched, so the caller must discard it.
+pub fn apply(tree: &mut Vec<FfonElement>, patches: &[FfonPatch]) -> Result<(), String> {
+    patches.iter().try_for_each(|patch| apply_one(tree, patch))
+}
+
+fn apply_one(tree: &mut Vec<FfonElement>, patch: &FfonPatch) -> Result<(), String> {
+    let Some((&at, parents)) = patch.path.split_last() else {
+        return Err("a patch with an empty path".to_owned());
+    };
+
+    let mut list = tree;
+    for &i in parents {
+        list = &mut list
+            .get_mut(i as usize)
+            .and_then(FfonElement::as_obj_mut)
+            .ok_or_else(|| format!("patch path {:?} does not resolve", patch.path))?
+            .children;
+    }
+
+    let at = at as usize;
+    let end = at + patch.remove as usize;
+    if end > list.len() {
+        return Err(format!(
+            "patch at {:?} removes {} of {} elements",
+            patch.path,
+            patch.remove,
+            list.len().saturating_sub(at)
+        ));
+    }
+    list.splice(at..end, ffon::deserialize_binary(&patch.insert));
+    Ok(())
+}
+
+/// The one splice that turns `old` into `new`, or `None` when they are equal.
+///
+/// Trims the common prefix and suffix and replaces what is left. The edits that
+/// reach `sync-ffon-body-children` — a deleted element, its undo, one edited
+/// line — are a single contiguous run, so this sends exactly that run without
+/// the cost of a general tree diff. A change spread across the list degrades to
+/// sending the span between the first and last difference, never to a wrong
+/// answer.
+pub fn diff(old: &[FfonElement], new: &[FfonElement]) -> Option<FfonPatch> {
+    let prefix = old.iter().zip(new).take_while(|(a, b)| a == b).count();
+    if prefix == old.len() && prefix == new.len() {
+        return None;
+    }
+    let suffix = old[prefix..]
+        .iter()
+        .rev()
+        .zip(new[prefix..].iter().rev())
+        .take_while(|(a, b)| a == b)
+        .count();
+
+    Some(FfonPatch {
+        path: vec![prefix as u32],
+        remove: (old.len() - prefix - suffix) as u32,
+        insert: ffon::serialize_binary(&new[prefix..new.len() - suffix]),
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn strs(items: &[&str]) -> Vec<FfonElement> {
+        items.iter().map(|s| FfonElement::new_str(*s)).collect()
+    }
+
+    fn obj(key: &str, children: Vec<FfonElement>) -> FfonElement {
+        let mut o = FfonElement::new_obj(key);
+        for child in children {
+            o.as_obj_mut().unwrap().push(child);
+        }
+        o
+    }
+
+    fn patch(path: &[u32], remove: u32, insert: &[FfonElement]) -> FfonPatch {
+        FfonPatch {
+            path: path.to_vec(),
+            remove,
+            insert: ffon::serialize_binary(insert),
+        }
+    }
+
+    #[test]
+    fn a_top_level_splice_replaces_the_run_it_names() {
+        let mut tree = strs(&["a", "b", "c"]);
+        apply(&mut tree, &[patch(&[1], 1, &strs(&["x", "y"]))]).unwrap();
+        assert_eq!(tree, strs(&["a", "x", "y", "c"]));
+    }
+
+    #[test]
+    fn a_nested_path_descends_through_objects() {
+        let mut tree = vec![obj("root", vec![obj("inner", strs(&["a", "b"]))])];
+        apply(&mut tree, &[patch(&[0, 0, 2], 0, &strs(&["c"]))]).unwrap();
+        assert_eq!(
+            tree,
+            vec![obj("root", vec![obj("inner", strs(&["a", "b", "c"]))])]
+        );
+    }
+
+    #[test]
+    fn patches_apply_in_order() {
+        // The second patch's index is only right once the first has been applied.
+        let mut tree = strs(&["a", "b"]);
+        apply(
+            &mut tree,
+            &[patch(&[0], 1, &[]), patch(&[1], 0, &strs(&["c"]))],
+        )
+        .unwrap();
+        assert_eq!(tree, strs(&["b", "c"]));
+    }
+
+    #[test]
+    fn a_patch_that_does_not_fit_is_refused() {
+        let mut tree = vec![obj("root", strs(&["a"]))];
+        // Through a string, which has no children.
+        assert!(apply(&mut tree, &[patch(&[0, 0, 0], 0, &[])]).is_err());
+        // Past the end of the list.
+        assert!(apply(&mut tree, &[patch(&[0, 0], 2, &[])]).is_err());
+        assert!(apply(&mut tree, &[patch(&[3], 0, &[])]).is_err());
+        // Nowhere at all.
+        assert!(apply(&mut tree, &[patch(&[], 0, &[])]).is_err());
+    }
+
+    #[test]
+    fn diff_sends_only_the_changed_run() {
+        let old = strs(&["a", "b", "c", "d"]);
+        let new = strs(&["a", "x", "d"]);
+        let p = diff(&old, &new).unwrap();
+        assert_eq!((p.path.as_slice(), p.remove), ([1u32].as_slice(), 2));
+        assert_eq!(ffon::deserialize_binary(&p.insert), strs(&["x"]));
+    }
+
+    #[test]
+    fn diff_round_trips_through_apply() {
+        let cases = [
+            (strs(&["a", "b"]), strs(&["a", "b", "c"])),
+            (strs(&["a", "b", "c"]), strs(&["b", "c"])),
+            (strs(&["a"]), strs(&[])),
+            (strs(&[]), strs(&["a"])),
+            (strs(&["a", "a"]), strs(&["a", "a", "a"])),
+            (strs(&["a", "b", "a"]), strs(&["a", "a"])),
+        ];
+        for (old, new) in cases {
+            let mut patched = old.clone();
+            apply(&mut patched, &[diff(&old, &new).unwrap()]).unwrap();
+            assert_eq!(patched, new, "{old:?} -> {new:?}");
+        }
+    }
+
+    #[test]
+    fn equal_lists_need_no_patch() {
+        assert!(diff(&strs(&["a", "b"]), &strs(&["a", "b"])).is_none());
+        assert!(diff(&[], &[]).is_none());
+    }
+}
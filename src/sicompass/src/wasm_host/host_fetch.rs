@@ -31,9 +31,11 @@
 use std::collections::HashMap;
 use std::collections::VecDeque;
 use std::net::IpAddr;
-use std::sync::{Mutex, OnceLock};
+use std::sync::{Arc, Mutex, OnceLock};
 use std::time::{Duration, Instant};
 
+use super::accounting;
+use super::http_cache::{self, Lookup};
 use super::wit::net::{HttpRequest, HttpResponse};
 
 /// Sent on every plugin request, so site owners can identify and contact us.
@@ -84,26 +86,36 @@ const DENIED_HEADERS: &[&str] = &[
 // ---------------------------------------------------------------------------
 
 /// Request policy for one plugin instance.
+///
+/// Cheap to clone, and the clones share one quota: each request in flight on
+/// [`super::net_requests`]' workers carries its own handle, and all of them draw
+/// from the budget the instance started with.
+#[derive(Clone)]
 pub struct FetchPolicy {
-    plugin_name: String,
+    plugin_name: Arc<str>,
     /// Lower-cased hosts from `plugin.json`.
-    allowed_hosts: Vec<String>,
+    allowed_hosts: Arc<[String]>,
     /// Recent request times per host, for the quota window.
-    recent: HashMap<String, VecDeque<Instant>>,
+    recent: Arc<Mutex<HashMap<String, VecDeque<Instant>>>>,
 }
 
 impl FetchPolicy {
     pub fn new(plugin_name: &str, allowed_hosts: &[String]) -> Self {
         FetchPolicy {
-            plugin_name: plugin_name.to_owned(),
+            plugin_name: plugin_name.into(),
             allowed_hosts: allowed_hosts
                 .iter()
                 .map(|h| h.trim().to_lowercase())
                 .collect(),
-            recent: HashMap::new(),
+            recent: Arc::default(),
         }
     }
 
+    /// The manifest name requests are refused and accounted under.
+    pub fn plugin_name(&self) -> &str {
+        &self.plugin_name
+    }
+
     /// Whether `host` is on this plugin's allowlist.
     pub fn host_allowed(&self, host: &str) -> bool {
         let host = host.to_lowercase();
@@ -111,9 +123,10 @@ impl FetchPolicy {
     }
 
     /// Record a request and report whether it fits in the budget.
-    fn take_quota(&mut self, host: &str) -> Result<(), String> {
+    fn take_quota(&self, host: &str) -> Result<(), String> {
         let now = Instant::now();
-        let slot = self.recent.entry(host.to_owned()).or_default();
+        let mut recent = self.recent.lock().unwrap_or_else(|e| e.into_inner());
+        let slot = recent.entry(host.to_owned()).or_default();
         while slot
             .front()
             .is_some_and(|t| now.duration_since(*t) > QUOTA_WINDOW)
@@ -266,7 +279,7 @@ fn robots_cache() -> &'static Mutex<HashMap<String, RobotsEntry>> {
 /// request it should have blocked. The one-hour TTL means that entry never expires
 /// within a run. Rare on a developer machine, reliable in CI.
 #[cfg(test)]
-fn forget_robots(origin: &str) {
+pub(super) fn forget_robots(origin: &str) {
     robots_cache().lock().unwrap().remove(origin);
 }
 
@@ -282,7 +295,7 @@ thread_local! {
     ///
     /// `#[cfg(test)]` means this cannot exist in a shipped binary, and the check it
     /// guards has its own dedicated tests that never touch this flag.
-    static ALLOW_INTERNAL_FOR_TESTS: std::cell::Cell<bool> =
+    pub(super) static ALLOW_INTERNAL_FOR_TESTS: std::cell::Cell<bool> =
         const { std::cell::Cell::new(false) };
 }
 
@@ -375,7 +388,7 @@ fn vet_url(policy: &FetchPolicy, url: &str) -> Result<(reqwest::Url, String, Str
     Ok((parsed, host, origin))
 }
 
-/// Fetch and cache robots.txt for `origin`, then check `path` and the crawl delay.
+/// Fetch and cache robots.txt for `origin`, then check `path` against it.
 fn check_robots(origin: &str, path: &str) -> Result<(), String> {
     let now = Instant::now();
 
@@ -395,22 +408,37 @@ fn check_robots(origin: &str, path: &str) -> Result<(), String> {
             // Any other status, or an unreachable server: no rules to apply.
             Ok(_) | Err(_) => Robots::default(),
         };
-        robots_cache().lock().unwrap().insert(
+        let mut cache = robots_cache().lock().unwrap();
+        // Keep the crawl-delay clock of an entry being refreshed.
+        let last_request = cache.get(origin).and_then(|e| e.last_request);
+        cache.insert(
             origin.to_owned(),
             RobotsEntry {
                 robots,
                 fetched: now,
-                last_request: None,
+                last_request,
             },
         );
     }
 
-    let mut cache = robots_cache().lock().unwrap();
-    let entry = cache.get_mut(origin).expect("just inserted");
-
+    let cache = robots_cache().lock().unwrap();
+    let entry = cache.get(origin).expect("just inserted");
     if !entry.robots.allows(path) {
         return Err(format!("{origin}/robots.txt disallows {path}"));
     }
+    Ok(())
+}
+
+/// Honour `origin`'s `Crawl-delay` for a request about to go out.
+///
+/// Separate from [`check_robots`] because a request the cache answers never
+/// reaches the site, so it owes it no delay.
+fn take_crawl_slot(origin: &str) -> Result<(), String> {
+    let now = Instant::now();
+    let mut cache = robots_cache().lock().unwrap();
+    let Some(entry) = cache.get_mut(origin) else {
+        return Ok(());
+    };
 
     if let Some(delay) = entry.robots.crawl_delay
         && let Some(last) = entry.last_request
@@ -445,6 +473,10 @@ fn sanitize_headers(headers: &[(String, String)]) -> Vec<(String, String)> {
 
 /// The shared blocking HTTP client.
 ///
+/// One for every plugin and every thread, so they share its pool of kept-alive
+/// connections: a plugin polling a feed reuses the connection rather than paying
+/// a TLS handshake per request.
+///
 /// Redirects are disabled: [`perform`] follows them itself so every hop is
 /// re-checked against the allowlist. Automatic following would let a 302 leave it.
 /// No cookie store either — a plugin gets no cross-request identity.
@@ -460,12 +492,16 @@ fn client() -> &'static reqwest::blocking::Client {
     })
 }
 
-/// Run a blocking request on its own thread.
+/// Run a blocking request where no tokio runtime is current.
 ///
 /// `reqwest::blocking` panics if called while a tokio runtime is current, and a
-/// guest call can be reached from one (`Provider::undo` is async). A dedicated
-/// thread has no runtime context, so this is safe wherever it is called from.
+/// guest call can be reached from one (`Provider::undo` is async). There, the
+/// request gets a dedicated thread, which has no runtime context; anywhere else —
+/// the render thread, a request worker — it runs in place.
 fn off_runtime<T: Send + 'static>(f: impl FnOnce() -> T + Send + 'static) -> Result<T, String> {
+    if tokio::runtime::Handle::try_current().is_err() {
+        return Ok(f());
+    }
     std::thread::Builder::new()
         .name("sicompass-plugin-fetch".to_owned())
         .spawn(f)
@@ -485,30 +521,68 @@ fn http_get_text(url: &str) -> Result<(u16, String), String> {
     })?
 }
 
-/// Perform one guest request, applying the whole policy.
-pub fn perform(policy: &mut FetchPolicy, req: HttpRequest) -> Result<HttpResponse, String> {
-    let method = req.method.trim().to_uppercase();
+/// Check what can be checked about a request without touching the network.
+///
+/// [`perform`] runs the same checks again; this is for refusing a request
+/// before it is queued, so the guest hears about a bad method or host at once.
+pub fn vet_request(policy: &FetchPolicy, req: &HttpRequest) -> Result<(), String> {
+    vet_method(&req.method)?;
+    vet_url(policy, &req.url).map(drop)
+}
+
+fn vet_method(method: &str) -> Result<String, String> {
+    let method = method.trim().to_uppercase();
     if !ALLOWED_METHODS.contains(&method.as_str()) {
         return Err(format!(
             "method `{method}` is not permitted (allowed: {})",
             ALLOWED_METHODS.join(", ")
         ));
     }
+    Ok(method)
+}
 
+/// Perform one guest request, applying the whole policy.
+///
+/// Blocks for as long as the exchange takes; [`super::net_requests`] runs it
+/// off the guest's thread.
+pub fn perform(policy: &FetchPolicy, req: HttpRequest) -> Result<HttpResponse, String> {
+    let mut method = vet_method(&req.method)?;
     let headers = sanitize_headers(&req.headers);
     let mut url = req.url.clone();
     let mut body = req.body.clone();
-    let mut method = method;
 
     for hop in 0..=MAX_REDIRECTS {
         // Every hop is vetted from scratch — that is the point of following
         // redirects by hand.
         let (parsed, host, origin) = vet_url(policy, &url)?;
         check_robots(&origin, parsed.path())?;
+
+        // Only now, with the URL cleared for this plugin, may the cache answer.
+        let cache_key = http_cache::key(&method, &url, &headers, body.is_some());
+        let mut hop_headers = headers.clone();
+        match cache_key.as_ref().map(http_cache::lookup) {
+            Some(Lookup::Fresh(resp)) => {
+                accounting::record_network(policy.plugin_name(), 0, 0, true);
+                return Ok(resp);
+            }
+            Some(Lookup::Stale(validators)) => hop_headers.extend(validators),
+            Some(Lookup::Miss) | None => {}
+        }
+
+        take_crawl_slot(&origin)?;
         policy.take_quota(&host)?;
 
+        let sent = body.as_ref().map_or(0, Vec::len);
         let (status, resp_headers, resp_body, location) =
-            send_once(&method, &url, &headers, body.clone())?;
+            send_once(&method, &url, &hop_headers, body.clone())?;
+        accounting::record_network(policy.plugin_name(), sent, resp_body.len(), false);
+
+        if status == 304
+            && let Some(key) = &cache_key
+            && let Some(resp) = http_cache::revalidated(key, &resp_headers)
+        {
+            return Ok(resp);
+        }
 
         let is_redirect = matches!(status, 301 | 302 | 303 | 307 | 308);
         match location {
@@ -530,11 +604,15 @@ pub fn perform(policy: &mut FetchPolicy, req: HttpRequest) -> Result<HttpRespons
             }
             // Not a redirect, or a redirect with no Location: hand it back as-is.
             _ => {
-                return Ok(HttpResponse {
+                let resp = HttpResponse {
                     status,
                     headers: resp_headers,
                     body: resp_body,
-                });
+                };
+                if let Some(key) = cache_key {
+                    http_cache::store(key, &resp);
+                }
+                return Ok(resp);
             }
         }
     }
@@ -822,7 +900,7 @@ mod tests {
 
     #[test]
     fn the_quota_is_per_host_and_refuses_when_spent() {
-        let mut p = policy(&["a.test", "b.test"]);
+        let p = policy(&["a.test", "b.test"]);
         for i in 0..QUOTA_REQUESTS {
             p.take_quota("a.test")
                 .unwrap_or_else(|e| panic!("request {i} refused: {e}"));
@@ -836,7 +914,7 @@ mod tests {
 
     #[test]
     fn quota_errors_name_the_plugin_so_the_user_knows_who_to_blame() {
-        let mut p = policy(&["a.test"]);
+        let p = policy(&["a.test"]);
         for _ in 0..QUOTA_REQUESTS {
             let _ = p.take_quota("a.test");
         }
@@ -871,7 +949,7 @@ mod tests {
         use wiremock::{Mock, MockServer, ResponseTemplate};
 
         /// Allow this thread to reach the mock server on 127.0.0.1, and drop any
-        /// robots.txt cached for this server's origin.
+        /// robots.txt or response cached for this server's origin.
         ///
         /// The internal-address flag is thread-local, so it cannot leak into a test
         /// checking that refusal itself. The cache eviction is per-origin: a port
@@ -881,6 +959,7 @@ mod tests {
         fn arrange(server: &MockServer) {
             ALLOW_INTERNAL_FOR_TESTS.with(|c| c.set(true));
             forget_robots(&server.uri());
+            http_cache::forget(&server.uri());
         }
 
         fn get(url: &str) -> HttpRequest {
@@ -921,8 +1000,8 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
-            let resp = perform(&mut p, get(&format!("{}/page", server.uri()))).unwrap();
+            let p = policy_for(&server);
+            let resp = perform(&p, get(&format!("{}/page", server.uri()))).unwrap();
 
             assert_eq!(resp.status, 200);
             assert_eq!(String::from_utf8_lossy(&resp.body), "hello");
@@ -934,8 +1013,8 @@ mod tests {
             arrange(&server);
             // No mounts at all: if the allowlist failed open, the request would 404
             // rather than being refused, and the error text would differ.
-            let mut p = FetchPolicy::new("demo", &["somewhere.else".to_owned()]);
-            let err = perform(&mut p, get(&format!("{}/page", server.uri()))).unwrap_err();
+            let p = FetchPolicy::new("demo", &["somewhere.else".to_owned()]);
+            let err = perform(&p, get(&format!("{}/page", server.uri()))).unwrap_err();
             assert!(err.contains("allowedHosts"), "{err}");
         }
 
@@ -950,9 +1029,8 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
-            let err =
-                perform(&mut p, get(&format!("{}/private/secret", server.uri()))).unwrap_err();
+            let p = policy_for(&server);
+            let err = perform(&p, get(&format!("{}/private/secret", server.uri()))).unwrap_err();
             assert!(err.contains("robots.txt disallows"), "{err}");
 
             // And a permitted path on the same origin still works, so this is the
@@ -962,7 +1040,7 @@ mod tests {
                 .respond_with(ResponseTemplate::new(200).set_body_string("ok"))
                 .mount(&server)
                 .await;
-            assert!(perform(&mut p, get(&format!("{}/public", server.uri()))).is_ok());
+            assert!(perform(&p, get(&format!("{}/public", server.uri()))).is_ok());
         }
 
         #[tokio::test(flavor = "multi_thread")]
@@ -976,10 +1054,10 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
+            let p = policy_for(&server);
             let started = Instant::now();
-            assert!(perform(&mut p, get(&format!("{}/a", server.uri()))).is_ok());
-            let err = perform(&mut p, get(&format!("{}/a", server.uri()))).unwrap_err();
+            assert!(perform(&p, get(&format!("{}/a", server.uri()))).is_ok());
+            let err = perform(&p, get(&format!("{}/a", server.uri()))).unwrap_err();
 
             assert!(err.contains("between requests"), "{err}");
             // The point: it returns immediately. Honouring a 30s Crawl-delay by
@@ -1006,8 +1084,8 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
-            let resp = perform(&mut p, get(&format!("{}/from", server.uri()))).unwrap();
+            let p = policy_for(&server);
+            let resp = perform(&p, get(&format!("{}/from", server.uri()))).unwrap();
             assert_eq!(resp.status, 200);
             assert_eq!(String::from_utf8_lossy(&resp.body), "arrived");
         }
@@ -1028,8 +1106,8 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
-            let err = perform(&mut p, get(&format!("{}/away", server.uri()))).unwrap_err();
+            let p = policy_for(&server);
+            let err = perform(&p, get(&format!("{}/away", server.uri()))).unwrap_err();
             assert!(err.contains("allowedHosts"), "{err}");
             assert!(
                 err.contains("evil.test"),
@@ -1055,8 +1133,8 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
-            let err = perform(&mut p, get(&format!("{}/huge", server.uri()))).unwrap_err();
+            let p = policy_for(&server);
+            let err = perform(&p, get(&format!("{}/huge", server.uri()))).unwrap_err();
             assert!(err.contains("over the"), "{err}");
 
             // A body inside the cap still comes through, so the limit is a limit and
@@ -1066,7 +1144,7 @@ mod tests {
                 .respond_with(ResponseTemplate::new(200).set_body_bytes(vec![b'y'; 1024]))
                 .mount(&server)
                 .await;
-            let ok = perform(&mut p, get(&format!("{}/small", server.uri()))).unwrap();
+            let ok = perform(&p, get(&format!("{}/small", server.uri()))).unwrap();
             assert_eq!(ok.body.len(), 1024);
         }
 
@@ -1087,20 +1165,80 @@ mod tests {
                 .mount(&server)
                 .await;
 
-            let mut p = policy_for(&server);
-            assert!(perform(&mut p, get(&format!("{}/page", server.uri()))).is_ok());
+            let p = policy_for(&server);
+            assert!(perform(&p, get(&format!("{}/page", server.uri()))).is_ok());
         }
 
         #[tokio::test(flavor = "multi_thread")]
         async fn a_disallowed_method_is_refused_before_any_request() {
             let server = MockServer::start().await;
             arrange(&server);
-            let mut p = policy_for(&server);
+            let p = policy_for(&server);
             let mut req = get(&format!("{}/x", server.uri()));
             req.method = "DELETE".to_owned();
 
-            let err = perform(&mut p, req).unwrap_err();
+            let err = perform(&p, req).unwrap_err();
             assert!(err.contains("not permitted"), "{err}");
         }
+
+        #[tokio::test(flavor = "multi_thread")]
+        async fn a_fresh_cached_response_is_served_without_a_request() {
+            let server = MockServer::start().await;
+            arrange(&server);
+            serve_robots(&server, "User-agent: *\nDisallow:\n").await;
+            Mock::given(method("GET"))
+                .and(path("/cached"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .insert_header("cache-control", "max-age=300")
+                        .set_body_string("once"),
+                )
+                .expect(1)
+                .mount(&server)
+                .await;
+
+            let p = policy_for(&server);
+            let url = format!("{}/cached", server.uri());
+            let first = perform(&p, get(&url)).unwrap();
+            let second = perform(&p, get(&url)).unwrap();
+
+            assert_eq!(first.body, second.body);
+            // `expect(1)` is checked when the server drops: the second answer
+            // came from the cache.
+        }
+
+        #[tokio::test(flavor = "multi_thread")]
+        async fn a_stale_response_is_revalidated_with_its_etag() {
+            let server = MockServer::start().await;
+            arrange(&server);
+            serve_robots(&server, "User-agent: *\nDisallow:\n").await;
+            Mock::given(method("GET"))
+                .and(path("/tagged"))
+                .and(wiremock::matchers::header("if-none-match", "\"v1\""))
+                .respond_with(ResponseTemplate::new(304).insert_header("etag", "\"v1\""))
+                .expect(1)
+                .mount(&server)
+                .await;
+            Mock::given(method("GET"))
+                .and(path("/tagged"))
+                .respond_with(
+                    ResponseTemplate::new(200)
+                        .insert_header("cache-control", "no-cache")
+                        .insert_header("etag", "\"v1\"")
+                        .set_body_string("tagged body"),
+                )
+                .expect(1)
+                .mount(&server)
+                .await;
+
+            let p = policy_for(&server);
+            let url = format!("{}/tagged", server.uri());
+            perform(&p, get(&url)).unwrap();
+            let again = perform(&p, get(&url)).unwrap();
+
+            // The 304 is turned back into the stored response.
+            assert_eq!(again.status, 200);
+            assert_eq!(String::from_utf8_lossy(&again.body), "tagged body");
+        }
     }
 }
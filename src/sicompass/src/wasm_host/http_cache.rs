@@ -0,0 +1,429 @@
+//! A small shared HTTP cache for plugin requests.
+//!
+//! Plugins that poll a feed or re-read the same page on every refresh would
+//! otherwise spend their quota, and the site's patience, on bytes the host
+//! already has. [`super::host_fetch::perform`] consults this after a request
+//! has passed the allowlist and robots.txt and before it touches the network, so
+//! a cached answer is never served for a URL the plugin may not fetch now — the
+//! cache saves the trip, not the checks.
+//!
+//! What is kept is deliberately narrow:
+//!
+//! - `GET` only, `200` only, with no request body;
+//! - nothing from a request carrying credentials (`authorization`, `cookie`),
+//!   since the cache is shared by every plugin;
+//! - nothing marked `no-store` or `private`, nothing that sets a cookie, and
+//!   nothing that `Vary`s on more than encoding;
+//! - a response is fresh for its `max-age`; past that, or with `no-cache`, it is
+//!   kept only if it has a validator (`ETag`, `Last-Modified`) to revalidate it
+//!   with, and the next request asks the server whether it changed.
+//!
+//! A request that brings its own conditional or cache-control headers bypasses
+//! the cache: the guest is managing freshness itself.
+
+use std::collections::{HashMap, VecDeque};
+use std::sync::{Mutex, OnceLock};
+use std::time::{Duration, Instant};
+
+use super::wit::net::HttpResponse;
+
+/// Total body bytes kept across all entries.
+const MAX_CACHE_BYTES: usize = 16 << 20;
+
+/// Largest single body worth keeping. Bigger ones would evict everything else.
+const MAX_ENTRY_BYTES: usize = 2 << 20;
+
+/// Request headers that mean the guest is handling caching itself.
+const BYPASS_HEADERS: &[&str] = &[
+    "if-none-match",
+    "if-modified-since",
+    "if-match",
+    "if-unmodified-since",
+    "if-range",
+    "cache-control",
+    "pragma",
+];
+
+/// Request headers that make a response personal to whoever sent them.
+const CREDENTIAL_HEADERS: &[&str] = &["authorization", "cookie"];
+
+/// The URL and the request headers, which together pick one response.
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+pub struct Key {
+    url: String,
+    headers: Vec<(String, String)>,
+}
+
+struct Entry {
+    response: HttpResponse,
+    fresh_until: Instant,
+    etag: Option<String>,
+    last_modified: Option<String>,
+}
+
+struct Cache {
+    entries: HashMap<Key, Entry>,
+    /// Insertion order, oldest first, for eviction.
+    order: VecDeque<Key>,
+    bytes: usize,
+    max_bytes: usize,
+}
+
+impl Cache {
+    fn new(max_bytes: usize) -> Self {
+        Cache {
+            entries: HashMap::new(),
+            order: VecDeque::new(),
+            bytes: 0,
+            max_bytes,
+        }
+    }
+
+    fn lookup(&self, key: &Key, now: Instant) -> Lookup {
+        let Some(entry) = self.entries.get(key) else {
+            return Lookup::Miss;
+        };
+        if now < entry.fresh_until {
+            return Lookup::Fresh(entry.response.clone());
+        }
+        let mut validators = Vec::new();
+        if let Some(etag) = &entry.etag {
+            validators.push(("if-none-match".to_owned(), etag.clone()));
+        }
+        if let Some(date) = &entry.last_modified {
+            validators.push(("if-modified-since".to_owned(), date.clone()));
+        }
+        Lookup::Stale(validators)
+    }
+
+    fn revalidated(
+        &mut self,
+        key: &Key,
+        headers: &[(String, String)],
+        now: Instant,
+    ) -> Option<HttpResponse> {
+        let entry = self.entries.get_mut(key)?;
+        entry.fresh_until = now + CachePolicy::of(headers).fresh_for();
+        Some(entry.response.clone())
+    }
+
+    fn store(&mut self, key: Key, response: &HttpResponse, now: Instant) {
+        if response.status != 200 || response.body.len() > MAX_ENTRY_BYTES.min(self.max_bytes) {
+            return;
+        }
+        let policy = CachePolicy::of(&response.headers);
+        let etag = header(&response.headers, "etag");
+        let last_modified = header(&response.headers, "last-modified");
+        let revalidatable = etag.is_some() || last_modified.is_some();
+        if policy.no_store
+            || policy.private
+            || policy.sets_cookie
+            || policy.varies
+            || (policy.fresh_for().is_zero() && !revalidatable)
+        {
+            return;
+        }
+
+        self.remove(&key);
+        while self.bytes + response.body.len() > self.max_bytes
+            && let Some(oldest) = self.order.front().cloned()
+        {
+            self.remove(&oldest);
+        }
+        self.bytes += response.body.len();
+        self.order.push_back(key.clone());
+        self.entries.insert(
+            key,
+            Entry {
+                response: response.clone(),
+                fresh_until: now + policy.fresh_for(),
+                etag,
+                last_modified,
+            },
+        );
+    }
+
+    fn remove(&mut self, key: &Key) {
+        if let Some(old) = self.entries.remove(key) {
+            self.bytes -= old.response.body.len();
+            self.order.retain(|k| k != key);
+        }
+    }
+}
+
+fn cache() -> &'static Mutex<Cache> {
+    static CACHE: OnceLock<Mutex<Cache>> = OnceLock::new();
+    CACHE.get_or_init(|| Mutex::new(Cache::new(MAX_CACHE_BYTES)))
+}
+
+fn shared() -> std::sync::MutexGuard<'static, Cache> {
+    cache().lock().unwrap_or_else(|e| e.into_inner())
+}
+
+/// The cache key for a request, or `None` when it must not be cached.
+pub fn key(method: &str, url: &str, headers: &[(String, String)], has_body: bool) -> Option<Key> {
+    if method != "GET" || has_body {
+        return None;
+    }
+    let mut normalized: Vec<(String, String)> = headers
+        .iter()
+        .map(|(k, v)| (k.to_lowercase(), v.clone()))
+        .collect();
+    if normalized.iter().any(|(k, _)| {
+        BYPASS_HEADERS.contains(&k.as_str()) || CREDENTIAL_HEADERS.contains(&k.as_str())
+    }) {
+        return None;
+    }
+    normalized.sort();
+    Some(Key {
+        url: url.to_owned(),
+        headers: normalized,
+    })
+}
+
+/// What the cache holds for a request.
+pub enum Lookup {
+    /// Serve this without asking the server.
+    Fresh(HttpResponse),
+    /// Ask the server, with these headers, whether it changed.
+    Stale(Vec<(String, String)>),
+    Miss,
+}
+
+pub fn lookup(key: &Key) -> Lookup {
+    shared().lookup(key, Instant::now())
+}
+
+/// The server answered `304` to a revalidation: the cached response is current
+/// again, for as long as the new headers say.
+pub fn revalidated(key: &Key, headers: &[(String, String)]) -> Option<HttpResponse> {
+    shared().revalidated(key, headers, Instant::now())
+}
+
+/// Keep `response` for `key` if its headers allow it.
+pub fn store(key: Key, response: &HttpResponse) {
+    shared().store(key, response, Instant::now());
+}
+
+/// Forget everything cached under `url_prefix`. Tests only; see `forget_robots`
+/// for why a freed port makes this necessary.
+#[cfg(test)]
+pub fn forget(url_prefix: &str) {
+    let mut cache = shared();
+    let keys: Vec<Key> = cache
+        .entries
+        .keys()
+        .filter(|k| k.url.starts_with(url_prefix))
+        .cloned()
+        .collect();
+    for key in keys {
+        cache.remove(&key);
+    }
+}
+
+/// The parts of a response's caching headers that matter here.
+#[derive(Debug, Default, PartialEq)]
+struct CachePolicy {
+    no_store: bool,
+    /// Meant for one user only, which a cache shared by every plugin is not.
+    private: bool,
+    no_cache: bool,
+    max_age: Option<Duration>,
+    /// A `Set-Cookie` would hand one requester's session to every other.
+    sets_cookie: bool,
+    /// `Vary` names something other than the encoding.
+    varies: bool,
+}
+
+impl CachePolicy {
+    fn of(headers: &[(String, String)]) -> Self {
+        let mut policy = CachePolicy::default();
+        for (name, value) in headers {
+            if name.eq_ignore_ascii_case("cache-control") {
+                for directive in value.split(',').map(|d| d.trim().to_ascii_lowercase()) {
+                    match directive.split_once('=') {
+                        Some(("max-age", secs)) => {
+                            policy.max_age =
+                                secs.trim_matches('"').parse().ok().map(Duration::from_secs);
+                        }
+                        // `private="field"` limits only the named fields; the
+                        // whole response is still not shared.
+                        Some(("private", _)) => policy.private = true,
+                        _ if directive == "no-store" => policy.no_store = true,
+                        _ if directive == "private" => policy.private = true,
+                        _ if directive == "no-cache" => policy.no_cache = true,
+                        _ => {}
+                    }
+                }
+            } else if name.eq_ignore_ascii_case("set-cookie") {
+                policy.sets_cookie = true;
+            } else if name.eq_ignore_ascii_case("vary") {
+                policy.varies |= value
+                    .split(',')
+                    .map(str::trim)
+                    .any(|v| !v.is_empty() && !v.eq_ignore_ascii_case("accept-encoding"));
+            }
+        }
+        policy
+    }
+
+    /// How long a response may be served without asking. `no-cache` means not at
+    /// all, whatever `max-age` says.
+    fn fresh_for(&self) -> Duration {
+        if self.no_cache {
+            return Duration::ZERO;
+        }
+        self.max_age.unwrap_or(Duration::ZERO)
+    }
+}
+
+fn header(headers: &[(String, String)], name: &str) -> Option<String> {
+    headers
+        .iter()
+        .find(|(n, _)| n.eq_ignore_ascii_case(name))
+        .map(|(_, v)| v.clone())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn h(pairs: &[(&str, &str)]) -> Vec<(String, String)> {
+        pairs
+            .iter()
+            .map(|(k, v)| ((*k).to_owned(), (*v).to_owned()))
+            .collect()
+    }
+
+    fn response(headers: &[(&str, &str)], body: &[u8]) -> HttpResponse {
+        HttpResponse {
+            status: 200,
+            headers: h(headers),
+            body: body.to_vec(),
+        }
+    }
+
+    #[test]
+    fn only_plain_gets_are_cacheable() {
+        assert!(key("GET", "https://a.test/", &[], false).is_some());
+        assert!(key("POST", "https://a.test/", &[], true).is_none());
+        assert!(key("GET", "https://a.test/", &[], true).is_none());
+        assert!(
+            key(
+                "GET",
+                "https://a.test/",
+                &h(&[("Authorization", "x")]),
+                false
+            )
+            .is_none()
+        );
+        assert!(
+            key(
+                "GET",
+                "https://a.test/",
+                &h(&[("If-None-Match", "\"1\"")]),
+                false
+            )
+            .is_none()
+        );
+    }
+
+    #[test]
+    fn header_order_and_case_do_not_split_the_key() {
+        let a = key("GET", "u", &h(&[("Accept", "x"), ("X-A", "1")]), false);
+        let b = key("GET", "u", &h(&[("x-a", "1"), ("accept", "x")]), false);
+        assert_eq!(a, b);
+    }
+
+    #[test]
+    fn cache_control_is_read() {
+        let p = CachePolicy::of(&h(&[("Cache-Control", "public, max-age=60")]));
+        assert_eq!(p.fresh_for(), Duration::from_secs(60));
+        assert!(CachePolicy::of(&h(&[("cache-control", "no-store")])).no_store);
+        assert!(CachePolicy::of(&h(&[("cache-control", "Private")])).private);
+        assert!(CachePolicy::of(&h(&[("cache-control", "private=\"x-user\"")])).private);
+        assert!(!CachePolicy::of(&h(&[("cache-control", "public")])).private);
+        assert!(CachePolicy::of(&h(&[("Set-Cookie", "a=1")])).sets_cookie);
+        assert_eq!(
+            CachePolicy::of(&h(&[("cache-control", "max-age=60, no-cache")])).fresh_for(),
+            Duration::ZERO
+        );
+        assert!(!CachePolicy::of(&h(&[("vary", "Accept-Encoding")])).varies);
+        assert!(CachePolicy::of(&h(&[("vary", "Accept-Encoding, Cookie")])).varies);
+    }
+
+    #[test]
+    fn a_fresh_response_is_served_and_a_stale_one_asks_with_its_validator() {
+        let mut cache = Cache::new(MAX_CACHE_BYTES);
+        let now = Instant::now();
+        let fresh = key("GET", "https://a.test/fresh", &[], false).unwrap();
+        cache.store(
+            fresh.clone(),
+            &response(&[("cache-control", "max-age=60")], b"hi"),
+            now,
+        );
+        assert!(matches!(cache.lookup(&fresh, now), Lookup::Fresh(r) if r.body == b"hi"));
+        let later = now + Duration::from_secs(61);
+        assert!(matches!(cache.lookup(&fresh, later), Lookup::Stale(v) if v.is_empty()));
+
+        let stale = key("GET", "https://a.test/stale", &[], false).unwrap();
+        cache.store(stale.clone(), &response(&[("etag", "\"v1\"")], b"old"), now);
+        match cache.lookup(&stale, now) {
+            Lookup::Stale(validators) => {
+                assert_eq!(validators, h(&[("if-none-match", "\"v1\"")]));
+            }
+            _ => panic!("a response with only a validator should need revalidating"),
+        }
+        let body = cache
+            .revalidated(&stale, &h(&[("cache-control", "max-age=60")]), now)
+            .unwrap();
+        assert_eq!(body.body, b"old");
+        assert!(matches!(cache.lookup(&stale, now), Lookup::Fresh(_)));
+    }
+
+    #[test]
+    fn uncacheable_responses_are_not_kept() {
+        let mut cache = Cache::new(MAX_CACHE_BYTES);
+        let now = Instant::now();
+        for (i, headers) in [
+            h(&[("cache-control", "no-store, max-age=60")]),
+            h(&[("cache-control", "max-age=60"), ("vary", "cookie")]),
+            h(&[("cache-control", "private, max-age=60")]),
+            h(&[("cache-control", "max-age=60"), ("Set-Cookie", "session=1")]),
+            h(&[("set-cookie", "session=1"), ("etag", "\"v1\"")]),
+            // Neither a lifetime nor a way to revalidate.
+            h(&[]),
+        ]
+        .into_iter()
+        .enumerate()
+        {
+            let k = key("GET", &format!("https://a.test/{i}"), &[], false).unwrap();
+            let response = HttpResponse {
+                status: 200,
+                headers,
+                body: b"x".to_vec(),
+            };
+            cache.store(k.clone(), &response, now);
+            assert!(matches!(cache.lookup(&k, now), Lookup::Miss), "case {i}");
+        }
+    }
+
+    #[test]
+    fn the_byte_cap_evicts_the_oldest_entries() {
+        let mut cache = Cache::new(10);
+        let now = Instant::now();
+        let keys: Vec<Key> = (0..3)
+            .map(|i| key("GET", &format!("https://a.test/{i}"), &[], false).unwrap())
+            .collect();
+        for k in &keys {
+            cache.store(
+                k.clone(),
+                &response(&[("cache-control", "max-age=60")], b"12345"),
+                now,
+            );
+        }
+        assert!(matches!(cache.lookup(&keys[0], now), Lookup::Miss));
+        assert!(matches!(cache.lookup(&keys[2], now), Lookup::Fresh(_)));
+        assert_eq!(cache.bytes, 10);
+    }
+}
@@ -13,7 +13,13 @@
 //!
 //! ## Layout
 //!
+//! - [`accounting`] — per-plugin fuel, time, memory and boundary traffic
+//! - [`delta`] — applying and computing incremental FFON changes
+//! - [`host_fetch`] — the policy every plugin request goes through
+//! - [`http_cache`] — responses shared between plugins, per `Cache-Control`
 //! - [`limits`] — fuel, epoch deadlines, memory caps
+//! - [`net_requests`] — `start-fetch` requests, run on shared worker threads
+//! - [`pool`] — pre-linked instances, warm spares, and the restart budget
 //! - [`provider`] — [`provider::WasmProvider`], which implements the SDK's
 //!   `Provider` trait by calling guest exports
 //!
@@ -22,16 +28,22 @@
 //! crates; `wasmtime` is a third-party dependency like `sdl3` or `ash`, and plugin
 //! discovery (`plugin_manifest`) and instantiation (`programs`) already live here.
 
+pub mod accounting;
+pub mod delta;
 pub mod host_fetch;
+pub mod http_cache;
 pub mod limits;
+pub mod net_requests;
+pub mod pool;
 pub mod provider;
 
+use sha2::{Digest, Sha256};
 use std::collections::HashMap;
 use std::path::{Path, PathBuf};
 use std::sync::OnceLock;
 
 use wasmtime::component::{Component, Linker};
-use wasmtime::{Config, Engine, StoreLimits};
+use wasmtime::{Config, Engine};
 
 pub use provider::WasmProvider;
 
@@ -54,6 +66,19 @@ use self::sicompass::plugin as wit;
 
 pub use self::sicompass::plugin::types as wit_types;
 
+// The optional `incremental` exports. A world of their own, looked up on an
+// instance after it is created, because a `plugin` world exporting them would
+// refuse every plugin built before they existed.
+mod incremental_bindings {
+    wasmtime::component::bindgen!({
+        path: "wit",
+        world: "incremental-plugin",
+    });
+}
+
+pub use incremental_bindings::IncrementalPlugin;
+pub use incremental_bindings::exports::sicompass::plugin::incremental as wit_incremental;
+
 /// Per-instance host state, reachable from every host function the guest calls.
 pub struct HostState {
     /// Manifest `name`. Prefixes log lines so plugin output is attributable.
@@ -72,8 +97,11 @@ pub struct HostState {
     pub allowed_hosts: Vec<String>,
     /// Allowlist, robots.txt and quota enforcement for this plugin's requests.
     pub fetch_policy: host_fetch::FetchPolicy,
-    /// Memory/table/instance caps. Wasmtime reaches this through `limiter()`.
-    pub limits: StoreLimits,
+    /// This instance's `start-fetch` requests not yet collected.
+    pub requests: net_requests::Requests,
+    /// Memory/table/instance caps, and the usage counted between two calls.
+    /// Wasmtime reaches this through `limiter()`.
+    pub meter: accounting::Meter,
 }
 
 impl HostState {
@@ -90,8 +118,9 @@ impl HostState {
             settings_section: settings_section.into(),
             plugin_dir: plugin_dir.into(),
             allowed_hosts,
+            requests: net_requests::Requests::new(fetch_policy.clone()),
             fetch_policy,
-            limits: limits::store_limits(),
+            meter: accounting::Meter::default(),
         }
     }
 
@@ -246,14 +275,19 @@ pub fn register_plugin_assets(plugin_name: &str, plugin_dir: &Path) {
 
 impl wit::host::Host for HostState {
     fn log(&mut self, msg: String) {
+        self.meter.import("log", 0);
         tracing::info!(target: "wasm_plugin", plugin = %self.plugin_name, "{msg}");
     }
 
     fn get_setting(&mut self, key: String) -> Option<String> {
-        read_plugin_setting(&self.settings_section, &key)
+        let value = read_plugin_setting(&self.settings_section, &key);
+        self.meter
+            .import("get-setting", value.as_ref().map_or(0, String::len));
+        value
     }
 
     fn now_millis(&mut self) -> u64 {
+        self.meter.import("now-millis", 0);
         std::time::SystemTime::now()
             .duration_since(std::time::UNIX_EPOCH)
             .map(|d| d.as_millis() as u64)
@@ -266,11 +300,16 @@ impl wit::host::Host for HostState {
     /// live in [`read_confined_asset`]; a refusal and a missing file both come back
     /// as `None`, so a guest cannot use this to learn what exists on the host.
     fn read_asset(&mut self, rel: String) -> Option<Vec<u8>> {
-        read_confined_asset(&self.asset_root(), &rel)
+        let asset = read_confined_asset(&self.asset_root(), &rel);
+        self.meter
+            .import("read-asset", asset.as_ref().map_or(0, Vec::len));
+        asset
     }
 
     fn translate(&mut self, key: String) -> String {
-        sicompass_sdk::localize::t(&key)
+        let text = sicompass_sdk::localize::t(&key);
+        self.meter.import("translate", text.len());
+        text
     }
 }
 
@@ -282,9 +321,7 @@ impl wit::host::Host for HostState {
 /// request is not a sandbox. Mirrors how `programs::is_plugin_enabled_in_config`
 /// reads the same file.
 fn read_plugin_setting(section: &str, key: &str) -> Option<String> {
-    let path = sicompass_sdk::platform::main_config_path()?;
-    let data = std::fs::read_to_string(&path).ok()?;
-    let root: serde_json::Value = serde_json::from_str(&data).ok()?;
+    let store = sicompass_config::settings()?;
 
     // `programs::inject_plugin_settings` registers under the manifest's
     // `displayName`, which is what `section` is. The spaces-stripped fallback
@@ -292,9 +329,9 @@ fn read_plugin_setting(section: &str, key: &str) -> Option<String> {
     // "chat client" vs "chatclient".
     let compact: String = section.chars().filter(|&c| c != ' ').collect();
     for candidate in [section, compact.as_str()] {
-        if let Some(v) = root.get(candidate).and_then(|s| s.get(key)) {
+        if let Some(v) = store.get(candidate, key) {
             return Some(match v {
-                serde_json::Value::String(s) => s.clone(),
+                serde_json::Value::String(s) => s,
                 other => other.to_string(),
             });
         }
@@ -302,6 +339,18 @@ fn read_plugin_setting(section: &str, key: &str) -> Option<String> {
     None
 }
 
+/// Everything `get_setting` could hand the plugin in `section`, as one value.
+///
+/// A warm spare ran `init` ahead of time, so whatever it read then is baked into
+/// its memory. Comparing this before and after tells [`pool`] whether that is still
+/// what the user has configured. Reads the same two sections
+/// [`read_plugin_setting`] falls back across.
+fn plugin_settings_snapshot(section: &str) -> Option<serde_json::Value> {
+    let store = sicompass_config::settings()?;
+    let compact: String = section.chars().filter(|&c| c != ' ').collect();
+    store.read(|root| serde_json::json!([root.get(section), root.get(&compact)]))
+}
+
 // ---------------------------------------------------------------------------
 // Engine
 // ---------------------------------------------------------------------------
@@ -340,6 +389,26 @@ fn engine_config() -> Config {
     config.consume_fuel(true);
     config.epoch_interruption(true);
 
+    // Name guest functions to an external sampling profiler. Off unless asked for,
+    // since it writes a map of every compiled function for the life of the process.
+    #[cfg(feature = "wasm-profiling")]
+    {
+        let strategy = match std::env::var("SICOMPASS_WASM_PROFILER").as_deref() {
+            Ok("perfmap") => Some(wasmtime::ProfilingStrategy::PerfMap),
+            Ok("jitdump") => Some(wasmtime::ProfilingStrategy::JitDump),
+            Ok("vtune") => Some(wasmtime::ProfilingStrategy::VTune),
+            Ok(other) => {
+                tracing::warn!(target: "wasm_plugin",
+                               "SICOMPASS_WASM_PROFILER={other}: expected perfmap, jitdump or vtune");
+                None
+            }
+            Err(_) => None,
+        };
+        if let Some(strategy) = strategy {
+            config.profiler(strategy);
+        }
+    }
+
     // Persist compiled components across runs. Compiling is what makes plugin
     // startup expensive — ~1.2s for a 65 KiB plugin — and `load_component`'s
     // in-process cache only removes the *repeat* cost within one launch. This
@@ -429,32 +498,63 @@ pub fn linker_for(state: &HostState) -> Result<Linker<HostState>, String> {
 
 impl wit::net::Host for HostState {
     fn fetch(&mut self, req: wit::net::HttpRequest) -> Result<wit::net::HttpResponse, String> {
-        host_fetch::perform(&mut self.fetch_policy, req)
+        let resp = host_fetch::perform(&self.fetch_policy, req);
+        self.meter
+            .import("fetch", resp.as_ref().map_or(0, |r| r.body.len()));
+        resp
     }
 
     fn fetch_url_ffon(&mut self, url: String) -> Result<Vec<u8>, String> {
-        // Deliberately routed through the same policy-checked `perform` rather than
-        // the SDK's global `fetch_url_to_ffon`. That callback is installed by
-        // lib_webbrowser and does its own fetching, so using it here would hand a
-        // plugin an unchecked way out — the one thing this module exists to prevent.
-        let resp = host_fetch::perform(
-            &mut self.fetch_policy,
-            wit::net::HttpRequest {
-                method: "GET".to_owned(),
-                url: url.clone(),
-                headers: Vec::new(),
-                body: None,
-            },
-        )?;
-
-        if !(200..300).contains(&resp.status) {
-            return Err(format!("GET {url} returned HTTP {}", resp.status));
-        }
+        let blob = fetch_url_ffon(&self.fetch_policy, &url);
+        self.meter
+            .import("fetch-url-ffon", blob.as_ref().map_or(0, Vec::len));
+        blob
+    }
+
+    fn start_fetch(&mut self, req: wit::net::HttpRequest) -> Result<wit::net::RequestId, String> {
+        self.meter.import("start-fetch", 0);
+        self.requests.start(req)
+    }
+
+    fn poll_fetch(&mut self, id: wit::net::RequestId) -> wit::net::FetchState {
+        let state = self.requests.poll(id);
+        let received = match &state {
+            wit::net::FetchState::Done(Ok(resp)) => resp.body.len(),
+            _ => 0,
+        };
+        self.meter.import("poll-fetch", received);
+        state
+    }
+
+    fn cancel_fetch(&mut self, id: wit::net::RequestId) {
+        self.meter.import("cancel-fetch", 0);
+        self.requests.cancel(id);
+    }
+}
 
-        let html = String::from_utf8_lossy(&resp.body);
-        let elements = sicompass_sdk::ffon::html_to_ffon(&html, &url);
-        Ok(sicompass_sdk::ffon::serialize_binary(&elements))
+/// `fetch-url-ffon`: GET `url` under the plugin's policy and convert the page.
+fn fetch_url_ffon(policy: &host_fetch::FetchPolicy, url: &str) -> Result<Vec<u8>, String> {
+    // Deliberately routed through the same policy-checked `perform` rather than
+    // the SDK's global `fetch_url_to_ffon`. That callback is installed by
+    // lib_webbrowser and does its own fetching, so using it here would hand a
+    // plugin an unchecked way out — the one thing this module exists to prevent.
+    let resp = host_fetch::perform(
+        policy,
+        wit::net::HttpRequest {
+            method: "GET".to_owned(),
+            url: url.to_owned(),
+            headers: Vec::new(),
+            body: None,
+        },
+    )?;
+
+    if !(200..300).contains(&resp.status) {
+        return Err(format!("GET {url} returned HTTP {}", resp.status));
     }
+
+    let html = String::from_utf8_lossy(&resp.body);
+    let elements = sicompass_sdk::ffon::html_to_ffon(&html, url);
+    Ok(sicompass_sdk::ffon::serialize_binary(&elements))
 }
 
 // ---------------------------------------------------------------------------
@@ -546,6 +646,11 @@ pub fn audit_component_imports(
 /// on disk is recompiled rather than silently served from the cache.
 type ComponentKey = (PathBuf, Option<std::time::SystemTime>, u64);
 
+fn component_key(path: &Path) -> Result<ComponentKey, String> {
+    let meta = std::fs::metadata(path).map_err(|e| format!("read {}: {e}", path.display()))?;
+    Ok((path.to_path_buf(), meta.modified().ok(), meta.len()))
+}
+
 fn component_cache() -> &'static std::sync::Mutex<HashMap<ComponentKey, Component>> {
     static CACHE: OnceLock<std::sync::Mutex<HashMap<ComponentKey, Component>>> = OnceLock::new();
     CACHE.get_or_init(|| std::sync::Mutex::new(HashMap::new()))
@@ -570,9 +675,15 @@ fn component_cache() -> &'static std::sync::Mutex<HashMap<ComponentKey, Componen
 /// several independent `Store`s is exactly the intended usage: isolation lives at
 /// the store level, not the component level, so sharing the compiled artifact costs
 /// nothing in sandboxing terms.
+///
+/// # And precompiled ahead of time
+///
+/// Across launches, a first compile is served from a [`precompile`]d artifact
+/// when there is one, which is a memory map rather than a compile. One that is
+/// missing or no longer loads is compiled here as before and written back in the
+/// background, so the launch after that is fast too.
 pub fn load_component(path: &Path) -> Result<Component, String> {
-    let meta = std::fs::metadata(path).map_err(|e| format!("read {}: {e}", path.display()))?;
-    let key: ComponentKey = (path.to_path_buf(), meta.modified().ok(), meta.len());
+    let key = component_key(path)?;
 
     if let Ok(cache) = component_cache().lock()
         && let Some(component) = cache.get(&key)
@@ -581,8 +692,15 @@ pub fn load_component(path: &Path) -> Result<Component, String> {
     }
 
     let bytes = std::fs::read(path).map_err(|e| format!("read {}: {e}", path.display()))?;
-    let component = Component::new(engine(), &bytes)
-        .map_err(|e| format!("{} is not a valid WASM component: {e}", path.display()))?;
+    let component = match load_precompiled(path, &bytes) {
+        Some(component) => component,
+        None => {
+            let component = Component::new(engine(), &bytes)
+                .map_err(|e| format!("{} is not a valid WASM component: {e}", path.display()))?;
+            save_precompiled_in_background(path, &bytes, &component);
+            component
+        }
+    };
 
     if let Ok(mut cache) = component_cache().lock() {
         cache.insert(key, component.clone());
@@ -590,6 +708,189 @@ pub fn load_component(path: &Path) -> Result<Component, String> {
     Ok(component)
 }
 
+// ---------------------------------------------------------------------------
+// Precompiled artifacts
+// ---------------------------------------------------------------------------
+
+/// Compile the component at `wasm_path` now and keep the result for
+/// [`load_component`], so the first launch that uses it does not have to.
+///
+/// Called by the updater on a staged plugin, after its signature is verified and
+/// before it is swapped in, which puts the second of Cranelift on the updater's
+/// background thread instead of on startup. Does nothing if an artifact for these
+/// bytes already exists.
+///
+/// # Not next to the `.wasm`
+///
+/// An artifact is native code, and loading one skips compilation — the step that
+/// makes a guest a guest. A plugin directory is whatever the plugin's package put
+/// there, so an artifact found in one could have been shipped rather than built
+/// here, and would run outside the sandbox. Artifacts therefore live in the app's
+/// own cache directory, which nothing but this function and [`load_component`]
+/// writes to.
+pub fn precompile(wasm_path: &Path) -> Result<(), String> {
+    let bytes =
+        std::fs::read(wasm_path).map_err(|e| format!("read {}: {e}", wasm_path.display()))?;
+    let Some(artifact) = precompiled_path(wasm_path, &bytes) else {
+        return Ok(());
+    };
+    if artifact.exists() {
+        return Ok(());
+    }
+    let compiled = engine()
+        .precompile_component(&bytes)
+        .map_err(|e| format!("{} is not a valid WASM component: {e}", wasm_path.display()))?;
+    write_precompiled(&artifact, &compiled)
+}
+
+/// Where [`precompile`] keeps the artifact for the component at `wasm_path`, or
+/// `None` with no cache directory. Exposed for tests.
+pub fn precompiled_artifact(wasm_path: &Path) -> Option<PathBuf> {
+    precompiled_path(wasm_path, &std::fs::read(wasm_path).ok()?)
+}
+
+/// `<cache>/sicompass/wasm/<engine>-<plugin>-<source>.cwasm`.
+///
+/// The source is the SHA-256 of the component's bytes, so two builds never
+/// share an artifact, and one made in the updater's staging directory is found
+/// again once the plugin is swapped into place. The engine part changes with the
+/// wasmtime version and the engine configuration — Cranelift or Pulley, fuel,
+/// epochs — any of which makes an artifact unloadable. The plugin part names the
+/// plugin the build belongs to, so [`write_precompiled`] can drop the builds it
+/// replaced.
+fn precompiled_path(wasm_path: &Path, bytes: &[u8]) -> Option<PathBuf> {
+    let dir = sicompass_sdk::platform::cache_home()?
+        .join("sicompass")
+        .join("wasm");
+    Some(dir.join(format!(
+        "{}-{}-{}.cwasm",
+        engine_fingerprint(),
+        plugin_fingerprint(wasm_path),
+        hex(&Sha256::digest(bytes))
+    )))
+}
+
+/// The plugin directory and entry file, the same for a staged build
+/// (`<name>.staging/<entry>`) as for the installed one (`<name>/<entry>`).
+fn plugin_fingerprint(wasm_path: &Path) -> String {
+    let entry = wasm_path.file_name().unwrap_or_default().to_string_lossy();
+    let dir = wasm_path
+        .parent()
+        .and_then(Path::file_name)
+        .unwrap_or_default()
+        .to_string_lossy();
+    let dir = dir.strip_suffix(".staging").unwrap_or(&dir);
+    let mut id = Sha256::new();
+    id.update(dir.as_bytes());
+    id.update(b"/");
+    id.update(entry.as_bytes());
+    hex(&id.finalize()[..8])
+}
+
+fn engine_fingerprint() -> String {
+    use std::hash::Hash;
+
+    let mut engine_hash = Sha256Hasher(Sha256::new());
+    engine()
+        .precompile_compatibility_hash()
+        .hash(&mut engine_hash);
+    hex(&engine_hash.0.finalize()[..8])
+}
+
+/// Feeds a value that only exposes `Hash` into SHA-256, which, unlike
+/// `DefaultHasher`, hashes the same in every build of the app.
+struct Sha256Hasher(Sha256);
+
+impl std::hash::Hasher for Sha256Hasher {
+    fn write(&mut self, bytes: &[u8]) {
+        self.0.update(bytes);
+    }
+
+    fn finish(&self) -> u64 {
+        let digest = self.0.clone().finalize();
+        u64::from_le_bytes(digest[..8].try_into().unwrap_or_default())
+    }
+}
+
+fn hex(bytes: &[u8]) -> String {
+    bytes.iter().map(|b| format!("{b:02x}")).collect()
+}
+
+/// The precompiled form of `bytes`, if there is one and this engine can load it.
+///
+/// The file name already matches the engine, so a refusal here means the file is
+/// damaged. It is removed, and the caller's compile writes a good one back.
+fn load_precompiled(wasm_path: &Path, bytes: &[u8]) -> Option<Component> {
+    let artifact = precompiled_path(wasm_path, bytes)?;
+    if !artifact.exists() {
+        return None;
+    }
+    // SAFETY: `deserialize_file` trusts the file to be wasmtime's own output and
+    // to stay unchanged while mapped. Only `write_precompiled` creates files in
+    // this directory, from `precompile_component` or `Component::serialize`, and
+    // it replaces them by rename rather than writing over them.
+    match unsafe { Component::deserialize_file(engine(), &artifact) } {
+        Ok(component) => Some(component),
+        Err(e) => {
+            tracing::warn!(target: "wasm_plugin", artifact = %artifact.display(),
+                           "precompiled component does not load, rebuilding: {e}");
+            let _ = std::fs::remove_file(&artifact);
+            None
+        }
+    }
+}
+
+/// Write back what `load_component` just compiled, off the caller's thread.
+fn save_precompiled_in_background(wasm_path: &Path, bytes: &[u8], component: &Component) {
+    let Some(artifact) = precompiled_path(wasm_path, bytes) else {
+        return;
+    };
+    let component = component.clone();
+    let _ = std::thread::Builder::new()
+        .name("sicompass-wasm-precompile".to_owned())
+        .spawn(move || {
+            let written = component
+                .serialize()
+                .map_err(|e| format!("serialize: {e}"))
+                .and_then(|compiled| write_precompiled(&artifact, &compiled));
+            if let Err(e) = written {
+                tracing::debug!(target: "wasm_plugin", "no precompiled artifact: {e}");
+            }
+        });
+}
+
+/// Write `compiled` to `artifact` by rename, and drop the artifacts it makes
+/// useless: any an older engine left behind, which can never load again, and
+/// the same plugin's earlier builds, which nothing will ask for again.
+fn write_precompiled(artifact: &Path, compiled: &[u8]) -> Result<(), String> {
+    let dir = artifact.parent().ok_or("artifact has no directory")?;
+    std::fs::create_dir_all(dir).map_err(|e| format!("mkdir {}: {e}", dir.display()))?;
+
+    // A per-process temporary name, so two writers never share a half-written file.
+    let tmp = artifact.with_extension(format!("cwasm.{}.tmp", std::process::id()));
+    std::fs::write(&tmp, compiled).map_err(|e| format!("write {}: {e}", tmp.display()))?;
+    if let Err(e) = std::fs::rename(&tmp, artifact) {
+        let _ = std::fs::remove_file(&tmp);
+        return Err(format!("write {}: {e}", artifact.display()));
+    }
+
+    let written = artifact.file_name().unwrap_or_default().to_string_lossy();
+    // `<engine>-<plugin>-`, the prefix every build of this plugin shares.
+    let plugin = written
+        .rsplit_once('-')
+        .map_or(String::new(), |(prefix, _)| format!("{prefix}-"));
+    let current = format!("{}-", engine_fingerprint());
+    for entry in std::fs::read_dir(dir).into_iter().flatten().flatten() {
+        let name = entry.file_name();
+        let name = name.to_string_lossy();
+        let superseded = !plugin.is_empty() && name.starts_with(&plugin) && name != written;
+        if name.ends_with(".cwasm") && (!name.starts_with(&current) || superseded) {
+            let _ = std::fs::remove_file(entry.path());
+        }
+    }
+    Ok(())
+}
+
 /// The import names this host is prepared to satisfy, as
 /// `("interface", "function")` pairs.
 ///
@@ -609,6 +910,9 @@ pub const HOST_IMPORTS: &[(&str, &str)] = &[
 pub const NET_IMPORTS: &[(&str, &str)] = &[
     ("sicompass:plugin/net", "fetch"),
     ("sicompass:plugin/net", "fetch-url-ffon"),
+    ("sicompass:plugin/net", "start-fetch"),
+    ("sicompass:plugin/net", "poll-fetch"),
+    ("sicompass:plugin/net", "cancel-fetch"),
 ];
 
 #[cfg(test)]
@@ -905,6 +1209,44 @@ mod tests {
         );
     }
 
+    #[test]
+    fn a_staged_build_and_the_installed_one_belong_to_the_same_plugin() {
+        let live = plugin_fingerprint(Path::new("/plugins/weather/plugin.wasm"));
+        assert_eq!(
+            live,
+            plugin_fingerprint(Path::new("/plugins/weather.staging/plugin.wasm"))
+        );
+        assert_ne!(
+            live,
+            plugin_fingerprint(Path::new("/plugins/news/plugin.wasm"))
+        );
+    }
+
+    #[test]
+    fn writing_a_build_drops_the_ones_it_supersedes() {
+        let dir = tempfile::tempdir().unwrap();
+        let engine = engine_fingerprint();
+        let weather = plugin_fingerprint(Path::new("/plugins/weather/plugin.wasm"));
+        let news = plugin_fingerprint(Path::new("/plugins/news/plugin.wasm"));
+        let artifact = |plugin: &str, source: &str| {
+            dir.path().join(format!("{engine}-{plugin}-{source}.cwasm"))
+        };
+        let old_engine = dir.path().join(format!("0000000000000000-{news}-aa.cwasm"));
+        std::fs::write(&old_engine, b"").unwrap();
+        std::fs::write(artifact(&news, "aa"), b"").unwrap();
+
+        write_precompiled(&artifact(&weather, "aa"), b"v1").unwrap();
+        write_precompiled(&artifact(&weather, "bb"), b"v2").unwrap();
+
+        assert!(!artifact(&weather, "aa").exists(), "the earlier build goes");
+        assert_eq!(std::fs::read(artifact(&weather, "bb")).unwrap(), b"v2");
+        assert!(
+            artifact(&news, "aa").exists(),
+            "another plugin's build stays"
+        );
+        assert!(!old_engine.exists());
+    }
+
     // --- settings scoping ---
 
     // --- settings scoping ---
@@ -975,6 +1317,6 @@ mod tests {
                 .all(|(i, _)| *i == "sicompass:plugin/net")
         );
         assert_eq!(HOST_IMPORTS.len(), 5);
-        assert_eq!(NET_IMPORTS.len(), 2);
+        assert_eq!(NET_IMPORTS.len(), 5);
     }
 }
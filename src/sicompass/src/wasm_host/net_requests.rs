@@ -0,0 +1,357 @@
+//! Plugin requests that run while the guest gets on with its frame.
+//!
+//! `net.fetch` answers within the guest call that made it, so the render thread
+//! driving that call waits for the network: up to the whole request timeout for a
+//! slow server. `start-fetch` instead hands the request to a shared pool of
+//! worker threads and returns an id at once; the guest asks after it with
+//! `poll-fetch`, typically from its per-frame `poll()`, and gets `pending` until
+//! the answer is in.
+//!
+//! The requests go through [`host_fetch::perform`] exactly like a blocking
+//! `fetch`: the same allowlist, robots.txt, quota, redirect checks and HTTP
+//! cache, and the same client, so the workers share its connection pool.
+//!
+//! ## Limits
+//!
+//! A plugin may have [`MAX_OUTSTANDING`] requests started and not yet collected,
+//! across all its instances. That bounds both the connections it holds open and
+//! the response bodies waiting in host memory for it to ask. A request counts
+//! until the guest collects its answer or cancels it, and a start beyond the
+//! limit is refused rather than queued, the way a spent quota is.
+//!
+//! The limit is a quarter of the worker pool, so a plugin waiting on slow
+//! servers holds at most that share of the workers and the others' requests
+//! still find one free.
+
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::mpsc::{Receiver, Sender, channel};
+use std::sync::{Arc, Mutex, OnceLock};
+
+use super::host_fetch::{self, FetchPolicy};
+use super::wit::net::{FetchState, HttpRequest, HttpResponse, RequestId};
+
+/// Requests one plugin may have started and not yet collected.
+pub const MAX_OUTSTANDING: usize = WORKERS / 4;
+
+/// Worker threads shared by every plugin. A request mostly waits on the network,
+/// so this is about how many sites can be waited on at once, not about cores.
+const WORKERS: usize = 16;
+
+type Job = Box<dyn FnOnce() + Send>;
+
+fn queue() -> &'static Sender<Job> {
+    static QUEUE: OnceLock<Sender<Job>> = OnceLock::new();
+    QUEUE.get_or_init(|| {
+        let (tx, rx) = channel::<Job>();
+        let rx = Arc::new(Mutex::new(rx));
+        for i in 0..WORKERS {
+            let rx = Arc::clone(&rx);
+            // A worker that fails to start leaves the others to drain the queue.
+            let _ = std::thread::Builder::new()
+                .name(format!("sicompass-plugin-net-{i}"))
+                .spawn(move || work(&rx));
+        }
+        tx
+    })
+}
+
+fn work(rx: &Mutex<Receiver<Job>>) {
+    loop {
+        // Hold the lock only to take a job, not while running it.
+        let job = rx.lock().unwrap_or_else(|e| e.into_inner()).recv();
+        match job {
+            Ok(job) => job(),
+            Err(_) => return,
+        }
+    }
+}
+
+/// Outstanding-request counters, one per plugin name.
+fn outstanding(plugin: &str) -> Arc<AtomicUsize> {
+    static COUNTS: OnceLock<Mutex<HashMap<String, Arc<AtomicUsize>>>> = OnceLock::new();
+    let mut counts = COUNTS
+        .get_or_init(Default::default)
+        .lock()
+        .unwrap_or_else(|e| e.into_inner());
+    Arc::clone(counts.entry(plugin.to_owned()).or_default())
+}
+
+/// One request's place in its plugin's [`MAX_OUTSTANDING`]; released on drop.
+struct Permit(Arc<AtomicUsize>);
+
+impl Permit {
+    fn take(count: &Arc<AtomicUsize>, plugin: &str) -> Result<Self, String> {
+        count
+            .fetch_update(Ordering::AcqRel, Ordering::Acquire, |n| {
+                (n < MAX_OUTSTANDING).then_some(n + 1)
+            })
+            .map(|_| Permit(Arc::clone(count)))
+            .map_err(|_| {
+                format!(
+                    "plugin `{plugin}` already has {MAX_OUTSTANDING} requests outstanding; \
+                     collect or cancel one first"
+                )
+            })
+    }
+}
+
+impl Drop for Permit {
+    fn drop(&mut self) {
+        self.0.fetch_sub(1, Ordering::AcqRel);
+    }
+}
+
+/// A request, shared by the guest's table and the worker running it.
+#[derive(Default)]
+struct Slot {
+    answer: Mutex<Option<Result<HttpResponse, String>>>,
+    cancelled: AtomicBool,
+}
+
+/// One instance's requests in flight.
+///
+/// Lives in [`super::HostState`], so an instance that is dropped or restarted
+/// forgets its requests and frees their places in the limit; a worker still
+/// running one finishes into a slot no one reads.
+pub struct Requests {
+    policy: FetchPolicy,
+    outstanding: Arc<AtomicUsize>,
+    slots: HashMap<RequestId, (Arc<Slot>, Permit)>,
+    next_id: RequestId,
+}
+
+impl Requests {
+    pub fn new(policy: FetchPolicy) -> Self {
+        Requests {
+            outstanding: outstanding(policy.plugin_name()),
+            policy,
+            slots: HashMap::new(),
+            next_id: 1,
+        }
+    }
+
+    /// Queue `req` and return its id, or refuse it now if it can never succeed
+    /// or the plugin is at its limit.
+    pub fn start(&mut self, req: HttpRequest) -> Result<RequestId, String> {
+        host_fetch::vet_request(&self.policy, &req)?;
+        let permit = Permit::take(&self.outstanding, self.policy.plugin_name())?;
+
+        let slot = Arc::new(Slot::default());
+        let id = self.next_id;
+        self.next_id += 1;
+        self.slots.insert(id, (Arc::clone(&slot), permit));
+
+        let policy = self.policy.clone();
+        #[cfg(test)]
+        let allow_internal = host_fetch::ALLOW_INTERNAL_FOR_TESTS.with(|c| c.get());
+        let job: Job = Box::new(move || {
+            #[cfg(test)]
+            host_fetch::ALLOW_INTERNAL_FOR_TESTS.with(|c| c.set(allow_internal));
+            if slot.cancelled.load(Ordering::Acquire) {
+                return;
+            }
+            let answer = host_fetch::perform(&policy, req);
+            *slot.answer.lock().unwrap_or_else(|e| e.into_inner()) = Some(answer);
+        });
+        if queue().send(job).is_err() {
+            self.slots.remove(&id);
+            return Err("no network worker is running".to_owned());
+        }
+        Ok(id)
+    }
+
+    /// Where request `id` stands. `done` is reported once; the id is then
+    /// forgotten and its place in the limit freed.
+    pub fn poll(&mut self, id: RequestId) -> FetchState {
+        let Some((slot, _)) = self.slots.get(&id) else {
+            return FetchState::Unknown;
+        };
+        let answer = slot.answer.lock().unwrap_or_else(|e| e.into_inner()).take();
+        match answer {
+            Some(answer) => {
+                self.slots.remove(&id);
+                FetchState::Done(answer)
+            }
+            None => FetchState::Pending,
+        }
+    }
+
+    /// Forget request `id`. One not yet started is never sent; one already on
+    /// the wire runs to the end, unread.
+    pub fn cancel(&mut self, id: RequestId) {
+        if let Some((slot, _)) = self.slots.remove(&id) {
+            slot.cancelled.store(true, Ordering::Release);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn requests(plugin: &str, hosts: &[&str]) -> Requests {
+        let hosts: Vec<String> = hosts.iter().map(|h| (*h).to_owned()).collect();
+        Requests::new(FetchPolicy::new(plugin, &hosts))
+    }
+
+    fn get(url: &str) -> HttpRequest {
+        HttpRequest {
+            method: "GET".to_owned(),
+            url: url.to_owned(),
+            headers: Vec::new(),
+            body: None,
+        }
+    }
+
+    #[test]
+    fn a_request_that_can_never_succeed_is_refused_at_the_start() {
+        let mut r = requests("net-requests-refused", &["a.test"]);
+        let err = r.start(get("https://elsewhere.test/")).unwrap_err();
+        assert!(err.contains("allowedHosts"), "{err}");
+        let mut post = get("https://a.test/");
+        post.method = "DELETE".to_owned();
+        assert!(r.start(post).is_err());
+        // Neither took a place in the limit.
+        assert_eq!(r.outstanding.load(Ordering::Acquire), 0);
+    }
+
+    #[test]
+    fn an_unknown_id_is_reported_as_such() {
+        let mut r = requests("net-requests-unknown", &["a.test"]);
+        assert!(matches!(r.poll(42), FetchState::Unknown));
+        r.cancel(42);
+    }
+
+    #[test]
+    fn permits_stop_at_the_limit_and_come_back_when_dropped() {
+        let count = outstanding("net-requests-permits");
+        let permits: Vec<Permit> = (0..MAX_OUTSTANDING)
+            .map(|_| Permit::take(&count, "p").unwrap())
+            .collect();
+        let err = Permit::take(&count, "p").err().unwrap();
+        assert!(err.contains("outstanding"), "{err}");
+        drop(permits);
+        assert_eq!(count.load(Ordering::Acquire), 0);
+        assert!(Permit::take(&count, "p").is_ok());
+    }
+
+    #[test]
+    fn one_plugin_at_its_limit_leaves_most_workers_free() {
+        assert!(MAX_OUTSTANDING >= 1);
+        assert!(MAX_OUTSTANDING * 3 <= WORKERS);
+    }
+
+    // -----------------------------------------------------------------------
+    // Against a live server
+    // -----------------------------------------------------------------------
+    mod live {
+        use super::*;
+        use std::time::{Duration, Instant};
+        use wiremock::matchers::{method, path};
+        use wiremock::{Mock, MockServer, ResponseTemplate};
+
+        /// See `host_fetch`'s live tests: reach 127.0.0.1 from this thread (and
+        /// so from the workers it starts), and forget what an earlier server on
+        /// the same port left in the robots.txt cache.
+        fn for_server(plugin: &str, server: &MockServer) -> Requests {
+            host_fetch::ALLOW_INTERNAL_FOR_TESTS.with(|c| c.set(true));
+            host_fetch::forget_robots(&server.uri());
+            let host = reqwest::Url::parse(&server.uri())
+                .unwrap()
+                .host_str()
+                .unwrap()
+                .to_owned();
+            requests(plugin, &[host.as_str()])
+        }
+
+        async fn serve(server: &MockServer, at: &str, response: ResponseTemplate) {
+            Mock::given(method("GET"))
+                .and(path("/robots.txt"))
+                .respond_with(ResponseTemplate::new(404))
+                .mount(server)
+                .await;
+            Mock::given(method("GET"))
+                .and(path(at))
+                .respond_with(response)
+                .mount(server)
+                .await;
+        }
+
+        /// Poll until the request is done, the way a guest would from `poll()`.
+        fn wait(r: &mut Requests, id: RequestId) -> Result<HttpResponse, String> {
+            let deadline = Instant::now() + Duration::from_secs(10);
+            loop {
+                match r.poll(id) {
+                    FetchState::Done(answer) => return answer,
+                    FetchState::Pending if Instant::now() < deadline => {
+                        std::thread::sleep(Duration::from_millis(5));
+                    }
+                    FetchState::Pending => panic!("request {id} never finished"),
+                    FetchState::Unknown => panic!("request {id} was forgotten"),
+                }
+            }
+        }
+
+        #[tokio::test(flavor = "multi_thread")]
+        async fn start_returns_at_once_and_poll_delivers_the_answer() {
+            let server = MockServer::start().await;
+            serve(
+                &server,
+                "/slow",
+                ResponseTemplate::new(200)
+                    .set_body_string("late")
+                    .set_delay(Duration::from_millis(300)),
+            )
+            .await;
+
+            let mut r = for_server("net-requests-live-slow", &server);
+            let started = Instant::now();
+            let id = r.start(get(&format!("{}/slow", server.uri()))).unwrap();
+            assert!(
+                started.elapsed() < Duration::from_millis(200),
+                "start waited for the response"
+            );
+            assert!(matches!(r.poll(id), FetchState::Pending));
+
+            let resp = wait(&mut r, id).unwrap();
+            assert_eq!(String::from_utf8_lossy(&resp.body), "late");
+            // Reported once.
+            assert!(matches!(r.poll(id), FetchState::Unknown));
+        }
+
+        #[tokio::test(flavor = "multi_thread")]
+        async fn requests_beyond_the_limit_are_refused_until_one_is_collected() {
+            let server = MockServer::start().await;
+            serve(
+                &server,
+                "/x",
+                ResponseTemplate::new(200).set_delay(Duration::from_millis(200)),
+            )
+            .await;
+
+            let mut r = for_server("net-requests-live-limit", &server);
+            let url = format!("{}/x", server.uri());
+            let ids: Vec<RequestId> = (0..MAX_OUTSTANDING)
+                .map(|_| r.start(get(&url)).unwrap())
+                .collect();
+            let err = r.start(get(&url)).unwrap_err();
+            assert!(err.contains("outstanding"), "{err}");
+
+            // A finished answer still holds its place until the guest takes it.
+            wait(&mut r, ids[0]).unwrap();
+            assert!(r.start(get(&url)).is_ok());
+        }
+
+        #[tokio::test(flavor = "multi_thread")]
+        async fn a_cancelled_request_is_forgotten() {
+            let server = MockServer::start().await;
+            serve(&server, "/x", ResponseTemplate::new(200)).await;
+
+            let mut r = for_server("net-requests-live-cancel", &server);
+            let id = r.start(get(&format!("{}/x", server.uri()))).unwrap();
+            r.cancel(id);
+            assert!(matches!(r.poll(id), FetchState::Unknown));
+        }
+    }
+}
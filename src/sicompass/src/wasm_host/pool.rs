@@ -0,0 +1,285 @@
+//! Pre-linked plugin instances, kept warm so opening a plugin and restarting a
+//! trapped one skip most of the work.
+//!
+//! [`super::load_component`] already takes compilation out of the repeat cost.
+//! What it leaves is per instance: building a linker, resolving and type-checking
+//! every import against it, instantiating, and running the guest's `init`. A
+//! [`Pool`] does the linking once per plugin, as a [`PluginPre`], and keeps one
+//! spare instance that has already been through `init`. Whoever needs an instance
+//! next — a new tab opening the plugin, or a provider replacing one that trapped —
+//! takes the spare and only pays for `describe`, and a fresh spare is made on a
+//! background thread.
+//!
+//! ## Not a memory snapshot
+//!
+//! Wasmtime cannot copy a live instance's state into another store, so the
+//! "snapshot" a restart resumes from is this spare: an instance made ahead of time
+//! by running `init` for real, in the state a freshly opened plugin would be in.
+//! The provider then puts the guest back at the path the user was on. Anything
+//! else the guest held in memory is gone, as it would be after relaunching the app.
+//!
+//! ## When there is no spare
+//!
+//! - **A plugin with network access.** Its `init` may fetch, and a spare nobody
+//!   has asked for yet must not reach the network on the user's behalf.
+//! - **A plugin whose settings changed** since the spare was made. The spare's
+//!   `init` saw the old values, so it is dropped and a new instance initialised
+//!   instead.
+//! - **A plugin that was disabled.** [`release`] drops its pool and spare; a
+//!   provider still finishing with it makes no new one.
+//!
+//! Either way the pre-linked [`PluginPre`] is still used, so the fallback is an
+//! instantiate and an `init`, not a relink.
+
+use std::collections::HashMap;
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
+use std::time::{Duration, Instant};
+
+use wasmtime::Store;
+use wasmtime::component::Component;
+
+use super::{ComponentKey, HostState, IncrementalPlugin, Plugin, PluginPre, accounting, limits};
+
+/// Restarts a provider may make within [`RESTART_WINDOW`] before a trap disables
+/// it instead.
+///
+/// A plugin that traps on a rare input deserves to come back; one that traps on
+/// every frame would otherwise restart sixty times a second and hide the fault
+/// behind a flickering view.
+pub const MAX_RESTARTS: usize = 3;
+
+/// The window [`MAX_RESTARTS`] is counted over.
+pub const RESTART_WINDOW: Duration = Duration::from_secs(60);
+
+/// A store and the guest instantiated into it.
+pub struct Instance {
+    pub store: Store<HostState>,
+    pub instance: Plugin,
+    /// The optional `incremental` exports, when the guest has them.
+    pub incremental: Option<IncrementalPlugin>,
+}
+
+/// A spare that has run `init`, and the settings it ran with.
+struct Spare {
+    ready: Instance,
+    settings: Option<serde_json::Value>,
+}
+
+/// One plugin, linked once, with at most one warm spare.
+pub struct Pool {
+    pre: PluginPre<HostState>,
+    plugin_name: String,
+    settings_section: String,
+    plugin_dir: PathBuf,
+    allowed_hosts: Vec<String>,
+    spare: Mutex<Option<Spare>>,
+    /// Set while a background refill is running, so a burst of takers starts one.
+    filling: AtomicBool,
+    /// Set by [`release`]: the plugin was disabled, so no spare is kept.
+    retired: AtomicBool,
+}
+
+/// `(component, plugin name, settings section, plugin dir, allowed hosts)`: every
+/// input to a [`HostState`], since a spare's host state is fixed when it is made.
+type PoolKey = (ComponentKey, String, String, PathBuf, Vec<String>);
+
+fn pools() -> &'static Mutex<HashMap<PoolKey, Arc<Pool>>> {
+    static POOLS: OnceLock<Mutex<HashMap<PoolKey, Arc<Pool>>>> = OnceLock::new();
+    POOLS.get_or_init(|| Mutex::new(HashMap::new()))
+}
+
+/// The shared pool for the plugin at `wasm_path`, created on first use.
+///
+/// `component` must be what [`super::load_component`] returned for `wasm_path`.
+/// A pool for an older build of the same file is dropped, so an updated plugin
+/// does not keep its predecessor's spare alive.
+pub fn for_plugin(
+    wasm_path: &Path,
+    component: &Component,
+    plugin_name: &str,
+    settings_section: &str,
+    plugin_dir: &Path,
+    allowed_hosts: &[String],
+) -> Result<Arc<Pool>, String> {
+    let key: PoolKey = (
+        super::component_key(wasm_path)?,
+        plugin_name.to_owned(),
+        settings_section.to_owned(),
+        plugin_dir.to_path_buf(),
+        allowed_hosts.to_vec(),
+    );
+
+    let mut pools = pools().lock().expect("pools mutex");
+    if let Some(pool) = pools.get(&key) {
+        return Ok(Arc::clone(pool));
+    }
+    let pool = Arc::new(Pool::new(
+        component,
+        plugin_name,
+        settings_section,
+        plugin_dir,
+        allowed_hosts.to_vec(),
+    )?);
+    pools.retain(|k, _| k.0.0 != key.0.0 || k.0 == key.0);
+    pools.insert(key, Arc::clone(&pool));
+    Ok(pool)
+}
+
+/// Drop the pools of the plugin named `plugin_name`, and their spares with
+/// them, now that it has been disabled.
+///
+/// A provider still holding one keeps it for as long as it lives, but no new
+/// spare is made for it; enabling the plugin again links a new pool.
+pub fn release(plugin_name: &str) {
+    let released: Vec<Arc<Pool>> = {
+        let mut pools = pools().lock().expect("pools mutex");
+        let keys: Vec<PoolKey> = pools
+            .keys()
+            .filter(|k| k.1 == plugin_name)
+            .cloned()
+            .collect();
+        keys.iter().filter_map(|k| pools.remove(k)).collect()
+    };
+    // Outside the map's lock: dropping a store can take a while.
+    for pool in released {
+        pool.retired.store(true, Ordering::Release);
+        drop(pool.spare.lock().expect("spare mutex").take());
+    }
+}
+
+impl Pool {
+    /// Link `component` for one plugin. Nothing is instantiated yet.
+    ///
+    /// Instantiation is where a missing import surfaces, and `instantiate_pre` is
+    /// where it is checked: a component that references `sicompass:plugin/net`
+    /// without `allowedHosts` fails right here, which is the enforcement point for
+    /// the whole capability model.
+    pub fn new(
+        component: &Component,
+        plugin_name: &str,
+        settings_section: &str,
+        plugin_dir: &Path,
+        allowed_hosts: Vec<String>,
+    ) -> Result<Self, String> {
+        let state = HostState::new(plugin_name, settings_section, plugin_dir, allowed_hosts);
+        let linker = super::linker_for(&state)?;
+        let pre = linker
+            .instantiate_pre(component)
+            .and_then(PluginPre::new)
+            .map_err(|e| format!("instantiate {plugin_name}: {e}"))?;
+
+        Ok(Pool {
+            pre,
+            plugin_name: state.plugin_name,
+            settings_section: state.settings_section,
+            plugin_dir: state.plugin_dir,
+            allowed_hosts: state.allowed_hosts,
+            spare: Mutex::new(None),
+            filling: AtomicBool::new(false),
+            retired: AtomicBool::new(false),
+        })
+    }
+
+    /// An instance that has run `init`: the spare if it is still good, otherwise a
+    /// new one initialised here.
+    ///
+    /// A trap during `init` comes back as `Err`; the caller decides whether that
+    /// means the plugin fails to open or a restart failed.
+    pub fn ready(self: &Arc<Self>) -> Result<Instance, String> {
+        let spare = self.spare.lock().expect("spare mutex").take();
+        self.refill();
+        if let Some(spare) = spare
+            && spare.settings == super::plugin_settings_snapshot(&self.settings_section)
+        {
+            return Ok(spare.ready);
+        }
+        self.initialised()
+    }
+
+    /// Instantiate and run `init`, on the caller's thread.
+    fn initialised(&self) -> Result<Instance, String> {
+        let state = HostState::new(
+            self.plugin_name.as_str(),
+            self.settings_section.as_str(),
+            self.plugin_dir.as_path(),
+            self.allowed_hosts.clone(),
+        );
+        let mut store = Store::new(super::engine(), state);
+        // Wire the memory/table/instance caps. `limiter` takes a closure pulling the
+        // limiter out of store data, which is why `HostState` owns it.
+        store.limiter(|s: &mut HostState| &mut s.meter);
+        limits::refresh_for_call(&mut store)?;
+
+        let instantiated = self
+            .pre
+            .instance_pre()
+            .instantiate(&mut store)
+            .map_err(|e| format!("instantiate {}: {e}", self.plugin_name))?;
+        let instance = Plugin::new(&mut store, &instantiated)
+            .map_err(|e| format!("instantiate {}: {e}", self.plugin_name))?;
+        // Absent in any plugin built before the interface existed, which is fine.
+        let incremental = IncrementalPlugin::new(&mut store, &instantiated).ok();
+
+        limits::refresh_for_call(&mut store)?;
+        let started = Instant::now();
+        let init = instance.sicompass_plugin_provider().call_init(&mut store);
+        accounting::record_call(&mut store, "init", started, init.is_err());
+        init.map_err(|e| super::provider::describe_trap("init", &self.plugin_name, &e))?;
+
+        Ok(Instance {
+            store,
+            instance,
+            incremental,
+        })
+    }
+
+    /// Make a new spare in the background, unless one exists, one is on its way,
+    /// or this plugin may not have one (see the module docs).
+    fn refill(self: &Arc<Self>) {
+        if !self.allowed_hosts.is_empty()
+            || self.retired.load(Ordering::Acquire)
+            || self.spare.lock().expect("spare mutex").is_some()
+            || self.filling.swap(true, Ordering::AcqRel)
+        {
+            return;
+        }
+
+        let pool = Arc::clone(self);
+        let spawned = std::thread::Builder::new()
+            .name("sicompass-wasm-spare".to_owned())
+            .spawn(move || {
+                let settings = super::plugin_settings_snapshot(&pool.settings_section);
+                match pool.initialised() {
+                    Ok(ready) => {
+                        let mut spare = pool.spare.lock().expect("spare mutex");
+                        // Released while this ran: the instance goes with the thread.
+                        if !pool.retired.load(Ordering::Acquire) {
+                            *spare = Some(Spare { ready, settings });
+                        }
+                    }
+                    // Not the user's problem yet: the next taker initialises on its
+                    // own thread and reports the same failure where it can be seen.
+                    Err(e) => {
+                        tracing::debug!(target: "wasm_plugin", plugin = %pool.plugin_name,
+                                        "no spare instance: {e}");
+                    }
+                }
+                pool.filling.store(false, Ordering::Release);
+            });
+        if spawned.is_err() {
+            self.filling.store(false, Ordering::Release);
+        }
+    }
+
+    /// The manifest name this pool's instances are accounted under.
+    pub fn plugin_name(&self) -> &str {
+        &self.plugin_name
+    }
+
+    /// Whether a warm spare is waiting. For tests and profiling.
+    pub fn has_spare(&self) -> bool {
+        self.spare.lock().expect("spare mutex").is_some()
+    }
+}
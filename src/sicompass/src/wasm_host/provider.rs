@@ -10,14 +10,19 @@
 //!
 //! 1. re-arms fuel and the epoch deadline ([`super::limits::refresh_for_call`]),
 //! 2. runs the guest export,
-//! 3. on `Trap` records the message for `take_error()` and **poisons** the provider.
+//! 3. on `Trap` records the message for `take_error()` and **restarts** the guest,
+//!    or **poisons** the provider once its restart budget is spent.
 //!
-//! Poisoning is deliberate. After a trap the guest's linear memory is in an
-//! arbitrary state, so continuing to call it would produce garbage rather than
-//! errors. A poisoned provider answers every later call the way an inert provider
-//! would and keeps surfacing its error, so the user sees a broken plugin instead of
-//! a broken app. This mirrors how a failed load already logs and skips in
-//! `programs::load_user_plugins`.
+//! The trapped instance is never called again either way. After a trap the guest's
+//! linear memory is in an arbitrary state, so continuing to call it would produce
+//! garbage rather than errors. A restart swaps in a fresh instance from the
+//! plugin's [`super::pool`], put back at the path the user was on; the call that
+//! trapped still fails, so nothing pretends it succeeded. More than
+//! [`MAX_RESTARTS`] in [`RESTART_WINDOW`] means the fault is not a rare input, and
+//! the provider is poisoned instead: it answers every later call the way an inert
+//! provider would and surfaces its error once, so the user sees a broken plugin
+//! instead of a broken app. This mirrors how a failed load already logs and skips
+//! in `programs::load_user_plugins`.
 //!
 //! ## Batched reads
 //!
@@ -28,6 +33,15 @@
 //! whose result is cached here, and those five trait methods read the cache.
 //! `describe()` does the same for values that never change.
 //!
+//! ## Incremental trees
+//!
+//! A guest exporting the optional `incremental` interface sends `fetch` as the
+//! change since the last generation the host saw, and receives body-children
+//! syncs as a splice rather than the whole list. The host keeps its copy of the
+//! fetched tree here and patches it (see [`super::delta`]). Anything that
+//! breaks the chain — a patch that does not apply, navigation, a restart —
+//! drops the copy, and the next fetch asks for everything.
+//!
 //! ## Why `RefCell`
 //!
 //! Five trait methods (`commands`, `command_label`, `command_list_items`,
@@ -41,8 +55,10 @@
 //! conflicting borrow. `borrow_mut` is still handled without panicking, so a future
 //! re-entrant host function degrades to an error rather than aborting.
 
-use std::cell::RefCell;
+use std::cell::{RefCell, RefMut};
 use std::path::Path;
+use std::sync::Arc;
+use std::time::Instant;
 
 use sicompass_sdk::{
     CellAttrs, DashboardCell, DashboardFrame, DashboardKey, DashboardKeysym, DashboardKind,
@@ -53,22 +69,43 @@ use wasmtime::Store;
 use wasmtime::component::Component;
 
 use super::exports::sicompass::plugin::provider::Guest;
-use super::{HostState, Plugin, confine_in, limits, wit_types};
+use super::pool::{self, MAX_RESTARTS, Pool, RESTART_WINDOW};
+use super::wit_incremental::{FfonChange, FfonDelta, FfonPatch};
+use super::{
+    HostState, IncrementalPlugin, Plugin, accounting, confine_in, delta, limits, wit_types,
+};
 
 /// The parts that a guest call mutates.
 struct Inner {
     store: Store<HostState>,
     instance: Plugin,
+    /// The optional `incremental` exports, when this guest has them.
+    incremental: Option<IncrementalPlugin>,
+    /// The host's copy of the last fetched tree, for `fetch-since` to patch.
+    fetched: Option<Generation>,
+    /// The body children last synced to the guest, for `sync-body-patches`.
+    synced_body: Option<Generation>,
     /// Errors waiting to be surfaced as a row: guest-reported, or a trap.
     pending_error: Option<String>,
-    /// Set after a trap. All further guest calls are skipped.
+    /// Set after a trap with no restart left. All further guest calls are skipped.
     poisoned: bool,
+    /// When each restart within the last [`RESTART_WINDOW`] happened.
+    restarts: Vec<Instant>,
+}
+
+/// A tree as the guest had it at `generation`.
+struct Generation {
+    generation: u64,
+    tree: Vec<FfonElement>,
 }
 
 /// A WASM component driven through the `Provider` trait.
 pub struct WasmProvider {
     inner: RefCell<Inner>,
 
+    /// Where replacement instances come from after a trap.
+    pool: Arc<Pool>,
+
     /// Constant guest properties, fetched once via `describe()`.
     descriptor: wit_types::Descriptor,
 
@@ -115,17 +152,23 @@ impl WasmProvider {
         super::audit_component_imports(&component, &allowed_hosts)
             .map_err(|e| format!("{}: {e}", wasm_path.display()))?;
 
-        Self::from_component(
+        // Shared with every other tab that opens this plugin, so after the first
+        // open there is usually a spare that has already run `init`.
+        let pool = pool::for_plugin(
+            wasm_path,
             &component,
             plugin_name,
             settings_section,
             plugin_dir,
-            allowed_hosts,
-        )
+            &allowed_hosts,
+        )?;
+        Self::from_pool(pool, plugin_name, plugin_dir)
     }
 
     /// Instantiate an already-parsed component. Split out so tests can build a
     /// component once and instantiate it repeatedly.
+    ///
+    /// Links afresh and keeps no spare, so this is the cold path `open` avoids.
     pub fn from_component(
         component: &Component,
         plugin_name: &str,
@@ -133,36 +176,42 @@ impl WasmProvider {
         plugin_dir: &Path,
         allowed_hosts: Vec<String>,
     ) -> Result<Self, String> {
-        let state = HostState::new(plugin_name, settings_section, plugin_dir, allowed_hosts);
-        let linker = super::linker_for(&state)?;
-
-        let mut store = Store::new(super::engine(), state);
-        // Wire the memory/table/instance caps. `limiter` takes a closure pulling the
-        // limiter out of store data, which is why `HostState` owns it.
-        store.limiter(|s: &mut HostState| &mut s.limits);
-        limits::refresh_for_call(&mut store)?;
+        let pool = Pool::new(
+            component,
+            plugin_name,
+            settings_section,
+            plugin_dir,
+            allowed_hosts,
+        )?;
+        Self::from_pool(Arc::new(pool), plugin_name, plugin_dir)
+    }
 
-        // Instantiation is where a missing import surfaces: a component that
-        // references `sicompass:plugin/net` without `allowedHosts` fails right here,
-        // which is the enforcement point for the whole capability model.
-        let instance = Plugin::instantiate(&mut store, component, &linker)
-            .map_err(|e| format!("instantiate {plugin_name}: {e}"))?;
+    fn from_pool(pool: Arc<Pool>, plugin_name: &str, plugin_dir: &Path) -> Result<Self, String> {
+        // `init` before `describe`, so a plugin can compute its display name.
+        let pool::Instance {
+            store,
+            instance,
+            incremental,
+        } = pool.ready()?;
 
         let me = WasmProvider {
             inner: RefCell::new(Inner {
                 store,
                 instance,
+                incremental,
+                fetched: None,
+                synced_body: None,
                 pending_error: None,
                 poisoned: false,
+                restarts: Vec::new(),
             }),
+            pool,
             descriptor: default_descriptor(plugin_name),
             current_path: "/".to_owned(),
             polled: default_poll(),
             dashboard_image: None,
         };
 
-        // `init` before `describe`, so a plugin can compute its display name.
-        me.call("init", |g, s| g.call_init(s))?;
         let descriptor = me.call("describe", |g, s| g.call_describe(s))?;
 
         // Publish this plugin's `assets/` directory under its manifest name, so
@@ -257,6 +306,34 @@ impl WasmProvider {
         &self,
         what: &str,
         f: impl FnOnce(&Guest, &mut Store<HostState>) -> wasmtime::Result<T>,
+    ) -> Result<T, String> {
+        self.call_raw(what, |inner| {
+            // Disjoint field borrows: `guest` reads `instance`, and `store` is separate.
+            let guest = inner.instance.sicompass_plugin_provider();
+            f(guest, &mut inner.store)
+        })
+    }
+
+    /// [`Self::call`] for an `incremental` export. `Ok(None)` when the guest does
+    /// not have the interface, so the caller uses the `provider` export instead.
+    fn call_incremental<T>(
+        &self,
+        what: &str,
+        f: impl FnOnce(&super::wit_incremental::Guest, &mut Store<HostState>) -> wasmtime::Result<T>,
+    ) -> Result<Option<T>, String> {
+        self.call_raw(what, |inner| match &inner.incremental {
+            Some(incremental) => {
+                f(incremental.sicompass_plugin_incremental(), &mut inner.store).map(Some)
+            }
+            None => Ok(None),
+        })
+    }
+
+    /// The trap containment behind [`Self::call`] and [`Self::call_incremental`].
+    fn call_raw<T>(
+        &self,
+        what: &str,
+        f: impl FnOnce(&mut Inner) -> wasmtime::Result<T>,
     ) -> Result<T, String> {
         let Ok(mut guard) = self.inner.try_borrow_mut() else {
             // Unreachable today (no host function re-enters the provider). Degrading
@@ -281,26 +358,90 @@ impl WasmProvider {
             return Err(msg);
         }
 
-        // Disjoint field borrows: `guest` reads `instance`, and `store` is separate.
-        let guest = inner.instance.sicompass_plugin_provider();
-        match f(guest, &mut inner.store) {
+        let started = Instant::now();
+        let result = f(inner);
+        accounting::record_call(&mut inner.store, what, started, result.is_err());
+
+        match result {
             Ok(v) => Ok(v),
             Err(e) => {
                 // Fuel exhaustion, epoch deadline, memory cap and guest panic all
                 // arrive here. The distinction matters for the message, not the
                 // handling: the instance is unusable either way.
-                let msg = describe_trap(what, &self.descriptor.name, &e);
-                poison(inner, &self.descriptor.name, msg.clone());
+                let trap = describe_trap(what, &self.descriptor.name, &e);
+                let msg = match self.restart(inner) {
+                    Ok(()) => {
+                        let msg = format!("{trap}; it was restarted");
+                        tracing::warn!(target: "wasm_plugin", plugin = %self.descriptor.name, "{msg}");
+                        if inner.pending_error.is_none() {
+                            inner.pending_error = Some(msg.clone());
+                        }
+                        msg
+                    }
+                    Err(why) => {
+                        let msg = format!("{trap}; {why}, so it has been disabled");
+                        poison(inner, &self.descriptor.name, msg.clone());
+                        msg
+                    }
+                };
                 Err(msg)
             }
         }
     }
 
-    /// Whether this provider has been shut down by a trap.
+    /// Replace a trapped instance with a fresh one at the same path.
+    ///
+    /// Refuses once [`MAX_RESTARTS`] have been spent in [`RESTART_WINDOW`], or when
+    /// the replacement itself fails to come up; the caller then poisons.
+    fn restart(&self, inner: &mut Inner) -> Result<(), String> {
+        let now = Instant::now();
+        inner
+            .restarts
+            .retain(|at| now.duration_since(*at) < RESTART_WINDOW);
+        if inner.restarts.len() >= MAX_RESTARTS {
+            return Err(format!(
+                "it was already restarted {MAX_RESTARTS} times in the last {}s",
+                RESTART_WINDOW.as_secs()
+            ));
+        }
+        inner.restarts.push(now);
+
+        let pool::Instance {
+            mut store,
+            instance,
+            incremental,
+        } = self.pool.ready()?;
+
+        // A fresh guest starts at the root. Put it where the host believes it is,
+        // or `current_path` would lie from here on.
+        if self.current_path != "/" {
+            limits::refresh_for_call(&mut store)?;
+            instance
+                .sicompass_plugin_provider()
+                .call_set_current_path(&mut store, &self.current_path)
+                .map_err(|e| format!("restoring its path failed: {e}"))?;
+        }
+
+        inner.store = store;
+        inner.instance = instance;
+        // Generations are the old instance's; the new one starts from nothing.
+        inner.incremental = incremental;
+        inner.fetched = None;
+        inner.synced_body = None;
+        Ok(())
+    }
+
+    /// Whether this provider has been shut down by a trap it could not restart from.
     pub fn is_poisoned(&self) -> bool {
         self.inner.borrow().poisoned
     }
 
+    /// Forget the fetched tree, after the guest moved somewhere it does not
+    /// describe.
+    fn forget_fetched(&mut self) {
+        self.inner.get_mut().fetched = None;
+    }
+
     /// Call a guest export returning an FFON blob, decoding it. A failure yields an
     /// empty tree; the reason is already queued for `take_error`.
     fn call_ffon(
@@ -309,10 +450,161 @@ impl WasmProvider {
         f: impl FnOnce(&Guest, &mut Store<HostState>) -> wasmtime::Result<Vec<u8>>,
     ) -> Vec<FfonElement> {
         match self.call(what, f) {
-            Ok(blob) => ffon::deserialize_binary(&blob),
+            Ok(blob) => {
+                self.record_bytes(what, 0, blob.len());
+                ffon::deserialize_binary(&blob)
+            }
             Err(_) => Vec::new(),
         }
     }
+
+    /// Account FFON bytes sent to or received from `what`; see [`accounting`].
+    fn record_bytes(&self, what: &str, sent: usize, received: usize) {
+        accounting::record_bytes(self.pool.plugin_name(), what, sent, received);
+    }
+}
+
+/// The guest's half of the `incremental` exchanges, and where the host keeps
+/// its copies. [`WasmProvider`] is the real one; the tests script one.
+trait IncrementalGuest {
+    /// `fetch-since`. `Ok(None)` without the exports; on `Err` the reason is
+    /// already queued for `take_error`.
+    fn fetch_since(&self, since: u64) -> Result<Option<FfonDelta>, String>;
+    /// `sync-body-patches`, in the same shape.
+    fn sync_body_patches(
+        &self,
+        base: u64,
+        patches: &[FfonPatch],
+    ) -> Result<Option<Option<u64>>, String>;
+    /// The host's copy of the last fetched tree. Never held across a call.
+    fn fetched(&self) -> RefMut<'_, Option<Generation>>;
+    /// The body children last synced to the guest. Never held across a call.
+    fn synced_body(&self) -> RefMut<'_, Option<Generation>>;
+    fn report(&self, msg: String);
+    fn plugin(&self) -> &str;
+}
+
+impl IncrementalGuest for WasmProvider {
+    fn fetch_since(&self, since: u64) -> Result<Option<FfonDelta>, String> {
+        let delta = self.call_incremental("fetch-since", |g, s| g.call_fetch_since(s, since))?;
+        if let Some(delta) = &delta {
+            let received = match &delta.change {
+                FfonChange::Unchanged => 0,
+                FfonChange::Patches(patches) => patches.iter().map(|p| p.insert.len()).sum(),
+                FfonChange::Full(blob) => blob.len(),
+            };
+            self.record_bytes("fetch-since", 0, received);
+        }
+        Ok(delta)
+    }
+
+    fn sync_body_patches(
+        &self,
+        base: u64,
+        patches: &[FfonPatch],
+    ) -> Result<Option<Option<u64>>, String> {
+        let sent = patches.iter().map(|p| p.insert.len()).sum();
+        self.record_bytes("sync-body-patches", sent, 0);
+        self.call_incremental("sync-body-patches", |g, s| {
+            g.call_sync_body_patches(s, base, patches)
+        })
+    }
+
+    fn fetched(&self) -> RefMut<'_, Option<Generation>> {
+        RefMut::map(self.inner.borrow_mut(), |inner| &mut inner.fetched)
+    }
+
+    fn synced_body(&self) -> RefMut<'_, Option<Generation>> {
+        RefMut::map(self.inner.borrow_mut(), |inner| &mut inner.synced_body)
+    }
+
+    fn report(&self, msg: String) {
+        self.note_error(msg);
+    }
+
+    fn plugin(&self) -> &str {
+        &self.descriptor.name
+    }
+}
+
+/// `fetch` through `fetch-since`, patching the host's copy of the tree.
+///
+/// `None` when the guest has no `incremental` exports. A delta that does not
+/// apply drops the copy and asks again from generation 0, which the guest must
+/// answer in full.
+fn fetch_incremental(guest: &impl IncrementalGuest) -> Option<Vec<FfonElement>> {
+    for _ in 0..2 {
+        let since = guest.fetched().as_ref().map_or(0, |f| f.generation);
+        let delta = match guest.fetch_since(since) {
+            Ok(Some(delta)) => delta,
+            Ok(None) => return None,
+            // Already queued for `take_error`.
+            Err(_) => return Some(Vec::new()),
+        };
+
+        let mut held = guest.fetched();
+        let fetched = match (delta.change, held.take()) {
+            (FfonChange::Full(blob), _) => Some(ffon::deserialize_binary(&blob)),
+            (FfonChange::Unchanged, Some(copy)) if since != 0 => Some(copy.tree),
+            (FfonChange::Patches(patches), Some(mut copy)) if since != 0 => {
+                match delta::apply(&mut copy.tree, &patches) {
+                    Ok(()) => Some(copy.tree),
+                    Err(e) => {
+                        tracing::debug!(target: "wasm_plugin", plugin = %guest.plugin(),
+                                        "fetch-since {since}: {e}; fetching in full");
+                        None
+                    }
+                }
+            }
+            // A change against a generation the host does not hold.
+            _ => None,
+        };
+        if let Some(tree) = fetched {
+            *held = Some(Generation {
+                generation: delta.generation,
+                tree: tree.clone(),
+            });
+            return Some(tree);
+        }
+    }
+    guest.report(format!(
+        "plugin `{}` sent a change it could not make in full",
+        guest.plugin()
+    ));
+    Some(Vec::new())
+}
+
+/// `sync-ffon-body-children` as one splice against the last synced children.
+///
+/// `false` when that is not possible — no `incremental` exports, nothing synced
+/// yet, or the guest's body moved on — and the caller syncs in full.
+fn sync_body_incremental(guest: &impl IncrementalGuest, children: &[FfonElement]) -> bool {
+    let (base, patch) = {
+        let synced = guest.synced_body();
+        let Some(synced) = synced.as_ref() else {
+            return false;
+        };
+        (synced.generation, delta::diff(&synced.tree, children))
+    };
+    let Some(patch) = patch else {
+        return true; // the guest already has exactly this
+    };
+
+    let synced = guest.sync_body_patches(base, &[patch]);
+    let mut held = guest.synced_body();
+    match synced {
+        Ok(Some(Some(generation))) => {
+            *held = Some(Generation {
+                generation,
+                tree: children.to_vec(),
+            });
+            true
+        }
+        _ => {
+            *held = None;
+            false
+        }
+    }
 }
 
 /// Mark the instance unusable and queue the reason for display.
@@ -356,8 +648,9 @@ fn default_poll() -> wit_types::PollResult {
 /// Turn a wasmtime error into something a user can act on.
 ///
 /// Wasmtime's own messages are accurate but assume the reader knows what fuel and
-/// epochs are; a plugin user does not.
-fn describe_trap(what: &str, plugin: &str, err: &wasmtime::Error) -> String {
+/// epochs are; a plugin user does not. What happened to the plugin afterwards —
+/// restarted or disabled — is for the caller to add.
+pub(super) fn describe_trap(what: &str, plugin: &str, err: &wasmtime::Error) -> String {
     if let Some(trap) = err.downcast_ref::<wasmtime::Trap>() {
         let reason = match trap {
             wasmtime::Trap::OutOfFuel => "used too much CPU (possible infinite loop)".to_owned(),
@@ -365,11 +658,11 @@ fn describe_trap(what: &str, plugin: &str, err: &wasmtime::Error) -> String {
             wasmtime::Trap::UnreachableCodeReached => "panicked".to_owned(),
             other => format!("faulted ({other})"),
         };
-        return format!("plugin `{plugin}` {reason} during `{what}`; it has been disabled");
+        return format!("plugin `{plugin}` {reason} during `{what}`");
     }
     // Not a trap: a host-function error, or a memory-limit refusal surfaced as a
     // plain error. Keep wasmtime's text, which names the limit.
-    format!("plugin `{plugin}` failed during `{what}`: {err}; it has been disabled")
+    format!("plugin `{plugin}` failed during `{what}`: {err}")
 }
 
 /// Decode a blob the guest produced for a single element.
@@ -491,6 +784,11 @@ impl Provider for WasmProvider {
     // ---- Data source -------------------------------------------------------
 
     fn fetch(&mut self) -> Vec<FfonElement> {
+        if self.inner.get_mut().incremental.is_some()
+            && let Some(tree) = fetch_incremental(self)
+        {
+            return tree;
+        }
         self.call_ffon("fetch", |g, s| g.call_fetch(s))
     }
 
@@ -500,7 +798,10 @@ impl Provider for WasmProvider {
         })
         .ok()
         .flatten()
-        .map(|blob| ffon::deserialize_binary(&blob))
+        .map(|blob| {
+            self.record_bytes("fetch-subtree-children", 0, blob.len());
+            ffon::deserialize_binary(&blob)
+        })
     }
 
     fn fetch_subtree_parent_key(&mut self) -> Option<String> {
@@ -512,10 +813,24 @@ impl Provider for WasmProvider {
     }
 
     fn sync_ffon_body_children(&mut self, children: &[FfonElement]) {
+        if sync_body_incremental(self, children) {
+            return;
+        }
         let blob = ffon::serialize_binary(children);
-        let _ = self.call("sync-ffon-body-children", |g, s| {
-            g.call_sync_ffon_body_children(s, &blob)
-        });
+        self.record_bytes("sync-ffon-body-children", blob.len(), 0);
+        if self
+            .call("sync-ffon-body-children", |g, s| {
+                g.call_sync_ffon_body_children(s, &blob)
+            })
+            .is_ok()
+            && let Ok(Some(generation)) =
+                self.call_incremental("body-generation", |g, s| g.call_body_generation(s))
+        {
+            self.inner.get_mut().synced_body = Some(Generation {
+                generation,
+                tree: children.to_vec(),
+            });
+        }
     }
 
     // ---- Lifecycle ---------------------------------------------------------
@@ -583,18 +898,21 @@ impl Provider for WasmProvider {
     }
 
     fn push_path(&mut self, segment: &str) {
+        self.forget_fetched();
         if let Ok(p) = self.call("push-path", |g, s| g.call_push_path(s, segment)) {
             self.current_path = p;
         }
     }
 
     fn pop_path(&mut self) {
+        self.forget_fetched();
         if let Ok(p) = self.call("pop-path", |g, s| g.call_pop_path(s)) {
             self.current_path = p;
         }
     }
 
     fn set_current_path(&mut self, path: &str) {
+        self.forget_fetched();
         if let Ok(p) = self.call("set-current-path", |g, s| g.call_set_current_path(s, path)) {
             self.current_path = p;
         }
@@ -995,7 +1313,6 @@ mod tests {
         assert!(msg.contains("weather"), "{msg}");
         assert!(msg.contains("too much CPU"), "{msg}");
         assert!(msg.contains("fetch"), "{msg}");
-        assert!(msg.contains("disabled"), "{msg}");
 
         let timeout: wasmtime::Error = wasmtime::Trap::Interrupt.into();
         assert!(describe_trap("poll", "w", &timeout).contains("took too long"));
@@ -1218,4 +1535,237 @@ mod tests {
         let blob = ffon::serialize_binary(&[FfonElement::new_str("only")]);
         assert_eq!(first_element(&blob), Some(FfonElement::new_str("only")));
     }
+
+    // --- incremental exchanges ---
+
+    use std::collections::VecDeque;
+
+    /// A guest answering from a script, recording what the host asked of it.
+    #[derive(Default)]
+    struct Scripted {
+        fetches: RefCell<VecDeque<Result<Option<FfonDelta>, String>>>,
+        syncs: RefCell<VecDeque<Result<Option<Option<u64>>, String>>>,
+        asked_since: RefCell<Vec<u64>>,
+        sent: RefCell<Vec<(u64, Vec<FfonPatch>)>>,
+        fetched: RefCell<Option<Generation>>,
+        synced_body: RefCell<Option<Generation>>,
+        errors: RefCell<Vec<String>>,
+    }
+
+    impl Scripted {
+        fn answering(fetches: Vec<Result<Option<FfonDelta>, String>>) -> Self {
+            Scripted {
+                fetches: RefCell::new(fetches.into()),
+                ..Default::default()
+            }
+        }
+
+        fn holding(self, generation: u64, tree: Vec<FfonElement>) -> Self {
+            *self.fetched.borrow_mut() = Some(Generation { generation, tree });
+            self
+        }
+
+        fn held(&self) -> Option<(u64, Vec<FfonElement>)> {
+            self.fetched
+                .borrow()
+                .as_ref()
+                .map(|g| (g.generation, g.tree.clone()))
+        }
+    }
+
+    impl IncrementalGuest for Scripted {
+        fn fetch_since(&self, since: u64) -> Result<Option<FfonDelta>, String> {
+            self.asked_since.borrow_mut().push(since);
+            self.fetches
+                .borrow_mut()
+                .pop_front()
+                .expect("an unscripted fetch")
+        }
+
+        fn sync_body_patches(
+            &self,
+            base: u64,
+            patches: &[FfonPatch],
+        ) -> Result<Option<Option<u64>>, String> {
+            self.sent.borrow_mut().push((base, patches.to_vec()));
+            self.syncs
+                .borrow_mut()
+                .pop_front()
+                .expect("an unscripted sync")
+        }
+
+        fn fetched(&self) -> RefMut<'_, Option<Generation>> {
+            self.fetched.borrow_mut()
+        }
+
+        fn synced_body(&self) -> RefMut<'_, Option<Generation>> {
+            self.synced_body.borrow_mut()
+        }
+
+        fn report(&self, msg: String) {
+            self.errors.borrow_mut().push(msg);
+        }
+
+        fn plugin(&self) -> &str {
+            "scripted"
+        }
+    }
+
+    fn strs(items: &[&str]) -> Vec<FfonElement> {
+        items.iter().map(|s| FfonElement::new_str(*s)).collect()
+    }
+
+    fn answer(generation: u64, change: FfonChange) -> Result<Option<FfonDelta>, String> {
+        Ok(Some(FfonDelta { generation, change }))
+    }
+
+    fn full(generation: u64, tree: &[&str]) -> Result<Option<FfonDelta>, String> {
+        answer(
+            generation,
+            FfonChange::Full(ffon::serialize_binary(&strs(tree))),
+        )
+    }
+
+    fn splice(at: u32, remove: u32, insert: &[&str]) -> FfonPatch {
+        FfonPatch {
+            path: vec![at],
+            remove,
+            insert: ffon::serialize_binary(&strs(insert)),
+        }
+    }
+
+    #[test]
+    fn a_guest_without_the_exports_is_fetched_in_full() {
+        let guest = Scripted::answering(vec![Ok(None)]);
+        assert!(fetch_incremental(&guest).is_none());
+        assert!(guest.held().is_none());
+    }
+
+    #[test]
+    fn the_first_fetch_asks_from_zero_and_keeps_the_generation() {
+        let guest = Scripted::answering(vec![full(3, &["a", "b"])]);
+        assert_eq!(fetch_incremental(&guest), Some(strs(&["a", "b"])));
+        assert_eq!(*guest.asked_since.borrow(), [0]);
+        assert_eq!(guest.held(), Some((3, strs(&["a", "b"]))));
+    }
+
+    #[test]
+    fn unchanged_serves_the_held_copy() {
+        let guest = Scripted::answering(vec![answer(3, FfonChange::Unchanged)])
+            .holding(3, strs(&["a", "b"]));
+        assert_eq!(fetch_incremental(&guest), Some(strs(&["a", "b"])));
+        assert_eq!(*guest.asked_since.borrow(), [3]);
+        assert_eq!(guest.held(), Some((3, strs(&["a", "b"]))));
+    }
+
+    #[test]
+    fn patches_are_applied_to_the_held_copy() {
+        let patches = vec![splice(1, 1, &["x", "y"])];
+        let guest = Scripted::answering(vec![answer(4, FfonChange::Patches(patches))])
+            .holding(3, strs(&["a", "b", "c"]));
+        assert_eq!(fetch_incremental(&guest), Some(strs(&["a", "x", "y", "c"])));
+        assert_eq!(*guest.asked_since.borrow(), [3]);
+        assert_eq!(guest.held(), Some((4, strs(&["a", "x", "y", "c"]))));
+    }
+
+    #[test]
+    fn a_patch_that_does_not_apply_asks_again_from_zero() {
+        let patches = vec![splice(5, 1, &["x"])];
+        let guest = Scripted::answering(vec![
+            answer(4, FfonChange::Patches(patches)),
+            full(4, &["z"]),
+        ])
+        .holding(3, strs(&["a"]));
+        assert_eq!(fetch_incremental(&guest), Some(strs(&["z"])));
+        assert_eq!(*guest.asked_since.borrow(), [3, 0]);
+        assert_eq!(guest.held(), Some((4, strs(&["z"]))));
+        assert!(guest.errors.borrow().is_empty());
+    }
+
+    #[test]
+    fn a_change_against_nothing_held_asks_again_from_zero() {
+        // The guest answers as if the host still held generation 3.
+        let guest = Scripted::answering(vec![answer(4, FfonChange::Unchanged), full(4, &["a"])]);
+        assert_eq!(fetch_incremental(&guest), Some(strs(&["a"])));
+        assert_eq!(*guest.asked_since.borrow(), [0, 0]);
+        assert_eq!(guest.held(), Some((4, strs(&["a"]))));
+    }
+
+    #[test]
+    fn a_guest_that_never_answers_in_full_is_reported() {
+        let guest = Scripted::answering(vec![
+            answer(4, FfonChange::Patches(vec![splice(9, 1, &[])])),
+            answer(4, FfonChange::Unchanged),
+        ])
+        .holding(3, strs(&["a"]));
+        assert_eq!(fetch_incremental(&guest), Some(Vec::new()));
+        assert_eq!(*guest.asked_since.borrow(), [3, 0]);
+        assert!(guest.held().is_none());
+        let errors = guest.errors.borrow();
+        assert_eq!(errors.len(), 1);
+        assert!(errors[0].contains("scripted"), "{}", errors[0]);
+    }
+
+    #[test]
+    fn a_failed_fetch_yields_nothing_and_keeps_the_copy() {
+        let guest = Scripted::answering(vec![Err("trapped".to_owned())]).holding(3, strs(&["a"]));
+        assert_eq!(fetch_incremental(&guest), Some(Vec::new()));
+        assert_eq!(guest.held(), Some((3, strs(&["a"]))));
+    }
+
+    #[test]
+    fn a_body_never_synced_is_synced_in_full() {
+        let guest = Scripted::default();
+        assert!(!sync_body_incremental(&guest, &strs(&["a"])));
+        assert!(guest.sent.borrow().is_empty());
+    }
+
+    #[test]
+    fn an_unchanged_body_sends_nothing() {
+        let guest = Scripted::default();
+        *guest.synced_body.borrow_mut() = Some(Generation {
+            generation: 5,
+            tree: strs(&["a", "b"]),
+        });
+        assert!(sync_body_incremental(&guest, &strs(&["a", "b"])));
+        assert!(guest.sent.borrow().is_empty());
+    }
+
+    #[test]
+    fn an_edited_body_is_sent_as_one_splice_against_its_base() {
+        let guest = Scripted::default();
+        guest.syncs.borrow_mut().push_back(Ok(Some(Some(6))));
+        *guest.synced_body.borrow_mut() = Some(Generation {
+            generation: 5,
+            tree: strs(&["a", "b", "c"]),
+        });
+        assert!(sync_body_incremental(&guest, &strs(&["a", "x", "c"])));
+
+        let sent = guest.sent.borrow();
+        assert_eq!(sent.len(), 1);
+        let (base, patches) = &sent[0];
+        assert_eq!(*base, 5);
+        let mut tree = strs(&["a", "b", "c"]);
+        delta::apply(&mut tree, patches).unwrap();
+        assert_eq!(tree, strs(&["a", "x", "c"]));
+
+        let synced = guest.synced_body.borrow();
+        let synced = synced.as_ref().unwrap();
+        assert_eq!(synced.generation, 6);
+        assert_eq!(synced.tree, strs(&["a", "x", "c"]));
+    }
+
+    #[test]
+    fn a_body_the_guest_moved_on_from_is_synced_in_full() {
+        for answer in [Ok(Some(None)), Ok(None), Err("trapped".to_owned())] {
+            let guest = Scripted::default();
+            guest.syncs.borrow_mut().push_back(answer);
+            *guest.synced_body.borrow_mut() = Some(Generation {
+                generation: 5,
+                tree: strs(&["a"]),
+            });
+            assert!(!sync_body_incremental(&guest, &strs(&["b"])));
+            assert!(guest.synced_body.borrow().is_none());
+        }
+    }
 }
@@ -6613,6 +6613,14 @@ fn email_renderer_inside_message() -> AppRenderer {
         async fn fetch_message(&mut self, _: &str, _: u32) -> Result<Option<EmailMessage>, String> {
             Ok(None)
         }
+        async fn fetch_part(
+            &mut self,
+            _: &str,
+            _: u32,
+            _: &str,
+        ) -> Result<Option<Vec<u8>>, String> {
+            Ok(None)
+        }
         async fn fetch_message_by_message_id(
             &mut self,
             _: &str,
@@ -6817,6 +6825,14 @@ fn ctrl_d_from_message_list_removes_message() {
         async fn fetch_message(&mut self, _: &str, _: u32) -> Result<Option<EmailMessage>, String> {
             Ok(None)
         }
+        async fn fetch_part(
+            &mut self,
+            _: &str,
+            _: u32,
+            _: &str,
+        ) -> Result<Option<Vec<u8>>, String> {
+            Ok(None)
+        }
         async fn fetch_message_by_message_id(
             &mut self,
             _: &str,
@@ -7418,8 +7434,10 @@ fn compose_body_insert_records_only_text_chunks() {
     type_text(&mut renderer, "line2");
     press_enter(&mut renderer);
 
-    let recorded: Vec<&TimelineEntry> = renderer.active_timeline().entries[baseline..]
-        .iter()
+    let recorded: Vec<&TimelineEntry> = renderer
+        .active_timeline()
+        .entries
+        .range(baseline..)
         .collect();
     assert!(
         recorded
@@ -10276,6 +10294,129 @@ fn apply_tabs_section_keeps_tab_timelines_parallel_to_tabs() {
     let _ = h.renderer.active_timeline_mut();
 }
 
+/// Only the active tab is built on restore. The others come back as stubs,
+/// built on first activation (or ahead of it), and a parked tab can go back to
+/// being a stub without losing its cursor or its timeline.
+#[test]
+fn restored_tabs_are_built_on_first_activation() {
+    let mut h = Harness::new();
+    let fb_idx = h.provider_idx("filebrowser").unwrap();
+
+    let tabs_json = format!(
+        r#"[{{"id":[{fb}],"path":"/"}},{{"id":[{fb}],"path":"/"}},{{"id":[{fb}],"path":"/"}}]"#,
+        fb = fb_idx,
+    );
+    let mut sec = serde_json::Map::new();
+    sec.insert("tabs".to_owned(), serde_json::Value::String(tabs_json));
+    sec.insert(
+        "activeTab".to_owned(),
+        serde_json::Value::String("0".to_owned()),
+    );
+    sicompass::programs::apply_tabs_section(h.r(), &sec);
+
+    assert!(!h.renderer.tabs[0].is_stub());
+    for i in 1..3 {
+        assert!(
+            h.renderer.tabs[i].is_stub(),
+            "tab {i} should not be built yet"
+        );
+        assert!(h.renderer.tabs[i].providers.is_empty());
+    }
+
+    // First activation builds the tab at its saved place.
+    h.renderer.switch_to_tab(1);
+    assert!(!h.renderer.tabs[1].is_stub());
+    assert_eq!(h.renderer.current_id.get(0), Some(fb_idx));
+    assert_eq!(h.renderer.providers[fb_idx].name(), "filebrowser");
+    press_right(h.r());
+    let cursor = h.renderer.current_id.clone();
+    let entries = h.renderer.tab_timelines[1].entries.len();
+
+    // Parked and dehydrated: nothing built, cursor and timeline kept.
+    h.renderer.switch_to_tab(0);
+    assert!(h.renderer.dehydrate_tab(1));
+    assert!(h.renderer.tabs[1].providers.is_empty());
+    assert_eq!(h.renderer.tabs[1].current_id, cursor);
+    assert_eq!(h.renderer.tab_timelines[1].entries.len(), entries);
+
+    // Built ahead of a switch, without moving the active tab's cursor.
+    let active_cursor = h.renderer.current_id.clone();
+    h.renderer.hydrate_tab(2);
+    assert!(!h.renderer.tabs[2].is_stub());
+    assert!(!h.renderer.tabs[2].providers.is_empty());
+    assert_eq!(h.renderer.current_id, active_cursor);
+
+    // Switching back lands where the tab was left.
+    h.renderer.switch_to_tab(1);
+    assert_eq!(h.renderer.current_id, cursor);
+    assert_eq!(h.renderer.active_timeline().entries.len(), entries);
+}
+
+/// Building a parked tab ahead of a switch does not wait for its providers.
+/// They start in the background, and the tab is walked to where it was saved
+/// once the one it was on is swapped in, even if it was switched to first.
+#[test]
+fn a_tab_built_while_idle_walks_to_its_place_once_its_provider_starts() {
+    let mut h = Harness::new();
+    let fb_idx = h.provider_idx("filebrowser").unwrap();
+    let tabs_json = format!(
+        r#"[{{"id":[{fb}],"path":"/"}},{{"id":[{fb},1],"path":"/"}}]"#,
+        fb = fb_idx,
+    );
+    let mut sec = serde_json::Map::new();
+    sec.insert("tabs".to_owned(), serde_json::Value::String(tabs_json));
+    sec.insert(
+        "activeTab".to_owned(),
+        serde_json::Value::String("0".to_owned()),
+    );
+    sicompass::programs::apply_tabs_section(h.r(), &sec);
+    assert!(h.renderer.tabs[1].is_stub());
+
+    h.renderer.hydrate_tab(1);
+    assert!(!h.renderer.tabs[1].is_stub());
+    assert!(h.renderer.tabs[1].pending_nav.is_some());
+    assert!(
+        h.renderer.startup.is_some(),
+        "its providers start in the background"
+    );
+
+    // Switched to before anything is in: the cursor waits on the provider.
+    h.renderer.switch_to_tab(1);
+    assert_eq!(h.renderer.current_id.as_slice(), [fb_idx]);
+
+    sicompass::programs::place_started_providers(h.r(), std::time::Duration::from_secs(30));
+    assert!(h.renderer.startup.is_none());
+    assert!(h.renderer.tabs[1].pending_nav.is_none());
+    assert_eq!(h.renderer.providers[fb_idx].name(), "filebrowser");
+    assert_eq!(h.renderer.current_id.as_slice(), [fb_idx, 1]);
+}
+
+/// The active tab restored while the provider it was on is still starting
+/// waits on that provider's row, then walks to where it was saved.
+#[test]
+fn the_active_tab_walks_to_its_place_once_its_provider_starts() {
+    let mut h = Harness::new();
+    let fb_idx = h.provider_idx("filebrowser").unwrap();
+    // As at launch: the content set is staged, each provider a placeholder.
+    let names = h.renderer.content_names();
+    drop(h.renderer.detach_content());
+    let (cp, cf) = sicompass::programs::stage_content_set_from_names(h.r(), &names);
+    h.renderer.attach_content(cp, cf);
+
+    let tabs_json = format!(r#"[{{"id":[{fb},1],"path":"/"}}]"#, fb = fb_idx);
+    let mut sec = serde_json::Map::new();
+    sec.insert("tabs".to_owned(), serde_json::Value::String(tabs_json));
+    sicompass::programs::apply_tabs_section(h.r(), &sec);
+    assert!(h.renderer.tabs[0].pending_nav.is_some());
+    assert_eq!(h.renderer.current_id.as_slice(), [fb_idx]);
+
+    sicompass::programs::place_started_providers(h.r(), std::time::Duration::from_secs(30));
+    assert!(h.renderer.startup.is_none());
+    assert!(h.renderer.tabs[0].pending_nav.is_none());
+    assert_eq!(h.renderer.providers[fb_idx].name(), "filebrowser");
+    assert_eq!(h.renderer.current_id.as_slice(), [fb_idx, 1]);
+}
+
 /// Regression: after restart, a tab snapshot may reference a cursor index
 /// past the end of the provider's current FFON tree — terminal scrollback,
 /// chat backlog and similar ephemeral content shrink across sessions. The
@@ -12679,7 +12820,13 @@ fn task_input_via_update_state_emits_text_chunk() {
         after_count > before_count,
         "Task::Input emitted at least one entry"
     );
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert!(
         new_entries
             .iter()
@@ -12708,7 +12855,13 @@ fn append_emits_structural_inserted_entry() {
         after_count > before_count,
         "Task::Append recorded at least one entry"
     );
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert!(
         new_entries.iter().any(|e| matches!(
             e,
@@ -12745,7 +12898,13 @@ fn delete_emits_structural_removed_entry() {
     );
     let after_count = h.renderer.active_timeline().entries.len();
     assert!(after_count > before_count);
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert!(
         new_entries.iter().any(|e| matches!(
             e,
@@ -12772,7 +12931,13 @@ fn fscreate_directory_emits_fsop_create_obj() {
     press_ctrl(h.r(), Keycode::I);
     type_text(h.r(), "+ a_unique_test_dir");
     press_enter(h.r());
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     // Creating a directory (including typing its name) must collapse into a
     // single undo step — no leftover per-keystroke TextChunks.
     assert_eq!(
@@ -12805,7 +12970,13 @@ fn fscreate_file_emits_fsop_create_str() {
     press_ctrl(h.r(), Keycode::I);
     type_text(h.r(), "- a_unique_test_file.txt");
     press_enter(h.r());
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     // Creating a file (including typing its name) must collapse into a single
     // undo step — no leftover per-keystroke TextChunks.
     assert_eq!(
@@ -12837,7 +13008,13 @@ fn fscreate_file_undoes_in_one_step() {
     let path = h.tmp.path().join("undo_one_step.txt");
     assert!(path.exists(), "file should be created on disk");
     // The whole creation is a single timeline entry...
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert_eq!(
         new_entries.len(),
         1,
@@ -13090,7 +13267,13 @@ fn fsrename_emits_fsop_rename() {
     h.renderer.cursor_position = 0;
     type_text(h.r(), "renamed_unique.txt");
     press_enter(h.r());
-    let new_entries: Vec<_> = h.renderer.active_timeline().entries[before_count..].to_vec();
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     // Renaming (including typing the new name) must collapse into a single
     // undo step — no leftover per-keystroke TextChunks.
     assert_eq!(
@@ -13111,6 +13294,81 @@ fn fsrename_emits_fsop_rename() {
     }
 }
 
+/// Every change the create, rename and cancel flows make to the timeline
+/// reaches the journal: a timeline reopened from it holds the same entries, in
+/// the same order, as the one in memory. Placeholder inserts popped by a
+/// create, keystroke chunks collapsed into it, and the chunks of a cancelled
+/// edit must not come back.
+#[test]
+fn journal_replays_the_timeline_left_by_create_rename_and_cancel() {
+    let mut h = Harness::new();
+    let journal_dir = TempDir::new().unwrap();
+    let active = h.renderer.active_tab;
+    h.renderer.tab_timelines[active] =
+        sicompass::timeline_journal::open_timeline(Some(journal_dir.path()), None, &[]);
+    let fb_idx = h.provider_idx("filebrowser").unwrap();
+    navigate_to_provider(h.r(), fb_idx);
+    press_right(h.r());
+
+    press_ctrl(h.r(), Keycode::I);
+    type_text(h.r(), "- journaled.txt");
+    press_enter(h.r());
+
+    for (name, new_name, commit) in [("alpha.txt", "renamed.txt", true), ("beta.txt", "x", false)] {
+        let idx = h
+            .renderer
+            .total_list
+            .iter()
+            .position(|item| item.label.contains(name))
+            .unwrap();
+        h.renderer.list_index = idx;
+        h.renderer.current_id = h.renderer.total_list[idx].id.clone();
+        press(h.r(), Keycode::I);
+        h.renderer.input_buffer.clear();
+        h.renderer.cursor_position = 0;
+        type_text(h.r(), new_name);
+        if commit {
+            press_enter(h.r());
+        } else {
+            press_escape(h.r());
+        }
+    }
+
+    let live = h.renderer.active_timeline();
+    let expected: Vec<String> = (0..live.entries.len())
+        .filter_map(|i| live.entries.load(i))
+        .filter(sicompass::timeline_journal::journaled)
+        .map(|e| format!("{e:?}"))
+        .collect();
+    assert!(
+        expected.iter().any(|e| e.contains("Create"))
+            && expected.iter().any(|e| e.contains("Rename")),
+        "expected a create and a rename, got {expected:?}"
+    );
+
+    let key = live.journal.as_ref().unwrap().key().to_owned();
+    let names = h.renderer.provider_names();
+    let names: Vec<&str> = names.iter().map(String::as_str).collect();
+    let restored =
+        sicompass::timeline_journal::open_timeline(Some(journal_dir.path()), Some(&key), &names);
+    let replayed: Vec<String> = restored.entries.iter().map(|e| format!("{e:?}")).collect();
+    assert_eq!(replayed, expected);
+    assert_eq!(restored.position, live.position);
+
+    // With the file browser disabled, nothing of it is replayed onto
+    // whichever provider took its index.
+    let without: Vec<&str> = names
+        .iter()
+        .copied()
+        .filter(|n| *n != "filebrowser")
+        .collect();
+    let restored =
+        sicompass::timeline_journal::open_timeline(Some(journal_dir.path()), Some(&key), &without);
+    assert_eq!(restored.entries.len(), 0);
+
+    std::fs::remove_file(h.tmp.path().join("journaled.txt")).ok();
+}
+
 #[test]
 fn settings_checkbox_emits_provider_op_and_undoes() {
     use sicompass_sdk::provider::Provider;
@@ -13327,7 +13585,12 @@ fn unified_undo_reverts_file_deletion_with_snapshot() {
     // the unified undo path on the resulting FsOp::Delete entry.
     let prior_entries_len = h.renderer.active_timeline().entries.len();
     assert!(sicompass::provider::delete_item_by_name(h.r(), "alpha.txt"));
-    let new_entries = &h.renderer.active_timeline().entries[prior_entries_len..];
+    let new_entries: Vec<_> = h
+        .renderer
+        .active_timeline()
+        .entries
+        .range(prior_entries_len..)
+        .collect();
     assert!(
         new_entries.iter().any(|e| matches!(
             e,
@@ -14505,7 +14768,12 @@ fn unified_undo_reverts_silent_checkbox_str_toggle_via_enter() {
     );
 
     // Exactly one new entry: a TextChunk capturing before/after.
-    let entries: Vec<_> = r.active_timeline().entries[before_count..].to_vec();
+    let entries: Vec<_> = r
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert_eq!(entries.len(), 1, "atomic single entry, got {:?}", entries);
     match &entries[0] {
         TimelineEntry::TextChunk {
@@ -14583,7 +14851,12 @@ fn unified_undo_reverts_silent_checkbox_obj_toggle_via_enter() {
         _ => panic!("expected Obj"),
     }
 
-    let entries: Vec<_> = r.active_timeline().entries[before_count..].to_vec();
+    let entries: Vec<_> = r
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert_eq!(entries.len(), 1, "atomic single entry");
     assert!(
         matches!(entries[0], TimelineEntry::TextChunk { .. }),
@@ -14656,7 +14929,12 @@ fn unified_undo_reverts_silent_radio_toggle_via_enter() {
     assert_eq!(post_children[2].as_str(), Some("east"));
 
     // Exactly one new entry: a Structural::Replace at parent_id.
-    let entries: Vec<_> = r.active_timeline().entries[before_count..].to_vec();
+    let entries: Vec<_> = r
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert_eq!(entries.len(), 1, "atomic single entry, got {:?}", entries);
     match &entries[0] {
         TimelineEntry::Structural { id, op, payload } => {
@@ -14912,7 +15190,12 @@ fn unified_undo_settings_checkbox_via_enter_records_single_provider_op() {
     press_enter(&mut r);
 
     // Settings emits a ProviderOp; the fallback TextChunk MUST NOT also fire.
-    let entries: Vec<_> = r.active_timeline().entries[before_count..].to_vec();
+    let entries: Vec<_> = r
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert_eq!(
         entries.len(),
         1,
@@ -14964,7 +15247,12 @@ fn unified_undo_settings_radio_via_enter_does_not_double_record() {
 
     // Settings emits a ProviderOp for the radio change; the fallback
     // Structural::Replace MUST NOT also fire.
-    let entries: Vec<_> = r.active_timeline().entries[before_count..].to_vec();
+    let entries: Vec<_> = r
+        .active_timeline()
+        .entries
+        .range(before_count..)
+        .cloned()
+        .collect();
     assert_eq!(
         entries.len(),
         1,
@@ -15074,11 +15362,15 @@ fn simple_search_enter_on_checkbox_jumps_without_toggling() {
         "Enter in search must not flip the checkbox",
     );
     assert!(
-        r.active_timeline().entries[before_count..]
-            .iter()
+        r.active_timeline()
+            .entries
+            .range(before_count..)
             .all(|e| !matches!(e, sicompass_sdk::timeline::TimelineEntry::TextChunk { .. })),
         "a jump must not record a text edit; got {:?}",
-        &r.active_timeline().entries[before_count..],
+        r.active_timeline()
+            .entries
+            .range(before_count..)
+            .collect::<Vec<_>>(),
     );
 
     // A second Enter, now in General mode, still toggles.
@@ -15149,11 +15441,15 @@ fn simple_search_enter_on_radio_jumps_without_selecting() {
         "east must not become checked"
     );
     assert!(
-        r.active_timeline().entries[before_count..]
-            .iter()
+        r.active_timeline()
+            .entries
+            .range(before_count..)
             .all(|e| !matches!(e, sicompass_sdk::timeline::TimelineEntry::Structural { .. })),
         "a jump must not record a radio replacement; got {:?}",
-        &r.active_timeline().entries[before_count..],
+        r.active_timeline()
+            .entries
+            .range(before_count..)
+            .collect::<Vec<_>>(),
     );
 
     // A second Enter, now in General mode, still selects.
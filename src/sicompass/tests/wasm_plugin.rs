@@ -43,6 +43,17 @@ fn open_hello() -> WasmProvider {
         .expect("the hello fixture should load and instantiate")
 }
 
+/// Trap the fixture until its restart budget is spent and it is disabled, draining
+/// the error rows on the way.
+fn explode_until_disabled(p: &mut WasmProvider) {
+    for _ in 0..=wasm_host::pool::MAX_RESTARTS {
+        assert!(!p.is_poisoned(), "disabled before the budget was spent");
+        assert!(!p.execute_command("explode", ""));
+        let _ = p.take_error();
+    }
+    assert!(p.is_poisoned());
+}
+
 // ---------------------------------------------------------------------------
 // Loading and identity
 // ---------------------------------------------------------------------------
@@ -197,6 +208,77 @@ fn the_component_imports_nothing_outside_the_host_capability_set() {
     );
 }
 
+// ---------------------------------------------------------------------------
+// Precompiled artifacts
+// ---------------------------------------------------------------------------
+
+/// A copy of the fixture whose bytes no other test shares, so its precompiled
+/// artifact is this test's alone. A trailing custom section changes the bytes
+/// without changing the component.
+fn unique_hello_copy(dir: &Path) -> PathBuf {
+    let tag = format!("{}-{:?}", std::process::id(), std::time::SystemTime::now());
+    let name = b"sicompass-test";
+    let payload_len = 1 + name.len() + tag.len();
+    assert!(payload_len < 128, "one-byte LEB128 size");
+
+    let mut bytes = std::fs::read(hello_wasm()).unwrap();
+    bytes.push(0); // custom section id
+    bytes.push(payload_len as u8);
+    bytes.push(name.len() as u8);
+    bytes.extend_from_slice(name);
+    bytes.extend_from_slice(tag.as_bytes());
+
+    let path = dir.join("hello.wasm");
+    std::fs::write(&path, bytes).unwrap();
+    path
+}
+
+#[test]
+fn a_precompiled_plugin_loads_without_compiling() {
+    let dir = tempfile::tempdir().unwrap();
+    let wasm = unique_hello_copy(dir.path());
+    let Some(artifact) = wasm_host::precompiled_artifact(&wasm) else {
+        return; // no cache directory on this machine
+    };
+
+    wasm_host::precompile(&wasm).expect("the fixture precompiles");
+    assert!(artifact.exists(), "no artifact at {}", artifact.display());
+
+    let p = WasmProvider::open(&wasm, "hello", "hello", &fixture_dir(), Vec::new())
+        .expect("opens from the artifact");
+    assert_eq!(p.name(), "hello");
+    let _ = std::fs::remove_file(artifact);
+}
+
+#[test]
+fn a_damaged_precompiled_artifact_is_rebuilt_rather_than_trusted() {
+    let dir = tempfile::tempdir().unwrap();
+    let wasm = unique_hello_copy(dir.path());
+    let Some(artifact) = wasm_host::precompiled_artifact(&wasm) else {
+        return;
+    };
+    std::fs::create_dir_all(artifact.parent().unwrap()).unwrap();
+    std::fs::write(&artifact, b"not an artifact").unwrap();
+
+    // Falls back to compiling, so the plugin still opens.
+    let p = WasmProvider::open(&wasm, "hello", "hello", &fixture_dir(), Vec::new())
+        .expect("a damaged artifact must not stop the plugin loading");
+    assert_eq!(p.name(), "hello");
+
+    // And the artifact is written back in the background.
+    let deadline = std::time::Instant::now() + std::time::Duration::from_secs(10);
+    while std::fs::read(&artifact).ok().as_deref() == Some(b"not an artifact".as_slice())
+        || !artifact.exists()
+    {
+        assert!(
+            std::time::Instant::now() < deadline,
+            "artifact was not rebuilt"
+        );
+        std::thread::sleep(std::time::Duration::from_millis(10));
+    }
+    let _ = std::fs::remove_file(artifact);
+}
+
 // ---------------------------------------------------------------------------
 // Trap containment — a misbehaving guest must not take the host down
 // ---------------------------------------------------------------------------
@@ -210,7 +292,10 @@ fn an_infinite_loop_in_a_guest_is_stopped() {
     let ok = p.execute_command("spin", "");
     assert!(!ok, "a trapped call must not report success");
 
-    assert!(p.is_poisoned(), "a runaway plugin must be disabled");
+    assert!(
+        !p.is_poisoned(),
+        "a first trap restarts rather than disables"
+    );
     let err = p
         .take_error()
         .expect("the trap should surface as an error row");
@@ -226,28 +311,81 @@ fn an_infinite_loop_in_a_guest_is_stopped() {
         err.contains("too much CPU") || err.contains("took too long"),
         "error should explain the cause: {err}"
     );
-    assert!(err.contains("disabled"), "{err}");
+    assert!(err.contains("restarted"), "{err}");
 }
 
 #[test]
-fn a_guest_panic_is_contained_and_disables_the_plugin() {
+fn a_guest_panic_restarts_the_plugin_where_it_was() {
     let mut p = open_hello();
-    assert!(!p.execute_command("explode", ""));
-    assert!(p.is_poisoned());
+    p.push_path("alpha");
+    assert!(
+        !p.execute_command("explode", ""),
+        "the trapped call still fails"
+    );
+    assert!(!p.is_poisoned());
 
     let err = p.take_error().expect("panic should surface as an error");
     assert!(err.contains("hello"), "{err}");
+    assert!(err.contains("restarted"), "{err}");
+
+    // The replacement is a different instance, so agreeing on the path means the
+    // host put it back rather than merely remembering where it was.
+    assert_eq!(p.current_path(), "/alpha");
+    let elems = p.fetch();
+    let obj = elems[0].as_obj().unwrap();
+    assert!(
+        obj.children
+            .iter()
+            .any(|c| c.as_str().is_some_and(|s| s == "current path: /alpha")),
+        "the restarted guest is somewhere else: {:?}",
+        obj.children
+    );
+}
+
+#[test]
+fn a_plugin_that_keeps_trapping_is_disabled_once_its_restart_budget_is_spent() {
+    let mut p = open_hello();
+    for _ in 0..wasm_host::pool::MAX_RESTARTS {
+        assert!(!p.execute_command("explode", ""));
+        assert!(!p.is_poisoned());
+        let _ = p.take_error();
+    }
+
+    assert!(!p.execute_command("explode", ""));
+    assert!(p.is_poisoned());
+    let err = p.take_error().expect("the last trap should surface too");
     assert!(err.contains("disabled"), "{err}");
 }
 
+#[test]
+fn every_call_is_accounted_to_the_plugin_that_made_it() {
+    // A name of its own, so other tests' calls do not land in these totals.
+    let name = "hello-accounting";
+    let mut p = WasmProvider::open(&hello_wasm(), name, "hello", &fixture_dir(), Vec::new())
+        .expect("the hello fixture should load and instantiate");
+    assert!(!p.fetch().is_empty());
+    assert!(!p.execute_command("explode", ""));
+    let _ = p.take_error();
+
+    let usage = wasm_host::accounting::snapshot()
+        .remove(name)
+        .expect("the plugin's calls were recorded");
+    let fetch = &usage.exports["fetch"];
+    assert!(fetch.calls >= 1 && fetch.fuel > 0, "{fetch:?}");
+    assert!(fetch.bytes_received > 0, "{fetch:?}");
+    assert_eq!(usage.exports["execute-command"].traps, 1);
+    // `describe` builds the display name through the host's `translate`.
+    assert!(usage.imports["translate"].calls >= 1);
+    // Instantiating the guest's memory goes through the meter too.
+    assert!(usage.memory_high_water > 0);
+}
+
 #[test]
 fn a_poisoned_plugin_stays_inert_instead_of_returning_garbage() {
     // After a trap the guest's linear memory is in an arbitrary state, so every
     // later call must be skipped rather than produce plausible-looking nonsense.
     let mut p = open_hello();
-    p.execute_command("explode", "");
-    assert!(p.is_poisoned());
-    let _ = p.take_error();
+    explode_until_disabled(&mut p);
 
     assert!(
         p.fetch().is_empty(),
@@ -275,8 +413,7 @@ fn one_plugin_trapping_does_not_affect_another_instance() {
     let mut doomed = open_hello();
     let mut healthy = open_hello();
 
-    doomed.execute_command("explode", "");
-    assert!(doomed.is_poisoned());
+    explode_until_disabled(&mut doomed);
 
     assert!(!healthy.is_poisoned());
     assert!(
@@ -679,9 +816,7 @@ fn entering_the_dashboard_resets_the_guests_frame_counter() {
 #[test]
 fn a_poisoned_plugin_renders_blanks_rather_than_panicking() {
     let mut p = open_hello();
-    p.execute_command("explode", "");
-    assert!(p.is_poisoned());
-    let _ = p.take_error();
+    explode_until_disabled(&mut p);
 
     // The app calls `dashboard_render` every frame; after a trap it must keep
     // returning a well-formed frame at the requested size or the renderer indexes
@@ -742,11 +877,143 @@ fn profile_startup_cost() {
     println!(
         "\n  Two caches sit behind these numbers. `load_component` keeps compiled\n  \
          components in-process, so the app's per-tab provider sets do not each pay\n  \
-         to compile the same bytes; and wasmtime's on-disk cache carries the\n  \
-         compile across runs. With a cold on-disk cache expect `load_component`\n  \
-         near 1.2s for this fixture rather than the few ms shown here — delete\n  \
-         ~/.cache/wasmtime to see it.\n"
+         to compile the same bytes; and a precompiled artifact in\n  \
+         ~/.cache/sicompass/wasm carries the compile across runs. Without one\n  \
+         expect `load_component` near 1.2s for this fixture rather than the few\n  \
+         ms shown here — delete that directory and ~/.cache/wasmtime to see it.\n"
+    );
+}
+
+/// What a warm spare saves when a plugin is opened again, or restarted after a
+/// trap.
+///
+/// Ignored by default; run deliberately:
+///
+/// ```text
+/// cargo test -p sicompass --test wasm_plugin -- --ignored --nocapture restart
+/// ```
+#[test]
+#[ignore = "manual profiling aid; prints timings instead of asserting"]
+fn profile_open_and_restart_cost() {
+    const N: u32 = 20;
+    let component = wasm_host::load_component(&hello_wasm()).expect("fixture compiles");
+    let pool = wasm_host::pool::for_plugin(
+        &hello_wasm(),
+        &component,
+        "hello",
+        "hello",
+        &fixture_dir(),
+        &[],
+    )
+    .expect("links");
+
+    // Each run waits for the spare first, so this is the warm path only.
+    let wait_for_spare = || {
+        let deadline = std::time::Instant::now() + std::time::Duration::from_secs(5);
+        while !pool.has_spare() && std::time::Instant::now() < deadline {
+            std::thread::sleep(std::time::Duration::from_millis(1));
+        }
+    };
+
+    let mut cold = std::time::Duration::ZERO;
+    for _ in 0..N {
+        let t = std::time::Instant::now();
+        let p =
+            WasmProvider::from_component(&component, "hello", "hello", &fixture_dir(), Vec::new())
+                .expect("instantiates");
+        cold += t.elapsed();
+        std::hint::black_box(&p);
+    }
+
+    let mut warm = std::time::Duration::ZERO;
+    for _ in 0..N {
+        wait_for_spare();
+        let t = std::time::Instant::now();
+        let p = open_hello();
+        warm += t.elapsed();
+        std::hint::black_box(&p);
+    }
+
+    // The call that traps is charged too: it is what the user waits on.
+    let mut restart = std::time::Duration::ZERO;
+    for _ in 0..N {
+        let mut p = open_hello();
+        p.push_path("alpha");
+        wait_for_spare();
+        let t = std::time::Instant::now();
+        p.execute_command("explode", "");
+        restart += t.elapsed();
+        assert!(!p.is_poisoned());
+    }
+
+    println!("\n  open, link + init (avg of {N})   {:>10.2?}", cold / N);
+    println!("  open, warm spare (avg of {N})    {:>10.2?}", warm / N);
+    println!(
+        "  trap + restart (avg of {N})      {:>10.2?}\n",
+        restart / N
+    );
+}
+
+/// What an incremental `fetch` saves on a large tree, host side.
+///
+/// The fixture predates the `incremental` exports, so this times the host's half
+/// of each path on a 100k-node tree: decoding a full blob (plus the guest's
+/// matching encode, which is the same codec), against applying a one-leaf patch
+/// to the held copy and handing out the clone `fetch` returns.
+///
+/// ```text
+/// cargo test -p sicompass --release --test wasm_plugin -- --ignored --nocapture incremental
+/// ```
+#[test]
+#[ignore = "manual profiling aid; prints timings instead of asserting"]
+fn profile_incremental_fetch_cost() {
+    use sicompass::wasm_host::{delta, wit_incremental::FfonPatch};
+    use sicompass_sdk::ffon;
+
+    const OBJS: usize = 1_000;
+    const LEAVES: usize = 99; // 1000 objects of 99 leaves: 100k nodes
+    const N: u32 = 10;
+
+    let tree: Vec<FfonElement> = (0..OBJS)
+        .map(|i| {
+            let mut obj = FfonElement::new_obj(format!("section {i}"));
+            for j in 0..LEAVES {
+                obj.as_obj_mut()
+                    .unwrap()
+                    .push(FfonElement::new_str(format!("row {i}.{j}: some text")));
+            }
+            obj
+        })
+        .collect();
+
+    let t = std::time::Instant::now();
+    for _ in 0..N {
+        let blob = ffon::serialize_binary(&tree);
+        std::hint::black_box(ffon::deserialize_binary(&blob));
+    }
+    let full = t.elapsed() / N;
+    let blob_len = ffon::serialize_binary(&tree).len();
+
+    let mut held = tree.clone();
+    let t = std::time::Instant::now();
+    for i in 0..N {
+        let patch = FfonPatch {
+            path: vec![(i as u32 * 97) % OBJS as u32, 0],
+            remove: 1,
+            insert: ffon::serialize_binary(&[FfonElement::new_str(format!("edited {i}"))]),
+        };
+        delta::apply(&mut held, &[patch]).unwrap();
+        std::hint::black_box(held.clone());
+    }
+    let patched = t.elapsed() / N;
+
+    println!(
+        "\n  {} nodes, {} KiB encoded",
+        OBJS * (LEAVES + 1),
+        blob_len / 1024
     );
+    println!("  full encode + decode        {full:>10.2?}");
+    println!("  one-leaf patch + clone      {patched:>10.2?}\n");
 }
 
 /// Rough per-frame cost of crossing the boundary, printed rather than asserted.